@@ -0,0 +1,29 @@
+#----------------------------------------------------------------
+# Generated CMake target import file.
+#----------------------------------------------------------------
+
+# Commands may need to know the format version.
+set(CMAKE_IMPORT_FILE_VERSION 1)
+
+# Import target "CrolinKit::thread" for configuration ""
+set_property(TARGET CrolinKit::thread APPEND PROPERTY IMPORTED_CONFIGURATIONS NOCONFIG)
+set_target_properties(CrolinKit::thread PROPERTIES
+  IMPORTED_LINK_INTERFACE_LANGUAGES_NOCONFIG "C"
+  IMPORTED_LOCATION_NOCONFIG "${_IMPORT_PREFIX}/lib/libthread.a"
+  )
+
+list(APPEND _cmake_import_check_targets CrolinKit::thread )
+list(APPEND _cmake_import_check_files_for_CrolinKit::thread "${_IMPORT_PREFIX}/lib/libthread.a" )
+
+# Import target "CrolinKit::log" for configuration ""
+set_property(TARGET CrolinKit::log APPEND PROPERTY IMPORTED_CONFIGURATIONS NOCONFIG)
+set_target_properties(CrolinKit::log PROPERTIES
+  IMPORTED_LINK_INTERFACE_LANGUAGES_NOCONFIG "C"
+  IMPORTED_LOCATION_NOCONFIG "${_IMPORT_PREFIX}/lib/liblog.a"
+  )
+
+list(APPEND _cmake_import_check_targets CrolinKit::log )
+list(APPEND _cmake_import_check_files_for_CrolinKit::log "${_IMPORT_PREFIX}/lib/liblog.a" )
+
+# Commands beyond this point should not need to know the version.
+set(CMAKE_IMPORT_FILE_VERSION)
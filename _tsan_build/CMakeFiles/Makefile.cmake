@@ -0,0 +1,116 @@
+# CMAKE generated file: DO NOT EDIT!
+# Generated by "Unix Makefiles" Generator, CMake Version 3.25
+
+# The generator used is:
+set(CMAKE_DEPENDS_GENERATOR "Unix Makefiles")
+
+# The top level Makefile was generated from the following files:
+set(CMAKE_MAKEFILE_DEPENDS
+  "CMakeCache.txt"
+  "/root/repo/CMakeLists.txt"
+  "CMakeFiles/3.25.1/CMakeCCompiler.cmake"
+  "CMakeFiles/3.25.1/CMakeSystem.cmake"
+  "/root/repo/cmake/templates/version.h.in"
+  "/root/repo/examples/CMakeLists.txt"
+  "/root/repo/examples/log/CMakeLists.txt"
+  "/root/repo/examples/thread/CMakeLists.txt"
+  "/root/repo/src/CMakeLists.txt"
+  "/root/repo/src/core/CMakeLists.txt"
+  "/root/repo/src/core/log/CMakeLists.txt"
+  "/root/repo/src/core/log/include/log.h"
+  "/root/repo/src/core/thread/CMakeLists.txt"
+  "/root/repo/src/core/thread/include/thread.h"
+  "/root/repo/tests/CMakeLists.txt"
+  "/root/repo/tests/modules/CMakeLists.txt"
+  "/root/repo/tests/modules/log/CMakeLists.txt"
+  "/root/repo/tests/modules/log/src/CMakeLists.txt"
+  "/root/repo/tests/modules/thread/CMakeLists.txt"
+  "/root/repo/tests/modules/thread/src/CMakeLists.txt"
+  "/root/repo/tools/CMakeLists.txt"
+  "/root/repo/tools/bench/CMakeLists.txt"
+  "/root/repo/tools/logcat/CMakeLists.txt"
+  "/usr/share/cmake-3.25/Modules/CMakeCInformation.cmake"
+  "/usr/share/cmake-3.25/Modules/CMakeCommonLanguageInclude.cmake"
+  "/usr/share/cmake-3.25/Modules/CMakeGenericSystem.cmake"
+  "/usr/share/cmake-3.25/Modules/CMakeInitializeConfigs.cmake"
+  "/usr/share/cmake-3.25/Modules/CMakeLanguageInformation.cmake"
+  "/usr/share/cmake-3.25/Modules/CMakeSystemSpecificInformation.cmake"
+  "/usr/share/cmake-3.25/Modules/CMakeSystemSpecificInitialize.cmake"
+  "/usr/share/cmake-3.25/Modules/CheckCSourceCompiles.cmake"
+  "/usr/share/cmake-3.25/Modules/CheckIncludeFile.cmake"
+  "/usr/share/cmake-3.25/Modules/CheckLibraryExists.cmake"
+  "/usr/share/cmake-3.25/Modules/Compiler/CMakeCommonCompilerMacros.cmake"
+  "/usr/share/cmake-3.25/Modules/Compiler/GNU-C.cmake"
+  "/usr/share/cmake-3.25/Modules/Compiler/GNU.cmake"
+  "/usr/share/cmake-3.25/Modules/FindPackageHandleStandardArgs.cmake"
+  "/usr/share/cmake-3.25/Modules/FindPackageMessage.cmake"
+  "/usr/share/cmake-3.25/Modules/FindThreads.cmake"
+  "/usr/share/cmake-3.25/Modules/GNUInstallDirs.cmake"
+  "/usr/share/cmake-3.25/Modules/Internal/CheckSourceCompiles.cmake"
+  "/usr/share/cmake-3.25/Modules/Platform/Linux-GNU-C.cmake"
+  "/usr/share/cmake-3.25/Modules/Platform/Linux-GNU.cmake"
+  "/usr/share/cmake-3.25/Modules/Platform/Linux.cmake"
+  "/usr/share/cmake-3.25/Modules/Platform/UnixPaths.cmake"
+  )
+
+# The corresponding makefile is:
+set(CMAKE_MAKEFILE_OUTPUTS
+  "Makefile"
+  "CMakeFiles/cmake.check_cache"
+  )
+
+# Byproducts of CMake generate step:
+set(CMAKE_MAKEFILE_PRODUCTS
+  "include/version.h"
+  "CMakeFiles/CMakeDirectoryInformation.cmake"
+  "src/CMakeFiles/CMakeDirectoryInformation.cmake"
+  "src/core/CMakeFiles/CMakeDirectoryInformation.cmake"
+  "include/thread.h"
+  "src/core/thread/CMakeFiles/CMakeDirectoryInformation.cmake"
+  "include/log.h"
+  "src/core/log/CMakeFiles/CMakeDirectoryInformation.cmake"
+  "tools/CMakeFiles/CMakeDirectoryInformation.cmake"
+  "tools/bench/CMakeFiles/CMakeDirectoryInformation.cmake"
+  "tools/logcat/CMakeFiles/CMakeDirectoryInformation.cmake"
+  "examples/CMakeFiles/CMakeDirectoryInformation.cmake"
+  "examples/thread/CMakeFiles/CMakeDirectoryInformation.cmake"
+  "examples/log/CMakeFiles/CMakeDirectoryInformation.cmake"
+  "tests/CMakeFiles/CMakeDirectoryInformation.cmake"
+  "tests/modules/CMakeFiles/CMakeDirectoryInformation.cmake"
+  "tests/modules/thread/CMakeFiles/CMakeDirectoryInformation.cmake"
+  "tests/modules/thread/src/CMakeFiles/CMakeDirectoryInformation.cmake"
+  "tests/modules/log/CMakeFiles/CMakeDirectoryInformation.cmake"
+  "tests/modules/log/src/CMakeFiles/CMakeDirectoryInformation.cmake"
+  )
+
+# Dependency information for all targets:
+set(CMAKE_DEPEND_INFO_FILES
+  "CMakeFiles/copy-compile-commands.dir/DependInfo.cmake"
+  "src/core/thread/CMakeFiles/thread.dir/DependInfo.cmake"
+  "src/core/log/CMakeFiles/log.dir/DependInfo.cmake"
+  "tools/bench/CMakeFiles/thread_bench.dir/DependInfo.cmake"
+  "tools/bench/CMakeFiles/log_bench.dir/DependInfo.cmake"
+  "tools/bench/CMakeFiles/bench.dir/DependInfo.cmake"
+  "tools/logcat/CMakeFiles/crolin-logcat.dir/DependInfo.cmake"
+  "examples/thread/CMakeFiles/thread_example.dir/DependInfo.cmake"
+  "examples/thread/CMakeFiles/thread_resize_example.dir/DependInfo.cmake"
+  "examples/thread/CMakeFiles/thread_auto_adjust_example.dir/DependInfo.cmake"
+  "examples/thread/CMakeFiles/thread_task_names_example.dir/DependInfo.cmake"
+  "examples/thread/CMakeFiles/thread_pool_example.dir/DependInfo.cmake"
+  "examples/thread/CMakeFiles/thread_priority_example.dir/DependInfo.cmake"
+  "examples/thread/CMakeFiles/thread_cancel_example.dir/DependInfo.cmake"
+  "examples/thread/CMakeFiles/thread_task_name_cancel_example.dir/DependInfo.cmake"
+  "examples/thread/CMakeFiles/thread_unnamed_tasks_example.dir/DependInfo.cmake"
+  "examples/log/CMakeFiles/log_basic_example.dir/DependInfo.cmake"
+  "examples/log/CMakeFiles/log_advanced_example.dir/DependInfo.cmake"
+  "tests/modules/thread/src/CMakeFiles/thread_unit_test.dir/DependInfo.cmake"
+  "tests/modules/thread/src/CMakeFiles/thread_resize_test.dir/DependInfo.cmake"
+  "tests/modules/thread/src/CMakeFiles/thread_auto_adjust.dir/DependInfo.cmake"
+  "tests/modules/thread/src/CMakeFiles/thread_debug_test.dir/DependInfo.cmake"
+  "tests/modules/thread/src/CMakeFiles/thread_pool_test.dir/DependInfo.cmake"
+  "tests/modules/thread/src/CMakeFiles/thread_priority_test.dir/DependInfo.cmake"
+  "tests/modules/thread/src/CMakeFiles/thread_cancel_test.dir/DependInfo.cmake"
+  "tests/modules/thread/src/CMakeFiles/thread_future_test.dir/DependInfo.cmake"
+  "tests/modules/log/src/CMakeFiles/log_unit_test.dir/DependInfo.cmake"
+  "tests/modules/log/src/CMakeFiles/log_compile_level_test.dir/DependInfo.cmake"
+  )
@@ -0,0 +1,8 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/copy-compile-commands"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang )
+  include(CMakeFiles/copy-compile-commands.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
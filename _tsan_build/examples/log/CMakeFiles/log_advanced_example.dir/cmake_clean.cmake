@@ -0,0 +1,11 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/log_advanced_example.dir/log_advanced_example.c.o"
+  "CMakeFiles/log_advanced_example.dir/log_advanced_example.c.o.d"
+  "log_advanced_example"
+  "log_advanced_example.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang C)
+  include(CMakeFiles/log_advanced_example.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
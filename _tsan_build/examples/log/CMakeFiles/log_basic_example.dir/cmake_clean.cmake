@@ -0,0 +1,11 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/log_basic_example.dir/log_basic_example.c.o"
+  "CMakeFiles/log_basic_example.dir/log_basic_example.c.o.d"
+  "log_basic_example"
+  "log_basic_example.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang C)
+  include(CMakeFiles/log_basic_example.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
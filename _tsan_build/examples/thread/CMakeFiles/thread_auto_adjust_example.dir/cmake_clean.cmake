@@ -0,0 +1,11 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/thread_auto_adjust_example.dir/thread_auto_adjust_example.c.o"
+  "CMakeFiles/thread_auto_adjust_example.dir/thread_auto_adjust_example.c.o.d"
+  "thread_auto_adjust_example"
+  "thread_auto_adjust_example.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang C)
+  include(CMakeFiles/thread_auto_adjust_example.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
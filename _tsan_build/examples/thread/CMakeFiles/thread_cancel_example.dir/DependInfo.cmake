@@ -0,0 +1,21 @@
+
+# Consider dependencies only in project.
+set(CMAKE_DEPENDS_IN_PROJECT_ONLY OFF)
+
+# The set of languages for which implicit dependencies are needed:
+set(CMAKE_DEPENDS_LANGUAGES
+  )
+
+# The set of dependency files which are needed:
+set(CMAKE_DEPENDS_DEPENDENCY_FILES
+  "/root/repo/examples/thread/thread_cancel_example.c" "examples/thread/CMakeFiles/thread_cancel_example.dir/thread_cancel_example.c.o" "gcc" "examples/thread/CMakeFiles/thread_cancel_example.dir/thread_cancel_example.c.o.d"
+  )
+
+# Targets to which this target links.
+set(CMAKE_TARGET_LINKED_INFO_FILES
+  "/root/repo/_tsan_build/src/core/thread/CMakeFiles/thread.dir/DependInfo.cmake"
+  "/root/repo/_tsan_build/src/core/log/CMakeFiles/log.dir/DependInfo.cmake"
+  )
+
+# Fortran module output directory.
+set(CMAKE_Fortran_TARGET_MODULE_DIR "")
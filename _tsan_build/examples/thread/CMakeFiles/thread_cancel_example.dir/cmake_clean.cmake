@@ -0,0 +1,11 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/thread_cancel_example.dir/thread_cancel_example.c.o"
+  "CMakeFiles/thread_cancel_example.dir/thread_cancel_example.c.o.d"
+  "thread_cancel_example"
+  "thread_cancel_example.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang C)
+  include(CMakeFiles/thread_cancel_example.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
@@ -0,0 +1,11 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/thread_pool_example.dir/thread_pool_example.c.o"
+  "CMakeFiles/thread_pool_example.dir/thread_pool_example.c.o.d"
+  "thread_pool_example"
+  "thread_pool_example.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang C)
+  include(CMakeFiles/thread_pool_example.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
@@ -0,0 +1,11 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/thread_task_names_example.dir/thread_task_names_example.c.o"
+  "CMakeFiles/thread_task_names_example.dir/thread_task_names_example.c.o.d"
+  "thread_task_names_example"
+  "thread_task_names_example.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang C)
+  include(CMakeFiles/thread_task_names_example.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
@@ -0,0 +1,11 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/thread_unnamed_tasks_example.dir/thread_unnamed_tasks_example.c.o"
+  "CMakeFiles/thread_unnamed_tasks_example.dir/thread_unnamed_tasks_example.c.o.d"
+  "thread_unnamed_tasks_example"
+  "thread_unnamed_tasks_example.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang C)
+  include(CMakeFiles/thread_unnamed_tasks_example.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
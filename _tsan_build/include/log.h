@@ -0,0 +1,878 @@
+#ifndef CROLINKIT_LOG_H
+#define CROLINKIT_LOG_H
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+
+/**
+ * @file log.h
+ * @brief 统一的日志接口，提供日志记录、控制和配置功能
+ *
+ * 该模块提供了一套完整的日志系统，支持多级别日志、模块化日志分类、
+ * 灵活的输出配置和运行时可配置的日志级别和格式。
+ *
+ * 主要功能包括：
+ * - 基本日志记录（不同级别）
+ * - 模块化日志控制（启用/禁用、级别控制）
+ * - 日志上下文管理（线程本地存储）
+ * - 日志回调机制（自定义日志处理）
+ * - 日志轮转功能（基于大小和时间）
+ * - 缓冲输出和可配置的刷新策略
+ * - 二进制延迟格式化日志（离线解码）
+ */
+
+// 日志级别名称
+extern const char *log_level_names[];
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief 日志级别定义
+ */
+typedef enum {
+    LOG_LEVEL_FATAL = 0, // 致命错误，系统无法继续运行
+    LOG_LEVEL_ERROR,     // 一般错误，功能无法正常工作
+    LOG_LEVEL_WARN,      // 警告信息，可能存在问题
+    LOG_LEVEL_INFO,      // 一般信息，重要操作和状态变化
+    LOG_LEVEL_DEBUG,     // 调试信息，详细的程序执行信息
+    LOG_LEVEL_TRACE      // 跟踪信息，最详细的调试数据
+} log_level_t;
+
+/**
+ * @brief 日志模块定义
+ */
+typedef enum {
+    LOG_MODULE_CORE = 0, // 核心模块
+    LOG_MODULE_THREAD,   // 线程模块
+    LOG_MODULE_LOG,      // 日志模块
+    LOG_MODULE_MAX       // 模块数量
+} log_module_t;
+
+/**
+ * @brief 获取日志模块名称
+ * @param module 模块枚举值
+ * @return 模块名称字符串
+ */
+const char *log_get_module_name(log_module_t module);
+
+/**
+ * @brief 日志格式选项
+ */
+typedef struct {
+    bool show_time;       // 是否显示时间戳
+    bool show_tid;        // 是否显示线程ID
+    bool show_module;     // 是否显示模块名
+    bool show_file_line;  // 是否显示文件名和行号
+    bool show_function;   // 是否显示函数名
+    bool use_colors;      // 是否使用颜色
+    bool use_iso_time;    // 是否使用ISO 8601时间格式
+    char time_format[32]; // 自定义时间格式（strftime格式）
+} log_format_options_t;
+
+/**
+ * @brief 每个模块的日志配置
+ */
+typedef struct {
+    log_level_t level;   // 日志级别
+    bool console_output; // 是否输出到控制台
+    bool file_output;    // 是否输出到文件
+    bool enabled;        // 是否启用
+    char *custom_file;   // 模块专用日志文件（可选）
+    bool binary_output;  // 二进制调用点 (LOG_BIN_*) 是否写入二进制日志文件
+} module_log_config_t;
+
+/**
+ * @brief 日志轮转配置
+ *
+ * 轮转时当前文件成为 <path>.1，原有备份依次后移为 .2 … .N，超出数量的最旧备份被删除。
+ * 文件大小在打开时读取一次，之后按写入的字节数累计，不会为每条日志访问文件系统。
+ */
+typedef struct {
+    size_t max_file_size;      // 单个日志文件最大大小（字节）
+    int max_file_count;        // 最大日志文件数量（含当前文件，即保留 max_file_count - 1 个备份）
+    bool rotate_on_size;       // 是否按大小轮转
+    bool rotate_on_time;       // 是否按时间轮转
+    int rotate_interval_hours; // 时间轮转间隔（小时）
+} log_rotation_config_t;
+
+/**
+ * @brief 日志上下文结构
+ *
+ * 用于在日志消息中添加上下文信息，如会话ID、用户ID等。
+ * 通过 log_set_context 设置的上下文复制到每个线程固定大小的线程本地缓冲区中，对每个线程独立，
+ * 不分配堆内存；也可以通过 log_write_with_context 为单条日志显式提供上下文。
+ * 每个字段最多保留 LOG_CONTEXT_FIELD_MAX - 1 个字节，超出部分被截断。
+ */
+typedef struct {
+    const char *context_id;     // 上下文标识符
+    const char *session_id;     // 会话ID
+    const char *user_id;        // 用户ID
+    const char *transaction_id; // 事务ID
+} log_context_t;
+
+// 日志上下文中单个字段的最大长度（含结尾的 '\0'）
+#define LOG_CONTEXT_FIELD_MAX 56
+
+/**
+ * @brief 日志回调函数类型
+ *
+ * 当日志消息被写入时，所有注册的回调函数都会被调用。
+ * 可以用于自定义日志处理，如发送到远程服务器、写入数据库等。
+ *
+ * @param level 日志级别
+ * @param module 日志模块
+ * @param file 源文件名
+ * @param line 行号
+ * @param func 函数名
+ * @param message 格式化后的日志消息
+ * @param user_data 用户数据，由注册回调时提供
+ */
+typedef void (*log_callback_t)(log_level_t level, log_module_t module, const char *file, int line,
+                               const char *func, const char *message, void *user_data);
+
+/*******************************************************************************
+ * 基本日志接口
+ *******************************************************************************/
+
+/**
+ * @brief 初始化日志系统
+ *
+ * @param log_file 日志文件路径，如果为NULL则使用默认路径
+ * @param level 默认日志级别
+ * @return 成功返回0，失败返回负数错误码
+ */
+int log_init(const char *log_file, log_level_t level);
+
+/**
+ * @brief 关闭日志系统
+ */
+void log_deinit(void);
+
+/**
+ * @brief 写入日志
+ *
+ * 核心日志写入函数，通常通过宏调用而不是直接调用。
+ *
+ * @param level 日志级别
+ * @param module 日志模块
+ * @param file 源文件名
+ * @param line 行号
+ * @param func 函数名
+ * @param fmt 格式化字符串
+ * @param ... 可变参数
+ */
+void log_write(log_level_t level, log_module_t module, const char *file, int line, const char *func,
+               const char *fmt, ...);
+
+/*******************************************************************************
+ * 模块级别的日志控制接口
+ *******************************************************************************/
+
+/**
+ * @brief 设置模块的日志级别
+ *
+ * @param module 日志模块
+ * @param level 日志级别
+ */
+void log_set_module_level(log_module_t module, log_level_t level);
+
+/**
+ * @brief 设置模块的输出目标
+ *
+ * @param module 日志模块
+ * @param console_on 是否输出到控制台
+ * @param file_on 是否输出到文件
+ */
+void log_set_module_output(log_module_t module, bool console_on, bool file_on);
+
+/**
+ * @brief 为模块挂接专用日志文件
+ *
+ * 挂接后该模块的日志写入 path 而不是 log_init 指定的文件，custom_file 记录该路径。
+ * 每个日志文件有独立的锁、缓冲区、刷新状态和备份链 <path>.1 … .N，使用全局的格式选项、
+ * 轮转配置和刷新策略；写日志时只锁定所用的文件，不同文件的写入互不阻塞。
+ * 可以在运行时调用，不需要暂停其他模块的日志。
+ *
+ * @param module 日志模块
+ * @param path 日志文件路径，长度小于256
+ * @return 成功返回0，参数无效或日志系统未初始化返回-1，已挂接专用文件返回-2，打开文件失败返回-3
+ */
+int log_attach_module_sink(log_module_t module, const char *path);
+
+/**
+ * @brief 撤销模块的专用日志文件
+ *
+ * 刷新并关闭模块的专用文件，之后该模块的日志重新写入 log_init 指定的文件。
+ * 异步模式下先等待已提交的日志写出。log_deinit 会自动撤销全部专用文件。不能在日志回调函数中调用。
+ *
+ * @param module 日志模块
+ * @return 成功返回0，参数无效返回-1，未挂接专用文件返回-2
+ */
+int log_detach_module_sink(log_module_t module);
+
+/**
+ * @brief 设置模块是否启用
+ *
+ * @param module 日志模块
+ * @param enable 是否启用
+ */
+void log_set_module_enable(log_module_t module, bool enable);
+
+/**
+ * @brief 获取模块的日志级别
+ *
+ * @param module 日志模块
+ * @return 日志级别
+ */
+log_level_t log_get_module_level(log_module_t module);
+
+/**
+ * @brief 获取模块是否启用
+ *
+ * @param module 日志模块
+ * @return 是否启用
+ */
+bool log_get_module_enable(log_module_t module);
+
+/**
+ * @brief 检查指定级别的日志是否会被记录
+ *
+ * @param module 日志模块
+ * @param level 日志级别
+ * @return 如果会被记录返回true，否则返回false
+ */
+bool log_is_level_enabled(log_module_t module, log_level_t level);
+
+/**
+ * @brief 设置日志格式选项
+ *
+ * @param options 格式选项
+ */
+void log_set_format_options(const log_format_options_t *options);
+
+/**
+ * @brief 获取日志格式选项
+ *
+ * @param options 用于存储格式选项的结构体指针
+ */
+void log_get_format_options(log_format_options_t *options);
+
+/**
+ * @brief 设置日志轮转配置
+ *
+ * @param config 轮转配置
+ */
+void log_set_rotation_config(const log_rotation_config_t *config);
+
+/**
+ * @brief 获取日志轮转配置
+ *
+ * @param config 用于存储轮转配置的结构体指针
+ */
+void log_get_rotation_config(log_rotation_config_t *config);
+
+/**
+ * @brief 立即执行日志轮转
+ *
+ * 备份链在后台线程中重命名，本函数等待重命名完成后返回，等待期间不阻塞其他线程写日志。
+ *
+ * @return 成功返回0，未打开日志文件返回-1，重命名当前文件失败返回-2，重新打开文件或启动后台线程失败返回-3
+ */
+int log_rotate_now(void);
+
+/**
+ * @brief 注册日志回调函数
+ *
+ * 回调函数在写日志的线程中（异步模式下在后台写线程中）调用，调用时不持有任何日志锁，
+ * 慢回调不会阻塞其他线程写日志；多个线程可能同时调用同一个回调函数。
+ * 不能在回调函数中注册或注销回调。
+ *
+ * @param callback 回调函数
+ * @param user_data 用户数据
+ * @return 成功返回0，失败返回负数错误码
+ */
+int log_register_callback(log_callback_t callback, void *user_data);
+
+/**
+ * @brief 注销日志回调函数
+ *
+ * 等待正在执行的该回调返回后才返回，之后可以安全地释放注册时提供的 user_data。
+ *
+ * @param callback 回调函数
+ * @return 成功返回0，失败返回负数错误码
+ */
+int log_unregister_callback(log_callback_t callback);
+
+/*******************************************************************************
+ * 缓冲与刷新接口
+ *******************************************************************************/
+
+/**
+ * @brief 日志输出的刷新策略
+ *
+ * 写出的日志先进入用户态缓冲区，满足任一条件时才刷新到控制台和文件。
+ * 缓冲区写满时标准库也会自动写出。默认策略每条日志都刷新，与不缓冲时相同。
+ * 使用前应先调用 log_flush_policy_init 填充默认值，再按需修改各字段。
+ */
+typedef struct {
+    size_t buffer_size;      // 日志文件的用户态缓冲区大小（字节），0 表示使用标准库的默认大小
+    size_t flush_bytes;      // 未刷新的数据达到该字节数时刷新，0 表示每条日志都刷新（默认）
+    int flush_interval_ms;   // 距上次刷新超过该毫秒数时刷新，0 表示不按时间刷新（默认）
+    log_level_t flush_level; // 该级别及更严重的日志写出后立即刷新，默认 LOG_LEVEL_ERROR
+} log_flush_policy_t;
+
+/**
+ * @brief 使用默认值初始化刷新策略
+ *
+ * @param policy 要初始化的策略，为NULL时不执行任何操作
+ */
+void log_flush_policy_init(log_flush_policy_t *policy);
+
+/**
+ * @brief 设置刷新策略
+ *
+ * 策略在 log_deinit 之后仍然保留。修改 buffer_size 时会刷新并重新打开日志文件。
+ * 同步模式下按时间刷新在下一条日志写出时检查；异步模式下后台写线程空闲时也会检查。
+ *
+ * @param policy 刷新策略
+ * @return 成功返回0，参数无效返回-1，重新打开日志文件失败返回-3
+ */
+int log_set_flush_policy(const log_flush_policy_t *policy);
+
+/**
+ * @brief 获取刷新策略
+ *
+ * @param policy 用于存储刷新策略的结构体指针
+ */
+void log_get_flush_policy(log_flush_policy_t *policy);
+
+/**
+ * @brief 立即刷新缓冲的日志
+ *
+ * 异步模式下先等待后台写线程输出调用前已提交的日志。不能在日志回调函数中调用。
+ *
+ * @return 成功返回0，日志系统未初始化返回-1
+ */
+int log_flush(void);
+
+/*******************************************************************************
+ * 异步日志接口
+ *******************************************************************************/
+
+/**
+ * @brief 异步模式下环形缓冲区已满时的处理策略
+ */
+typedef enum {
+    LOG_OVERFLOW_BLOCK = 0,            // 等待后台写线程腾出槽位，不丢失日志（默认）
+    LOG_OVERFLOW_DROP_NEWEST = 1,      // 丢弃当前这条日志；ERROR 和 FATAL 日志仍然等待槽位
+    LOG_OVERFLOW_DROP_LOWEST_LEVEL = 2 // 按级别逐级丢弃：缓冲区半满时丢弃 TRACE，四分之三满时丢弃 DEBUG，
+                                       // 已满时丢弃 INFO；WARN 及更严重的日志等待槽位
+} log_overflow_policy_t;
+
+/**
+ * @brief 异步日志配置
+ *
+ * 使用前应先调用 log_async_config_init 填充默认值，再按需修改各字段。
+ */
+typedef struct {
+    size_t queue_capacity;                 // 环形缓冲区槽位数量，向上取整为 2 的幂，默认 256
+    log_overflow_policy_t overflow_policy; // 缓冲区已满时的处理策略，默认 LOG_OVERFLOW_BLOCK
+    int batch_size;                        // 后台写线程每批最多输出的日志条数，默认 64
+} log_async_config_t;
+
+/**
+ * @brief 异步日志统计信息
+ */
+typedef struct {
+    unsigned long enqueued; // 已放入缓冲区的日志条数
+    unsigned long written;  // 后台写线程已输出的日志条数
+    unsigned long dropped;  // 因缓冲区已满被丢弃的日志条数
+    unsigned long blocked;  // 生产者因缓冲区已满而等待的次数
+} log_async_stats_t;
+
+/**
+ * @brief 使用默认值初始化异步日志配置
+ *
+ * @param config 要初始化的配置，为NULL时不执行任何操作
+ */
+void log_async_config_init(log_async_config_t *config);
+
+/**
+ * @brief 启用异步日志
+ *
+ * 启用后 log_write 只在调用线程中格式化消息，写入无锁的多生产者环形缓冲区后立即返回，
+ * 由后台写线程成批输出到控制台、文件和回调函数，按刷新策略在每批结束时刷新输出流。
+ * FATAL 级别的日志在写出后才返回。回调函数在后台写线程中调用。
+ *
+ * @param config 异步日志配置，为NULL时使用默认值
+ * @return 成功返回0，参数无效或日志系统未初始化返回-1，已经启用返回-2，内存分配或线程创建失败返回-3
+ */
+int log_enable_async(const log_async_config_t *config);
+
+/**
+ * @brief 停用异步日志
+ *
+ * 等待后台写线程输出缓冲区中剩余的全部日志后停止它，之后 log_write 恢复同步输出。
+ * log_deinit 会自动调用此函数。
+ *
+ * @return 成功返回0，异步日志未启用返回-1
+ */
+int log_disable_async(void);
+
+/**
+ * @brief 获取异步日志统计信息
+ *
+ * 统计在每次启用异步日志时清零，停用后保留最后一次的数值。
+ *
+ * @param stats 用于存储统计信息的结构体指针
+ */
+void log_get_async_stats(log_async_stats_t *stats);
+
+/*******************************************************************************
+ * 限流与去重接口
+ *******************************************************************************/
+
+/**
+ * @brief 被抑制日志的统计信息
+ *
+ * 统计在每次 log_init 时清零。
+ */
+typedef struct {
+    uint64_t sampled;        // LOG_EVERY_N、LOG_FIRST_N、LOG_EVERY_MS 跳过的日志条数
+    uint64_t rate_limited;   // LOG_RATELIMITED 因令牌不足丢弃的日志条数
+    uint64_t deduplicated;   // 去重阶段折叠的重复日志条数
+    uint64_t repeat_reports; // 输出的 "last message repeated N times" 行数
+} log_suppress_stats_t;
+
+/**
+ * @brief 设置重复日志折叠
+ *
+ * 启用后，与同一输出文件上一条日志的模块、文件、行号和消息正文都相同的日志不再输出，
+ * 只累计次数；出现不同的日志、距上一条实际输出的重复日志超过 window_ms 毫秒、调用 log_flush
+ * 或关闭文件时输出一行 "last message repeated N times"。比较的是这几项的64位哈希值。
+ * 设置在 log_deinit 之后仍然保留，只作用于文本日志。被折叠的日志不调用回调函数，
+ * "last message repeated N times" 只写入控制台和文件。
+ *
+ * @param enabled 是否启用，默认不启用
+ * @param window_ms 折叠窗口（毫秒），0 表示一直折叠到出现不同的日志
+ * @return 成功返回0，window_ms 为负数返回-1
+ */
+int log_set_dedup(bool enabled, int window_ms);
+
+/**
+ * @brief 获取被抑制日志的统计信息
+ *
+ * @param stats 用于存储统计信息的结构体指针
+ */
+void log_get_suppress_stats(log_suppress_stats_t *stats);
+
+/**
+ * @brief LOG_EVERY_N 的调用点判断（内部使用）：第 1、n+1、2n+1 … 次调用返回 true
+ */
+bool log_site_every_n(unsigned long *counter, unsigned long n);
+
+/**
+ * @brief LOG_FIRST_N 的调用点判断（内部使用）：前 n 次调用返回 true
+ */
+bool log_site_first_n(unsigned long *counter, unsigned long n);
+
+/**
+ * @brief LOG_EVERY_MS 的调用点判断（内部使用）：距上次返回 true 至少 interval_ms 毫秒时返回 true
+ */
+bool log_site_every_ms(int64_t *next_ns, long interval_ms);
+
+/**
+ * @brief LOG_RATELIMITED 的调用点判断（内部使用）：令牌桶中有令牌时消耗一个并返回 true
+ */
+bool log_site_ratelimit(int64_t *tat_ns, unsigned rate, unsigned burst);
+
+/*******************************************************************************
+ * 二进制日志接口
+ *******************************************************************************/
+
+/**
+ * @brief 二进制日志调用点描述
+ *
+ * 由 LOG_BIN_* 宏在每个调用处定义为静态变量，格式字符串、文件名、行号、函数名、级别和模块在编译期确定。
+ * 首次写入时注册并分配描述ID，描述只写入二进制日志文件一次，
+ * 之后每条记录只包含描述ID、时间戳、线程ID、上下文和原始参数，不在运行时格式化消息。
+ */
+typedef struct {
+    const char *fmt;     // 格式字符串
+    const char *file;    // 源文件名
+    const char *func;    // 函数名
+    int line;            // 行号
+    log_level_t level;   // 日志级别
+    log_module_t module; // 日志模块
+    void *registration;  // 注册信息（内部使用），只能通过 __atomic 内建函数访问
+} log_binary_site_t;
+
+/**
+ * @brief 打开二进制日志文件
+ *
+ * 以追加方式打开，每次打开和每次轮转后先写入文件头和全部已注册调用点的描述，
+ * 同一个文件中可以包含多次运行的记录。二进制日志文件使用与文本日志相同的轮转配置
+ * (log_set_rotation_config) 和刷新策略 (log_set_flush_policy)，有独立的备份链 <path>.1 … .N；
+ * 刷新策略中的 buffer_size 在下一次打开或轮转时生效。应在 log_init 之后调用。
+ *
+ * @param path 二进制日志文件路径
+ * @return 成功返回0，参数无效返回-1，已经打开返回-2，打开文件失败返回-3
+ */
+int log_binary_open(const char *path);
+
+/**
+ * @brief 关闭二进制日志文件
+ *
+ * 写出缓冲的记录并等待最后一次轮转并入备份链。log_deinit 会自动调用此函数。
+ *
+ * @return 成功返回0，未打开返回-1
+ */
+int log_binary_close(void);
+
+/**
+ * @brief 设置模块的二进制调用点是否写入二进制日志文件
+ *
+ * 启用后该模块的 LOG_BIN_* 日志只写入二进制日志文件，不输出到控制台、文本日志文件和回调；
+ * 未启用、二进制日志文件未打开或格式字符串不支持二进制编码时，LOG_BIN_* 与 LOG_* 一样按文本输出。
+ * 该模块的 LOG_* 日志不受影响。
+ *
+ * @param module 日志模块
+ * @param enable 是否启用
+ */
+void log_set_module_binary(log_module_t module, bool enable);
+
+/**
+ * @brief 写入一条二进制日志，通常通过 LOG_BIN_* 宏调用
+ *
+ * 支持 %d %i %u %o %x %X %c %s %p %f %F %e %E %g %G %a %A 和 %%，可带标志、宽度、精度
+ * (包括 '*') 以及 hh h l ll z j t L 长度修饰符。格式字符串包含 %n、%m、宽字符或位置参数时
+ * 该调用点始终按文本输出。字符串参数在写入时复制，单个字符串最多保留 LOG_BINARY_STRING_MAX 字节；
+ * 带精度的 %s (如 %.*s、%.4s) 与 printf 一样最多读取精度指定的字节数，可用于不以 '\0' 结尾的缓冲区。
+ *
+ * @param site 调用点描述
+ * @param ... 与格式字符串对应的参数
+ */
+void log_write_binary(log_binary_site_t *site, ...);
+
+/**
+ * @brief 把二进制日志文件解码为文本
+ *
+ * 每条记录输出一行，版式与 log_write 写入文本日志文件的相同。时间按解码时所在的时区显示。
+ *
+ * @param path 二进制日志文件路径
+ * @param out 输出流
+ * @param options 格式选项，为NULL时使用 log_init 设置的默认选项；use_colors 被忽略
+ * @return 成功返回解码的记录条数，打开文件失败返回-1，文件格式错误或被截断返回-2（之前的记录已输出）
+ */
+int log_binary_decode(const char *path, FILE *out, const log_format_options_t *options);
+
+// 二进制日志中单个字符串参数保留的最大字节数
+#define LOG_BINARY_STRING_MAX 1023
+
+/*******************************************************************************
+ * 日志上下文管理接口
+ *******************************************************************************/
+
+/**
+ * @brief 设置当前线程的日志上下文
+ *
+ * 复制各字段到线程本地缓冲区，替换之前设置的全部字段，为NULL的字段被清除。
+ * 不分配堆内存，调用返回后 context 指向的字符串可以立即释放。
+ *
+ * @param context 上下文信息，为NULL时不执行任何操作
+ */
+void log_set_context(const log_context_t *context);
+
+/**
+ * @brief 清除当前线程的日志上下文
+ */
+void log_clear_context(void);
+
+/**
+ * @brief 获取当前线程的日志上下文
+ *
+ * 返回的字段指向线程本地缓冲区，在本线程下一次调用 log_set_context 或 log_clear_context 之前有效。
+ *
+ * @return 日志上下文，未设置的字段为NULL
+ */
+log_context_t log_get_thread_context(void);
+
+/**
+ * @brief 带上下文的日志写入函数
+ *
+ * 使用 context 代替当前线程的上下文渲染这一条日志，不读取也不修改线程本地的上下文，
+ * 适合按请求传递上下文的场景。上下文前缀和消息正文直接渲染到日志记录中，不分配堆内存。
+ *
+ * @param level 日志级别
+ * @param module 日志模块
+ * @param context 上下文信息，为NULL时使用当前线程的上下文
+ * @param file 源文件名
+ * @param line 行号
+ * @param func 函数名
+ * @param fmt 格式化字符串
+ * @param ... 可变参数
+ */
+void log_write_with_context(log_level_t level, log_module_t module, const log_context_t *context,
+                            const char *file, int line, const char *func, const char *fmt, ...);
+
+/*******************************************************************************
+ * 日志宏
+ *******************************************************************************/
+
+/**
+ * @def CROLINKIT_LOG_COMPILE_LEVEL
+ * @brief 编译期日志级别
+ *
+ * 比此级别更详细的日志宏在编译期被移除：参数不会被求值，也不会调用 log_write，
+ * 但格式字符串和参数仍会经过类型检查。取值为日志级别的数值（0 为 FATAL，5 为 TRACE），
+ * 默认为 5，保留全部日志宏。可以在包含本头文件前定义，或通过 CMake 的
+ * CROLINKIT_LOG_COMPILE_LEVEL 选项为整个项目设置（例如 3 移除 DEBUG 和 TRACE）。
+ */
+#ifndef CROLINKIT_LOG_COMPILE_LEVEL
+#define CROLINKIT_LOG_COMPILE_LEVEL 5
+#endif
+
+/**
+ * @brief 各模块当前生效的级别门限（内部使用）
+ *
+ * 模块启用时为其日志级别的数值，禁用或日志系统未初始化时为 -1。
+ * 由 log_set_module_level、log_set_module_enable 等函数维护，只能通过 __atomic 内建函数访问。
+ */
+extern int log_module_thresholds[LOG_MODULE_MAX];
+
+/**
+ * @brief 无锁检查指定级别的日志是否会被记录
+ *
+ * 只有一次 relaxed 原子读取，供日志宏在求值参数之前内联调用。
+ *
+ * @param module 日志模块
+ * @param level 日志级别
+ * @return 如果会被记录返回true，否则返回false
+ */
+static inline bool log_level_enabled_fast(log_module_t module, log_level_t level)
+{
+    return (unsigned)module < (unsigned)LOG_MODULE_MAX &&
+           (int)level <= __atomic_load_n(&log_module_thresholds[module], __ATOMIC_RELAXED);
+}
+
+// 调用 log_write，自动填入文件名、行号和函数名
+#define LOG_WRITE_AT_(level, module, fmt, ...)                                                     \
+    log_write(level, module, __FILE__, __LINE__, __func__, fmt, ##__VA_ARGS__)
+
+// 编译期移除的日志宏：不求值参数，只做类型检查
+#define LOG_ELIDED_(level, module, fmt, ...)                                                       \
+    (0 ? LOG_WRITE_AT_(level, module, fmt, ##__VA_ARGS__) : (void)0)
+
+/**
+ * @brief 基本日志宏
+ *
+ * 这些宏用于记录不同级别的日志，自动包含文件名、行号和函数名。
+ * LOG_DEBUG 和 LOG_TRACE 先内联检查级别，级别未启用时不求值参数、不调用 log_write。
+ * 比 CROLINKIT_LOG_COMPILE_LEVEL 更详细的宏在编译期被移除。
+ */
+#if CROLINKIT_LOG_COMPILE_LEVEL >= 0
+#define LOG_FATAL(module, fmt, ...) LOG_WRITE_AT_(LOG_LEVEL_FATAL, module, fmt, ##__VA_ARGS__)
+#else
+#define LOG_FATAL(module, fmt, ...) LOG_ELIDED_(LOG_LEVEL_FATAL, module, fmt, ##__VA_ARGS__)
+#endif
+
+#if CROLINKIT_LOG_COMPILE_LEVEL >= 1
+#define LOG_ERROR(module, fmt, ...) LOG_WRITE_AT_(LOG_LEVEL_ERROR, module, fmt, ##__VA_ARGS__)
+#else
+#define LOG_ERROR(module, fmt, ...) LOG_ELIDED_(LOG_LEVEL_ERROR, module, fmt, ##__VA_ARGS__)
+#endif
+
+#if CROLINKIT_LOG_COMPILE_LEVEL >= 2
+#define LOG_WARN(module, fmt, ...) LOG_WRITE_AT_(LOG_LEVEL_WARN, module, fmt, ##__VA_ARGS__)
+#else
+#define LOG_WARN(module, fmt, ...) LOG_ELIDED_(LOG_LEVEL_WARN, module, fmt, ##__VA_ARGS__)
+#endif
+
+#if CROLINKIT_LOG_COMPILE_LEVEL >= 3
+#define LOG_INFO(module, fmt, ...) LOG_WRITE_AT_(LOG_LEVEL_INFO, module, fmt, ##__VA_ARGS__)
+#else
+#define LOG_INFO(module, fmt, ...) LOG_ELIDED_(LOG_LEVEL_INFO, module, fmt, ##__VA_ARGS__)
+#endif
+
+#if CROLINKIT_LOG_COMPILE_LEVEL >= 4
+#define LOG_DEBUG(module, fmt, ...)                                                                \
+    (log_level_enabled_fast(module, LOG_LEVEL_DEBUG)                                               \
+         ? LOG_WRITE_AT_(LOG_LEVEL_DEBUG, module, fmt, ##__VA_ARGS__)                              \
+         : (void)0)
+#else
+#define LOG_DEBUG(module, fmt, ...) LOG_ELIDED_(LOG_LEVEL_DEBUG, module, fmt, ##__VA_ARGS__)
+#endif
+
+#if CROLINKIT_LOG_COMPILE_LEVEL >= 5
+#define LOG_TRACE(module, fmt, ...)                                                                \
+    (log_level_enabled_fast(module, LOG_LEVEL_TRACE)                                               \
+         ? LOG_WRITE_AT_(LOG_LEVEL_TRACE, module, fmt, ##__VA_ARGS__)                              \
+         : (void)0)
+#else
+#define LOG_TRACE(module, fmt, ...) LOG_ELIDED_(LOG_LEVEL_TRACE, module, fmt, ##__VA_ARGS__)
+#endif
+
+// 定义静态调用点描述并调用 log_write_binary；fmt 必须是字符串字面量，level 和 module 必须是常量
+#define LOG_BIN_AT_(level, module, fmt, ...)                                                       \
+    do {                                                                                           \
+        static log_binary_site_t log_bin_site_ = {fmt, __FILE__, __func__, __LINE__,              \
+                                                  level, module, NULL};                            \
+        if (log_level_enabled_fast(module, level))                                                 \
+            log_write_binary(&log_bin_site_, ##__VA_ARGS__);                                       \
+    } while (0)
+
+// 编译期移除的二进制日志宏：不求值参数，只做类型检查
+#define LOG_BIN_ELIDED_(level, module, fmt, ...)                                                   \
+    do {                                                                                           \
+        if (0)                                                                                     \
+            LOG_WRITE_AT_(level, module, fmt, ##__VA_ARGS__);                                      \
+    } while (0)
+
+/**
+ * @brief 二进制日志宏
+ *
+ * 用于最高频的跟踪点：模块通过 log_set_module_binary 启用二进制输出后，只记录调用点描述ID、
+ * 时间戳、线程ID和原始参数，由 crolin-logcat 或 log_binary_decode 离线格式化。
+ * 未启用时与对应的 LOG_* 宏输出相同的文本日志。这些宏是语句，不能用在表达式中。
+ */
+#if CROLINKIT_LOG_COMPILE_LEVEL >= 0
+#define LOG_BIN_FATAL(module, fmt, ...) LOG_BIN_AT_(LOG_LEVEL_FATAL, module, fmt, ##__VA_ARGS__)
+#else
+#define LOG_BIN_FATAL(module, fmt, ...) LOG_BIN_ELIDED_(LOG_LEVEL_FATAL, module, fmt, ##__VA_ARGS__)
+#endif
+
+#if CROLINKIT_LOG_COMPILE_LEVEL >= 1
+#define LOG_BIN_ERROR(module, fmt, ...) LOG_BIN_AT_(LOG_LEVEL_ERROR, module, fmt, ##__VA_ARGS__)
+#else
+#define LOG_BIN_ERROR(module, fmt, ...) LOG_BIN_ELIDED_(LOG_LEVEL_ERROR, module, fmt, ##__VA_ARGS__)
+#endif
+
+#if CROLINKIT_LOG_COMPILE_LEVEL >= 2
+#define LOG_BIN_WARN(module, fmt, ...) LOG_BIN_AT_(LOG_LEVEL_WARN, module, fmt, ##__VA_ARGS__)
+#else
+#define LOG_BIN_WARN(module, fmt, ...) LOG_BIN_ELIDED_(LOG_LEVEL_WARN, module, fmt, ##__VA_ARGS__)
+#endif
+
+#if CROLINKIT_LOG_COMPILE_LEVEL >= 3
+#define LOG_BIN_INFO(module, fmt, ...) LOG_BIN_AT_(LOG_LEVEL_INFO, module, fmt, ##__VA_ARGS__)
+#else
+#define LOG_BIN_INFO(module, fmt, ...) LOG_BIN_ELIDED_(LOG_LEVEL_INFO, module, fmt, ##__VA_ARGS__)
+#endif
+
+#if CROLINKIT_LOG_COMPILE_LEVEL >= 4
+#define LOG_BIN_DEBUG(module, fmt, ...) LOG_BIN_AT_(LOG_LEVEL_DEBUG, module, fmt, ##__VA_ARGS__)
+#else
+#define LOG_BIN_DEBUG(module, fmt, ...) LOG_BIN_ELIDED_(LOG_LEVEL_DEBUG, module, fmt, ##__VA_ARGS__)
+#endif
+
+#if CROLINKIT_LOG_COMPILE_LEVEL >= 5
+#define LOG_BIN_TRACE(module, fmt, ...) LOG_BIN_AT_(LOG_LEVEL_TRACE, module, fmt, ##__VA_ARGS__)
+#else
+#define LOG_BIN_TRACE(module, fmt, ...) LOG_BIN_ELIDED_(LOG_LEVEL_TRACE, module, fmt, ##__VA_ARGS__)
+#endif
+
+/**
+ * @brief 采样和限流日志宏
+ *
+ * 用于可能在短时间内大量重复的调用点。每个调用处定义自己的静态状态，只做原子操作，不加锁。
+ * 级别未启用时不更新状态、不求值参数；被跳过的调用不求值参数，计入 log_get_suppress_stats。
+ * level 为日志级别（如 LOG_LEVEL_ERROR），比 CROLINKIT_LOG_COMPILE_LEVEL 更详细的调用在编译期被移除。
+ * 这些宏是语句，不能用在表达式中。
+ *
+ * - LOG_EVERY_N: 第 1、n+1、2n+1 … 次调用写出
+ * - LOG_FIRST_N: 只有前 n 次调用写出
+ * - LOG_EVERY_MS: 距该调用点上次写出至少 ms 毫秒才再次写出
+ * - LOG_RATELIMITED: 令牌桶，每秒补充 rate 个令牌，最多积累 burst 个，每次写出消耗一个
+ */
+#define LOG_SITE_AT_(level, module, check, fmt, ...)                                               \
+    do {                                                                                           \
+        if ((int)(level) <= CROLINKIT_LOG_COMPILE_LEVEL && log_level_enabled_fast(module, level) && \
+            (check))                                                                               \
+            LOG_WRITE_AT_(level, module, fmt, ##__VA_ARGS__);                                      \
+    } while (0)
+
+#define LOG_EVERY_N(level, module, n, fmt, ...)                                                    \
+    do {                                                                                           \
+        static unsigned long log_site_counter_;                                                    \
+        LOG_SITE_AT_(level, module, log_site_every_n(&log_site_counter_, n), fmt, ##__VA_ARGS__);  \
+    } while (0)
+
+#define LOG_FIRST_N(level, module, n, fmt, ...)                                                    \
+    do {                                                                                           \
+        static unsigned long log_site_counter_;                                                    \
+        LOG_SITE_AT_(level, module, log_site_first_n(&log_site_counter_, n), fmt, ##__VA_ARGS__);  \
+    } while (0)
+
+#define LOG_EVERY_MS(level, module, ms, fmt, ...)                                                  \
+    do {                                                                                           \
+        static int64_t log_site_next_ns_;                                                          \
+        LOG_SITE_AT_(level, module, log_site_every_ms(&log_site_next_ns_, ms), fmt, ##__VA_ARGS__); \
+    } while (0)
+
+#define LOG_RATELIMITED(level, module, rate, burst, fmt, ...)                                      \
+    do {                                                                                           \
+        static int64_t log_site_tat_ns_;                                                           \
+        LOG_SITE_AT_(level, module, log_site_ratelimit(&log_site_tat_ns_, rate, burst), fmt,       \
+                     ##__VA_ARGS__);                                                               \
+    } while (0)
+
+/**
+ * @brief 条件日志宏
+ *
+ * 这些宏仅在条件为真时记录日志，避免不必要的字符串格式化开销。
+ */
+#define LOG_FATAL_IF(cond, module, fmt, ...)                                                       \
+    do {                                                                                           \
+        if (cond)                                                                                  \
+            LOG_FATAL(module, fmt, ##__VA_ARGS__);                                                 \
+    } while (0)
+
+#define LOG_ERROR_IF(cond, module, fmt, ...)                                                       \
+    do {                                                                                           \
+        if (cond)                                                                                  \
+            LOG_ERROR(module, fmt, ##__VA_ARGS__);                                                 \
+    } while (0)
+
+#define LOG_WARN_IF(cond, module, fmt, ...)                                                        \
+    do {                                                                                           \
+        if (cond)                                                                                  \
+            LOG_WARN(module, fmt, ##__VA_ARGS__);                                                  \
+    } while (0)
+
+#define LOG_INFO_IF(cond, module, fmt, ...)                                                        \
+    do {                                                                                           \
+        if (cond)                                                                                  \
+            LOG_INFO(module, fmt, ##__VA_ARGS__);                                                  \
+    } while (0)
+
+#define LOG_DEBUG_IF(cond, module, fmt, ...)                                                       \
+    do {                                                                                           \
+        if (cond)                                                                                  \
+            LOG_DEBUG(module, fmt, ##__VA_ARGS__);                                                 \
+    } while (0)
+
+#define LOG_TRACE_IF(cond, module, fmt, ...)                                                       \
+    do {                                                                                           \
+        if (cond)                                                                                  \
+            LOG_TRACE(module, fmt, ##__VA_ARGS__);                                                 \
+    } while (0)
+
+/**
+ * @brief 带退出的致命错误日志宏
+ *
+ * 记录致命错误日志并退出程序，通常用于无法恢复的错误。
+ */
+#define LOG_FATAL_EXIT(module, exit_code, fmt, ...)                                                \
+    do {                                                                                           \
+        LOG_FATAL(module, fmt, ##__VA_ARGS__);                                                     \
+        exit(exit_code);                                                                           \
+    } while (0)
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* CROLINKIT_LOG_H */
@@ -0,0 +1,1084 @@
+/**
+ * @file thread.h
+ * @brief C 线程池库的公共头文件。
+ *
+ * 定义了用于创建、管理和使用线程池的公共 API。
+ * 这包括任务定义、线程池管理功能以及用于监控和调试的实用程序。
+ */
+#ifndef THREAD_H
+#define THREAD_H
+
+#include <pthread.h> // 用于 pthread_t，尽管现在是不透明结构的一部分。
+// 保留它是为了通用完整性，尽管如果所有 pthread 类型都隐藏在不透明 API 后面，
+// 则并非严格需要。
+#include <stddef.h> // 用于 size_t
+#include <stdint.h> // 用于 uint64_t
+
+/**
+ * @brief 任务名称的最大长度，包括空终止符。
+ *
+ * 此宏定义用于确定 `task_t` 结构中 `task_name` 缓冲区的大小，
+ * 以及库中其他地方存储任务名称的缓冲区的大小。
+ */
+#define MAX_TASK_NAME_LEN 64
+
+// 日志宏 (使用日志模块)
+#include "log.h" // 包含日志模块的头文件
+
+/**
+ * @def TPOOL_DEBUG
+ * @brief 用于调试日志消息的宏。
+ *
+ * 使用日志模块的 LOG_DEBUG 函数记录调试日志。
+ * 这些日志只在调试级别下可见，包含详细的内部状态信息。
+ */
+#define TPOOL_DEBUG(fmt, ...) LOG_DEBUG(LOG_MODULE_THREAD, fmt, ##__VA_ARGS__)
+
+/**
+ * @def TPOOL_TRACE
+ * @brief 用于跟踪日志消息的宏。
+ *
+ * 使用日志模块的 LOG_TRACE 函数记录最详细的跟踪日志。
+ * 这些日志只在跟踪级别下可见，包含非常详细的内部状态和流程信息。
+ */
+#define TPOOL_TRACE(fmt, ...) LOG_TRACE(LOG_MODULE_THREAD, fmt, ##__VA_ARGS__)
+
+/**
+ * @def TPOOL_LOG
+ * @brief 用于一般日志消息的宏。
+ *
+ * 使用日志模块的 LOG_INFO 函数记录日志。
+ * 这些日志在信息级别下可见，包含重要的状态变化和操作信息。
+ */
+#define TPOOL_LOG(fmt, ...) LOG_INFO(LOG_MODULE_THREAD, fmt, ##__VA_ARGS__)
+
+/**
+ * @def TPOOL_WARN
+ * @brief 用于警告日志消息的宏。
+ *
+ * 使用日志模块的 LOG_WARN 函数记录警告日志。
+ * 这些日志在警告级别下可见，包含可能存在的问题或异常情况。
+ */
+#define TPOOL_WARN(fmt, ...) LOG_WARN(LOG_MODULE_THREAD, fmt, ##__VA_ARGS__)
+
+/**
+ * @def TPOOL_ERROR
+ * @brief 用于错误日志消息的宏。
+ *
+ * 使用日志模块的 LOG_ERROR 函数记录错误日志。
+ * 这些日志在错误级别下可见，包含函数执行错误和异常情况。
+ */
+#define TPOOL_ERROR(fmt, ...)                                                                      \
+    LOG_ERROR(LOG_MODULE_THREAD, "(%s:%d) " fmt, __FILE__, __LINE__, ##__VA_ARGS__)
+
+/**
+ * @brief 任务优先级枚举
+ *
+ * 定义任务的优先级级别，数值越小优先级越高
+ */
+typedef enum {
+    TASK_PRIORITY_HIGH = 0,   /**< 高优先级任务 */
+    TASK_PRIORITY_NORMAL = 5, /**< 普通优先级任务 */
+    TASK_PRIORITY_LOW = 10,   /**< 低优先级任务 */
+    TASK_PRIORITY_BACKGROUND = 15 /**< 后台任务，最低优先级 */
+} task_priority_t;
+
+/**
+ * @typedef task_id_t
+ * @brief 任务的唯一标识符类型。
+ *
+ * 用于标识和引用线程池中的特定任务，例如用于取消任务。
+ * 值0保留为无效任务ID。
+ */
+typedef uint64_t task_id_t;
+
+/**
+ * @struct task_t
+ * @brief 表示将由线程池执行的任务。
+ *
+ * 此结构传递给 `thread_pool_add_task` 以定义要执行的工作。
+ */
+typedef struct {
+    void (*function)(void *arg); /**< 指向要执行的函数的指针。 */
+    void *arg;                   /**< 要传递给函数的参数。 */
+    char task_name[MAX_TASK_NAME_LEN]; /**< 任务的名称，用于日志记录/监控。以空字符结尾。 */
+    task_priority_t priority;    /**< 任务的优先级，决定执行顺序 */
+    task_id_t id;                /**< 任务的唯一标识符 */
+} task_t;
+
+/**
+ * @struct thread_pool_task_spec_t
+ * @brief 批量提交时描述单个任务的条目。
+ *
+ * 传递给 `thread_pool_add_tasks`，字段含义与 `thread_pool_add_task` 的参数相同。
+ */
+typedef struct {
+    void (*function)(void *arg); /**< 指向要执行的函数的指针。不能为空。 */
+    void *arg;                   /**< 要传递给函数的参数。 */
+    const char *task_name;       /**< 任务名称，为 NULL 时自动生成包含任务ID的唯一名称。 */
+    task_priority_t priority;    /**< 任务的优先级。 */
+} thread_pool_task_spec_t;
+
+/**
+ * @typedef thread_pool_t
+ * @brief 线程池实例的不透明句柄。
+ *
+ * 此类型用于与线程池交互。实际的结构定义是库内部的。
+ */
+typedef struct thread_pool_s *thread_pool_t;
+
+/**
+ * @enum thread_pool_scheduler_t
+ * @brief 线程池的调度模式，在创建时选择。
+ */
+typedef enum {
+    THREAD_POOL_SCHED_SHARED_QUEUE = 0, /**< 所有任务进入共享的优先级队列 (默认)。 */
+    THREAD_POOL_SCHED_WORK_STEALING = 1 /**< 工作线程内提交的任务进入该线程的本地双端队列，
+                                             空闲线程从其他线程窃取；外部提交仍进入共享队列。 */
+} thread_pool_scheduler_t;
+
+/**
+ * @enum thread_pool_pin_policy_t
+ * @brief 工作线程的 CPU 绑定策略。
+ *
+ * 可用 CPU 为 `thread_pool_config_t::cpus` 给出的集合，未给出时为进程当前的 CPU 亲和性。
+ * NUMA 拓扑从 sysfs 读取，无法读取时所有 CPU 视为节点 0。
+ */
+typedef enum {
+    THREAD_POOL_PIN_NONE = 0,     /**< 不绑定到单个 CPU (默认)。给出 CPU 集合时线程可在整个集合上运行。 */
+    THREAD_POOL_PIN_COMPACT = 1,  /**< 线程 i 绑定到第 i 个 CPU，CPU 按节点依次排列，先填满一个节点。 */
+    THREAD_POOL_PIN_SCATTER = 2,  /**< 线程 i 绑定到第 i 个 CPU，CPU 在各节点间轮流排列。 */
+    THREAD_POOL_PIN_NUMA_NODE = 3 /**< 线程按编号轮流归属各 NUMA 节点，可在该节点所有可用的 CPU 上运行。 */
+} thread_pool_pin_policy_t;
+
+/**
+ * @struct thread_pool_config_t
+ * @brief 线程池创建选项。
+ *
+ * 使用前应先调用 `thread_pool_config_init` 填充默认值，再按需修改各字段。
+ */
+typedef struct {
+    int num_threads;          /**< 初始工作线程数，必须为正数。 */
+    int task_slab_size;       /**< 预分配的任务节点数量，0 表示不预分配。 */
+    int task_slab_chunk_size; /**< 预分配节点耗尽时每次扩展的节点数量，必须为正数。 */
+    thread_pool_scheduler_t scheduler; /**< 调度模式。 */
+    int ws_deque_capacity;    /**< 工作窃取模式下每个优先级级别的本地队列容量 (向上取整为 2 的幂)，
+                                   本地队列满时任务回退到共享队列。 */
+    int idle_spin_us;         /**< 空闲工作线程休眠前自旋等待新任务的最长时间 (微秒)，
+                                   0 表示立即休眠 (默认)。适用于对唤醒延迟敏感的线程池。 */
+    int latency_stats;        /**< 非 0 时记录每个任务的排队等待和执行时间，
+                                   供 thread_pool_get_latency_stats 查询。默认为 0 (不记录，无额外开销)。 */
+    const int *cpus;          /**< 工作线程可使用的 CPU 编号，为 NULL 时使用进程当前的 CPU 亲和性。
+                                   数组只在创建时读取。 */
+    int cpu_count;            /**< cpus 中的条目数量。 */
+    thread_pool_pin_policy_t pin_policy; /**< CPU 绑定策略，默认为 THREAD_POOL_PIN_NONE。 */
+    size_t stack_size;        /**< 工作线程栈大小 (字节)，0 表示使用系统默认值。 */
+    int sched_policy;         /**< 工作线程的调度策略 (例如 SCHED_FIFO)，-1 表示继承创建者的调度属性 (默认)。 */
+    int sched_priority;       /**< sched_policy 不为 -1 时使用的调度优先级。 */
+    int queue_capacity;       /**< 排队任务数量上限，0 表示不限制 (默认)。
+                                   队列满时 thread_pool_add_task 阻塞，其他提交函数立即失败。 */
+    int queue_reserved;       /**< 为高优先级任务保留的排队槽位数量，必须小于 queue_capacity。默认为 0。 */
+    task_priority_t queue_reserved_priority; /**< 可以使用保留槽位的最低优先级 (数值不大于它的任务)，
+                                                  默认为 TASK_PRIORITY_HIGH。 */
+    int aging_ms;             /**< 优先级老化间隔 (毫秒)：共享队列和节点队列中的任务每等待这么长时间
+                                   提升一个优先级级别，避免低优先级任务在持续负载下饿死。0 表示不老化 (默认)。 */
+} thread_pool_config_t;
+
+// 公共函数声明
+
+/**
+ * @brief 使用默认值初始化线程池创建选项。
+ *
+ * @param config 要初始化的选项结构。为 NULL 时不执行任何操作。
+ * @param num_threads 初始工作线程数。
+ */
+void thread_pool_config_init(thread_pool_config_t *config, int num_threads);
+
+/**
+ * @brief 按照指定选项创建一个新的线程池。
+ *
+ * 任务节点从线程池私有的 slab 中分配并循环复用，
+ * `task_slab_size` 决定创建时预分配的节点数量，
+ * 节点耗尽后按 `task_slab_chunk_size` 成块扩展，直到线程池销毁才释放。
+ *
+ * @param config 创建选项。不能为空。
+ * @return 成功时返回指向新创建的 thread_pool_t 实例的指针，
+ *         错误时返回 NULL (例如，内存分配失败，无效参数)。
+ */
+thread_pool_t thread_pool_create_with_config(const thread_pool_config_t *config);
+
+/**
+ * @brief 创建一个新的线程池。
+ *
+ * 使用指定数量的工作线程和默认选项初始化线程池。
+ *
+ * @param num_threads 要在池中创建的工作线程数。必须为正数。
+ * @return 成功时返回指向新创建的 thread_pool_t 实例的指针，
+ *         错误时返回 NULL (例如，内存分配失败，无效参数)。
+ */
+thread_pool_t thread_pool_create(int num_threads);
+
+/**
+ * @brief向线程池的队列中添加一个新任务。
+ *
+ * 该任务将被一个可用的工作线程拾取以执行。
+ * 线程池设置了队列容量且队列已满时，阻塞直到有空位或线程池关闭，
+ * 等同于 timeout_ms 为负数的 `thread_pool_add_task_timeout`。
+ *
+ * @param pool 指向 thread_pool_t 实例的指针。
+ * @param function 指向定义任务的函数的指针。不能为空。
+ * @param arg 要传递给任务函数的参数。如果函数期望，可以为 NULL。
+ * @param task_name 任务的描述性名称。如果为 NULL，将使用 "unnamed_task"。
+ *                  该名称被复制到任务结构中。
+ * @param priority 任务的优先级，决定执行顺序。默认为 TASK_PRIORITY_NORMAL。
+ * @return 成功时返回 0，错误时返回 -1 (例如，pool 为 NULL，function 为 NULL，
+ *         池正在关闭，任务节点的内存分配失败)。
+ */
+task_id_t thread_pool_add_task(thread_pool_t pool, void (*function)(void *), void *arg,
+                         const char *task_name, task_priority_t priority);
+
+/**
+ * @brief 向线程池添加任务，队列已满时最多等待指定时间。
+ *
+ * 仅对设置了 `thread_pool_config_t::queue_capacity` 的线程池有区别：
+ * 队列已满 (或只剩当前优先级不能使用的保留槽位) 时，在条件变量上等待工作线程取走任务，
+ * 每取走一个任务只唤醒一个能使用该槽位的等待者。从本线程池的工作线程中调用时不等待，
+ * 以免所有工作线程互相等待。
+ *
+ * @param pool 指向 thread_pool_t 实例的指针。
+ * @param function 指向定义任务的函数的指针。不能为空。
+ * @param arg 要传递给任务函数的参数。
+ * @param task_name 任务的描述性名称。如果为 NULL，将使用 "unnamed_task"。
+ * @param priority 任务的优先级。
+ * @param timeout_ms 最长等待时间 (毫秒)，0 表示不等待，负数表示一直等待。
+ * @return 成功时返回任务ID，超时、线程池关闭或其他错误时返回 0。
+ */
+task_id_t thread_pool_add_task_timeout(thread_pool_t pool, void (*function)(void *), void *arg,
+                                       const char *task_name, task_priority_t priority, int timeout_ms);
+
+/**
+ * @brief 向线程池添加任务，队列已满时立即失败。
+ *
+ * 等同于 timeout_ms 为 0 的 `thread_pool_add_task_timeout`。
+ *
+ * @return 成功时返回任务ID，队列已满或其他错误时返回 0。
+ */
+task_id_t thread_pool_try_add_task(thread_pool_t pool, void (*function)(void *), void *arg,
+                                   const char *task_name, task_priority_t priority);
+
+/**
+ * @brief 向线程池添加一个匿名任务。
+ *
+ * 适合提交频率高、执行时间短的任务：不生成或复制任务名称，不检查重名，也不登记到名称索引，
+ * 其余行为 (优先级调度、队列已满时阻塞、按任务ID取消和查询) 与 `thread_pool_add_task` 相同。
+ * 匿名任务不能通过名称查找或取消，在运行中任务名称和快照中显示为 "[anonymous]"。
+ *
+ * @param pool 指向 thread_pool_t 实例的指针。
+ * @param function 指向定义任务的函数的指针。不能为空。
+ * @param arg 要传递给任务函数的参数。
+ * @param priority 任务的优先级。
+ * @return 成功时返回任务ID，错误时返回 0，与 `thread_pool_add_task` 相同。
+ */
+task_id_t thread_pool_add_anonymous_task(thread_pool_t pool, void (*function)(void *), void *arg,
+                                         task_priority_t priority);
+
+/**
+ * @brief 向线程池添加一个倾向于在指定 NUMA 节点上执行的任务。
+ *
+ * 仅当线程池使用共享队列调度并设置了 CPU 绑定策略时，任务才进入该节点的运行队列，
+ * 由归属该节点的工作线程优先执行；其他情况下 (未绑定、工作窃取模式、节点无效或没有归属该节点的线程)
+ * 等同于 `thread_pool_add_task`。节点上最后一个工作线程退出时，剩余任务转回共享队列。
+ *
+ * @param pool 指向 thread_pool_t 实例的指针。
+ * @param function 指向定义任务的函数的指针。不能为空。
+ * @param arg 要传递给任务函数的参数。
+ * @param task_name 任务的描述性名称。如果为 NULL，将使用 "unnamed_task"。
+ * @param priority 任务的优先级。
+ * @param numa_node 期望执行任务的 NUMA 节点编号，负数表示不指定。
+ * @return 成功时返回任务ID，错误时返回 0，与 `thread_pool_add_task` 相同。
+ */
+task_id_t thread_pool_add_task_on_node(thread_pool_t pool, void (*function)(void *), void *arg,
+                                       const char *task_name, task_priority_t priority, int numa_node);
+
+/**
+ * @brief 向线程池添加一个带截止时间的任务。
+ *
+ * 带截止时间的任务进入共享运行队列中的截止时间堆。优先级仍然决定级别，最早截止时间优先 (EDF)
+ * 只在同一级别内生效：同级带截止时间的任务按截止时间先后、截止时间相同时先提交者优先，
+ * 先于同级的其他任务执行 (包括工作窃取模式下的本地队列和 NUMA 节点队列中的任务)，
+ * 但不会越过更高级别的任务。启用优先级老化时，截止时间堆中最高级别、截止时间最早的任务
+ * 与队列中的任务一样按等待时间提升级别。不使用此函数提交任务的线程池完全按优先级调度。
+ * 截止时间只决定执行顺序，过了截止时间的任务仍会执行。可以通过返回的任务ID取消。
+ *
+ * @param pool 指向 thread_pool_t 实例的指针。
+ * @param function 指向定义任务的函数的指针。不能为空。
+ * @param arg 要传递给任务函数的参数。
+ * @param task_name 任务的描述性名称。如果为 NULL，将使用 "unnamed_task"。
+ * @param priority 任务的优先级，用于队列容量的保留槽位判断和延迟统计的分级，不影响执行顺序。
+ * @param deadline_ms 截止时间，从提交时起算的毫秒数。
+ * @return 成功时返回任务ID，队列已满或其他错误时返回 0。
+ */
+task_id_t thread_pool_add_task_with_deadline(thread_pool_t pool, void (*function)(void *), void *arg,
+                                             const char *task_name, task_priority_t priority,
+                                             unsigned int deadline_ms);
+
+/**
+ * @brief 向线程池添加一个延迟执行的任务。
+ *
+ * 任务先进入由独立定时器线程驱动的分级时间轮 (1 毫秒精度)，至少经过 delay_ms 毫秒后
+ * 进入共享运行队列，再与普通任务一样按优先级调度。到期前可以通过返回的任务ID
+ * 使用 `thread_pool_cancel_task` 取消。到期前的任务不计入队列长度，也不受 queue_capacity 限制；
+ * 线程池销毁时尚未到期的任务被取消，其完成句柄以 TASK_FUTURE_CANCELLED 结束。
+ *
+ * @param pool 指向 thread_pool_t 实例的指针。
+ * @param function 指向定义任务的函数的指针。不能为空。
+ * @param arg 要传递给任务函数的参数。
+ * @param task_name 任务的描述性名称。如果为 NULL，将使用 "unnamed_task"。
+ * @param priority 到期后进入运行队列时的优先级。
+ * @param delay_ms 延迟时间 (毫秒)，0 表示由定时器线程立即释放。
+ * @return 成功时返回任务ID，错误时返回 0。
+ */
+task_id_t thread_pool_add_delayed_task(thread_pool_t pool, void (*function)(void *), void *arg,
+                                       const char *task_name, task_priority_t priority, unsigned int delay_ms);
+
+/**
+ * @brief 向线程池添加一个周期执行的任务。
+ *
+ * 首次执行在 initial_delay_ms 毫秒后，此后按固定频率每 period_ms 毫秒执行一次：
+ * 下一次到期时间从上一次到期时间起算，不会因执行耗时而漂移；执行超过一个周期时跳过错过的执行，
+ * 同一周期任务不会重叠执行。所有执行共享同一个任务ID和名称。
+ * 使用 `thread_pool_cancel_task` 停止：等待中的任务立即移除，正在执行的任务完成本次执行后不再继续。
+ *
+ * @param pool 指向 thread_pool_t 实例的指针。
+ * @param function 指向定义任务的函数的指针。不能为空。
+ * @param arg 要传递给任务函数的参数。
+ * @param task_name 任务的描述性名称。如果为 NULL，将使用 "unnamed_task"。
+ * @param priority 每次到期进入运行队列时的优先级。
+ * @param initial_delay_ms 首次执行前的延迟 (毫秒)。
+ * @param period_ms 执行周期 (毫秒)，必须大于 0。
+ * @return 成功时返回任务ID，错误时返回 0。
+ */
+task_id_t thread_pool_add_periodic_task(thread_pool_t pool, void (*function)(void *), void *arg,
+                                        const char *task_name, task_priority_t priority,
+                                        unsigned int initial_delay_ms, unsigned int period_ms);
+
+/**
+ * @brief向线程池的队列中添加一个新任务（使用默认优先级）。
+ *
+ * 该任务将被一个可用的工作线程拾取以执行，使用TASK_PRIORITY_NORMAL优先级。
+ *
+ * @param pool 指向 thread_pool_t 实例的指针。
+ * @param function 指向定义任务的函数的指针。不能为空。
+ * @param arg 要传递给任务函数的参数。如果函数期望，可以为 NULL。
+ * @param task_name 任务的描述性名称。如果为 NULL，将使用 "unnamed_task"。
+ *                  该名称被复制到任务结构中。
+ * @return 成功时返回 0，错误时返回 -1 (例如，pool 为 NULL，function 为 NULL，
+ *         池正在关闭，任务节点的内存分配失败)。
+ */
+task_id_t thread_pool_add_task_default(thread_pool_t pool, void (*function)(void *), void *arg,
+                                 const char *task_name);
+
+/**
+ * @brief 在一次加锁内向线程池批量添加任务。
+ *
+ * 为整批任务分配一段连续的任务ID：第 i 个条目的ID为起始ID加 i，
+ * 失败条目的ID被跳过而不复用。所有条目在同一临界区内入队，
+ * 之后只唤醒与新任务数量相当的等待线程，而不是每个任务发送一次信号。
+ * 单个条目失败 (例如 function 为 NULL、名称重复、节点分配失败) 不会回滚
+ * 已成功入队的条目。
+ *
+ * @param pool 指向 thread_pool_t 实例的指针。
+ * @param tasks 任务条目数组。count 为 0 时可以为 NULL。
+ * @param count 条目数量，不能为负数。
+ * @param task_ids 如果不为 NULL，长度至少为 count，第 i 项被设置为条目 i 的任务ID，
+ *                 条目失败时设置为 0。
+ * @return 成功入队的条目数量；pool 为 NULL、参数无效或池正在关闭时返回 -1。
+ */
+int thread_pool_add_tasks(thread_pool_t pool, const thread_pool_task_spec_t *tasks, int count,
+                          task_id_t *task_ids);
+
+/**
+ * @brief 销毁线程池。
+ *
+ * 通知所有工作线程关闭。工作线程执行完队列中剩余的任务后退出，
+ * 此函数等待它们全部完成；尚未到期的延迟和周期任务被取消，其完成句柄以 TASK_FUTURE_CANCELLED 结束。
+ * 所有相关资源都将被释放。需要更快关闭时使用 `thread_pool_destroy_with_mode`。
+ *
+ * @param pool 指向要销毁的 thread_pool_t 实例的指针。
+ * @return 成功时返回 0，如果池指针为 NULL 则返回 -1。如果池
+ *         已在关闭或已销毁，则可能返回 0 作为无操作。
+ */
+int thread_pool_destroy(thread_pool_t pool);
+
+/**
+ * @brief 检索由工作线程当前执行的任务名称的副本。
+ *
+ * 调用者负责使用 `free_running_task_names()` 释放返回的数组及其中的每个字符串。
+ *
+ * @param pool 指向 thread_pool_t 实例的指针。
+ * @return 一个动态分配的字符串数组 (char **)。此数组的大小
+ *         等于池中的线程数。每个字符串是
+ *         相应线程正在执行的任务名称的副本，或者如果线程
+ *         当前未执行任务，则为 "[idle]"。
+ *         错误时返回 NULL (例如，pool 为 NULL，内存分配失败)。
+ */
+char **thread_pool_get_running_task_names(thread_pool_t pool);
+
+/**
+ * @brief 释放由 `thread_pool_get_running_task_names` 返回的任务名称数组。
+ *
+ * @param task_names 要释放的字符串数组 (char **).
+ * @param count 数组中的字符串数量 (应与调用 `thread_pool_get_running_task_names` 时
+ *              池的 thread_count 相匹配)。
+ */
+void free_running_task_names(char **task_names, int count);
+
+/**
+ * @struct thread_pool_stats_t
+ * @brief 线程池的统计信息。
+ *
+ * 此结构提供线程池的当前状态信息，包括线程数量、任务队列长度等。
+ */
+typedef struct {
+    int thread_count;    /**< 当前线程数量 */
+    int min_threads;     /**< 最小线程数量 */
+    int max_threads;     /**< 最大线程数量 */
+    int idle_threads;    /**< 空闲线程数量 */
+    int task_queue_size; /**< 当前任务队列长度 */
+    int started;         /**< 已启动的线程数量 */
+} thread_pool_stats_t;
+
+/**
+ * @enum thread_pool_worker_status_t
+ * @brief 快照中单个工作线程的状态。
+ */
+typedef enum {
+    THREAD_POOL_WORKER_IDLE = 0,   /**< 空闲，等待任务 */
+    THREAD_POOL_WORKER_BUSY = 1,   /**< 正在执行任务 */
+    THREAD_POOL_WORKER_EXITING = 2 /**< 因调整大小或关闭而正在退出 */
+} thread_pool_worker_status_t;
+
+/**
+ * @struct thread_pool_worker_info_t
+ * @brief 快照中单个工作线程的信息。
+ */
+typedef struct {
+    int thread_id;                      /**< 工作线程ID */
+    thread_pool_worker_status_t status; /**< 工作线程状态 */
+    task_id_t task_id;                  /**< 正在执行的任务ID，不忙碌时为 0 */
+    char task_name[MAX_TASK_NAME_LEN];  /**< 正在执行的任务名称，不忙碌时为空字符串 */
+    unsigned long tasks_completed;      /**< 该线程槽位累计完成的任务数量 */
+} thread_pool_worker_info_t;
+
+/**
+ * @struct thread_pool_snapshot_t
+ * @brief 无锁读取的线程池计数器快照。
+ *
+ * 每个字段各自原子地读取，字段之间不保证处于同一时刻。
+ * 累计计数器在 32 位平台上可能回绕。
+ */
+typedef struct {
+    int thread_count;              /**< 当前线程数量 */
+    int idle_threads;              /**< 空闲线程数量 */
+    int task_queue_size;           /**< 当前排队的任务数量 */
+    unsigned long tasks_submitted; /**< 累计成功提交的任务数量 */
+    unsigned long tasks_completed; /**< 累计执行完成的任务数量 */
+    unsigned long tasks_cancelled; /**< 累计被取消的任务数量 */
+    unsigned long tasks_rejected;  /**< 累计因队列已满而被拒绝的提交次数 */
+} thread_pool_snapshot_t;
+
+/**
+ * @def THREAD_POOL_LATENCY_BUCKETS
+ * @brief 延迟直方图的桶数量。
+ *
+ * 第 0 桶覆盖 [0, 2) 微秒，第 i 桶 (i >= 1) 覆盖 [2^i, 2^(i+1)) 微秒，
+ * 更长的延迟计入最后一个桶。
+ */
+#define THREAD_POOL_LATENCY_BUCKETS 32
+
+/**
+ * @struct thread_pool_latency_histogram_t
+ * @brief 单项延迟的直方图及其汇总值，单位为微秒。
+ *
+ * p50 和 p99 由桶计数估算，取所在桶的上界 (不超过 max_us)。
+ */
+typedef struct {
+    unsigned long count;  /**< 样本数量 */
+    unsigned long p50_us; /**< 中位数估计值 */
+    unsigned long p99_us; /**< 第 99 百分位估计值 */
+    unsigned long max_us; /**< 最大值 */
+    unsigned long buckets[THREAD_POOL_LATENCY_BUCKETS]; /**< 各桶的样本数量 */
+} thread_pool_latency_histogram_t;
+
+/**
+ * @struct thread_pool_latency_stats_t
+ * @brief 单个优先级的任务延迟统计。
+ */
+typedef struct {
+    thread_pool_latency_histogram_t queue_wait; /**< 从提交到开始执行的等待时间 */
+    thread_pool_latency_histogram_t run_time;   /**< 任务函数的执行时间 */
+} thread_pool_latency_stats_t;
+
+/**
+ * @brief 调整线程池大小。
+ *
+ * 根据指定的新线程数量调整线程池大小。如果新线程数量大于当前数量，
+ * 将创建新的线程。如果新线程数量小于当前数量，将优雅地减少线程数量。
+ * 缩小时多出的线程在当前任务结束后退出，调用不等待它们；随后再增加线程时，
+ * 尚未退出的线程直接留用，不会阻塞在它们正在执行的任务上。
+ *
+ * @param pool 指向 thread_pool_t 实例的指针。
+ * @param new_thread_count 新的线程数量。必须大于等于 min_threads 且小于等于 max_threads。
+ * @return 成功时返回 0，错误时返回 -1 (例如，pool 为 NULL，新线程数量超出范围，
+ *         池正在关闭，线程创建失败)。
+ */
+int thread_pool_resize(thread_pool_t pool, int new_thread_count);
+
+/**
+ * @brief 获取线程池的统计信息。
+ *
+ * 返回线程池的当前状态信息，包括线程数量、任务队列长度等。
+ *
+ * @param pool 指向 thread_pool_t 实例的指针。
+ * @param stats 指向 thread_pool_stats_t 结构的指针，用于存储统计信息。
+ * @return 成功时返回 0，错误时返回 -1 (例如，pool 为 NULL，stats 为 NULL)。
+ */
+int thread_pool_get_stats(thread_pool_t pool, thread_pool_stats_t *stats);
+
+/**
+ * @brief 获取指定优先级任务的排队等待和执行时间统计。
+ *
+ * 仅在创建时设置了 `thread_pool_config_t::latency_stats` 的线程池上可用。
+ * 直方图由工作线程在池锁之外无锁地更新，读取同样不获取池锁，
+ * 并发记录时各桶之间可能相差几个样本。超出运行队列级别范围的优先级按入队时的规则钳制。
+ *
+ * @param pool 指向 thread_pool_t 实例的指针。
+ * @param priority 要查询的任务优先级。
+ * @param stats 用于存储统计信息的结构，不能为 NULL。
+ * @return 成功时返回 0，错误时返回 -1 (例如，pool 为 NULL，stats 为 NULL，未启用延迟统计)。
+ */
+int thread_pool_get_latency_stats(thread_pool_t pool, task_priority_t priority, thread_pool_latency_stats_t *stats);
+
+/**
+ * @brief 开始记录线程池事件跟踪。
+ *
+ * 跟踪对进程内的所有线程池生效，记录任务的入队、出队、开始和完成，工作线程的休眠和唤醒，
+ * 以及线程池调整大小。每个事件是一条定长二进制记录，写入产生事件的线程私有的环形缓冲区，
+ * 不格式化字符串也不获取锁；缓冲区写满后覆盖最早的事件。未开始跟踪时每个事件点只有一次原子读取。
+ * 再次调用会清空之前记录的事件并按新的容量重新开始。
+ *
+ * @param events_per_thread 每个线程可保留的最近事件数量，向上取整为 2 的幂，不能为 0。
+ * @return 成功时返回 0，参数无效或内存分配失败时返回 -1。
+ */
+int thread_pool_trace_start(size_t events_per_thread);
+
+/**
+ * @brief 停止记录线程池事件跟踪。已记录的事件保留到下一次 thread_pool_trace_start。
+ */
+void thread_pool_trace_stop(void);
+
+/**
+ * @brief 将已记录的跟踪事件导出为 Chrome trace JSON 文件。
+ *
+ * 生成的文件可以在 chrome://tracing 或 Perfetto 中打开：任务执行和工作线程休眠显示为时间段，
+ * 入队和出队显示为瞬时事件，线程数显示为计数器。跟踪进行中也可以调用，导出期间暂停记录。
+ *
+ * @param path 输出文件路径。
+ * @return 成功时返回 0，path 为 NULL 或文件无法写入时返回 -1。
+ */
+int thread_pool_trace_export_chrome(const char *path);
+
+/**
+ * @brief 无锁地获取线程池计数器和正在运行的任务信息。
+ *
+ * 不获取池的锁，也不分配内存，适合监控程序高频轮询。
+ * 计数器由线程池在状态变化时以原子操作发布；每个工作线程的信息通过序列锁读取，
+ * 因此单个条目的状态、任务ID和名称彼此一致。
+ * 不得在 thread_pool_destroy 开始之后调用。
+ *
+ * @param pool 指向 thread_pool_t 实例的指针。
+ * @param snapshot 用于存储计数器的结构，不能为 NULL。
+ * @param workers 调用者提供的缓冲区，用于存储前 max_workers 个工作线程的信息；max_workers 为 0 时可以为 NULL。
+ * @param max_workers workers 缓冲区可容纳的条目数量。
+ * @return 成功时返回写入 workers 的条目数量 (不超过 max_workers 和当前线程数)，
+ *         参数无效时返回 -1。
+ */
+int thread_pool_get_snapshot(thread_pool_t pool, thread_pool_snapshot_t *snapshot,
+                             thread_pool_worker_info_t *workers, int max_workers);
+
+/**
+ * @brief 设置线程池的最小和最大线程数量。
+ *
+ * 设置线程池允许的线程数量范围。当前线程数量将保持不变，
+ * 除非当前数量超出新的范围。
+ *
+ * @param pool 指向 thread_pool_t 实例的指针。
+ * @param min_threads 最小线程数量，必须大于 0。
+ * @param max_threads 最大线程数量，必须大于等于 min_threads。
+ * @return 成功时返回 0，错误时返回 -1 (例如，pool 为 NULL，无效的线程数量范围)。
+ */
+int thread_pool_set_limits(thread_pool_t pool, int min_threads, int max_threads);
+
+/**
+ * @brief 启用线程池自动动态调整功能
+ *
+ * 根据任务队列长度和空闲线程数量自动调整线程池大小。
+ * 当任务队列长度超过high_watermark时，会增加线程数量。
+ * 当空闲线程数量超过low_watermark时，会减少线程数量。
+ * 线程数量的调整会在指定的时间间隔内最多进行一次，以避免频繁调整。
+ * 线程数量始终保持在min_threads和max_threads之间（通过thread_pool_set_limits设置）。
+ *
+ * @param pool 指向线程池实例的指针
+ * @param high_watermark 任务队列高水位线，当任务队列长度超过此值时增加线程
+ * @param low_watermark 空闲线程高水位线，当空闲线程数超过此值时减少线程
+ * @param adjust_interval 调整检查间隔（毫秒）
+ * @return 成功返回0，失败返回-1（例如，pool为NULL，参数无效）
+ */
+int thread_pool_enable_auto_adjust(thread_pool_t pool, int high_watermark, int low_watermark,
+                                   int adjust_interval);
+
+/**
+ * @enum thread_pool_adjust_policy_t
+ * @brief 自动调整线程数量的策略。
+ */
+typedef enum {
+    THREAD_POOL_ADJUST_WATERMARK = 0, /**< 按队列长度和空闲线程数与水位线比较，每次增减一个线程。 */
+    THREAD_POOL_ADJUST_RATE = 1       /**< 按平滑后的到达率、完成率和估计的排队等待时间
+                                           直接计算目标线程数，一次调整到位。 */
+} thread_pool_adjust_policy_t;
+
+/**
+ * @struct thread_pool_adjust_config_t
+ * @brief 自动调整选项。
+ *
+ * 使用前应先调用 `thread_pool_adjust_config_init` 填充默认值，再按需修改各字段。
+ */
+typedef struct {
+    thread_pool_adjust_policy_t policy; /**< 调整策略，默认为 THREAD_POOL_ADJUST_WATERMARK。 */
+    int high_watermark;       /**< 水位线策略：任务队列高水位线，必须为正数。 */
+    int low_watermark;        /**< 水位线策略：空闲线程高水位线，不能为负数。 */
+    int adjust_interval;      /**< 检查间隔 (毫秒)，必须为正数。速率策略按此间隔采样。 */
+    int target_queue_wait_us; /**< 速率策略：期望的任务排队等待时间 (微秒)，必须为正数。 */
+    int ewma_weight_percent;  /**< 速率策略：每次采样在指数加权移动平均中的权重 (1~100)。 */
+    int hysteresis_percent;   /**< 速率策略：缩减的死区，目标线程数至少比当前少该百分比才缩减 (0~100)。 */
+    int cooldown_ms;          /**< 速率策略：任何一次调整之后再次缩减前的最短间隔 (毫秒)，不能为负数。 */
+} thread_pool_adjust_config_t;
+
+/**
+ * @brief 使用默认值初始化自动调整选项。
+ *
+ * 默认使用水位线策略，高水位线为 1，低水位线为 1，检查间隔为 1000 毫秒；
+ * 速率策略的期望排队等待时间为 10 毫秒，平滑权重为 30%，死区为 25%，缩减冷却时间为 5000 毫秒。
+ *
+ * @param config 要初始化的选项结构。为 NULL 时不执行任何操作。
+ */
+void thread_pool_adjust_config_init(thread_pool_adjust_config_t *config);
+
+/**
+ * @brief 按照指定选项启用线程池自动调整功能。
+ *
+ * 速率策略每个检查间隔采样一次提交和完成的任务数量，以指数加权移动平均估计到达率和
+ * 每个忙碌线程的处理速率，再按 Little 定律由当前队列长度估计排队等待时间。
+ * 目标线程数为承担到达率所需的线程数，加上在期望等待时间内清空积压所需的线程数，
+ * 通过一次 thread_pool_resize 直接调整到目标 (限制在 min_threads 和 max_threads 之间)。
+ * 扩容只要目标大于当前线程数即执行；缩减需要目标低于死区且距上次调整超过冷却时间。
+ * 已启用时调用会更新参数和策略。
+ *
+ * @param pool 指向线程池实例的指针
+ * @param config 自动调整选项，不能为 NULL
+ * @return 成功返回0，失败返回-1（例如，pool为NULL，参数无效，线程池正在关闭）
+ */
+int thread_pool_enable_auto_adjust_with_config(thread_pool_t pool, const thread_pool_adjust_config_t *config);
+
+/**
+ * @brief 禁用线程池自动动态调整功能
+ *
+ * @param pool 指向线程池实例的指针
+ * @return 成功返回0，失败返回-1（例如，pool为NULL）
+ */
+int thread_pool_disable_auto_adjust(thread_pool_t pool);
+
+/**
+ * @brief 任务取消回调函数类型
+ *
+ * 当任务被取消时，将调用此类型的回调函数。
+ * 回调函数接收被取消任务的参数和任务ID。
+ *
+ * @param arg 被取消任务的参数
+ * @param task_id 被取消任务的ID
+ */
+typedef void (*task_cancel_callback_t)(void *arg, task_id_t task_id);
+
+/**
+ * @brief 取消线程池中的任务
+ *
+ * 尝试取消指定ID的任务。如果任务已经开始执行，则无法取消。
+ * 尚未到期的延迟或周期任务直接从时间轮中移除；正在执行的周期任务本次执行照常完成，
+ * 但不再安排后续执行。
+ * 如果任务成功取消，将调用取消回调函数（如果提供）；正在执行的周期任务的取消回调
+ * 在本次执行返回后由工作线程调用一次，回调中可以安全地释放任务参数。
+ *
+ * @param pool 指向线程池实例的指针
+ * @param task_id 要取消的任务ID
+ * @param cancel_callback 任务取消时的回调函数，可以为NULL
+ * @return 成功取消返回0，任务不存在或已开始执行返回-1，参数无效返回-2
+ */
+int thread_pool_cancel_task(thread_pool_t pool, task_id_t task_id, task_cancel_callback_t cancel_callback);
+
+/**
+ * @brief 检查任务是否存在于线程池中
+ *
+ * 检查指定ID的任务是否存在于线程池的队列中或正在执行。
+ *
+ * @param pool 指向线程池实例的指针
+ * @param task_id 要检查的任务ID
+ * @param is_running 如果不为NULL，将设置为1表示任务正在执行，0表示任务在队列中等待
+ * @return 任务存在返回1，任务不存在返回0，参数无效返回-1
+ */
+int thread_pool_task_exists(thread_pool_t pool, task_id_t task_id, int *is_running);
+
+/**
+ * @brief 通过任务名称查找任务ID
+ *
+ * 在线程池中查找指定名称的任务，并返回其任务ID。
+ *
+ * @param pool 指向线程池实例的指针
+ * @param task_name 要查找的任务名称
+ * @param is_running 如果不为NULL，将设置为1表示任务正在执行，0表示任务在队列中等待
+ * @return 成功时返回任务ID（大于0的值），如果任务不存在或参数无效则返回0（无效任务ID）
+ */
+task_id_t thread_pool_find_task_by_name(thread_pool_t pool, const char *task_name, int *is_running);
+
+/**
+ * @brief 通过任务名称取消任务
+ *
+ * 在线程池中查找指定名称的任务，并尝试取消它。
+ * 只有在队列中等待的任务才能被取消，正在运行的任务无法取消。
+ *
+ * @param pool 指向线程池实例的指针
+ * @param task_name 要取消的任务名称
+ * @param cancel_callback 如果不为 NULL，则在任务被取消时调用此函数
+ * @return 成功取消任务返回 0，任务不存在或正在运行返回 -1，参数无效返回 -2
+ */
+int thread_pool_cancel_task_by_name(thread_pool_t pool, const char *task_name,
+                                    task_cancel_callback_t cancel_callback);
+
+/**
+ * @brief 取消任务，正在执行的任务改为请求其协作取消。
+ *
+ * 排队中或尚未到期的任务与 `thread_pool_cancel_task` 相同，被移除并调用取消回调。
+ * 正在执行的任务设置取消标志，任务函数通过 `thread_pool_cancel_requested` 查询后自行提前返回；
+ * 此时不调用取消回调，任务仍按正常完成处理。正在执行的周期任务同时停止后续执行，
+ * 并在本次执行返回后由工作线程调用一次取消回调，回调中可以安全地释放任务参数。
+ *
+ * @param pool 指向线程池实例的指针
+ * @param task_id 要取消的任务ID
+ * @param cancel_callback 排队中的任务或正在执行的周期任务被取消时的回调函数，可以为NULL
+ * @return 排队中的任务已取消返回 0，已为正在执行的任务设置取消标志返回 1，
+ *         任务不存在返回 -1，参数无效返回 -2
+ */
+int thread_pool_request_cancel(thread_pool_t pool, task_id_t task_id, task_cancel_callback_t cancel_callback);
+
+/**
+ * @brief 在任务函数内部检查当前任务是否已被请求取消。
+ *
+ * 只读取线程本地的当前任务和一个原子标志，开销很小，适合在长时间运行的任务的循环中频繁调用。
+ * 取消标志由 `thread_pool_request_cancel` 或以 `THREAD_POOL_DESTROY_CANCEL_RUNNING` 模式
+ * 销毁线程池时设置。
+ *
+ * @return 已请求取消返回 1；未请求取消或不是在线程池任务内部调用时返回 0。
+ */
+int thread_pool_cancel_requested(void);
+
+/**
+ * @enum thread_pool_destroy_mode_t
+ * @brief 销毁线程池时如何处理尚未完成的任务。
+ */
+typedef enum {
+    THREAD_POOL_DESTROY_DRAIN = 0,           /**< 执行完所有排队中的任务后退出 (thread_pool_destroy 的行为)。 */
+    THREAD_POOL_DESTROY_DISCARD_PENDING = 1, /**< 取消所有排队中和尚未到期的任务并调用取消回调，
+                                                  只等待正在执行的任务完成。 */
+    THREAD_POOL_DESTROY_CANCEL_RUNNING = 2   /**< 在 DISCARD_PENDING 的基础上为正在执行的任务设置取消标志，
+                                                  等待它们响应后退出。 */
+} thread_pool_destroy_mode_t;
+
+/**
+ * @brief 按指定模式销毁线程池。
+ *
+ * 除排队任务的处理方式外与 `thread_pool_destroy` 相同。使用 DISCARD_PENDING 或 CANCEL_RUNNING 时，
+ * 销毁耗时取决于正在执行的任务多快结束 (或多快响应取消)，与排队任务的数量无关：
+ * 排队任务在一次加锁内全部移除，释放池锁后在调用线程中依次调用取消回调，然后才等待工作线程退出。
+ * 被取消任务的完成句柄进入 TASK_FUTURE_CANCELLED 状态，依赖图中的任务连同其后继一并取消。
+ *
+ * @param pool 指向要销毁的 thread_pool_t 实例的指针。
+ * @param mode 销毁模式。
+ * @param cancel_callback 每个被取消的任务调用一次的回调函数，可以为 NULL。DRAIN 模式下只对尚未到期的延迟和周期任务
+ *        以及正在执行的周期任务调用；正在执行的周期任务在本次执行返回后由工作线程调用。
+ * @return 成功时返回 0，池指针为 NULL 或模式无效时返回 -1。
+ */
+int thread_pool_destroy_with_mode(thread_pool_t pool, thread_pool_destroy_mode_t mode,
+                                  task_cancel_callback_t cancel_callback);
+
+// --- 任务完成句柄 (future) ---
+
+/**
+ * @typedef task_future_t
+ * @brief 任务完成句柄的不透明类型。
+ *
+ * 句柄采用引用计数：提交或登记时返回的句柄由调用者持有一个引用，
+ * 使用完毕后必须调用 `task_future_release` 释放。任务完成或被取消后句柄仍然有效。
+ */
+typedef struct task_future_s *task_future_t;
+
+/**
+ * @enum task_future_state_t
+ * @brief 任务完成句柄的状态。
+ */
+typedef enum {
+    TASK_FUTURE_PENDING = 0,   /**< 任务在队列中等待或正在执行。 */
+    TASK_FUTURE_COMPLETED = 1, /**< 任务已执行完成。 */
+    TASK_FUTURE_CANCELLED = 2  /**< 任务在执行前被取消或随线程池销毁被丢弃。 */
+} task_future_state_t;
+
+/**
+ * @brief 添加一个新任务并返回其完成句柄。
+ *
+ * 参数与 `thread_pool_add_task` 相同。
+ *
+ * @return 成功时返回任务的完成句柄，错误时返回 NULL。
+ */
+task_future_t thread_pool_add_task_with_future(thread_pool_t pool, void (*function)(void *), void *arg,
+                                               const char *task_name, task_priority_t priority);
+
+/**
+ * @brief 获取已提交任务的完成句柄。
+ *
+ * 同一任务多次调用返回同一句柄，每次调用都增加一个引用。
+ *
+ * @param pool 指向线程池实例的指针
+ * @param task_id 排队中或正在执行的任务ID
+ * @return 任务的完成句柄；任务不存在 (包括已经完成)、参数无效或内存分配失败时返回 NULL。
+ */
+task_future_t thread_pool_get_task_future(thread_pool_t pool, task_id_t task_id);
+
+/**
+ * @brief 在任务函数内部设置当前任务的结果指针。
+ *
+ * 结果在任务完成时交给其完成句柄，可通过 `task_future_get_result` 读取。
+ * 多次调用以最后一次为准。
+ *
+ * @param result 结果指针，其生命周期由调用者管理。
+ * @return 成功返回 0；不是在线程池任务内部调用时返回 -1。
+ */
+int thread_pool_set_task_result(void *result);
+
+/**
+ * @brief 等待任务完成或被取消。
+ *
+ * @param future 任务完成句柄
+ * @param timeout_ms 最长等待时间 (毫秒)，负数表示无限等待
+ * @return 任务已完成或被取消返回 0，超时返回 -1，参数无效返回 -2
+ */
+int task_future_wait(task_future_t future, int timeout_ms);
+
+/**
+ * @brief 等待一组任务全部完成或被取消。
+ *
+ * @param futures 任务完成句柄数组
+ * @param count 句柄数量
+ * @param timeout_ms 整体的最长等待时间 (毫秒)，负数表示无限等待
+ * @return 全部完成返回 0，超时返回 -1，参数无效返回 -2
+ */
+int task_future_wait_all(task_future_t *futures, int count, int timeout_ms);
+
+/**
+ * @brief 等待一组任务中的任意一个完成或被取消。
+ *
+ * @param futures 任务完成句柄数组
+ * @param count 句柄数量
+ * @param timeout_ms 最长等待时间 (毫秒)，负数表示无限等待
+ * @return 已结束任务在数组中的下标 (多个任务已结束时返回最小的下标)，
+ *         超时返回 -1，参数无效或内存分配失败返回 -2
+ */
+int task_future_wait_any(task_future_t *futures, int count, int timeout_ms);
+
+/**
+ * @brief 获取任务完成句柄的当前状态。
+ *
+ * @param future 任务完成句柄
+ * @return 句柄状态；future 为 NULL 时返回 TASK_FUTURE_CANCELLED。
+ */
+task_future_state_t task_future_get_state(task_future_t future);
+
+/**
+ * @brief 获取任务通过 `thread_pool_set_task_result` 设置的结果指针。
+ *
+ * @param future 任务完成句柄
+ * @return 任务已完成时返回其结果指针 (未设置时为 NULL)，任务未完成或被取消时返回 NULL。
+ */
+void *task_future_get_result(task_future_t future);
+
+/**
+ * @brief 获取任务完成句柄对应的任务ID。
+ *
+ * @param future 任务完成句柄
+ * @return 任务ID，future 为 NULL 时返回 0。
+ */
+task_id_t task_future_get_task_id(task_future_t future);
+
+/**
+ * @brief 释放调用者持有的任务完成句柄引用。
+ *
+ * @param future 任务完成句柄，可以为 NULL。
+ */
+void task_future_release(task_future_t future);
+
+// --- 并行循环 (parallel_for / parallel_reduce) ---
+
+/**
+ * @typedef thread_pool_range_fn_t
+ * @brief 并行循环的区间处理函数，处理 [begin, end) 中的每个下标。
+ */
+typedef void (*thread_pool_range_fn_t)(size_t begin, size_t end, void *ctx);
+
+/**
+ * @typedef thread_pool_reduce_fn_t
+ * @brief 并行归约的区间处理函数，把 [begin, end) 的结果累加到 accumulator 中。
+ *
+ * 同一参与线程处理的所有区间共享同一个 accumulator，初始值为 identity。
+ */
+typedef void (*thread_pool_reduce_fn_t)(size_t begin, size_t end, void *accumulator, void *ctx);
+
+/**
+ * @typedef thread_pool_combine_fn_t
+ * @brief 并行归约的合并函数，把 partial 合并到 accumulator 中。
+ */
+typedef void (*thread_pool_combine_fn_t)(void *accumulator, const void *partial, void *ctx);
+
+/**
+ * @brief 把区间 [begin, end) 分块后在线程池中并行处理，返回时所有下标都已处理完。
+ *
+ * 块大小根据线程数自动选择 (约为每个参与线程 4 块，且不小于 grain)，
+ * 参与的线程以原子操作领取下一块，先空闲的线程自然领取更多块。
+ * 调用线程也参与处理而不是阻塞等待，因此可以在线程池的任务中嵌套调用。
+ * 整个调用只提交不超过线程数的辅助任务 (使用自动生成的名称，不受 queue_capacity 限制)，
+ * 不为每个块或每个下标分配内存；区间处理完时尚未开始的辅助任务会被撤回。
+ *
+ * @param pool 线程池。
+ * @param begin 区间起点。
+ * @param end 区间终点 (不含)，不大于 begin 时直接返回。
+ * @param grain 最小块大小，0 表示 1。
+ * @param fn 区间处理函数，不能为空。
+ * @param ctx 传给 fn 的参数。
+ * @return 成功返回 0，参数无效返回 -2。
+ */
+int thread_pool_parallel_for(thread_pool_t pool, size_t begin, size_t end, size_t grain, thread_pool_range_fn_t fn,
+                             void *ctx);
+
+/**
+ * @brief 分块并行归约区间 [begin, end)，分块和调度方式与 `thread_pool_parallel_for` 相同。
+ *
+ * 每个参与线程拥有一个以 identity 初始化的累加值，fn 把块的结果累加到其中；
+ * 全部块处理完后，调用线程按参与线程的顺序用 combine 把各累加值合并到 result。
+ * combine 需要满足结合律，且 identity 是它的单位元。
+ *
+ * @param pool 线程池。
+ * @param begin 区间起点。
+ * @param end 区间终点 (不含)。
+ * @param grain 最小块大小，0 表示 1。
+ * @param fn 区间归约函数，不能为空。
+ * @param combine 合并函数，不能为空。
+ * @param identity 累加值的初始值，大小为 value_size 字节。
+ * @param value_size 累加值的大小 (字节)，必须大于 0。
+ * @param result 输出归约结果，大小为 value_size 字节；区间为空时为 identity。
+ * @param ctx 传给 fn 和 combine 的参数。
+ * @return 成功返回 0，内存分配失败返回 -1，参数无效返回 -2。
+ */
+int thread_pool_parallel_reduce(thread_pool_t pool, size_t begin, size_t end, size_t grain,
+                                thread_pool_reduce_fn_t fn, thread_pool_combine_fn_t combine, const void *identity,
+                                size_t value_size, void *result, void *ctx);
+
+// --- 任务依赖图 (task graph) ---
+
+/**
+ * @typedef task_graph_t
+ * @brief 任务依赖图的不透明类型。
+ *
+ * 依赖图中的每个任务声明它的前驱任务，最后一个前驱完成时立即提交到线程池执行，
+ * 无需轮询完成状态。同一张图可以反复运行 (例如每帧一次)，运行时不分配内存。
+ */
+typedef struct task_graph_s *task_graph_t;
+
+/**
+ * @brief 创建一个在指定线程池上执行的空依赖图。
+ *
+ * @param pool 执行任务的线程池，必须在依赖图销毁之后才能销毁。
+ * @return 依赖图，参数无效或内存分配失败时返回 NULL。
+ */
+task_graph_t task_graph_create(thread_pool_t pool);
+
+/**
+ * @brief 向依赖图添加一个任务。
+ *
+ * 任务ID在添加时分配，此后每次运行都使用同一ID，可以配合 `thread_pool_task_exists`
+ * 和 `thread_pool_cancel_task` 使用。前驱只能是同一张图中已经添加的任务，因此图中不会出现环。
+ * 只能在依赖图未运行时添加。
+ *
+ * @param graph 依赖图。
+ * @param function 任务函数，不能为空。
+ * @param arg 任务参数。
+ * @param task_name 任务名称，为 NULL 时自动生成；同一时刻线程池中的任务名称不能重复。
+ * @param priority 提交到线程池时的优先级。
+ * @param deps 前驱任务ID数组，dep_count 为 0 时可以为 NULL。
+ * @param dep_count 前驱任务数量。
+ * @return 任务ID；参数无效、前驱不属于该图、依赖图正在运行或内存分配失败时返回 0。
+ */
+task_id_t task_graph_add_task(task_graph_t graph, void (*function)(void *), void *arg, const char *task_name,
+                              task_priority_t priority, const task_id_t *deps, int dep_count);
+
+/**
+ * @brief 开始运行依赖图：提交所有没有前驱的任务，其余任务在前驱全部完成后自动提交。
+ *
+ * 依赖图中的任务不受 `thread_pool_config_t::queue_capacity` 限制。
+ * 根任务提交失败 (线程池正在关闭、名称重复或内存分配失败) 时，该任务连同其后继被取消并返回 -1；
+ * 此时其他已提交的根任务照常执行，仍需调用 `task_graph_wait` 等待本次运行结束。
+ *
+ * @param graph 依赖图。
+ * @return 成功返回 0，上一次运行尚未结束或有根任务未能提交返回 -1，参数无效返回 -2。
+ */
+int task_graph_run(task_graph_t graph);
+
+/**
+ * @brief 等待依赖图的本次运行结束 (所有任务都已完成或被取消)。
+ *
+ * 不要在同一线程池的任务中等待，以免占住工作线程导致图无法完成。
+ *
+ * @param graph 依赖图。
+ * @param timeout_ms 最长等待时间 (毫秒)，负数表示无限等待。
+ * @return 全部任务完成返回 0，运行结束但有任务被取消返回 1，超时返回 -1，参数无效返回 -2。
+ */
+int task_graph_wait(task_graph_t graph, int timeout_ms);
+
+/**
+ * @brief 取消依赖图中的一个任务及其所有后继任务。
+ *
+ * 尚未提交的任务直接取消，已在队列中的任务通过 `thread_pool_cancel_task` 取消
+ * (对依赖图中的任务直接调用 `thread_pool_cancel_task` 效果相同)。
+ * 每个被取消的任务都以其参数调用一次 cancel_callback。正在执行或已完成的任务无法取消。
+ *
+ * @param graph 依赖图。
+ * @param task_id 要取消的任务ID。
+ * @param cancel_callback 取消回调，可以为 NULL。
+ * @return 成功取消返回 0，任务不属于该图、正在执行、已完成或依赖图未运行返回 -1，参数无效返回 -2。
+ */
+int task_graph_cancel_task(task_graph_t graph, task_id_t task_id, task_cancel_callback_t cancel_callback);
+
+/**
+ * @brief 销毁依赖图。
+ *
+ * @param graph 依赖图，可以为 NULL。
+ * @return 成功返回 0，依赖图正在运行返回 -1。
+ */
+int task_graph_destroy(task_graph_t graph);
+
+#endif /* THREAD_H */
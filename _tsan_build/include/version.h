@@ -0,0 +1,13 @@
+/**
+ * @file version.h
+ * @brief CrolinKit 版本信息头文件
+ */
+#ifndef CROLINKIT_VERSION_H
+#define CROLINKIT_VERSION_H
+
+#define CROLINKIT_VERSION_MAJOR 1
+#define CROLINKIT_VERSION_MINOR 0
+#define CROLINKIT_VERSION_PATCH 0
+#define CROLINKIT_VERSION "1.0.0"
+
+#endif /* CROLINKIT_VERSION_H */
@@ -0,0 +1,22 @@
+
+# Consider dependencies only in project.
+set(CMAKE_DEPENDS_IN_PROJECT_ONLY OFF)
+
+# The set of languages for which implicit dependencies are needed:
+set(CMAKE_DEPENDS_LANGUAGES
+  )
+
+# The set of dependency files which are needed:
+set(CMAKE_DEPENDS_DEPENDENCY_FILES
+  "/root/repo/src/core/log/src/log.c" "src/core/log/CMakeFiles/log.dir/src/log.c.o" "gcc" "src/core/log/CMakeFiles/log.dir/src/log.c.o.d"
+  "/root/repo/src/core/log/src/log_async.c" "src/core/log/CMakeFiles/log.dir/src/log_async.c.o" "gcc" "src/core/log/CMakeFiles/log.dir/src/log_async.c.o.d"
+  "/root/repo/src/core/log/src/log_binary.c" "src/core/log/CMakeFiles/log.dir/src/log_binary.c.o" "gcc" "src/core/log/CMakeFiles/log.dir/src/log_binary.c.o.d"
+  "/root/repo/src/core/log/src/log_ratelimit.c" "src/core/log/CMakeFiles/log.dir/src/log_ratelimit.c.o" "gcc" "src/core/log/CMakeFiles/log.dir/src/log_ratelimit.c.o.d"
+  )
+
+# Targets to which this target links.
+set(CMAKE_TARGET_LINKED_INFO_FILES
+  )
+
+# Fortran module output directory.
+set(CMAKE_Fortran_TARGET_MODULE_DIR "")
@@ -0,0 +1,17 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/log.dir/src/log.c.o"
+  "CMakeFiles/log.dir/src/log.c.o.d"
+  "CMakeFiles/log.dir/src/log_async.c.o"
+  "CMakeFiles/log.dir/src/log_async.c.o.d"
+  "CMakeFiles/log.dir/src/log_binary.c.o"
+  "CMakeFiles/log.dir/src/log_binary.c.o.d"
+  "CMakeFiles/log.dir/src/log_ratelimit.c.o"
+  "CMakeFiles/log.dir/src/log_ratelimit.c.o.d"
+  "liblog.a"
+  "liblog.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang C)
+  include(CMakeFiles/log.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
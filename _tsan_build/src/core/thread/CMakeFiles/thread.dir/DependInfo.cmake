@@ -0,0 +1,31 @@
+
+# Consider dependencies only in project.
+set(CMAKE_DEPENDS_IN_PROJECT_ONLY OFF)
+
+# The set of languages for which implicit dependencies are needed:
+set(CMAKE_DEPENDS_LANGUAGES
+  )
+
+# The set of dependency files which are needed:
+set(CMAKE_DEPENDS_DEPENDENCY_FILES
+  "/root/repo/src/core/thread/src/thread.c" "src/core/thread/CMakeFiles/thread.dir/src/thread.c.o" "gcc" "src/core/thread/CMakeFiles/thread.dir/src/thread.c.o.d"
+  "/root/repo/src/core/thread/src/thread_affinity.c" "src/core/thread/CMakeFiles/thread.dir/src/thread_affinity.c.o" "gcc" "src/core/thread/CMakeFiles/thread.dir/src/thread_affinity.c.o.d"
+  "/root/repo/src/core/thread/src/thread_deadline.c" "src/core/thread/CMakeFiles/thread.dir/src/thread_deadline.c.o" "gcc" "src/core/thread/CMakeFiles/thread.dir/src/thread_deadline.c.o.d"
+  "/root/repo/src/core/thread/src/thread_future.c" "src/core/thread/CMakeFiles/thread.dir/src/thread_future.c.o" "gcc" "src/core/thread/CMakeFiles/thread.dir/src/thread_future.c.o.d"
+  "/root/repo/src/core/thread/src/thread_graph.c" "src/core/thread/CMakeFiles/thread.dir/src/thread_graph.c.o" "gcc" "src/core/thread/CMakeFiles/thread.dir/src/thread_graph.c.o.d"
+  "/root/repo/src/core/thread/src/thread_index.c" "src/core/thread/CMakeFiles/thread.dir/src/thread_index.c.o" "gcc" "src/core/thread/CMakeFiles/thread.dir/src/thread_index.c.o.d"
+  "/root/repo/src/core/thread/src/thread_latency.c" "src/core/thread/CMakeFiles/thread.dir/src/thread_latency.c.o" "gcc" "src/core/thread/CMakeFiles/thread.dir/src/thread_latency.c.o.d"
+  "/root/repo/src/core/thread/src/thread_parallel.c" "src/core/thread/CMakeFiles/thread.dir/src/thread_parallel.c.o" "gcc" "src/core/thread/CMakeFiles/thread.dir/src/thread_parallel.c.o.d"
+  "/root/repo/src/core/thread/src/thread_slab.c" "src/core/thread/CMakeFiles/thread.dir/src/thread_slab.c.o" "gcc" "src/core/thread/CMakeFiles/thread.dir/src/thread_slab.c.o.d"
+  "/root/repo/src/core/thread/src/thread_timer.c" "src/core/thread/CMakeFiles/thread.dir/src/thread_timer.c.o" "gcc" "src/core/thread/CMakeFiles/thread.dir/src/thread_timer.c.o.d"
+  "/root/repo/src/core/thread/src/thread_trace.c" "src/core/thread/CMakeFiles/thread.dir/src/thread_trace.c.o" "gcc" "src/core/thread/CMakeFiles/thread.dir/src/thread_trace.c.o.d"
+  "/root/repo/src/core/thread/src/thread_ws.c" "src/core/thread/CMakeFiles/thread.dir/src/thread_ws.c.o" "gcc" "src/core/thread/CMakeFiles/thread.dir/src/thread_ws.c.o.d"
+  )
+
+# Targets to which this target links.
+set(CMAKE_TARGET_LINKED_INFO_FILES
+  "/root/repo/_tsan_build/src/core/log/CMakeFiles/log.dir/DependInfo.cmake"
+  )
+
+# Fortran module output directory.
+set(CMAKE_Fortran_TARGET_MODULE_DIR "")
@@ -0,0 +1,33 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/thread.dir/src/thread.c.o"
+  "CMakeFiles/thread.dir/src/thread.c.o.d"
+  "CMakeFiles/thread.dir/src/thread_affinity.c.o"
+  "CMakeFiles/thread.dir/src/thread_affinity.c.o.d"
+  "CMakeFiles/thread.dir/src/thread_deadline.c.o"
+  "CMakeFiles/thread.dir/src/thread_deadline.c.o.d"
+  "CMakeFiles/thread.dir/src/thread_future.c.o"
+  "CMakeFiles/thread.dir/src/thread_future.c.o.d"
+  "CMakeFiles/thread.dir/src/thread_graph.c.o"
+  "CMakeFiles/thread.dir/src/thread_graph.c.o.d"
+  "CMakeFiles/thread.dir/src/thread_index.c.o"
+  "CMakeFiles/thread.dir/src/thread_index.c.o.d"
+  "CMakeFiles/thread.dir/src/thread_latency.c.o"
+  "CMakeFiles/thread.dir/src/thread_latency.c.o.d"
+  "CMakeFiles/thread.dir/src/thread_parallel.c.o"
+  "CMakeFiles/thread.dir/src/thread_parallel.c.o.d"
+  "CMakeFiles/thread.dir/src/thread_slab.c.o"
+  "CMakeFiles/thread.dir/src/thread_slab.c.o.d"
+  "CMakeFiles/thread.dir/src/thread_timer.c.o"
+  "CMakeFiles/thread.dir/src/thread_timer.c.o.d"
+  "CMakeFiles/thread.dir/src/thread_trace.c.o"
+  "CMakeFiles/thread.dir/src/thread_trace.c.o.d"
+  "CMakeFiles/thread.dir/src/thread_ws.c.o"
+  "CMakeFiles/thread.dir/src/thread_ws.c.o.d"
+  "libthread.a"
+  "libthread.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang C)
+  include(CMakeFiles/thread.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
@@ -0,0 +1,11 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/log_compile_level_test.dir/log_compile_level_test.c.o"
+  "CMakeFiles/log_compile_level_test.dir/log_compile_level_test.c.o.d"
+  "log_compile_level_test"
+  "log_compile_level_test.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang C)
+  include(CMakeFiles/log_compile_level_test.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
@@ -0,0 +1,11 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/log_unit_test.dir/log_unit_test.c.o"
+  "CMakeFiles/log_unit_test.dir/log_unit_test.c.o.d"
+  "log_unit_test"
+  "log_unit_test.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang C)
+  include(CMakeFiles/log_unit_test.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
@@ -0,0 +1,10 @@
+# CMake generated Testfile for 
+# Source directory: /root/repo/tests/modules/log/src
+# Build directory: /root/repo/_tsan_build/tests/modules/log/src
+# 
+# This file includes the relevant testing commands required for 
+# testing this directory and lists subdirectories to be tested as well.
+add_test(log_unit_test "/root/repo/_tsan_build/tests/modules/log/src/log_unit_test")
+set_tests_properties(log_unit_test PROPERTIES  _BACKTRACE_TRIPLES "/root/repo/tests/modules/log/src/CMakeLists.txt;8;add_test;/root/repo/tests/modules/log/src/CMakeLists.txt;0;")
+add_test(log_compile_level_test "/root/repo/_tsan_build/tests/modules/log/src/log_compile_level_test")
+set_tests_properties(log_compile_level_test PROPERTIES  _BACKTRACE_TRIPLES "/root/repo/tests/modules/log/src/CMakeLists.txt;18;add_test;/root/repo/tests/modules/log/src/CMakeLists.txt;0;")
@@ -0,0 +1,11 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/thread_auto_adjust.dir/thread_auto_adjust.c.o"
+  "CMakeFiles/thread_auto_adjust.dir/thread_auto_adjust.c.o.d"
+  "thread_auto_adjust"
+  "thread_auto_adjust.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang C)
+  include(CMakeFiles/thread_auto_adjust.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
@@ -0,0 +1,11 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/thread_cancel_test.dir/thread_cancel_test.c.o"
+  "CMakeFiles/thread_cancel_test.dir/thread_cancel_test.c.o.d"
+  "thread_cancel_test"
+  "thread_cancel_test.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang C)
+  include(CMakeFiles/thread_cancel_test.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
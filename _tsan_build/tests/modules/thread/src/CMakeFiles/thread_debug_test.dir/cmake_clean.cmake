@@ -0,0 +1,11 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/thread_debug_test.dir/thread_debug_test.c.o"
+  "CMakeFiles/thread_debug_test.dir/thread_debug_test.c.o.d"
+  "thread_debug_test"
+  "thread_debug_test.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang C)
+  include(CMakeFiles/thread_debug_test.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
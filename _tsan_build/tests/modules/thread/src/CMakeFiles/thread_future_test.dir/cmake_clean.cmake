@@ -0,0 +1,11 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/thread_future_test.dir/thread_future_test.c.o"
+  "CMakeFiles/thread_future_test.dir/thread_future_test.c.o.d"
+  "thread_future_test"
+  "thread_future_test.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang C)
+  include(CMakeFiles/thread_future_test.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
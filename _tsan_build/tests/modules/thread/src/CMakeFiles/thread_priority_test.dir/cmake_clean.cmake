@@ -0,0 +1,11 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/thread_priority_test.dir/thread_priority_test.c.o"
+  "CMakeFiles/thread_priority_test.dir/thread_priority_test.c.o.d"
+  "thread_priority_test"
+  "thread_priority_test.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang C)
+  include(CMakeFiles/thread_priority_test.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
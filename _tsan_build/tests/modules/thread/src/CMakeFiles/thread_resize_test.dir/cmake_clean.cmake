@@ -0,0 +1,11 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/thread_resize_test.dir/thread_resize_test.c.o"
+  "CMakeFiles/thread_resize_test.dir/thread_resize_test.c.o.d"
+  "thread_resize_test"
+  "thread_resize_test.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang C)
+  include(CMakeFiles/thread_resize_test.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
@@ -0,0 +1,11 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/thread_unit_test.dir/thread_unit_test.c.o"
+  "CMakeFiles/thread_unit_test.dir/thread_unit_test.c.o.d"
+  "thread_unit_test"
+  "thread_unit_test.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang C)
+  include(CMakeFiles/thread_unit_test.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
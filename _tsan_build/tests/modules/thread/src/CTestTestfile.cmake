@@ -0,0 +1,22 @@
+# CMake generated Testfile for 
+# Source directory: /root/repo/tests/modules/thread/src
+# Build directory: /root/repo/_tsan_build/tests/modules/thread/src
+# 
+# This file includes the relevant testing commands required for 
+# testing this directory and lists subdirectories to be tested as well.
+add_test(ThreadUnitTest "/root/repo/_tsan_build/tests/modules/thread/src/thread_unit_test")
+set_tests_properties(ThreadUnitTest PROPERTIES  _BACKTRACE_TRIPLES "/root/repo/tests/modules/thread/src/CMakeLists.txt;5;add_test;/root/repo/tests/modules/thread/src/CMakeLists.txt;0;")
+add_test(ThreadResizeTest "/root/repo/_tsan_build/tests/modules/thread/src/thread_resize_test")
+set_tests_properties(ThreadResizeTest PROPERTIES  _BACKTRACE_TRIPLES "/root/repo/tests/modules/thread/src/CMakeLists.txt;11;add_test;/root/repo/tests/modules/thread/src/CMakeLists.txt;0;")
+add_test(ThreadAutoAdjustTest "/root/repo/_tsan_build/tests/modules/thread/src/thread_auto_adjust")
+set_tests_properties(ThreadAutoAdjustTest PROPERTIES  _BACKTRACE_TRIPLES "/root/repo/tests/modules/thread/src/CMakeLists.txt;17;add_test;/root/repo/tests/modules/thread/src/CMakeLists.txt;0;")
+add_test(ThreadDebugTest "/root/repo/_tsan_build/tests/modules/thread/src/thread_debug_test")
+set_tests_properties(ThreadDebugTest PROPERTIES  _BACKTRACE_TRIPLES "/root/repo/tests/modules/thread/src/CMakeLists.txt;23;add_test;/root/repo/tests/modules/thread/src/CMakeLists.txt;0;")
+add_test(ThreadPoolRandomTest "/root/repo/_tsan_build/tests/modules/thread/src/thread_pool_test")
+set_tests_properties(ThreadPoolRandomTest PROPERTIES  _BACKTRACE_TRIPLES "/root/repo/tests/modules/thread/src/CMakeLists.txt;29;add_test;/root/repo/tests/modules/thread/src/CMakeLists.txt;0;")
+add_test(ThreadPriorityTest "/root/repo/_tsan_build/tests/modules/thread/src/thread_priority_test")
+set_tests_properties(ThreadPriorityTest PROPERTIES  _BACKTRACE_TRIPLES "/root/repo/tests/modules/thread/src/CMakeLists.txt;35;add_test;/root/repo/tests/modules/thread/src/CMakeLists.txt;0;")
+add_test(ThreadCancelTest "/root/repo/_tsan_build/tests/modules/thread/src/thread_cancel_test")
+set_tests_properties(ThreadCancelTest PROPERTIES  _BACKTRACE_TRIPLES "/root/repo/tests/modules/thread/src/CMakeLists.txt;41;add_test;/root/repo/tests/modules/thread/src/CMakeLists.txt;0;")
+add_test(ThreadFutureTest "/root/repo/_tsan_build/tests/modules/thread/src/thread_future_test")
+set_tests_properties(ThreadFutureTest PROPERTIES  _BACKTRACE_TRIPLES "/root/repo/tests/modules/thread/src/CMakeLists.txt;47;add_test;/root/repo/tests/modules/thread/src/CMakeLists.txt;0;")
@@ -0,0 +1,11 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/log_bench.dir/log_bench.c.o"
+  "CMakeFiles/log_bench.dir/log_bench.c.o.d"
+  "log_bench"
+  "log_bench.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang C)
+  include(CMakeFiles/log_bench.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
@@ -0,0 +1,11 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/thread_bench.dir/thread_bench.c.o"
+  "CMakeFiles/thread_bench.dir/thread_bench.c.o.d"
+  "thread_bench"
+  "thread_bench.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang C)
+  include(CMakeFiles/thread_bench.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
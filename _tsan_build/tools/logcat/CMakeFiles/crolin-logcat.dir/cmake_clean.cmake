@@ -0,0 +1,11 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/crolin-logcat.dir/crolin_logcat.c.o"
+  "CMakeFiles/crolin-logcat.dir/crolin_logcat.c.o.d"
+  "crolin-logcat"
+  "crolin-logcat.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang C)
+  include(CMakeFiles/crolin-logcat.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
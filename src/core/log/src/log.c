@@ -4,7 +4,9 @@
  */
 
 #include "log.h"
+#include "log_internal.h"
 #include <pthread.h>
+#include <sched.h>
 #include <stdarg.h>
 #include <stdio.h>
 #include <stdlib.h>
@@ -25,44 +27,157 @@ static const char *const module_names[] = {"CORE", "THREAD", "LOG"};
 // 日志文件的最大大小（10MB）
 #define MAX_LOG_FILE_SIZE (10 * 1024 * 1024)
 
-// 默认日志轮转配置
+// 日志轮转配置，在 log_deinit 之后仍然保留，由 g_log_config.mutex 保护
+static log_rotation_config_t g_log_rotation = {.max_file_size = MAX_LOG_FILE_SIZE,
+                                               .max_file_count = 5,
+                                               .rotate_on_size = true,
+                                               .rotate_on_time = false,
+                                               .rotate_interval_hours = 24};
+
+// 刷新策略，在 log_deinit 之后仍然保留，由 g_log_config.mutex 保护
+static log_flush_policy_t g_log_flush_policy = {.buffer_size = 0, .flush_bytes = 0, .flush_interval_ms = 0,
+                                                .flush_level = LOG_LEVEL_ERROR};
+
+// 重复日志折叠设置，在 log_deinit 之后仍然保留，由 g_log_config.mutex 保护
 static struct {
-    size_t max_file_size;      // 单个日志文件最大大小（字节）
-    int max_file_count;        // 最大日志文件数量
-    bool rotate_on_size;       // 是否按大小轮转
-    bool rotate_on_time;       // 是否按时间轮转
-    int rotate_interval_hours; // 时间轮转间隔（小时）
-    time_t last_rotate_time;   // 上次轮转时间
-} g_log_rotation = {.max_file_size = MAX_LOG_FILE_SIZE,
-                    .max_file_count = 5,
-                    .rotate_on_size = true,
-                    .rotate_on_time = false,
-                    .rotate_interval_hours = 24,
-                    .last_rotate_time = 0};
+    bool enabled;  // 是否启用
+    int window_ms; // 折叠窗口（毫秒），0 表示一直折叠到出现不同的日志
+} g_log_dedup = {false, 0};
+
+// 格式选项、轮转配置、刷新策略和折叠设置的版本号，在 g_log_config.mutex 下修改后递增，
+// 各输出目标写日志前比较版本号，变化时才同步自己的配置快照
+static unsigned g_log_config_version = 1;
+
+// 采集日志时间戳使用的时钟，log_init 时选择
+static clockid_t g_log_clock = CLOCK_REALTIME;
+
+// 日志文件用户态缓冲区大小的上限
+#define LOG_FLUSH_MAX_BUFFER (64 * 1024 * 1024)
+
+/**
+ * 日志输出目标：一个日志文件及其轮转、刷新和时间戳缓存状态，全部由 lock 保护。
+ *
+ * 没有专用文件的模块共用默认输出目标，通过 log_attach_module_sink 挂接专用文件的模块使用自己的输出目标，
+ * 写日志时只获取所用输出目标的锁，不同输出目标的写入互不阻塞。
+ * 格式选项、轮转配置和刷新策略按 g_log_config_version 同步为快照，写日志时不获取 g_log_config.mutex。
+ * 加锁顺序：输出目标的 lock 在 g_log_config.mutex 之前，持有 g_log_config.mutex 时不能获取输出目标的锁。
+ */
+typedef struct {
+    pthread_mutex_t lock;           // 保护以下字段
+    FILE *file;                     // 日志文件，未打开时为 NULL
+    char path[256];                 // 日志文件路径
+    char *buffer;                   // 日志文件的用户态缓冲区，buffer_size 为 0 时不分配
+    size_t buffer_size;             // 打开文件时使用的缓冲区大小
+    size_t file_bytes;              // 当前日志文件的大小，打开时读取一次，之后按写入的字节数累加
+    time_t last_rotate_time;        // 上次轮转时间
+    time_t next_rotate_time;        // 下一次按时间轮转的时刻
+    size_t pending_bytes;           // 上次刷新后写出的字节数
+    bool due;                       // 已满足刷新条件，等待刷新
+    struct timeval last_flush;      // 上次刷新的时间
+
+    unsigned config_version;        // 已同步的配置版本号
+    log_format_options_t format;    // 格式选项快照
+    log_rotation_config_t rotation; // 轮转配置快照
+    log_flush_policy_t flush;       // 刷新策略快照
+    bool dedup_enabled;             // 折叠设置快照：是否启用
+    int dedup_window_ms;            // 折叠设置快照：折叠窗口
+
+    // 重复日志折叠：上一条实际输出的日志及之后被折叠的次数
+    struct {
+        bool valid;             // 是否有上一条日志
+        uint64_t hash;          // 模块、文件、行号和消息正文的哈希值
+        unsigned long repeats;  // 被折叠的次数
+        struct timeval since;   // 上一条实际输出的时间
+        log_level_t level;      // 以下字段用于输出 "last message repeated N times"
+        log_module_t module;
+        const char *file;
+        int line;
+        const char *func;
+    } dedup;
+
+    // 时间戳前缀缓存："[<time_format>." 部分只在秒数或格式变化时重新渲染
+    struct {
+        bool valid;      // 缓存是否有效，格式选项变化时失效
+        time_t second;   // 缓存对应的秒数
+        char prefix[40]; // "[" + strftime 的结果 + "."
+        size_t length;   // prefix 的长度
+    } time_cache;
+
+    // 后台轮转线程：在锁之外重命名 .1 … .N 备份链，轮转时写日志的线程只需等待一次 rename
+    log_rotator_t rotator;
+} log_sink_t;
+
+// 默认输出目标，log_init 指定的日志文件
+static log_sink_t g_log_default_sink = {.lock = PTHREAD_MUTEX_INITIALIZER, .rotator = LOG_ROTATOR_INITIALIZER};
+
+// 各模块的专用输出目标，锁在首次 log_init 时初始化，之后不再释放，写日志的线程可以无锁取得其地址
+static log_sink_t g_log_module_sinks[LOG_MODULE_MAX];
+static pthread_once_t g_log_module_sinks_once = PTHREAD_ONCE_INIT;
+
+// 各模块是否挂接了专用输出目标，写日志时无锁读取，只能通过 __atomic 内建函数访问
+static int g_log_module_sink_attached[LOG_MODULE_MAX];
+
+// 各模块的输出目标位：控制台和文件，写日志时无锁读取，只能通过 __atomic 内建函数访问
+#define LOG_OUTPUT_CONSOLE 0x1
+#define LOG_OUTPUT_FILE 0x2
+static int g_log_module_outputs[LOG_MODULE_MAX];
+
+// 异步写线程当前持有锁的输出目标，只由写线程访问
+static log_sink_t *g_log_batch_sink;
 
 // 全局日志配置
 static struct {
-    FILE *log_file;                              // 日志文件指针
-    char log_file_path[256];                     // 日志文件路径
-    pthread_mutex_t mutex;                       // 日志互斥锁
+    pthread_mutex_t mutex;                       // 保护配置和模块配置，静态初始化，log_deinit 之后仍可使用
     module_log_config_t modules[LOG_MODULE_MAX]; // 模块配置
     log_format_options_t format;                 // 格式选项
     bool initialized;                            // 是否已初始化
+} g_log_config = {.mutex = PTHREAD_MUTEX_INITIALIZER};
 
-    // 回调函数
+// 最多支持的回调数量
+#define LOG_CALLBACK_MAX 10
+
+/**
+ * 回调表的快照：写日志的线程不加锁地读取当前生效的一份，注册和注销时修改另一份后切换。
+ *
+ * 读者先在 g_log_callback_readers[i] 上登记再复查当前生效的下标，复查通过后表 i 在读者离开前不会被修改；
+ * 注册和注销在 g_log_callback_lock 下把新表写入未生效的一份，切换下标后等待旧表的读者全部离开，
+ * 之后旧表才能在下一次修改时重用。回调函数在任何日志锁之外调用，慢回调不会阻塞其他线程写日志。
+ */
+typedef struct {
+    int count; // 回调数量，只能通过 __atomic 内建函数访问
     struct {
         log_callback_t func; // 回调函数
         void *user_data;     // 用户数据
-    } callbacks[10];         // 最多支持10个回调
-    int callback_count;      // 回调函数数量
-
-    // 线程本地存储
-    pthread_key_t context_key;    // 上下文键
-    bool context_key_initialized; // 上下文键是否已初始化
-} g_log_config = {0};
+    } entries[LOG_CALLBACK_MAX];
+} log_callback_table_t;
+
+static log_callback_table_t g_log_callback_tables[2];
+static int g_log_callback_active;                                     // 当前生效的表，只能通过 __atomic 内建函数访问
+static int g_log_callback_readers[2];                                 // 各表的读者数量，只能通过 __atomic 内建函数访问
+static pthread_mutex_t g_log_callback_lock = PTHREAD_MUTEX_INITIALIZER; // 串行化注册和注销
+
+// 各模块当前生效的级别门限，日志宏和 log_is_level_enabled 无锁读取；
+// 静态初始化为 -1，log_init 之前所有级别都不记录。新增模块时必须在此补上初始值
+_Static_assert(LOG_MODULE_MAX == 3, "log_module_thresholds 的初始值必须覆盖所有模块");
+int log_module_thresholds[LOG_MODULE_MAX] = {
+    [LOG_MODULE_CORE] = -1,
+    [LOG_MODULE_THREAD] = -1,
+    [LOG_MODULE_LOG] = -1,
+};
+
+// 各模块的二进制调用点是否写入二进制日志文件，log_write_binary 无锁读取
+static int g_log_module_binary[LOG_MODULE_MAX];
+
+// 按模块配置更新级别门限，调用者必须持有 g_log_config.mutex
+static void log_update_threshold_locked(log_module_t module)
+{
+    const module_log_config_t *config = &g_log_config.modules[module];
+    __atomic_store_n(&log_module_thresholds[module], config->enabled ? (int)config->level : -1,
+                     __ATOMIC_RELAXED);
+}
 
 // 获取线程ID
-static pid_t log_gettid(void)
+pid_t log_current_tid(void)
 {
 #if defined(__linux__)
     return syscall(SYS_gettid);
@@ -72,58 +187,207 @@ static pid_t log_gettid(void)
 #endif
 }
 
-// 释放线程本地存储的上下文
-static void free_thread_context(void *ptr)
+// 上下文字段的数量和在日志行中的标签，顺序与 log_context_t 的字段相同
+#define LOG_CONTEXT_FIELD_COUNT 4
+static const char *const log_context_tags[LOG_CONTEXT_FIELD_COUNT] = {"CTX", "SID", "UID", "TXN"};
+
+/**
+ * 线程本地的日志上下文：字段内联保存在固定大小的缓冲区中，设置和清除上下文不分配堆内存。
+ * 每次设置或清除时递增 version，上下文前缀在下一条日志写出时按版本号重新渲染一次，
+ * 之后每条日志只需复制已渲染的前缀。
+ */
+typedef struct {
+    unsigned version;                                           // 字段的版本号
+    unsigned rendered_version;                                  // text 对应的版本号
+    bool present[LOG_CONTEXT_FIELD_COUNT];                      // 字段是否已设置
+    char fields[LOG_CONTEXT_FIELD_COUNT][LOG_CONTEXT_FIELD_MAX]; // 字段内容
+    char text[LOG_CONTEXT_TEXT_MAX];                            // 已渲染的上下文前缀
+    size_t text_length;                                         // text 的长度
+} log_thread_context_t;
+
+static _Thread_local log_thread_context_t tls_log_context;
+
+// 前向声明
+static void log_select_clock(void);
+
+// 初始化各模块专用输出目标的锁
+static void log_module_sinks_init(void)
+{
+    for (int i = 0; i < LOG_MODULE_MAX; i++) {
+        pthread_mutex_init(&g_log_module_sinks[i].lock, NULL);
+        pthread_mutex_init(&g_log_module_sinks[i].rotator.mutex, NULL);
+        pthread_cond_init(&g_log_module_sinks[i].rotator.cond, NULL);
+    }
+}
+
+// 计算下一次按时间轮转的时刻，调用者必须持有 sink->lock
+static void log_sink_update_deadline_locked(log_sink_t *sink)
+{
+    sink->next_rotate_time = sink->last_rotate_time + (time_t)sink->rotation.rotate_interval_hours * 3600;
+}
+
+// 日志文件打开后设置缓冲区，读取一次文件大小并确定下一次按时间轮转的时刻，调用者必须持有 sink->lock
+static void log_sink_file_opened_locked(log_sink_t *sink, time_t now)
 {
-    if (ptr) {
-        log_context_t *context = (log_context_t *)ptr;
-        free(context);
+    // 旧文件已关闭，可以释放大小不同的旧缓冲区；setvbuf 只能在打开后、第一次读写之前调用
+    if (sink->buffer && sink->buffer_size != sink->flush.buffer_size) {
+        free(sink->buffer);
+        sink->buffer = NULL;
     }
+    sink->buffer_size = sink->flush.buffer_size;
+    if (sink->file && sink->buffer_size > 0) {
+        if (!sink->buffer) {
+            sink->buffer = (char *)malloc(sink->buffer_size);
+        }
+        if (sink->buffer) {
+            setvbuf(sink->file, sink->buffer, _IOFBF, sink->buffer_size);
+        }
+    }
+
+    struct stat st;
+    sink->file_bytes = 0;
+    if (sink->file && fstat(fileno(sink->file), &st) == 0) {
+        sink->file_bytes = (size_t)st.st_size;
+    }
+    if (sink->last_rotate_time == 0) {
+        sink->last_rotate_time = now;
+    }
+    log_sink_update_deadline_locked(sink);
 }
 
-// 初始化线程本地存储键
-static void init_context_key(void)
+// 打开输出目标的日志文件，调用者必须持有 sink->lock
+static int log_sink_open_locked(log_sink_t *sink, const char *path, time_t now)
 {
-    if (!g_log_config.context_key_initialized) {
-        pthread_key_create(&g_log_config.context_key, free_thread_context);
-        g_log_config.context_key_initialized = true;
+    sink->file = fopen(path, "a");
+    if (!sink->file) {
+        return -3;
+    }
+    if (sink->path != path) {
+        strncpy(sink->path, path, sizeof(sink->path) - 1);
+        sink->path[sizeof(sink->path) - 1] = '\0';
     }
+    log_sink_file_opened_locked(sink, now);
+    return 0;
 }
 
 // 前向声明
-int log_rotate_now(void);
+static void log_dedup_report_locked(log_sink_t *sink, const struct timeval *now);
 
-// 检查并轮转日志文件
-static void check_log_file_rotate(void)
+// 关闭输出目标的日志文件并释放缓冲区，调用者必须持有 sink->lock
+static void log_sink_close_locked(log_sink_t *sink)
 {
-    if (!g_log_config.log_file || !g_log_config.log_file_path[0]) {
-        return;
+    if (sink->dedup.valid) {
+        // 关闭前输出已折叠的次数
+        struct timeval now;
+        log_now(&now);
+        log_dedup_report_locked(sink, &now);
+        sink->dedup.valid = false;
+    }
+    if (sink->file) {
+        fclose(sink->file);
+        sink->file = NULL;
     }
+    free(sink->buffer);
+    sink->buffer = NULL;
+    sink->buffer_size = 0;
+}
 
-    struct stat st;
-    if (stat(g_log_config.log_file_path, &st) != 0) {
+// 同步格式选项、轮转配置、刷新策略和折叠设置的快照，缓冲区大小变化时重新打开日志文件
+// 调用者必须持有 sink->lock，配置变化时短暂获取 g_log_config.mutex
+static int log_sink_sync_locked(log_sink_t *sink)
+{
+    if (sink->config_version == __atomic_load_n(&g_log_config_version, __ATOMIC_ACQUIRE)) {
+        return 0;
+    }
+
+    pthread_mutex_lock(&g_log_config.mutex);
+    sink->format = g_log_config.format;
+    sink->rotation = g_log_rotation;
+    sink->flush = g_log_flush_policy;
+    sink->dedup_enabled = g_log_dedup.enabled;
+    sink->dedup_window_ms = g_log_dedup.window_ms;
+    sink->config_version = __atomic_load_n(&g_log_config_version, __ATOMIC_RELAXED);
+    pthread_mutex_unlock(&g_log_config.mutex);
+
+    sink->time_cache.valid = false;
+    log_sink_update_deadline_locked(sink);
+    if (!sink->dedup_enabled && sink->dedup.valid) {
+        // 停用折叠前输出已折叠的次数
+        struct timeval now;
+        log_now(&now);
+        log_dedup_report_locked(sink, &now);
+        sink->dedup.valid = false;
+    }
+    if (sink->file && sink->buffer_size != sink->flush.buffer_size) {
+        // 缓冲区只能在打开文件后设置，刷新并重新打开日志文件以更换缓冲区
+        fclose(sink->file);
+        sink->file = NULL;
+        return log_sink_open_locked(sink, sink->path, time(NULL));
+    }
+    return 0;
+}
+
+// 执行日志轮转，调用者必须持有 sink->lock
+// 当前文件只改名为待处理文件并重新打开，备份链由轮转线程在锁之外重命名
+// staged 不为 NULL 时返回本次轮转的序号，可用于 log_rotator_wait
+static int log_sink_rotate_locked(log_sink_t *sink, time_t now, unsigned long *staged)
+{
+    // 关闭当前日志文件并改名为待处理文件
+    fclose(sink->file);
+    sink->file = NULL;
+    int result = log_rotator_stage(&sink->rotator, sink->path, sink->rotation.max_file_count - 1, staged);
+    if (result != 0) {
+        // 重命名失败，尝试重新打开原文件
+        log_sink_open_locked(sink, sink->path, now);
+        return result;
+    }
+
+    // 打开新的日志文件
+    sink->last_rotate_time = now;
+    return log_sink_open_locked(sink, sink->path, now);
+}
+
+// 检查并轮转日志文件，调用者必须持有 sink->lock
+// 只比较内存中的字节数和日志记录自带的时间戳，不访问文件系统
+static void log_sink_check_rotate_locked(log_sink_t *sink, const log_record_t *record)
+{
+    if (!sink->file) {
         return;
     }
 
     bool need_rotate = false;
 
     // 检查文件大小
-    if (g_log_rotation.rotate_on_size && st.st_size >= (off_t)g_log_rotation.max_file_size) {
+    if (sink->rotation.rotate_on_size && sink->file_bytes >= sink->rotation.max_file_size) {
         need_rotate = true;
     }
 
     // 检查时间
-    time_t now = time(NULL);
-    if (g_log_rotation.rotate_on_time &&
-        (now - g_log_rotation.last_rotate_time) >= g_log_rotation.rotate_interval_hours * 3600) {
+    if (sink->rotation.rotate_on_time && record->tv.tv_sec >= sink->next_rotate_time) {
         need_rotate = true;
     }
 
     if (need_rotate) {
-        log_rotate_now();
+        log_sink_rotate_locked(sink, record->tv.tv_sec, NULL);
     }
 }
 
+// 获取并锁定模块当前使用的输出目标：挂接了专用文件时为模块的输出目标，否则为默认输出目标
+static log_sink_t *log_sink_acquire(log_module_t module)
+{
+    if (__atomic_load_n(&g_log_module_sink_attached[module], __ATOMIC_ACQUIRE)) {
+        log_sink_t *sink = &g_log_module_sinks[module];
+        pthread_mutex_lock(&sink->lock);
+        // 挂接状态可能在加锁前被撤销，此时改用默认输出目标
+        if (sink->file) {
+            return sink;
+        }
+        pthread_mutex_unlock(&sink->lock);
+    }
+    pthread_mutex_lock(&g_log_default_sink.lock);
+    return &g_log_default_sink;
+}
+
 // 获取日志模块名称
 const char *log_get_module_name(log_module_t module)
 {
@@ -140,7 +404,7 @@ int log_init(const char *log_file, log_level_t level)
         return 0; // 已经初始化
     }
 
-    pthread_mutex_init(&g_log_config.mutex, NULL);
+    pthread_once(&g_log_module_sinks_once, log_module_sinks_init);
 
     // 设置默认格式选项
     g_log_config.format.show_time = true;
@@ -151,6 +415,12 @@ int log_init(const char *log_file, log_level_t level)
     g_log_config.format.use_colors = true;
     g_log_config.format.use_iso_time = true;
     strcpy(g_log_config.format.time_format, "%Y-%m-%d %H:%M:%S");
+    __atomic_add_fetch(&g_log_config_version, 1, __ATOMIC_RELEASE);
+
+    // 时区只在初始化时读取一次，之后每秒最多调用一次 localtime_r
+    tzset();
+    log_select_clock();
+    log_suppress_reset_stats();
 
     // 初始化模块配置
     for (int i = 0; i < LOG_MODULE_MAX; i++) {
@@ -159,20 +429,24 @@ int log_init(const char *log_file, log_level_t level)
         g_log_config.modules[i].file_output = true;
         g_log_config.modules[i].enabled = true;
         g_log_config.modules[i].custom_file = NULL;
+        g_log_config.modules[i].binary_output = false;
+        log_update_threshold_locked((log_module_t)i);
+        __atomic_store_n(&g_log_module_outputs[i], LOG_OUTPUT_CONSOLE | LOG_OUTPUT_FILE, __ATOMIC_RELAXED);
+        __atomic_store_n(&g_log_module_binary[i], 0, __ATOMIC_RELAXED);
     }
 
     // 打开日志文件
-    if (log_file) {
-        g_log_config.log_file = fopen(log_file, "a");
-        if (g_log_config.log_file) {
-            strncpy(g_log_config.log_file_path, log_file, sizeof(g_log_config.log_file_path) - 1);
-        } else {
-            fprintf(stderr, "Failed to open log file: %s\n", log_file);
-        }
+    pthread_mutex_lock(&g_log_default_sink.lock);
+    log_sink_sync_locked(&g_log_default_sink);
+    gettimeofday(&g_log_default_sink.last_flush, NULL);
+    g_log_default_sink.pending_bytes = 0;
+    g_log_default_sink.due = false;
+    g_log_default_sink.path[0] = '\0';
+    if (log_file && log_sink_open_locked(&g_log_default_sink, log_file, time(NULL)) != 0) {
+        fprintf(stderr, "Failed to open log file: %s\n", log_file);
     }
+    pthread_mutex_unlock(&g_log_default_sink.lock);
 
-    // 初始化上下文键
-    init_context_key();
 
     g_log_config.initialized = true;
 
@@ -188,6 +462,7 @@ void log_set_module_level(log_module_t module, log_level_t level)
     if (module >= 0 && module < LOG_MODULE_MAX) {
         pthread_mutex_lock(&g_log_config.mutex);
         g_log_config.modules[module].level = level;
+        log_update_threshold_locked(module);
         pthread_mutex_unlock(&g_log_config.mutex);
     }
 }
@@ -199,6 +474,8 @@ void log_set_module_output(log_module_t module, bool console_on, bool file_on)
         pthread_mutex_lock(&g_log_config.mutex);
         g_log_config.modules[module].console_output = console_on;
         g_log_config.modules[module].file_output = file_on;
+        __atomic_store_n(&g_log_module_outputs[module],
+                         (console_on ? LOG_OUTPUT_CONSOLE : 0) | (file_on ? LOG_OUTPUT_FILE : 0), __ATOMIC_RELAXED);
         pthread_mutex_unlock(&g_log_config.mutex);
     }
 }
@@ -209,10 +486,29 @@ void log_set_module_enable(log_module_t module, bool enable)
     if (module >= 0 && module < LOG_MODULE_MAX) {
         pthread_mutex_lock(&g_log_config.mutex);
         g_log_config.modules[module].enabled = enable;
+        log_update_threshold_locked(module);
+        pthread_mutex_unlock(&g_log_config.mutex);
+    }
+}
+
+// 设置模块的二进制调用点是否写入二进制日志文件
+void log_set_module_binary(log_module_t module, bool enable)
+{
+    if (module >= 0 && module < LOG_MODULE_MAX) {
+        pthread_mutex_lock(&g_log_config.mutex);
+        g_log_config.modules[module].binary_output = enable;
+        __atomic_store_n(&g_log_module_binary[module], enable ? 1 : 0, __ATOMIC_RELAXED);
         pthread_mutex_unlock(&g_log_config.mutex);
     }
 }
 
+// 模块的二进制调用点是否写入二进制日志文件
+bool log_module_binary_output(log_module_t module)
+{
+    return (unsigned)module < (unsigned)LOG_MODULE_MAX &&
+           __atomic_load_n(&g_log_module_binary[module], __ATOMIC_RELAXED) != 0;
+}
+
 // 获取模块的日志级别
 log_level_t log_get_module_level(log_module_t module)
 {
@@ -237,17 +533,10 @@ bool log_get_module_enable(log_module_t module)
     return false;
 }
 
-// 检查指定级别的日志是否会被记录
+// 检查指定级别的日志是否会被记录，只读取一次级别门限，不加锁
 bool log_is_level_enabled(log_module_t module, log_level_t level)
 {
-    if (module >= 0 && module < LOG_MODULE_MAX) {
-        pthread_mutex_lock(&g_log_config.mutex);
-        bool enabled =
-            g_log_config.modules[module].enabled && (level <= g_log_config.modules[module].level);
-        pthread_mutex_unlock(&g_log_config.mutex);
-        return enabled;
-    }
-    return false;
+    return log_level_enabled_fast(module, level);
 }
 
 // 设置日志格式选项
@@ -256,6 +545,7 @@ void log_set_format_options(const log_format_options_t *options)
     if (options) {
         pthread_mutex_lock(&g_log_config.mutex);
         memcpy(&g_log_config.format, options, sizeof(log_format_options_t));
+        __atomic_add_fetch(&g_log_config_version, 1, __ATOMIC_RELEASE);
         pthread_mutex_unlock(&g_log_config.mutex);
     }
 }
@@ -270,110 +560,262 @@ void log_get_format_options(log_format_options_t *options)
     }
 }
 
-// 写入日志
-void log_write(log_level_t level, log_module_t module, const char *file, int line, const char *func,
-               const char *fmt, ...)
+// 按 log_context_t 的字段顺序渲染上下文前缀，返回写入的长度
+static size_t log_render_context_fields(char *buf, size_t size, const char *const fields[LOG_CONTEXT_FIELD_COUNT])
 {
-    if (!g_log_config.initialized) {
-        return;
+    size_t pos = 0;
+    buf[0] = '\0';
+    for (int i = 0; i < LOG_CONTEXT_FIELD_COUNT; i++) {
+        if (!fields[i] || pos >= size) {
+            continue;
+        }
+        int written = snprintf(buf + pos, size - pos, "[%s:%.*s] ", log_context_tags[i], LOG_CONTEXT_FIELD_MAX - 1,
+                               fields[i]);
+        if (written > 0) {
+            pos += (size_t)written;
+        }
     }
+    return pos < size ? pos : size - 1;
+}
 
-    if (!log_is_level_enabled(module, level)) {
-        return;
+// 渲染上下文前缀，context 为NULL时使用当前线程的上下文
+size_t log_render_context(char *buf, size_t size, const log_context_t *context)
+{
+    const char *fields[LOG_CONTEXT_FIELD_COUNT];
+    if (context) {
+        fields[0] = context->context_id;
+        fields[1] = context->session_id;
+        fields[2] = context->user_id;
+        fields[3] = context->transaction_id;
+        return log_render_context_fields(buf, size, fields);
     }
 
-    pthread_mutex_lock(&g_log_config.mutex);
+    log_thread_context_t *tls = &tls_log_context;
+    if (tls->rendered_version != tls->version) {
+        for (int i = 0; i < LOG_CONTEXT_FIELD_COUNT; i++) {
+            fields[i] = tls->present[i] ? tls->fields[i] : NULL;
+        }
+        tls->text_length = log_render_context_fields(tls->text, sizeof(tls->text), fields);
+        tls->rendered_version = tls->version;
+    }
 
-    // 检查日志文件轮转
-    check_log_file_rotate();
+    size_t length = tls->text_length < size ? tls->text_length : size - 1;
+    memcpy(buf, tls->text, length);
+    buf[length] = '\0';
+    return length;
+}
 
-    // 获取当前时间
-    struct timeval tv;
-    gettimeofday(&tv, NULL);
-    struct tm *tm_info = localtime(&tv.tv_sec);
+// 选择采集时间戳的时钟：粗粒度时钟的精度不低于输出的毫秒时才使用它，输出与 CLOCK_REALTIME 一致
+static void log_select_clock(void)
+{
+    g_log_clock = CLOCK_REALTIME;
+#ifdef CLOCK_REALTIME_COARSE
+    struct timespec res;
+    if (clock_getres(CLOCK_REALTIME_COARSE, &res) == 0 && res.tv_sec == 0 && res.tv_nsec <= 1000000L) {
+        g_log_clock = CLOCK_REALTIME_COARSE;
+    }
+#endif
+}
 
-    char time_str[32];
-    strftime(time_str, sizeof(time_str), g_log_config.format.time_format, tm_info);
+// 获取当前时间
+void log_now(struct timeval *tv)
+{
+    struct timespec ts;
+    clock_gettime(g_log_clock, &ts);
+    tv->tv_sec = ts.tv_sec;
+    tv->tv_usec = (suseconds_t)(ts.tv_nsec / 1000);
+}
 
-    // 格式化日志消息
-    char message[1024];
-    va_list args;
-    va_start(args, fmt);
-    vsnprintf(message, sizeof(message), fmt, args);
-    va_end(args);
+// 渲染 "[时间.毫秒] " 前缀，返回写入的长度，调用者必须持有 sink->lock
+static int log_render_time_locked(log_sink_t *sink, char *buf, size_t size, const struct timeval *tv)
+{
+    if (!sink->time_cache.valid || sink->time_cache.second != tv->tv_sec) {
+        struct tm tm_info;
+        char time_str[32];
+        localtime_r(&tv->tv_sec, &tm_info);
+        if (strftime(time_str, sizeof(time_str), sink->format.time_format, &tm_info) == 0) {
+            time_str[0] = '\0';
+        }
+        sink->time_cache.length =
+            (size_t)snprintf(sink->time_cache.prefix, sizeof(sink->time_cache.prefix), "[%s.", time_str);
+        sink->time_cache.second = tv->tv_sec;
+        sink->time_cache.valid = true;
+    }
+
+    // 缓存的前缀之后只需补上三位毫秒数
+    size_t length = sink->time_cache.length;
+    if (length + 6 > size) {
+        return 0;
+    }
+    long ms = (long)tv->tv_usec / 1000;
+    memcpy(buf, sink->time_cache.prefix, length);
+    buf[length++] = (char)('0' + ms / 100);
+    buf[length++] = (char)('0' + ms / 10 % 10);
+    buf[length++] = (char)('0' + ms % 10);
+    buf[length++] = ']';
+    buf[length++] = ' ';
+    buf[length] = '\0';
+    return (int)length;
+}
+
+// 填写一条日志记录
+void log_fill_record(log_record_t *record, log_level_t level, log_module_t module, const char *file, int line,
+                     const char *func, const log_context_t *context, const char *fmt, va_list args)
+{
+    record->level = level;
+    record->module = module;
+    record->file = file;
+    record->line = line;
+    record->func = func;
+    log_now(&record->tv);
+    record->tid = log_current_tid();
+    log_render_context(record->context, sizeof(record->context), context);
+    vsnprintf(record->message, sizeof(record->message), fmt, args);
+}
+
+// 两个时间之间经过的毫秒数
+static long log_elapsed_ms(const struct timeval *from, const struct timeval *to)
+{
+    return (long)(to->tv_sec - from->tv_sec) * 1000 + (long)(to->tv_usec - from->tv_usec) / 1000;
+}
+
+// 距上次刷新经过的毫秒数
+static long log_flush_elapsed_ms(const log_sink_t *sink, const struct timeval *now)
+{
+    return log_elapsed_ms(&sink->last_flush, now);
+}
+
+// 刷新控制台和输出目标的文件，调用者必须持有 sink->lock
+static void log_flush_locked(log_sink_t *sink, const struct timeval *now)
+{
+    fflush(stdout);
+    fflush(stderr);
+    if (sink->file) {
+        fflush(sink->file);
+    }
+    sink->pending_bytes = 0;
+    sink->due = false;
+    sink->last_flush = *now;
+}
+
+// 记录一条日志写出的字节数并按刷新策略判断是否需要刷新，调用者必须持有 sink->lock
+static void log_flush_note_locked(log_sink_t *sink, const log_record_t *record, size_t bytes)
+{
+    const log_flush_policy_t *policy = &sink->flush;
+    sink->pending_bytes += bytes;
+    if (policy->flush_bytes == 0 || sink->pending_bytes >= policy->flush_bytes ||
+        record->level <= policy->flush_level ||
+        (policy->flush_interval_ms > 0 && log_flush_elapsed_ms(sink, &record->tv) >= policy->flush_interval_ms)) {
+        sink->due = true;
+    }
+}
+
+// 是否注册了回调函数，无锁读取
+static bool log_callbacks_registered(void)
+{
+    int index = __atomic_load_n(&g_log_callback_active, __ATOMIC_RELAXED);
+    return __atomic_load_n(&g_log_callback_tables[index].count, __ATOMIC_RELAXED) != 0;
+}
+
+// 调用注册的回调函数，不获取任何日志锁
+static void log_dispatch_callbacks(const log_record_t *record)
+{
+    int index;
+    for (;;) {
+        index = __atomic_load_n(&g_log_callback_active, __ATOMIC_SEQ_CST);
+        if (__atomic_load_n(&g_log_callback_tables[index].count, __ATOMIC_RELAXED) == 0) {
+            return;
+        }
+        // 登记后复查：下标未变时修改者一定会等待本线程离开
+        __atomic_add_fetch(&g_log_callback_readers[index], 1, __ATOMIC_SEQ_CST);
+        if (__atomic_load_n(&g_log_callback_active, __ATOMIC_SEQ_CST) == index) {
+            break;
+        }
+        __atomic_sub_fetch(&g_log_callback_readers[index], 1, __ATOMIC_RELEASE);
+    }
+
+    const log_callback_table_t *table = &g_log_callback_tables[index];
+    int count = __atomic_load_n(&table->count, __ATOMIC_RELAXED);
+    for (int i = 0; i < count; i++) {
+        table->entries[i].func(record->level, record->module, record->file, record->line, record->func,
+                               record->message, table->entries[i].user_data);
+    }
+    __atomic_sub_fetch(&g_log_callback_readers[index], 1, __ATOMIC_RELEASE);
+}
+
+// 发布新的回调表并等待旧表的读者离开，调用者必须持有 g_log_callback_lock
+static void log_callback_publish_locked(const log_callback_table_t *next)
+{
+    int old = __atomic_load_n(&g_log_callback_active, __ATOMIC_RELAXED);
+    log_callback_table_t *table = &g_log_callback_tables[1 - old];
+    memcpy(table->entries, next->entries, sizeof(table->entries));
+    __atomic_store_n(&table->count, next->count, __ATOMIC_RELAXED);
+    __atomic_store_n(&g_log_callback_active, 1 - old, __ATOMIC_SEQ_CST);
+
+    // 返回后旧表中的回调不会再被调用，调用者可以释放 user_data
+    while (__atomic_load_n(&g_log_callback_readers[old], __ATOMIC_SEQ_CST) != 0) {
+        sched_yield();
+    }
+}
+
+// 格式化并输出一条日志记录，按刷新策略标记是否需要刷新，调用者必须持有 sink->lock
+static void log_emit_line_locked(log_sink_t *sink, const log_record_t *record)
+{
+    size_t bytes = 0;
+    int written;
+
+    log_level_t level = record->level;
+    log_module_t module = record->module;
+    const log_format_options_t *format = &sink->format;
+    int outputs = __atomic_load_n(&g_log_module_outputs[module], __ATOMIC_RELAXED);
 
     // 构建完整日志行
     char log_line[2048];
     int pos = 0;
 
     // 添加时间戳
-    if (g_log_config.format.show_time) {
-        pos += snprintf(log_line + pos, sizeof(log_line) - pos, "[%s.%03ld] ", time_str,
-                        tv.tv_usec / 1000);
+    if (format->show_time) {
+        pos += log_render_time_locked(sink, log_line + pos, sizeof(log_line) - pos, &record->tv);
     }
 
     // 添加日志级别
     pos += snprintf(log_line + pos, sizeof(log_line) - pos, "[%s] ", log_level_names[level]);
 
     // 添加线程ID
-    if (g_log_config.format.show_tid) {
-        pos += snprintf(log_line + pos, sizeof(log_line) - pos, "[TID:%ld] ", (long)log_gettid());
+    if (format->show_tid) {
+        pos += snprintf(log_line + pos, sizeof(log_line) - pos, "[TID:%ld] ", (long)record->tid);
     }
 
     // 添加模块名
-    if (g_log_config.format.show_module) {
+    if (format->show_module) {
         pos +=
             snprintf(log_line + pos, sizeof(log_line) - pos, "[%s] ", log_get_module_name(module));
     }
 
     // 添加文件名和行号
-    if (g_log_config.format.show_file_line) {
+    if (format->show_file_line) {
         // 提取文件名（不包括路径）
-        const char *filename = strrchr(file, '/');
-        filename = filename ? filename + 1 : file;
+        const char *filename = strrchr(record->file, '/');
+        filename = filename ? filename + 1 : record->file;
 
-        pos += snprintf(log_line + pos, sizeof(log_line) - pos, "[%s:%d] ", filename, line);
+        pos += snprintf(log_line + pos, sizeof(log_line) - pos, "[%s:%d] ", filename, record->line);
     }
 
     // 添加函数名
-    if (g_log_config.format.show_function) {
-        pos += snprintf(log_line + pos, sizeof(log_line) - pos, "[%s] ", func);
-    }
-
-    // 添加上下文信息（如果有）
-    log_context_t *context = NULL;
-    if (g_log_config.context_key_initialized) {
-        context = pthread_getspecific(g_log_config.context_key);
-        if (context) {
-            if (context->context_id) {
-                pos += snprintf(log_line + pos, sizeof(log_line) - pos, "[CTX:%s] ",
-                                context->context_id);
-            }
-            if (context->session_id) {
-                pos += snprintf(log_line + pos, sizeof(log_line) - pos, "[SID:%s] ",
-                                context->session_id);
-            }
-            if (context->user_id) {
-                pos +=
-                    snprintf(log_line + pos, sizeof(log_line) - pos, "[UID:%s] ", context->user_id);
-            }
-            if (context->transaction_id) {
-                pos += snprintf(log_line + pos, sizeof(log_line) - pos, "[TXN:%s] ",
-                                context->transaction_id);
-            }
-        }
+    if (format->show_function) {
+        pos += snprintf(log_line + pos, sizeof(log_line) - pos, "[%s] ", record->func);
     }
 
-    // 添加日志消息
-    snprintf(log_line + pos, sizeof(log_line) - pos, "%s", message);
+    // 添加上下文信息和日志消息
+    snprintf(log_line + pos, sizeof(log_line) - pos, "%s%s", record->context, record->message);
 
     // 输出到控制台
-    if (g_log_config.modules[module].console_output) {
+    if (outputs & LOG_OUTPUT_CONSOLE) {
         // 根据日志级别选择输出流
         FILE *out = (level <= LOG_LEVEL_ERROR) ? stderr : stdout;
 
         // 添加颜色（如果启用）
-        if (g_log_config.format.use_colors) {
+        if (format->use_colors) {
             const char *color_code = "";
             switch (level) {
                 case LOG_LEVEL_FATAL:
@@ -397,94 +839,272 @@ void log_write(log_level_t level, log_module_t module, const char *file, int lin
                 default:
                     break;
             }
-            fprintf(out, "%s%s\033[0m\n", color_code, log_line);
+            written = fprintf(out, "%s%s\033[0m\n", color_code, log_line);
         } else {
-            fprintf(out, "%s\n", log_line);
+            written = fprintf(out, "%s\n", log_line);
+        }
+        if (written > 0) {
+            bytes += (size_t)written;
         }
-        fflush(out);
     }
 
     // 输出到文件
-    if (g_log_config.log_file && g_log_config.modules[module].file_output) {
-        fprintf(g_log_config.log_file, "%s\n", log_line);
-        fflush(g_log_config.log_file);
+    if (sink->file && (outputs & LOG_OUTPUT_FILE)) {
+        written = fprintf(sink->file, "%s\n", log_line);
+        if (written > 0) {
+            sink->file_bytes += (size_t)written;
+            bytes += (size_t)written;
+        }
     }
+    log_flush_note_locked(sink, record, bytes);
+}
 
-    // 调用回调函数
-    for (int i = 0; i < g_log_config.callback_count; i++) {
-        if (g_log_config.callbacks[i].func) {
-            g_log_config.callbacks[i].func(level, module, file, line, func, message,
-                                           g_log_config.callbacks[i].user_data);
+// 模块、文件、行号和消息正文的 FNV-1a 哈希值，文件名只比较 __FILE__ 的地址
+static uint64_t log_dedup_hash(const log_record_t *record)
+{
+    uint64_t hash = 14695981039346656037ULL;
+    uint64_t key[3] = {(uint64_t)record->module, (uint64_t)(uintptr_t)record->file, (uint64_t)record->line};
+    const unsigned char *bytes = (const unsigned char *)key;
+    for (size_t i = 0; i < sizeof(key); i++) {
+        hash = (hash ^ bytes[i]) * 1099511628211ULL;
+    }
+    for (const unsigned char *p = (const unsigned char *)record->message; *p; p++) {
+        hash = (hash ^ *p) * 1099511628211ULL;
+    }
+    return hash;
+}
+
+// 有被折叠的日志时输出 "last message repeated N times"，调用者必须持有 sink->lock
+static void log_dedup_report_locked(log_sink_t *sink, const struct timeval *now)
+{
+    if (sink->dedup.repeats == 0) {
+        return;
+    }
+
+    log_record_t report;
+    report.level = sink->dedup.level;
+    report.module = sink->dedup.module;
+    report.file = sink->dedup.file;
+    report.line = sink->dedup.line;
+    report.func = sink->dedup.func;
+    report.tv = *now;
+    report.tid = log_current_tid();
+    report.context[0] = '\0';
+    snprintf(report.message, sizeof(report.message), "last message repeated %lu times", sink->dedup.repeats);
+    sink->dedup.repeats = 0;
+    log_emit_line_locked(sink, &report);
+    log_suppress_note_repeat_report();
+}
+
+// 输出一条日志记录，启用折叠时先与上一条日志比较，调用者必须持有 sink->lock
+// 返回 false 表示记录被折叠，不应再调用回调函数
+static bool log_emit_locked(log_sink_t *sink, const log_record_t *record)
+{
+    if (sink->dedup_enabled) {
+        uint64_t hash = log_dedup_hash(record);
+        if (sink->dedup.valid && sink->dedup.hash == hash &&
+            (sink->dedup_window_ms == 0 || log_elapsed_ms(&sink->dedup.since, &record->tv) < sink->dedup_window_ms)) {
+            sink->dedup.repeats++;
+            log_suppress_note_deduplicated();
+            return false;
         }
+
+        // 不同的日志或超出折叠窗口：先报告上一条日志被折叠的次数
+        log_dedup_report_locked(sink, &record->tv);
+        sink->dedup.valid = true;
+        sink->dedup.hash = hash;
+        sink->dedup.since = record->tv;
+        sink->dedup.level = record->level;
+        sink->dedup.module = record->module;
+        sink->dedup.file = record->file;
+        sink->dedup.line = record->line;
+        sink->dedup.func = record->func;
     }
+    log_emit_line_locked(sink, record);
+    return true;
+}
 
-    pthread_mutex_unlock(&g_log_config.mutex);
+// 结束写线程当前的输出目标：按刷新策略刷新并释放锁
+static void log_output_release_batch_sink(void)
+{
+    if (g_log_batch_sink) {
+        if (g_log_batch_sink->due) {
+            struct timeval now;
+            gettimeofday(&now, NULL);
+            log_flush_locked(g_log_batch_sink, &now);
+        }
+        pthread_mutex_unlock(&g_log_batch_sink->lock);
+        g_log_batch_sink = NULL;
+    }
 }
 
-// 设置日志上下文
-void log_set_context(const log_context_t *context)
+// 开始输出一批日志记录
+void log_output_batch_begin(void)
+{
+    g_log_batch_sink = NULL;
+}
+
+// 输出一条日志记录，连续的记录属于同一个输出目标时不重复加锁
+void log_output_record_locked(const log_record_t *record)
 {
-    if (!g_log_config.context_key_initialized) {
-        init_context_key();
+    log_sink_t *target = &g_log_default_sink;
+    if (__atomic_load_n(&g_log_module_sink_attached[record->module], __ATOMIC_ACQUIRE)) {
+        target = &g_log_module_sinks[record->module];
+    }
+    if (target != g_log_batch_sink) {
+        log_output_release_batch_sink();
+        g_log_batch_sink = log_sink_acquire(record->module);
+        log_sink_sync_locked(g_log_batch_sink);
     }
 
-    log_context_t *thread_context = pthread_getspecific(g_log_config.context_key);
-    if (!thread_context) {
-        thread_context = (log_context_t *)malloc(sizeof(log_context_t));
-        if (!thread_context) {
-            return;
+    log_sink_t *sink = g_log_batch_sink;
+    log_sink_check_rotate_locked(sink, record);
+    bool emitted = log_emit_locked(sink, record);
+    // 达到 flush_level 的日志在写线程推进 head 之前刷新，等待 FATAL 日志写出的生产者返回时它已在文件中
+    if (sink->due && record->level <= sink->flush.flush_level) {
+        log_flush_locked(sink, &record->tv);
+    }
+
+    // 回调函数在释放输出目标的锁之后调用，慢回调不会阻塞同步写日志的线程和 log_flush
+    if (emitted && log_callbacks_registered()) {
+        log_output_release_batch_sink();
+        log_dispatch_callbacks(record);
+    }
+}
+
+// 结束一批输出，按刷新策略每批最多刷新一次输出流
+void log_output_batch_end(void)
+{
+    log_output_release_batch_sink();
+}
+
+// 按时间刷新策略到期时刷新输出目标
+static void log_sink_flush_if_idle(log_sink_t *sink)
+{
+    pthread_mutex_lock(&sink->lock);
+    if (sink->dedup.repeats > 0 && sink->dedup_window_ms > 0) {
+        // 折叠窗口已过时报告被折叠的次数，不必等到下一条日志
+        struct timeval now;
+        log_now(&now);
+        if (log_elapsed_ms(&sink->dedup.since, &now) >= sink->dedup_window_ms) {
+            log_dedup_report_locked(sink, &now);
+            if (sink->due) {
+                log_flush_locked(sink, &now);
+            }
+        }
+    }
+    if (sink->pending_bytes > 0 && sink->flush.flush_interval_ms > 0) {
+        struct timeval now;
+        gettimeofday(&now, NULL);
+        if (log_flush_elapsed_ms(sink, &now) >= sink->flush.flush_interval_ms) {
+            log_flush_locked(sink, &now);
         }
-        memset(thread_context, 0, sizeof(log_context_t));
-        pthread_setspecific(g_log_config.context_key, thread_context);
     }
+    pthread_mutex_unlock(&sink->lock);
+}
 
-    if (context) {
-        // 复制上下文信息
-        thread_context->context_id = context->context_id ? strdup(context->context_id) : NULL;
-        thread_context->session_id = context->session_id ? strdup(context->session_id) : NULL;
-        thread_context->user_id = context->user_id ? strdup(context->user_id) : NULL;
-        thread_context->transaction_id =
-            context->transaction_id ? strdup(context->transaction_id) : NULL;
+// 写线程空闲时检查按时间刷新
+void log_output_idle(void)
+{
+    log_sink_flush_if_idle(&g_log_default_sink);
+    for (int i = 0; i < LOG_MODULE_MAX; i++) {
+        if (__atomic_load_n(&g_log_module_sink_attached[i], __ATOMIC_ACQUIRE)) {
+            log_sink_flush_if_idle(&g_log_module_sinks[i]);
+        }
     }
 }
 
-// 清除日志上下文
-void log_clear_context(void)
+// 同步或交给异步后端输出一条日志
+void log_vwrite(log_level_t level, log_module_t module, const char *file, int line, const char *func,
+                const log_context_t *context, const char *fmt, va_list args)
 {
-    if (!g_log_config.context_key_initialized) {
+    // 异步模式下交给后台写线程
+    if (log_async_submit(level, module, file, line, func, context, fmt, args)) {
         return;
     }
 
-    log_context_t *thread_context = pthread_getspecific(g_log_config.context_key);
-    if (thread_context) {
-        if (thread_context->context_id)
-            free((void *)thread_context->context_id);
-        if (thread_context->session_id)
-            free((void *)thread_context->session_id);
-        if (thread_context->user_id)
-            free((void *)thread_context->user_id);
-        if (thread_context->transaction_id)
-            free((void *)thread_context->transaction_id);
+    log_record_t record;
+    log_fill_record(&record, level, module, file, line, func, context, fmt, args);
+
+    // 只锁定该模块使用的输出目标，挂接了专用文件的模块不会阻塞其他模块
+    log_sink_t *sink = log_sink_acquire(module);
+    log_sink_sync_locked(sink);
+
+    // 检查日志文件轮转
+    log_sink_check_rotate_locked(sink, &record);
 
-        memset(thread_context, 0, sizeof(log_context_t));
+    bool emitted = log_emit_locked(sink, &record);
+    if (sink->due) {
+        log_flush_locked(sink, &record.tv);
+    }
+
+    pthread_mutex_unlock(&sink->lock);
+
+    // 回调函数在锁之外调用，慢回调只阻塞调用它的线程
+    if (emitted) {
+        log_dispatch_callbacks(&record);
     }
 }
 
-// 获取当前线程的日志上下文
-log_context_t log_get_thread_context(void)
+// 写入日志
+void log_write(log_level_t level, log_module_t module, const char *file, int line, const char *func,
+               const char *fmt, ...)
+{
+    if (!g_log_config.initialized) {
+        return;
+    }
+
+    if (!log_is_level_enabled(module, level)) {
+        return;
+    }
+
+    va_list args;
+    va_start(args, fmt);
+    log_vwrite(level, module, file, line, func, NULL, fmt, args);
+    va_end(args);
+}
+
+// 设置日志上下文
+void log_set_context(const log_context_t *context)
 {
-    log_context_t empty_context = {0};
+    if (!context) {
+        return;
+    }
 
-    if (!g_log_config.context_key_initialized) {
-        return empty_context;
+    // 复制上下文信息到线程本地缓冲区
+    log_thread_context_t *tls = &tls_log_context;
+    const char *fields[LOG_CONTEXT_FIELD_COUNT] = {context->context_id, context->session_id, context->user_id,
+                                                   context->transaction_id};
+    for (int i = 0; i < LOG_CONTEXT_FIELD_COUNT; i++) {
+        tls->present[i] = fields[i] != NULL;
+        if (fields[i]) {
+            snprintf(tls->fields[i], sizeof(tls->fields[i]), "%s", fields[i]);
+        }
     }
+    tls->version++;
+}
 
-    log_context_t *thread_context = pthread_getspecific(g_log_config.context_key);
-    if (thread_context) {
-        return *thread_context;
+// 清除日志上下文
+void log_clear_context(void)
+{
+    log_thread_context_t *tls = &tls_log_context;
+    for (int i = 0; i < LOG_CONTEXT_FIELD_COUNT; i++) {
+        tls->present[i] = false;
     }
+    tls->version++;
+}
 
-    return empty_context;
+// 获取当前线程的日志上下文
+log_context_t log_get_thread_context(void)
+{
+    log_thread_context_t *tls = &tls_log_context;
+    log_context_t context = {
+        .context_id = tls->present[0] ? tls->fields[0] : NULL,
+        .session_id = tls->present[1] ? tls->fields[1] : NULL,
+        .user_id = tls->present[2] ? tls->fields[2] : NULL,
+        .transaction_id = tls->present[3] ? tls->fields[3] : NULL,
+    };
+    return context;
 }
 
 // 带上下文的日志写入函数
@@ -499,29 +1119,11 @@ void log_write_with_context(log_level_t level, log_module_t module, const log_co
         return;
     }
 
-    // 保存当前上下文
-    log_context_t old_context = log_get_thread_context();
-
-    // 设置新上下文
-    if (context) {
-        log_set_context(context);
-    }
-
-    // 格式化日志消息
-    char message[1024];
+    // 上下文和消息直接渲染到日志记录中，不修改线程本地的上下文
     va_list args;
     va_start(args, fmt);
-    vsnprintf(message, sizeof(message), fmt, args);
+    log_vwrite(level, module, file, line, func, context, fmt, args);
     va_end(args);
-
-    // 写入日志
-    log_write(level, module, file, line, func, "%s", message);
-
-    // 恢复旧上下文
-    log_set_context(&old_context);
-
-    // 清理临时上下文
-    log_clear_context();
 }
 
 // 注册日志回调函数
@@ -531,29 +1133,30 @@ int log_register_callback(log_callback_t callback, void *user_data)
         return -1;
     }
 
-    pthread_mutex_lock(&g_log_config.mutex);
+    pthread_mutex_lock(&g_log_callback_lock);
+    log_callback_table_t next = g_log_callback_tables[__atomic_load_n(&g_log_callback_active, __ATOMIC_RELAXED)];
 
     // 检查是否已经注册
-    for (int i = 0; i < g_log_config.callback_count; i++) {
-        if (g_log_config.callbacks[i].func == callback) {
-            pthread_mutex_unlock(&g_log_config.mutex);
+    for (int i = 0; i < next.count; i++) {
+        if (next.entries[i].func == callback) {
+            pthread_mutex_unlock(&g_log_callback_lock);
             return -2; // 已经注册
         }
     }
 
     // 检查是否达到最大回调数
-    if (g_log_config.callback_count >=
-        (int)(sizeof(g_log_config.callbacks) / sizeof(g_log_config.callbacks[0]))) {
-        pthread_mutex_unlock(&g_log_config.mutex);
+    if (next.count >= LOG_CALLBACK_MAX) {
+        pthread_mutex_unlock(&g_log_callback_lock);
         return -3; // 回调数量已达上限
     }
 
     // 注册回调
-    g_log_config.callbacks[g_log_config.callback_count].func = callback;
-    g_log_config.callbacks[g_log_config.callback_count].user_data = user_data;
-    g_log_config.callback_count++;
+    next.entries[next.count].func = callback;
+    next.entries[next.count].user_data = user_data;
+    next.count++;
+    log_callback_publish_locked(&next);
 
-    pthread_mutex_unlock(&g_log_config.mutex);
+    pthread_mutex_unlock(&g_log_callback_lock);
     return 0;
 }
 
@@ -564,29 +1167,31 @@ int log_unregister_callback(log_callback_t callback)
         return -1;
     }
 
-    pthread_mutex_lock(&g_log_config.mutex);
+    pthread_mutex_lock(&g_log_callback_lock);
+    log_callback_table_t next = g_log_callback_tables[__atomic_load_n(&g_log_callback_active, __ATOMIC_RELAXED)];
 
     // 查找回调
     int found = -1;
-    for (int i = 0; i < g_log_config.callback_count; i++) {
-        if (g_log_config.callbacks[i].func == callback) {
+    for (int i = 0; i < next.count; i++) {
+        if (next.entries[i].func == callback) {
             found = i;
             break;
         }
     }
 
     if (found < 0) {
-        pthread_mutex_unlock(&g_log_config.mutex);
+        pthread_mutex_unlock(&g_log_callback_lock);
         return -2; // 回调未注册
     }
 
     // 移除回调（通过移动后面的回调）
-    for (int i = found; i < g_log_config.callback_count - 1; i++) {
-        g_log_config.callbacks[i] = g_log_config.callbacks[i + 1];
+    for (int i = found; i < next.count - 1; i++) {
+        next.entries[i] = next.entries[i + 1];
     }
-    g_log_config.callback_count--;
+    next.count--;
+    log_callback_publish_locked(&next);
 
-    pthread_mutex_unlock(&g_log_config.mutex);
+    pthread_mutex_unlock(&g_log_callback_lock);
     return 0;
 }
 
@@ -600,7 +1205,9 @@ void log_set_rotation_config(const log_rotation_config_t *config)
         g_log_rotation.rotate_on_size = config->rotate_on_size;
         g_log_rotation.rotate_on_time = config->rotate_on_time;
         g_log_rotation.rotate_interval_hours = config->rotate_interval_hours;
+        __atomic_add_fetch(&g_log_config_version, 1, __ATOMIC_RELEASE);
         pthread_mutex_unlock(&g_log_config.mutex);
+        log_binary_reload_config();
     }
 }
 
@@ -618,50 +1225,347 @@ void log_get_rotation_config(log_rotation_config_t *config)
     }
 }
 
-// 立即执行日志轮转
+// 第 seq 次轮转的待处理文件名
+static void log_rotator_staged_path(char *buf, size_t size, const char *path, unsigned long seq)
+{
+    snprintf(buf, size, "%s.rotating.%lu", path, seq);
+}
+
+// 把一个待处理文件并入备份链：删除最旧的 .N，.1 … .N-1 依次后移，待处理文件成为 .1
+static void log_rotator_shift_chain(const char *path, int backup_count, const char *staged_path)
+{
+    char from[512];
+    char to[512];
+
+    if (backup_count <= 0) {
+        unlink(staged_path);
+        return;
+    }
+    snprintf(to, sizeof(to), "%s.%d", path, backup_count);
+    unlink(to);
+    for (int i = backup_count - 1; i >= 1; i--) {
+        snprintf(from, sizeof(from), "%s.%d", path, i);
+        snprintf(to, sizeof(to), "%s.%d", path, i + 1);
+        rename(from, to); // 备份尚未达到 i 个时 .i 不存在，忽略错误
+    }
+    snprintf(to, sizeof(to), "%s.1", path);
+    if (rename(staged_path, to) != 0) {
+        fprintf(stderr, "Failed to rotate log file: %s\n", staged_path);
+    }
+}
+
+// 轮转线程：按轮转顺序处理待处理文件
+static void *log_rotator_thread(void *arg)
+{
+    log_rotator_t *rotator = (log_rotator_t *)arg;
+    pthread_mutex_lock(&rotator->mutex);
+    for (;;) {
+        while (rotator->completed == rotator->staged && !rotator->stop) {
+            pthread_cond_wait(&rotator->cond, &rotator->mutex);
+        }
+        if (rotator->completed == rotator->staged) {
+            break;
+        }
+        unsigned long seq = rotator->completed + 1;
+        char path[sizeof(rotator->path)];
+        char staged_path[512];
+        memcpy(path, rotator->path, sizeof(path));
+        int backup_count = rotator->backup_count;
+        pthread_mutex_unlock(&rotator->mutex);
+
+        log_rotator_staged_path(staged_path, sizeof(staged_path), path, seq);
+        log_rotator_shift_chain(path, backup_count, staged_path);
+
+        pthread_mutex_lock(&rotator->mutex);
+        rotator->completed = seq;
+        pthread_cond_broadcast(&rotator->cond);
+    }
+    pthread_mutex_unlock(&rotator->mutex);
+    return NULL;
+}
+
+// 把已关闭的日志文件改名为待处理文件，交给轮转线程
+int log_rotator_stage(log_rotator_t *rotator, const char *path, int backup_count, unsigned long *seq_out)
+{
+    char staged_path[512];
+
+    // 待处理文件按序号命名，上一次轮转尚未并入备份链时也不会冲突
+    pthread_mutex_lock(&rotator->mutex);
+    if (!rotator->started) {
+        if (pthread_create(&rotator->thread, NULL, log_rotator_thread, rotator) != 0) {
+            pthread_mutex_unlock(&rotator->mutex);
+            return -3;
+        }
+        rotator->started = true;
+    }
+    if (strcmp(rotator->path, path) != 0) {
+        // 日志文件路径只在重新打开时改变，此前的 log_rotator_stop 已处理完旧路径的全部文件
+        strncpy(rotator->path, path, sizeof(rotator->path) - 1);
+        rotator->path[sizeof(rotator->path) - 1] = '\0';
+    }
+    rotator->backup_count = backup_count;
+    unsigned long seq = rotator->staged + 1;
+    pthread_mutex_unlock(&rotator->mutex);
+
+    log_rotator_staged_path(staged_path, sizeof(staged_path), path, seq);
+    if (rename(path, staged_path) != 0) {
+        return -2;
+    }
+
+    pthread_mutex_lock(&rotator->mutex);
+    rotator->staged = seq;
+    pthread_cond_signal(&rotator->cond);
+    pthread_mutex_unlock(&rotator->mutex);
+    if (seq_out) {
+        *seq_out = seq;
+    }
+    return 0;
+}
+
+// 等待第 seq 次轮转并入备份链
+void log_rotator_wait(log_rotator_t *rotator, unsigned long seq)
+{
+    pthread_mutex_lock(&rotator->mutex);
+    while (rotator->started && rotator->completed < seq) {
+        pthread_cond_wait(&rotator->cond, &rotator->mutex);
+    }
+    pthread_mutex_unlock(&rotator->mutex);
+}
+
+// 处理完剩余的待处理文件后停止轮转线程，调用者不能持有写该文件时使用的锁
+void log_rotator_stop(log_rotator_t *rotator)
+{
+    pthread_mutex_lock(&rotator->mutex);
+    if (!rotator->started) {
+        pthread_mutex_unlock(&rotator->mutex);
+        return;
+    }
+    rotator->stop = true;
+    pthread_cond_broadcast(&rotator->cond);
+    pthread_mutex_unlock(&rotator->mutex);
+
+    pthread_join(rotator->thread, NULL);
+
+    pthread_mutex_lock(&rotator->mutex);
+    rotator->started = false;
+    rotator->stop = false;
+    pthread_mutex_unlock(&rotator->mutex);
+}
+
+// 立即执行日志轮转，等待备份链重命名完成后返回；等待期间不持有日志锁
 int log_rotate_now(void)
 {
-    if (!g_log_config.log_file || !g_log_config.log_file_path[0]) {
+    log_sink_t *sink = &g_log_default_sink;
+    unsigned long seq = 0;
+    int result = -1;
+
+    pthread_mutex_lock(&sink->lock);
+    if (sink->file && sink->path[0]) {
+        log_sink_sync_locked(sink);
+        result = log_sink_rotate_locked(sink, time(NULL), &seq);
+    }
+    pthread_mutex_unlock(&sink->lock);
+    if (seq != 0) {
+        log_rotator_wait(&sink->rotator, seq);
+    }
+    return result;
+}
+
+// 使用默认值初始化刷新策略
+void log_flush_policy_init(log_flush_policy_t *policy)
+{
+    if (policy) {
+        policy->buffer_size = 0;
+        policy->flush_bytes = 0;
+        policy->flush_interval_ms = 0;
+        policy->flush_level = LOG_LEVEL_ERROR;
+    }
+}
+
+// 设置刷新策略
+int log_set_flush_policy(const log_flush_policy_t *policy)
+{
+    if (!policy || policy->buffer_size > LOG_FLUSH_MAX_BUFFER || policy->flush_interval_ms < 0 ||
+        policy->flush_level < LOG_LEVEL_FATAL || policy->flush_level > LOG_LEVEL_TRACE) {
         return -1;
     }
 
     pthread_mutex_lock(&g_log_config.mutex);
+    g_log_flush_policy = *policy;
+    __atomic_add_fetch(&g_log_config_version, 1, __ATOMIC_RELEASE);
+    pthread_mutex_unlock(&g_log_config.mutex);
 
-    // 关闭当前日志文件
-    fclose(g_log_config.log_file);
-    g_log_config.log_file = NULL;
+    // 立即同步已打开的输出目标，缓冲区大小变化时在这里重新打开日志文件
+    int result = 0;
+    pthread_mutex_lock(&g_log_default_sink.lock);
+    if (g_log_default_sink.file && log_sink_sync_locked(&g_log_default_sink) != 0) {
+        result = -3;
+    }
+    pthread_mutex_unlock(&g_log_default_sink.lock);
+    for (int i = 0; i < LOG_MODULE_MAX; i++) {
+        if (__atomic_load_n(&g_log_module_sink_attached[i], __ATOMIC_ACQUIRE)) {
+            log_sink_t *sink = &g_log_module_sinks[i];
+            pthread_mutex_lock(&sink->lock);
+            if (sink->file && log_sink_sync_locked(sink) != 0) {
+                result = -3;
+            }
+            pthread_mutex_unlock(&sink->lock);
+        }
+    }
+    log_binary_reload_config();
+    return result;
+}
 
-    // 生成轮转文件名
-    char rotate_path[512];
-    time_t now = time(NULL);
-    struct tm *tm_info = localtime(&now);
-    char time_str[32];
-    strftime(time_str, sizeof(time_str), "%Y%m%d_%H%M%S", tm_info);
+// 获取刷新策略
+void log_get_flush_policy(log_flush_policy_t *policy)
+{
+    if (policy) {
+        pthread_mutex_lock(&g_log_config.mutex);
+        *policy = g_log_flush_policy;
+        pthread_mutex_unlock(&g_log_config.mutex);
+    }
+}
+
+// 设置重复日志折叠
+int log_set_dedup(bool enabled, int window_ms)
+{
+    if (window_ms < 0) {
+        return -1;
+    }
 
-    snprintf(rotate_path, sizeof(rotate_path), "%s.%s", g_log_config.log_file_path, time_str);
+    pthread_mutex_lock(&g_log_config.mutex);
+    g_log_dedup.enabled = enabled;
+    g_log_dedup.window_ms = window_ms;
+    __atomic_add_fetch(&g_log_config_version, 1, __ATOMIC_RELEASE);
+    pthread_mutex_unlock(&g_log_config.mutex);
+    return 0;
+}
 
-    // 重命名当前日志文件
-    if (rename(g_log_config.log_file_path, rotate_path) != 0) {
-        // 重命名失败，尝试重新打开原文件
-        g_log_config.log_file = fopen(g_log_config.log_file_path, "a");
-        pthread_mutex_unlock(&g_log_config.mutex);
+// 立即刷新缓冲的日志
+int log_flush(void)
+{
+    if (!g_log_config.initialized) {
+        return -1;
+    }
+
+    // 异步模式下先等待已提交的日志写出
+    log_async_drain();
+
+    struct timeval now;
+    gettimeofday(&now, NULL);
+    pthread_mutex_lock(&g_log_default_sink.lock);
+    log_dedup_report_locked(&g_log_default_sink, &now);
+    log_flush_locked(&g_log_default_sink, &now);
+    pthread_mutex_unlock(&g_log_default_sink.lock);
+    for (int i = 0; i < LOG_MODULE_MAX; i++) {
+        if (__atomic_load_n(&g_log_module_sink_attached[i], __ATOMIC_ACQUIRE)) {
+            pthread_mutex_lock(&g_log_module_sinks[i].lock);
+            log_dedup_report_locked(&g_log_module_sinks[i], &now);
+            log_flush_locked(&g_log_module_sinks[i], &now);
+            pthread_mutex_unlock(&g_log_module_sinks[i].lock);
+        }
+    }
+    log_binary_flush();
+    return 0;
+}
+
+// 为模块挂接专用日志文件
+int log_attach_module_sink(log_module_t module, const char *path)
+{
+    if (!g_log_config.initialized || module < 0 || module >= LOG_MODULE_MAX || !path || !path[0] ||
+        strlen(path) >= sizeof(g_log_module_sinks[module].path)) {
+        return -1;
+    }
+
+    log_sink_t *sink = &g_log_module_sinks[module];
+    pthread_mutex_lock(&sink->lock);
+    if (sink->file) {
+        pthread_mutex_unlock(&sink->lock);
         return -2;
     }
 
-    // 打开新的日志文件
-    g_log_config.log_file = fopen(g_log_config.log_file_path, "a");
-    if (!g_log_config.log_file) {
-        pthread_mutex_unlock(&g_log_config.mutex);
+    log_sink_sync_locked(sink);
+    time_t now = time(NULL);
+    sink->last_rotate_time = 0;
+    if (log_sink_open_locked(sink, path, now) != 0) {
+        pthread_mutex_unlock(&sink->lock);
         return -3;
     }
+    gettimeofday(&sink->last_flush, NULL);
+    sink->pending_bytes = 0;
+    sink->due = false;
+
+    pthread_mutex_lock(&g_log_config.mutex);
+    free(g_log_config.modules[module].custom_file);
+    g_log_config.modules[module].custom_file = strdup(path);
+    pthread_mutex_unlock(&g_log_config.mutex);
 
-    // 更新上次轮转时间
-    g_log_rotation.last_rotate_time = now;
+    // 文件打开后才发布挂接状态，之后该模块的日志只锁定这个输出目标
+    __atomic_store_n(&g_log_module_sink_attached[module], 1, __ATOMIC_RELEASE);
+    pthread_mutex_unlock(&sink->lock);
+    return 0;
+}
+
+// 撤销模块的专用日志文件
+int log_detach_module_sink(log_module_t module)
+{
+    if (module < 0 || module >= LOG_MODULE_MAX) {
+        return -1;
+    }
 
+    // 异步模式下先输出已提交的日志，使它们写入模块自己的文件
+    log_async_drain();
+
+    log_sink_t *sink = &g_log_module_sinks[module];
+    pthread_mutex_lock(&sink->lock);
+    if (!sink->file) {
+        pthread_mutex_unlock(&sink->lock);
+        return -2;
+    }
+
+    // 先撤销挂接状态，之后到达的日志改用默认输出目标
+    __atomic_store_n(&g_log_module_sink_attached[module], 0, __ATOMIC_RELEASE);
+    log_sink_close_locked(sink);
+    sink->pending_bytes = 0;
+    sink->due = false;
+
+    pthread_mutex_lock(&g_log_config.mutex);
+    free(g_log_config.modules[module].custom_file);
+    g_log_config.modules[module].custom_file = NULL;
     pthread_mutex_unlock(&g_log_config.mutex);
+    pthread_mutex_unlock(&sink->lock);
+
+    // 文件已关闭，等待最后一次轮转并入备份链
+    log_rotator_stop(&sink->rotator);
     return 0;
 }
 
+// 异步模式下环形缓冲区槽位数量的上限
+#define LOG_ASYNC_MAX_CAPACITY (1u << 20)
+
+// 启用异步日志
+int log_enable_async(const log_async_config_t *config)
+{
+    log_async_config_t defaults;
+    if (!config) {
+        log_async_config_init(&defaults);
+        config = &defaults;
+    }
+    if (!g_log_config.initialized || config->queue_capacity == 0 ||
+        config->queue_capacity > LOG_ASYNC_MAX_CAPACITY || config->batch_size <= 0 ||
+        config->overflow_policy < LOG_OVERFLOW_BLOCK ||
+        config->overflow_policy > LOG_OVERFLOW_DROP_LOWEST_LEVEL) {
+        return -1;
+    }
+    return log_async_start(config);
+}
+
+// 停用异步日志
+int log_disable_async(void)
+{
+    return log_async_stop();
+}
+
 // 关闭日志系统
 void log_deinit(void)
 {
@@ -669,25 +1573,35 @@ void log_deinit(void)
         return;
     }
 
-    pthread_mutex_lock(&g_log_config.mutex);
+    // 先输出异步缓冲区中剩余的日志
+    log_async_stop();
+    log_binary_close();
 
-    // 关闭日志文件
-    if (g_log_config.log_file) {
-        fclose(g_log_config.log_file);
-        g_log_config.log_file = NULL;
+    // 关闭各模块的专用日志文件和默认日志文件
+    for (int i = 0; i < LOG_MODULE_MAX; i++) {
+        log_detach_module_sink((log_module_t)i);
     }
+    pthread_mutex_lock(&g_log_default_sink.lock);
+    log_sink_close_locked(&g_log_default_sink);
+    pthread_mutex_unlock(&g_log_default_sink.lock);
+    fflush(stdout);
+    fflush(stderr);
 
     // 清除回调
-    g_log_config.callback_count = 0;
+    pthread_mutex_lock(&g_log_callback_lock);
+    log_callback_table_t empty = {0};
+    log_callback_publish_locked(&empty);
+    pthread_mutex_unlock(&g_log_callback_lock);
 
-    // 销毁上下文键
-    if (g_log_config.context_key_initialized) {
-        pthread_key_delete(g_log_config.context_key);
-        g_log_config.context_key_initialized = false;
-    }
+    pthread_mutex_lock(&g_log_config.mutex);
 
     g_log_config.initialized = false;
+    for (int i = 0; i < LOG_MODULE_MAX; i++) {
+        __atomic_store_n(&log_module_thresholds[i], -1, __ATOMIC_RELAXED);
+    }
 
     pthread_mutex_unlock(&g_log_config.mutex);
-    pthread_mutex_destroy(&g_log_config.mutex);
+
+    // 日志文件已关闭，等待最后一次轮转并入备份链
+    log_rotator_stop(&g_log_default_sink.rotator);
 }
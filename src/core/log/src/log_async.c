@@ -0,0 +1,401 @@
+/**
+ * @file log_async.c
+ * @brief 异步日志后端：无锁多生产者环形缓冲区和后台写线程。
+ *
+ * 环形缓冲区的每个槽位带有序号：生产者以 CAS 推进 tail 领取槽位，在槽位中直接格式化记录，
+ * 再以 release 语义发布序号；唯一的消费者 (后台写线程) 按顺序取出已发布的槽位，
+ * 每批在一次加锁内输出，批次结束时按刷新策略刷新输出流。
+ * 写线程空闲时在条件变量上休眠，生产者只有发现它在休眠时才加锁唤醒它。
+ */
+#include "log_internal.h"
+#include <pthread.h>
+#include <sched.h>
+#include <stdatomic.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <time.h>
+
+// 默认的环形缓冲区槽位数量
+#define LOG_ASYNC_DEFAULT_CAPACITY 256
+
+// 默认每批最多输出的日志条数
+#define LOG_ASYNC_DEFAULT_BATCH 64
+
+// 条件等待的超时时间（毫秒），唤醒丢失时作为保底
+#define LOG_ASYNC_WAIT_MS 10
+
+// 环形缓冲区槽位：seq 等于位置时空闲，等于位置 + 1 时已发布待输出
+typedef struct {
+    atomic_size_t seq;   // 槽位序号
+    log_record_t record; // 日志记录
+} log_async_slot_t;
+
+// 异步后端的全局状态
+static struct {
+    log_async_slot_t *slots;        // 槽位数组
+    size_t capacity;                // 槽位数量（2 的幂）
+    log_overflow_policy_t policy;   // 溢出策略
+    int batch_size;                 // 每批最多输出的条数
+
+    atomic_size_t tail;             // 下一个待领取的位置，由生产者推进
+    atomic_size_t head;             // 下一个待输出的位置，由写线程推进
+
+    atomic_bool enabled;            // 是否已启用
+    atomic_int active;              // 正在提交的生产者数量，停用时等待其归零
+    atomic_bool stopping;           // 通知写线程输出剩余日志后退出
+    atomic_int writer_sleeping;     // 写线程是否在 wakeup 上休眠
+    atomic_int waiters;             // 在 progress 上等待槽位或等待写出的生产者数量
+
+    pthread_t thread;               // 后台写线程
+    pthread_mutex_t lock;           // 保护条件等待
+    pthread_cond_t wakeup;          // 唤醒写线程
+    pthread_cond_t progress;        // 写线程输出一批后通知等待的生产者
+    pthread_mutex_t control_lock;   // 串行化启用和停用
+
+    atomic_ulong enqueued;          // 统计：已放入缓冲区
+    atomic_ulong written;           // 统计：已输出
+    atomic_ulong dropped;           // 统计：已丢弃
+    atomic_ulong blocked;           // 统计：生产者等待次数
+} g_log_async = {.lock = PTHREAD_MUTEX_INITIALIZER,
+                 .wakeup = PTHREAD_COND_INITIALIZER,
+                 .progress = PTHREAD_COND_INITIALIZER,
+                 .control_lock = PTHREAD_MUTEX_INITIALIZER};
+
+// 当前线程是否为后台写线程，写线程自身产生的日志不能等待自己
+static _Thread_local bool tls_log_writer = false;
+
+// 计算 LOG_ASYNC_WAIT_MS 之后的绝对时间
+static void log_async_deadline(struct timespec *ts)
+{
+    clock_gettime(CLOCK_REALTIME, ts);
+    ts->tv_nsec += LOG_ASYNC_WAIT_MS * 1000000L;
+    if (ts->tv_nsec >= 1000000000L) {
+        ts->tv_sec++;
+        ts->tv_nsec -= 1000000000L;
+    }
+}
+
+// 使用默认值初始化异步日志配置
+void log_async_config_init(log_async_config_t *config)
+{
+    if (config) {
+        config->queue_capacity = LOG_ASYNC_DEFAULT_CAPACITY;
+        config->overflow_policy = LOG_OVERFLOW_BLOCK;
+        config->batch_size = LOG_ASYNC_DEFAULT_BATCH;
+    }
+}
+
+// 获取异步日志统计信息
+void log_get_async_stats(log_async_stats_t *stats)
+{
+    if (stats) {
+        stats->enqueued = atomic_load_explicit(&g_log_async.enqueued, memory_order_relaxed);
+        stats->written = atomic_load_explicit(&g_log_async.written, memory_order_relaxed);
+        stats->dropped = atomic_load_explicit(&g_log_async.dropped, memory_order_relaxed);
+        stats->blocked = atomic_load_explicit(&g_log_async.blocked, memory_order_relaxed);
+    }
+}
+
+bool log_async_enabled(void)
+{
+    return atomic_load_explicit(&g_log_async.enabled, memory_order_acquire);
+}
+
+// 写线程输出一批后唤醒等待槽位或等待写出的生产者
+static void log_async_notify_progress(void)
+{
+    atomic_thread_fence(memory_order_seq_cst);
+    if (atomic_load_explicit(&g_log_async.waiters, memory_order_relaxed) > 0) {
+        pthread_mutex_lock(&g_log_async.lock);
+        pthread_cond_broadcast(&g_log_async.progress);
+        pthread_mutex_unlock(&g_log_async.lock);
+    }
+}
+
+// 生产者发布槽位后，如果写线程在休眠则唤醒它
+static void log_async_wake_writer(void)
+{
+    atomic_thread_fence(memory_order_seq_cst);
+    if (atomic_load_explicit(&g_log_async.writer_sleeping, memory_order_relaxed)) {
+        pthread_mutex_lock(&g_log_async.lock);
+        pthread_cond_signal(&g_log_async.wakeup);
+        pthread_mutex_unlock(&g_log_async.lock);
+    }
+}
+
+// 写线程下一个待输出的槽位是否已发布
+static bool log_async_ready(size_t head)
+{
+    log_async_slot_t *slot = &g_log_async.slots[head & (g_log_async.capacity - 1)];
+    return atomic_load_explicit(&slot->seq, memory_order_acquire) == head + 1;
+}
+
+// 后台写线程
+static void *log_async_writer_main(void *arg)
+{
+    (void)arg;
+    tls_log_writer = true;
+    size_t mask = g_log_async.capacity - 1;
+    size_t head = atomic_load_explicit(&g_log_async.head, memory_order_relaxed);
+
+    for (;;) {
+        if (log_async_ready(head)) {
+            int count = 0;
+            log_output_batch_begin();
+            do {
+                log_async_slot_t *slot = &g_log_async.slots[head & mask];
+                log_output_record_locked(&slot->record);
+                // 归还槽位，它下一次对应的位置是 head + capacity
+                atomic_store_explicit(&slot->seq, head + g_log_async.capacity, memory_order_release);
+                head++;
+                atomic_store_explicit(&g_log_async.head, head, memory_order_release);
+                count++;
+            } while (count < g_log_async.batch_size && log_async_ready(head));
+            log_output_batch_end();
+            atomic_fetch_add_explicit(&g_log_async.written, (unsigned long)count, memory_order_relaxed);
+            log_async_notify_progress();
+            continue;
+        }
+
+        // 停用时生产者都已离开，所有领取的槽位都已发布，缓冲区为空即可退出
+        if (atomic_load_explicit(&g_log_async.stopping, memory_order_acquire)) {
+            break;
+        }
+
+        pthread_mutex_lock(&g_log_async.lock);
+        atomic_store_explicit(&g_log_async.writer_sleeping, 1, memory_order_seq_cst);
+        if (!log_async_ready(head) && !atomic_load_explicit(&g_log_async.stopping, memory_order_acquire)) {
+            struct timespec ts;
+            log_async_deadline(&ts);
+            pthread_cond_timedwait(&g_log_async.wakeup, &g_log_async.lock, &ts);
+        }
+        atomic_store_explicit(&g_log_async.writer_sleeping, 0, memory_order_relaxed);
+        pthread_mutex_unlock(&g_log_async.lock);
+
+        // 没有新日志时按时间刷新缓冲的输出
+        if (!log_async_ready(head)) {
+            log_output_idle();
+        }
+    }
+    return NULL;
+}
+
+// ERROR 和 FATAL 日志在任何溢出策略下都不丢弃
+static bool log_async_must_keep(log_level_t level)
+{
+    return level <= LOG_LEVEL_ERROR;
+}
+
+// 缓冲区已满时按溢出策略处理：返回 true 表示已等到空位应重试，false 表示放弃领取槽位
+// 写线程不能等待自己，放弃领取的 ERROR 和 FATAL 日志由调用者改为同步写出，其他日志被丢弃
+static bool log_async_wait_for_space(log_level_t level)
+{
+    if (tls_log_writer) {
+        return false;
+    }
+    if (!log_async_must_keep(level)) {
+        if (g_log_async.policy == LOG_OVERFLOW_DROP_NEWEST) {
+            return false;
+        }
+        if (g_log_async.policy == LOG_OVERFLOW_DROP_LOWEST_LEVEL && level >= LOG_LEVEL_INFO) {
+            return false;
+        }
+    }
+
+    atomic_fetch_add_explicit(&g_log_async.blocked, 1, memory_order_relaxed);
+    pthread_mutex_lock(&g_log_async.lock);
+    atomic_fetch_add_explicit(&g_log_async.waiters, 1, memory_order_seq_cst);
+    while (atomic_load_explicit(&g_log_async.tail, memory_order_seq_cst) -
+               atomic_load_explicit(&g_log_async.head, memory_order_seq_cst) >=
+           g_log_async.capacity) {
+        struct timespec ts;
+        log_async_deadline(&ts);
+        pthread_cond_timedwait(&g_log_async.progress, &g_log_async.lock, &ts);
+    }
+    atomic_fetch_sub_explicit(&g_log_async.waiters, 1, memory_order_relaxed);
+    pthread_mutex_unlock(&g_log_async.lock);
+    return true;
+}
+
+// 按级别逐级丢弃策略下，缓冲区占用达到该级别的门限时丢弃
+static bool log_async_over_level_threshold(log_level_t level, size_t pos)
+{
+    if (g_log_async.policy != LOG_OVERFLOW_DROP_LOWEST_LEVEL || level < LOG_LEVEL_DEBUG) {
+        return false;
+    }
+    size_t used = pos - atomic_load_explicit(&g_log_async.head, memory_order_relaxed);
+    size_t threshold = level == LOG_LEVEL_DEBUG ? g_log_async.capacity / 4 * 3 : g_log_async.capacity / 2;
+    return used >= threshold;
+}
+
+// 领取一个槽位，按溢出策略丢弃或写线程无法等待时返回 NULL
+static log_async_slot_t *log_async_reserve(log_level_t level, size_t *pos_out)
+{
+    size_t mask = g_log_async.capacity - 1;
+    size_t pos = atomic_load_explicit(&g_log_async.tail, memory_order_relaxed);
+    for (;;) {
+        log_async_slot_t *slot = &g_log_async.slots[pos & mask];
+        size_t seq = atomic_load_explicit(&slot->seq, memory_order_acquire);
+        intptr_t diff = (intptr_t)seq - (intptr_t)pos;
+        if (diff == 0) {
+            if (log_async_over_level_threshold(level, pos)) {
+                return NULL;
+            }
+            if (atomic_compare_exchange_weak_explicit(&g_log_async.tail, &pos, pos + 1, memory_order_relaxed,
+                                                      memory_order_relaxed)) {
+                *pos_out = pos;
+                return slot;
+            }
+        } else if (diff < 0) {
+            // 槽位还没有被写线程归还，缓冲区已满
+            if (!log_async_wait_for_space(level)) {
+                return NULL;
+            }
+            pos = atomic_load_explicit(&g_log_async.tail, memory_order_relaxed);
+        } else {
+            // 其他生产者已领取该位置
+            pos = atomic_load_explicit(&g_log_async.tail, memory_order_relaxed);
+        }
+    }
+}
+
+// 等待写线程输出到指定位置（不含）
+static void log_async_wait_written(size_t target)
+{
+    pthread_mutex_lock(&g_log_async.lock);
+    atomic_fetch_add_explicit(&g_log_async.waiters, 1, memory_order_seq_cst);
+    while (atomic_load_explicit(&g_log_async.head, memory_order_seq_cst) < target) {
+        struct timespec ts;
+        log_async_deadline(&ts);
+        pthread_cond_timedwait(&g_log_async.progress, &g_log_async.lock, &ts);
+    }
+    atomic_fetch_sub_explicit(&g_log_async.waiters, 1, memory_order_relaxed);
+    pthread_mutex_unlock(&g_log_async.lock);
+}
+
+// 把一条日志交给异步后端
+bool log_async_submit(log_level_t level, log_module_t module, const char *file, int line, const char *func,
+                      const log_context_t *context, const char *fmt, va_list args)
+{
+    if (!atomic_load_explicit(&g_log_async.enabled, memory_order_acquire)) {
+        return false;
+    }
+    // 先登记再复查，停用时等待所有登记的生产者离开后才释放缓冲区
+    atomic_fetch_add_explicit(&g_log_async.active, 1, memory_order_seq_cst);
+    if (!atomic_load_explicit(&g_log_async.enabled, memory_order_seq_cst)) {
+        atomic_fetch_sub_explicit(&g_log_async.active, 1, memory_order_release);
+        return false;
+    }
+
+    size_t pos;
+    log_async_slot_t *slot = log_async_reserve(level, &pos);
+    if (slot == NULL) {
+        atomic_fetch_sub_explicit(&g_log_async.active, 1, memory_order_release);
+        if (log_async_must_keep(level)) {
+            // 只有写线程会走到这里 (例如在回调函数中记录错误)，交给调用者同步写出
+            return false;
+        }
+        atomic_fetch_add_explicit(&g_log_async.dropped, 1, memory_order_relaxed);
+        return true;
+    }
+
+    log_fill_record(&slot->record, level, module, file, line, func, context, fmt, args);
+    atomic_store_explicit(&slot->seq, pos + 1, memory_order_release);
+    atomic_fetch_add_explicit(&g_log_async.enqueued, 1, memory_order_relaxed);
+    log_async_wake_writer();
+
+    // 致命错误之后进程通常会退出，等到这条日志写出后再返回
+    if (level == LOG_LEVEL_FATAL && !tls_log_writer) {
+        log_async_wait_written(pos + 1);
+    }
+
+    atomic_fetch_sub_explicit(&g_log_async.active, 1, memory_order_release);
+    return true;
+}
+
+// 等待调用前已提交的日志全部输出
+void log_async_drain(void)
+{
+    if (tls_log_writer || !atomic_load_explicit(&g_log_async.enabled, memory_order_acquire)) {
+        return;
+    }
+    // 与生产者一样登记，等待期间缓冲区不会被停用
+    atomic_fetch_add_explicit(&g_log_async.active, 1, memory_order_seq_cst);
+    if (atomic_load_explicit(&g_log_async.enabled, memory_order_seq_cst)) {
+        log_async_wait_written(atomic_load_explicit(&g_log_async.tail, memory_order_seq_cst));
+    }
+    atomic_fetch_sub_explicit(&g_log_async.active, 1, memory_order_release);
+}
+
+// 启动后台写线程
+int log_async_start(const log_async_config_t *config)
+{
+    pthread_mutex_lock(&g_log_async.control_lock);
+    if (atomic_load_explicit(&g_log_async.enabled, memory_order_relaxed)) {
+        pthread_mutex_unlock(&g_log_async.control_lock);
+        return -2;
+    }
+
+    size_t capacity = 2;
+    while (capacity < config->queue_capacity) {
+        capacity <<= 1;
+    }
+    log_async_slot_t *slots = (log_async_slot_t *)malloc(capacity * sizeof(log_async_slot_t));
+    if (!slots) {
+        pthread_mutex_unlock(&g_log_async.control_lock);
+        return -3;
+    }
+    for (size_t i = 0; i < capacity; i++) {
+        atomic_init(&slots[i].seq, i);
+    }
+
+    g_log_async.slots = slots;
+    g_log_async.capacity = capacity;
+    g_log_async.policy = config->overflow_policy;
+    g_log_async.batch_size = config->batch_size;
+    atomic_store_explicit(&g_log_async.tail, 0, memory_order_relaxed);
+    atomic_store_explicit(&g_log_async.head, 0, memory_order_relaxed);
+    atomic_store_explicit(&g_log_async.stopping, false, memory_order_relaxed);
+    atomic_store_explicit(&g_log_async.enqueued, 0, memory_order_relaxed);
+    atomic_store_explicit(&g_log_async.written, 0, memory_order_relaxed);
+    atomic_store_explicit(&g_log_async.dropped, 0, memory_order_relaxed);
+    atomic_store_explicit(&g_log_async.blocked, 0, memory_order_relaxed);
+
+    if (pthread_create(&g_log_async.thread, NULL, log_async_writer_main, NULL) != 0) {
+        free(slots);
+        g_log_async.slots = NULL;
+        pthread_mutex_unlock(&g_log_async.control_lock);
+        return -3;
+    }
+
+    atomic_store_explicit(&g_log_async.enabled, true, memory_order_release);
+    pthread_mutex_unlock(&g_log_async.control_lock);
+    return 0;
+}
+
+// 输出剩余的全部日志并停止后台写线程
+int log_async_stop(void)
+{
+    pthread_mutex_lock(&g_log_async.control_lock);
+    if (!atomic_load_explicit(&g_log_async.enabled, memory_order_relaxed)) {
+        pthread_mutex_unlock(&g_log_async.control_lock);
+        return -1;
+    }
+
+    // 新的日志改为同步输出，等待已进入缓冲区的生产者发布完槽位
+    atomic_store_explicit(&g_log_async.enabled, false, memory_order_seq_cst);
+    while (atomic_load_explicit(&g_log_async.active, memory_order_acquire) > 0) {
+        sched_yield();
+    }
+
+    atomic_store_explicit(&g_log_async.stopping, true, memory_order_release);
+    pthread_mutex_lock(&g_log_async.lock);
+    pthread_cond_signal(&g_log_async.wakeup);
+    pthread_mutex_unlock(&g_log_async.lock);
+    pthread_join(g_log_async.thread, NULL);
+
+    free(g_log_async.slots);
+    g_log_async.slots = NULL;
+    pthread_mutex_unlock(&g_log_async.control_lock);
+    return 0;
+}
@@ -0,0 +1,1086 @@
+/**
+ * @file log_binary.c
+ * @brief 二进制延迟格式化日志：调用点注册、记录编码、文件轮转和离线解码。
+ *
+ * 文件由若干条目组成，每个条目以一个字节的标记开头，多字节整数使用写入端的字节序：
+ * - 'H' 文件头：7 字节魔数 "CRLNBIN"、1 字节版本号、4 字节字节序标记 0x01020304。
+ *   每次打开和轮转后写入，解码器遇到文件头时清空已知的调用点描述。
+ * - 'D' 调用点描述：u32 描述ID、u8 级别、u8 参数个数、u32 行号、u16 格式字符串长度、
+ *   u16 文件名长度、u16 函数名长度、u8 模块名长度，随后是每个参数的编码类型和各字符串（不含 '\0'）。
+ * - 'R' 日志记录：u32 描述ID、i64 秒、u32 微秒、i32 线程ID、u16 上下文长度、u16 参数长度，
+ *   随后是上下文前缀和按描述中的编码类型依次排列的参数。
+ *
+ * 参数编码：整数按类型宽度写 4 或 8 字节，浮点数写 8 字节 double，指针写 8 字节，
+ * 字符串写 u16 长度和内容。解码时按格式字符串逐个转换说明调用 snprintf，结果与 vsnprintf 相同。
+ *
+ * 调用点首次写入时在 g_log_binary.lock 下注册；记录在调用线程中编码，只在写入文件时加锁。
+ */
+#include "log_internal.h"
+#include <limits.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/stat.h>
+#include <time.h>
+
+// 文件头的魔数和版本号
+#define LOG_BINARY_MAGIC "CRLNBIN"
+#define LOG_BINARY_VERSION 1
+
+// 字节序标记，解码器据此拒绝其他字节序写入的文件
+#define LOG_BINARY_BYTE_ORDER 0x01020304u
+
+// 条目标记
+#define LOG_BINARY_TAG_HEADER 'H'
+#define LOG_BINARY_TAG_DESCRIPTOR 'D'
+#define LOG_BINARY_TAG_RECORD 'R'
+
+// 一个调用点最多支持的参数个数（包括 '*' 宽度和精度）
+#define LOG_BINARY_MAX_ARGS 16
+
+// 一条记录编码后的最大长度
+#define LOG_BINARY_RECORD_MAX 2048
+
+// 转换说明的精度：没有精度，或精度由 '*' 参数给出
+#define LOG_BINARY_PRECISION_NONE (-1)
+#define LOG_BINARY_PRECISION_STAR (-2)
+
+// 参数在文件中的编码类型
+typedef enum {
+    LOG_BINARY_WIRE_INT32 = 1, // 4 字节整数
+    LOG_BINARY_WIRE_INT64,     // 8 字节整数
+    LOG_BINARY_WIRE_DOUBLE,    // 8 字节 double
+    LOG_BINARY_WIRE_POINTER,   // 8 字节指针
+    LOG_BINARY_WIRE_STRING     // u16 长度 + 内容
+} log_binary_wire_t;
+
+// 参数的 C 类型，决定编码时 va_arg 取出的类型
+typedef enum {
+    LOG_BINARY_ARG_INT = 0,     // int 及提升为 int 的类型
+    LOG_BINARY_ARG_LONG,        // long
+    LOG_BINARY_ARG_LLONG,       // long long
+    LOG_BINARY_ARG_SIZE,        // size_t
+    LOG_BINARY_ARG_INTMAX,      // intmax_t
+    LOG_BINARY_ARG_PTRDIFF,     // ptrdiff_t
+    LOG_BINARY_ARG_DOUBLE,      // double
+    LOG_BINARY_ARG_LONG_DOUBLE, // long double，按 double 编码
+    LOG_BINARY_ARG_POINTER,     // void *
+    LOG_BINARY_ARG_STRING       // const char *
+} log_binary_arg_t;
+
+// 一个转换说明的解析结果
+typedef struct {
+    size_t length;       // 从 '%' 开始的长度
+    int stars;           // '*' 宽度和精度的个数
+    int precision;       // 精度，LOG_BINARY_PRECISION_NONE 或 LOG_BINARY_PRECISION_STAR
+    char conv;           // 转换字符，"%%" 时为 '%'
+    size_t mod_offset;   // 长度修饰符在说明中的偏移
+    size_t mod_length;   // 长度修饰符的长度
+    log_binary_arg_t arg; // 转换对应的参数类型
+} log_binary_spec_t;
+
+// 调用点注册信息，注册后不再改变，生命周期与进程相同
+typedef struct {
+    uint32_t id;                          // 描述ID，从 1 开始
+    bool supported;                       // 格式字符串能否二进制编码，不能时该调用点按文本输出
+    int nargs;                            // 参数个数
+    uint8_t args[LOG_BINARY_MAX_ARGS];    // 各参数的 C 类型 (log_binary_arg_t)
+    int precisions[LOG_BINARY_MAX_ARGS];  // 字符串参数的精度，编码时最多读取这么多字节
+} log_binary_entry_t;
+
+// 二进制日志的全局状态，除 open 外由 lock 保护
+static struct {
+    pthread_mutex_t lock;             // 保护文件、轮转和刷新状态以及调用点表
+    FILE *file;                       // 二进制日志文件
+    char path[256];                   // 文件路径
+    char *buffer;                     // 文件的用户态缓冲区
+    int open;                         // 文件是否已打开，写入前无锁检查，只能通过 __atomic 内建函数访问
+
+    log_rotation_config_t rotation;   // 轮转配置，与文本日志相同
+    size_t file_bytes;                // 当前文件的大小
+    time_t last_rotate_time;          // 上次轮转时间
+    log_flush_policy_t flush;         // 刷新策略，与文本日志相同
+    size_t pending_bytes;             // 上次刷新后写入的字节数
+    struct timeval last_flush;        // 上次刷新的时间
+
+    log_binary_site_t **sites;        // 已注册的调用点，按描述ID排列
+    size_t site_count;                // 已注册的调用点数量
+    size_t site_capacity;             // sites 数组的容量
+
+    log_rotator_t rotator;            // 后台轮转线程
+} g_log_binary = {.lock = PTHREAD_MUTEX_INITIALIZER,
+                  .rotation = {.max_file_size = 10 * 1024 * 1024,
+                               .max_file_count = 5,
+                               .rotate_on_size = true,
+                               .rotate_on_time = false,
+                               .rotate_interval_hours = 24},
+                  .flush = {.flush_level = LOG_LEVEL_ERROR},
+                  .rotator = LOG_ROTATOR_INITIALIZER};
+
+/*******************************************************************************
+ * 格式字符串解析，编码和解码共用
+ *******************************************************************************/
+
+// 解析 p 处 ('%') 开始的转换说明，不支持二进制编码时返回 false
+static bool log_binary_parse_spec(const char *p, log_binary_spec_t *spec)
+{
+    size_t i = 1;
+    memset(spec, 0, sizeof(*spec));
+    spec->precision = LOG_BINARY_PRECISION_NONE;
+
+    if (p[1] == '%') {
+        spec->length = 2;
+        spec->conv = '%';
+        return true;
+    }
+
+    // 位置参数 (%1$d) 不支持
+    size_t digits = i;
+    while (p[digits] >= '0' && p[digits] <= '9') {
+        digits++;
+    }
+    if (digits > i && p[digits] == '$') {
+        return false;
+    }
+
+    while (p[i] && strchr("-+ #0'", p[i])) {
+        i++;
+    }
+    if (p[i] == '*') {
+        spec->stars++;
+        i++;
+    } else {
+        while (p[i] >= '0' && p[i] <= '9') {
+            i++;
+        }
+    }
+    if (p[i] == '.') {
+        i++;
+        if (p[i] == '*') {
+            spec->stars++;
+            spec->precision = LOG_BINARY_PRECISION_STAR;
+            i++;
+        } else {
+            // 只有 '.' 时精度为 0；超出 int 范围的精度按 INT_MAX 处理，不影响截断
+            spec->precision = 0;
+            while (p[i] >= '0' && p[i] <= '9') {
+                if (spec->precision <= (INT_MAX - 9) / 10) {
+                    spec->precision = spec->precision * 10 + (p[i] - '0');
+                } else {
+                    spec->precision = INT_MAX;
+                }
+                i++;
+            }
+        }
+    }
+
+    spec->mod_offset = i;
+    if ((p[i] == 'h' && p[i + 1] == 'h') || (p[i] == 'l' && p[i + 1] == 'l')) {
+        i += 2;
+    } else if (p[i] && strchr("hlzjtL", p[i])) {
+        i++;
+    }
+    spec->mod_length = i - spec->mod_offset;
+    const char *mod = p + spec->mod_offset;
+    size_t mod_length = spec->mod_length;
+
+    spec->conv = p[i];
+    if (spec->conv == '\0') {
+        return false;
+    }
+    spec->length = i + 1;
+
+    switch (spec->conv) {
+        case 'd':
+        case 'i':
+        case 'o':
+        case 'u':
+        case 'x':
+        case 'X':
+            if (mod_length == 0 || mod[0] == 'h') {
+                spec->arg = LOG_BINARY_ARG_INT;
+            } else if (mod_length == 2 && mod[0] == 'l') {
+                spec->arg = LOG_BINARY_ARG_LLONG;
+            } else if (mod[0] == 'l') {
+                spec->arg = LOG_BINARY_ARG_LONG;
+            } else if (mod[0] == 'z') {
+                spec->arg = LOG_BINARY_ARG_SIZE;
+            } else if (mod[0] == 'j') {
+                spec->arg = LOG_BINARY_ARG_INTMAX;
+            } else if (mod[0] == 't') {
+                spec->arg = LOG_BINARY_ARG_PTRDIFF;
+            } else {
+                return false;
+            }
+            return true;
+        case 'c':
+            spec->arg = LOG_BINARY_ARG_INT;
+            return mod_length == 0;
+        case 's':
+            spec->arg = LOG_BINARY_ARG_STRING;
+            return mod_length == 0;
+        case 'p':
+            spec->arg = LOG_BINARY_ARG_POINTER;
+            return mod_length == 0;
+        case 'f':
+        case 'F':
+        case 'e':
+        case 'E':
+        case 'g':
+        case 'G':
+        case 'a':
+        case 'A':
+            if (mod_length == 0 || (mod_length == 1 && mod[0] == 'l')) {
+                spec->arg = LOG_BINARY_ARG_DOUBLE;
+                return true;
+            }
+            if (mod_length == 1 && mod[0] == 'L') {
+                spec->arg = LOG_BINARY_ARG_LONG_DOUBLE;
+                return true;
+            }
+            return false;
+        default:
+            // %n、%m、宽字符等
+            return false;
+    }
+}
+
+// 参数类型在文件中的编码类型
+static log_binary_wire_t log_binary_wire_of(log_binary_arg_t arg)
+{
+    switch (arg) {
+        case LOG_BINARY_ARG_INT:
+            return LOG_BINARY_WIRE_INT32;
+        case LOG_BINARY_ARG_LONG:
+            return sizeof(long) == 8 ? LOG_BINARY_WIRE_INT64 : LOG_BINARY_WIRE_INT32;
+        case LOG_BINARY_ARG_SIZE:
+            return sizeof(size_t) == 8 ? LOG_BINARY_WIRE_INT64 : LOG_BINARY_WIRE_INT32;
+        case LOG_BINARY_ARG_PTRDIFF:
+            return sizeof(ptrdiff_t) == 8 ? LOG_BINARY_WIRE_INT64 : LOG_BINARY_WIRE_INT32;
+        case LOG_BINARY_ARG_LLONG:
+        case LOG_BINARY_ARG_INTMAX:
+            return LOG_BINARY_WIRE_INT64;
+        case LOG_BINARY_ARG_DOUBLE:
+        case LOG_BINARY_ARG_LONG_DOUBLE:
+            return LOG_BINARY_WIRE_DOUBLE;
+        case LOG_BINARY_ARG_POINTER:
+            return LOG_BINARY_WIRE_POINTER;
+        default:
+            return LOG_BINARY_WIRE_STRING;
+    }
+}
+
+/*******************************************************************************
+ * 写入
+ *******************************************************************************/
+
+// 按文本日志的配置重新读取轮转配置和刷新策略
+void log_binary_reload_config(void)
+{
+    log_rotation_config_t rotation;
+    log_flush_policy_t flush;
+    log_get_rotation_config(&rotation);
+    log_get_flush_policy(&flush);
+
+    pthread_mutex_lock(&g_log_binary.lock);
+    g_log_binary.rotation = rotation;
+    g_log_binary.flush = flush;
+    pthread_mutex_unlock(&g_log_binary.lock);
+}
+
+// 写入一个调用点描述，调用者必须持有 g_log_binary.lock
+static void log_binary_write_descriptor_locked(const log_binary_site_t *site)
+{
+    const log_binary_entry_t *entry = (const log_binary_entry_t *)site->registration;
+    const char *module = log_get_module_name(site->module);
+    uint8_t head[1 + 4 + 1 + 1 + 4 + 2 + 2 + 2 + 1 + LOG_BINARY_MAX_ARGS];
+    size_t fmt_length = strnlen(site->fmt, UINT16_MAX);
+    size_t file_length = strnlen(site->file, UINT16_MAX);
+    size_t func_length = strnlen(site->func, UINT16_MAX);
+    size_t module_length = strnlen(module, UINT8_MAX);
+    uint32_t line = (uint32_t)site->line;
+    uint16_t length;
+    size_t pos = 0;
+
+    head[pos++] = LOG_BINARY_TAG_DESCRIPTOR;
+    memcpy(head + pos, &entry->id, 4);
+    pos += 4;
+    head[pos++] = (uint8_t)site->level;
+    head[pos++] = (uint8_t)entry->nargs;
+    memcpy(head + pos, &line, 4);
+    pos += 4;
+    length = (uint16_t)fmt_length;
+    memcpy(head + pos, &length, 2);
+    pos += 2;
+    length = (uint16_t)file_length;
+    memcpy(head + pos, &length, 2);
+    pos += 2;
+    length = (uint16_t)func_length;
+    memcpy(head + pos, &length, 2);
+    pos += 2;
+    head[pos++] = (uint8_t)module_length;
+    for (int i = 0; i < entry->nargs; i++) {
+        head[pos++] = (uint8_t)log_binary_wire_of((log_binary_arg_t)entry->args[i]);
+    }
+
+    size_t written = fwrite(head, 1, pos, g_log_binary.file);
+    written += fwrite(site->fmt, 1, fmt_length, g_log_binary.file);
+    written += fwrite(site->file, 1, file_length, g_log_binary.file);
+    written += fwrite(site->func, 1, func_length, g_log_binary.file);
+    written += fwrite(module, 1, module_length, g_log_binary.file);
+    g_log_binary.file_bytes += written;
+    g_log_binary.pending_bytes += written;
+}
+
+// 文件打开后设置缓冲区，读取文件大小，写入文件头和全部已注册调用点的描述，调用者必须持有 g_log_binary.lock
+static void log_binary_file_opened_locked(time_t now)
+{
+    if (g_log_binary.flush.buffer_size > 0) {
+        free(g_log_binary.buffer);
+        g_log_binary.buffer = (char *)malloc(g_log_binary.flush.buffer_size);
+        if (g_log_binary.buffer) {
+            setvbuf(g_log_binary.file, g_log_binary.buffer, _IOFBF, g_log_binary.flush.buffer_size);
+        }
+    }
+
+    struct stat st;
+    g_log_binary.file_bytes = 0;
+    if (fstat(fileno(g_log_binary.file), &st) == 0) {
+        g_log_binary.file_bytes = (size_t)st.st_size;
+    }
+    g_log_binary.last_rotate_time = now;
+
+    uint8_t header[1 + 7 + 1 + 4];
+    uint32_t byte_order = LOG_BINARY_BYTE_ORDER;
+    header[0] = LOG_BINARY_TAG_HEADER;
+    memcpy(header + 1, LOG_BINARY_MAGIC, 7);
+    header[8] = LOG_BINARY_VERSION;
+    memcpy(header + 9, &byte_order, 4);
+    size_t written = fwrite(header, 1, sizeof(header), g_log_binary.file);
+    g_log_binary.file_bytes += written;
+    g_log_binary.pending_bytes += written;
+
+    for (size_t i = 0; i < g_log_binary.site_count; i++) {
+        log_binary_write_descriptor_locked(g_log_binary.sites[i]);
+    }
+}
+
+// 轮转二进制日志文件，调用者必须持有 g_log_binary.lock
+static void log_binary_rotate_locked(time_t now)
+{
+    fclose(g_log_binary.file);
+    g_log_binary.file = NULL;
+    log_rotator_stage(&g_log_binary.rotator, g_log_binary.path, g_log_binary.rotation.max_file_count - 1, NULL);
+    // 重命名失败时重新打开原文件继续追加
+    g_log_binary.file = fopen(g_log_binary.path, "ab");
+    if (!g_log_binary.file) {
+        __atomic_store_n(&g_log_binary.open, 0, __ATOMIC_RELAXED);
+        fprintf(stderr, "Failed to reopen binary log file: %s\n", g_log_binary.path);
+        return;
+    }
+    log_binary_file_opened_locked(now);
+}
+
+// 刷新二进制日志文件，调用者必须持有 g_log_binary.lock
+static void log_binary_flush_locked(const struct timeval *now)
+{
+    if (g_log_binary.file) {
+        fflush(g_log_binary.file);
+    }
+    g_log_binary.pending_bytes = 0;
+    g_log_binary.last_flush = *now;
+}
+
+// 刷新二进制日志文件
+void log_binary_flush(void)
+{
+    struct timeval now;
+    gettimeofday(&now, NULL);
+    pthread_mutex_lock(&g_log_binary.lock);
+    log_binary_flush_locked(&now);
+    pthread_mutex_unlock(&g_log_binary.lock);
+}
+
+// 打开二进制日志文件
+int log_binary_open(const char *path)
+{
+    if (!path || !path[0] || strlen(path) >= sizeof(g_log_binary.path)) {
+        return -1;
+    }
+    log_binary_reload_config();
+
+    pthread_mutex_lock(&g_log_binary.lock);
+    if (g_log_binary.file) {
+        pthread_mutex_unlock(&g_log_binary.lock);
+        return -2;
+    }
+    g_log_binary.file = fopen(path, "ab");
+    if (!g_log_binary.file) {
+        pthread_mutex_unlock(&g_log_binary.lock);
+        return -3;
+    }
+    strcpy(g_log_binary.path, path);
+    gettimeofday(&g_log_binary.last_flush, NULL);
+    g_log_binary.pending_bytes = 0;
+    log_binary_file_opened_locked(g_log_binary.last_flush.tv_sec);
+    __atomic_store_n(&g_log_binary.open, 1, __ATOMIC_RELEASE);
+    pthread_mutex_unlock(&g_log_binary.lock);
+    return 0;
+}
+
+// 关闭二进制日志文件
+int log_binary_close(void)
+{
+    pthread_mutex_lock(&g_log_binary.lock);
+    if (!g_log_binary.file) {
+        pthread_mutex_unlock(&g_log_binary.lock);
+        return -1;
+    }
+    __atomic_store_n(&g_log_binary.open, 0, __ATOMIC_RELAXED);
+    fclose(g_log_binary.file);
+    g_log_binary.file = NULL;
+    free(g_log_binary.buffer);
+    g_log_binary.buffer = NULL;
+    pthread_mutex_unlock(&g_log_binary.lock);
+
+    // 路径只在下一次打开时改变，先等待旧路径的轮转全部完成
+    log_rotator_stop(&g_log_binary.rotator);
+    return 0;
+}
+
+// 注册调用点：解析格式字符串并分配描述ID，内存不足时返回 NULL
+static const log_binary_entry_t *log_binary_register(log_binary_site_t *site)
+{
+    const log_binary_entry_t *entry = __atomic_load_n(&site->registration, __ATOMIC_ACQUIRE);
+    if (entry) {
+        return entry;
+    }
+
+    pthread_mutex_lock(&g_log_binary.lock);
+    entry = (const log_binary_entry_t *)site->registration;
+    if (entry) {
+        pthread_mutex_unlock(&g_log_binary.lock);
+        return entry;
+    }
+
+    log_binary_entry_t *created = (log_binary_entry_t *)calloc(1, sizeof(log_binary_entry_t));
+    if (!created) {
+        pthread_mutex_unlock(&g_log_binary.lock);
+        return NULL;
+    }
+    created->supported = true;
+    for (const char *p = strchr(site->fmt, '%'); p; p = strchr(p, '%')) {
+        log_binary_spec_t spec;
+        if (!log_binary_parse_spec(p, &spec) ||
+            created->nargs + spec.stars + (spec.conv != '%') > LOG_BINARY_MAX_ARGS) {
+            created->supported = false;
+            break;
+        }
+        for (int i = 0; i < spec.stars; i++) {
+            created->args[created->nargs++] = LOG_BINARY_ARG_INT;
+        }
+        if (spec.conv != '%') {
+            created->precisions[created->nargs] = spec.precision;
+            created->args[created->nargs++] = (uint8_t)spec.arg;
+        }
+        p += spec.length;
+    }
+
+    // 不支持的调用点不分配描述ID，也不写入文件
+    if (created->supported) {
+        if (g_log_binary.site_count == g_log_binary.site_capacity) {
+            size_t capacity = g_log_binary.site_capacity ? g_log_binary.site_capacity * 2 : 64;
+            log_binary_site_t **sites =
+                (log_binary_site_t **)realloc(g_log_binary.sites, capacity * sizeof(log_binary_site_t *));
+            if (!sites) {
+                free(created);
+                pthread_mutex_unlock(&g_log_binary.lock);
+                return NULL;
+            }
+            g_log_binary.sites = sites;
+            g_log_binary.site_capacity = capacity;
+        }
+        g_log_binary.sites[g_log_binary.site_count++] = site;
+        created->id = (uint32_t)g_log_binary.site_count;
+    }
+
+    __atomic_store_n(&site->registration, created, __ATOMIC_RELEASE);
+    if (created->supported && g_log_binary.file) {
+        log_binary_write_descriptor_locked(site);
+    }
+    pthread_mutex_unlock(&g_log_binary.lock);
+    return created;
+}
+
+// 把一条记录编码到 buf 中，返回编码后的长度
+static size_t log_binary_encode(uint8_t *buf, const log_binary_entry_t *entry, const struct timeval *tv,
+                                va_list args)
+{
+    char context[LOG_CONTEXT_TEXT_MAX];
+    int64_t sec = (int64_t)tv->tv_sec;
+    uint32_t usec = (uint32_t)tv->tv_usec;
+    int32_t tid = (int32_t)log_current_tid();
+    size_t pos = 0;
+
+    uint16_t context_length = (uint16_t)log_render_context(context, sizeof(context), NULL);
+
+    buf[pos++] = LOG_BINARY_TAG_RECORD;
+    memcpy(buf + pos, &entry->id, 4);
+    pos += 4;
+    memcpy(buf + pos, &sec, 8);
+    pos += 8;
+    memcpy(buf + pos, &usec, 4);
+    pos += 4;
+    memcpy(buf + pos, &tid, 4);
+    pos += 4;
+    memcpy(buf + pos, &context_length, 2);
+    pos += 2;
+    size_t args_length_pos = pos;
+    pos += 2;
+    memcpy(buf + pos, context, context_length);
+    pos += context_length;
+
+    size_t args_start = pos;
+    int32_t last_int = 0; // 最近一个 int 参数，'*' 精度总是紧挨在其字符串参数之前
+    for (int i = 0; i < entry->nargs; i++) {
+        int32_t i32;
+        int64_t i64 = 0;
+        uint64_t u64;
+        double d;
+        switch ((log_binary_arg_t)entry->args[i]) {
+            case LOG_BINARY_ARG_INT:
+                i32 = (int32_t)va_arg(args, int);
+                last_int = i32;
+                memcpy(buf + pos, &i32, 4);
+                pos += 4;
+                continue;
+            case LOG_BINARY_ARG_LONG:
+                i64 = (int64_t)va_arg(args, long);
+                break;
+            case LOG_BINARY_ARG_LLONG:
+                i64 = (int64_t)va_arg(args, long long);
+                break;
+            case LOG_BINARY_ARG_SIZE:
+                i64 = (int64_t)va_arg(args, size_t);
+                break;
+            case LOG_BINARY_ARG_INTMAX:
+                i64 = (int64_t)va_arg(args, intmax_t);
+                break;
+            case LOG_BINARY_ARG_PTRDIFF:
+                i64 = (int64_t)va_arg(args, ptrdiff_t);
+                break;
+            case LOG_BINARY_ARG_DOUBLE:
+                d = va_arg(args, double);
+                memcpy(buf + pos, &d, 8);
+                pos += 8;
+                continue;
+            case LOG_BINARY_ARG_LONG_DOUBLE:
+                d = (double)va_arg(args, long double);
+                memcpy(buf + pos, &d, 8);
+                pos += 8;
+                continue;
+            case LOG_BINARY_ARG_POINTER:
+                u64 = (uint64_t)(uintptr_t)va_arg(args, void *);
+                memcpy(buf + pos, &u64, 8);
+                pos += 8;
+                continue;
+            case LOG_BINARY_ARG_STRING: {
+                const char *str = va_arg(args, const char *);
+                if (!str) {
+                    str = "(null)";
+                }
+                // 为其余参数预留空间，字符串按剩余空间截断
+                size_t room = LOG_BINARY_RECORD_MAX - pos - 2 - (size_t)(entry->nargs - i - 1) * 8;
+                size_t limit = room < LOG_BINARY_STRING_MAX ? room : LOG_BINARY_STRING_MAX;
+                // 带精度的 %s 可以指向不以 '\0' 结尾的缓冲区，最多读取精度指定的字节数；负的 '*' 精度视为没有精度
+                int precision = entry->precisions[i] == LOG_BINARY_PRECISION_STAR ? last_int : entry->precisions[i];
+                if (precision >= 0 && (size_t)precision < limit) {
+                    limit = (size_t)precision;
+                }
+                uint16_t length = (uint16_t)strnlen(str, limit);
+                memcpy(buf + pos, &length, 2);
+                pos += 2;
+                memcpy(buf + pos, str, length);
+                pos += length;
+                continue;
+            }
+        }
+        // 4 字节的 long、size_t 和 ptrdiff_t 按原宽度写入，解码时按转换字符做符号扩展或零扩展
+        if (log_binary_wire_of((log_binary_arg_t)entry->args[i]) == LOG_BINARY_WIRE_INT32) {
+            i32 = (int32_t)i64;
+            memcpy(buf + pos, &i32, 4);
+            pos += 4;
+        } else {
+            memcpy(buf + pos, &i64, 8);
+            pos += 8;
+        }
+    }
+
+    uint16_t args_length = (uint16_t)(pos - args_start);
+    memcpy(buf + args_length_pos, &args_length, 2);
+    return pos;
+}
+
+// 写入一条二进制日志
+void log_write_binary(log_binary_site_t *site, ...)
+{
+    if (!log_is_level_enabled(site->module, site->level)) {
+        return;
+    }
+
+    va_list args;
+    va_start(args, site);
+
+    const log_binary_entry_t *entry = NULL;
+    if (log_module_binary_output(site->module) && __atomic_load_n(&g_log_binary.open, __ATOMIC_ACQUIRE)) {
+        entry = log_binary_register(site);
+    }
+    if (!entry || !entry->supported) {
+        log_vwrite(site->level, site->module, site->file, site->line, site->func, NULL, site->fmt, args);
+        va_end(args);
+        return;
+    }
+
+    // 编码会消耗参数，保留一份在文件被关闭时按文本输出
+    va_list fallback;
+    va_copy(fallback, args);
+    struct timeval tv;
+    log_now(&tv);
+    uint8_t record[LOG_BINARY_RECORD_MAX];
+    size_t length = log_binary_encode(record, entry, &tv, args);
+    va_end(args);
+
+    pthread_mutex_lock(&g_log_binary.lock);
+    if (!g_log_binary.file) {
+        pthread_mutex_unlock(&g_log_binary.lock);
+        log_vwrite(site->level, site->module, site->file, site->line, site->func, NULL, site->fmt, fallback);
+        va_end(fallback);
+        return;
+    }
+    va_end(fallback);
+
+    const log_rotation_config_t *rotation = &g_log_binary.rotation;
+    if ((rotation->rotate_on_size && g_log_binary.file_bytes >= rotation->max_file_size) ||
+        (rotation->rotate_on_time &&
+         tv.tv_sec >= g_log_binary.last_rotate_time + (time_t)rotation->rotate_interval_hours * 3600)) {
+        log_binary_rotate_locked(tv.tv_sec);
+        if (!g_log_binary.file) {
+            pthread_mutex_unlock(&g_log_binary.lock);
+            return;
+        }
+    }
+
+    size_t written = fwrite(record, 1, length, g_log_binary.file);
+    g_log_binary.file_bytes += written;
+    g_log_binary.pending_bytes += written;
+
+    const log_flush_policy_t *policy = &g_log_binary.flush;
+    long elapsed_ms = (long)(tv.tv_sec - g_log_binary.last_flush.tv_sec) * 1000 +
+                      (long)(tv.tv_usec - g_log_binary.last_flush.tv_usec) / 1000;
+    if (policy->flush_bytes == 0 || g_log_binary.pending_bytes >= policy->flush_bytes ||
+        site->level <= policy->flush_level ||
+        (policy->flush_interval_ms > 0 && elapsed_ms >= policy->flush_interval_ms)) {
+        log_binary_flush_locked(&tv);
+    }
+    pthread_mutex_unlock(&g_log_binary.lock);
+}
+
+/*******************************************************************************
+ * 解码
+ *******************************************************************************/
+
+// 解码时的调用点描述
+typedef struct {
+    bool valid;                        // 是否已读到描述
+    int level;                         // 日志级别
+    int line;                          // 行号
+    int nargs;                         // 参数个数
+    uint8_t wires[LOG_BINARY_MAX_ARGS]; // 各参数的编码类型
+    char *fmt;                         // 格式字符串
+    char *file;                        // 文件名
+    char *func;                        // 函数名
+    char *module;                      // 模块名
+} log_binary_desc_t;
+
+// 解码器状态
+typedef struct {
+    FILE *in;                 // 输入文件
+    log_binary_desc_t *descs; // 按描述ID索引的调用点描述
+    size_t desc_count;        // descs 数组的长度
+} log_binary_decoder_t;
+
+// 读取指定长度，返回是否读满
+static bool log_binary_read(log_binary_decoder_t *decoder, void *buf, size_t length)
+{
+    return fread(buf, 1, length, decoder->in) == length;
+}
+
+// 读取指定长度的字符串并补上 '\0'
+static char *log_binary_read_string(log_binary_decoder_t *decoder, size_t length)
+{
+    char *str = (char *)malloc(length + 1);
+    if (!str) {
+        return NULL;
+    }
+    if (!log_binary_read(decoder, str, length)) {
+        free(str);
+        return NULL;
+    }
+    str[length] = '\0';
+    return str;
+}
+
+// 释放全部调用点描述
+static void log_binary_reset_descs(log_binary_decoder_t *decoder)
+{
+    for (size_t i = 0; i < decoder->desc_count; i++) {
+        free(decoder->descs[i].fmt);
+        free(decoder->descs[i].file);
+        free(decoder->descs[i].func);
+        free(decoder->descs[i].module);
+    }
+    free(decoder->descs);
+    decoder->descs = NULL;
+    decoder->desc_count = 0;
+}
+
+// 读取文件头（标记之后的部分）
+static bool log_binary_read_header(log_binary_decoder_t *decoder)
+{
+    uint8_t header[7 + 1 + 4];
+    uint32_t byte_order;
+    if (!log_binary_read(decoder, header, sizeof(header)) || memcmp(header, LOG_BINARY_MAGIC, 7) != 0 ||
+        header[7] != LOG_BINARY_VERSION) {
+        return false;
+    }
+    memcpy(&byte_order, header + 8, 4);
+    if (byte_order != LOG_BINARY_BYTE_ORDER) {
+        return false;
+    }
+    log_binary_reset_descs(decoder);
+    return true;
+}
+
+// 读取调用点描述（标记之后的部分）
+static bool log_binary_read_descriptor(log_binary_decoder_t *decoder)
+{
+    uint8_t head[4 + 1 + 1 + 4 + 2 + 2 + 2 + 1];
+    uint32_t id;
+    uint32_t line;
+    uint16_t fmt_length, file_length, func_length;
+
+    if (!log_binary_read(decoder, head, sizeof(head))) {
+        return false;
+    }
+    memcpy(&id, head, 4);
+    memcpy(&line, head + 6, 4);
+    memcpy(&fmt_length, head + 10, 2);
+    memcpy(&file_length, head + 12, 2);
+    memcpy(&func_length, head + 14, 2);
+    int nargs = head[5];
+    if (id == 0 || nargs > LOG_BINARY_MAX_ARGS || head[4] > LOG_LEVEL_TRACE) {
+        return false;
+    }
+
+    if (id > decoder->desc_count) {
+        size_t count = decoder->desc_count ? decoder->desc_count : 64;
+        while (count < id) {
+            count *= 2;
+        }
+        log_binary_desc_t *descs = (log_binary_desc_t *)realloc(decoder->descs, count * sizeof(log_binary_desc_t));
+        if (!descs) {
+            return false;
+        }
+        memset(descs + decoder->desc_count, 0, (count - decoder->desc_count) * sizeof(log_binary_desc_t));
+        decoder->descs = descs;
+        decoder->desc_count = count;
+    }
+
+    log_binary_desc_t *desc = &decoder->descs[id - 1];
+    free(desc->fmt);
+    free(desc->file);
+    free(desc->func);
+    free(desc->module);
+    memset(desc, 0, sizeof(*desc));
+    desc->level = head[4];
+    desc->nargs = nargs;
+    desc->line = (int)line;
+    if (!log_binary_read(decoder, desc->wires, (size_t)nargs)) {
+        return false;
+    }
+    desc->fmt = log_binary_read_string(decoder, fmt_length);
+    desc->file = log_binary_read_string(decoder, file_length);
+    desc->func = log_binary_read_string(decoder, func_length);
+    desc->module = log_binary_read_string(decoder, head[16]);
+    desc->valid = desc->fmt && desc->file && desc->func && desc->module;
+    return desc->valid;
+}
+
+// 已解码的参数值
+typedef struct {
+    log_binary_wire_t wire; // 编码类型
+    int64_t i;              // 整数，INT32 已符号扩展
+    uint64_t u;             // 整数按原宽度零扩展的值，或指针
+    double d;               // 浮点数
+    char *s;                // 字符串，指向参数缓冲区
+} log_binary_value_t;
+
+// 按调用点描述解出参数值，字符串在 args 中原地补上 '\0'（长度前缀已被读走）
+static bool log_binary_unpack(const log_binary_desc_t *desc, uint8_t *args, size_t length,
+                              log_binary_value_t *values)
+{
+    size_t pos = 0;
+    for (int i = 0; i < desc->nargs; i++) {
+        log_binary_value_t *value = &values[i];
+        int32_t i32;
+        uint16_t str_length;
+        value->wire = (log_binary_wire_t)desc->wires[i];
+        switch (value->wire) {
+            case LOG_BINARY_WIRE_INT32:
+                if (pos + 4 > length) {
+                    return false;
+                }
+                memcpy(&i32, args + pos, 4);
+                value->i = i32;
+                value->u = (uint32_t)i32;
+                pos += 4;
+                break;
+            case LOG_BINARY_WIRE_INT64:
+            case LOG_BINARY_WIRE_POINTER:
+                if (pos + 8 > length) {
+                    return false;
+                }
+                memcpy(&value->i, args + pos, 8);
+                value->u = (uint64_t)value->i;
+                pos += 8;
+                break;
+            case LOG_BINARY_WIRE_DOUBLE:
+                if (pos + 8 > length) {
+                    return false;
+                }
+                memcpy(&value->d, args + pos, 8);
+                pos += 8;
+                break;
+            case LOG_BINARY_WIRE_STRING:
+                if (pos + 2 > length) {
+                    return false;
+                }
+                memcpy(&str_length, args + pos, 2);
+                if (pos + 2 + str_length > length) {
+                    return false;
+                }
+                // 把字符串整体前移两个字节覆盖长度前缀，末尾写 '\0'
+                memmove(args + pos, args + pos + 2, str_length);
+                args[pos + str_length] = '\0';
+                value->s = (char *)args + pos;
+                pos += 2 + (size_t)str_length;
+                break;
+            default:
+                return false;
+        }
+    }
+    return pos == length;
+}
+
+// 用单个转换说明格式化一个参数，stars 个 '*' 参数在 star 中
+#define LOG_BINARY_PRINT(buf, size, spec, stars, star, value)                                      \
+    ((stars) == 0   ? snprintf(buf, size, spec, value)                                             \
+     : (stars) == 1 ? snprintf(buf, size, spec, (star)[0], value)                                  \
+                    : snprintf(buf, size, spec, (star)[0], (star)[1], value))
+
+// 按格式字符串和参数值渲染消息正文，结果与 vsnprintf 相同（长度上限为 size - 1）
+static void log_binary_format_message(char *buf, size_t size, const char *fmt, const log_binary_value_t *values)
+{
+    size_t pos = 0;
+    int arg = 0;
+
+    buf[0] = '\0';
+    for (const char *p = fmt; *p && pos + 1 < size;) {
+        if (*p != '%') {
+            buf[pos++] = *p++;
+            buf[pos] = '\0';
+            continue;
+        }
+
+        log_binary_spec_t spec;
+        if (!log_binary_parse_spec(p, &spec)) {
+            break;
+        }
+        if (spec.conv == '%') {
+            buf[pos++] = '%';
+            buf[pos] = '\0';
+            p += spec.length;
+            continue;
+        }
+
+        int star[2] = {0, 0};
+        for (int i = 0; i < spec.stars; i++) {
+            star[i] = (int)values[arg++].i;
+        }
+        const log_binary_value_t *value = &values[arg++];
+
+        // 重建转换说明：整数统一用 ll 修饰符，浮点数去掉 L 修饰符
+        char conv[32];
+        size_t prefix = spec.mod_offset < sizeof(conv) - 4 ? spec.mod_offset : sizeof(conv) - 4;
+        memcpy(conv, p, prefix);
+        size_t n = prefix;
+        bool integer = strchr("diouxX", spec.conv) != NULL;
+        bool keep_modifier = integer && value->wire == LOG_BINARY_WIRE_INT32 &&
+                             (spec.mod_length == 0 || p[spec.mod_offset] == 'h');
+        if (keep_modifier) {
+            memcpy(conv + n, p + spec.mod_offset, spec.mod_length);
+            n += spec.mod_length;
+        } else if (integer) {
+            conv[n++] = 'l';
+            conv[n++] = 'l';
+        }
+        conv[n++] = spec.conv;
+        conv[n] = '\0';
+
+        int written;
+        if (keep_modifier || spec.conv == 'c') {
+            written = LOG_BINARY_PRINT(buf + pos, size - pos, conv, spec.stars, star, (int)value->i);
+        } else if (spec.conv == 'd' || spec.conv == 'i') {
+            written = LOG_BINARY_PRINT(buf + pos, size - pos, conv, spec.stars, star, (long long)value->i);
+        } else if (integer) {
+            written = LOG_BINARY_PRINT(buf + pos, size - pos, conv, spec.stars, star, (unsigned long long)value->u);
+        } else if (spec.conv == 's') {
+            written = LOG_BINARY_PRINT(buf + pos, size - pos, conv, spec.stars, star, value->s);
+        } else if (spec.conv == 'p') {
+            written = LOG_BINARY_PRINT(buf + pos, size - pos, conv, spec.stars, star, (void *)(uintptr_t)value->u);
+        } else {
+            written = LOG_BINARY_PRINT(buf + pos, size - pos, conv, spec.stars, star, value->d);
+        }
+        if (written > 0) {
+            pos += (size_t)written < size - pos ? (size_t)written : size - pos - 1;
+        }
+        p += spec.length;
+    }
+}
+
+// 按格式选项输出一行，版式与 log_emit_locked 写入文件的相同
+static void log_binary_print_line(FILE *out, const log_format_options_t *options, const log_binary_desc_t *desc,
+                                  int64_t sec, uint32_t usec, int32_t tid, const char *context,
+                                  const char *message)
+{
+    if (options->show_time) {
+        time_t t = (time_t)sec;
+        struct tm tm_info;
+        char time_str[32];
+        localtime_r(&t, &tm_info);
+        if (strftime(time_str, sizeof(time_str), options->time_format, &tm_info) == 0) {
+            time_str[0] = '\0';
+        }
+        fprintf(out, "[%s.%03ld] ", time_str, (long)usec / 1000);
+    }
+    fprintf(out, "[%s] ", log_level_names[desc->level]);
+    if (options->show_tid) {
+        fprintf(out, "[TID:%ld] ", (long)tid);
+    }
+    if (options->show_module) {
+        fprintf(out, "[%s] ", desc->module);
+    }
+    if (options->show_file_line) {
+        const char *filename = strrchr(desc->file, '/');
+        filename = filename ? filename + 1 : desc->file;
+        fprintf(out, "[%s:%d] ", filename, desc->line);
+    }
+    if (options->show_function) {
+        fprintf(out, "[%s] ", desc->func);
+    }
+    fprintf(out, "%s%s\n", context, message);
+}
+
+// 读取并输出一条日志记录（标记之后的部分）
+static bool log_binary_read_record(log_binary_decoder_t *decoder, FILE *out, const log_format_options_t *options)
+{
+    uint8_t head[4 + 8 + 4 + 4 + 2 + 2];
+    uint32_t id;
+    int64_t sec;
+    uint32_t usec;
+    int32_t tid;
+    uint16_t context_length, args_length;
+    char context[LOG_BINARY_RECORD_MAX];
+    uint8_t args[LOG_BINARY_RECORD_MAX];
+    log_binary_value_t values[LOG_BINARY_MAX_ARGS];
+    char message[LOG_MESSAGE_MAX];
+
+    if (!log_binary_read(decoder, head, sizeof(head))) {
+        return false;
+    }
+    memcpy(&id, head, 4);
+    memcpy(&sec, head + 4, 8);
+    memcpy(&usec, head + 12, 4);
+    memcpy(&tid, head + 16, 4);
+    memcpy(&context_length, head + 20, 2);
+    memcpy(&args_length, head + 22, 2);
+    if (id == 0 || id > decoder->desc_count || !decoder->descs[id - 1].valid ||
+        context_length >= sizeof(context) || args_length > sizeof(args)) {
+        return false;
+    }
+    if (!log_binary_read(decoder, context, context_length) || !log_binary_read(decoder, args, args_length)) {
+        return false;
+    }
+    context[context_length] = '\0';
+
+    const log_binary_desc_t *desc = &decoder->descs[id - 1];
+    if (!log_binary_unpack(desc, args, args_length, values)) {
+        return false;
+    }
+    log_binary_format_message(message, sizeof(message), desc->fmt, values);
+    log_binary_print_line(out, options, desc, sec, usec, tid, context, message);
+    return true;
+}
+
+// 把二进制日志文件解码为文本
+int log_binary_decode(const char *path, FILE *out, const log_format_options_t *options)
+{
+    log_format_options_t defaults = {.show_time = true,
+                                     .show_tid = true,
+                                     .show_module = true,
+                                     .show_file_line = true,
+                                     .show_function = true,
+                                     .use_colors = false,
+                                     .use_iso_time = true,
+                                     .time_format = "%Y-%m-%d %H:%M:%S"};
+    if (!options) {
+        options = &defaults;
+    }
+    if (!path || !out) {
+        return -1;
+    }
+
+    log_binary_decoder_t decoder = {.in = fopen(path, "rb")};
+    if (!decoder.in) {
+        return -1;
+    }
+
+    int count = 0;
+    bool ok = true;
+    bool seen_header = false;
+    int tag;
+    while (ok && (tag = fgetc(decoder.in)) != EOF) {
+        switch (tag) {
+            case LOG_BINARY_TAG_HEADER:
+                ok = log_binary_read_header(&decoder);
+                seen_header = ok;
+                break;
+            case LOG_BINARY_TAG_DESCRIPTOR:
+                ok = seen_header && log_binary_read_descriptor(&decoder);
+                break;
+            case LOG_BINARY_TAG_RECORD:
+                ok = seen_header && log_binary_read_record(&decoder, out, options);
+                if (ok) {
+                    count++;
+                }
+                break;
+            default:
+                ok = false;
+                break;
+        }
+    }
+
+    log_binary_reset_descs(&decoder);
+    fclose(decoder.in);
+    return ok ? count : -2;
+}
@@ -0,0 +1,229 @@
+/**
+ * @file log_internal.h
+ * @brief 日志模块的内部头文件。
+ *
+ * 声明 log.c 与异步后端 (log_async.c) 之间共享的日志记录结构和函数，
+ * 不应被外部代码直接包含。
+ */
+#ifndef CROLINKIT_LOG_INTERNAL_H
+#define CROLINKIT_LOG_INTERNAL_H
+
+#include "log.h"
+#include <pthread.h>
+#include <stdarg.h>
+#include <stddef.h>
+#include <sys/time.h>
+#include <sys/types.h>
+
+// 格式化后的消息正文的最大长度（含结尾的 '\0'）
+#define LOG_MESSAGE_MAX 1024
+
+// 上下文前缀（[CTX:...] [SID:...] 等）的最大长度（含结尾的 '\0'）
+#define LOG_CONTEXT_TEXT_MAX 256
+
+/**
+ * @brief 一条待输出的日志记录
+ *
+ * 生产者在调用 log_write 的线程中填写：采集时间戳和线程ID，渲染上下文前缀，格式化消息正文。
+ * 时间、级别、模块、文件行号等前缀在输出时按当时的格式选项渲染。
+ * file 和 func 通常是 __FILE__ 和 __func__，只保存指针。
+ */
+typedef struct {
+    log_level_t level;                     // 日志级别
+    log_module_t module;                   // 日志模块
+    const char *file;                      // 源文件名
+    int line;                              // 行号
+    const char *func;                      // 函数名
+    struct timeval tv;                     // 调用 log_write 时的时间
+    pid_t tid;                             // 调用 log_write 的线程ID
+    char context[LOG_CONTEXT_TEXT_MAX];    // 上下文前缀，没有上下文时为空字符串
+    char message[LOG_MESSAGE_MAX];         // 格式化后的消息正文
+} log_record_t;
+
+/*******************************************************************************
+ * log.c 提供给异步后端的输出接口
+ *******************************************************************************/
+
+/**
+ * @brief 开始输出一批日志记录
+ */
+void log_output_batch_begin(void);
+
+/**
+ * @brief 输出一条日志记录到控制台、文件和回调，调用者必须已调用 log_output_batch_begin
+ *
+ * 持有记录所属输出目标的锁直到下一条记录属于另一个输出目标或本批结束，连续写同一个文件时不重复加锁。
+ *
+ * @param record 日志记录
+ */
+void log_output_record_locked(const log_record_t *record);
+
+/**
+ * @brief 结束一批输出：按刷新策略刷新控制台和文件，释放输出目标的锁
+ */
+void log_output_batch_end(void);
+
+/**
+ * @brief 写线程空闲时调用：按时间刷新策略到期时刷新缓冲的日志
+ */
+void log_output_idle(void);
+
+/**
+ * @brief 获取当前时间，与 log_write 采集时间戳使用同一个时钟
+ */
+void log_now(struct timeval *tv);
+
+/**
+ * @brief 获取当前线程ID
+ */
+pid_t log_current_tid(void);
+
+/**
+ * @brief 渲染上下文前缀（[CTX:...] [SID:...] 等），没有上下文时为空字符串
+ *
+ * @param context 显式提供的上下文，为NULL时使用当前线程的上下文
+ * @return 写入的长度，不含结尾的 '\0'
+ */
+size_t log_render_context(char *buf, size_t size, const log_context_t *context);
+
+/**
+ * @brief 同步或交给异步后端输出一条日志，与 log_write 相同但接受 va_list
+ *
+ * @param context 显式提供的上下文，为NULL时使用当前线程的上下文
+ */
+void log_vwrite(log_level_t level, log_module_t module, const char *file, int line, const char *func,
+                const log_context_t *context, const char *fmt, va_list args);
+
+/**
+ * @brief 模块的二进制调用点 (LOG_BIN_*) 是否写入二进制日志文件，无锁读取
+ */
+bool log_module_binary_output(log_module_t module);
+
+/*******************************************************************************
+ * 后台轮转线程
+ *******************************************************************************/
+
+/**
+ * @brief 一个日志文件的后台轮转线程
+ *
+ * 轮转时写日志的线程只把当前文件改名为按序号命名的待处理文件，
+ * 轮转线程在日志锁之外按顺序删除最旧的 .N，把 .1 … .N-1 依次后移，待处理文件成为 .1。
+ * 每个会轮转的日志文件使用一个独立的实例，首次轮转时启动线程。
+ */
+typedef struct {
+    pthread_mutex_t mutex;       // 保护以下字段
+    pthread_cond_t cond;         // 有新的待处理文件或已处理完一个
+    pthread_t thread;            // 轮转线程
+    bool started;                // 轮转线程是否已启动
+    bool stop;                   // 请求轮转线程处理完剩余文件后退出
+    char path[256];              // 日志文件路径
+    int backup_count;            // 保留的备份文件数量 (max_file_count - 1)
+    unsigned long staged;        // 已改名为待处理文件的轮转次数
+    unsigned long completed;     // 已并入备份链的轮转次数
+} log_rotator_t;
+
+// log_rotator_t 的静态初始化
+#define LOG_ROTATOR_INITIALIZER {.mutex = PTHREAD_MUTEX_INITIALIZER, .cond = PTHREAD_COND_INITIALIZER}
+
+/**
+ * @brief 把已关闭的日志文件改名为待处理文件，交给轮转线程并入备份链
+ *
+ * 调用者负责在调用前关闭文件、在调用后重新打开文件。
+ * 日志文件路径只应在此前的 log_rotator_stop 处理完旧路径的全部文件之后改变。
+ *
+ * @param rotator 轮转线程
+ * @param path 日志文件路径
+ * @param backup_count 保留的备份文件数量
+ * @param seq 不为 NULL 时返回本次轮转的序号，可用于 log_rotator_wait
+ * @return 成功返回0，重命名失败返回-2，启动轮转线程失败返回-3
+ */
+int log_rotator_stage(log_rotator_t *rotator, const char *path, int backup_count, unsigned long *seq);
+
+/**
+ * @brief 等待第 seq 次轮转并入备份链
+ */
+void log_rotator_wait(log_rotator_t *rotator, unsigned long seq);
+
+/**
+ * @brief 处理完剩余的待处理文件后停止轮转线程
+ */
+void log_rotator_stop(log_rotator_t *rotator);
+
+/*******************************************************************************
+ * 二进制日志 (log_binary.c)
+ *******************************************************************************/
+
+/**
+ * @brief 轮转或刷新策略改变后重新读取配置，调用者不能持有 g_log_config.mutex
+ */
+void log_binary_reload_config(void);
+
+/**
+ * @brief 刷新二进制日志文件
+ */
+void log_binary_flush(void);
+
+/*******************************************************************************
+ * 异步后端 (log_async.c)
+ *******************************************************************************/
+
+/**
+ * @brief 启动后台写线程
+ *
+ * @return 成功返回0，已启用返回-2，内存分配或线程创建失败返回-3
+ */
+int log_async_start(const log_async_config_t *config);
+
+/**
+ * @brief 输出缓冲区中剩余的全部日志并停止后台写线程
+ *
+ * @return 成功返回0，未启用返回-1
+ */
+int log_async_stop(void);
+
+/**
+ * @brief 记录一条被去重折叠的日志 (log_ratelimit.c)
+ */
+void log_suppress_note_deduplicated(void);
+
+/**
+ * @brief 记录一行 "last message repeated N times" (log_ratelimit.c)
+ */
+void log_suppress_note_repeat_report(void);
+
+/**
+ * @brief 清零被抑制日志的统计 (log_ratelimit.c)
+ */
+void log_suppress_reset_stats(void);
+
+/**
+ * @brief 把一条日志交给异步后端
+ *
+ * 从环形缓冲区领取一个槽位，调用 log_fill_record 在槽位中填写记录后发布给后台写线程。
+ * FATAL 级别的日志在写出后才返回；ERROR 和 FATAL 日志在任何溢出策略下都不丢弃。
+ *
+ * @return 已交给后端或按溢出策略丢弃返回 true；异步模式未启用，或写线程自身的 ERROR/FATAL 日志
+ *         遇到缓冲区已满时返回 false，调用者应同步输出
+ */
+bool log_async_submit(log_level_t level, log_module_t module, const char *file, int line, const char *func,
+                      const log_context_t *context, const char *fmt, va_list args);
+
+/**
+ * @brief 等待调用前已提交的日志全部输出，异步模式未启用或在后台写线程中调用时立即返回
+ */
+void log_async_drain(void);
+
+/**
+ * @brief 异步模式是否已启用
+ */
+bool log_async_enabled(void);
+
+/**
+ * @brief 填写一条日志记录：时间戳、线程ID、上下文前缀和格式化后的消息
+ *
+ * @param context 显式提供的上下文，为NULL时使用当前线程的上下文
+ */
+void log_fill_record(log_record_t *record, log_level_t level, log_module_t module, const char *file, int line,
+                     const char *func, const log_context_t *context, const char *fmt, va_list args);
+
+#endif /* CROLINKIT_LOG_INTERNAL_H */
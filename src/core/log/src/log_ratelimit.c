@@ -0,0 +1,119 @@
+/**
+ * @file log_ratelimit.c
+ * @brief 热点日志调用点的采样和限流，以及被抑制日志的统计。
+ *
+ * LOG_EVERY_N、LOG_FIRST_N、LOG_EVERY_MS 和 LOG_RATELIMITED 在每个调用处定义静态状态变量，
+ * 这里的判断函数只对该变量做原子操作，不加锁。限流使用 GCRA (通用信元速率算法) 实现令牌桶：
+ * 状态只有一个"理论到达时间"，一次比较交换即可同时完成补充令牌和消耗令牌。
+ *
+ * 被抑制的条数按原因累计在全局计数器中，由 log_get_suppress_stats 读取，在每次 log_init 时清零。
+ */
+#include "log_internal.h"
+#include <time.h>
+
+// 各原因被抑制的日志条数，只能通过 __atomic 内建函数访问
+static uint64_t g_log_suppressed_sampled;
+static uint64_t g_log_suppressed_rate_limited;
+static uint64_t g_log_suppressed_deduplicated;
+static uint64_t g_log_repeat_reports;
+
+// 单调时钟的当前时间（纳秒）
+static int64_t log_monotonic_ns(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (int64_t)ts.tv_sec * 1000000000LL + ts.tv_nsec;
+}
+
+// 每 n 次调用写出一次：第 1、n+1、2n+1 … 次
+bool log_site_every_n(unsigned long *counter, unsigned long n)
+{
+    unsigned long seq = __atomic_fetch_add(counter, 1, __ATOMIC_RELAXED);
+    if (n <= 1 || seq % n == 0) {
+        return true;
+    }
+    __atomic_add_fetch(&g_log_suppressed_sampled, 1, __ATOMIC_RELAXED);
+    return false;
+}
+
+// 只写出前 n 次调用
+bool log_site_first_n(unsigned long *counter, unsigned long n)
+{
+    // 达到上限后只读不写，调用点的状态不再在 CPU 之间来回传递
+    if (__atomic_load_n(counter, __ATOMIC_RELAXED) < n &&
+        __atomic_fetch_add(counter, 1, __ATOMIC_RELAXED) < n) {
+        return true;
+    }
+    __atomic_add_fetch(&g_log_suppressed_sampled, 1, __ATOMIC_RELAXED);
+    return false;
+}
+
+// 距上次写出至少 interval_ms 毫秒才再次写出
+bool log_site_every_ms(int64_t *next_ns, long interval_ms)
+{
+    int64_t now = log_monotonic_ns();
+    int64_t next = __atomic_load_n(next_ns, __ATOMIC_RELAXED);
+    // 多个线程同时到期时只有交换成功的一个写出
+    if (now >= next && __atomic_compare_exchange_n(next_ns, &next, now + (int64_t)interval_ms * 1000000LL, false,
+                                                   __ATOMIC_RELAXED, __ATOMIC_RELAXED)) {
+        return true;
+    }
+    __atomic_add_fetch(&g_log_suppressed_sampled, 1, __ATOMIC_RELAXED);
+    return false;
+}
+
+// 令牌桶：每秒补充 rate 个令牌，最多积累 burst 个
+bool log_site_ratelimit(int64_t *tat_ns, unsigned rate, unsigned burst)
+{
+    if (rate > 0) {
+        int64_t interval = 1000000000LL / rate;
+        int64_t tolerance = interval * (int64_t)(burst > 0 ? burst - 1 : 0);
+        int64_t now = log_monotonic_ns();
+        int64_t tat = __atomic_load_n(tat_ns, __ATOMIC_RELAXED);
+        for (;;) {
+            // 理论到达时间超前当前时间的部分对应已消耗的令牌
+            int64_t start = tat > now ? tat : now;
+            if (start - now > tolerance) {
+                break;
+            }
+            if (__atomic_compare_exchange_n(tat_ns, &tat, start + interval, true, __ATOMIC_RELAXED,
+                                            __ATOMIC_RELAXED)) {
+                return true;
+            }
+        }
+    }
+    __atomic_add_fetch(&g_log_suppressed_rate_limited, 1, __ATOMIC_RELAXED);
+    return false;
+}
+
+// 记录一条被去重折叠的日志
+void log_suppress_note_deduplicated(void)
+{
+    __atomic_add_fetch(&g_log_suppressed_deduplicated, 1, __ATOMIC_RELAXED);
+}
+
+// 记录一行 "last message repeated N times"
+void log_suppress_note_repeat_report(void)
+{
+    __atomic_add_fetch(&g_log_repeat_reports, 1, __ATOMIC_RELAXED);
+}
+
+// 清零统计
+void log_suppress_reset_stats(void)
+{
+    __atomic_store_n(&g_log_suppressed_sampled, 0, __ATOMIC_RELAXED);
+    __atomic_store_n(&g_log_suppressed_rate_limited, 0, __ATOMIC_RELAXED);
+    __atomic_store_n(&g_log_suppressed_deduplicated, 0, __ATOMIC_RELAXED);
+    __atomic_store_n(&g_log_repeat_reports, 0, __ATOMIC_RELAXED);
+}
+
+// 获取被抑制日志的统计
+void log_get_suppress_stats(log_suppress_stats_t *stats)
+{
+    if (stats) {
+        stats->sampled = __atomic_load_n(&g_log_suppressed_sampled, __ATOMIC_RELAXED);
+        stats->rate_limited = __atomic_load_n(&g_log_suppressed_rate_limited, __ATOMIC_RELAXED);
+        stats->deduplicated = __atomic_load_n(&g_log_suppressed_deduplicated, __ATOMIC_RELAXED);
+        stats->repeat_reports = __atomic_load_n(&g_log_repeat_reports, __ATOMIC_RELAXED);
+    }
+}
@@ -9,6 +9,7 @@
 #include "log.h"
 #include <errno.h> // 用于 strerror() 函数获取错误信息
 #include <pthread.h>
+#include <sched.h> // 用于 sched_yield()
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
@@ -18,197 +19,1519 @@
 // 前向声明内部静态函数
 static void *auto_adjust_thread_function(void *arg);
 
+/**
+ * @brief 当前线程作为工作线程时的线程本地上下文。
+ *
+ * 工作线程启动时设置，非工作线程中 pool 为 NULL。
+ * 用于让工作线程在提交子任务时优先使用自己的本地节点缓存。
+ */
+static _Thread_local struct {
+    thread_pool_t pool;            /**< 当前线程所属的线程池。 */
+    task_node_cache_t *node_cache; /**< 当前工作线程的本地节点缓存 (位于其工作线程状态中)。 */
+    int thread_id;                 /**< 当前工作线程的ID，工作窃取模式下用于定位本地队列。 */
+    task_node_t *current_node;     /**< 当前正在执行的任务节点，供 thread_pool_set_task_result 使用。 */
+} tls_worker;
+
+const char task_anonymous_name[] = "[anonymous]";
+
+/**
+ * @brief 队列腾出空位后唤醒等待中的提交者 (内部函数)。
+ *
+ * 每腾出一个槽位只唤醒一个能使用它的提交者：可使用保留槽位的提交者优先，
+ * 只有空位超出保留部分时才唤醒普通提交者。一次腾出多个槽位时唤醒所有提交者，由它们重新竞争。
+ * 调用者必须持有池的锁。
+ *
+ * @param pool 指向 thread_pool_s 实例的指针 (设置了队列容量)。
+ * @param freed 腾出的槽位数量。
+ */
+static void pool_space_released_locked(thread_pool_t pool, int freed)
+{
+    if (pool->space_waiters == 0 && pool->reserved_space_waiters == 0) {
+        return;
+    }
+    if (freed > 1) {
+        pthread_cond_broadcast(&pool->reserved_space_cond);
+        pthread_cond_broadcast(&pool->space_cond);
+    } else if (pool->reserved_space_waiters > 0) {
+        pthread_cond_signal(&pool->reserved_space_cond);
+    } else if (pool->task_queue_size < pool->queue_capacity - pool->queue_reserved) {
+        pthread_cond_signal(&pool->space_cond);
+    }
+}
+
+/**
+ * @brief 调整任务队列长度并发布给快照接口 (内部函数)。调用者必须持有池的锁。
+ *
+ * 队列变短且设置了队列容量时，唤醒等待空位的提交者。
+ */
+static inline void pool_queue_size_add_locked(thread_pool_t pool, int delta)
+{
+    pool->task_queue_size += delta;
+    atomic_store_explicit(&pool->stat_queue_size, pool->task_queue_size, memory_order_relaxed);
+    if (delta < 0 && pool->queue_capacity > 0) {
+        pool_space_released_locked(pool, -delta);
+    }
+}
+
+/**
+ * @brief 调整空闲线程数并发布给快照接口 (内部函数)。调用者必须持有池的锁。
+ */
+static inline void pool_idle_threads_add_locked(thread_pool_t pool, int delta)
+{
+    pool->idle_threads += delta;
+    atomic_store_explicit(&pool->stat_idle_threads, pool->idle_threads, memory_order_relaxed);
+}
+
+/**
+ * @brief 递增只在持有池锁时修改的统计计数器 (内部函数)。
+ *
+ * 写者已由池锁串行化，因此用 relaxed 读写代替原子读-改-写。
+ */
+static inline void stat_counter_inc_locked(atomic_ulong *counter)
+{
+    atomic_store_explicit(counter, atomic_load_explicit(counter, memory_order_relaxed) + 1, memory_order_relaxed);
+}
+
+/**
+ * @brief 为新任务获取一个任务节点 (内部函数)。
+ *
+ * 如果调用者是该池的工作线程，优先从其本地缓存中获取，
+ * 否则从池的共享 slab 中获取。调用者必须持有池的锁。
+ *
+ * @param pool 指向 thread_pool_s 实例的指针。
+ * @return 任务节点，slab 扩展失败时返回 NULL。
+ */
+static task_node_t *task_node_alloc(thread_pool_t pool)
+{
+    if (tls_worker.pool == pool) {
+        task_node_t *node = task_node_cache_pop(tls_worker.node_cache);
+        if (node != NULL) {
+            return node;
+        }
+    }
+    return task_slab_alloc(&pool->task_slab);
+}
+
+/**
+ * @brief 结束节点上登记的完成句柄并释放节点持有的引用 (内部函数)。
+ *
+ * 节点未登记句柄时不执行任何操作。调用者必须持有池的锁。
+ *
+ * @param node 已完成、被取消或被丢弃的任务节点。
+ * @param state TASK_FUTURE_COMPLETED 或 TASK_FUTURE_CANCELLED。
+ */
+static void task_node_finish_future(task_node_t *node, task_future_state_t state)
+{
+    if (node->future == NULL) {
+        return;
+    }
+    task_future_finish(node->future, state, node->result);
+    task_future_release(node->future);
+    node->future = NULL;
+}
+
 // --- 任务队列管理函数 (内部) ---
 
 /**
- * @brief 按优先级向队列中添加任务 (内部函数)。
+ * @brief 将任务优先级映射到运行队列的级别索引 (内部函数)。
+ *
+ * 优先级数值直接作为级别索引使用，超出 [0, TASK_PRIORITY_LEVELS-1] 的
+ * 自定义优先级被钳制到最近的边界级别。
+ *
+ * @param priority 任务优先级。
+ * @return 运行队列中的级别索引。
+ */
+static inline int task_priority_level(task_priority_t priority)
+{
+    int level = (int)priority;
+    if (level < 0) {
+        return 0;
+    }
+    if (level >= TASK_PRIORITY_LEVELS) {
+        return TASK_PRIORITY_LEVELS - 1;
+    }
+    return level;
+}
+
+/**
+ * @brief 指定优先级的任务是否可以进入队列 (内部函数)。
+ *
+ * 未设置队列容量时总是可以；否则普通任务只能使用容量减去保留槽位后的部分，
+ * 级别不大于 queue_reserved_level 的任务可以用满整个容量。调用者必须持有池的锁。
+ */
+static inline int pool_queue_admits_locked(thread_pool_t pool, task_priority_t priority)
+{
+    if (pool->queue_capacity == 0) {
+        return 1;
+    }
+    int limit = pool->queue_capacity;
+    if (task_priority_level(priority) > pool->queue_reserved_level) {
+        limit -= pool->queue_reserved;
+    }
+    return pool->task_queue_size < limit;
+}
+
+/**
+ * @brief 记录一次因队列已满而拒绝的提交 (内部函数)。调用者必须持有池的锁。
+ */
+static void pool_reject_locked(thread_pool_t pool, task_priority_t priority)
+{
+    TPOOL_DEBUG("线程池 %p 的队列已满 (%d/%d)，拒绝优先级为 %d 的任务", (void *)pool, pool->task_queue_size,
+              pool->queue_capacity, (int)priority);
+    stat_counter_inc_locked(&pool->tasks_rejected);
+}
+
+/**
+ * @brief 记录任务开始执行的时间，并将其排队等待时间计入直方图 (内部函数)。
+ *
+ * 不需要持有池的锁。未启用延迟统计时不执行任何操作。
+ *
+ * @param pool 指向 thread_pool_s 实例的指针。
+ * @param node 即将执行的任务节点。
+ */
+static inline void task_latency_start(thread_pool_t pool, task_node_t *node)
+{
+    if (pool->latency == NULL) {
+        return;
+    }
+    node->start_ns = latency_now_ns();
+    latency_hist_record(&pool->latency[task_priority_level(node->priority)].queue_wait,
+                        node->start_ns - node->enqueue_ns);
+}
+
+/**
+ * @brief 将任务的执行时间计入直方图 (内部函数)。
+ *
+ * 不需要持有池的锁。未启用延迟统计时不执行任何操作。
+ *
+ * @param pool 指向 thread_pool_s 实例的指针。
+ * @param node 刚执行完成的任务节点。
+ */
+static inline void task_latency_finish(thread_pool_t pool, task_node_t *node)
+{
+    if (pool->latency == NULL) {
+        return;
+    }
+    latency_hist_record(&pool->latency[task_priority_level(node->priority)].run_time,
+                        latency_now_ns() - node->start_ns);
+}
+
+/**
+ * @brief 返回共享运行队列或指定 NUMA 节点运行队列的分桶和位图 (内部函数)。
+ *
+ * @param pool 指向 thread_pool_s 实例的指针。
+ * @param queue_node 节点编号，-1 表示共享运行队列。节点队列必须已分配。
+ * @param bitmap 输出该队列的位图。
+ * @return 该队列的分桶数组。
+ */
+static inline task_bucket_t *task_queue_buckets(thread_pool_t pool, int queue_node, uint64_t **bitmap)
+{
+    if (queue_node < 0) {
+        *bitmap = &pool->run_queue_bitmap;
+        return pool->run_queue;
+    }
+    *bitmap = &pool->node_queues[queue_node].bitmap;
+    return pool->node_queues[queue_node].buckets;
+}
+
+/**
+ * @brief 记录任务进入运行队列的时间 (内部函数)。
+ *
+ * 延迟统计和优先级老化都使用这个时间戳，两者都未启用时不读取时钟。
+ *
+ * @param pool 指向 thread_pool_s 实例的指针。
+ * @param node 即将入队的任务节点。
+ */
+static inline void task_stamp_enqueue(thread_pool_t pool, task_node_t *node)
+{
+    if (pool->latency != NULL || pool->aging_ns != 0) {
+        node->enqueue_ns = latency_now_ns();
+    }
+}
+
+/**
+ * @brief 按优先级向队列中添加任务 (内部函数)。
+ *
+ * 此函数假定调用者 (例如, `thread_pool_add_task`)
+ * 持有池的锁，并已从池的节点 slab 中取得节点、填好任务数据。
+ * 它将节点追加到 node->queue_node 所指运行队列中对应优先级级别的 FIFO 尾部，
+ * 同时在位图中标记该级别非空。
+ * 入队操作与队列长度无关，为 O(1)。同一优先级的任务保持先进先出顺序。
+ * 带截止时间的节点 (只会进入共享运行队列) 改为加入截止时间堆，为 O(log n)，
+ * 调用者必须已通过 deadline_heap_reserve 预留空间。
+ *
+ * @param pool 指向 thread_pool_s 实例的指针。
+ * @param new_node 已填好任务数据的节点。
+ */
+static void task_enqueue_internal(thread_pool_t pool, task_node_t *new_node)
+{
+    new_node->next = NULL;
+    new_node->state = TASK_NODE_QUEUED;
+
+    if (new_node->deadline_ns != 0) {
+        new_node->prev = NULL;
+        deadline_heap_push(&pool->deadline_heap, new_node, task_priority_level(new_node->priority));
+    } else {
+        int level = task_priority_level(new_node->priority);
+        uint64_t *bitmap = NULL;
+        task_bucket_t *bucket = &task_queue_buckets(pool, new_node->queue_node, &bitmap)[level];
+        new_node->prev = bucket->tail;
+        if (bucket->tail == NULL) { // 该级别队列为空
+            bucket->head = new_node;
+            bucket->tail = new_node;
+            *bitmap |= (UINT64_C(1) << level);
+        } else {
+            bucket->tail->next = new_node;
+            bucket->tail = new_node;
+        }
+    }
+
+    pool_queue_size_add_locked(pool, 1);
+    atomic_fetch_add_explicit(&pool->submit_seq, 1, memory_order_relaxed); // 通知自旋中的工作线程
+    trace_event(TRACE_EVENT_ENQUEUE, pool, new_node->id, new_node->priority);
+    TPOOL_DEBUG("任务 '%s' (优先级:%d) 已按优先级入队。线程池: %p, 队列大小: %d", 
+              task_node_name(new_node), new_node->priority, (void *)pool, pool->task_queue_size);
+
+    // 检查是否需要调整线程数 (在锁内进行)
+    // 直接信号自动调整线程，避免多重嵌套锁定
+    if (pool->auto_adjust) {
+        // 如果队列大小增加，可能需要增加线程
+        if (pool->task_queue_size > pool->high_watermark && pool->thread_count < pool->max_threads) {
+            TPOOL_DEBUG("任务入队触发自动调整检查：任务队列大小 %d > 高水位 %d", 
+                     pool->task_queue_size, pool->high_watermark);
+            // 向自动调整线程发送信号，让它检查是否需要调整线程池大小
+            pthread_mutex_lock(&pool->adjust_cond_lock);
+            pthread_cond_signal(&pool->adjust_cond);
+            pthread_mutex_unlock(&pool->adjust_cond_lock);
+        }
+    }
+}
+
+/**
+ * @brief 返回任务老化后的有效级别：每等待 aging_ns 纳秒提升一个级别，最高提升到 0 (内部函数)。
+ *
+ * 调用者必须确保已启用老化 (aging_ns 非零)，此时入队时间总会被记录。
+ */
+static inline int task_aged_level(thread_pool_t pool, int level, uint64_t enqueue_ns, uint64_t now)
+{
+    uint64_t boost = (now - enqueue_ns) / pool->aging_ns;
+    return boost >= (uint64_t)level ? 0 : level - (int)boost;
+}
+
+/**
+ * @brief 选出按优先级调度的运行队列中下一个出队的级别 (内部函数)。
+ *
+ * 未启用老化时即为位图的最低置位 (数值越小优先级越高)。启用老化时，每个非空级别的队首
+ * (该级别中等待最久的任务) 每等待 aging_ns 纳秒提升一个级别，选出提升后级别最高者，
+ * 相同时取原级别较高者。最多检查 TASK_PRIORITY_LEVELS 个队首，与队列长度无关。
+ * 调用者必须持有池的锁。
+ *
+ * @param pool 指向 thread_pool_s 实例的指针。
+ * @param queue_node 运行队列，-1 表示共享运行队列，否则为 NUMA 节点编号。
+ * @param now 当前时间 (纳秒)，未启用老化时不使用。
+ * @param level 输出要出队的级别。
+ * @return 提升后的级别，用于在多个运行队列之间比较；队列为空时返回 TASK_PRIORITY_LEVELS。
+ */
+static int task_queue_pick_level(thread_pool_t pool, int queue_node, uint64_t now, int *level)
+{
+    uint64_t *bitmap = NULL;
+    const task_bucket_t *buckets = task_queue_buckets(pool, queue_node, &bitmap);
+    if (*bitmap == 0) {
+        *level = TASK_PRIORITY_LEVELS;
+        return TASK_PRIORITY_LEVELS;
+    }
+    int best = __builtin_ctzll(*bitmap);
+    int best_effective = best;
+    if (pool->aging_ns != 0) {
+        for (uint64_t pending = *bitmap; pending != 0 && best_effective > 0; pending &= pending - 1) {
+            int candidate = __builtin_ctzll(pending);
+            int effective = task_aged_level(pool, candidate, buckets[candidate].head->enqueue_ns, now);
+            if (effective < best_effective) {
+                best = candidate;
+                best_effective = effective;
+            }
+        }
+    }
+    *level = best;
+    return best_effective;
+}
+
+/**
+ * @brief 返回共享运行队列下一个出队任务的有效级别 (内部函数)。
+ *
+ * 最早截止时间优先只在同一优先级级别内生效：截止时间堆顶 (最高级别中截止时间最早的任务)
+ * 按同样的规则老化后，其级别不低于各级别队列老化后的最高级别时，*level 置为 -1 并返回堆顶
+ * 老化后的级别；否则与 task_queue_pick_level 相同。堆按原级别排序，因此只有堆顶参与老化，
+ * 低级别的截止时间任务要等更高级别的截止时间任务出队后才开始与队列竞争。
+ * 调用者必须持有池的锁。
+ */
+static int task_shared_pick_level(thread_pool_t pool, uint64_t now, int *level)
+{
+    int effective = task_queue_pick_level(pool, -1, now, level);
+    if (pool->deadline_heap.size > 0) {
+        const deadline_entry_t *top = &pool->deadline_heap.entries[0];
+        int top_effective = top->level;
+        if (pool->aging_ns != 0) {
+            top_effective = task_aged_level(pool, top->level, top->node->enqueue_ns, now);
+        }
+        if (top_effective <= effective) {
+            *level = -1;
+            return top_effective;
+        }
+    }
+    return effective;
+}
+
+/**
+ * @brief 出队时老化计算使用的当前时间，未启用老化时不读取时钟 (内部函数)。
+ */
+static inline uint64_t task_aging_now(thread_pool_t pool)
+{
+    return pool->aging_ns != 0 ? latency_now_ns() : 0;
+}
+
+/**
+ * @brief 从运行队列的指定级别中移除队首任务 (内部函数)。
+ *
+ * 此函数假定调用者 (通常是工作线程) 持有池的锁，
+ * 并且已通过 task_queue_pick_level 或 task_shared_pick_level 选出非空的级别。
+ * 级别为 -1 时从截止时间堆中取出截止时间最早的任务。
+ * 返回的节点直接交给工作线程执行，不再复制任务数据；
+ * 调用者负责在执行后将节点归还给 slab 或其本地缓存。
+ *
+ * @param pool 指向 thread_pool_s 实例的指针。
+ * @param queue_node 要出队的运行队列，-1 表示共享运行队列，否则为 NUMA 节点编号。
+ * @param level 要出队的级别。
+ * @return 出队的任务节点，如果该级别为空则返回 NULL。
+ */
+static task_node_t *task_dequeue_level_internal(thread_pool_t pool, int queue_node, int level)
+{
+    task_node_t *node_to_dequeue = NULL;
+    if (level < 0) {
+        node_to_dequeue = deadline_heap_pop(&pool->deadline_heap);
+    } else if (level < TASK_PRIORITY_LEVELS) {
+        uint64_t *bitmap = NULL;
+        task_bucket_t *bucket = &task_queue_buckets(pool, queue_node, &bitmap)[level];
+        node_to_dequeue = bucket->head;
+        if (node_to_dequeue != NULL) {
+            bucket->head = node_to_dequeue->next;
+            if (bucket->head == NULL) {
+                bucket->tail = NULL; // 该级别队列变为空
+                *bitmap &= ~(UINT64_C(1) << level);
+            } else {
+                bucket->head->prev = NULL;
+            }
+        }
+    }
+    if (node_to_dequeue == NULL) { // 防御性检查，尽管调用者应确保队列不为空。
+        return NULL;
+    }
+
+    pool_queue_size_add_locked(pool, -1);
+    node_to_dequeue->next = NULL;
+    node_to_dequeue->state = TASK_NODE_RUNNING; // 节点仍登记在任务索引中，直到执行完成
+    TPOOL_DEBUG("任务 '%s' 已从线程池 %p 内部出队。队列大小: %d", task_node_name(node_to_dequeue),
+              (void *)pool, pool->task_queue_size);
+
+    return node_to_dequeue;
+}
+
+/**
+ * @brief 将排队中的任务节点从所在优先级级别中摘除 (内部函数)。
+ *
+ * 利用节点的前后指针直接摘除，为 O(1)；该级别变空时清除位图中的对应位。
+ * 带截止时间的节点从截止时间堆中删除，为 O(log n)。
+ * 假定调用者持有池的锁，且节点处于 TASK_NODE_QUEUED 状态。
+ * 调用者负责将节点移出任务索引并归还给 slab。
+ *
+ * @param pool 指向 thread_pool_s 实例的指针。
+ * @param node 要摘除的节点。
+ */
+static void task_queue_unlink_internal(thread_pool_t pool, task_node_t *node)
+{
+    if (node->deadline_ns != 0) {
+        deadline_heap_remove(&pool->deadline_heap, node);
+        pool_queue_size_add_locked(pool, -1);
+        return;
+    }
+    int level = task_priority_level(node->priority);
+    uint64_t *bitmap = NULL;
+    task_bucket_t *bucket = &task_queue_buckets(pool, node->queue_node, &bitmap)[level];
+
+    if (node->prev == NULL) {
+        bucket->head = node->next;
+    } else {
+        node->prev->next = node->next;
+    }
+    if (node->next == NULL) {
+        bucket->tail = node->prev;
+    } else {
+        node->next->prev = node->prev;
+    }
+    if (bucket->head == NULL) {
+        *bitmap &= ~(UINT64_C(1) << level);
+    }
+    pool_queue_size_add_locked(pool, -1);
+    node->next = NULL;
+    node->prev = NULL;
+}
+
+/**
+ * @brief 将指定 NUMA 节点运行队列中的全部任务按原顺序移到共享运行队列 (内部函数)。
+ *
+ * 用于该节点上最后一个工作线程退出时，避免任务滞留。队列长度不变。
+ * 调用者必须持有池的锁。
+ *
+ * @param pool 指向 thread_pool_s 实例的指针。
+ * @param queue_node 节点编号。
+ * @return 移动的任务数量。
+ */
+static int task_queue_splice_node_locked(thread_pool_t pool, int queue_node)
+{
+    node_run_queue_t *queue = &pool->node_queues[queue_node];
+    int moved = 0;
+    while (queue->bitmap != 0) {
+        int level = __builtin_ctzll(queue->bitmap);
+        task_bucket_t *from = &queue->buckets[level];
+        task_bucket_t *to = &pool->run_queue[level];
+        for (task_node_t *current = from->head; current != NULL; current = current->next) {
+            current->queue_node = -1;
+            moved++;
+        }
+        if (to->tail == NULL) {
+            to->head = from->head;
+        } else {
+            to->tail->next = from->head;
+            from->head->prev = to->tail;
+        }
+        to->tail = from->tail;
+        pool->run_queue_bitmap |= (UINT64_C(1) << level);
+        from->head = NULL;
+        from->tail = NULL;
+        queue->bitmap &= ~(UINT64_C(1) << level);
+    }
+    return moved;
+}
+
+/**
+ * @brief 丢弃一个运行队列中所有剩余的任务节点 (内部函数)。
+ *
+ * @return 丢弃的节点数量。
+ */
+static int task_buckets_discard(thread_pool_t pool, task_bucket_t *buckets, uint64_t *bitmap)
+{
+    int count = 0;
+    for (int level = 0; level < TASK_PRIORITY_LEVELS; level++) {
+        task_node_t *current = buckets[level].head;
+        task_node_t *next_node = NULL;
+        while (current != NULL) {
+            next_node = current->next;
+            // 队列中剩余的任务只是被丢弃；其 'arg' 可能由外部或任务函数管理，在此不被处理。
+            task_node_finish_future(current, TASK_FUTURE_CANCELLED);
+            task_slab_free(&pool->task_slab, current);
+            current = next_node;
+            count++;
+        }
+        buckets[level].head = NULL;
+        buckets[level].tail = NULL;
+    }
+    *bitmap = 0;
+    return count;
+}
+
+/**
+ * @brief 丢弃队列中所有剩余的任务节点 (内部函数)。
+ *
+ * 此函数通常在线程池销毁期间，在所有线程都已连接后调用。
+ * 它遍历共享运行队列和各 NUMA 节点运行队列的所有优先级级别以及截止时间堆，将剩余节点归还给 slab 并清空队列；
+ * 节点内存本身随后由 `task_slab_destroy` 统一释放。
+ * 假定持有池锁或没有其他线程正在访问队列。
+ *
+ * @param pool 指向 thread_pool_s 实例的指针。
+ */
+static void task_queue_destroy_internal(thread_pool_t pool)
+{
+    int count = task_buckets_discard(pool, pool->run_queue, &pool->run_queue_bitmap);
+    if (pool->node_queues != NULL) {
+        for (int node = 0; node < pool->placement.max_node; node++) {
+            count += task_buckets_discard(pool, pool->node_queues[node].buckets, &pool->node_queues[node].bitmap);
+        }
+    }
+    task_node_t *node = NULL;
+    while ((node = deadline_heap_pop(&pool->deadline_heap)) != NULL) {
+        task_node_finish_future(node, TASK_FUTURE_CANCELLED);
+        task_slab_free(&pool->task_slab, node);
+        count++;
+    }
+    pool_queue_size_add_locked(pool, -pool->task_queue_size);
+    TPOOL_DEBUG("线程池 %p 的内部任务队列已销毁。%d 个节点已丢弃。", (void *)pool, count);
+}
+
+// --- 工作线程状态与休眠唤醒 (内部) ---
+
+/**
+ * @brief 自旋等待时降低 CPU 占用的提示指令 (内部函数)。
+ */
+static inline void cpu_relax(void)
+{
+#if defined(__x86_64__) || defined(__i386__)
+    __builtin_ia32_pause();
+#elif defined(__aarch64__)
+    __asm__ __volatile__("yield");
+#endif
+}
+
+/**
+ * @brief 确保能容纳指定数量的工作线程状态和空闲栈条目 (内部函数)。
+ *
+ * 新线程ID的状态单独按缓存行对齐分配，已有的状态保持原地址。
+ * 容量变化时发布新的状态表，旧表保留到销毁线程池，供无锁读取者继续使用。
+ * 调用者必须持有池的锁，或者在工作线程创建之前调用。
+ *
+ * @param pool 指向 thread_pool_s 实例的指针。
+ * @param count 需要容纳的线程ID数量。
+ * @return 成功返回 0，内存分配失败返回 -1 (已有的状态不受影响)。
+ */
+static int worker_states_reserve(thread_pool_t pool, int count)
+{
+    if (count <= pool->worker_capacity) {
+        return 0;
+    }
+    int *idle_stack = (int *)realloc(pool->idle_stack, (size_t)count * sizeof(int));
+    if (idle_stack == NULL) {
+        TPOOL_ERROR("线程池 %p: 未能为 %d 个工作线程的空闲栈分配内存。", (void *)pool, count);
+        return -1;
+    }
+    pool->idle_stack = idle_stack;
+    worker_table_t *table =
+        (worker_table_t *)malloc(sizeof(worker_table_t) + (size_t)count * sizeof(worker_state_t *));
+    if (table == NULL) {
+        TPOOL_ERROR("线程池 %p: 未能为 %d 个工作线程状态指针分配内存。", (void *)pool, count);
+        return -1;
+    }
+    table->retired = atomic_load_explicit(&pool->worker_table, memory_order_relaxed);
+    if (pool->worker_capacity > 0) {
+        memcpy(table->slots, pool->workers, (size_t)pool->worker_capacity * sizeof(worker_state_t *));
+    }
+
+    int created = pool->worker_capacity;
+    for (int i = pool->worker_capacity; i < count; i++) {
+        // sizeof(worker_state_t) 是对齐值的整数倍，满足 aligned_alloc 的要求
+        worker_state_t *worker =
+            (worker_state_t *)aligned_alloc(THREAD_POOL_CACHE_LINE_SIZE, sizeof(worker_state_t));
+        if (worker == NULL) {
+            TPOOL_ERROR("线程池 %p: 未能为工作线程 #%d 分配状态。", (void *)pool, i);
+            break;
+        }
+        memset(worker, 0, sizeof(*worker));
+        if (pthread_cond_init(&worker->park_cond, NULL) != 0) {
+            TPOOL_ERROR("线程池 %p: 未能为工作线程 #%d 初始化条件变量。", (void *)pool, i);
+            free(worker);
+            break;
+        }
+        worker->pool = pool;
+        worker->thread_id = i;
+        worker->numa_node = worker_placement_node(&pool->placement, i);
+        snprintf(worker->running_task_name, MAX_TASK_NAME_LEN, "[idle]");
+        atomic_init(&worker->tasks_completed, 0);
+        atomic_init(&worker->info_seq, 0);
+        atomic_init(&worker->info_status, 0);
+        table->slots[i] = worker;
+        created = i + 1;
+    }
+    if (created == pool->worker_capacity) {
+        free(table);
+        return -1;
+    }
+    table->capacity = created;
+    pool->workers = table->slots;
+    pool->worker_capacity = created;
+    atomic_store_explicit(&pool->worker_table, table, memory_order_release);
+    return created == count ? 0 : -1;
+}
+
+/**
+ * @brief 释放所有工作线程状态、状态表和空闲栈 (内部函数)。
+ *
+ * 仅在所有工作线程都已连接 (或从未创建) 后调用。
+ *
+ * @param pool 指向 thread_pool_s 实例的指针。
+ */
+static void worker_states_destroy(thread_pool_t pool)
+{
+    for (int i = 0; i < pool->worker_capacity; i++) {
+        pthread_cond_destroy(&pool->workers[i]->park_cond);
+        free(pool->workers[i]);
+    }
+    worker_table_t *table = atomic_load_explicit(&pool->worker_table, memory_order_relaxed);
+    while (table != NULL) {
+        worker_table_t *retired = table->retired;
+        free(table);
+        table = retired;
+    }
+    atomic_store_explicit(&pool->worker_table, NULL, memory_order_relaxed);
+    free(pool->idle_stack);
+    pool->workers = NULL;
+    pool->idle_stack = NULL;
+    pool->idle_stack_size = 0;
+    pool->worker_capacity = 0;
+}
+
+/**
+ * @brief 将工作线程的状态、任务ID和任务名称发布给快照接口 (内部函数)。
+ *
+ * 在 info_seq 序列锁下以 relaxed 原子操作写入发布副本；
+ * 写者由池锁串行化，因此序列号本身也无需原子读-改-写。
+ * 调用者必须持有池的锁，并已更新 status、running_task_id 和 running_task_name。
+ *
+ * @param worker 工作线程状态。
+ */
+static void worker_publish_locked(worker_state_t *worker)
+{
+    unsigned int seq = atomic_load_explicit(&worker->info_seq, memory_order_relaxed);
+    atomic_store_explicit(&worker->info_seq, seq + 1, memory_order_relaxed);
+    atomic_thread_fence(memory_order_release);
+
+    atomic_store_explicit(&worker->info_status, worker->status, memory_order_relaxed);
+    atomic_store_explicit(&worker->info_task_id[0], (unsigned int)(worker->running_task_id & 0xFFFFFFFFu),
+                          memory_order_relaxed);
+    atomic_store_explicit(&worker->info_task_id[1], (unsigned int)(worker->running_task_id >> 32),
+                          memory_order_relaxed);
+    for (size_t i = 0; i < MAX_TASK_NAME_LEN / sizeof(unsigned int); i++) {
+        unsigned int word;
+        memcpy(&word, &worker->running_task_name[i * sizeof(unsigned int)], sizeof(word));
+        atomic_store_explicit(&worker->info_task_name[i], word, memory_order_relaxed);
+    }
+
+    atomic_store_explicit(&worker->info_seq, seq + 2, memory_order_release);
+}
+
+/**
+ * @brief 无锁读取工作线程的发布副本 (内部函数)。
+ *
+ * 序列号为奇数或读取前后不一致时重试，因此得到的状态、任务ID和名称彼此一致。
+ *
+ * @param worker 工作线程状态。
+ * @param info 输出参数。
+ */
+static void worker_read_info(worker_state_t *worker, thread_pool_worker_info_t *info)
+{
+    unsigned int name_words[MAX_TASK_NAME_LEN / sizeof(unsigned int)];
+    unsigned int seq;
+    int status = 0;
+    unsigned int id_lo = 0;
+    unsigned int id_hi = 0;
+    do {
+        seq = atomic_load_explicit(&worker->info_seq, memory_order_acquire);
+        if (seq & 1u) {
+            cpu_relax();
+            continue;
+        }
+        status = atomic_load_explicit(&worker->info_status, memory_order_relaxed);
+        id_lo = atomic_load_explicit(&worker->info_task_id[0], memory_order_relaxed);
+        id_hi = atomic_load_explicit(&worker->info_task_id[1], memory_order_relaxed);
+        for (size_t i = 0; i < MAX_TASK_NAME_LEN / sizeof(unsigned int); i++) {
+            name_words[i] = atomic_load_explicit(&worker->info_task_name[i], memory_order_relaxed);
+        }
+        atomic_thread_fence(memory_order_acquire);
+    } while ((seq & 1u) || atomic_load_explicit(&worker->info_seq, memory_order_relaxed) != seq);
+
+    info->thread_id = worker->thread_id;
+    info->tasks_completed = atomic_load_explicit(&worker->tasks_completed, memory_order_relaxed);
+    // 刚创建、尚未取到任务的线程状态为忙碌但没有任务，按空闲报告
+    if (status > 0 && (id_lo | id_hi) != 0) {
+        info->status = THREAD_POOL_WORKER_BUSY;
+        info->task_id = ((task_id_t)id_hi << 32) | id_lo;
+        memcpy(info->task_name, name_words, MAX_TASK_NAME_LEN);
+        info->task_name[MAX_TASK_NAME_LEN - 1] = '\0';
+    } else {
+        info->status = status >= 0 ? THREAD_POOL_WORKER_IDLE : THREAD_POOL_WORKER_EXITING;
+        info->task_id = 0;
+        info->task_name[0] = '\0';
+    }
+}
+
+/**
+ * @brief 连接所有仍可连接的工作线程 (内部函数)。
+ *
+ * 包括因缩小而退出、但其槽位尚未被复用的线程。调用者不得持有池的锁，
+ * 且必须保证不会再创建新线程 (线程池已标记为关闭)。
+ *
+ * @param pool 指向 thread_pool_s 实例的指针。
+ */
+static void worker_threads_join_all(thread_pool_t pool)
+{
+    for (int i = 0; i < pool->worker_capacity; i++) {
+        worker_state_t *worker = pool->workers[i];
+        if (!worker->joinable) {
+            continue;
+        }
+        TPOOL_DEBUG("线程池 %p: 正在连接工作线程 #%d (ID: %lu)。", (void *)pool, i,
+                  (unsigned long)worker->thread);
+        int join_result = pthread_join(worker->thread, NULL);
+        if (join_result != 0) {
+            TPOOL_ERROR("线程池 %p: 连接工作线程 #%d 失败: %s", (void *)pool, i, strerror(join_result));
+        }
+        worker->joinable = 0;
+    }
+}
+
+/**
+ * @brief 向指定的工作线程发放唤醒许可 (内部函数)。
+ *
+ * 调用者必须持有池的锁，并已将该线程从空闲栈中移除。
+ */
+static inline void worker_unpark_locked(worker_state_t *worker)
+{
+    worker->parked = 0;
+    worker->permit = 1;
+    pthread_cond_signal(&worker->park_cond);
+}
+
+/**
+ * @brief 从空闲栈顶唤醒最多指定数量的休眠线程 (内部函数)。
+ *
+ * 后进先出：最近休眠的线程缓存最热，最先被唤醒。
+ * 没有休眠线程时不执行任何操作，正在忙碌的线程会在下一个任务边界发现新任务。
+ * 调用者必须持有池的锁。
+ *
+ * @param pool 指向 thread_pool_s 实例的指针。
+ * @param count 最多唤醒的线程数量。
+ * @return 实际唤醒的线程数量。
+ */
+static int pool_wake_idle_locked(thread_pool_t pool, int count)
+{
+    int woken = 0;
+    while (woken < count && pool->idle_stack_size > 0) {
+        int thread_id = pool->idle_stack[--pool->idle_stack_size];
+        worker_unpark_locked(pool->workers[thread_id]);
+        woken++;
+    }
+    return woken;
+}
+
+/**
+ * @brief 唤醒所有休眠的工作线程 (内部函数)。用于关闭线程池。
+ *
+ * 调用者必须持有池的锁。
+ */
+static void pool_wake_all_locked(thread_pool_t pool)
+{
+    pool_wake_idle_locked(pool, pool->idle_stack_size);
+}
+
+/**
+ * @brief 唤醒指定ID的工作线程 (如果它正在休眠) (内部函数)。
+ *
+ * 用于调整大小时只通知需要退出的线程。调用者必须持有池的锁。
+ *
+ * @param pool 指向 thread_pool_s 实例的指针。
+ * @param thread_id 要唤醒的线程ID。
+ */
+static void pool_wake_worker_locked(thread_pool_t pool, int thread_id)
+{
+    if (thread_id < 0 || thread_id >= pool->worker_capacity || !pool->workers[thread_id]->parked) {
+        return;
+    }
+    for (int i = 0; i < pool->idle_stack_size; i++) {
+        if (pool->idle_stack[i] == thread_id) {
+            memmove(&pool->idle_stack[i], &pool->idle_stack[i + 1],
+                    (size_t)(pool->idle_stack_size - i - 1) * sizeof(int));
+            pool->idle_stack_size--;
+            break;
+        }
+    }
+    worker_unpark_locked(pool->workers[thread_id]);
+}
+
+/**
+ * @brief 没有可执行任务时让工作线程等待，直到被定向唤醒 (内部函数)。
+ *
+ * 如果配置了 idle_spin_us，先释放锁并在 submit_seq 上自旋一段时间，
+ * 期间有新任务入队则立即返回；否则将自己压入空闲栈并在自己的条件变量上等待，
+ * 不设超时，只有提交任务、调整大小或关闭线程池时才会被唤醒。
+ * 调用者必须持有池的锁，返回时仍持有锁，并应重新检查等待条件。
+ *
+ * @param pool 指向 thread_pool_s 实例的指针。
+ * @param worker 当前工作线程的状态。
+ */
+static void worker_idle_wait_locked(thread_pool_t pool, worker_state_t *worker)
+{
+    if (pool->idle_spin_us > 0) {
+        unsigned int seq = atomic_load_explicit(&pool->submit_seq, memory_order_relaxed);
+        struct timespec start;
+        struct timespec now;
+        clock_gettime(CLOCK_MONOTONIC, &start);
+        pthread_mutex_unlock(&(pool->lock));
+        int changed = 0;
+        do {
+            for (int i = 0; i < 64; i++) {
+                if (atomic_load_explicit(&pool->submit_seq, memory_order_relaxed) != seq) {
+                    changed = 1;
+                    break;
+                }
+                cpu_relax();
+            }
+            clock_gettime(CLOCK_MONOTONIC, &now);
+        } while (!changed && (now.tv_sec - start.tv_sec) * 1000000L + (now.tv_nsec - start.tv_nsec) / 1000L <
+                                 pool->idle_spin_us);
+        pthread_mutex_lock(&(pool->lock));
+        if (changed || atomic_load_explicit(&pool->submit_seq, memory_order_relaxed) != seq) {
+            return;
+        }
+    }
+
+    worker->parked = 1;
+    pool->idle_stack[pool->idle_stack_size++] = worker->thread_id;
+    trace_event(TRACE_EVENT_SLEEP, pool, (uint64_t)worker->thread_id, 0);
+    while (!worker->permit) {
+        pthread_cond_wait(&worker->park_cond, &(pool->lock));
+    }
+    worker->permit = 0;
+    trace_event(TRACE_EVENT_WAKE, pool, (uint64_t)worker->thread_id, 0);
+}
+
+// --- NUMA 节点运行队列 (内部) ---
+
+/**
+ * @brief 唤醒一个归属指定 NUMA 节点的休眠线程 (内部函数)。
+ *
+ * 从栈顶向下查找，仍优先唤醒最近休眠的线程。调用者必须持有池的锁。
+ *
+ * @param pool 指向 thread_pool_s 实例的指针。
+ * @param queue_node 节点编号。
+ * @return 唤醒了线程返回 1，该节点没有休眠线程返回 0。
+ */
+static int pool_wake_node_locked(thread_pool_t pool, int queue_node)
+{
+    for (int i = pool->idle_stack_size - 1; i >= 0; i--) {
+        int thread_id = pool->idle_stack[i];
+        if (pool->workers[thread_id]->numa_node == queue_node) {
+            pool_wake_worker_locked(pool, thread_id);
+            return 1;
+        }
+    }
+    return 0;
+}
+
+/**
+ * @brief 工作线程是否有可取的任务：共享运行队列或其节点运行队列非空 (内部函数)。
+ *
+ * 调用者必须持有池的锁。
+ */
+static inline int worker_has_work_locked(thread_pool_t pool, const worker_state_t *worker)
+{
+    if (pool->node_queues == NULL) {
+        return pool->task_queue_size > 0;
+    }
+    return pool->run_queue_bitmap != 0 || pool->deadline_heap.size > 0 ||
+           (worker->numa_node >= 0 && pool->node_queues[worker->numa_node].bitmap != 0);
+}
+
+/**
+ * @brief 为工作线程取出下一个任务 (内部函数)。
+ *
+ * 比较共享运行队列和该线程节点运行队列的最高 (老化后) 优先级，优先级相同时先取节点队列；
+ * 但同一级别中带截止时间的任务先于节点队列出队。调用者必须持有池的锁。
+ *
+ * @param pool 指向 thread_pool_s 实例的指针 (共享队列模式)。
+ * @param worker 当前工作线程的状态。
+ * @return 出队的任务节点，两个队列都为空时返回 NULL。
+ */
+static task_node_t *task_dequeue_for_worker_locked(thread_pool_t pool, const worker_state_t *worker)
+{
+    uint64_t now = task_aging_now(pool);
+    int shared_level;
+    int shared_effective = task_shared_pick_level(pool, now, &shared_level);
+    if (pool->node_queues != NULL && worker->numa_node >= 0) {
+        int node_level;
+        int node_effective = task_queue_pick_level(pool, worker->numa_node, now, &node_level);
+        if (node_level < TASK_PRIORITY_LEVELS &&
+            (node_effective < shared_effective || (node_effective == shared_effective && shared_level >= 0))) {
+            return task_dequeue_level_internal(pool, worker->numa_node, node_level);
+        }
+    }
+    return task_dequeue_level_internal(pool, -1, shared_level);
+}
+
+/**
+ * @brief 登记新创建的工作线程到其节点 (内部函数)。
+ *
+ * 在线程创建成功后由创建者调用，使按节点提交的任务立即可以进入该节点的队列。
+ * 调用者必须持有池的锁。
+ */
+static inline void worker_node_attach_locked(thread_pool_t pool, const worker_state_t *worker)
+{
+    if (pool->node_queues != NULL && worker->numa_node >= 0) {
+        pool->node_worker_count[worker->numa_node]++;
+    }
+}
+
+/**
+ * @brief 工作线程退出时从其节点注销 (内部函数)。
  *
- * 此函数假定调用者 (例如, `thread_pool_add_task`)
- * 持有池的锁。它分配一个新的任务节点并将其按优先级插入到队列中。
- * 优先级值越小，优先级越高，将被插入到队列的更前面位置。
+ * 节点上已没有其他线程时，把该节点队列中剩余的任务转回共享运行队列并唤醒休眠线程；
+ * 否则如果节点队列仍有任务，唤醒该节点的一个休眠线程接手。调用者必须持有池的锁。
+ */
+static void worker_node_detach_locked(thread_pool_t pool, const worker_state_t *worker)
+{
+    if (pool->node_queues == NULL || worker->numa_node < 0) {
+        return;
+    }
+    int queue_node = worker->numa_node;
+    if (--pool->node_worker_count[queue_node] == 0) {
+        int moved = task_queue_splice_node_locked(pool, queue_node);
+        if (moved > 0) {
+            TPOOL_DEBUG("线程池 %p: 节点 %d 上已没有工作线程，%d 个任务转回共享队列。", (void *)pool, queue_node,
+                      moved);
+            pool_wake_idle_locked(pool, moved);
+        }
+    } else if (pool->node_queues[queue_node].bitmap != 0) {
+        pool_wake_node_locked(pool, queue_node);
+    }
+}
+
+// --- 工作窃取调度 (内部) ---
+
+/**
+ * @brief 获取指定工作线程ID的本地队列槽位，不存在时创建 (内部函数)。
  *
- * @param pool 指向 thread_pool_s 实例的指针。
- * @param task 要入队的 task_t 数据。
- * @return 成功时返回 0，新任务节点内存分配错误时返回 -1。
+ * 槽位按线程ID复用：调整大小后新建的同ID线程继续使用原槽位。
+ * 槽位指针以 release 语义发布，窃取者以 acquire 语义读取。
+ * 调用者必须持有池的锁。
+ *
+ * @param pool 指向 thread_pool_s 实例的指针 (工作窃取模式)。
+ * @param thread_id 工作线程ID。
+ * @return 槽位，线程ID超出 WS_MAX_WORKERS 或内存分配失败时返回 NULL。
+ */
+static ws_worker_t *ws_worker_slot_locked(thread_pool_t pool, int thread_id)
+{
+    if (thread_id < 0 || thread_id >= WS_MAX_WORKERS) {
+        return NULL;
+    }
+    ws_worker_t *worker = atomic_load_explicit(&pool->ws_workers[thread_id], memory_order_relaxed);
+    if (worker != NULL) {
+        return worker;
+    }
+
+    worker = (ws_worker_t *)malloc(sizeof(ws_worker_t));
+    if (worker == NULL) {
+        TPOOL_ERROR("线程池 %p: 未能为工作线程 #%d 分配本地队列槽位。", (void *)pool, thread_id);
+        return NULL;
+    }
+    for (int level = 0; level < TASK_PRIORITY_LEVELS; level++) {
+        atomic_init(&worker->deques[level], NULL);
+    }
+    worker->local_bitmap = 0;
+    atomic_store_explicit(&pool->ws_workers[thread_id], worker, memory_order_release);
+    if (thread_id >= atomic_load_explicit(&pool->ws_worker_slots, memory_order_relaxed)) {
+        atomic_store_explicit(&pool->ws_worker_slots, thread_id + 1, memory_order_release);
+    }
+    return worker;
+}
+
+/**
+ * @brief 将工作线程内提交的任务压入该线程的本地队列 (内部函数)。
+ *
+ * 对应优先级级别的双端队列在首次使用时创建。成功时节点进入
+ * TASK_NODE_QUEUED_LOCAL 状态并计入 task_queue_size。
+ * 调用者必须持有池的锁。
+ *
+ * @param pool 指向 thread_pool_s 实例的指针 (工作窃取模式)。
+ * @param thread_id 提交任务的工作线程ID。
+ * @param node 已填好任务数据的节点。
+ * @return 成功返回 0；槽位或队列无法创建、队列已满时返回 -1，调用者应改用共享队列。
  */
-static int task_enqueue_internal(thread_pool_t pool, task_t task)
+static int ws_push_local_locked(thread_pool_t pool, int thread_id, task_node_t *node)
 {
-    task_node_t *new_node = (task_node_t *)malloc(sizeof(task_node_t));
-    if (new_node == NULL) {
-        TPOOL_ERROR("task_enqueue_internal: 未能为新任务节点分配内存");
+    ws_worker_t *worker = ws_worker_slot_locked(pool, thread_id);
+    if (worker == NULL) {
         return -1;
     }
-    new_node->task = task; // 复制任务数据
-    new_node->next = NULL;
+    int level = task_priority_level(node->priority);
+    ws_deque_t *deque = atomic_load_explicit(&worker->deques[level], memory_order_relaxed);
+    if (deque == NULL) {
+        deque = ws_deque_create(pool->ws_deque_capacity);
+        if (deque == NULL) {
+            return -1;
+        }
+        atomic_store_explicit(&worker->deques[level], deque, memory_order_release);
+    }
 
-    if (pool->head == NULL) { // 队列为空
-        pool->head = new_node;
-        pool->tail = new_node;
-    } else {
-        // 按优先级插入任务
-        // 优先级值越小，优先级越高，将被插入到队列的更前面位置
-        if (task.priority < pool->head->task.priority) {
-            // 如果新任务优先级高于队列头部任务，插入到队列头部
-            new_node->next = pool->head;
-            pool->head = new_node;
-        } else {
-            // 否则，找到合适的位置插入
-            task_node_t *current = pool->head;
-            task_node_t *previous = NULL;
-            
-            // 遍历队列，找到第一个优先级低于新任务的节点
-            while (current != NULL && current->task.priority <= task.priority) {
-                previous = current;
-                current = current->next;
+    node->next = NULL;
+    node->prev = NULL;
+    node->state = TASK_NODE_QUEUED_LOCAL;
+    if (ws_deque_push(deque, node) != 0) {
+        TPOOL_DEBUG("线程池 %p: 工作线程 #%d 的本地队列 (级别 %d) 已满，任务 '%s' 回退到共享队列。",
+                    (void *)pool, thread_id, level, task_node_name(node));
+        return -1;
+    }
+    worker->local_bitmap |= (UINT64_C(1) << level);
+    pool_queue_size_add_locked(pool, 1);
+    atomic_fetch_add_explicit(&pool->submit_seq, 1, memory_order_relaxed);
+    trace_event(TRACE_EVENT_ENQUEUE, pool, node->id, node->priority);
+    TPOOL_DEBUG("任务 '%s' (优先级:%d) 已压入工作线程 #%d 的本地队列。线程池: %p, 队列大小: %d",
+                task_node_name(node), node->priority, thread_id, (void *)pool,
+                pool->task_queue_size);
+    return 0;
+}
+
+/**
+ * @brief 为工作线程选取下一个要执行的任务 (内部函数)。
+ *
+ * 比较共享队列 (老化后) 与本地队列中最高的非空优先级，优先级更高者先出；
+ * 同级时优先取本地队列 (LIFO，利于缓存局部性)，但共享队列中同级带截止时间的任务先于本地队列出队；
+ * 本地队列中的任务不参与老化。本地队列中已被取消的节点
+ * 在此处直接回收。调用者必须持有池的锁。
+ *
+ * @param pool 指向 thread_pool_s 实例的指针 (工作窃取模式)。
+ * @param worker 当前工作线程的槽位，可以为 NULL (视为本地队列为空)。
+ * @return 已标记为 TASK_NODE_RUNNING 的节点，没有可执行任务时返回 NULL。
+ */
+static task_node_t *ws_take_task_locked(thread_pool_t pool, ws_worker_t *worker)
+{
+    uint64_t now = task_aging_now(pool);
+    while (1) {
+        int shared_level;
+        int shared_effective = task_shared_pick_level(pool, now, &shared_level);
+        int local_level = (worker != NULL && worker->local_bitmap != 0)
+                              ? __builtin_ctzll(worker->local_bitmap)
+                              : TASK_PRIORITY_LEVELS;
+        if (shared_effective < local_level || (shared_level < 0 && shared_effective == local_level)) {
+            return task_dequeue_level_internal(pool, -1, shared_level);
+        }
+        if (local_level == TASK_PRIORITY_LEVELS) {
+            return NULL;
+        }
+
+        ws_deque_t *deque = atomic_load_explicit(&worker->deques[local_level], memory_order_relaxed);
+        task_node_t *node = ws_deque_pop(deque);
+        if (node == NULL) {
+            // 该级别已被窃取一空
+            worker->local_bitmap &= ~(UINT64_C(1) << local_level);
+            continue;
+        }
+        if (node->state == TASK_NODE_CANCELLED) {
+            task_slab_free(&pool->task_slab, node);
+            continue;
+        }
+        node->state = TASK_NODE_RUNNING;
+        pool_queue_size_add_locked(pool, -1);
+        return node;
+    }
+}
+
+/**
+ * @brief 无锁地从其他工作线程的本地队列中窃取一个任务 (内部函数)。
+ *
+ * 从下一个线程ID开始轮询所有槽位，每个受害者按优先级从高到低尝试。
+ * 窃取到的节点尚未被认领，调用者必须在持有池锁时调用
+ * `ws_claim_stolen_locked` 完成认领。调用者不得持有池的锁。
+ *
+ * @param pool 指向 thread_pool_s 实例的指针 (工作窃取模式)。
+ * @param thread_id 窃取者的线程ID，其自身槽位会被跳过。
+ * @return 窃取到的节点，没有可窃取的任务时返回 NULL。
+ */
+static task_node_t *ws_steal_task(thread_pool_t pool, int thread_id)
+{
+    int slots = atomic_load_explicit(&pool->ws_worker_slots, memory_order_acquire);
+    for (int i = 1; i <= slots; i++) {
+        int victim_id = (thread_id + i) % slots;
+        if (victim_id == thread_id) {
+            continue;
+        }
+        ws_worker_t *victim = atomic_load_explicit(&pool->ws_workers[victim_id], memory_order_acquire);
+        if (victim == NULL) {
+            continue;
+        }
+        for (int level = 0; level < TASK_PRIORITY_LEVELS; level++) {
+            ws_deque_t *deque = atomic_load_explicit(&victim->deques[level], memory_order_acquire);
+            if (deque == NULL || ws_deque_size(deque) == 0) {
+                continue;
             }
-            
-            // 插入新节点
-            if (previous == NULL) { // 理论上不会发生，因为已经处理了头部插入的情况
-                new_node->next = pool->head;
-                pool->head = new_node;
-            } else {
-                new_node->next = previous->next;
-                previous->next = new_node;
-                
-                // 如果插入到了队列尾部，更新tail指针
-                if (previous == pool->tail) {
-                    pool->tail = new_node;
-                }
+            task_node_t *node = ws_deque_steal(deque);
+            if (node != NULL) {
+                return node;
             }
         }
     }
-    
-    pool->task_queue_size++;
-    TPOOL_DEBUG("任务 '%s' (优先级:%d) 已按优先级入队。线程池: %p, 队列大小: %d", 
-              task.task_name, task.priority, (void *)pool, pool->task_queue_size);
+    return NULL;
+}
 
-    // 检查是否需要调整线程数 (在锁内进行)
-    // 直接信号自动调整线程，避免多重嵌套锁定
-    if (pool->auto_adjust) {
-        // 如果队列大小增加，可能需要增加线程
-        if (pool->task_queue_size > pool->high_watermark && pool->thread_count < pool->max_threads) {
-            TPOOL_DEBUG("任务入队触发自动调整检查：任务队列大小 %d > 高水位 %d", 
-                     pool->task_queue_size, pool->high_watermark);
-            // 向自动调整线程发送信号，让它检查是否需要调整线程池大小
-            pthread_mutex_lock(&pool->adjust_cond_lock);
-            pthread_cond_signal(&pool->adjust_cond);
-            pthread_mutex_unlock(&pool->adjust_cond_lock);
-        }
+/**
+ * @brief 认领一个窃取到的节点 (内部函数)。
+ *
+ * 节点在窃取期间可能已被取消，此时直接回收。调用者必须持有池的锁。
+ *
+ * @param pool 指向 thread_pool_s 实例的指针。
+ * @param node 窃取到的节点。
+ * @return 认领成功返回 0 (节点已标记为 TASK_NODE_RUNNING)，节点已被取消返回 -1。
+ */
+static int ws_claim_stolen_locked(thread_pool_t pool, task_node_t *node)
+{
+    if (node->state == TASK_NODE_CANCELLED) {
+        task_slab_free(&pool->task_slab, node);
+        return -1;
     }
+    node->state = TASK_NODE_RUNNING;
+    pool_queue_size_add_locked(pool, -1);
     return 0;
 }
 
 /**
- * @brief 从队列头部移除任务 (内部函数)。
+ * @brief 将工作线程本地队列中剩余的任务转移到共享队列 (内部函数)。
  *
- * 此函数假定调用者 (通常是工作线程) 持有池的锁，
- * 并且已经检查过队列不为空，以及池在队列为空时没有正在关闭。
- * 它为新的 `task_t` 结构分配内存，将出队任务的数据复制到其中，
- * 释放 `task_node_t`，并返回指向新分配的 `task_t` 的指针。
- * 调用者负责在执行后释放返回的 `task_t`。
+ * 工作线程因调整大小或关闭而退出时调用，确保其本地任务仍会被执行。
+ * 已取消的节点直接回收。调用者必须持有池的锁。
  *
  * @param pool 指向 thread_pool_s 实例的指针。
- * @return 指向出队的 `task_t` (在堆上分配) 的指针，如果队列为空 (调用者应预先检查)
- *         或为 `task_t` 副本分配内存失败，则返回 NULL。
+ * @param worker 退出线程的槽位。
+ * @return 转移到共享队列的任务数量。
  */
-static task_t *task_dequeue_internal(thread_pool_t pool)
+static int ws_drain_local_locked(thread_pool_t pool, ws_worker_t *worker)
 {
-    if (pool->head == NULL) { // 防御性检查，尽管调用者应确保队列不为空。
-        TPOOL_TRACE("task_dequeue_internal: 尝试从线程池 %p 的空队列中出队。", (void *)pool);
-        return NULL;
+    int drained = 0;
+    for (int level = 0; level < TASK_PRIORITY_LEVELS; level++) {
+        ws_deque_t *deque = atomic_load_explicit(&worker->deques[level], memory_order_relaxed);
+        if (deque == NULL) {
+            continue;
+        }
+        // 从 top 端取出以保持原提交顺序
+        task_node_t *node = NULL;
+        while ((node = ws_deque_steal(deque)) != NULL || ws_deque_size(deque) > 0) {
+            if (node == NULL) {
+                continue; // 与窃取者竞争失败，重试
+            }
+            if (node->state == TASK_NODE_CANCELLED) {
+                task_slab_free(&pool->task_slab, node);
+                continue;
+            }
+            pool_queue_size_add_locked(pool, -1);
+            task_enqueue_internal(pool, node);
+            drained++;
+        }
+    }
+    worker->local_bitmap = 0;
+    return drained;
+}
+
+/**
+ * @brief 释放工作窃取模式的所有槽位和本地队列 (内部函数)。
+ *
+ * 仅在所有工作线程都已连接后调用，队列中剩余的节点随 slab 一并释放。
+ *
+ * @param pool 指向 thread_pool_s 实例的指针。共享队列模式下不执行任何操作。
+ */
+static void ws_workers_destroy(thread_pool_t pool)
+{
+    if (pool->ws_workers == NULL) {
+        return;
+    }
+    for (int i = 0; i < WS_MAX_WORKERS; i++) {
+        ws_worker_t *worker = atomic_load_explicit(&pool->ws_workers[i], memory_order_relaxed);
+        if (worker == NULL) {
+            continue;
+        }
+        for (int level = 0; level < TASK_PRIORITY_LEVELS; level++) {
+            ws_deque_t *deque = atomic_load_explicit(&worker->deques[level], memory_order_relaxed);
+            if (deque == NULL) {
+                continue;
+            }
+            // 正常关闭时本地队列已被执行完，此处只处理异常退出遗留的节点
+            task_node_t *node = NULL;
+            while ((node = ws_deque_steal(deque)) != NULL) {
+                if (node->state != TASK_NODE_CANCELLED) {
+                    task_node_finish_future(node, TASK_FUTURE_CANCELLED);
+                }
+            }
+            ws_deque_destroy(deque);
+        }
+        free(worker);
     }
+    free((void *)pool->ws_workers);
+    pool->ws_workers = NULL;
+}
 
-    task_node_t *node_to_dequeue = pool->head;
-    // 分配内存以保存任务数据的副本。此副本将由
-    // 工作线程处理并在执行后由其释放。
-    task_t *dequeued_task_data = (task_t *)malloc(sizeof(task_t));
+// --- 工作线程函数 ---
 
-    if (dequeued_task_data == NULL) {
-        TPOOL_ERROR("task_dequeue_internal: 未能为线程池 %p 的出队任务数据分配内存", (void *)pool);
-        // 在这种特定的错误情况下，节点仍保留在队列中。
-        // 工作线程将循环并可能重试或根据关闭状态退出。
-        return NULL;
+// 前向声明 worker_thread_function，因为 thread_pool_resize 中创建线程时会用到
+// 如果定义在 resize 之前，则不需要这个
+// static void *worker_thread_function(void *arg); // 实际上定义在 resize
+// 之前，所以不需要显式前向声明于此
+
+/**
+ * @brief 将工作线程标记为正在执行指定任务 (内部函数)。
+ *
+ * 调用者必须持有池的锁。
+ *
+ * @param pool 指向 thread_pool_s 实例的指针。
+ * @param worker 工作线程状态。
+ * @param node 即将执行的任务节点。
+ */
+static void worker_mark_running_locked(thread_pool_t pool, worker_state_t *worker, const task_node_t *node)
+{
+    if (worker->status == 0) { // 如果是空闲状态
+        pool_idle_threads_add_locked(pool, -1);
+        TPOOL_DEBUG("工作线程 #%d (线程池 %p): 设置为忙碌，空闲线程数: %d", worker->thread_id,
+                  (void *)pool, pool->idle_threads);
     }
+    worker->status = 1; // 设置为忙碌
 
-    *dequeued_task_data = node_to_dequeue->task; // 复制任务数据
+    // 记录正在执行的任务ID
+    worker->running_task_id = node->id;
+    trace_event(TRACE_EVENT_DEQUEUE, pool, node->id, node->priority);
+
+    // 更新运行任务名称 - 使用更安全的方式复制字符串
+    // 使用snprintf而不是strncpy，避免编译器警告
+    snprintf(worker->running_task_name, MAX_TASK_NAME_LEN, "%s", task_node_name(node));
+    worker_publish_locked(worker);
+}
+
+/**
+ * @brief 将工作线程标记为空闲 (内部函数)。
+ *
+ * 调用者必须持有池的锁。
+ *
+ * @param pool 指向 thread_pool_s 实例的指针。
+ * @param worker 工作线程状态。
+ */
+static void worker_mark_idle_locked(thread_pool_t pool, worker_state_t *worker)
+{
+    snprintf(worker->running_task_name, MAX_TASK_NAME_LEN, "[idle]");
+    // 清除正在执行的任务ID
+    worker->running_task_id = 0;
+    // 标记线程为空闲状态
+    worker->status = 0; // 空闲
+    worker_publish_locked(worker);
+    pool_idle_threads_add_locked(pool, 1);
+}
 
-    pool->head = node_to_dequeue->next;
-    if (pool->head == NULL) {
-        pool->tail = NULL; // 队列变为空
+/**
+ * @brief 把节点放入时间轮，必要时唤醒定时器线程 (内部函数)。
+ *
+ * 只有到期时间早于定时器线程计划醒来的刻度时才发送信号。调用者必须持有池的锁，
+ * 且定时器线程已创建。
+ *
+ * @param pool 指向 thread_pool_s 实例的指针。
+ * @param node 已登记到任务索引、不在任何队列中的节点。
+ * @param expire 到期刻度。
+ */
+static void timer_arm_locked(thread_pool_t pool, task_node_t *node, uint64_t expire)
+{
+    node->state = TASK_NODE_TIMER;
+    node->timer_expire = expire;
+    timer_wheel_insert(&pool->timer_wheel, node, timer_now_tick());
+    if (expire < pool->timer_wake_tick) {
+        pthread_cond_signal(&pool->timer_cond);
     }
-    pool->task_queue_size--;
-    TPOOL_DEBUG("任务 '%s' 已从线程池 %p 内部出队。队列大小: %d", dequeued_task_data->task_name,
-              (void *)pool, pool->task_queue_size);
+}
 
-    free(node_to_dequeue);     // 释放队列节点本身
-    return dequeued_task_data; // 返回堆分配的任务数据
+/**
+ * @brief 在周期任务执行完成后安排下一次执行 (内部函数)。
+ *
+ * 下一次到期时间为上一次到期时间加上周期，而不是完成时间加上周期，因此执行时间不会累积成漂移；
+ * 执行超过一个周期时跳过已错过的执行，同一周期任务永远不会重叠执行。调用者必须持有池的锁。
+ *
+ * @param pool 指向 thread_pool_s 实例的指针。
+ * @param node 刚执行完成的周期任务节点。
+ */
+static void timer_rearm_periodic_locked(thread_pool_t pool, task_node_t *node)
+{
+    uint64_t period = node->timer_period;
+    uint64_t now = timer_now_tick();
+    uint64_t expire = node->timer_expire + period;
+    if (expire < now) {
+        expire += ((now - expire) / period + 1) * period;
+    }
+    timer_arm_locked(pool, node, expire);
 }
 
 /**
- * @brief 释放队列中所有剩余的任务节点 (内部函数)。
+ * @brief 从任务索引中移除已完成的任务，并回收其节点 (内部函数)。
  *
- * 此函数通常在线程池销毁期间，在所有线程都已连接后调用。
- * 它遍历队列并释放所有 `task_node_t` 结构。
- * 注意：此函数 *不* 释放可能由 `task_dequeue_internal` 分配的 `task_t` 数据，
- * 因为这是工作线程的责任，或者如果任务从未执行，则由特定的清理逻辑负责。
- * 在这里，它仅释放队列容器节点。
- * 假定持有池锁或没有其他线程正在访问队列。
+ * 登记了完成句柄的任务在移出索引后才唤醒等待者，因此等待者醒来时任务已不可见。
+ * 节点优先放回工作线程的本地缓存；缓存已满时将缓存连同该节点一并归还给 slab。
+ * 未被取消的周期任务不回收，而是重新进入时间轮。
+ * 执行期间被取消的周期任务登记了取消回调时，回收节点后临时释放池锁调用回调，
+ * 此时任务函数已经返回，回调可以安全地释放任务参数。
+ * 调用者必须持有池的锁，且不得依赖调用前后池状态不变。
  *
  * @param pool 指向 thread_pool_s 实例的指针。
+ * @param worker 执行该任务的工作线程状态。
+ * @param node 已执行完成的节点。
  */
-static void task_queue_destroy_internal(thread_pool_t pool)
+static void task_node_complete_locked(thread_pool_t pool, worker_state_t *worker, task_node_t *node)
 {
-    task_node_t *current = pool->head;
-    task_node_t *next_node = NULL;
-    int count = 0;
-    while (current != NULL) {
-        next_node = current->next;
-        // current->task 中的 task_t 在此不被释放，因为：
-        // 1. 如果它是通过 thread_pool_add_task 添加的，其 'arg' 可能由外部或任务函数管理。
-        // 2. 此函数用于在关闭期间清理队列结构本身。
-        //    由工作线程获取的任何任务，其 task_t (来自 task_dequeue_internal) 将由工作线程释放。
-        //    队列中剩余的任务只是被丢弃；它们的内部数据不被处理。
-        free(current); // 释放节点结构
-        current = next_node;
-        count++;
+    task_node_cache_t *node_cache = &worker->node_cache;
+    stat_counter_inc_locked(&worker->tasks_completed);
+    if (node->timer_period > 0 && !pool->shutdown) {
+        // 周期任务按固定频率重新进入时间轮，节点和索引登记保持不变
+        timer_rearm_periodic_locked(pool, node);
+        return;
+    }
+    task_cancel_callback_t cancel_callback = node->cancel_callback;
+    void *cancel_arg = node->arg;
+    task_id_t cancel_id = node->id;
+    task_index_remove(&pool->id_index, node);
+    if (!node->anonymous) {
+        task_index_remove(&pool->name_index, node);
+    }
+    task_node_finish_future(node, TASK_FUTURE_COMPLETED);
+    if (node->function == task_graph_node_run) {
+        task_graph_node_retired(node->arg);
+    }
+    TPOOL_DEBUG("线程池 %p: 从任务索引中移除已完成的任务 '%s' (ID: %lu)", (void *)pool,
+              task_node_name(node), (unsigned long)node->id);
+    if (task_node_cache_push(node_cache, node) != 0) {
+        task_node_cache_flush(node_cache, &pool->task_slab);
+        task_slab_free(&pool->task_slab, node);
+    }
+    if (cancel_callback != NULL) {
+        pthread_mutex_unlock(&pool->lock);
+        cancel_callback(cancel_arg, cancel_id);
+        pthread_mutex_lock(&pool->lock);
     }
-    pool->head = NULL;
-    pool->tail = NULL;
-    pool->task_queue_size = 0;
-    TPOOL_DEBUG("线程池 %p 的内部任务队列已销毁。%d 个节点已释放。", (void *)pool, count);
 }
 
-// --- 工作线程函数 ---
+/**
+ * @brief 工作窃取模式下工作线程的主循环 (内部函数)。
+ *
+ * 每次任务边界只获取一次池锁：在同一临界区内完成上一个任务的收尾、
+ * 退出检查以及从共享队列或本地队列中选取下一个任务。
+ * 本地队列为空时释放锁并无锁地从其他线程窃取；仍无任务时才进入空闲栈休眠，等待定向唤醒。
+ * 退出前将本地队列中剩余的任务转移到共享队列。
+ *
+ * @param pool 指向 thread_pool_s 实例的指针 (工作窃取模式)。
+ * @param worker 当前工作线程的状态。
+ */
+static void worker_ws_loop(thread_pool_t pool, worker_state_t *worker)
+{
+    int thread_id = worker->thread_id;
+    task_node_t *finished = NULL;
 
-// 前向声明 worker_thread_function，因为 thread_pool_resize 中创建线程时会用到
-// 如果定义在 resize 之前，则不需要这个
-// static void *worker_thread_function(void *arg); // 实际上定义在 resize
-// 之前，所以不需要显式前向声明于此
+    pthread_mutex_lock(&(pool->lock));
+    ws_worker_t *self = ws_worker_slot_locked(pool, thread_id);
+
+    while (1) {
+        if (finished != NULL) {
+            task_node_complete_locked(pool, worker, finished);
+            finished = NULL;
+        }
+
+        if ((pool->shutdown && pool->task_queue_size == 0) || thread_id >= pool->thread_count ||
+            worker->status < 0) {
+            break;
+        }
+
+        task_node_t *node = ws_take_task_locked(pool, self);
+        if (node == NULL) {
+            // 本地和共享队列都为空，释放锁后尝试从其他线程窃取
+            pthread_mutex_unlock(&(pool->lock));
+            node = ws_steal_task(pool, thread_id);
+            pthread_mutex_lock(&(pool->lock));
+            if (node != NULL && ws_claim_stolen_locked(pool, node) != 0) {
+                continue; // 窃取到的任务已被取消
+            }
+            if (node != NULL) {
+                worker->tasks_stolen++;
+            }
+            if (node != NULL && (thread_id >= pool->thread_count || worker->status < 0)) {
+                // 窃取期间本线程被标记为退出，把任务交还共享队列
+                task_enqueue_internal(pool, node);
+                pool_wake_idle_locked(pool, 1);
+                continue;
+            }
+        }
+
+        if (node == NULL) {
+            if (pool->task_queue_size > 0) {
+                // 任务正在被其他线程窃取或认领，稍后重试
+                pthread_mutex_unlock(&(pool->lock));
+                sched_yield();
+                pthread_mutex_lock(&(pool->lock));
+                continue;
+            }
+            if (worker->status != 0) {
+                worker_mark_idle_locked(pool, worker);
+            }
+            if (pool->shutdown) {
+                continue; // 队列已空，下一轮退出
+            }
+            worker_idle_wait_locked(pool, worker);
+            continue;
+        }
+
+        worker_mark_running_locked(pool, worker, node);
+        pthread_mutex_unlock(&(pool->lock));
+
+        TPOOL_DEBUG("工作线程 #%d (线程池 %p): 开始任务 '%s'。", thread_id, (void *)pool,
+                  task_node_name(node));
+        tls_worker.current_node = node;
+        task_latency_start(pool, node);
+        trace_event(TRACE_EVENT_START, pool, node->id, node->priority);
+        (*(node->function))(node->arg);
+        trace_event(TRACE_EVENT_FINISH, pool, node->id, node->priority);
+        task_latency_finish(pool, node);
+        tls_worker.current_node = NULL;
+        TPOOL_DEBUG("工作线程 #%d (线程池 %p): 完成任务 '%s'。", thread_id, (void *)pool,
+                  task_node_name(node));
+
+        pthread_mutex_lock(&(pool->lock));
+        finished = node;
+    }
+
+    // 退出：本地剩余任务交给其他线程，修正空闲计数并归还节点缓存
+    if (self != NULL) {
+        int drained = ws_drain_local_locked(pool, self);
+        pool_wake_idle_locked(pool, drained);
+    }
+    if (worker->status == 0) {
+        pool_idle_threads_add_locked(pool, -1);
+    }
+    worker->status = -1;
+    worker_publish_locked(worker);
+    TPOOL_LOG("工作线程 #%d (线程池 %p): 正在退出，已完成 %lu 个任务 (窃取 %lu 个)。%s", thread_id,
+              (void *)pool, atomic_load_explicit(&worker->tasks_completed, memory_order_relaxed),
+              worker->tasks_stolen,
+              pool->shutdown ? "(由于关闭)" : "(由于调整大小)");
+    task_node_cache_flush(&worker->node_cache, &pool->task_slab);
+    tls_worker.pool = NULL;
+    pthread_mutex_unlock(&(pool->lock));
+}
 
 /**
  * @brief 池中每个工作线程执行的主函数。
  *
  * 工作线程持续监控任务队列。当有可用任务且池处于活动状态时，
- * 它们将任务出队，执行它，然后释放由 `task_dequeue_internal` 分配的任务数据结构。
+ * 它们将任务节点出队，直接执行节点中的任务，然后将节点放回本地缓存
+ * (缓存满时归还给池的 slab)。
  * 如果池正在关闭且任务队列变空，则线程将退出。
  *
- * @param arg 指向 `thread_args_t` 结构的指针，包含池实例和线程的 ID。
- *            此结构由工作线程释放。
+ * @param arg 指向该线程槽位的 `worker_state_t`，包含池实例和线程的 ID。
+ *            槽位由线程池持有，线程退出时无需释放。
  * @return 线程终止时返回 NULL。
  */
 static void *worker_thread_function(void *arg)
 {
-    thread_args_t *thread_args = (thread_args_t *)arg;
-    thread_pool_t pool = thread_args->pool;
-    int thread_id = thread_args->thread_id;
-    free(thread_args); // 释放参数结构
+    worker_state_t *worker = (worker_state_t *)arg;
+    thread_pool_t pool = worker->pool;
+    int thread_id = worker->thread_id;
+
+    // 工作线程本地的空闲节点缓存位于槽位中，退出前归还给池的 slab
+    tls_worker.pool = pool;
+    tls_worker.node_cache = &worker->node_cache;
+    tls_worker.thread_id = thread_id;
 
     TPOOL_LOG("工作线程 #%d (线程池 %p): 已启动。", thread_id, (void *)pool);
 
+    if (pool->scheduler == THREAD_POOL_SCHED_WORK_STEALING) {
+        worker_ws_loop(pool, worker);
+        return NULL;
+    }
+
     // 循环直到池关闭且队列为空，或者线程被标记为退出
     while (1) {
         pthread_mutex_lock(&(pool->lock));
-        TPOOL_TRACE("工作线程 #%d (线程池 %p): 已锁定池。", thread_id, (void *)pool);
 
         // 检查线程ID是否超出范围（可能在调整大小后发生）
         if (thread_id >= pool->thread_count) {
@@ -217,153 +1540,88 @@ static void *worker_thread_function(void *arg)
             // 在此处不立即退出，让线程继续等待通知，在收到通知后再检查是否需要退出
         }
 
-        // 先检查是否有任务，如果队列为空且线程池未关闭，则等待
-        // 这是关键修改点：使用谓词条件而不是盲目等待
-        struct timespec timeout;
-        clock_gettime(CLOCK_REALTIME, &timeout);
-        timeout.tv_sec += 1; // 最多等待1秒，防止永久阻塞
-        
-        while (pool->task_queue_size == 0 && !pool->shutdown && 
+        // 先检查是否有任务，如果队列为空且线程池未关闭，则休眠直到被定向唤醒
+        // 提交任务、调整大小和关闭线程池都会唤醒需要的线程，因此无需超时轮询
+        while (!worker_has_work_locked(pool, worker) && !pool->shutdown && 
               thread_id < pool->thread_count && 
-              (thread_id >= pool->thread_count || pool->thread_status[thread_id] >= 0)) {
-            // 使用超时等待，防止永久阻塞
-            int wait_result = pthread_cond_timedwait(&(pool->notify), &(pool->lock), &timeout);
-            if (wait_result == ETIMEDOUT) {
-                // 超时后，检查一下队列是否有新任务，可能信号丢失
-                if (pool->task_queue_size > 0) {
-                    TPOOL_DEBUG("工作线程 #%d (线程池 %p): 等待超时但发现有任务，继续处理", 
-                             thread_id, (void *)pool);
-                    break;
-                }
-                // 重置超时，再等待一秒
-                clock_gettime(CLOCK_REALTIME, &timeout);
-                timeout.tv_sec += 1;
-            }
+              (thread_id >= pool->thread_count || worker->status >= 0)) {
+            worker_idle_wait_locked(pool, worker);
         }
-        TPOOL_TRACE("工作线程 #%d (线程池 %p): 已被唤醒。", thread_id, (void *)pool);
 
         // 检查是否应该退出（增加对线程ID范围的检查）
-        if ((pool->shutdown && pool->task_queue_size == 0) ||
+        if ((pool->shutdown && !worker_has_work_locked(pool, worker)) ||
             thread_id >= pool->thread_count ||
-            (thread_id < pool->thread_count && pool->thread_status[thread_id] < 0)) {
-            // 如果是空闲状态，减少空闲线程计数
-            if (thread_id < pool->thread_count && pool->thread_status[thread_id] == 0) {
-                pool->idle_threads--;
+            (thread_id < pool->thread_count && worker->status < 0)) {
+            // 如果是空闲状态，减少空闲线程计数 (槽位状态独立于 thread_count，缩小后同样有效)
+            if (worker->status == 0) {
+                pool_idle_threads_add_locked(pool, -1);
                 TPOOL_DEBUG("工作线程 #%d (线程池 %p): 退出前减少空闲线程计数，当前空闲线程数: %d",
                           thread_id, (void *)pool, pool->idle_threads);
             }
 
-            // 清除线程状态，避免后续访问（仅当线程ID在有效范围内时）
-            if (thread_id < pool->thread_count) {
-                pool->thread_status[thread_id] = -1;
-            }
-
             // 初始化退出原因变量为默认值，避克lint错误
             const char* exit_reason = "(未知原因)";
             if (thread_id >= pool->thread_count) {
                 exit_reason = "(由于线程ID超出范围)";
-            } else if (thread_id < pool->thread_count && pool->thread_status[thread_id] < 0) {
+            } else if (thread_id < pool->thread_count && worker->status < 0) {
                 exit_reason = "(由于调整大小)";
             } else if (pool->shutdown) {
                 exit_reason = "(由于关闭)";
             }
-            TPOOL_LOG("工作线程 #%d (线程池 %p): 正在退出。%s", thread_id, (void *)pool, exit_reason);
+
+            // 标记线程已退出
+            worker->status = -1;
+            worker_publish_locked(worker);
+            worker_node_detach_locked(pool, worker);
+            TPOOL_LOG("工作线程 #%d (线程池 %p): 正在退出，已完成 %lu 个任务。%s", thread_id, (void *)pool,
+                      atomic_load_explicit(&worker->tasks_completed, memory_order_relaxed), exit_reason);
+            task_node_cache_flush(&worker->node_cache, &pool->task_slab);
+            tls_worker.pool = NULL;
             pthread_mutex_unlock(&(pool->lock));
             pthread_exit(NULL);
         }
 
-        // 获取任务
-        task_t *task = NULL;
-        if (pool->task_queue_size > 0) {
-            task = task_dequeue_internal(pool);
+        // 获取任务节点
+        task_node_t *node = NULL;
+        if (worker_has_work_locked(pool, worker)) {
+            node = task_dequeue_for_worker_locked(pool, worker);
         }
         
-        if (task == NULL) {
-            // 队列为空，唤醒其他线程然后继续循环
-            // 这有助于防止所有线程都在等待而没有线程检查任务队列的情况
-            pthread_cond_broadcast(&(pool->notify));
+        if (node == NULL) {
+            // 任务已被其他线程取走，继续循环重新等待
             pthread_mutex_unlock(&(pool->lock));
             continue;
         }
-
         // 标记为忙碌
-        if (pool->thread_status[thread_id] == 0) { // 如果是空闲状态
-            pool->idle_threads--;
-            TPOOL_DEBUG("工作线程 #%d (线程池 %p): 设置为忙碌，空闲线程数: %d", thread_id,
-                      (void *)pool, pool->idle_threads);
-        }
-        pool->thread_status[thread_id] = 1; // 设置为忙碌
-        
-        // 记录正在执行的任务ID
-        pool->running_task_ids[thread_id] = task->id;
-
-        // 更新运行任务名称 - 使用更安全的方式复制字符串
-        // 使用snprintf而不是strncpy，避免编译器警告
-        snprintf(pool->running_task_names[thread_id], MAX_TASK_NAME_LEN, "%s", task->task_name);
+        worker_mark_running_locked(pool, worker, node);
 
         TPOOL_DEBUG("工作线程 #%d (线程池 %p): 出队任务 '%s'。", thread_id, (void *)pool,
-                  task->task_name);
+                  task_node_name(node));
 
         // 解锁池，允许其他线程访问
         pthread_mutex_unlock(&(pool->lock));
         TPOOL_DEBUG("工作线程 #%d (线程池 %p): 开始任务 '%s'。", thread_id, (void *)pool,
-                  task->task_name);
+                  task_node_name(node));
 
         // 执行任务
-        (*(task->function))(task->arg);
+        tls_worker.current_node = node;
+        task_latency_start(pool, node);
+        trace_event(TRACE_EVENT_START, pool, node->id, node->priority);
+        (*(node->function))(node->arg);
+        trace_event(TRACE_EVENT_FINISH, pool, node->id, node->priority);
+        task_latency_finish(pool, node);
+        tls_worker.current_node = NULL;
 
         // 任务完成
-        TPOOL_DEBUG("工作线程 #%d (线程池 %p): 完成任务 '%s'。", thread_id, (void *)pool,
-                  task->task_name);
-
-        // 释放任务结构
-        free(task);
-
-        // 重新锁定池以设置状态为空闲
-        pthread_mutex_lock(&(pool->lock));
-        TPOOL_TRACE("工作线程 #%d (线程池 %p): 已锁定池以设置状态为闲置。", thread_id, (void *)pool);
-
-        // 检查线程ID是否仍然有效（可能在执行任务期间池被调整大小）
-        if (thread_id >= pool->thread_count) {
-            TPOOL_DEBUG("工作线程 #%d (线程池 %p): 任务完成后发现线程ID超出范围（当前线程数: %d）。"
-                     "将在下一次循环优雅退出。",
-                     thread_id, (void *)pool, pool->thread_count);
-            // 不立即退出，先解锁并在下一个循环中优雅退出
-            // 这样可以避免在持有锁的情况下突然退出
-            pthread_mutex_unlock(&(pool->lock));
-            continue;
-        }
-
-        // 从任务名称映射中移除已完成的任务
-        task_id_t completed_task_id = pool->running_task_ids[thread_id];
-        char completed_task_name[MAX_TASK_NAME_LEN];
-        strncpy(completed_task_name, pool->running_task_names[thread_id], MAX_TASK_NAME_LEN - 1);
-        completed_task_name[MAX_TASK_NAME_LEN - 1] = '\0';
-        
-        // 解锁线程池锁，锁住任务名称映射锁
-        pthread_mutex_unlock(&(pool->lock));
-        pthread_mutex_lock(&(pool->name_map_lock));
-        
-        // 在映射中查找并移除已完成的任务
-        for (int i = 0; i < pool->task_name_map_size; i++) {
-            if (pool->task_name_map[i].task_id == completed_task_id) {
-                // 找到要移除的映射，将最后一个映射移动到这个位置
-                if (i < pool->task_name_map_size - 1) {
-                    // 如果不是最后一个元素，将最后一个元素复制到当前位置
-                    memcpy(&pool->task_name_map[i], &pool->task_name_map[pool->task_name_map_size - 1], 
-                           sizeof(*pool->task_name_map));
-                }
-                pool->task_name_map_size--;
-                TPOOL_DEBUG("工作线程 #%d (线程池 %p): 从任务名称映射中移除已完成的任务 '%s' (ID: %lu)", 
-                          thread_id, (void *)pool, completed_task_name, (unsigned long)completed_task_id);
-                break;
-            }
-        }
-        
-        // 释放任务名称映射锁，重新锁住线程池锁
-        pthread_mutex_unlock(&(pool->name_map_lock));
+        TPOOL_DEBUG("工作线程 #%d (线程池 %p): 完成任务 '%s'。", thread_id, (void *)pool,
+                  task_node_name(node));
+
+        // 重新锁定池以设置状态为空闲
         pthread_mutex_lock(&(pool->lock));
-        
+
+        // 从任务索引中移除已完成的任务并回收节点
+        task_node_complete_locked(pool, worker, node);
+
         // 检查线程ID是否仍然有效（可能在执行任务期间池被调整大小）
         if (thread_id >= pool->thread_count) {
             TPOOL_DEBUG("工作线程 #%d (线程池 %p): 任务完成后发现线程ID超出范围（当前线程数: %d）。"
@@ -376,18 +1634,11 @@ static void *worker_thread_function(void *arg)
         }
         
         // 设置为空闲状态
-        if (pool->thread_status[thread_id] != 0) { // 如果不是已经空闲
-            pool->thread_status[thread_id] = 0;
+        if (worker->status != 0) { // 如果不是已经空闲
             // 状态更新已在 pool->lock 保护下
             TPOOL_DEBUG("工作线程 #%d (线程池 %p): 任务完成，准备更新状态为闲置。", thread_id,
                       (void *)pool);
-            strncpy(pool->running_task_names[thread_id], "[idle]", MAX_TASK_NAME_LEN - 1);
-            pool->running_task_names[thread_id][MAX_TASK_NAME_LEN - 1] = '\0';
-            // 清除正在执行的任务ID
-            pool->running_task_ids[thread_id] = 0;
-            // 标记线程为空闲状态
-            pool->thread_status[thread_id] = 0; // 空闲
-            pool->idle_threads++;
+            worker_mark_idle_locked(pool, worker);
 
             // 任务完成后信号自动调整线程检查是否需要调整线程池大小
             if (pool->auto_adjust) {
@@ -404,38 +1655,150 @@ static void *worker_thread_function(void *arg)
                     pthread_cond_signal(&pool->adjust_cond);
                     pthread_mutex_unlock(&pool->adjust_cond_lock);
                     
-                    // 同时唤醒所有工作线程，确保没有线程永久阻塞
-                    pthread_cond_broadcast(&(pool->notify));
-                    
                     // 重新获取线程池锁
                     pthread_mutex_lock(&(pool->lock));
                 }
             }
         } else if (pool->shutdown) {
-            // 如果 task_dequeue_internal 返回 NULL (例如，出队期间 malloc 失败) 并且 池正在关闭。
-            // 这确保即使在关闭期间出队失败，线程也会退出。
+            // 线程状态已被外部改为空闲并且池正在关闭。
+            // 这确保即使在关闭期间状态异常，线程也会退出。
+            worker_node_detach_locked(pool, worker);
+            task_node_cache_flush(&worker->node_cache, &pool->task_slab);
+            tls_worker.pool = NULL;
             pthread_mutex_unlock(&(pool->lock));
             TPOOL_LOG(
                 "工作线程 #%d (线程池 %p): 正在关闭 (任务为 NULL，可能在关闭或出队错误期间)。",
                 thread_id, (void *)pool);
             pthread_exit(NULL);
         } else {
-            // 任务为 NULL，但没有关闭。这表示 task_dequeue_internal 失败 (例如，malloc)。
-            // task_dequeue_internal 会记录错误。
+            // 线程状态已是空闲，但没有关闭。
             // 工作线程继续循环并将重新评估条件。
             TPOOL_DEBUG("工作线程 #%d (线程池 %p): 发现任务为 NULL，但未关闭。将重新等待。",
                       thread_id, (void *)pool);
         }
-        // 任务完成或状态变更，唤醒其他线程查看是否有新任务
-        pthread_cond_broadcast(&(pool->notify));
         pthread_mutex_unlock(&(pool->lock));
-        TPOOL_TRACE("工作线程 #%d (线程池 %p): 已解锁池，继续循环。", thread_id, (void *)pool);
     }
     return NULL; // 应该无法到达
 }
 
 // --- 自动调整相关函数 ---
 
+/**
+ * @brief 累计所有工作线程槽位完成的任务数 (内部函数)。
+ *
+ * 调用者必须持有池的锁。
+ */
+static unsigned long pool_tasks_completed_locked(thread_pool_t pool)
+{
+    unsigned long completed = 0;
+    for (int i = 0; i < pool->worker_capacity; i++) {
+        completed += atomic_load_explicit(&pool->workers[i]->tasks_completed, memory_order_relaxed);
+    }
+    return completed;
+}
+
+/**
+ * @brief 速率策略：采样到达率和处理速率并计算目标线程数 (内部函数)。
+ *
+ * 两次采样间隔不足半个检查间隔时 (例如被提交任务提前唤醒) 不采样，直接返回当前线程数。
+ * 目标线程数 = 到达率 / 每线程处理速率 + 队列长度 / (每线程处理速率 * 期望排队等待时间)，
+ * 即承担稳定到达所需的线程数加上在期望等待时间内清空积压所需的线程数。
+ * 扩容立即生效；缩减要求目标低于死区、估计的排队等待时间不超过期望值，且距上次调整超过冷却时间。
+ * 调用者必须持有池的锁。
+ *
+ * @param pool 指向 thread_pool_s 实例的指针。
+ * @return 目标线程数 (已限制在 min_threads 和 max_threads 之间)。
+ */
+static int auto_adjust_rate_target_locked(thread_pool_t pool)
+{
+    adjust_rate_state_t *rate = &pool->adjust_rate;
+    int current_threads = pool->thread_count;
+    uint64_t now_ns = latency_now_ns();
+    unsigned long submitted = atomic_load_explicit(&pool->tasks_submitted, memory_order_relaxed);
+    unsigned long completed = pool_tasks_completed_locked(pool);
+
+    if (rate->samples == 0) {
+        rate->samples = 1;
+        rate->last_sample_ns = now_ns;
+        rate->last_resize_ns = now_ns;
+        rate->last_submitted = submitted;
+        rate->last_completed = completed;
+        return current_threads;
+    }
+    uint64_t elapsed_ns = now_ns - rate->last_sample_ns;
+    if (elapsed_ns < (uint64_t)pool->adjust_interval * 500000u) {
+        return current_threads;
+    }
+
+    // 累计计数器可能回绕，无符号差值仍然正确
+    double elapsed_s = (double)elapsed_ns / 1e9;
+    double arrivals = (double)(submitted - rate->last_submitted) / elapsed_s;
+    double completions = (double)(completed - rate->last_completed) / elapsed_s;
+    double weight = pool->adjust_ewma_weight / 100.0;
+    int queued = pool->task_queue_size;
+    // 有积压时所有线程都应处于忙碌状态
+    int busy = queued > 0 ? current_threads : current_threads - pool->idle_threads;
+
+    if (rate->samples == 1) {
+        rate->arrival_rate = arrivals;
+    } else {
+        rate->arrival_rate += weight * (arrivals - rate->arrival_rate);
+    }
+    if (completions > 0 && busy > 0) {
+        double per_thread = completions / busy;
+        rate->service_rate = rate->service_rate > 0 ? rate->service_rate + weight * (per_thread - rate->service_rate)
+                                                    : per_thread;
+    }
+    rate->samples++;
+    rate->last_sample_ns = now_ns;
+    rate->last_submitted = submitted;
+    rate->last_completed = completed;
+
+    double target_wait_s = pool->adjust_target_wait_us / 1e6;
+    double needed;
+    double queue_wait_s;
+    if (rate->service_rate > 0) {
+        needed = rate->arrival_rate / rate->service_rate + queued / (rate->service_rate * target_wait_s);
+        // Little 定律：排队等待时间约为队列长度除以整个线程池的处理速率
+        queue_wait_s = queued / (rate->service_rate * current_threads);
+    } else {
+        // 还没有任务完成，无法估计处理速率：有积压时按积压量扩容
+        needed = queued > 0 ? (double)current_threads + queued : current_threads;
+        queue_wait_s = queued > 0 ? target_wait_s * 2 : 0;
+    }
+
+    int target_threads = needed >= pool->max_threads ? pool->max_threads : (int)needed;
+    if (target_threads < needed) {
+        target_threads++; // 向上取整
+    }
+    if (target_threads < pool->min_threads) {
+        target_threads = pool->min_threads;
+    }
+    if (target_threads > pool->max_threads) {
+        target_threads = pool->max_threads;
+    }
+
+    TPOOL_DEBUG("自动调整 (速率): 到达率=%.1f/s, 每线程处理速率=%.1f/s, 队列=%d, 估计排队等待=%.1f ms "
+              "(期望 %.1f ms), 当前线程=%d, 目标线程=%d",
+              rate->arrival_rate, rate->service_rate, queued, queue_wait_s * 1000, target_wait_s * 1000,
+              current_threads, target_threads);
+
+    if (target_threads < current_threads) {
+        int dead_band = current_threads * pool->adjust_hysteresis / 100;
+        if (dead_band < 1) {
+            dead_band = 1;
+        }
+        if (current_threads - target_threads < dead_band || queue_wait_s > target_wait_s ||
+            now_ns - rate->last_resize_ns < (uint64_t)pool->adjust_cooldown_ms * 1000000u) {
+            return current_threads;
+        }
+    }
+    if (target_threads != current_threads) {
+        rate->last_resize_ns = now_ns;
+    }
+    return target_threads;
+}
+
 /**
  * @brief 自动调整线程的主执行函数。
  *
@@ -516,8 +1879,12 @@ static void *auto_adjust_thread_function(void *arg)
                       current_threads, tasks_in_queue, pool->high_watermark,
                       idle, pool->low_watermark, pool->min_threads, pool->max_threads);
             
+            if (pool->adjust_policy == THREAD_POOL_ADJUST_RATE) {
+                // 速率策略直接给出目标线程数，一次调整到位
+                target_threads = auto_adjust_rate_target_locked(pool);
+            }
             // 检查是否需要增加线程
-            if (tasks_in_queue > pool->high_watermark && current_threads < pool->max_threads) {
+            else if (tasks_in_queue > pool->high_watermark && current_threads < pool->max_threads) {
                 target_threads = current_threads + 1;
                 TPOOL_DEBUG("自动调整: 任务队列 (%d) > 高水位 (%d)。建议增加线程数至 %d。", 
                           tasks_in_queue, pool->high_watermark, target_threads);
@@ -574,16 +1941,60 @@ static void *auto_adjust_thread_function(void *arg)
 
 // --- 公共 API 函数实现 ---
 
+/**
+ * @brief 使用默认值初始化线程池创建选项。
+ *
+ * @param config 要初始化的选项结构。为 NULL 时不执行任何操作。
+ * @param num_threads 初始工作线程数。
+ */
+void thread_pool_config_init(thread_pool_config_t *config, int num_threads)
+{
+    if (config == NULL) {
+        return;
+    }
+    config->num_threads = num_threads;
+    config->task_slab_size = TASK_SLAB_DEFAULT_NODES;
+    config->task_slab_chunk_size = TASK_SLAB_DEFAULT_CHUNK_NODES;
+    config->scheduler = THREAD_POOL_SCHED_SHARED_QUEUE;
+    config->ws_deque_capacity = WS_DEQUE_DEFAULT_CAPACITY;
+    config->idle_spin_us = 0;
+    config->latency_stats = 0;
+    config->cpus = NULL;
+    config->cpu_count = 0;
+    config->pin_policy = THREAD_POOL_PIN_NONE;
+    config->stack_size = 0;
+    config->sched_policy = -1;
+    config->sched_priority = 0;
+    config->queue_capacity = 0;
+    config->queue_reserved = 0;
+    config->queue_reserved_priority = TASK_PRIORITY_HIGH;
+    config->aging_ms = 0;
+}
+
 /**
  * @brief 创建一个新的线程池。
  *
- * 使用指定数量的工作线程初始化线程池。
+ * 使用指定数量的工作线程和默认选项初始化线程池。
  *
  * @param num_threads 要在池中创建的工作线程数。必须为正数。
  * @return 成功时返回指向新创建的 thread_pool_t 实例的指针，
  *         错误时返回 NULL (例如，内存分配失败，无效参数)。
  */
 thread_pool_t thread_pool_create(int num_threads)
+{
+    thread_pool_config_t config;
+    thread_pool_config_init(&config, num_threads);
+    return thread_pool_create_with_config(&config);
+}
+
+/**
+ * @brief 按照指定选项创建一个新的线程池。
+ *
+ * @param config 创建选项。不能为空。
+ * @return 成功时返回指向新创建的 thread_pool_t 实例的指针，
+ *         错误时返回 NULL (例如，内存分配失败，无效参数)。
+ */
+thread_pool_t thread_pool_create_with_config(const thread_pool_config_t *config)
 {
     // 确保日志模块已初始化
     static int log_initialized = 0;
@@ -613,11 +2024,46 @@ thread_pool_t thread_pool_create(int num_threads)
         log_initialized = 1;
     }
 
+    if (config == NULL) {
+        TPOOL_ERROR("thread_pool_create_with_config: 创建选项为 NULL。");
+        return NULL;
+    }
+    int num_threads = config->num_threads;
+
     TPOOL_DEBUG("尝试创建包含 %d 个线程的线程池。", num_threads);
     if (num_threads <= 0) {
         TPOOL_ERROR("线程数必须为正。请求数: %d", num_threads);
         return NULL;
     }
+    if (config->task_slab_size < 0 || config->task_slab_chunk_size <= 0) {
+        TPOOL_ERROR("无效的任务节点 slab 选项 (预分配: %d, 扩展块: %d)。", config->task_slab_size,
+                    config->task_slab_chunk_size);
+        return NULL;
+    }
+    if (config->scheduler == THREAD_POOL_SCHED_WORK_STEALING &&
+        (num_threads > WS_MAX_WORKERS || config->ws_deque_capacity <= 0)) {
+        TPOOL_ERROR("无效的工作窃取选项 (线程数: %d, 上限: %d, 本地队列容量: %d)。", num_threads,
+                    WS_MAX_WORKERS, config->ws_deque_capacity);
+        return NULL;
+    }
+    if (config->idle_spin_us < 0) {
+        TPOOL_ERROR("无效的空闲自旋时间: %d 微秒。", config->idle_spin_us);
+        return NULL;
+    }
+    if (config->scheduler != THREAD_POOL_SCHED_SHARED_QUEUE &&
+        config->scheduler != THREAD_POOL_SCHED_WORK_STEALING) {
+        TPOOL_ERROR("未知的调度模式: %d。", (int)config->scheduler);
+        return NULL;
+    }
+    if (config->aging_ms < 0) {
+        TPOOL_ERROR("无效的优先级老化间隔: %d 毫秒。", config->aging_ms);
+        return NULL;
+    }
+    if (config->queue_capacity < 0 || config->queue_reserved < 0 ||
+        (config->queue_reserved > 0 && config->queue_reserved >= config->queue_capacity)) {
+        TPOOL_ERROR("无效的队列容量选项 (容量: %d, 保留: %d)。", config->queue_capacity, config->queue_reserved);
+        return NULL;
+    }
 
     // 分配 thread_pool_s 结构本身
     thread_pool_t pool = (thread_pool_t)calloc(1, sizeof(struct thread_pool_s));
@@ -634,23 +2080,38 @@ thread_pool_t thread_pool_create(int num_threads)
     pool->shutdown = 0;                  // 池处于活动状态
     pool->resize_shutdown = 0;           // 没有线程需要由于缩小而退出
     pool->started = 0;                   // 尚未启动任何线程
-    pool->head = NULL;
-    pool->tail = NULL;
+    memset(pool->run_queue, 0, sizeof(pool->run_queue)); // 所有优先级级别的队列均为空
+    pool->run_queue_bitmap = 0;
+    deadline_heap_init(&pool->deadline_heap);
+    pool->aging_ns = (uint64_t)config->aging_ms * UINT64_C(1000000);
     pool->task_queue_size = 0;
+    pool->queue_capacity = config->queue_capacity;
+    pool->queue_reserved = config->queue_reserved;
+    pool->queue_reserved_level = task_priority_level(config->queue_reserved_priority);
+    pool->space_waiters = 0;
+    pool->reserved_space_waiters = 0;
     pool->next_task_id = 1;              // 初始化任务ID计数器，从1开始（0保留为无效ID）
+    pool->scheduler = config->scheduler;
+    pool->ws_deque_capacity = (size_t)config->ws_deque_capacity;
+    pool->ws_workers = NULL;             // 工作窃取槽位在创建线程前分配
+    atomic_init(&pool->ws_worker_slots, 0);
+    pool->workers = NULL;                // 工作线程状态在创建线程前分配
+    pool->worker_capacity = 0;
+    pool->idle_stack = NULL;
+    pool->idle_stack_size = 0;
+    pool->idle_spin_us = config->idle_spin_us;
+    atomic_init(&pool->submit_seq, 0);
+    pool->latency = NULL;                // 延迟直方图仅在启用时分配
+    pool->node_queues = NULL;            // NUMA 节点运行队列在解析 CPU 绑定后按需分配
+    pool->node_worker_count = NULL;
+    atomic_init(&pool->worker_table, NULL);
+    atomic_init(&pool->stat_thread_count, num_threads);
+    atomic_init(&pool->stat_idle_threads, 0);
+    atomic_init(&pool->stat_queue_size, 0);
+    atomic_init(&pool->tasks_submitted, 0);
+    atomic_init(&pool->tasks_cancelled, 0);
+    atomic_init(&pool->tasks_rejected, 0);
     
-    // 初始化任务名称映射
-    pool->task_name_map = NULL;
-    pool->task_name_map_size = 0;
-    pool->task_name_map_capacity = 0;
-    
-    // 初始化任务名称映射互斥锁
-    if (pthread_mutex_init(&pool->name_map_lock, NULL) != 0) {
-        TPOOL_ERROR("未能为线程池 %p 初始化任务名称映射互斥锁。", (void *)pool);
-        free(pool);
-        return NULL;
-    }
-
     // 初始化自动调整相关字段
     pool->auto_adjust = 0;                 // 默认禁用自动调整
     pool->high_watermark = num_threads;    // 默认任务队列高水位线为线程数
@@ -666,282 +2127,731 @@ thread_pool_t thread_pool_create(int num_threads)
         return NULL;
     }
 
-    // 初始化调整大小互斥锁
-    if (pthread_mutex_init(&pool->resize_lock, NULL) != 0) {
-        TPOOL_ERROR("未能为线程池 %p 初始化调整大小互斥锁。", (void *)pool);
-        pthread_mutex_destroy(&pool->lock);
-        free(pool);
-        return NULL;
+    // 初始化调整大小互斥锁
+    if (pthread_mutex_init(&pool->resize_lock, NULL) != 0) {
+        TPOOL_ERROR("未能为线程池 %p 初始化调整大小互斥锁。", (void *)pool);
+        pthread_mutex_destroy(&pool->lock);
+        free(pool);
+        return NULL;
+    }
+
+    // 初始化提交者等待队列空位的条件变量
+    if (monotonic_cond_init(&pool->space_cond) != 0) {
+        TPOOL_ERROR("未能为线程池 %p 初始化队列空位条件变量。", (void *)pool);
+        pthread_mutex_destroy(&pool->resize_lock);
+        pthread_mutex_destroy(&pool->lock);
+        free(pool);
+        return NULL;
+    }
+    if (monotonic_cond_init(&pool->reserved_space_cond) != 0) {
+        TPOOL_ERROR("未能为线程池 %p 初始化保留槽位条件变量。", (void *)pool);
+        pthread_cond_destroy(&pool->space_cond);
+        pthread_mutex_destroy(&pool->resize_lock);
+        pthread_mutex_destroy(&pool->lock);
+        free(pool);
+        return NULL;
+    }
+
+    // 初始化时间轮和定时器线程等待的条件变量，定时器线程在首次提交延迟或周期任务时创建
+    if (monotonic_cond_init(&pool->timer_cond) != 0) {
+        TPOOL_ERROR("未能为线程池 %p 初始化定时器条件变量。", (void *)pool);
+        pthread_cond_destroy(&pool->reserved_space_cond);
+        pthread_cond_destroy(&pool->space_cond);
+        pthread_mutex_destroy(&pool->resize_lock);
+        pthread_mutex_destroy(&pool->lock);
+        free(pool);
+        return NULL;
+    }
+    timer_wheel_init(&pool->timer_wheel, timer_now_tick());
+    pool->timer_wake_tick = UINT64_MAX;
+
+    // 先解析 CPU 绑定 (槽位的节点归属依赖它)，再按 max_threads 一次性分配每个工作线程的状态，
+    // 调整大小时不再分配；同时预分配任务节点 slab 并初始化任务索引
+    int use_node_queues = pool->scheduler == THREAD_POOL_SCHED_SHARED_QUEUE &&
+                          config->pin_policy != THREAD_POOL_PIN_NONE;
+    if (worker_placement_init(&pool->placement, config) != 0 ||
+        (use_node_queues &&
+         ((pool->node_queues = (node_run_queue_t *)calloc((size_t)pool->placement.max_node,
+                                                          sizeof(node_run_queue_t))) == NULL ||
+          (pool->node_worker_count = (int *)calloc((size_t)pool->placement.max_node, sizeof(int))) == NULL)) ||
+        worker_states_reserve(pool, pool->max_threads) != 0 ||
+        task_slab_init(&pool->task_slab, config->task_slab_size, config->task_slab_chunk_size) != 0 ||
+        task_index_init(&pool->id_index, TASK_INDEX_BY_ID) != 0 ||
+        task_index_init(&pool->name_index, TASK_INDEX_BY_NAME) != 0 ||
+        (pool->scheduler == THREAD_POOL_SCHED_WORK_STEALING &&
+         (pool->ws_workers = (_Atomic(ws_worker_t *) *)malloc(WS_MAX_WORKERS * sizeof(*pool->ws_workers))) ==
+             NULL) ||
+        (config->latency_stats && (pool->latency = latency_levels_create()) == NULL)) {
+        TPOOL_ERROR("未能为线程池 %p 解析 CPU 绑定、分配工作线程状态、预分配 %d 个任务节点、初始化任务索引、"
+                    "工作窃取槽位或延迟直方图。",
+                    (void *)pool, config->task_slab_size);
+        latency_levels_destroy(pool->latency);
+        free(pool->node_worker_count);
+        free(pool->node_queues);
+        worker_placement_destroy(&pool->placement);
+        free((void *)pool->ws_workers);
+        deadline_heap_destroy(&pool->deadline_heap);
+        task_index_destroy(&pool->name_index);
+        task_index_destroy(&pool->id_index);
+        task_slab_destroy(&pool->task_slab);
+        worker_states_destroy(pool);
+        pthread_cond_destroy(&pool->timer_cond);
+        pthread_cond_destroy(&pool->reserved_space_cond);
+        pthread_cond_destroy(&pool->space_cond);
+        pthread_mutex_destroy(&pool->resize_lock);
+        pthread_mutex_destroy(&pool->lock);
+        free(pool);
+        return NULL;
+    }
+    if (pool->ws_workers != NULL) {
+        for (int i = 0; i < WS_MAX_WORKERS; i++) {
+            atomic_init(&pool->ws_workers[i], NULL);
+        }
+    }
+
+    // 初始化线程状态为1（忙碌），因为线程创建后将立即开始工作
+    for (int i = 0; i < num_threads; i++) {
+        pool->workers[i]->status = 1;
+        worker_publish_locked(pool->workers[i]);
+    }
+
+    // 创建工作线程，槽位本身作为线程参数
+    for (int i = 0; i < num_threads; ++i) {
+        worker_state_t *worker = pool->workers[i];
+        int create_result = worker_placement_create_thread(&pool->placement, i, &worker->thread,
+                                                           worker_thread_function, (void *)worker);
+        if (create_result != 0) {
+            TPOOL_ERROR("未能为线程池 %p 创建工作线程 #%d: %s", (void *)pool, i, strerror(create_result));
+            // perror("pthread_create");
+            // 通知已创建的线程停止并连接它们；线程可能已在休眠，必须显式唤醒
+            pthread_mutex_lock(&pool->lock);
+            pool->shutdown = 1;
+            pool_wake_all_locked(pool);
+            pthread_mutex_unlock(&pool->lock);
+            worker_threads_join_all(pool);
+
+            // 释放所有已分配的资源
+            latency_levels_destroy(pool->latency);
+            free(pool->node_worker_count);
+            free(pool->node_queues);
+            worker_placement_destroy(&pool->placement);
+            ws_workers_destroy(pool);
+            deadline_heap_destroy(&pool->deadline_heap);
+            task_index_destroy(&pool->name_index);
+            task_index_destroy(&pool->id_index);
+            task_slab_destroy(&pool->task_slab);
+            worker_states_destroy(pool);
+            pthread_cond_destroy(&pool->timer_cond);
+            pthread_cond_destroy(&pool->reserved_space_cond);
+            pthread_cond_destroy(&pool->space_cond);
+            pthread_mutex_destroy(&pool->resize_lock);
+            pthread_mutex_destroy(&pool->lock);
+            free(pool);
+            return NULL;
+        }
+        worker->joinable = 1;
+        pthread_mutex_lock(&pool->lock);
+        worker_node_attach_locked(pool, worker);
+        pthread_mutex_unlock(&pool->lock);
+        TPOOL_DEBUG("已为线程池 %p 成功创建工作线程 #%d。", (void *)pool, i);
+        pool->started++; // 增加成功启动的线程计数
+    }
+    TPOOL_LOG("线程池 %p 已成功创建，包含 %d 个线程。", (void *)pool, pool->started);
+    return pool;
+}
+
+/**
+ * @brief 在持有池锁时取得任务节点并登记到任务索引中 (内部函数)。
+ *
+ * 生成任务名称、检查名称是否重复、预留索引空间并取得节点，填好任务数据后登记到任务索引。
+ * 任一步失败都不会留下部分状态。节点尚未进入任何队列，由调用者决定放入运行队列还是时间轮。
+ * task_name 为 task_anonymous_name 时跳过所有名称相关的步骤，节点只登记到ID索引中，
+ * 也不写入节点的名称字段。
+ *
+ * @param pool 指向 thread_pool_s 实例的指针。调用者必须持有池的锁且池未关闭。
+ * @param function 任务函数，不能为空。
+ * @param arg 任务参数。
+ * @param task_name 任务名称，为 NULL 时生成包含任务ID的唯一名称，为 task_anonymous_name 时登记为匿名任务。
+ * @param priority 任务优先级。
+ * @param task_id 已分配给该任务的ID。
+ * @param future 要登记到节点上的完成句柄，可以为 NULL。成功时节点接管调用者传入的这个引用。
+ * @return 已登记的节点，名称重复或内存分配失败返回 NULL。
+ */
+static task_node_t *task_register_locked(thread_pool_t pool, void (*function)(void *), void *arg,
+                                         const char *task_name, task_priority_t priority, task_id_t task_id,
+                                         task_future_t future)
+{
+    int anonymous = task_name == task_anonymous_name;
+    char actual_task_name[MAX_TASK_NAME_LEN];
+    uint32_t name_hash = 0;
+    if (!anonymous) {
+        // 未命名的任务使用包含ID的唯一名称
+        if (task_name != NULL) {
+            strncpy(actual_task_name, task_name, MAX_TASK_NAME_LEN - 1);
+            actual_task_name[MAX_TASK_NAME_LEN - 1] = '\0'; // 确保以空字符结尾
+        } else {
+            snprintf(actual_task_name, MAX_TASK_NAME_LEN, "unnamed_task_%lu", (unsigned long)task_id);
+            TPOOL_DEBUG("thread_pool_add_task: 任务未命名，自动生成名称 '%s'", actual_task_name);
+        }
+
+        // 通过名称索引检查任务名称是否已存在 (排队中或运行中)
+        name_hash = task_name_hash(actual_task_name);
+        if (task_index_find_name(&pool->name_index, actual_task_name, name_hash) != NULL) {
+            TPOOL_ERROR("thread_pool_add_task: 任务名称 '%s' 已存在于线程池 %p 中", 
+                      actual_task_name, (void *)pool);
+            return NULL;
+        }
+    }
+
+    // 预留索引空间并取得任务节点，任一步失败都不会留下部分状态
+    task_node_t *node = NULL;
+    if (task_index_reserve(&pool->id_index) != 0 ||
+        (!anonymous && task_index_reserve(&pool->name_index) != 0) || (node = task_node_alloc(pool)) == NULL) {
+        TPOOL_ERROR("thread_pool_add_task: 未能为任务 (ID: %lu) 分配任务节点或索引空间",
+                    (unsigned long)task_id);
+        return NULL;
+    }
+
+    // 准备任务数据
+    node->function = function;
+    node->arg = arg;
+    node->priority = priority; // 设置任务优先级
+    node->id = task_id;
+    node->anonymous = (unsigned char)anonymous;
+    node->name_hash = name_hash;
+    node->future = future;
+    node->result = NULL;
+    node->queue_node = -1;
+    node->timer_period = 0;
+    node->cancel_callback = NULL;
+    node->timer_slot = -1;
+    node->deadline_ns = 0;
+    node->deadline_index = -1;
+    atomic_store_explicit(&node->cancel_requested, 0, memory_order_relaxed);
+
+    task_index_insert(&pool->id_index, node);
+    if (!anonymous) {
+        memcpy(node->task_name, actual_task_name, MAX_TASK_NAME_LEN);
+        task_index_insert(&pool->name_index, node);
+    }
+    return node;
+}
+
+/**
+ * @brief 在持有池锁时登记并入队单个任务，不检查队列容量 (内部函数)。
+ *
+ * 登记任务 (见 task_register_locked) 后将节点加入运行队列：
+ * 工作窃取模式下由工作线程提交的任务进入该线程的本地队列，其余任务进入共享队列。
+ * 此函数不唤醒工作线程，由调用者根据提交的任务数量决定。
+ *
+ * @param pool 指向 thread_pool_s 实例的指针。调用者必须持有池的锁且池未关闭。
+ * @param function 任务函数，不能为空。
+ * @param arg 任务参数。
+ * @param task_name 任务名称，为 NULL 时生成包含任务ID的唯一名称。
+ * @param priority 任务优先级。
+ * @param task_id 已分配给该任务的ID。
+ * @param future 要登记到节点上的完成句柄，可以为 NULL。成功时节点接管调用者传入的这个引用。
+ * @param queue_node 任务进入的 NUMA 节点运行队列，-1 表示共享运行队列。调用者负责确认节点有效。
+ * @param local 不为 NULL 时，任务进入工作线程本地队列则设置为 1，否则设置为 0。
+ * @return 成功返回 0，名称重复或内存分配失败返回 -1。
+ */
+static int task_submit_admitted_locked(thread_pool_t pool, void (*function)(void *), void *arg,
+                                       const char *task_name, task_priority_t priority, task_id_t task_id,
+                                       task_future_t future, int queue_node, int *local)
+{
+    task_node_t *node = task_register_locked(pool, function, arg, task_name, priority, task_id, future);
+    if (node == NULL) {
+        return -1;
+    }
+    node->queue_node = queue_node;
+    task_stamp_enqueue(pool, node);
+
+    int pushed_local = queue_node < 0 && pool->scheduler == THREAD_POOL_SCHED_WORK_STEALING &&
+                       tls_worker.pool == pool &&
+                       ws_push_local_locked(pool, tls_worker.thread_id, node) == 0;
+    if (!pushed_local) {
+        task_enqueue_internal(pool, node);
+    }
+    if (local != NULL) {
+        *local = pushed_local;
+    }
+    stat_counter_inc_locked(&pool->tasks_submitted);
+    return 0;
+}
+
+/**
+ * @brief 在持有池锁时检查队列容量，然后登记并入队单个任务 (内部函数)。
+ *
+ * 参数与 task_submit_admitted_locked 相同。
+ *
+ * @return 成功返回 0，名称重复或内存分配失败返回 -1，队列已满返回 -2。
+ */
+static int task_submit_locked(thread_pool_t pool, void (*function)(void *), void *arg, const char *task_name,
+                              task_priority_t priority, task_id_t task_id, task_future_t future, int queue_node,
+                              int *local)
+{
+    if (!pool_queue_admits_locked(pool, priority)) {
+        pool_reject_locked(pool, priority);
+        return -2;
+    }
+    return task_submit_admitted_locked(pool, function, arg, task_name, priority, task_id, future, queue_node,
+                                       local);
+}
+
+/**
+ * @brief 队列已满时等待可以提交指定优先级的任务 (内部函数)。
+ *
+ * 可以使用保留槽位的提交者和普通提交者分别在两个条件变量上等待，
+ * 使腾出的槽位只唤醒能使用它的提交者。线程池关闭时返回，
+ * 并在最后一个等待者离开时通知 thread_pool_destroy。调用者必须持有池的锁。
+ *
+ * @param pool 指向 thread_pool_s 实例的指针。
+ * @param priority 任务优先级。
+ * @param timeout_ms 最长等待时间 (毫秒)，负数表示一直等待。
+ */
+static void pool_wait_for_space_locked(thread_pool_t pool, task_priority_t priority, int timeout_ms)
+{
+    int reserved = task_priority_level(priority) <= pool->queue_reserved_level;
+    pthread_cond_t *cond = reserved ? &pool->reserved_space_cond : &pool->space_cond;
+    int *waiters = reserved ? &pool->reserved_space_waiters : &pool->space_waiters;
+    struct timespec deadline_storage;
+    const struct timespec *deadline = monotonic_deadline(&deadline_storage, timeout_ms);
+
+    int timed_out = 0;
+    while (!pool->shutdown && !timed_out && !pool_queue_admits_locked(pool, priority)) {
+        (*waiters)++;
+        if (deadline == NULL) {
+            pthread_cond_wait(cond, &(pool->lock));
+        } else {
+            timed_out = pthread_cond_timedwait(cond, &(pool->lock), deadline) == ETIMEDOUT;
+        }
+        (*waiters)--;
+    }
+    if (pool->shutdown) {
+        if (pool->space_waiters == 0 && pool->reserved_space_waiters == 0) {
+            pthread_cond_broadcast(&pool->space_cond);
+        }
+    } else if (timed_out && !pool_queue_admits_locked(pool, priority)) {
+        // 超时的同时可能收到了唤醒，把它转交给下一个能使用空位的等待者
+        pool_space_released_locked(pool, 1);
+    }
+}
+
+task_id_t thread_pool_add_task_timeout(thread_pool_t pool, void (*function)(void *), void *arg,
+                                       const char *task_name, task_priority_t priority, int timeout_ms)
+{
+    if (pool == NULL || function == NULL) {
+        TPOOL_ERROR("thread_pool_add_task: 无效参数 (pool: %p, function: %s)", (void *)pool,
+                    function == NULL ? "NULL" : "非空");
+        return 0; // 返回无效任务ID
+    }
+
+    pthread_mutex_lock(&(pool->lock));
+
+    // 队列已满时等待空位；工作线程自身不等待，避免所有工作线程都阻塞在提交上
+    if (!pool->shutdown && timeout_ms != 0 && tls_worker.pool != pool &&
+        !pool_queue_admits_locked(pool, priority)) {
+        pool_wait_for_space_locked(pool, priority, timeout_ms);
+    }
+
+    if (pool->shutdown) {
+        TPOOL_ERROR("thread_pool_add_task: 尝试向正在关闭的线程池 %p 添加任务", (void *)pool);
+        pthread_mutex_unlock(&(pool->lock));
+        return 0; // 返回无效任务ID
+    }
+
+    // 队列仍然已满时直接拒绝，不消耗任务ID
+    if (!pool_queue_admits_locked(pool, priority)) {
+        pool_reject_locked(pool, priority);
+        pthread_mutex_unlock(&(pool->lock));
+        return 0;
+    }
+
+    // 分配唯一任务ID
+    task_id_t new_task_id = pool->next_task_id++;
+    if (task_submit_locked(pool, function, arg, task_name, priority, new_task_id, NULL, -1, NULL) != 0) {
+        pthread_mutex_unlock(&(pool->lock));
+        return 0; // 返回无效任务ID
+    }
+
+    // 唤醒一个休眠的工作线程 (本地队列中的任务由它窃取)；没有休眠线程时忙碌的线程会在任务边界取走任务
+    pool_wake_idle_locked(pool, 1);
+    pthread_mutex_unlock(&(pool->lock));
+    
+    // 如果启用了自动调整，则向自动调整线程发送信号
+    if (pool->auto_adjust) {
+        pthread_mutex_lock(&pool->adjust_cond_lock);
+        pthread_cond_signal(&pool->adjust_cond);
+        pthread_mutex_unlock(&pool->adjust_cond_lock);
+    }
+
+    TPOOL_DEBUG("任务 (ID: %lu) 已添加到线程池 %p。已通知工作线程。", (unsigned long)new_task_id,
+               (void *)pool);
+    return new_task_id; // 返回分配的任务ID
+}
+
+/**
+ * @brief向线程池的队列中添加一个新任务。
+ *
+ * 该任务将被一个可用的工作线程拾取以执行。队列已满时阻塞直到有空位。
+ *
+ * @param pool 指向 thread_pool_t 实例的指针。
+ * @param function 指向定义任务的函数的指针。不能为空。
+ * @param arg 要传递给任务函数的参数。如果函数期望，可以为 NULL。
+ * @param task_name 任务的描述性名称。如果为 NULL，将使用 "unnamed_task"。
+ *                  该名称被复制到任务结构中。
+ * @param priority 任务的优先级，决定执行顺序。默认为 TASK_PRIORITY_NORMAL。
+ * @return 成功时返回分配的任务ID（大于0的值），错误时返回0（无效任务ID）。
+ *         错误情况包括：pool为NULL，function为NULL，池正在关闭，
+ *         任务节点的内存分配失败等。
+ */
+task_id_t thread_pool_add_task(thread_pool_t pool, void (*function)(void *), void *arg,
+                         const char *task_name, task_priority_t priority)
+{
+    return thread_pool_add_task_timeout(pool, function, arg, task_name, priority, -1);
+}
+
+task_id_t thread_pool_try_add_task(thread_pool_t pool, void (*function)(void *), void *arg,
+                                   const char *task_name, task_priority_t priority)
+{
+    return thread_pool_add_task_timeout(pool, function, arg, task_name, priority, 0);
+}
+
+task_id_t thread_pool_add_anonymous_task(thread_pool_t pool, void (*function)(void *), void *arg,
+                                         task_priority_t priority)
+{
+    return thread_pool_add_task_timeout(pool, function, arg, task_anonymous_name, priority, -1);
+}
+
+task_id_t thread_pool_add_task_on_node(thread_pool_t pool, void (*function)(void *), void *arg,
+                                       const char *task_name, task_priority_t priority, int numa_node)
+{
+    if (pool == NULL || function == NULL) {
+        TPOOL_ERROR("thread_pool_add_task_on_node: 无效参数 (pool: %p, function: %s)", (void *)pool,
+                    function == NULL ? "NULL" : "非空");
+        return 0;
+    }
+
+    pthread_mutex_lock(&(pool->lock));
+    if (pool->shutdown) {
+        TPOOL_ERROR("thread_pool_add_task_on_node: 尝试向正在关闭的线程池 %p 添加任务", (void *)pool);
+        pthread_mutex_unlock(&(pool->lock));
+        return 0;
+    }
+
+    // 节点无效或节点上没有工作线程时退回共享队列
+    int queue_node = -1;
+    if (pool->node_queues != NULL && numa_node >= 0 && numa_node < pool->placement.max_node &&
+        pool->node_worker_count[numa_node] > 0) {
+        queue_node = numa_node;
+    } else if (numa_node >= 0) {
+        TPOOL_DEBUG("thread_pool_add_task_on_node: 线程池 %p 没有归属节点 %d 的工作线程，任务进入共享队列",
+                  (void *)pool, numa_node);
     }
 
-    if (pthread_cond_init(&pool->notify, NULL) != 0) {
-        TPOOL_ERROR("未能为线程池 %p 初始化条件变量。", (void *)pool);
-        // perror("pthread_cond_init");
-        pthread_mutex_destroy(&pool->resize_lock); // 清理已成功初始化的调整大小互斥锁
-        pthread_mutex_destroy(&pool->lock);        // 清理已成功初始化的互斥锁
-        free(pool);
-        return NULL;
+    task_id_t new_task_id = pool->next_task_id++;
+    if (task_submit_locked(pool, function, arg, task_name, priority, new_task_id, NULL, queue_node, NULL) != 0) {
+        pthread_mutex_unlock(&(pool->lock));
+        return 0;
     }
-
-    // 为线程 ID 分配数组
-    pool->threads = (pthread_t *)malloc(sizeof(pthread_t) * num_threads);
-    if (pool->threads == NULL) {
-        TPOOL_ERROR("未能为线程池 %p 的线程数组分配内存。", (void *)pool);
-        // perror("malloc for pool->threads");
-        pthread_mutex_destroy(&pool->resize_lock);
-        pthread_mutex_destroy(&pool->lock);
-        pthread_cond_destroy(&pool->notify);
-        free(pool);
-        return NULL;
+    if (queue_node >= 0) {
+        pool_wake_node_locked(pool, queue_node);
+    } else {
+        pool_wake_idle_locked(pool, 1);
     }
+    pthread_mutex_unlock(&(pool->lock));
 
-    // 为线程状态分配数组
-    pool->thread_status = (int *)calloc(num_threads, sizeof(int));
-    if (pool->thread_status == NULL) {
-        TPOOL_ERROR("未能为线程池 %p 的线程状态数组分配内存。", (void *)pool);
-        free(pool->threads);
-        pthread_mutex_destroy(&pool->resize_lock);
-        pthread_mutex_destroy(&pool->lock);
-        pthread_cond_destroy(&pool->notify);
-        free(pool);
-        return NULL;
+    if (pool->auto_adjust) {
+        pthread_mutex_lock(&pool->adjust_cond_lock);
+        pthread_cond_signal(&pool->adjust_cond);
+        pthread_mutex_unlock(&pool->adjust_cond_lock);
     }
-    
-    // 为运行中任务ID分配数组
-    pool->running_task_ids = (task_id_t *)calloc(num_threads, sizeof(task_id_t));
-    if (pool->running_task_ids == NULL) {
-        TPOOL_ERROR("未能为线程池 %p 的运行中任务ID数组分配内存。", (void *)pool);
-        free(pool->thread_status);
-        free(pool->threads);
-        pthread_mutex_destroy(&pool->resize_lock);
-        pthread_mutex_destroy(&pool->lock);
-        pthread_cond_destroy(&pool->notify);
-        free(pool);
-        return NULL;
+
+    TPOOL_DEBUG("任务 (ID: %lu) 已添加到线程池 %p 的节点 %d 队列。", (unsigned long)new_task_id, (void *)pool,
+              queue_node);
+    return new_task_id;
+}
+
+task_id_t thread_pool_add_task_with_deadline(thread_pool_t pool, void (*function)(void *), void *arg,
+                                             const char *task_name, task_priority_t priority,
+                                             unsigned int deadline_ms)
+{
+    if (pool == NULL || function == NULL) {
+        TPOOL_ERROR("thread_pool_add_task_with_deadline: 无效参数 (pool: %p, function: %s)", (void *)pool,
+                    function == NULL ? "NULL" : "非空");
+        return 0;
     }
 
-    // 初始化线程状态为1（忙碌），因为线程创建后将立即开始工作
-    for (int i = 0; i < num_threads; i++) {
-        pool->thread_status[i] = 1;
+    pthread_mutex_lock(&(pool->lock));
+    if (pool->shutdown) {
+        TPOOL_ERROR("thread_pool_add_task_with_deadline: 尝试向正在关闭的线程池 %p 添加任务", (void *)pool);
+        pthread_mutex_unlock(&(pool->lock));
+        return 0;
+    }
+    if (!pool_queue_admits_locked(pool, priority)) {
+        pool_reject_locked(pool, priority);
+        pthread_mutex_unlock(&(pool->lock));
+        return 0;
+    }
+    // 先预留堆空间，使入队本身不会失败
+    if (deadline_heap_reserve(&pool->deadline_heap) != 0) {
+        pthread_mutex_unlock(&(pool->lock));
+        return 0;
     }
 
-    // 为正在运行的任务名称分配数组
-    pool->running_task_names = (char **)malloc(sizeof(char *) * num_threads);
-    if (pool->running_task_names == NULL) {
-        TPOOL_ERROR("未能为线程池 %p 的 running_task_names 数组分配内存。", (void *)pool);
-        // perror("malloc for pool->running_task_names");
-        free(pool->threads);
-        pthread_mutex_destroy(&pool->lock);
-        pthread_cond_destroy(&pool->notify);
-        free(pool);
-        return NULL;
+    task_id_t new_task_id = pool->next_task_id++;
+    task_node_t *node = task_register_locked(pool, function, arg, task_name, priority, new_task_id, NULL);
+    if (node == NULL) {
+        pthread_mutex_unlock(&(pool->lock));
+        return 0;
     }
+    // 带截止时间的任务总是进入共享运行队列，按截止时间先后出队
+    uint64_t now = latency_now_ns();
+    node->deadline_ns = now + (uint64_t)deadline_ms * UINT64_C(1000000);
+    if (pool->latency != NULL || pool->aging_ns != 0) {
+        node->enqueue_ns = now;
+    }
+    task_enqueue_internal(pool, node);
+    stat_counter_inc_locked(&pool->tasks_submitted);
+    pool_wake_idle_locked(pool, 1);
+    pthread_mutex_unlock(&(pool->lock));
 
-    // 为每个正在运行的任务名称分配单独的字符串并初始化为 "[idle]"
-    for (int i = 0; i < num_threads; ++i) {
-        pool->running_task_names[i] = (char *)malloc(MAX_TASK_NAME_LEN);
-        if (pool->running_task_names[i] == NULL) {
-            TPOOL_ERROR("未能为线程池 %p 的 running_task_name 字符串 #%d 分配内存。", i,
-                        (void *)pool);
-            // perror("malloc for pool->running_task_names[i]");
-            // 清理先前分配的名称字符串
-            for (int j = 0; j < i; ++j) {
-                free(pool->running_task_names[j]);
-            }
-            free(pool->running_task_names);
-            free(pool->threads);
-            pthread_mutex_destroy(&pool->lock);
-            pthread_cond_destroy(&pool->notify);
-            free(pool);
-            return NULL;
-        }
-        strncpy(pool->running_task_names[i], "[idle]", MAX_TASK_NAME_LEN - 1);
-        pool->running_task_names[i][MAX_TASK_NAME_LEN - 1] = '\0'; // 确保空终止
+    if (pool->auto_adjust) {
+        pthread_mutex_lock(&pool->adjust_cond_lock);
+        pthread_cond_signal(&pool->adjust_cond);
+        pthread_mutex_unlock(&pool->adjust_cond_lock);
     }
 
-    // 创建工作线程
-    for (int i = 0; i < num_threads; ++i) {
-        thread_args_t *args = (thread_args_t *)malloc(sizeof(thread_args_t));
-        if (args == NULL) {
-            TPOOL_ERROR("未能为线程池 %p 的线程 #%d 分配线程参数内存。", i, (void *)pool);
-            // 这是一个严重错误；尝试优雅地关闭已创建的资源。
-            pool->shutdown = 1; // 通知任何可能（但此时不太可能）正在运行的线程停止
-            // 连接任何可能在先前迭代中成功创建的线程（如果这是第一次失败则不太可能）
-            for (int k = 0; k < i; ++k) {
-                pthread_join(pool->threads[k], NULL); // 此处为简洁起见省略了对 join 的错误检查
-            }
+    TPOOL_DEBUG("任务 (ID: %lu) 已添加到线程池 %p，截止时间为 %u 毫秒后。", (unsigned long)new_task_id,
+              (void *)pool, deadline_ms);
+    return new_task_id;
+}
 
-            // 释放所有已分配的资源
-            for (int j = 0; j < num_threads; ++j) { // 如果已分配，则释放所有名称槽
-                if (pool->running_task_names[j]) {
-                    free(pool->running_task_names[j]);
-                }
-            }
-            free(pool->running_task_names);
-            free(pool->running_task_ids);
-            free(pool->thread_status);
-            free(pool->threads);
-            pthread_mutex_destroy(&pool->lock);
-            pthread_cond_destroy(&pool->notify);
-            free(pool);
-            return NULL;
-        }
-        args->pool = pool; // 传递不透明的池指针
-        args->thread_id = i;
+/**
+ * @brief 定时器线程的主函数 (内部函数)。
+ *
+ * 推进时间轮，把到期的节点放入共享运行队列并唤醒相应数量的休眠线程，
+ * 然后睡眠到下一个需要处理的刻度；时间轮为空时无限等待，直到有新的定时器或线程池关闭。
+ *
+ * @param arg 指向 thread_pool_s 实例的指针。
+ * @return 总是返回 NULL。
+ */
+static void *timer_thread_function(void *arg)
+{
+    thread_pool_t pool = (thread_pool_t)arg;
 
-        if (pthread_create(&(pool->threads[i]), NULL, worker_thread_function, (void *)args) != 0) {
-            TPOOL_ERROR("未能为线程池 %p 创建工作线程 #%d。", i, (void *)pool);
-            // perror("pthread_create");
-            free(args);         // 释放失败线程的参数
-            pool->shutdown = 1; // 通知其他线程停止
-            // 连接成功创建的线程
-            for (int k = 0; k < i; ++k) {
-                pthread_join(pool->threads[k], NULL);
-            }
+    pthread_mutex_lock(&(pool->lock));
+    while (!pool->shutdown) {
+        uint64_t now = timer_now_tick();
+        task_node_t *node = timer_wheel_advance(&pool->timer_wheel, now);
+        int released = 0;
+        while (node != NULL) {
+            task_node_t *next = node->next;
+            task_stamp_enqueue(pool, node);
+            task_enqueue_internal(pool, node);
+            stat_counter_inc_locked(&pool->tasks_submitted);
+            released++;
+            node = next;
+        }
+        if (released > 0) {
+            pool_wake_idle_locked(pool, released);
+            TPOOL_DEBUG("线程池 %p: 定时器线程释放了 %d 个到期任务", (void *)pool, released);
+        }
 
-            for (int j = 0; j < num_threads; ++j) {
-                if (pool->running_task_names[j]) {
-                    free(pool->running_task_names[j]);
-                }
-            }
-            free(pool->running_task_names);
-            free(pool->running_task_ids);
-            free(pool->thread_status);
-            free(pool->threads);
-            pthread_mutex_destroy(&pool->lock);
-            pthread_cond_destroy(&pool->notify);
-            free(pool);
-            return NULL;
+        pool->timer_wake_tick = timer_wheel_next_tick(&pool->timer_wheel);
+        if (pool->timer_wake_tick == UINT64_MAX) {
+            pthread_cond_wait(&pool->timer_cond, &(pool->lock));
+        } else {
+            struct timespec deadline = {
+                .tv_sec = (time_t)(pool->timer_wake_tick / 1000),
+                .tv_nsec = (long)(pool->timer_wake_tick % 1000) * 1000000L,
+            };
+            pthread_cond_timedwait(&pool->timer_cond, &(pool->lock), &deadline);
         }
-        TPOOL_DEBUG("已为线程池 %p 成功创建工作线程 #%d。", (void *)pool, i);
-        pool->started++; // 增加成功启动的线程计数
     }
-    TPOOL_LOG("线程池 %p 已成功创建，包含 %d 个线程。", (void *)pool, pool->started);
-    return pool;
+    pthread_mutex_unlock(&(pool->lock));
+    return NULL;
 }
 
 /**
- * @brief向线程池的队列中添加一个新任务。
+ * @brief 登记一个延迟或周期任务并放入时间轮 (内部函数)。
  *
- * 该任务将被一个可用的工作线程拾取以执行。
+ * 首次调用时创建定时器线程。任务到期前不计入队列长度，也不受 queue_capacity 限制；
+ * 到期后进入共享运行队列，与普通任务一样按优先级调度。
  *
- * @param pool 指向 thread_pool_t 实例的指针。
- * @param function 指向定义任务的函数的指针。不能为空。
- * @param arg 要传递给任务函数的参数。如果函数期望，可以为 NULL。
- * @param task_name 任务的描述性名称。如果为 NULL，将使用 "unnamed_task"。
- *                  该名称被复制到任务结构中。
- * @param priority 任务的优先级，决定执行顺序。默认为 TASK_PRIORITY_NORMAL。
- * @return 成功时返回分配的任务ID（大于0的值），错误时返回0（无效任务ID）。
- *         错误情况包括：pool为NULL，function为NULL，池正在关闭，
- *         任务节点的内存分配失败等。
+ * @param pool 指向 thread_pool_s 实例的指针。
+ * @param function 任务函数。
+ * @param arg 任务参数。
+ * @param task_name 任务名称，为 NULL 时自动生成。
+ * @param priority 到期后进入运行队列时使用的优先级。
+ * @param delay_ms 首次执行前的延迟 (毫秒)。
+ * @param period_ms 周期 (毫秒)，0 表示只执行一次。
+ * @return 成功时返回任务ID，失败时返回0。
  */
-task_id_t thread_pool_add_task(thread_pool_t pool, void (*function)(void *), void *arg,
-                         const char *task_name, task_priority_t priority)
+static task_id_t timer_task_add(thread_pool_t pool, void (*function)(void *), void *arg, const char *task_name,
+                                task_priority_t priority, unsigned int delay_ms, unsigned int period_ms)
+{
+    // 向上取整到毫秒刻度，保证实际延迟不短于 delay_ms
+    uint64_t expire = (latency_now_ns() + (uint64_t)delay_ms * UINT64_C(1000000) + UINT64_C(999999)) /
+                      UINT64_C(1000000);
+
+    pthread_mutex_lock(&(pool->lock));
+    if (pool->shutdown) {
+        TPOOL_ERROR("thread_pool_add_delayed_task: 尝试向正在关闭的线程池 %p 添加任务", (void *)pool);
+        pthread_mutex_unlock(&(pool->lock));
+        return 0;
+    }
+
+    if (!pool->timer_started) {
+        int create_result = pthread_create(&pool->timer_thread, NULL, timer_thread_function, (void *)pool);
+        if (create_result != 0) {
+            TPOOL_ERROR("未能为线程池 %p 创建定时器线程: %s", (void *)pool, strerror(create_result));
+            pthread_mutex_unlock(&(pool->lock));
+            return 0;
+        }
+        pool->timer_started = 1;
+    }
+
+    task_id_t new_task_id = pool->next_task_id++;
+    task_node_t *node = task_register_locked(pool, function, arg, task_name, priority, new_task_id, NULL);
+    if (node == NULL) {
+        pthread_mutex_unlock(&(pool->lock));
+        return 0;
+    }
+    node->timer_period = period_ms;
+    timer_arm_locked(pool, node, expire);
+    pthread_mutex_unlock(&(pool->lock));
+
+    TPOOL_DEBUG("任务 (ID: %lu) 已加入线程池 %p 的时间轮，延迟 %u 毫秒，周期 %u 毫秒。",
+              (unsigned long)new_task_id, (void *)pool, delay_ms, period_ms);
+    return new_task_id;
+}
+
+task_id_t thread_pool_add_delayed_task(thread_pool_t pool, void (*function)(void *), void *arg,
+                                       const char *task_name, task_priority_t priority, unsigned int delay_ms)
 {
     if (pool == NULL || function == NULL) {
-        TPOOL_ERROR("thread_pool_add_task: 无效参数 (pool: %p, function: %p)", (void *)pool,
-                    (void *)function);
-        return 0; // 返回无效任务ID
+        TPOOL_ERROR("thread_pool_add_delayed_task: 无效参数 (pool: %p, function: %s)", (void *)pool,
+                    function == NULL ? "NULL" : "非空");
+        return 0;
     }
+    return timer_task_add(pool, function, arg, task_name, priority, delay_ms, 0);
+}
 
-    // 先锁住任务名称映射锁，检查任务名称是否已存在
-    pthread_mutex_lock(&(pool->name_map_lock));
-    
-    // 准备任务名称
-    char actual_task_name[MAX_TASK_NAME_LEN];
-    
-    // 预先分配任务ID，用于生成唯一名称
-    task_id_t new_task_id = pool->next_task_id++; // 分配唯一任务ID并递增计数器
-    
-    if (task_name == NULL) {
-        // 如果没有提供名称，生成包含任务ID的唯一名称
-        snprintf(actual_task_name, MAX_TASK_NAME_LEN - 1, "unnamed_task_%lu", (unsigned long)new_task_id);
-        TPOOL_DEBUG("thread_pool_add_task: 任务未命名，自动生成名称 '%s'", actual_task_name);
-    } else {
-        strncpy(actual_task_name, task_name, MAX_TASK_NAME_LEN - 1);
+task_id_t thread_pool_add_periodic_task(thread_pool_t pool, void (*function)(void *), void *arg,
+                                        const char *task_name, task_priority_t priority,
+                                        unsigned int initial_delay_ms, unsigned int period_ms)
+{
+    if (pool == NULL || function == NULL || period_ms == 0) {
+        TPOOL_ERROR("thread_pool_add_periodic_task: 无效参数 (pool: %p, function: %s, period_ms: %u)",
+                    (void *)pool, function == NULL ? "NULL" : "非空", period_ms);
+        return 0;
     }
-    actual_task_name[MAX_TASK_NAME_LEN - 1] = '\0'; // 确保以空字符结尾
-    
-    // 检查任务名称是否已存在
-    for (int i = 0; i < pool->task_name_map_size; i++) {
-        if (strcmp(pool->task_name_map[i].task_name, actual_task_name) == 0) {
-            TPOOL_ERROR("thread_pool_add_task: 任务名称 '%s' 已存在于线程池 %p 中", 
-                      actual_task_name, (void *)pool);
-            pthread_mutex_unlock(&(pool->name_map_lock));
-            return 0; // 返回无效任务ID
-        }
+    return timer_task_add(pool, function, arg, task_name, priority, initial_delay_ms, period_ms);
+}
+
+/**
+ * @brief 在一次加锁内向线程池批量添加任务。
+ *
+ * 整批任务共享一段连续的任务ID，并在同一临界区内入队。
+ * 入队完成后从空闲栈中唤醒最多与新任务数量相同的休眠线程，
+ * 而不是每个任务发送一次信号。单个条目失败不回滚其他条目。
+ *
+ * @param pool 指向 thread_pool_t 实例的指针。
+ * @param tasks 任务条目数组。count 为 0 时可以为 NULL。
+ * @param count 条目数量，不能为负数。
+ * @param task_ids 如果不为 NULL，第 i 项被设置为条目 i 的任务ID，条目失败时设置为 0。
+ * @return 成功入队的条目数量；pool 为 NULL、参数无效或池正在关闭时返回 -1。
+ */
+int thread_pool_add_tasks(thread_pool_t pool, const thread_pool_task_spec_t *tasks, int count,
+                          task_id_t *task_ids)
+{
+    if (pool == NULL || count < 0 || (tasks == NULL && count > 0)) {
+        TPOOL_ERROR("thread_pool_add_tasks: 无效参数 (pool: %p, tasks: %p, count: %d)", (void *)pool,
+                    (const void *)tasks, count);
+        return -1;
     }
-    
+
     pthread_mutex_lock(&(pool->lock));
 
     if (pool->shutdown) {
-        TPOOL_ERROR("thread_pool_add_task: 尝试向正在关闭的线程池 %p 添加任务", (void *)pool);
+        TPOOL_ERROR("thread_pool_add_tasks: 尝试向正在关闭的线程池 %p 添加任务", (void *)pool);
         pthread_mutex_unlock(&(pool->lock));
-        pthread_mutex_unlock(&(pool->name_map_lock));
-        return 0; // 返回无效任务ID
+        return -1;
     }
 
-    // 准备任务数据
-    task_t task;
-    task.function = function;
-    task.arg = arg;
-    task.priority = priority; // 设置任务优先级
-    task.id = new_task_id; // 使用预先分配的任务ID
-
-    // 使用前面准备好的任务名称
-    strncpy(task.task_name, actual_task_name, MAX_TASK_NAME_LEN - 1);
-    task.task_name[MAX_TASK_NAME_LEN - 1] = '\0'; // 确保以空字符结尾
-
-    // 将任务添加到队列
-    int result = task_enqueue_internal(pool, task);
-    if (result == 0) {
-        // 任务入队成功，添加任务名称到任务ID的映射
-        // 检查是否需要扩展映射数组
-        if (pool->task_name_map_size >= pool->task_name_map_capacity) {
-            // 需要扩展映射数组
-            int new_capacity = pool->task_name_map_capacity == 0 ? 16 : pool->task_name_map_capacity * 2;
-            void *new_map = realloc(pool->task_name_map, new_capacity * sizeof(*pool->task_name_map));
-            if (new_map == NULL) {
-                // 内存分配失败，但任务已经添加到队列，所以只记录日志
-                TPOOL_ERROR("thread_pool_add_task: 为任务名称映射数组分配内存失败");
-                pthread_mutex_unlock(&(pool->lock));
-                pthread_mutex_unlock(&(pool->name_map_lock));
-                return new_task_id; // 返回预先分配的任务ID
-            }
-            pool->task_name_map = new_map;
-            pool->task_name_map_capacity = new_capacity;
+    // 为整批任务分配连续的任务ID，失败条目的ID不再复用
+    task_id_t first_task_id = pool->next_task_id;
+    pool->next_task_id += (task_id_t)count;
+
+    int added = 0;
+    for (int i = 0; i < count; i++) {
+        const thread_pool_task_spec_t *spec = &tasks[i];
+        task_id_t task_id = first_task_id + (task_id_t)i;
+        if (spec->function == NULL) {
+            TPOOL_ERROR("thread_pool_add_tasks: 条目 #%d 的任务函数为 NULL", i);
+            task_id = 0;
+        } else if (task_submit_locked(pool, spec->function, spec->arg, spec->task_name, spec->priority,
+                                      task_id, NULL, -1, NULL) != 0) {
+            task_id = 0;
+        } else {
+            added++;
+        }
+        if (task_ids != NULL) {
+            task_ids[i] = task_id;
         }
-        
-        // 添加新的映射
-        strncpy(pool->task_name_map[pool->task_name_map_size].task_name, actual_task_name, MAX_TASK_NAME_LEN - 1);
-        pool->task_name_map[pool->task_name_map_size].task_name[MAX_TASK_NAME_LEN - 1] = '\0';
-        pool->task_name_map[pool->task_name_map_size].task_id = new_task_id;
-        pool->task_name_map_size++;
-        
-        TPOOL_DEBUG("thread_pool_add_task: 添加任务名称 '%s' 到任务ID %lu 的映射", 
-                  actual_task_name, (unsigned long)new_task_id);
-                  
-        // 通知一个等待的工作线程有新任务
-        pthread_cond_signal(&(pool->notify));
-    } else {
-        // 如果入队失败，返回无效任务ID
-        new_task_id = 0;
     }
 
-    // 释放锁以避免死锁
+    // 只唤醒需要的工作线程数量
+    int wake = pool_wake_idle_locked(pool, added);
     pthread_mutex_unlock(&(pool->lock));
-    pthread_mutex_unlock(&(pool->name_map_lock));
-    
-    // 如果启用了自动调整，则向自动调整线程发送信号
-    if (pool->auto_adjust) {
+
+    if (added > 0 && pool->auto_adjust) {
         pthread_mutex_lock(&pool->adjust_cond_lock);
         pthread_cond_signal(&pool->adjust_cond);
         pthread_mutex_unlock(&pool->adjust_cond_lock);
     }
 
-    TPOOL_DEBUG("任务 '%s' (ID: %lu) 已添加到线程池 %p。已通知工作线程。", 
-               task.task_name, (unsigned long)new_task_id, (void *)pool);
-    return new_task_id; // 返回分配的任务ID
+    TPOOL_DEBUG("thread_pool_add_tasks: 线程池 %p 批量添加 %d/%d 个任务 (起始ID: %lu)，唤醒 %d 个线程。",
+              (void *)pool, added, count, (unsigned long)first_task_id, wake);
+    return added;
+}
+
+task_id_t pool_reserve_task_ids(thread_pool_t pool, int count)
+{
+    pthread_mutex_lock(&(pool->lock));
+    task_id_t first_task_id = 0;
+    if (!pool->shutdown) {
+        first_task_id = pool->next_task_id;
+        pool->next_task_id += (task_id_t)count;
+    }
+    pthread_mutex_unlock(&(pool->lock));
+    return first_task_id;
+}
+
+int pool_submit_with_ids(thread_pool_t pool, const thread_pool_task_spec_t *tasks, const task_id_t *task_ids,
+                         int count, int *results)
+{
+    pthread_mutex_lock(&(pool->lock));
+    int added = 0;
+    for (int i = 0; i < count; i++) {
+        const thread_pool_task_spec_t *spec = &tasks[i];
+        results[i] = pool->shutdown ? -1
+                                    : task_submit_admitted_locked(pool, spec->function, spec->arg, spec->task_name,
+                                                                  spec->priority, task_ids[i], NULL, -1, NULL);
+        if (results[i] == 0) {
+            added++;
+        }
+    }
+    pool_wake_idle_locked(pool, added);
+    pthread_mutex_unlock(&(pool->lock));
+
+    if (added > 0 && pool->auto_adjust) {
+        pthread_mutex_lock(&pool->adjust_cond_lock);
+        pthread_cond_signal(&pool->adjust_cond);
+        pthread_mutex_unlock(&pool->adjust_cond_lock);
+    }
+    return added;
 }
 
 /**
@@ -975,6 +2885,21 @@ task_id_t thread_pool_add_task_default(thread_pool_t pool, void (*function)(void
  * @return 成功时返回 0，如果池指针为 NULL 则返回 -1。如果池
  *         已在关闭或已销毁，则可能返回 0 作为无操作。
  */
+/**
+ * @brief 保存速率策略的参数并清空采样状态 (内部函数)。
+ *
+ * 调用者必须持有池的锁。
+ */
+static void auto_adjust_apply_policy_locked(thread_pool_t pool, const thread_pool_adjust_config_t *config)
+{
+    pool->adjust_policy = config->policy;
+    pool->adjust_target_wait_us = config->target_queue_wait_us;
+    pool->adjust_ewma_weight = config->ewma_weight_percent;
+    pool->adjust_hysteresis = config->hysteresis_percent;
+    pool->adjust_cooldown_ms = config->cooldown_ms;
+    memset(&pool->adjust_rate, 0, sizeof(pool->adjust_rate));
+}
+
 /**
  * @brief 启用线程池自动动态调整功能
  *
@@ -994,10 +2919,52 @@ task_id_t thread_pool_add_task_default(thread_pool_t pool, void (*function)(void
 int thread_pool_enable_auto_adjust(thread_pool_t pool, int high_watermark, int low_watermark,
                                    int adjust_interval)
 {
-    if (pool == NULL) {
-        TPOOL_ERROR("thread_pool_enable_auto_adjust: 池为 NULL。");
+    thread_pool_adjust_config_t config;
+    thread_pool_adjust_config_init(&config);
+    config.high_watermark = high_watermark;
+    config.low_watermark = low_watermark;
+    config.adjust_interval = adjust_interval;
+    return thread_pool_enable_auto_adjust_with_config(pool, &config);
+}
+
+/**
+ * @brief 使用默认值初始化自动调整选项。
+ *
+ * @param config 要初始化的选项结构。为 NULL 时不执行任何操作。
+ */
+void thread_pool_adjust_config_init(thread_pool_adjust_config_t *config)
+{
+    if (config == NULL) {
+        return;
+    }
+    config->policy = THREAD_POOL_ADJUST_WATERMARK;
+    config->high_watermark = 1;
+    config->low_watermark = 1;
+    config->adjust_interval = 1000;
+    config->target_queue_wait_us = 10000;
+    config->ewma_weight_percent = 30;
+    config->hysteresis_percent = 25;
+    config->cooldown_ms = 5000;
+}
+
+/**
+ * @brief 按照指定选项启用线程池自动调整功能。
+ *
+ * 已启用时更新参数和策略，并清空速率策略的采样状态。
+ *
+ * @param pool 指向线程池实例的指针。
+ * @param config 自动调整选项。
+ * @return 成功返回0，失败返回-1（例如，pool为NULL，参数无效，或池内min/max线程数未正确设置）。
+ */
+int thread_pool_enable_auto_adjust_with_config(thread_pool_t pool, const thread_pool_adjust_config_t *config)
+{
+    if (pool == NULL || config == NULL) {
+        TPOOL_ERROR("thread_pool_enable_auto_adjust: 池或选项为 NULL。");
         return -1;
     }
+    int high_watermark = config->high_watermark;
+    int low_watermark = config->low_watermark;
+    int adjust_interval = config->adjust_interval;
 
     // 检查池中预设的 min_threads 和 max_threads 是否有效
     // 这些值应由 thread_pool_create 或 thread_pool_set_limits 设置
@@ -1020,6 +2987,17 @@ int thread_pool_enable_auto_adjust(thread_pool_t pool, int high_watermark, int l
                     high_watermark, low_watermark, adjust_interval);
         return -1;
     }
+    if ((config->policy != THREAD_POOL_ADJUST_WATERMARK && config->policy != THREAD_POOL_ADJUST_RATE) ||
+        config->target_queue_wait_us <= 0 || config->ewma_weight_percent < 1 ||
+        config->ewma_weight_percent > 100 || config->hysteresis_percent < 0 || config->hysteresis_percent > 100 ||
+        config->cooldown_ms < 0) {
+        pthread_mutex_unlock(&pool->lock);
+        TPOOL_ERROR("thread_pool_enable_auto_adjust: 无效的调整策略选项。policy=%d, target_wait=%dus, "
+                    "weight=%d%%, hysteresis=%d%%, cooldown=%dms",
+                    (int)config->policy, config->target_queue_wait_us, config->ewma_weight_percent,
+                    config->hysteresis_percent, config->cooldown_ms);
+        return -1;
+    }
 
     // pthread_mutex_lock(&pool->lock); // 已在上面获取
     if (pool->shutdown) {
@@ -1035,6 +3013,7 @@ int thread_pool_enable_auto_adjust(thread_pool_t pool, int high_watermark, int l
         pool->high_watermark = high_watermark;
         pool->low_watermark = low_watermark;
         pool->adjust_interval = adjust_interval;
+        auto_adjust_apply_policy_locked(pool, config);
         pthread_cond_signal(&pool->adjust_cond);
         pthread_mutex_unlock(&pool->adjust_cond_lock);
         pthread_mutex_unlock(&pool->lock); // 释放外层 pool->lock
@@ -1047,6 +3026,7 @@ int thread_pool_enable_auto_adjust(thread_pool_t pool, int high_watermark, int l
     pool->high_watermark = high_watermark;
     pool->low_watermark = low_watermark;
     pool->adjust_interval = adjust_interval;
+    auto_adjust_apply_policy_locked(pool, config);
     pool->auto_adjust = 1;
 
     if (pthread_mutex_init(&pool->adjust_cond_lock, NULL) != 0) {
@@ -1076,20 +3056,148 @@ int thread_pool_enable_auto_adjust(thread_pool_t pool, int high_watermark, int l
         return -1;
     }
 
-    TPOOL_LOG(
-        "线程池 %p 已成功启用自动调整功能。min=%d, max=%d, high_wm=%d, low_wm=%d, interval=%dms",
-        (void *)pool, pool->min_threads, pool->max_threads, high_watermark, low_watermark,
-        adjust_interval);
-    pthread_mutex_unlock(&pool->lock);
-    return 0;
+    TPOOL_LOG(
+        "线程池 %p 已成功启用自动调整功能。policy=%s, min=%d, max=%d, high_wm=%d, low_wm=%d, interval=%dms",
+        (void *)pool, pool->adjust_policy == THREAD_POOL_ADJUST_RATE ? "rate" : "watermark", pool->min_threads,
+        pool->max_threads, high_watermark, low_watermark, adjust_interval);
+    pthread_mutex_unlock(&pool->lock);
+    return 0;
+}
+
+/**
+ * @brief 取消一个尚未开始执行的任务节点 (内部函数)。
+ *
+ * 将节点移出任务索引并以取消状态结束其完成句柄，然后按节点所在位置摘除：
+ * 运行队列和时间轮中的节点直接归还给 slab；工作窃取本地双端队列中的节点无法直接摘除，
+ * 标记为已取消，由取出它的线程回收。调用者必须持有池的锁，并在调用前保存需要的任务数据。
+ *
+ * @param pool 指向 thread_pool_s 实例的指针。
+ * @param node 处于排队或时间轮中的节点。
+ */
+static void task_node_cancel_locked(thread_pool_t pool, task_node_t *node)
+{
+    task_index_remove(&pool->id_index, node);
+    if (!node->anonymous) {
+        task_index_remove(&pool->name_index, node);
+    }
+    task_node_finish_future(node, TASK_FUTURE_CANCELLED);
+    if (node->state == TASK_NODE_QUEUED_LOCAL) {
+        // 节点仍在某个工作线程的本地双端队列中，无法直接摘除；
+        // 标记为已取消，由取出它的线程回收节点
+        node->state = TASK_NODE_CANCELLED;
+        pool_queue_size_add_locked(pool, -1);
+    } else if (node->state == TASK_NODE_TIMER) {
+        // 延迟或周期任务尚未到期，从时间轮中摘除
+        timer_wheel_remove(&pool->timer_wheel, node);
+        task_slab_free(&pool->task_slab, node);
+    } else {
+        // 将任务从所在优先级级别中摘除并归还给 slab
+        task_queue_unlink_internal(pool, node);
+        task_slab_free(&pool->task_slab, node);
+    }
+    stat_counter_inc_locked(&pool->tasks_cancelled);
+}
+
+/**
+ * @struct pool_discarded_task_t
+ * @brief 销毁线程池时被丢弃的任务，用于在释放池锁后调用取消回调 (内部使用)。
+ */
+typedef struct {
+    void (*function)(void *arg); /**< 任务函数，用于识别依赖图任务。 */
+    void *arg;                   /**< 任务参数。 */
+    task_id_t id;                /**< 任务ID。 */
+} pool_discarded_task_t;
+
+/**
+ * @brief 线程池关闭时取消所有尚未开始执行的任务 (内部函数)。
+ *
+ * 遍历ID索引一次取得所有任务节点：时间轮中尚未到期的任务在任何模式下都被取消，
+ * DRAIN 以外的模式还取消排队中的任务；CANCEL_RUNNING 模式下还为正在执行的任务设置取消标志。
+ * 正在执行的周期任务在任何模式下都停止后续执行，由工作线程在本次执行结束后调用取消回调。
+ * 耗时与任务数量成正比，但不执行其中任何任务。调用者必须持有池的锁且已设置 shutdown。
+ *
+ * @param pool 指向 thread_pool_s 实例的指针。
+ * @param mode 销毁模式。
+ * @param cancel_callback 正在执行的周期任务结束后调用的取消回调，可以为 NULL。
+ * @param count 输出被取消的任务数量。
+ * @return 被取消任务的数组 (*count 项)，由调用者释放；没有被取消的任务或内存分配失败时返回 NULL，
+ *         内存分配失败时 *count 为 -1，任务留在队列中照常执行。
+ */
+static pool_discarded_task_t *pool_discard_pending_locked(thread_pool_t pool, thread_pool_destroy_mode_t mode,
+                                                          task_cancel_callback_t cancel_callback, int *count)
+{
+    *count = 0;
+    int total = (int)pool->id_index.size;
+    if (total == 0) {
+        return NULL;
+    }
+    task_node_t **nodes = (task_node_t **)malloc((size_t)total * sizeof(task_node_t *));
+    pool_discarded_task_t *discarded = (pool_discarded_task_t *)malloc((size_t)total * sizeof(pool_discarded_task_t));
+    if (nodes == NULL || discarded == NULL) {
+        TPOOL_ERROR("thread_pool_destroy: 未能为 %d 个任务分配丢弃列表，改为执行所有排队任务", total);
+        free(nodes);
+        free(discarded);
+        *count = -1;
+        return NULL;
+    }
+
+    // 先收集节点再逐个取消，移出索引会移动槽位，不能边遍历边删除
+    int found = 0;
+    for (uint32_t slot = 0; slot < pool->id_index.capacity; slot++) {
+        task_node_t *node = pool->id_index.slots[slot];
+        if (node != NULL) {
+            nodes[found++] = node;
+        }
+    }
+
+    int cancelled = 0;
+    for (int i = 0; i < found; i++) {
+        task_node_t *node = nodes[i];
+        if (node->state == TASK_NODE_RUNNING) {
+            if (mode == THREAD_POOL_DESTROY_CANCEL_RUNNING) {
+                atomic_store_explicit(&node->cancel_requested, 1, memory_order_relaxed);
+            }
+            if (node->timer_period > 0) {
+                node->timer_period = 0;
+                node->cancel_callback = cancel_callback;
+            }
+            continue;
+        }
+        if (mode == THREAD_POOL_DESTROY_DRAIN && node->state != TASK_NODE_TIMER) {
+            continue; // 排队中的任务照常执行
+        }
+        discarded[cancelled].function = node->function;
+        discarded[cancelled].arg = node->arg;
+        discarded[cancelled].id = node->id;
+        cancelled++;
+        task_node_cancel_locked(pool, node);
+    }
+    free(nodes);
+    *count = cancelled;
+    if (cancelled == 0) {
+        free(discarded);
+        return NULL;
+    }
+    return discarded;
 }
 
 int thread_pool_destroy(thread_pool_t pool)
+{
+    return thread_pool_destroy_with_mode(pool, THREAD_POOL_DESTROY_DRAIN, NULL);
+}
+
+int thread_pool_destroy_with_mode(thread_pool_t pool, thread_pool_destroy_mode_t mode,
+                                  task_cancel_callback_t cancel_callback)
 {
     if (pool == NULL) {
         TPOOL_ERROR("thread_pool_destroy: 尝试销毁 NULL 池");
         return -1;
     }
+    if (mode != THREAD_POOL_DESTROY_DRAIN && mode != THREAD_POOL_DESTROY_DISCARD_PENDING &&
+        mode != THREAD_POOL_DESTROY_CANCEL_RUNNING) {
+        TPOOL_ERROR("thread_pool_destroy: 未知的销毁模式: %d", (int)mode);
+        return -1;
+    }
 
     // 如果自动调整已启用，则先禁用它
     // 这将确保自动调整线程被正确停止和清理
@@ -1143,14 +3251,14 @@ int thread_pool_destroy(thread_pool_t pool)
     pthread_mutex_lock(&pool->lock);
     int calculated_idle_threads = 0;
     for (int i = 0; i < pool->thread_count; i++) {
-        if (pool->thread_status[i] == 0) { // 空闲状态
+        if (pool->workers[i]->status == 0) { // 空闲状态
             calculated_idle_threads++;
         }
     }
     if (calculated_idle_threads != pool->idle_threads) {
         TPOOL_LOG("thread_pool_destroy: 修正空闲线程计数 %d -> %d", pool->idle_threads,
                   calculated_idle_threads);
-        pool->idle_threads = calculated_idle_threads;
+        pool_idle_threads_add_locked(pool, calculated_idle_threads - pool->idle_threads);
     }
 
     // 标记线程池为关闭状态
@@ -1158,33 +3266,55 @@ int thread_pool_destroy(thread_pool_t pool)
     TPOOL_DEBUG("thread_pool_destroy: 线程池 %p 已标记为关闭。正在向所有工作线程广播。",
               (void *)pool);
 
-    // 广播给所有等待的线程
-    pthread_cond_broadcast(&pool->notify);
-    pthread_mutex_unlock(&pool->lock);
+    // 按销毁模式取消排队中的任务，工作线程之后只需完成正在执行的任务；
+    // 时间轮中尚未到期的任务在任何模式下都被取消，其完成句柄和取消回调与排队任务一样处理
+    pool_discarded_task_t *discarded = NULL;
+    int discarded_count = 0;
+    if (pool->id_index.size > 0) {
+        discarded = pool_discard_pending_locked(pool, mode, cancel_callback, &discarded_count);
+        TPOOL_DEBUG("thread_pool_destroy: 线程池 %p 取消了 %d 个尚未执行的任务", (void *)pool, discarded_count);
+    }
 
-    // 等待一小段时间，让线程有机会响应关闭信号
-    const struct timespec wait_time = {0, 100000000}; // 100ms
-    nanosleep(&wait_time, NULL);
+    // 唤醒所有休眠的线程；忙碌的线程在完成当前任务后会看到关闭标志，此后不再休眠
+    pool_wake_all_locked(pool);
 
-    // 再次广播，确保所有线程都收到信号
-    pthread_mutex_lock(&pool->lock);
-    pthread_cond_broadcast(&pool->notify);
+    // 唤醒等待队列空位的提交者，并等待它们全部离开，之后才能销毁锁和条件变量
+    pthread_cond_broadcast(&pool->reserved_space_cond);
+    pthread_cond_broadcast(&pool->space_cond);
+    while (pool->space_waiters > 0 || pool->reserved_space_waiters > 0) {
+        pthread_cond_wait(&pool->space_cond, &pool->lock);
+    }
+
+    // 停止定时器线程；只有分配丢弃列表失败时时间轮中才会留下任务，它们随 slab 一起丢弃
+    pthread_cond_signal(&pool->timer_cond);
+    if (pool->timer_wheel.count > 0) {
+        TPOOL_DEBUG("thread_pool_destroy: 丢弃线程池 %p 时间轮中 %d 个尚未到期的任务", (void *)pool,
+                  pool->timer_wheel.count);
+    }
     pthread_mutex_unlock(&pool->lock);
+    if (pool->timer_started) {
+        int join_result = pthread_join(pool->timer_thread, NULL);
+        if (join_result != 0) {
+            TPOOL_ERROR("thread_pool_destroy: 连接定时器线程失败: %s", strerror(join_result));
+        }
+        pool->timer_started = 0;
+    }
+
+    // 在池锁之外统一调用取消回调；依赖图中的任务由依赖图以用户参数调用回调，并一并取消其后继任务
+    for (int i = 0; i < discarded_count; i++) {
+        if (discarded[i].function == task_graph_node_run) {
+            task_graph_node_cancelled(discarded[i].arg, cancel_callback);
+        } else if (cancel_callback != NULL) {
+            cancel_callback(discarded[i].arg, discarded[i].id);
+        }
+    }
+    free(discarded);
 
     // 再次广播给自动调整线程，确保它退出
     pthread_mutex_lock(&pool->resize_lock);
     pthread_cond_broadcast(&pool->adjust_cond);
     pthread_mutex_unlock(&pool->resize_lock);
 
-    // 等待短暂时间，给线程机会退出
-    struct timespec short_wait = {0, 200000000}; // 200ms
-    nanosleep(&short_wait, NULL);
-
-    // 再次广播
-    pthread_mutex_lock(&pool->lock);
-    pthread_cond_broadcast(&pool->notify);
-    pthread_mutex_unlock(&pool->lock);
-
     // 如果存在自动调整线程，先处理它
     if (pool->adjust_thread != 0) {
         TPOOL_DEBUG("thread_pool_destroy: 正在连接自动调整线程 (ID: %lu)", 
@@ -1220,117 +3350,37 @@ int thread_pool_destroy(thread_pool_t pool)
         pool->adjust_thread = 0;
     }
 
-    // 线程连接处理
+    // 连接所有工作线程，包括因缩小而退出、尚未被连接的线程
+    worker_threads_join_all(pool);
 
-    for (int i = 0; i < pool->thread_count; i++) {
-        if (pool->threads[i] == 0) {
-            continue; // 跳过无效线程ID
-        }
-
-        TPOOL_DEBUG("thread_pool_destroy: 正在连接线程池 %p 的线程 #%d (ID: %lu)。", (void *)pool, i,
-                  (unsigned long)pool->threads[i]);
-
-        // 创建一个单独的线程来处理连接
-        pthread_t thread_id = pool->threads[i];
-        int join_attempted = 0;
-
-        // 在连接前再次发送广播信号
-        pthread_mutex_lock(&pool->lock);
-        pthread_cond_broadcast(&pool->notify);
-        pthread_mutex_unlock(&pool->lock);
-
-        // 使用超时机制尝试连接
-        struct timespec join_start_time;
-        clock_gettime(CLOCK_MONOTONIC, &join_start_time);
-        struct timespec current_time;
-        
-        // 设置超时时间为500ms
-        struct timespec end_time = join_start_time;
-        end_time.tv_nsec += 500000000; // 500ms
-        if (end_time.tv_nsec >= 1000000000) {
-            end_time.tv_sec += 1;
-            end_time.tv_nsec -= 1000000000;
-        }
-
-        // 尝试使用标准pthread_join
-        int join_result = pthread_join(thread_id, NULL);
-
-        if (join_result == 0) {
-            // 成功连接
-            join_attempted = 1;
-            TPOOL_DEBUG("thread_pool_destroy: 线程 #%d (ID: %lu) 已成功连接。", i,
-                      (unsigned long)thread_id);
-        } else {
-            // 连接失败，可能是线程已经分离或其他原因
-            TPOOL_ERROR("thread_pool_destroy: 连接线程 #%d (ID: %lu) 失败: %s", i,
-                        (unsigned long)thread_id, strerror(join_result));
-            
-            // 检查是否超时
-            clock_gettime(CLOCK_MONOTONIC, &current_time);
-            if ((current_time.tv_sec > end_time.tv_sec) || 
-                (current_time.tv_sec == end_time.tv_sec && current_time.tv_nsec > end_time.tv_nsec)) {
-                TPOOL_ERROR("thread_pool_destroy: 连接线程 #%d 超时", i);
-            }
-        }
-
-        // 如果连接失败，尝试取消线程
-        if (!join_attempted) {
-            TPOOL_ERROR("thread_pool_destroy: 无法连接线程 #%d (ID: %lu), 尝试取消。", i,
-                        (unsigned long)thread_id);
-
-            // 尝试取消线程
-            pthread_cancel(thread_id);
-
-            // 再次尝试连接，设置短超时
-            join_result = pthread_join(thread_id, NULL);
-            if (join_result == 0) {
-                TPOOL_DEBUG("thread_pool_destroy: 线程 #%d (ID: %lu) 在取消后成功连接。", i,
-                          (unsigned long)thread_id);
-            } else {
-                TPOOL_ERROR("thread_pool_destroy: 无法在取消后连接线程 #%d (ID: %lu): %s", i,
-                            (unsigned long)thread_id, strerror(join_result));
-            }
-        }
-
-        // 清除线程 ID，避免重复连接
-        pool->threads[i] = 0;
-    }
-
-    // 销毁任务队列
+    // 销毁任务队列和工作窃取本地队列
     task_queue_destroy_internal(pool);
+    ws_workers_destroy(pool);
+    worker_states_destroy(pool);
+    latency_levels_destroy(pool->latency);
+    free(pool->node_queues);
+    free(pool->node_worker_count);
+    worker_placement_destroy(&pool->placement);
+    TPOOL_DEBUG("已清理线程池 %p 的工作线程状态。", (void *)pool);
 
     // 销毁互斥锁和条件变量
+    pthread_cond_destroy(&pool->timer_cond);
+    pthread_cond_destroy(&pool->reserved_space_cond);
+    pthread_cond_destroy(&pool->space_cond);
     pthread_mutex_destroy(&pool->lock);
     pthread_mutex_destroy(&pool->resize_lock);
-    pthread_cond_destroy(&pool->notify);
-
-    // 释放 running_task_names 数组及其字符串
-    for (int i = 0; i < pool->thread_count; ++i) {
-        if (pool->running_task_names[i]) {
-            free(pool->running_task_names[i]);
-        }
-    }
-    free(pool->running_task_names);
-    TPOOL_DEBUG("已清理线程池 %p 的 running_task_names。", (void *)pool);
-    
-    // 释放任务名称映射数组
-    if (pool->task_name_map != NULL) {
-        free(pool->task_name_map);
-        pool->task_name_map = NULL;
-        pool->task_name_map_size = 0;
-        pool->task_name_map_capacity = 0;
-        TPOOL_DEBUG("已清理线程池 %p 的任务名称映射。", (void *)pool);
-    }
     
-    // 销毁任务名称映射互斥锁
-    pthread_mutex_destroy(&pool->name_map_lock);
+    // 释放任务索引
+    task_index_destroy(&pool->id_index);
+    task_index_destroy(&pool->name_index);
+    deadline_heap_destroy(&pool->deadline_heap);
+    TPOOL_DEBUG("已清理线程池 %p 的任务索引。", (void *)pool);
 
     // 在释放池之前记录日志，避免释放后使用
     TPOOL_LOG("线程池 (%p) 即将销毁。", (void *)pool);
 
-    // 释放线程数组、线程状态数组和池结构本身
-    free(pool->threads);
-    free(pool->thread_status);
+    // 释放任务节点和池结构本身
+    task_slab_destroy(&pool->task_slab); // 所有线程已连接，释放全部任务节点内存
     free(pool); // 释放 struct thread_pool_s
 
     // 注意：我们不在这里关闭日志模块，因为其他模块可能仍在使用它
@@ -1366,6 +3416,12 @@ int thread_pool_resize(thread_pool_t pool, int new_thread_count)
         pthread_mutex_unlock(&(pool->resize_lock));
         return -1;
     }
+    if (pool->scheduler == THREAD_POOL_SCHED_WORK_STEALING && new_thread_count > WS_MAX_WORKERS) {
+        TPOOL_ERROR("thread_pool_resize: new_thread_count (%d) exceeds work-stealing limit %d for pool %p",
+                    new_thread_count, WS_MAX_WORKERS, (void *)pool);
+        pthread_mutex_unlock(&(pool->resize_lock));
+        return -1;
+    }
 
     // 获取主锁以安全地访问和修改池的共享状态
     pthread_mutex_lock(&(pool->lock));
@@ -1391,101 +3447,59 @@ int thread_pool_resize(thread_pool_t pool, int new_thread_count)
     }
 
     if (new_thread_count > old_thread_count) { // 增加线程
-        // 分别为线程数组分配新内存，避免 realloc 失败导致的不一致状态
-        pthread_t *new_threads_ptr = (pthread_t *)malloc(new_thread_count * sizeof(pthread_t));
-        char **new_running_task_names_ptr = (char **)malloc(new_thread_count * sizeof(char *));
-        int *new_thread_status_ptr = (int *)malloc(new_thread_count * sizeof(int));
-
-        if (new_threads_ptr == NULL || new_running_task_names_ptr == NULL ||
-            new_thread_status_ptr == NULL) {
-            TPOOL_ERROR(
-                "thread_pool_resize: Failed to allocate memory for thread arrays for pool %p",
-                (void *)pool);
-            // 清理所有已分配的内存
-            if (new_threads_ptr != NULL) {
-                free(new_threads_ptr);
-            }
-            if (new_running_task_names_ptr != NULL) {
-                free(new_running_task_names_ptr);
-            }
-            if (new_thread_status_ptr != NULL) {
-                free(new_thread_status_ptr);
+        // 工作线程状态已按 max_threads 分配，这里只复用槽位，无需在持锁时分配和复制数组。
+        // 槽位上因之前缩小而被要求退出的线程：已在持锁时决定退出 (status < 0) 的马上就会结束，
+        // 连接它即可；仍在执行任务或尚未醒来的线程直接留用，提高 thread_count 后它不会再退出，
+        // 因此不会阻塞在长时间运行的任务上
+        for (int i = old_thread_count; i < new_thread_count; ++i) {
+            worker_state_t *worker = pool->workers[i];
+            if (!worker->joinable || worker->status >= 0) {
+                continue;
             }
             pthread_mutex_unlock(&(pool->lock));
+            pthread_join(worker->thread, NULL);
+            pthread_mutex_lock(&(pool->lock));
+            worker->joinable = 0;
+            i = old_thread_count - 1; // 释放锁期间已检查过的线程可能也决定了退出，重新检查
+        }
+        if (pool->shutdown) {
+            TPOOL_ERROR("thread_pool_resize: pool %p is shutting down", (void *)pool);
+            pthread_mutex_unlock(&(pool->lock));
             pthread_mutex_unlock(&(pool->resize_lock));
             return -1;
         }
-        
-        // 复制现有数组数据到新数组
-        memcpy(new_threads_ptr, pool->threads, old_thread_count * sizeof(pthread_t));
-        memcpy(new_running_task_names_ptr, pool->running_task_names, old_thread_count * sizeof(char *));
-        memcpy(new_thread_status_ptr, pool->thread_status, old_thread_count * sizeof(int));
-        // 释放旧数组并更新指针
-        free(pool->threads);
-        free(pool->running_task_names);
-        free(pool->thread_status);
-        
-        pool->threads = new_threads_ptr;
-        pool->running_task_names = new_running_task_names_ptr;
-        pool->thread_status = new_thread_status_ptr;
 
         for (int i = old_thread_count; i < new_thread_count; ++i) {
-            pool->running_task_names[i] = (char *)malloc(MAX_TASK_NAME_LEN);
-            if (pool->running_task_names[i] == NULL) {
-                TPOOL_ERROR("thread_pool_resize: Failed to allocate memory for task name for new "
-                            "thread %d in pool %p",
-                            i, (void *)pool);
-                // 回滚：释放已分配的，并将数组大小调回 old_thread_count
-                for (int k = old_thread_count; k < i; ++k) {
-                    free(pool->running_task_names[k]);
-                }
-                // 此处不尝试 realloc 缩小数组，因为可能再次失败。标记池为错误状态可能更好。
-                pthread_mutex_unlock(&(pool->lock));
-                pthread_mutex_unlock(&(pool->resize_lock));
-                return -1;
-            }
-            snprintf(pool->running_task_names[i], MAX_TASK_NAME_LEN, "[idle]");
-            pool->thread_status[i] = 0; // 0 for idle
-
-            thread_args_t *args = (thread_args_t *)malloc(sizeof(thread_args_t));
-            if (!args) {
-                TPOOL_ERROR("thread_pool_resize: Failed to allocate memory for thread_args_t for "
-                            "thread %d in pool %p",
-                            i, (void *)pool);
-                free(pool->running_task_names[i]);
-                pthread_mutex_unlock(&(pool->lock));
-                pthread_mutex_unlock(&(pool->resize_lock));
-                return -1;
+            worker_state_t *worker = pool->workers[i];
+            if (worker->joinable) {
+                continue; // 留用的线程，其空闲计数和节点归属都未撤销
             }
-            args->pool = pool;
-            args->thread_id = i;
-
-            if (pthread_create(&(pool->threads[i]), NULL, worker_thread_function, (void *)args) !=
-                0) {
+            snprintf(worker->running_task_name, MAX_TASK_NAME_LEN, "[idle]");
+            worker->running_task_id = 0;
+            worker->status = 0; // 0 for idle
+            worker->permit = 0;
+            worker_publish_locked(worker);
+
+            int create_result = worker_placement_create_thread(&pool->placement, i, &worker->thread,
+                                                               worker_thread_function, (void *)worker);
+            if (create_result != 0) {
                 TPOOL_ERROR("thread_pool_resize: Failed to create new thread %d for pool %p: %s", i,
-                            (void *)pool, strerror(errno));
-                // 清理已分配的资源
-                free(pool->running_task_names[i]);
-                free(args);
-                
-                // 回滚：释放先前创建的线程
+                            (void *)pool, strerror(create_result));
+                // 回滚：让本次已创建的线程退出，线程数保持不变
                 for (int k = old_thread_count; k < i; ++k) {
-                    // 标记这些线程需要退出
-                    pool->thread_status[k] = -2; // -2 表示因为调整大小而退出
+                    pool->workers[k]->status = -2; // -2 表示因为调整大小而退出
+                    worker_publish_locked(pool->workers[k]);
+                    pool_wake_worker_locked(pool, k);
                 }
-                // 广播通知线程退出
-                pthread_cond_broadcast(&(pool->notify));
-                
-                // 更新线程计数为实际成功创建的线程数
-                pool->thread_count = old_thread_count + (i - old_thread_count);
-                
                 pthread_mutex_unlock(&(pool->lock));
                 pthread_mutex_unlock(&(pool->resize_lock));
                 return -1;
             }
+            worker->joinable = 1;
+            worker_node_attach_locked(pool, worker);
             TPOOL_DEBUG("Thread %d (ID: %lu) created successfully for pool %p.", i,
-                      (unsigned long)pool->threads[i], (void *)pool);
-            pool->idle_threads++;
+                      (unsigned long)worker->thread, (void *)pool);
+            pool_idle_threads_add_locked(pool, 1);
             pool->started++;
         }
         pool->resize_shutdown = 0; // 确保增加线程时，缩减标志是关闭的
@@ -1494,12 +3508,17 @@ int thread_pool_resize(thread_pool_t pool, int new_thread_count)
         // 工作线程会在其循环中检查 args->thread_id >= new_thread_count (在 resize 后是
         // pool->thread_count) 并自行退出。主锁已持有。
         TPOOL_LOG(
-            "Thread pool %p: resize_shutdown initiated. Target count %d. Broadcasting to workers.",
+            "Thread pool %p: resize_shutdown initiated. Target count %d. Waking exiting workers.",
             (void *)pool, new_thread_count);
-        pthread_cond_broadcast(&(pool->notify)); // 唤醒所有线程检查状态
+        // 只唤醒需要退出的线程
+        for (int i = new_thread_count; i < old_thread_count; ++i) {
+            pool_wake_worker_locked(pool, i);
+        }
     }
 
     pool->thread_count = new_thread_count; // 更新逻辑线程计数
+    atomic_store_explicit(&pool->stat_thread_count, new_thread_count, memory_order_relaxed);
+    trace_event(TRACE_EVENT_RESIZE, pool, (uint64_t)new_thread_count, old_thread_count);
 
     pthread_mutex_unlock(&(pool->lock));
     pthread_mutex_unlock(&(pool->resize_lock));
@@ -1567,26 +3586,16 @@ char **thread_pool_get_running_task_names(thread_pool_t pool)
         }
         
         // 检查线程是否正在执行任务
-        if (pool->running_task_names != NULL && i < pool->thread_count && 
-            pool->running_task_names[i] != NULL &&
-            pool->thread_status != NULL && pool->thread_status[i] > 0) {
+        worker_state_t *worker = pool->workers[i];
+        if (worker->status > 0) {
             // 线程正在执行任务，复制任务名
-            strncpy(task_names_copy[i], pool->running_task_names[i], MAX_TASK_NAME_LEN - 1);
-            task_names_copy[i][MAX_TASK_NAME_LEN - 1] = '\0';
+            snprintf(task_names_copy[i], MAX_TASK_NAME_LEN, "%s", worker->running_task_name);
+        } else if (worker->status == -2) {
+            snprintf(task_names_copy[i], MAX_TASK_NAME_LEN, "[exiting_resize]");
+        } else if (worker->status == -1) {
+            snprintf(task_names_copy[i], MAX_TASK_NAME_LEN, "[exiting_shutdown]");
         } else {
-            // 检查线程状态并设置适当的状态标记
-            if (pool->thread_status != NULL && i < pool->thread_count) {
-                if (pool->thread_status[i] == -2) {
-                    snprintf(task_names_copy[i], MAX_TASK_NAME_LEN, "[exiting_resize]");
-                } else if (pool->thread_status[i] == -1) {
-                    snprintf(task_names_copy[i], MAX_TASK_NAME_LEN, "[exiting_shutdown]");
-                } else {
-                    snprintf(task_names_copy[i], MAX_TASK_NAME_LEN, "[idle]");
-                }
-            } else {
-                // 无效状态或数组未初始化
-                snprintf(task_names_copy[i], MAX_TASK_NAME_LEN, "[unknown]");
-            }
+            snprintf(task_names_copy[i], MAX_TASK_NAME_LEN, "[idle]");
         }
     }
     task_names_copy[current_thread_count] = NULL; // NULL 终止数组
@@ -1595,6 +3604,34 @@ char **thread_pool_get_running_task_names(thread_pool_t pool)
     return task_names_copy;
 }
 
+/**
+ * @brief 获取指定优先级任务的排队等待和执行时间统计。
+ *
+ * 直方图由工作线程无锁地更新，这里同样不获取池锁。
+ *
+ * @param pool 指向 thread_pool_t 实例的指针。
+ * @param priority 要查询的任务优先级。
+ * @param stats 用于存储统计信息的结构。
+ * @return 成功时返回 0，错误时返回 -1 (例如，pool 为 NULL，stats 为 NULL，未启用延迟统计)。
+ */
+int thread_pool_get_latency_stats(thread_pool_t pool, task_priority_t priority, thread_pool_latency_stats_t *stats)
+{
+    if (pool == NULL || stats == NULL) {
+        TPOOL_ERROR("thread_pool_get_latency_stats: 无效参数 (pool: %p, stats: %p)", (void *)pool,
+                    (void *)stats);
+        return -1;
+    }
+    if (pool->latency == NULL) {
+        TPOOL_ERROR("thread_pool_get_latency_stats: 线程池 %p 创建时未启用延迟统计", (void *)pool);
+        return -1;
+    }
+
+    latency_level_t *level = &pool->latency[task_priority_level(priority)];
+    latency_hist_read(&level->queue_wait, &stats->queue_wait);
+    latency_hist_read(&level->run_time, &stats->run_time);
+    return 0;
+}
+
 /**
  * @brief 释放由 `thread_pool_get_running_task_names` 返回的任务名称数组。
  *
@@ -1642,6 +3679,12 @@ int thread_pool_set_limits(thread_pool_t pool, int min_threads, int max_threads)
         TPOOL_ERROR("thread_pool_set_limits: 池正在关闭，不能设置限制。");
         return -1;
     }
+    // 提高上限时补齐工作线程状态，之后的调整大小无需分配内存
+    if (worker_states_reserve(pool, max_threads) != 0) {
+        pthread_mutex_unlock(&(pool->lock));
+        TPOOL_ERROR("thread_pool_set_limits: 未能为 %d 个工作线程分配状态。", max_threads);
+        return -1;
+    }
 
     pool->min_threads = min_threads;
     pool->max_threads = max_threads;
@@ -1719,6 +3762,40 @@ int thread_pool_get_stats(thread_pool_t pool, thread_pool_stats_t *stats)
     return 0;
 }
 
+int thread_pool_get_snapshot(thread_pool_t pool, thread_pool_snapshot_t *snapshot,
+                             thread_pool_worker_info_t *workers, int max_workers)
+{
+    if (pool == NULL || snapshot == NULL || max_workers < 0 || (workers == NULL && max_workers > 0)) {
+        TPOOL_ERROR("thread_pool_get_snapshot: 无效参数 (pool: %p, snapshot: %p, workers: %p, max_workers: %d)。",
+                    (void *)pool, (void *)snapshot, (void *)workers, max_workers);
+        return -1;
+    }
+
+    snapshot->thread_count = atomic_load_explicit(&pool->stat_thread_count, memory_order_relaxed);
+    snapshot->idle_threads = atomic_load_explicit(&pool->stat_idle_threads, memory_order_relaxed);
+    snapshot->task_queue_size = atomic_load_explicit(&pool->stat_queue_size, memory_order_relaxed);
+    snapshot->tasks_submitted = atomic_load_explicit(&pool->tasks_submitted, memory_order_relaxed);
+    snapshot->tasks_cancelled = atomic_load_explicit(&pool->tasks_cancelled, memory_order_relaxed);
+    snapshot->tasks_rejected = atomic_load_explicit(&pool->tasks_rejected, memory_order_relaxed);
+
+    // 已完成任务数由各槽位分别累计，包括已退出线程的槽位
+    worker_table_t *table = atomic_load_explicit(&pool->worker_table, memory_order_acquire);
+    unsigned long completed = 0;
+    int count = 0;
+    for (int i = 0; table != NULL && i < table->capacity; i++) {
+        worker_state_t *worker = table->slots[i];
+        if (i < snapshot->thread_count && count < max_workers) {
+            worker_read_info(worker, &workers[count]);
+            completed += workers[count].tasks_completed;
+            count++;
+        } else {
+            completed += atomic_load_explicit(&worker->tasks_completed, memory_order_relaxed);
+        }
+    }
+    snapshot->tasks_completed = completed;
+    return count;
+}
+
 // 确保这个函数定义在 thread_pool_destroy 之前，或者 thread_pool_destroy 在它之后
 int thread_pool_disable_auto_adjust(thread_pool_t pool)
 {
@@ -1820,6 +3897,8 @@ int thread_pool_disable_auto_adjust(thread_pool_t pool)
  * @brief 取消线程池中的任务
  *
  * 尝试取消指定ID的任务。如果任务已经开始执行，则无法取消。
+ * 尚未到期的延迟或周期任务直接从时间轮中移除；正在执行的周期任务本次执行照常完成，
+ * 但不再安排后续执行。
  * 如果任务成功取消，将调用取消回调函数（如果提供）。
  *
  * @param pool 指向线程池实例的指针
@@ -1833,91 +3912,94 @@ int thread_pool_cancel_task(thread_pool_t pool, task_id_t task_id, task_cancel_c
         return -2; // 参数无效
     }
 
-    // 获取锁以安全地访问任务队列
+    // 获取锁以安全地访问任务队列和任务索引
     pthread_mutex_lock(&(pool->lock));
 
-    // 检查任务是否正在运行
-    for (int i = 0; i < pool->thread_count; i++) {
-        if (pool->running_task_ids[i] == task_id) {
-            // 任务正在运行，无法取消
-            pthread_mutex_unlock(&(pool->lock));
-            TPOOL_DEBUG("线程池 %p: 任务ID %lu 正在运行，无法取消。", (void *)pool, (unsigned long)task_id);
-            return -1;
-        }
+    task_node_t *current = task_index_find_id(&pool->id_index, task_id);
+    if (current == NULL) {
+        // 任务不在队列中，也不在运行中
+        pthread_mutex_unlock(&(pool->lock));
+        TPOOL_DEBUG("线程池 %p: 任务ID %lu 不存在，无法取消。", (void *)pool, (unsigned long)task_id);
+        return -1;
+    }
+    if (current->state == TASK_NODE_RUNNING && current->timer_period == 0) {
+        // 任务正在运行，无法取消
+        pthread_mutex_unlock(&(pool->lock));
+        TPOOL_DEBUG("线程池 %p: 任务ID %lu 正在运行，无法取消。", (void *)pool, (unsigned long)task_id);
+        return -1;
     }
 
-    // 在任务队列中查找任务
-    task_node_t *prev = NULL;
-    task_node_t *current = pool->head;
+    // 保存任务信息以便在解锁后调用回调
+    void *task_arg = current->arg;
+    task_id_t canceled_task_id = current->id;
+    int graph_task = current->function == task_graph_node_run;
+
+    if (current->state == TASK_NODE_RUNNING) {
+        // 周期任务正在执行：本次执行照常完成，之后不再重新进入时间轮；
+        // 任务函数仍在使用参数，取消回调由工作线程在本次执行结束后调用
+        current->timer_period = 0;
+        current->cancel_callback = cancel_callback;
+        stat_counter_inc_locked(&pool->tasks_cancelled);
+        pthread_mutex_unlock(&(pool->lock));
+        TPOOL_DEBUG("线程池 %p: 已取消周期任务ID %lu 的后续执行。", (void *)pool,
+                    (unsigned long)canceled_task_id);
+        return 0;
+    }
 
-    while (current != NULL) {
-        if (current->task.id == task_id) {
-            // 找到任务，从队列中移除
-            if (prev == NULL) {
-                // 任务在队列头部
-                pool->head = current->next;
-            } else {
-                // 任务在队列中间或尾部
-                prev->next = current->next;
-            }
+    task_node_cancel_locked(pool, current);
 
-            // 如果是队列尾部的任务，更新尾指针
-            if (current->next == NULL) {
-                pool->tail = prev;
-            }
+    // 解锁线程池锁
+    pthread_mutex_unlock(&(pool->lock));
 
-            // 减少任务队列长度
-            pool->task_queue_size--;
+    // 调用取消回调（如果提供）；依赖图中的任务由依赖图以用户参数调用回调，并一并取消其后继任务
+    if (graph_task) {
+        task_graph_node_cancelled(task_arg, cancel_callback);
+    } else if (cancel_callback != NULL) {
+        cancel_callback(task_arg, canceled_task_id);
+    }
 
-            // 保存任务信息以便在解锁后调用回调
-            void *task_arg = current->task.arg;
-            task_id_t canceled_task_id = current->task.id;
-            char task_name[MAX_TASK_NAME_LEN];
-            strncpy(task_name, current->task.task_name, MAX_TASK_NAME_LEN - 1);
-            task_name[MAX_TASK_NAME_LEN - 1] = '\0';
+    TPOOL_DEBUG("线程池 %p: 成功取消任务ID %lu。", (void *)pool, (unsigned long)canceled_task_id);
+    return 0;
+}
 
-            // 释放任务节点
-            free(current);
+int thread_pool_request_cancel(thread_pool_t pool, task_id_t task_id, task_cancel_callback_t cancel_callback)
+{
+    if (pool == NULL || task_id == 0) {
+        TPOOL_ERROR("thread_pool_request_cancel: 线程池为NULL或任务ID无效，无法取消任务。");
+        return -2;
+    }
 
-            // 解锁线程池锁
+    while (1) {
+        pthread_mutex_lock(&(pool->lock));
+        task_node_t *node = task_index_find_id(&pool->id_index, task_id);
+        if (node == NULL) {
             pthread_mutex_unlock(&(pool->lock));
-            
-            // 从任务名称映射中移除该任务
-            pthread_mutex_lock(&(pool->name_map_lock));
-            for (int i = 0; i < pool->task_name_map_size; i++) {
-                if (pool->task_name_map[i].task_id == canceled_task_id) {
-                    // 找到要移除的映射，将最后一个映射移动到这个位置
-                    if (i < pool->task_name_map_size - 1) {
-                        // 如果不是最后一个元素，将最后一个元素复制到当前位置
-                        memcpy(&pool->task_name_map[i], &pool->task_name_map[pool->task_name_map_size - 1], 
-                               sizeof(*pool->task_name_map));
-                    }
-                    pool->task_name_map_size--;
-                    TPOOL_DEBUG("从任务名称映射中移除任务 '%s' (ID: %lu)", 
-                              task_name, (unsigned long)canceled_task_id);
-                    break;
-                }
-            }
-            pthread_mutex_unlock(&(pool->name_map_lock));
-
-            // 调用取消回调（如果提供）
-            if (cancel_callback != NULL) {
-                cancel_callback(task_arg, canceled_task_id);
+            return -1;
+        }
+        if (node->state == TASK_NODE_RUNNING) {
+            // 由任务自己在检查点响应；周期任务同时停止后续执行，并在本次执行结束后调用取消回调
+            atomic_store_explicit(&node->cancel_requested, 1, memory_order_relaxed);
+            if (node->timer_period > 0) {
+                node->timer_period = 0;
+                node->cancel_callback = cancel_callback;
             }
+            pthread_mutex_unlock(&(pool->lock));
+            TPOOL_DEBUG("线程池 %p: 已请求取消正在执行的任务ID %lu。", (void *)pool, (unsigned long)task_id);
+            return 1;
+        }
+        pthread_mutex_unlock(&(pool->lock));
 
-            TPOOL_DEBUG("线程池 %p: 成功取消任务ID %lu。", (void *)pool, (unsigned long)canceled_task_id);
+        if (thread_pool_cancel_task(pool, task_id, cancel_callback) == 0) {
             return 0;
         }
-
-        // 移动到下一个节点
-        prev = current;
-        current = current->next;
+        // 任务在两次加锁之间开始执行或已经完成，重新检查
     }
+}
 
-    // 任务不在队列中，也不在运行中
-    pthread_mutex_unlock(&(pool->lock));
-    TPOOL_DEBUG("线程池 %p: 任务ID %lu 不存在，无法取消。", (void *)pool, (unsigned long)task_id);
-    return -1;
+int thread_pool_cancel_requested(void)
+{
+    task_node_t *node = tls_worker.current_node;
+    return node != NULL && atomic_load_explicit(&node->cancel_requested, memory_order_relaxed) != 0;
 }
 
 /**
@@ -1937,37 +4019,20 @@ task_id_t thread_pool_find_task_by_name(thread_pool_t pool, const char *task_nam
     }
     
     task_id_t found_task_id = 0;
-    
-    // 锁住任务名称映射锁以安全访问映射
-    pthread_mutex_lock(&(pool->name_map_lock));
-    
-    // 在映射中查找任务名称
-    for (int i = 0; i < pool->task_name_map_size; i++) {
-        if (strcmp(pool->task_name_map[i].task_name, task_name) == 0) {
-            found_task_id = pool->task_name_map[i].task_id;
-            break;
-        }
-    }
-    
-    pthread_mutex_unlock(&(pool->name_map_lock));
-    
-    // 如果找到任务且请求检查运行状态
-    if (found_task_id > 0 && is_running != NULL) {
-        pthread_mutex_lock(&(pool->lock));
-        
-        // 默认为不在运行
-        *is_running = 0;
-        
-        // 检查任务是否正在运行
-        for (int i = 0; i < pool->thread_count; i++) {
-            if (pool->running_task_ids[i] == found_task_id) {
-                *is_running = 1;
-                break;
-            }
+    uint32_t name_hash = task_name_hash(task_name);
+
+    pthread_mutex_lock(&(pool->lock));
+
+    // 在名称索引中查找任务
+    task_node_t *node = task_index_find_name(&pool->name_index, task_name, name_hash);
+    if (node != NULL) {
+        found_task_id = node->id;
+        if (is_running != NULL) {
+            *is_running = (node->state == TASK_NODE_RUNNING);
         }
-        
-        pthread_mutex_unlock(&(pool->lock));
     }
+
+    pthread_mutex_unlock(&(pool->lock));
     
     return found_task_id;
 }
@@ -1976,7 +4041,7 @@ task_id_t thread_pool_find_task_by_name(thread_pool_t pool, const char *task_nam
  * @brief 通过任务名称取消任务
  *
  * 在线程池中查找指定名称的任务，并尝试取消它。
- * 只有在队列中等待的任务才能被取消，正在运行的任务无法取消。
+ * 只有在队列中等待的任务才能被取消，正在运行的任务无法取消 (周期任务的处理见 thread_pool_cancel_task)。
  *
  * @param pool 指向线程池实例的指针
  * @param task_name 要取消的任务名称
@@ -1990,26 +4055,22 @@ int thread_pool_cancel_task_by_name(thread_pool_t pool, const char *task_name, t
     }
     
     // 先查找任务ID
-    int is_running = 0;
-    task_id_t task_id = thread_pool_find_task_by_name(pool, task_name, &is_running);
+    task_id_t task_id = thread_pool_find_task_by_name(pool, task_name, NULL);
     
     if (task_id == 0) {
         TPOOL_DEBUG("线程池 %p: 任务名称 '%s' 不存在，无法取消。", (void *)pool, task_name);
         return -1; // 任务不存在
     }
     
-    if (is_running) {
-        TPOOL_DEBUG("线程池 %p: 任务名称 '%s' (ID: %lu) 正在运行，无法取消。", 
-                  (void *)pool, task_name, (unsigned long)task_id);
-        return -1; // 任务正在运行，无法取消
-    }
-    
-    // 使用现有的取消函数来取消任务
+    // 使用现有的取消函数来取消任务；正在运行的任务由它拒绝 (周期任务除外)
     int result = thread_pool_cancel_task(pool, task_id, cancel_callback);
     
     if (result == 0) {
         TPOOL_DEBUG("线程池 %p: 成功取消任务名称 '%s' (ID: %lu)。", 
                   (void *)pool, task_name, (unsigned long)task_id);
+    } else if (result == -1) {
+        TPOOL_DEBUG("线程池 %p: 任务名称 '%s' (ID: %lu) 正在运行或已完成，无法取消。", 
+                  (void *)pool, task_name, (unsigned long)task_id);
     } else {
         TPOOL_ERROR("线程池 %p: 取消任务名称 '%s' (ID: %lu) 失败，错误代码: %d。", 
                   (void *)pool, task_name, (unsigned long)task_id, result);
@@ -2034,36 +4095,140 @@ int thread_pool_task_exists(thread_pool_t pool, task_id_t task_id, int *is_runni
         return -1; // 参数无效
     }
 
-    // 获取锁以安全地访问任务队列和运行状态
+    // 获取锁以安全地访问任务索引
     pthread_mutex_lock(&(pool->lock));
 
-    // 首先检查任务是否正在运行
-    for (int i = 0; i < pool->thread_count; i++) {
-        if (pool->running_task_ids[i] == task_id) {
-            // 任务正在运行
-            if (is_running != NULL) {
-                *is_running = 1;
-            }
-            pthread_mutex_unlock(&(pool->lock));
-            return 1; // 任务存在且正在运行
-        }
-    }
-
-    // 在任务队列中查找任务
-    task_node_t *current = pool->head;
-    while (current != NULL) {
-        if (current->task.id == task_id) {
-            // 任务在队列中等待
-            if (is_running != NULL) {
-                *is_running = 0;
-            }
-            pthread_mutex_unlock(&(pool->lock));
-            return 1; // 任务存在但未运行
+    task_node_t *node = task_index_find_id(&pool->id_index, task_id);
+    if (node != NULL) {
+        if (is_running != NULL) {
+            *is_running = (node->state == TASK_NODE_RUNNING);
         }
-        current = current->next;
+        pthread_mutex_unlock(&(pool->lock));
+        return 1; // 任务存在 (正在运行或在队列中等待)
     }
 
     // 任务不存在
     pthread_mutex_unlock(&(pool->lock));
     return 0; // 任务不存在
 }
+
+/**
+ * @brief 添加一个新任务并返回其完成句柄。
+ *
+ * 句柄在加锁前创建，任务入队的同时登记到节点上，因此不会错过任务的完成。
+ * 返回的句柄由调用者持有一个引用，任务节点另持有一个引用直到任务结束。
+ *
+ * @param pool 指向线程池实例的指针
+ * @param function 任务函数，不能为空
+ * @param arg 任务参数
+ * @param task_name 任务名称，为 NULL 时自动生成
+ * @param priority 任务优先级
+ * @return 成功时返回任务的完成句柄，错误时返回 NULL
+ */
+task_future_t thread_pool_add_task_with_future(thread_pool_t pool, void (*function)(void *), void *arg,
+                                               const char *task_name, task_priority_t priority)
+{
+    if (pool == NULL || function == NULL) {
+        TPOOL_ERROR("thread_pool_add_task_with_future: 无效参数 (pool: %p, function: %s)", (void *)pool,
+                    function == NULL ? "NULL" : "非空");
+        return NULL;
+    }
+
+    task_future_t future = task_future_create(0);
+    if (future == NULL) {
+        return NULL;
+    }
+
+    pthread_mutex_lock(&(pool->lock));
+
+    if (pool->shutdown) {
+        TPOOL_ERROR("thread_pool_add_task_with_future: 尝试向正在关闭的线程池 %p 添加任务", (void *)pool);
+        pthread_mutex_unlock(&(pool->lock));
+        task_future_release(future);
+        return NULL;
+    }
+
+    task_id_t new_task_id = pool->next_task_id++;
+    future->task_id = new_task_id;
+    task_future_retain(future); // 节点持有的引用
+    if (task_submit_locked(pool, function, arg, task_name, priority, new_task_id, future, -1, NULL) != 0) {
+        pthread_mutex_unlock(&(pool->lock));
+        task_future_release(future);
+        task_future_release(future);
+        return NULL;
+    }
+    pool_wake_idle_locked(pool, 1);
+    pthread_mutex_unlock(&(pool->lock));
+
+    if (pool->auto_adjust) {
+        pthread_mutex_lock(&pool->adjust_cond_lock);
+        pthread_cond_signal(&pool->adjust_cond);
+        pthread_mutex_unlock(&pool->adjust_cond_lock);
+    }
+
+    TPOOL_DEBUG("任务 (ID: %lu) 已添加到线程池 %p 并登记完成句柄 %p。", (unsigned long)new_task_id,
+              (void *)pool, (void *)future);
+    return future;
+}
+
+/**
+ * @brief 获取已提交任务的完成句柄
+ *
+ * 任务尚未登记句柄时创建一个新句柄并登记到任务节点上。
+ *
+ * @param pool 指向线程池实例的指针
+ * @param task_id 排队中或正在执行的任务ID
+ * @return 任务的完成句柄；任务不存在、参数无效或内存分配失败时返回 NULL
+ */
+task_future_t thread_pool_get_task_future(thread_pool_t pool, task_id_t task_id)
+{
+    if (pool == NULL || task_id == 0) {
+        TPOOL_ERROR("thread_pool_get_task_future: 线程池为NULL或任务ID无效。");
+        return NULL;
+    }
+
+    // 在锁外预先创建句柄，任务已有句柄时再丢弃
+    task_future_t created = task_future_create(task_id);
+    if (created == NULL) {
+        return NULL;
+    }
+
+    pthread_mutex_lock(&(pool->lock));
+    task_node_t *node = task_index_find_id(&pool->id_index, task_id);
+    if (node == NULL) {
+        pthread_mutex_unlock(&(pool->lock));
+        task_future_release(created);
+        TPOOL_DEBUG("线程池 %p: 任务ID %lu 不存在，无法获取完成句柄。", (void *)pool, (unsigned long)task_id);
+        return NULL;
+    }
+    task_future_t future = node->future;
+    if (future == NULL) {
+        future = created;
+        created = NULL;
+        task_future_retain(future); // 节点持有的引用
+        node->future = future;
+    } else {
+        task_future_retain(future);
+    }
+    pthread_mutex_unlock(&(pool->lock));
+
+    task_future_release(created);
+    return future;
+}
+
+/**
+ * @brief 在任务函数内部设置当前任务的结果指针
+ *
+ * @param result 结果指针
+ * @return 成功返回 0；不是在线程池任务内部调用时返回 -1
+ */
+int thread_pool_set_task_result(void *result)
+{
+    if (tls_worker.current_node == NULL) {
+        TPOOL_ERROR("thread_pool_set_task_result: 只能在线程池任务内部调用。");
+        return -1;
+    }
+    // 节点在执行期间只由当前线程写入，完成时在池锁内交给完成句柄
+    tls_worker.current_node->result = result;
+    return 0;
+}
@@ -0,0 +1,354 @@
+/**
+ * @file thread_affinity.c
+ * @brief 工作线程的 CPU 绑定、NUMA 节点归属和线程属性。
+ *
+ * NUMA 拓扑从 /sys/devices/system/node 读取，不依赖 libnuma；
+ * 读取失败时把所有 CPU 视为节点 0。CPU 亲和性仅在 Linux 上支持，
+ * 其他平台上只能使用 THREAD_POOL_PIN_NONE 且不能指定 CPU 集合。
+ */
+#ifndef _GNU_SOURCE
+#define _GNU_SOURCE // pthread_attr_setaffinity_np、sched_getaffinity
+#endif
+#include "thread_internal.h"
+#include <errno.h>
+#include <limits.h>
+#include <sched.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#ifdef __linux__
+
+/**
+ * @def AFFINITY_MAX_NODES
+ * @brief 支持的最大 NUMA 节点编号 (不含)。
+ */
+#define AFFINITY_MAX_NODES 1024
+
+/**
+ * @brief 解析 sysfs 的编号列表 (例如 "0-3,8-11")，把列表中的每个编号 i 标记为 marks[i] = value (内部函数)。
+ *
+ * @param text 列表文本。
+ * @param marks 标记数组。
+ * @param size 标记数组长度，超出范围的编号被忽略。
+ * @param value 要写入的值。
+ * @return 成功返回 0，文本格式错误返回 -1 (错误之前的编号已被标记)。
+ */
+static int affinity_parse_list(const char *text, int *marks, int size, int value)
+{
+    const char *p = text;
+    while (*p != '\0' && *p != '\n') {
+        char *end = NULL;
+        long first = strtol(p, &end, 10);
+        if (end == p) {
+            return -1;
+        }
+        long last = first;
+        p = end;
+        if (*p == '-') {
+            last = strtol(p + 1, &end, 10);
+            if (end == p + 1) {
+                return -1;
+            }
+            p = end;
+        }
+        for (long i = first < 0 ? 0 : first; i <= last && i < size; i++) {
+            marks[i] = value;
+        }
+        if (*p == ',') {
+            p++;
+        } else if (*p != '\0' && *p != '\n') {
+            return -1;
+        }
+    }
+    return 0;
+}
+
+/**
+ * @brief 读取 sysfs 文件的第一行并按编号列表解析 (内部函数)。
+ *
+ * @return 成功返回 0，文件不存在或读取失败返回 -1，内容无法解析返回 -2。
+ */
+static int affinity_read_list(const char *path, int *marks, int size, int value)
+{
+    char text[1024];
+    FILE *file = fopen(path, "r");
+    if (file == NULL) {
+        return -1;
+    }
+    int result = fgets(text, sizeof(text), file) != NULL ? 0 : -1;
+    fclose(file);
+    if (result == 0 && affinity_parse_list(text, marks, size, value) != 0) {
+        result = -2;
+    }
+    return result;
+}
+
+/**
+ * @brief 读取每个 CPU 所在的 NUMA 节点 (内部函数)。
+ *
+ * 内核不提供 NUMA 信息 (没有 /sys/devices/system/node/online) 时所有 CPU 都记为节点 0，不视为错误。
+ * 节点列表或某个节点的 CPU 列表无法读取或解析时记录警告，同样退回到所有 CPU 都在节点 0。
+ *
+ * @param cpu_nodes 长度为 CPU_SETSIZE 的数组。
+ * @return 成功返回 0，内存分配失败返回 -1。
+ */
+static int affinity_read_topology(int *cpu_nodes)
+{
+    for (int cpu = 0; cpu < CPU_SETSIZE; cpu++) {
+        cpu_nodes[cpu] = 0;
+    }
+    int *online = (int *)calloc(AFFINITY_MAX_NODES, sizeof(int));
+    if (online == NULL) {
+        TPOOL_ERROR("未能为 NUMA 节点列表分配内存。");
+        return -1;
+    }
+    char path[64] = "/sys/devices/system/node/online";
+    int result = affinity_read_list(path, online, AFFINITY_MAX_NODES, 1);
+    int failed = result == -2; // 节点列表不存在不算错误
+    for (int node = 0; result == 0 && node < AFFINITY_MAX_NODES; node++) {
+        if (online[node]) {
+            snprintf(path, sizeof(path), "/sys/devices/system/node/node%d/cpulist", node);
+            result = affinity_read_list(path, cpu_nodes, CPU_SETSIZE, node);
+            failed = result != 0;
+        }
+    }
+    free(online);
+    if (failed) {
+        TPOOL_WARN("%s %s，所有 CPU 视为 NUMA 节点 0。", path, result == -2 ? "格式无法解析" : "读取失败");
+        for (int cpu = 0; cpu < CPU_SETSIZE; cpu++) {
+            cpu_nodes[cpu] = 0;
+        }
+    }
+    return 0;
+}
+
+/**
+ * @brief 紧凑顺序中 CPU a 是否应排在 CPU b 之后：先比较节点，再比较 CPU 编号 (内部函数)。
+ */
+static inline int affinity_cpu_after(int cpu_a, int cpu_b, const int *cpu_nodes)
+{
+    if (cpu_nodes[cpu_a] != cpu_nodes[cpu_b]) {
+        return cpu_nodes[cpu_a] > cpu_nodes[cpu_b];
+    }
+    return cpu_a > cpu_b;
+}
+
+#endif /* __linux__ */
+
+int worker_placement_init(worker_placement_t *placement, const thread_pool_config_t *config)
+{
+    memset(placement, 0, sizeof(*placement));
+    placement->policy = config->pin_policy;
+    placement->stack_size = config->stack_size;
+    placement->sched_policy = config->sched_policy;
+    placement->sched_priority = config->sched_priority;
+
+    if (config->pin_policy < THREAD_POOL_PIN_NONE || config->pin_policy > THREAD_POOL_PIN_NUMA_NODE ||
+        config->cpu_count < 0 || (config->cpus == NULL && config->cpu_count > 0)) {
+        TPOOL_ERROR("无效的 CPU 绑定选项 (策略: %d, CPU 数量: %d)。", (int)config->pin_policy, config->cpu_count);
+        return -1;
+    }
+    if (config->stack_size != 0 && config->stack_size < (size_t)PTHREAD_STACK_MIN) {
+        TPOOL_ERROR("工作线程栈大小 %zu 小于系统最小值 %zu。", config->stack_size, (size_t)PTHREAD_STACK_MIN);
+        return -1;
+    }
+    if (config->sched_policy != -1) {
+        int min_priority = sched_get_priority_min(config->sched_policy);
+        int max_priority = sched_get_priority_max(config->sched_policy);
+        if (min_priority == -1 || config->sched_priority < min_priority || config->sched_priority > max_priority) {
+            TPOOL_ERROR("无效的调度策略 %d 或优先级 %d。", config->sched_policy, config->sched_priority);
+            return -1;
+        }
+    }
+
+    int use_cpus = config->pin_policy != THREAD_POOL_PIN_NONE || config->cpu_count > 0;
+    if (!use_cpus) {
+        return 0;
+    }
+
+#ifdef __linux__
+    // 确定允许使用的 CPU：调用者给出的集合，或进程当前的亲和性
+    cpu_set_t allowed;
+    CPU_ZERO(&allowed);
+    if (config->cpu_count > 0) {
+        for (int i = 0; i < config->cpu_count; i++) {
+            if (config->cpus[i] < 0 || config->cpus[i] >= CPU_SETSIZE) {
+                TPOOL_ERROR("无效的 CPU 编号: %d。", config->cpus[i]);
+                return -1;
+            }
+            CPU_SET(config->cpus[i], &allowed);
+        }
+    } else if (sched_getaffinity(0, sizeof(allowed), &allowed) != 0) {
+        TPOOL_ERROR("读取进程 CPU 亲和性失败: %s。", strerror(errno));
+        return -1;
+    }
+
+    int *cpu_nodes = (int *)malloc(CPU_SETSIZE * sizeof(int));
+    placement->cpus = (int *)malloc((size_t)CPU_COUNT(&allowed) * sizeof(int));
+    placement->cpu_nodes = (int *)malloc((size_t)CPU_COUNT(&allowed) * sizeof(int));
+    placement->nodes = (int *)malloc((size_t)CPU_COUNT(&allowed) * sizeof(int));
+    if (cpu_nodes == NULL || placement->cpus == NULL || placement->cpu_nodes == NULL || placement->nodes == NULL) {
+        TPOOL_ERROR("未能为 CPU 绑定信息分配内存。");
+        free(cpu_nodes);
+        worker_placement_destroy(placement);
+        return -1;
+    }
+    if (affinity_read_topology(cpu_nodes) != 0) {
+        free(cpu_nodes);
+        worker_placement_destroy(placement);
+        return -1;
+    }
+
+    for (int cpu = 0; cpu < CPU_SETSIZE; cpu++) {
+        if (CPU_ISSET(cpu, &allowed)) {
+            placement->cpus[placement->cpu_count++] = cpu;
+        }
+    }
+
+    // 紧凑顺序：先按节点再按 CPU 编号 (插入排序，CPU 数量很小)
+    for (int i = 1; i < placement->cpu_count; i++) {
+        int cpu = placement->cpus[i];
+        int j = i - 1;
+        while (j >= 0 && affinity_cpu_after(placement->cpus[j], cpu, cpu_nodes)) {
+            placement->cpus[j + 1] = placement->cpus[j];
+            j--;
+        }
+        placement->cpus[j + 1] = cpu;
+    }
+    for (int i = 0; i < placement->cpu_count; i++) {
+        int node = cpu_nodes[placement->cpus[i]];
+        placement->cpu_nodes[i] = node;
+        if (placement->node_count == 0 || placement->nodes[placement->node_count - 1] != node) {
+            placement->nodes[placement->node_count++] = node;
+        }
+        if (node + 1 > placement->max_node) {
+            placement->max_node = node + 1;
+        }
+    }
+    free(cpu_nodes);
+
+    // 分散顺序：依次从每个节点取下一个 CPU
+    if (placement->policy == THREAD_POOL_PIN_SCATTER && placement->node_count > 1) {
+        int *scattered = (int *)malloc((size_t)placement->cpu_count * sizeof(int));
+        int *scattered_nodes = (int *)malloc((size_t)placement->cpu_count * sizeof(int));
+        int *next = (int *)calloc((size_t)placement->node_count, sizeof(int));
+        if (scattered == NULL || scattered_nodes == NULL || next == NULL) {
+            TPOOL_ERROR("未能为 CPU 绑定信息分配内存。");
+            free(scattered);
+            free(scattered_nodes);
+            free(next);
+            worker_placement_destroy(placement);
+            return -1;
+        }
+        // next[n] 为节点 n 在紧凑顺序中下一个未使用 CPU 的下标
+        for (int n = 0, i = 0; n < placement->node_count; n++) {
+            while (i < placement->cpu_count && placement->cpu_nodes[i] != placement->nodes[n]) {
+                i++;
+            }
+            next[n] = i;
+        }
+        int count = 0;
+        while (count < placement->cpu_count) {
+            for (int n = 0; n < placement->node_count; n++) {
+                int i = next[n];
+                if (i < placement->cpu_count && placement->cpu_nodes[i] == placement->nodes[n]) {
+                    scattered[count] = placement->cpus[i];
+                    scattered_nodes[count] = placement->cpu_nodes[i];
+                    count++;
+                    next[n]++;
+                }
+            }
+        }
+        free(placement->cpus);
+        free(placement->cpu_nodes);
+        free(next);
+        placement->cpus = scattered;
+        placement->cpu_nodes = scattered_nodes;
+    }
+    TPOOL_DEBUG("工作线程绑定策略 %d: %d 个 CPU，分布在 %d 个 NUMA 节点上。", (int)placement->policy,
+              placement->cpu_count, placement->node_count);
+    return 0;
+#else
+    TPOOL_ERROR("当前平台不支持设置工作线程的 CPU 亲和性。");
+    return -1;
+#endif
+}
+
+void worker_placement_destroy(worker_placement_t *placement)
+{
+    free(placement->cpus);
+    free(placement->cpu_nodes);
+    free(placement->nodes);
+    placement->cpus = NULL;
+    placement->cpu_nodes = NULL;
+    placement->nodes = NULL;
+    placement->cpu_count = 0;
+    placement->node_count = 0;
+    placement->max_node = 0;
+}
+
+int worker_placement_node(const worker_placement_t *placement, int thread_id)
+{
+    switch (placement->policy) {
+    case THREAD_POOL_PIN_COMPACT:
+    case THREAD_POOL_PIN_SCATTER:
+        return placement->cpu_nodes[thread_id % placement->cpu_count];
+    case THREAD_POOL_PIN_NUMA_NODE:
+        return placement->nodes[thread_id % placement->node_count];
+    default:
+        return -1;
+    }
+}
+
+int worker_placement_create_thread(const worker_placement_t *placement, int thread_id, pthread_t *thread,
+                                   void *(*start_routine)(void *), void *arg)
+{
+    if (placement->cpu_count == 0 && placement->stack_size == 0 && placement->sched_policy == -1) {
+        return pthread_create(thread, NULL, start_routine, arg);
+    }
+
+    pthread_attr_t attr;
+    int result = pthread_attr_init(&attr);
+    if (result != 0) {
+        return result;
+    }
+    if (placement->stack_size != 0) {
+        result = pthread_attr_setstacksize(&attr, placement->stack_size);
+    }
+    if (result == 0 && placement->sched_policy != -1) {
+        struct sched_param param;
+        memset(&param, 0, sizeof(param));
+        param.sched_priority = placement->sched_priority;
+        result = pthread_attr_setinheritsched(&attr, PTHREAD_EXPLICIT_SCHED);
+        if (result == 0) {
+            result = pthread_attr_setschedpolicy(&attr, placement->sched_policy);
+        }
+        if (result == 0) {
+            result = pthread_attr_setschedparam(&attr, &param);
+        }
+    }
+#ifdef __linux__
+    if (result == 0 && placement->cpu_count > 0) {
+        cpu_set_t cpus;
+        CPU_ZERO(&cpus);
+        if (placement->policy == THREAD_POOL_PIN_COMPACT || placement->policy == THREAD_POOL_PIN_SCATTER) {
+            CPU_SET(placement->cpus[thread_id % placement->cpu_count], &cpus);
+        } else {
+            // 按节点归属时可在该节点所有允许的 CPU 上运行；不绑定时可在整个集合上运行
+            int node = worker_placement_node(placement, thread_id);
+            for (int i = 0; i < placement->cpu_count; i++) {
+                if (node < 0 || placement->cpu_nodes[i] == node) {
+                    CPU_SET(placement->cpus[i], &cpus);
+                }
+            }
+        }
+        result = pthread_attr_setaffinity_np(&attr, sizeof(cpus), &cpus);
+    }
+#endif
+    if (result == 0) {
+        result = pthread_create(thread, &attr, start_routine, arg);
+    }
+    pthread_attr_destroy(&attr);
+    return result;
+}
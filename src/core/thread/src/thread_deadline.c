@@ -0,0 +1,123 @@
+/**
+ * @file thread_deadline.c
+ * @brief 截止时间调度使用的二叉最小堆实现。
+ *
+ * 条目中复制了级别、截止时间和入堆序号，上浮和下沉时只比较数组中的条目，
+ * 只有条目移动时才写回节点记录的位置，从而支持按节点 O(log n) 删除 (取消任务)。
+ */
+#include "thread_internal.h"
+#include <stdlib.h>
+
+/** 堆数组首次分配的容量。 */
+#define DEADLINE_HEAP_INITIAL_CAPACITY 64
+
+void deadline_heap_init(deadline_heap_t *heap)
+{
+    heap->entries = NULL;
+    heap->size = 0;
+    heap->capacity = 0;
+    heap->next_seq = 0;
+}
+
+void deadline_heap_destroy(deadline_heap_t *heap)
+{
+    free(heap->entries);
+    heap->entries = NULL;
+    heap->size = 0;
+    heap->capacity = 0;
+}
+
+int deadline_heap_reserve(deadline_heap_t *heap)
+{
+    if (heap->size < heap->capacity) {
+        return 0;
+    }
+    int new_capacity = heap->capacity > 0 ? heap->capacity * 2 : DEADLINE_HEAP_INITIAL_CAPACITY;
+    deadline_entry_t *entries =
+        (deadline_entry_t *)realloc(heap->entries, (size_t)new_capacity * sizeof(deadline_entry_t));
+    if (entries == NULL) {
+        TPOOL_ERROR("deadline_heap_reserve: 未能为 %d 个截止时间堆条目分配内存", new_capacity);
+        return -1;
+    }
+    heap->entries = entries;
+    heap->capacity = new_capacity;
+    return 0;
+}
+
+/**
+ * @brief 条目 a 是否应排在条目 b 之前 (内部函数)。
+ */
+static inline int deadline_entry_before(const deadline_entry_t *a, const deadline_entry_t *b)
+{
+    if (a->level != b->level) {
+        return a->level < b->level;
+    }
+    return a->deadline < b->deadline || (a->deadline == b->deadline && a->seq < b->seq);
+}
+
+/**
+ * @brief 把条目放到指定位置并更新节点记录的位置 (内部函数)。
+ */
+static inline void deadline_heap_set(deadline_heap_t *heap, int index, deadline_entry_t entry)
+{
+    heap->entries[index] = entry;
+    entry.node->deadline_index = index;
+}
+
+/**
+ * @brief 把条目从指定位置上浮或下沉到合适的位置 (内部函数)。
+ */
+static void deadline_heap_sift(deadline_heap_t *heap, int index, deadline_entry_t entry)
+{
+    while (index > 0) {
+        int parent = (index - 1) / 2;
+        if (!deadline_entry_before(&entry, &heap->entries[parent])) {
+            break;
+        }
+        deadline_heap_set(heap, index, heap->entries[parent]);
+        index = parent;
+    }
+    while (1) {
+        int child = index * 2 + 1;
+        if (child >= heap->size) {
+            break;
+        }
+        if (child + 1 < heap->size && deadline_entry_before(&heap->entries[child + 1], &heap->entries[child])) {
+            child++;
+        }
+        if (!deadline_entry_before(&heap->entries[child], &entry)) {
+            break;
+        }
+        deadline_heap_set(heap, index, heap->entries[child]);
+        index = child;
+    }
+    deadline_heap_set(heap, index, entry);
+}
+
+void deadline_heap_push(deadline_heap_t *heap, task_node_t *node, int level)
+{
+    deadline_entry_t entry = {level, node->deadline_ns, heap->next_seq++, node};
+    heap->size++;
+    deadline_heap_sift(heap, heap->size - 1, entry);
+}
+
+task_node_t *deadline_heap_pop(deadline_heap_t *heap)
+{
+    if (heap->size == 0) {
+        return NULL;
+    }
+    task_node_t *node = heap->entries[0].node;
+    deadline_heap_remove(heap, node);
+    return node;
+}
+
+void deadline_heap_remove(deadline_heap_t *heap, task_node_t *node)
+{
+    int index = node->deadline_index;
+    heap->size--;
+    if (index < heap->size) {
+        // 用最后一个条目填补空位，它可能需要上浮也可能需要下沉
+        deadline_heap_sift(heap, index, heap->entries[heap->size]);
+    }
+    node->deadline_index = -1;
+}
@@ -0,0 +1,282 @@
+/**
+ * @file thread_future.c
+ * @brief 任务完成句柄 (future) 的实现。
+ *
+ * 每个句柄有自己的互斥锁和条件变量，任务结束时只唤醒等待该句柄的线程。
+ * wait_any 通过在多个句柄上登记同一个等待者实现。
+ */
+#include "thread_internal.h"
+#include <errno.h>
+#include <stdlib.h>
+#include <time.h>
+
+int monotonic_cond_init(pthread_cond_t *cond)
+{
+    pthread_condattr_t attr;
+    if (pthread_condattr_init(&attr) != 0) {
+        return -1;
+    }
+    int result = pthread_condattr_setclock(&attr, CLOCK_MONOTONIC);
+    if (result == 0) {
+        result = pthread_cond_init(cond, &attr);
+    }
+    pthread_condattr_destroy(&attr);
+    return result == 0 ? 0 : -1;
+}
+
+const struct timespec *monotonic_deadline(struct timespec *deadline, int timeout_ms)
+{
+    if (timeout_ms < 0) {
+        return NULL;
+    }
+    clock_gettime(CLOCK_MONOTONIC, deadline);
+    deadline->tv_sec += timeout_ms / 1000;
+    deadline->tv_nsec += (long)(timeout_ms % 1000) * 1000000L;
+    if (deadline->tv_nsec >= 1000000000L) {
+        deadline->tv_sec += 1;
+        deadline->tv_nsec -= 1000000000L;
+    }
+    return deadline;
+}
+
+/**
+ * @brief 等待句柄结束直到截止时间 (内部函数)。
+ *
+ * @param deadline 绝对截止时间，为 NULL 时无限等待。
+ * @return 句柄已结束返回 0，超时返回 -1。
+ */
+static int future_wait_until(task_future_t future, const struct timespec *deadline)
+{
+    pthread_mutex_lock(&future->lock);
+    while (future->state == TASK_FUTURE_PENDING) {
+        if (deadline == NULL) {
+            pthread_cond_wait(&future->cond, &future->lock);
+        } else if (pthread_cond_timedwait(&future->cond, &future->lock, deadline) == ETIMEDOUT) {
+            break;
+        }
+    }
+    int finished = future->state != TASK_FUTURE_PENDING;
+    pthread_mutex_unlock(&future->lock);
+    return finished ? 0 : -1;
+}
+
+task_future_t task_future_create(task_id_t task_id)
+{
+    task_future_t future = (task_future_t)malloc(sizeof(struct task_future_s));
+    if (future == NULL) {
+        TPOOL_ERROR("task_future_create: 未能为任务 %lu 的完成句柄分配内存", (unsigned long)task_id);
+        return NULL;
+    }
+    if (pthread_mutex_init(&future->lock, NULL) != 0) {
+        free(future);
+        return NULL;
+    }
+    if (monotonic_cond_init(&future->cond) != 0) {
+        pthread_mutex_destroy(&future->lock);
+        free(future);
+        return NULL;
+    }
+    future->state = TASK_FUTURE_PENDING;
+    future->result = NULL;
+    future->task_id = task_id;
+    atomic_init(&future->refs, 1);
+    future->waiters = NULL;
+    return future;
+}
+
+void task_future_retain(task_future_t future)
+{
+    atomic_fetch_add_explicit(&future->refs, 1, memory_order_relaxed);
+}
+
+void task_future_finish(task_future_t future, task_future_state_t state, void *result)
+{
+    pthread_mutex_lock(&future->lock);
+    future->state = state;
+    future->result = state == TASK_FUTURE_COMPLETED ? result : NULL;
+    pthread_cond_broadcast(&future->cond);
+    for (task_future_link_t *link = future->waiters; link != NULL; link = link->next) {
+        pthread_mutex_lock(&link->waiter->lock);
+        link->waiter->fired = 1;
+        pthread_cond_signal(&link->waiter->cond);
+        pthread_mutex_unlock(&link->waiter->lock);
+    }
+    pthread_mutex_unlock(&future->lock);
+}
+
+void task_future_release(task_future_t future)
+{
+    if (future == NULL) {
+        return;
+    }
+    if (atomic_fetch_sub_explicit(&future->refs, 1, memory_order_acq_rel) == 1) {
+        pthread_cond_destroy(&future->cond);
+        pthread_mutex_destroy(&future->lock);
+        free(future);
+    }
+}
+
+int task_future_wait(task_future_t future, int timeout_ms)
+{
+    if (future == NULL) {
+        TPOOL_ERROR("task_future_wait: 完成句柄为 NULL");
+        return -2;
+    }
+    struct timespec deadline;
+    return future_wait_until(future, monotonic_deadline(&deadline, timeout_ms));
+}
+
+int task_future_wait_all(task_future_t *futures, int count, int timeout_ms)
+{
+    if (futures == NULL || count <= 0) {
+        TPOOL_ERROR("task_future_wait_all: 无效参数 (futures: %p, count: %d)", (void *)futures, count);
+        return -2;
+    }
+    for (int i = 0; i < count; i++) {
+        if (futures[i] == NULL) {
+            TPOOL_ERROR("task_future_wait_all: 第 %d 个完成句柄为 NULL", i);
+            return -2;
+        }
+    }
+
+    // 所有句柄共享同一个截止时间
+    struct timespec deadline_storage;
+    const struct timespec *deadline = monotonic_deadline(&deadline_storage, timeout_ms);
+    for (int i = 0; i < count; i++) {
+        if (future_wait_until(futures[i], deadline) != 0) {
+            return -1;
+        }
+    }
+    return 0;
+}
+
+/**
+ * @brief 返回数组中第一个已结束句柄的下标 (内部函数)。
+ *
+ * @return 下标，全部未结束时返回 -1。
+ */
+static int future_first_finished(task_future_t *futures, int count)
+{
+    for (int i = 0; i < count; i++) {
+        pthread_mutex_lock(&futures[i]->lock);
+        int finished = futures[i]->state != TASK_FUTURE_PENDING;
+        pthread_mutex_unlock(&futures[i]->lock);
+        if (finished) {
+            return i;
+        }
+    }
+    return -1;
+}
+
+int task_future_wait_any(task_future_t *futures, int count, int timeout_ms)
+{
+    if (futures == NULL || count <= 0) {
+        TPOOL_ERROR("task_future_wait_any: 无效参数 (futures: %p, count: %d)", (void *)futures, count);
+        return -2;
+    }
+    for (int i = 0; i < count; i++) {
+        if (futures[i] == NULL) {
+            TPOOL_ERROR("task_future_wait_any: 第 %d 个完成句柄为 NULL", i);
+            return -2;
+        }
+    }
+
+    struct timespec deadline_storage;
+    const struct timespec *deadline = monotonic_deadline(&deadline_storage, timeout_ms);
+    int index = future_first_finished(futures, count);
+    if (index >= 0 || timeout_ms == 0) {
+        return index;
+    }
+
+    task_future_link_t *links = (task_future_link_t *)malloc((size_t)count * sizeof(task_future_link_t));
+    if (links == NULL) {
+        TPOOL_ERROR("task_future_wait_any: 未能为 %d 个等待者链表节点分配内存", count);
+        return -2;
+    }
+    task_future_waiter_t waiter;
+    if (pthread_mutex_init(&waiter.lock, NULL) != 0) {
+        free(links);
+        return -2;
+    }
+    if (monotonic_cond_init(&waiter.cond) != 0) {
+        pthread_mutex_destroy(&waiter.lock);
+        free(links);
+        return -2;
+    }
+    waiter.fired = 0;
+
+    // 在每个句柄上登记等待者；登记时已结束的句柄直接触发
+    int registered = 0;
+    for (; registered < count; registered++) {
+        task_future_t future = futures[registered];
+        pthread_mutex_lock(&future->lock);
+        if (future->state != TASK_FUTURE_PENDING) {
+            pthread_mutex_unlock(&future->lock);
+            // 已登记的句柄可能同时在 task_future_finish 中写 fired，必须持有等待者的锁
+            pthread_mutex_lock(&waiter.lock);
+            waiter.fired = 1;
+            pthread_mutex_unlock(&waiter.lock);
+            break;
+        }
+        links[registered].waiter = &waiter;
+        links[registered].next = future->waiters;
+        future->waiters = &links[registered];
+        pthread_mutex_unlock(&future->lock);
+    }
+
+    pthread_mutex_lock(&waiter.lock);
+    while (!waiter.fired) {
+        if (deadline == NULL) {
+            pthread_cond_wait(&waiter.cond, &waiter.lock);
+        } else if (pthread_cond_timedwait(&waiter.cond, &waiter.lock, deadline) == ETIMEDOUT) {
+            break;
+        }
+    }
+    pthread_mutex_unlock(&waiter.lock);
+
+    // 注销等待者，此后不会再有句柄访问 waiter
+    for (int i = 0; i < registered; i++) {
+        task_future_t future = futures[i];
+        pthread_mutex_lock(&future->lock);
+        task_future_link_t **link = &future->waiters;
+        while (*link != NULL && *link != &links[i]) {
+            link = &(*link)->next;
+        }
+        if (*link != NULL) {
+            *link = links[i].next;
+        }
+        pthread_mutex_unlock(&future->lock);
+    }
+    pthread_cond_destroy(&waiter.cond);
+    pthread_mutex_destroy(&waiter.lock);
+    free(links);
+
+    return future_first_finished(futures, count);
+}
+
+task_future_state_t task_future_get_state(task_future_t future)
+{
+    if (future == NULL) {
+        return TASK_FUTURE_CANCELLED;
+    }
+    pthread_mutex_lock(&future->lock);
+    task_future_state_t state = future->state;
+    pthread_mutex_unlock(&future->lock);
+    return state;
+}
+
+void *task_future_get_result(task_future_t future)
+{
+    if (future == NULL) {
+        return NULL;
+    }
+    pthread_mutex_lock(&future->lock);
+    void *result = future->result;
+    pthread_mutex_unlock(&future->lock);
+    return result;
+}
+
+task_id_t task_future_get_task_id(task_future_t future)
+{
+    return future != NULL ? future->task_id : 0;
+}
@@ -0,0 +1,459 @@
+/**
+ * @file thread_graph.c
+ * @brief 任务依赖图的实现。
+ *
+ * 每个节点保存前驱数量和后继下标。运行开始时把各节点的前驱计数重置为前驱数量并提交根节点；
+ * 节点执行完成后由工作线程无锁地递减各后继的计数，计数归零的后继在一次池锁内批量提交。
+ * 整张图的结束由 remaining 计数判断。节点在线程池把它移出任务索引之后才计入结束，
+ * 因此等待者醒来后立即再次运行时不会与上一次运行的任务ID或名称冲突。
+ * 只有把 remaining 减到 0 的线程才获取图的锁并唤醒等待者，并且这是该线程对图的最后一次访问，
+ * 等待者醒来后可以立即复用或销毁依赖图。
+ * 锁顺序：池锁 -> 图锁，持有图锁时从不获取池锁。
+ */
+#include "thread_internal.h"
+#include <errno.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+/** 一次批量提交的最大任务数量，超过时分批提交。 */
+#define TASK_GRAPH_SUBMIT_BATCH 32
+
+task_graph_t task_graph_create(thread_pool_t pool)
+{
+    if (pool == NULL) {
+        TPOOL_ERROR("task_graph_create: 线程池为 NULL");
+        return NULL;
+    }
+    task_graph_t graph = (task_graph_t)calloc(1, sizeof(struct task_graph_s));
+    if (graph == NULL) {
+        TPOOL_ERROR("task_graph_create: 未能为依赖图分配内存");
+        return NULL;
+    }
+    if (pthread_mutex_init(&graph->lock, NULL) != 0) {
+        free(graph);
+        return NULL;
+    }
+    if (monotonic_cond_init(&graph->cond) != 0) {
+        pthread_mutex_destroy(&graph->lock);
+        free(graph);
+        return NULL;
+    }
+    graph->pool = pool;
+    atomic_init(&graph->remaining, 0);
+    atomic_init(&graph->cancelled, 0);
+    return graph;
+}
+
+/**
+ * @brief 按任务ID查找节点 (内部函数)。节点按ID递增保存，使用二分查找。
+ */
+static task_graph_node_t *task_graph_find(task_graph_t graph, task_id_t task_id)
+{
+    int low = 0;
+    int high = graph->node_count - 1;
+    while (low <= high) {
+        int mid = low + (high - low) / 2;
+        task_graph_node_t *node = graph->nodes[mid];
+        if (node->task_id == task_id) {
+            return node;
+        }
+        if (node->task_id < task_id) {
+            low = mid + 1;
+        } else {
+            high = mid - 1;
+        }
+    }
+    return NULL;
+}
+
+/**
+ * @brief 把节点追加到前驱的后继数组 (内部函数)。
+ *
+ * @return 成功返回 0，内存分配失败返回 -1。
+ */
+static int task_graph_link(task_graph_node_t *pred, task_graph_node_t *successor)
+{
+    if (pred->successor_count == pred->successor_capacity) {
+        int capacity = pred->successor_capacity > 0 ? pred->successor_capacity * 2 : 4;
+        task_graph_node_t **successors =
+            (task_graph_node_t **)realloc(pred->successors, (size_t)capacity * sizeof(task_graph_node_t *));
+        if (successors == NULL) {
+            return -1;
+        }
+        pred->successors = successors;
+        pred->successor_capacity = capacity;
+    }
+    pred->successors[pred->successor_count++] = successor;
+    return 0;
+}
+
+task_id_t task_graph_add_task(task_graph_t graph, void (*function)(void *), void *arg, const char *task_name,
+                              task_priority_t priority, const task_id_t *deps, int dep_count)
+{
+    if (graph == NULL || function == NULL || dep_count < 0 || (deps == NULL && dep_count > 0)) {
+        TPOOL_ERROR("task_graph_add_task: 无效参数 (graph: %p, function: %s, dep_count: %d)", (void *)graph,
+                    function == NULL ? "NULL" : "非空", dep_count);
+        return 0;
+    }
+
+    // 在获取图锁之前分配任务ID (需要池锁，持有图锁时不能获取)，添加失败时该ID不再复用；
+    // 并发添加时ID较大的节点可能先登记，因此下面按ID插入到有序位置
+    task_id_t task_id = pool_reserve_task_ids(graph->pool, 1);
+    if (task_id == 0) {
+        TPOOL_ERROR("task_graph_add_task: 线程池 %p 正在关闭", (void *)graph->pool);
+        return 0;
+    }
+
+    pthread_mutex_lock(&graph->lock);
+    if (graph->running) {
+        TPOOL_ERROR("task_graph_add_task: 依赖图 %p 正在运行，不能添加任务", (void *)graph);
+        pthread_mutex_unlock(&graph->lock);
+        return 0;
+    }
+    for (int i = 0; i < dep_count; i++) {
+        if (task_graph_find(graph, deps[i]) == NULL) {
+            TPOOL_ERROR("task_graph_add_task: 前驱任务 %lu 不属于依赖图 %p", (unsigned long)deps[i], (void *)graph);
+            pthread_mutex_unlock(&graph->lock);
+            return 0;
+        }
+    }
+
+    if (graph->node_count == graph->node_capacity) {
+        int capacity = graph->node_capacity > 0 ? graph->node_capacity * 2 : 8;
+        task_graph_node_t **nodes =
+            (task_graph_node_t **)realloc(graph->nodes, (size_t)capacity * sizeof(task_graph_node_t *));
+        if (nodes == NULL) {
+            TPOOL_ERROR("task_graph_add_task: 未能为依赖图 %p 扩展节点数组", (void *)graph);
+            pthread_mutex_unlock(&graph->lock);
+            return 0;
+        }
+        graph->nodes = nodes;
+        graph->node_capacity = capacity;
+    }
+    task_graph_node_t *node = (task_graph_node_t *)calloc(1, sizeof(task_graph_node_t));
+    if (node == NULL) {
+        TPOOL_ERROR("task_graph_add_task: 未能为依赖图 %p 分配节点", (void *)graph);
+        pthread_mutex_unlock(&graph->lock);
+        return 0;
+    }
+
+    // 先登记到所有前驱的后继数组，失败时撤销已登记的部分
+    for (int i = 0; i < dep_count; i++) {
+        if (task_graph_link(task_graph_find(graph, deps[i]), node) != 0) {
+            TPOOL_ERROR("task_graph_add_task: 未能为依赖图 %p 扩展后继数组", (void *)graph);
+            for (int j = 0; j < i; j++) {
+                task_graph_find(graph, deps[j])->successor_count--;
+            }
+            free(node);
+            pthread_mutex_unlock(&graph->lock);
+            return 0;
+        }
+    }
+
+    node->graph = graph;
+    node->function = function;
+    node->arg = arg;
+    if (task_name != NULL) {
+        snprintf(node->task_name, MAX_TASK_NAME_LEN, "%s", task_name);
+    }
+    node->priority = priority;
+    node->task_id = task_id;
+    node->dep_count = dep_count;
+    atomic_init(&node->pending, 0);
+    atomic_init(&node->state, TASK_GRAPH_NODE_DONE);
+    int index = graph->node_count;
+    while (index > 0 && graph->nodes[index - 1]->task_id > task_id) {
+        graph->nodes[index] = graph->nodes[index - 1];
+        index--;
+    }
+    graph->nodes[index] = node;
+    graph->node_count++;
+    pthread_mutex_unlock(&graph->lock);
+
+    TPOOL_DEBUG("task_graph_add_task: 依赖图 %p 添加任务 %lu (前驱 %d 个)", (void *)graph, (unsigned long)task_id,
+              dep_count);
+    return task_id;
+}
+
+/**
+ * @brief 结束本次运行中的若干节点 (内部函数)。
+ *
+ * 把 remaining 减到 0 的线程清除 running 并唤醒等待者。调用后不得再访问依赖图。
+ */
+static void task_graph_finish_nodes(task_graph_t graph, int count)
+{
+    if (atomic_fetch_sub_explicit(&graph->remaining, count, memory_order_acq_rel) != count) {
+        return;
+    }
+    pthread_mutex_lock(&graph->lock);
+    graph->running = 0;
+    pthread_cond_broadcast(&graph->cond);
+    pthread_mutex_unlock(&graph->lock);
+}
+
+/**
+ * @brief 取消节点的所有尚未提交的后继 (内部函数)。
+ *
+ * 只有成功把状态从 PENDING 改为 CANCELLED 的调用者负责该节点，因此并发取消时每个节点只回调一次。
+ * 依赖链可能很长，用串在 cancel_next 上的显式工作栈代替递归；每个节点只会被一个调用者压栈，
+ * 因此不需要额外的内存。
+ *
+ * @return 本次取消的节点数量。
+ */
+static int task_graph_cancel_successors(task_graph_node_t *node, task_cancel_callback_t cancel_callback)
+{
+    int cancelled = 0;
+    node->cancel_next = NULL;
+    task_graph_node_t *stack = node;
+    while (stack != NULL) {
+        task_graph_node_t *current = stack;
+        stack = current->cancel_next;
+        for (int i = 0; i < current->successor_count; i++) {
+            task_graph_node_t *successor = current->successors[i];
+            int expected = TASK_GRAPH_NODE_PENDING;
+            if (!atomic_compare_exchange_strong_explicit(&successor->state, &expected, TASK_GRAPH_NODE_CANCELLED,
+                                                         memory_order_acq_rel, memory_order_acquire)) {
+                continue; // 已被其他前驱的取消处理
+            }
+            if (cancel_callback != NULL) {
+                cancel_callback(successor->arg, successor->task_id);
+            }
+            successor->cancel_next = stack;
+            stack = successor;
+            cancelled++;
+        }
+    }
+    return cancelled;
+}
+
+/**
+ * @brief 取消一个已经不会执行的节点及其后继，并计入本次运行的结束数量 (内部函数)。
+ *
+ * 节点自身的状态已由调用者改为 CANCELLED。调用后不得再访问依赖图。
+ *
+ * @param notify_self 是否为节点自身调用取消回调。
+ */
+static void task_graph_cancel_from(task_graph_node_t *node, task_cancel_callback_t cancel_callback,
+                                   int notify_self)
+{
+    task_graph_t graph = node->graph;
+    if (notify_self && cancel_callback != NULL) {
+        cancel_callback(node->arg, node->task_id);
+    }
+    int cancelled = 1 + task_graph_cancel_successors(node, cancel_callback);
+    atomic_fetch_add_explicit(&graph->cancelled, cancelled, memory_order_relaxed);
+    TPOOL_DEBUG("依赖图 %p: 任务 %lu 被取消，连同后继共取消 %d 个任务", (void *)graph,
+              (unsigned long)node->task_id, cancelled);
+    task_graph_finish_nodes(graph, cancelled);
+}
+
+/**
+ * @brief 把一批前驱已全部完成的节点提交到线程池 (内部函数)。
+ *
+ * 已被取消的节点跳过；提交失败 (线程池正在关闭、名称重复等) 的节点连同后继一起取消，不调用回调。
+ *
+ * @return 提交失败的节点数量。
+ */
+static int task_graph_submit(task_graph_t graph, task_graph_node_t **ready, int count)
+{
+    thread_pool_task_spec_t specs[TASK_GRAPH_SUBMIT_BATCH];
+    task_id_t task_ids[TASK_GRAPH_SUBMIT_BATCH];
+    task_graph_node_t *submitted[TASK_GRAPH_SUBMIT_BATCH];
+    int results[TASK_GRAPH_SUBMIT_BATCH];
+
+    int batch = 0;
+    for (int i = 0; i < count; i++) {
+        int expected = TASK_GRAPH_NODE_PENDING;
+        if (!atomic_compare_exchange_strong_explicit(&ready[i]->state, &expected, TASK_GRAPH_NODE_SUBMITTED,
+                                                     memory_order_acq_rel, memory_order_acquire)) {
+            continue; // 提交前已被取消
+        }
+        specs[batch].function = task_graph_node_run;
+        specs[batch].arg = ready[i];
+        specs[batch].task_name = ready[i]->task_name[0] != '\0' ? ready[i]->task_name : NULL;
+        specs[batch].priority = ready[i]->priority;
+        task_ids[batch] = ready[i]->task_id;
+        submitted[batch] = ready[i];
+        batch++;
+    }
+    if (batch == 0) {
+        return 0;
+    }
+
+    int failed = batch - pool_submit_with_ids(graph->pool, specs, task_ids, batch, results);
+    if (failed == 0) {
+        return 0;
+    }
+    for (int i = 0; i < batch; i++) {
+        if (results[i] == 0) {
+            continue;
+        }
+        TPOOL_ERROR("依赖图 %p: 未能提交任务 %lu，取消该任务及其后继", (void *)graph,
+                    (unsigned long)submitted[i]->task_id);
+        atomic_store_explicit(&submitted[i]->state, TASK_GRAPH_NODE_CANCELLED, memory_order_release);
+        task_graph_cancel_from(submitted[i], NULL, 0);
+    }
+    return failed;
+}
+
+int task_graph_run(task_graph_t graph)
+{
+    if (graph == NULL) {
+        TPOOL_ERROR("task_graph_run: 依赖图为 NULL");
+        return -2;
+    }
+
+    pthread_mutex_lock(&graph->lock);
+    if (graph->running) {
+        TPOOL_ERROR("task_graph_run: 依赖图 %p 的上一次运行尚未结束", (void *)graph);
+        pthread_mutex_unlock(&graph->lock);
+        return -1;
+    }
+    if (graph->node_count == 0) {
+        pthread_mutex_unlock(&graph->lock);
+        return 0;
+    }
+    for (int i = 0; i < graph->node_count; i++) {
+        task_graph_node_t *node = graph->nodes[i];
+        atomic_store_explicit(&node->pending, node->dep_count, memory_order_relaxed);
+        atomic_store_explicit(&node->state, TASK_GRAPH_NODE_PENDING, memory_order_relaxed);
+    }
+    atomic_store_explicit(&graph->cancelled, 0, memory_order_relaxed);
+    // 提交期间持有一个额外的计数，防止根节点在提交完所有根之前就让 remaining 归零
+    atomic_store_explicit(&graph->remaining, graph->node_count + 1, memory_order_release);
+    graph->running = 1;
+    int node_count = graph->node_count;
+    pthread_mutex_unlock(&graph->lock);
+
+    task_graph_node_t *ready[TASK_GRAPH_SUBMIT_BATCH];
+    int ready_count = 0;
+    int failed = 0;
+    for (int i = 0; i < node_count; i++) {
+        if (graph->nodes[i]->dep_count == 0) {
+            ready[ready_count++] = graph->nodes[i];
+            if (ready_count == TASK_GRAPH_SUBMIT_BATCH) {
+                failed += task_graph_submit(graph, ready, ready_count);
+                ready_count = 0;
+            }
+        }
+    }
+    failed += task_graph_submit(graph, ready, ready_count);
+    task_graph_finish_nodes(graph, 1);
+    if (failed > 0) {
+        TPOOL_ERROR("task_graph_run: 依赖图 %p 有 %d 个根任务未能提交", (void *)graph, failed);
+        return -1;
+    }
+    return 0;
+}
+
+void task_graph_node_run(void *arg)
+{
+    task_graph_node_t *node = (task_graph_node_t *)arg;
+    task_graph_t graph = node->graph;
+    node->function(node->arg);
+    atomic_store_explicit(&node->state, TASK_GRAPH_NODE_DONE, memory_order_release);
+
+    // 无锁地递减后继的前驱计数，只有把计数减到 0 的前驱负责提交该后继
+    task_graph_node_t *ready[TASK_GRAPH_SUBMIT_BATCH];
+    int ready_count = 0;
+    for (int i = 0; i < node->successor_count; i++) {
+        task_graph_node_t *successor = node->successors[i];
+        if (atomic_fetch_sub_explicit(&successor->pending, 1, memory_order_acq_rel) == 1) {
+            ready[ready_count++] = successor;
+            if (ready_count == TASK_GRAPH_SUBMIT_BATCH) {
+                task_graph_submit(graph, ready, ready_count);
+                ready_count = 0;
+            }
+        }
+    }
+    task_graph_submit(graph, ready, ready_count);
+}
+
+void task_graph_node_retired(void *arg)
+{
+    task_graph_node_t *node = (task_graph_node_t *)arg;
+    task_graph_finish_nodes(node->graph, 1);
+}
+
+void task_graph_node_cancelled(void *arg, task_cancel_callback_t cancel_callback)
+{
+    task_graph_node_t *node = (task_graph_node_t *)arg;
+    atomic_store_explicit(&node->state, TASK_GRAPH_NODE_CANCELLED, memory_order_release);
+    task_graph_cancel_from(node, cancel_callback, 1);
+}
+
+int task_graph_wait(task_graph_t graph, int timeout_ms)
+{
+    if (graph == NULL) {
+        TPOOL_ERROR("task_graph_wait: 依赖图为 NULL");
+        return -2;
+    }
+    struct timespec deadline_storage;
+    const struct timespec *deadline = monotonic_deadline(&deadline_storage, timeout_ms);
+
+    pthread_mutex_lock(&graph->lock);
+    while (graph->running) {
+        if (deadline == NULL) {
+            pthread_cond_wait(&graph->cond, &graph->lock);
+        } else if (pthread_cond_timedwait(&graph->cond, &graph->lock, deadline) == ETIMEDOUT) {
+            break;
+        }
+    }
+    int result = graph->running ? -1 : (atomic_load_explicit(&graph->cancelled, memory_order_relaxed) > 0);
+    pthread_mutex_unlock(&graph->lock);
+    return result;
+}
+
+int task_graph_cancel_task(task_graph_t graph, task_id_t task_id, task_cancel_callback_t cancel_callback)
+{
+    if (graph == NULL || task_id == 0) {
+        TPOOL_ERROR("task_graph_cancel_task: 依赖图为 NULL 或任务ID无效");
+        return -2;
+    }
+
+    // 只在查找时持有图锁，回调可能再次调用依赖图接口
+    pthread_mutex_lock(&graph->lock);
+    task_graph_node_t *node = graph->running ? task_graph_find(graph, task_id) : NULL;
+    pthread_mutex_unlock(&graph->lock);
+    if (node == NULL) {
+        TPOOL_DEBUG("task_graph_cancel_task: 任务 %lu 不属于依赖图 %p 或依赖图未在运行", (unsigned long)task_id,
+                  (void *)graph);
+        return -1;
+    }
+
+    int expected = TASK_GRAPH_NODE_PENDING;
+    if (atomic_compare_exchange_strong_explicit(&node->state, &expected, TASK_GRAPH_NODE_CANCELLED,
+                                                memory_order_acq_rel, memory_order_acquire)) {
+        task_graph_cancel_from(node, cancel_callback, 1);
+        return 0;
+    }
+    if (expected == TASK_GRAPH_NODE_SUBMITTED) {
+        // 已在线程池队列中，由 thread_pool_cancel_task 摘除并回调 task_graph_node_cancelled
+        return thread_pool_cancel_task(graph->pool, task_id, cancel_callback);
+    }
+    return -1;
+}
+
+int task_graph_destroy(task_graph_t graph)
+{
+    if (graph == NULL) {
+        return 0;
+    }
+    pthread_mutex_lock(&graph->lock);
+    int running = graph->running;
+    pthread_mutex_unlock(&graph->lock);
+    if (running) {
+        TPOOL_ERROR("task_graph_destroy: 依赖图 %p 正在运行，无法销毁", (void *)graph);
+        return -1;
+    }
+
+    for (int i = 0; i < graph->node_count; i++) {
+        free(graph->nodes[i]->successors);
+        free(graph->nodes[i]);
+    }
+    free(graph->nodes);
+    pthread_cond_destroy(&graph->cond);
+    pthread_mutex_destroy(&graph->lock);
+    free(graph);
+    return 0;
+}
@@ -0,0 +1,161 @@
+/**
+ * @file thread_index.c
+ * @brief 线程池任务索引 (按任务ID和任务名称) 的实现。
+ *
+ * 两个索引共用同一套线性探测开放寻址实现，仅键的哈希与比较方式不同。
+ * 槽位中直接存放任务节点指针，查找结果即为队列中的节点。
+ */
+#include "thread_internal.h"
+#include <stdlib.h>
+#include <string.h>
+
+uint32_t task_name_hash(const char *task_name)
+{
+    // FNV-1a
+    uint32_t hash = 2166136261u;
+    for (const unsigned char *p = (const unsigned char *)task_name; *p != '\0'; p++) {
+        hash ^= *p;
+        hash *= 16777619u;
+    }
+    return hash;
+}
+
+/**
+ * @brief 计算任务ID的哈希值 (内部函数)。
+ *
+ * 任务ID是连续递增的，使用斐波那契乘法散列将其均匀打散到槽位中。
+ */
+static inline uint32_t task_id_hash(task_id_t task_id)
+{
+    return (uint32_t)((task_id * UINT64_C(0x9E3779B97F4A7C15)) >> 32);
+}
+
+/**
+ * @brief 计算节点在指定索引中的键哈希值 (内部函数)。
+ */
+static inline uint32_t task_index_node_hash(const task_index_t *index, const task_node_t *node)
+{
+    return index->key == TASK_INDEX_BY_ID ? task_id_hash(node->id) : node->name_hash;
+}
+
+/**
+ * @brief 分配新的槽位数组并将现有节点重新散列到其中 (内部函数)。
+ *
+ * @return 成功返回 0，内存分配失败返回 -1 (原索引保持不变)。
+ */
+static int task_index_rehash(task_index_t *index, uint32_t new_capacity)
+{
+    task_node_t **new_slots = (task_node_t **)calloc(new_capacity, sizeof(task_node_t *));
+    if (new_slots == NULL) {
+        TPOOL_ERROR("task_index_rehash: 未能为 %u 个索引槽位分配内存", (unsigned)new_capacity);
+        return -1;
+    }
+    uint32_t mask = new_capacity - 1;
+    for (uint32_t i = 0; i < index->capacity; i++) {
+        task_node_t *node = index->slots[i];
+        if (node == NULL) {
+            continue;
+        }
+        uint32_t slot = task_index_node_hash(index, node) & mask;
+        while (new_slots[slot] != NULL) {
+            slot = (slot + 1) & mask;
+        }
+        new_slots[slot] = node;
+    }
+    free(index->slots);
+    index->slots = new_slots;
+    index->capacity = new_capacity;
+    return 0;
+}
+
+int task_index_init(task_index_t *index, task_index_key_t key)
+{
+    index->slots = (task_node_t **)calloc(TASK_INDEX_INITIAL_CAPACITY, sizeof(task_node_t *));
+    if (index->slots == NULL) {
+        return -1;
+    }
+    index->capacity = TASK_INDEX_INITIAL_CAPACITY;
+    index->size = 0;
+    index->key = key;
+    return 0;
+}
+
+void task_index_destroy(task_index_t *index)
+{
+    free(index->slots);
+    index->slots = NULL;
+    index->capacity = 0;
+    index->size = 0;
+}
+
+int task_index_reserve(task_index_t *index)
+{
+    if ((index->size + 1) * 2 <= index->capacity) {
+        return 0;
+    }
+    return task_index_rehash(index, index->capacity * 2);
+}
+
+void task_index_insert(task_index_t *index, task_node_t *node)
+{
+    uint32_t mask = index->capacity - 1;
+    uint32_t slot = task_index_node_hash(index, node) & mask;
+    while (index->slots[slot] != NULL) {
+        slot = (slot + 1) & mask;
+    }
+    index->slots[slot] = node;
+    index->size++;
+}
+
+void task_index_remove(task_index_t *index, const task_node_t *node)
+{
+    uint32_t mask = index->capacity - 1;
+    uint32_t slot = task_index_node_hash(index, node) & mask;
+    while (index->slots[slot] != node) {
+        if (index->slots[slot] == NULL) {
+            return; // 节点不在索引中
+        }
+        slot = (slot + 1) & mask;
+    }
+
+    // 向后移位删除：把探测链上后续可以前移的节点填入空位，保持查找无需墓碑
+    uint32_t hole = slot;
+    uint32_t next = (hole + 1) & mask;
+    while (index->slots[next] != NULL) {
+        uint32_t home = task_index_node_hash(index, index->slots[next]) & mask;
+        // home 不在 (hole, next] 区间内时，该节点可以移动到 hole
+        if (((next - home) & mask) >= ((next - hole) & mask)) {
+            index->slots[hole] = index->slots[next];
+            hole = next;
+        }
+        next = (next + 1) & mask;
+    }
+    index->slots[hole] = NULL;
+    index->size--;
+}
+
+task_node_t *task_index_find_id(const task_index_t *index, task_id_t task_id)
+{
+    uint32_t mask = index->capacity - 1;
+    uint32_t slot = task_id_hash(task_id) & mask;
+    for (task_node_t *node = index->slots[slot]; node != NULL; node = index->slots[slot]) {
+        if (node->id == task_id) {
+            return node;
+        }
+        slot = (slot + 1) & mask;
+    }
+    return NULL;
+}
+
+task_node_t *task_index_find_name(const task_index_t *index, const char *task_name, uint32_t name_hash)
+{
+    uint32_t mask = index->capacity - 1;
+    uint32_t slot = name_hash & mask;
+    for (task_node_t *node = index->slots[slot]; node != NULL; node = index->slots[slot]) {
+        if (node->name_hash == name_hash && strcmp(node->task_name, task_name) == 0) {
+            return node;
+        }
+        slot = (slot + 1) & mask;
+    }
+    return NULL;
+}
@@ -11,19 +11,376 @@
 #include "../include/thread.h"
 // log.h 已在 thread.h 中包含
 #include <pthread.h>
+#include <stdatomic.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <time.h>
+
+/**
+ * @enum task_node_state_t
+ * @brief 任务节点的生命周期状态。
+ */
+typedef enum {
+    TASK_NODE_QUEUED = 0,       /**< 任务在共享运行队列中等待。 */
+    TASK_NODE_RUNNING = 1,      /**< 任务已被工作线程取出并正在执行。 */
+    TASK_NODE_QUEUED_LOCAL = 2, /**< 任务在某个工作线程的本地双端队列中等待 (工作窃取模式)。 */
+    TASK_NODE_CANCELLED = 3,    /**< 任务在本地双端队列中被取消，等待取出它的线程回收节点。 */
+    TASK_NODE_TIMER = 4         /**< 延迟或周期任务在时间轮中等待到期。 */
+} task_node_state_t;
 
 /**
  * @struct task_node_s
  * @brief 用于表示任务队列的链表节点结构。
  *
- * 每个节点包含一个任务和指向队列中下一个任务的指针。
+ * 每个节点包含一个任务和指向队列中前后任务的指针。
+ * 节点从提交到执行完成期间一直登记在任务索引中。
+ * 前半部分是入队、出队、调度和执行都要访问的热字段，排在一起以便落在同一缓存行内；
+ * 任务名称等只在登记、查找和日志中使用的冷字段放在后面，队列遍历不会访问它们。
  * 此结构是线程池实现的内部结构。
  */
 typedef struct task_node_s {
-    task_t task; /**< 实际的任务数据 (函数、参数、名称、优先级)。task_t 在 thread.h 中定义。 */
-    struct task_node_s *next; /**< 指向队列中下一个任务节点的指针。 */
+    struct task_node_s *next; /**< 指向队列中下一个任务节点的指针 (空闲时用作空闲链表指针)。 */
+    struct task_node_s *prev; /**< 指向队列中上一个任务节点的指针，用于 O(1) 摘除。 */
+    void (*function)(void *arg); /**< 任务函数。 */
+    void *arg;                /**< 传递给任务函数的参数。 */
+    task_id_t id;             /**< 任务的唯一标识符。 */
+    task_priority_t priority; /**< 任务优先级。 */
+    task_node_state_t state;  /**< 节点当前状态。 */
+    int queue_node;           /**< 排队时所在的 NUMA 节点运行队列，-1 表示共享运行队列。 */
+    uint32_t name_hash;       /**< 任务名称的哈希值，供名称索引使用。 */
+    unsigned char anonymous;  /**< 为 1 时任务没有名称，不登记在名称索引中，task_name 未初始化。 */
+    atomic_int cancel_requested; /**< 非 0 表示已请求取消正在执行的任务，由任务通过 thread_pool_cancel_requested 查询。 */
+    task_future_t future;     /**< 任务的完成句柄，未登记时为 NULL。节点持有其一个引用。 */
+    void *result;             /**< 任务通过 thread_pool_set_task_result 设置的结果。 */
+    uint64_t enqueue_ns;      /**< 提交时的 CLOCK_MONOTONIC 时间戳 (纳秒)，仅在启用延迟统计时记录。 */
+    uint64_t start_ns;        /**< 开始执行时的时间戳 (纳秒)，仅在启用延迟统计时记录。 */
+    uint64_t timer_expire;    /**< 时间轮中的到期时间 (CLOCK_MONOTONIC 毫秒)。 */
+    uint32_t timer_period;    /**< 周期任务的周期 (毫秒)，0 表示非周期任务或已取消后续执行。 */
+    task_cancel_callback_t cancel_callback; /**< 执行期间被取消的周期任务在本次执行结束后调用的取消回调。 */
+    int timer_slot;           /**< 在时间轮中的槽位 (级别 * TIMER_WHEEL_SLOTS + 槽位)，不在时间轮中时为 -1。 */
+    uint64_t deadline_ns;     /**< 截止时间 (CLOCK_MONOTONIC 纳秒)，0 表示没有截止时间、按优先级调度。 */
+    int deadline_index;       /**< 在截止时间堆中的位置，不在堆中时为 -1。 */
+    char task_name[MAX_TASK_NAME_LEN]; /**< 任务名称，以空字符结尾。 */
 } task_node_t;             /**< 内部使用的类型定义。 */
 
+/**
+ * @def TASK_PRIORITY_LEVELS
+ * @brief 运行队列支持的优先级级别数量。
+ *
+ * 每个优先级数值 (0 ~ TASK_PRIORITY_LEVELS-1) 对应一个独立的 FIFO 队列，
+ * 超出该范围的自定义优先级会被钳制到最近的边界级别。
+ * 级别数量与 run_queue_bitmap 的位数一致。
+ */
+#define TASK_PRIORITY_LEVELS 64
+
+/**
+ * @struct task_bucket_t
+ * @brief 单个优先级级别的 FIFO 任务队列。
+ */
+typedef struct {
+    task_node_t *head; /**< 该级别队列的头指针。 */
+    task_node_t *tail; /**< 该级别队列的尾指针。 */
+} task_bucket_t;
+
+/**
+ * @struct node_run_queue_t
+ * @brief 单个 NUMA 节点的按优先级分桶的运行队列。
+ *
+ * 结构与 thread_pool_s 的共享运行队列相同，受池锁保护。
+ */
+typedef struct {
+    task_bucket_t buckets[TASK_PRIORITY_LEVELS]; /**< 各优先级级别的 FIFO 队列。 */
+    uint64_t bitmap;                             /**< 非空优先级级别的位图。 */
+} node_run_queue_t;
+
+/**
+ * @def TASK_SLAB_DEFAULT_NODES
+ * @brief 任务节点 slab 默认预分配的节点数量。
+ */
+#define TASK_SLAB_DEFAULT_NODES 256
+
+/**
+ * @def TASK_SLAB_DEFAULT_CHUNK_NODES
+ * @brief 任务节点 slab 空闲链表耗尽时，每次扩展分配的默认节点数量。
+ */
+#define TASK_SLAB_DEFAULT_CHUNK_NODES 256
+
+/**
+ * @def TASK_NODE_CACHE_MAX
+ * @brief 每个工作线程本地节点缓存的最大节点数量。
+ *
+ * 缓存满时，工作线程在持有池锁的情况下将整个缓存归还给共享空闲链表。
+ */
+#define TASK_NODE_CACHE_MAX 32
+
+/**
+ * @struct task_slab_chunk_s
+ * @brief 任务节点 slab 中一次性分配的一块连续节点内存。
+ */
+typedef struct task_slab_chunk_s {
+    struct task_slab_chunk_s *next; /**< 指向下一个内存块，用于销毁时统一释放。 */
+    int node_count;                 /**< 本块包含的节点数量。 */
+    task_node_t nodes[];            /**< 节点存储区。 */
+} task_slab_chunk_t;
+
+/**
+ * @struct task_slab_t
+ * @brief 线程池私有的任务节点 slab。
+ *
+ * 节点按块预分配并通过空闲链表 (复用 task_node_t::next) 循环使用，
+ * 任务的入队、执行和取消在稳定状态下不再调用 malloc/free。
+ * 节点内存仅在线程池销毁时归还给系统。
+ * 除初始化和销毁外，所有操作都要求调用者持有池的锁。
+ */
+typedef struct {
+    task_slab_chunk_t *chunks; /**< 已分配的内存块链表。 */
+    task_node_t *free_list;    /**< 空闲节点链表。 */
+    int free_count;            /**< 空闲链表中的节点数量。 */
+    int total_nodes;           /**< slab 拥有的节点总数。 */
+    int chunk_nodes;           /**< 每次扩展分配的节点数量。 */
+} task_slab_t;
+
+/**
+ * @struct task_node_cache_t
+ * @brief 工作线程本地的空闲节点缓存。
+ *
+ * 仅由所属工作线程访问，因此无需加锁。
+ */
+typedef struct {
+    task_node_t *head; /**< 缓存的空闲节点链表。 */
+    int count;         /**< 缓存中的节点数量。 */
+} task_node_cache_t;
+
+/**
+ * @def TASK_INDEX_INITIAL_CAPACITY
+ * @brief 任务索引的初始槽位数量 (必须为 2 的幂)。
+ */
+#define TASK_INDEX_INITIAL_CAPACITY 64
+
+/**
+ * @enum task_index_key_t
+ * @brief 任务索引的键类型。
+ */
+typedef enum {
+    TASK_INDEX_BY_ID = 0,  /**< 以 task_node_t::id 为键。 */
+    TASK_INDEX_BY_NAME = 1 /**< 以 task_node_t::task_name 为键。 */
+} task_index_key_t;
+
+/**
+ * @struct task_index_t
+ * @brief 指向任务节点的开放寻址哈希索引。
+ *
+ * 使用线性探测，删除时向后移位而不留墓碑，负载因子不超过 1/2，
+ * 因此插入、查找和删除的期望开销均为常数，与积压任务数量无关。
+ * 索引覆盖排队中和运行中的任务，所有操作都要求调用者持有池的锁。
+ */
+typedef struct {
+    task_node_t **slots;  /**< 槽位数组，NULL 表示空槽。 */
+    uint32_t capacity;    /**< 槽位数量，始终为 2 的幂。 */
+    uint32_t size;        /**< 已占用的槽位数量。 */
+    task_index_key_t key; /**< 索引的键类型。 */
+} task_index_t;
+
+/**
+ * @def WS_MAX_WORKERS
+ * @brief 工作窃取模式下支持的最大工作线程槽位数量。
+ *
+ * 窃取者需要无锁地遍历所有工作线程槽位，因此槽位指针数组在创建时一次性分配，
+ * 此后不再重新分配。工作窃取模式的线程池不能扩展到超过该数量的线程。
+ */
+#define WS_MAX_WORKERS 256
+
+/**
+ * @def WS_DEQUE_DEFAULT_CAPACITY
+ * @brief 工作窃取模式下每个本地双端队列的默认容量。
+ */
+#define WS_DEQUE_DEFAULT_CAPACITY 256
+
+/**
+ * @struct ws_deque_t
+ * @brief Chase-Lev 工作窃取双端队列 (固定容量的环形缓冲区)。
+ *
+ * 所有者在 bottom 端压入和弹出 (LIFO)，窃取者在 top 端通过 CAS 窃取 (FIFO)。
+ * 本实现中所有者操作在持有池锁时进行，窃取操作完全无锁。
+ * 队列满时压入失败，调用者应回退到共享运行队列。
+ */
+typedef struct {
+    atomic_size_t top;               /**< 窃取端索引，只增不减。 */
+    atomic_size_t bottom;            /**< 所有者端索引。 */
+    size_t mask;                     /**< 容量减一，容量为 2 的幂。 */
+    _Atomic(task_node_t *) *slots;   /**< 环形缓冲区。 */
+} ws_deque_t;
+
+/**
+ * @struct ws_worker_t
+ * @brief 工作窃取模式下单个工作线程槽位的本地队列。
+ *
+ * 每个优先级级别一个双端队列，首次使用时才分配。
+ * local_bitmap 仅在持有池锁时由所有者访问，可能包含已被窃取一空的级别。
+ */
+typedef struct {
+    _Atomic(ws_deque_t *) deques[TASK_PRIORITY_LEVELS]; /**< 各优先级级别的双端队列，未使用时为 NULL。 */
+    uint64_t local_bitmap; /**< 所有者视角下非空级别的位图，受池锁保护。 */
+} ws_worker_t;
+
+/** 缓存行大小 (字节)，每个工作线程的状态按此对齐以避免伪共享。 */
+#define THREAD_POOL_CACHE_LINE_SIZE 64
+
+/**
+ * @struct worker_state_t
+ * @brief 单个工作线程槽位的状态。
+ *
+ * 每个线程ID一个实例，按缓存行对齐并单独分配，相邻线程在任务开始和结束时的写入互不干扰。
+ * 实例在创建线程池时按 max_threads 一次性分配 (之后提高上限时补齐)，地址在线程池生命周期内不变，
+ * 因此调整大小时无需重新分配，也不会移动正在被等待的条件变量。
+ * 除特别说明外，字段均受池锁保护。
+ *
+ * info_* 字段是 status、running_task_id 和 running_task_name 的发布副本，
+ * 由持有池锁的写者在 info_seq 序列锁下以 relaxed 原子操作写入，供快照接口无锁读取。
+ * 任务ID拆分为两个 32 位字，避免在 32 位平台上依赖 64 位原子操作。
+ *
+ * park_cond 与 permit 相当于受池锁保护的二值信号量：唤醒者置位 permit 并只向该线程的条件变量发送信号，
+ * 工作线程在自己的条件变量上等待直到 permit 被置位。
+ */
+typedef struct {
+    _Alignas(THREAD_POOL_CACHE_LINE_SIZE) thread_pool_t pool; /**< 所属线程池，同时作为线程入口参数。 */
+    int thread_id;                 /**< 线程ID，即在 workers 数组中的下标。 */
+    int status;                    /**< 线程状态，0表示空闲，1表示忙碌，-1表示应该退出，-2表示因调整大小而退出。 */
+    task_id_t running_task_id;     /**< 当前正在执行的任务ID，0表示没有执行任务。 */
+    char running_task_name[MAX_TASK_NAME_LEN]; /**< 当前正在执行的任务名称，空闲时为 "[idle]"。 */
+    atomic_ulong tasks_completed;  /**< 此槽位上的线程已完成的任务数量，持锁写入，可无锁读取。 */
+    unsigned long tasks_stolen;    /**< 工作窃取模式下从其他线程窃取的任务数量。 */
+    int numa_node;                 /**< 此槽位的线程归属的 NUMA 节点，-1 表示未绑定。创建槽位后不变。 */
+    atomic_uint info_seq;          /**< 发布副本的序列锁计数器，奇数表示正在更新。 */
+    atomic_int info_status;        /**< status 的发布副本。 */
+    atomic_uint info_task_id[2];   /**< running_task_id 的发布副本 (低 32 位、高 32 位)。 */
+    atomic_uint info_task_name[MAX_TASK_NAME_LEN / sizeof(unsigned int)]; /**< running_task_name 的发布副本。 */
+    task_node_cache_t node_cache;  /**< 工作线程本地的空闲节点缓存，仅由占用槽位的线程访问。 */
+    pthread_t thread;              /**< 占用此槽位的线程。 */
+    int joinable;                  /**< thread 是否已创建且尚未被连接。 */
+    pthread_cond_t park_cond;      /**< 工作线程休眠时等待的条件变量。 */
+    int permit;                    /**< 唤醒许可。 */
+    int parked;                    /**< 是否位于空闲栈中。 */
+} worker_state_t;
+
+/**
+ * @struct worker_table_t
+ * @brief 工作线程状态指针表。
+ *
+ * 提高线程数上限时分配更大的新表并发布，旧表挂在 retired 链上直到销毁线程池才释放，
+ * 因此无锁读取者拿到的表在线程池生命周期内始终有效。
+ */
+typedef struct worker_table_s {
+    struct worker_table_s *retired; /**< 被此表替换的旧表。 */
+    int capacity;                   /**< slots 中有效的条目数量。 */
+    worker_state_t *slots[];        /**< 按线程ID索引的工作线程状态。 */
+} worker_table_t;
+
+/** 时间轮每一级的槽位数量的对数。 */
+#define TIMER_WHEEL_BITS 6
+
+/** 时间轮每一级的槽位数量，与每级位图的位数一致。 */
+#define TIMER_WHEEL_SLOTS (1 << TIMER_WHEEL_BITS)
+
+/** 时间轮的级数。以 1 毫秒为一个刻度，5 级共覆盖 2^30 毫秒 (约 12 天)，更远的定时器在顶级循环。 */
+#define TIMER_WHEEL_LEVELS 5
+
+/**
+ * @struct timer_wheel_t
+ * @brief 分级时间轮，按到期刻度管理延迟和周期任务节点。
+ *
+ * 第 0 级每个槽位对应一个刻度，第 N 级每个槽位对应 64^N 个刻度；
+ * 低级转完一圈时把上一级的当前槽位重新分配到下级 (级联)。
+ * 槽位是复用 task_node_t::next/prev 的双向链表，插入和删除都是 O(1)。
+ * 所有操作都要求调用者持有池的锁。
+ */
+typedef struct {
+    task_node_t *slots[TIMER_WHEEL_LEVELS][TIMER_WHEEL_SLOTS]; /**< 各槽位的链表头。 */
+    uint64_t bitmap[TIMER_WHEEL_LEVELS]; /**< 各级非空槽位的位图。 */
+    uint64_t current;                    /**< 下一个待处理的刻度。 */
+    int count;                           /**< 时间轮中的节点数量。 */
+} timer_wheel_t;
+
+/**
+ * @struct deadline_entry_t
+ * @brief 截止时间堆的条目。键值复制在条目中，比较时不需要访问节点。
+ */
+typedef struct {
+    int level;         /**< 运行队列级别，级别高 (数值小) 的条目先出堆。 */
+    uint64_t deadline; /**< 截止时间 (纳秒)，同一级别内截止时间早者先出堆。 */
+    uint64_t seq;      /**< 入堆序号，截止时间相同时先入堆者优先。 */
+    task_node_t *node; /**< 任务节点。 */
+} deadline_entry_t;
+
+/**
+ * @struct deadline_heap_t
+ * @brief 按 (级别, 截止时间) 排序的二叉最小堆，保存共享运行队列中带截止时间的任务。
+ *
+ * 堆顶是最高非空级别中截止时间最早的任务，因此最早截止时间优先 (EDF) 只在同一优先级级别内生效。
+ * 入堆、出堆和按节点删除都是 O(log n)。节点在 task_node_t::deadline_index 中记录自己的位置。
+ * 所有操作都要求调用者持有池的锁。
+ */
+typedef struct {
+    deadline_entry_t *entries; /**< 堆数组。 */
+    int size;                  /**< 堆中的条目数量。 */
+    int capacity;              /**< entries 的容量。 */
+    uint64_t next_seq;         /**< 下一个入堆序号。 */
+} deadline_heap_t;
+
+/**
+ * @struct worker_placement_t
+ * @brief 创建时解析出的工作线程 CPU 绑定和线程属性，创建后只读。
+ */
+typedef struct {
+    thread_pool_pin_policy_t policy; /**< 绑定策略。 */
+    int *cpus;          /**< 可用 CPU，按策略排列 (紧凑或分散顺序)，未使用 CPU 集合时为 NULL。 */
+    int *cpu_nodes;     /**< cpus[i] 所在的 NUMA 节点。 */
+    int cpu_count;      /**< cpus 中的条目数量，0 表示不设置 CPU 亲和性。 */
+    int *nodes;         /**< 可用 CPU 所在的不同节点，按编号递增。 */
+    int node_count;     /**< nodes 中的条目数量。 */
+    int max_node;       /**< 最大节点编号加一，即节点运行队列的数量。 */
+    size_t stack_size;  /**< 线程栈大小，0 表示系统默认值。 */
+    int sched_policy;   /**< 调度策略，-1 表示继承。 */
+    int sched_priority; /**< 调度优先级。 */
+} worker_placement_t;
+
+/**
+ * @struct latency_hist_t
+ * @brief 按 2 的幂分桶的无锁延迟直方图，单位为微秒。
+ *
+ * 第 0 桶记录 [0, 2) 微秒，第 i 桶 (i >= 1) 记录 [2^i, 2^(i+1)) 微秒，
+ * 超出范围的样本计入最后一个桶。所有计数均为 32 位原子量，任意线程可并发记录。
+ */
+typedef struct {
+    atomic_uint buckets[THREAD_POOL_LATENCY_BUCKETS]; /**< 各桶的样本数量。 */
+    atomic_uint max_us;                               /**< 观测到的最大延迟 (微秒)。 */
+} latency_hist_t;
+
+/**
+ * @struct latency_level_t
+ * @brief 单个优先级级别的排队等待和执行时间直方图。
+ */
+typedef struct {
+    latency_hist_t queue_wait; /**< 从提交到开始执行的时间。 */
+    latency_hist_t run_time;   /**< 任务函数的执行时间。 */
+} latency_level_t;
+
+/**
+ * @struct adjust_rate_state_t
+ * @brief 速率自动调整策略的采样状态。
+ *
+ * 由自动调整线程在持有池锁时更新，每次启用自动调整时清零。
+ */
+typedef struct {
+    int samples;                  /**< 已采样的次数，第一次采样只记录基线。 */
+    uint64_t last_sample_ns;      /**< 上次采样的时间 (CLOCK_MONOTONIC 纳秒)。 */
+    uint64_t last_resize_ns;      /**< 上次调整线程数的时间。 */
+    unsigned long last_submitted; /**< 上次采样时累计提交的任务数。 */
+    unsigned long last_completed; /**< 上次采样时累计完成的任务数。 */
+    double arrival_rate;          /**< 平滑后的到达率 (任务/秒)。 */
+    double service_rate;          /**< 平滑后的每个忙碌线程的处理速率 (任务/秒)，0 表示尚无估计。 */
+} adjust_rate_state_t;
+
 /**
  * @struct thread_pool_s
  * @brief 线程池的内部表示。
@@ -34,31 +391,74 @@ typedef struct task_node_s {
 struct thread_pool_s {
     pthread_mutex_t lock; /**< 用于保护任务队列和其他共享状态的互斥锁。 */
     pthread_mutex_t resize_lock; /**< 用于保护线程池大小调整操作的互斥锁。 */
-    pthread_cond_t notify; /**< 条件变量，用于通知工作线程有新任务或池正在关闭。 */
-    pthread_t *threads;  /**< 工作线程 ID 数组。 */
-    task_node_t *head;   /**< 任务队列头指针。 */
-    task_node_t *tail;   /**< 任务队列尾指针。 */
+    worker_state_t **workers; /**< 按线程ID索引的工作线程状态 (当前 worker_table 的 slots)，受 lock 保护。 */
+    int worker_capacity;  /**< workers 和 idle_stack 的容量，不小于 max_threads。 */
+    _Atomic(worker_table_t *) worker_table; /**< 当前的工作线程状态表，供快照接口无锁读取。 */
+    int *idle_stack;      /**< 正在休眠的工作线程ID栈 (LIFO，栈顶为最近休眠、缓存最热的线程)。 */
+    int idle_stack_size;  /**< 空闲栈中的线程数量。 */
+    int idle_spin_us;     /**< 休眠前自旋等待新任务的最长时间 (微秒)，0 表示不自旋。 */
+    atomic_uint submit_seq; /**< 每次有任务入队时递增，供自旋中的工作线程无锁地发现新任务。 */
+    latency_level_t *latency; /**< 按优先级级别的延迟直方图 (TASK_PRIORITY_LEVELS 项)，未启用时为 NULL。 */
+    task_bucket_t run_queue[TASK_PRIORITY_LEVELS]; /**< 按优先级分桶的运行队列，每个级别一个 FIFO。 */
+    uint64_t run_queue_bitmap; /**< 非空优先级级别的位图，第 N 位为 1 表示级别 N 的队列非空。 */
+    deadline_heap_t deadline_heap; /**< 带截止时间的任务，同一级别内按截止时间先后出队，并先于该级别的其他任务。 */
+    uint64_t aging_ns;         /**< 排队任务每等待这么长时间提升一个优先级级别 (纳秒)，0 表示不老化。创建后不变。 */
+    worker_placement_t placement; /**< 工作线程的 CPU 绑定和线程属性。 */
+    node_run_queue_t *node_queues; /**< 各 NUMA 节点的运行队列 (placement.max_node 项)，
+                                        仅在共享队列模式且设置了绑定策略时分配，否则为 NULL。 */
+    int *node_worker_count; /**< 各节点上正在运行的工作线程数量，与 node_queues 一同分配。 */
+    task_slab_t task_slab;     /**< 任务节点 slab，受 lock 保护。 */
+    thread_pool_scheduler_t scheduler; /**< 调度模式，创建后不变。 */
+    size_t ws_deque_capacity;  /**< 工作窃取模式下每个本地双端队列的容量。 */
+    _Atomic(ws_worker_t *) *ws_workers; /**< 工作窃取模式下的工作线程槽位 (WS_MAX_WORKERS 个)，共享队列模式为 NULL。 */
+    atomic_int ws_worker_slots; /**< 已分配的工作线程槽位数量上界，窃取者只遍历这些槽位。 */
     int thread_count;    /**< 池中的线程数量。 */
     int min_threads;     /**< 池中允许的最小线程数量。 */
     int max_threads;     /**< 池中允许的最大线程数量。 */
     int idle_threads;    /**< 当前空闲的线程数量。 */
     int task_queue_size; /**< 当前任务队列中的任务数量。 */
+    int queue_capacity;  /**< 排队任务数量上限，0 表示不限制。创建后不变。 */
+    int queue_reserved;  /**< 为高优先级任务保留的槽位数量。 */
+    int queue_reserved_level; /**< 可以使用保留槽位的最大优先级级别。 */
+    pthread_cond_t space_cond; /**< 普通提交者等待队列空位的条件变量 (CLOCK_MONOTONIC)，与 lock 一起使用。 */
+    pthread_cond_t reserved_space_cond; /**< 可使用保留槽位的提交者等待空位的条件变量。 */
+    int space_waiters;          /**< 在 space_cond 上等待的提交者数量。 */
+    int reserved_space_waiters; /**< 在 reserved_space_cond 上等待的提交者数量。 */
     int shutdown;        /**< 标志，指示池是否正在关闭 (1) 或活动 (0)。 */
     int resize_shutdown; /**< 标志，指示是否有线程需要由于缩小而退出 (1) 或不需要 (0)。 */
     int started;               /**< 已成功启动的线程数量。 */
-    char **running_task_names; /**< 字符串数组，每个字符串存储
-                                     相应工作线程当前正在执行的任务的名称。
-                                     每个字符串的最大长度为 MAX_TASK_NAME_LEN。 */
-    int *thread_status; /**< 线程状态数组，0表示空闲，1表示忙碌，-1表示应该退出。 */
-    task_id_t *running_task_ids; /**< 数组，存储每个工作线程当前正在执行的任务ID。
-                                     值0表示线程当前没有执行任务。 */
     task_id_t next_task_id;     /**< 下一个要分配的任务ID。从1开始递增，0保留为无效ID。 */
 
+    /* 延迟和周期任务，受 lock 保护 */
+    timer_wheel_t timer_wheel;  /**< 等待到期的任务节点。 */
+    pthread_t timer_thread;     /**< 定时器线程，首次提交延迟或周期任务时创建。 */
+    int timer_started;          /**< 定时器线程是否已创建。 */
+    pthread_cond_t timer_cond;  /**< 定时器线程等待下一个到期刻度的条件变量 (CLOCK_MONOTONIC)。 */
+    uint64_t timer_wake_tick;   /**< 定时器线程计划醒来的刻度，UINT64_MAX 表示无限等待。 */
+
+    /* 供快照接口无锁读取的计数器，只在持有 lock 时以 relaxed 语义写入 */
+    atomic_int stat_thread_count;   /**< thread_count 的发布副本。 */
+    atomic_int stat_idle_threads;   /**< idle_threads 的发布副本。 */
+    atomic_int stat_queue_size;     /**< task_queue_size 的发布副本。 */
+    atomic_ulong tasks_submitted;   /**< 累计成功提交的任务数量。 */
+    atomic_ulong tasks_cancelled;   /**< 累计被取消的任务数量。 */
+    atomic_ulong tasks_rejected;    /**< 累计因队列已满而被拒绝的提交次数。 */
+
+    /* 任务索引 (排队中和运行中的任务)，受 lock 保护 */
+    task_index_t id_index;   /**< 任务ID到任务节点的索引。 */
+    task_index_t name_index; /**< 任务名称到任务节点的索引，同时用于检查名称重复。 */
+
     /* 自动动态调整相关字段 */
     int auto_adjust;                    /**< 是否启用自动调整 (1=启用, 0=禁用) */
     int high_watermark;                 /**< 任务队列高水位线，超过此值增加线程 */
     int low_watermark;                  /**< 空闲线程高水位线，超过此值减少线程 */
     int adjust_interval;                /**< 调整检查间隔（毫秒） */
+    thread_pool_adjust_policy_t adjust_policy; /**< 自动调整策略。 */
+    int adjust_target_wait_us;          /**< 速率策略：期望的排队等待时间 (微秒)。 */
+    int adjust_ewma_weight;             /**< 速率策略：每次采样的平滑权重 (百分比)。 */
+    int adjust_hysteresis;              /**< 速率策略：缩减死区 (百分比)。 */
+    int adjust_cooldown_ms;             /**< 速率策略：调整之后再次缩减前的冷却时间 (毫秒)。 */
+    adjust_rate_state_t adjust_rate;    /**< 速率策略的采样状态，受 lock 保护。 */
     time_t last_adjust_time;            /**< 上次调整时间 */
     pthread_t adjust_thread;            /**< 自动调整线程的ID。 */
     volatile int adjust_thread_running; /**< 控制自动调整线程循环的标志。 */
@@ -66,16 +466,625 @@ struct thread_pool_s {
     pthread_mutex_t adjust_cond_lock;   /**< 与 adjust_cond 一起使用的互斥锁。 */
 };
 
+// --- 任务节点 slab (thread_slab.c) ---
+
+/**
+ * @brief 初始化任务节点 slab 并预分配节点。
+ *
+ * @param slab 要初始化的 slab。
+ * @param initial_nodes 预分配的节点数量，为 0 时不预分配。
+ * @param chunk_nodes 空闲链表耗尽时每次扩展的节点数量，必须为正数。
+ * @return 成功返回 0，内存分配失败或参数无效返回 -1。
+ */
+int task_slab_init(task_slab_t *slab, int initial_nodes, int chunk_nodes);
+
+/**
+ * @brief 释放 slab 拥有的全部内存块。
+ *
+ * 调用后所有由该 slab 分配的节点 (包括仍在队列或工作线程缓存中的节点) 均失效。
+ *
+ * @param slab 要销毁的 slab。
+ */
+void task_slab_destroy(task_slab_t *slab);
+
+/**
+ * @brief 从 slab 中取出一个空闲节点，必要时按块扩展。
+ *
+ * 调用者必须持有池的锁。
+ *
+ * @param slab 任务节点 slab。
+ * @return 空闲节点，扩展时内存分配失败返回 NULL。
+ */
+task_node_t *task_slab_alloc(task_slab_t *slab);
+
 /**
- * @struct thread_args_t
- * @brief 用于向新创建的工作线程传递参数的结构。
+ * @brief 将节点归还给 slab 的空闲链表。
  *
- * 此结构在内部用于为每个工作线程提供指向线程池
- * 及其唯一线程 ID 的指针。
+ * 调用者必须持有池的锁。
+ *
+ * @param slab 任务节点 slab。
+ * @param node 要归还的节点。
+ */
+void task_slab_free(task_slab_t *slab, task_node_t *node);
+
+/**
+ * @brief 从工作线程本地缓存中取出一个节点。
+ *
+ * @param cache 工作线程本地缓存。
+ * @return 缓存的节点，缓存为空时返回 NULL。
+ */
+task_node_t *task_node_cache_pop(task_node_cache_t *cache);
+
+/**
+ * @brief 将节点放入工作线程本地缓存。
+ *
+ * @param cache 工作线程本地缓存。
+ * @param node 要缓存的节点。
+ * @return 成功返回 0，缓存已满返回 -1 (节点未被缓存)。
+ */
+int task_node_cache_push(task_node_cache_t *cache, task_node_t *node);
+
+/**
+ * @brief 将工作线程本地缓存中的全部节点归还给 slab。
+ *
+ * 调用者必须持有池的锁。
+ *
+ * @param cache 工作线程本地缓存。
+ * @param slab 节点所属的 slab。
+ */
+void task_node_cache_flush(task_node_cache_t *cache, task_slab_t *slab);
+
+// --- 任务索引 (thread_index.c) ---
+
+/**
+ * @brief 计算任务名称的哈希值。
+ *
+ * @param task_name 以空字符结尾的任务名称。
+ * @return 名称的 32 位哈希值。
+ */
+uint32_t task_name_hash(const char *task_name);
+
+/**
+ * @brief 初始化任务索引。
+ *
+ * @param index 要初始化的索引。
+ * @param key 索引的键类型。
+ * @return 成功返回 0，内存分配失败返回 -1。
+ */
+int task_index_init(task_index_t *index, task_index_key_t key);
+
+/**
+ * @brief 释放任务索引的槽位数组 (不释放节点)。
+ *
+ * @param index 要销毁的索引。
+ */
+void task_index_destroy(task_index_t *index);
+
+/**
+ * @brief 确保索引在再插入一个节点后仍满足负载因子，必要时扩容。
+ *
+ * 在插入之前调用，使插入本身不会失败。
+ *
+ * @param index 任务索引。
+ * @return 成功返回 0，扩容时内存分配失败返回 -1。
+ */
+int task_index_reserve(task_index_t *index);
+
+/**
+ * @brief 将节点登记到索引中。调用者必须已通过 task_index_reserve 预留空间。
+ *
+ * @param index 任务索引。
+ * @param node 要登记的节点。
+ */
+void task_index_insert(task_index_t *index, task_node_t *node);
+
+/**
+ * @brief 从索引中移除节点。节点不在索引中时不执行任何操作。
+ *
+ * @param index 任务索引。
+ * @param node 要移除的节点。
+ */
+void task_index_remove(task_index_t *index, const task_node_t *node);
+
+/**
+ * @brief 在 ID 索引中查找任务。
+ *
+ * @param index 键类型为 TASK_INDEX_BY_ID 的索引。
+ * @param task_id 任务ID。
+ * @return 对应的任务节点，不存在时返回 NULL。
+ */
+task_node_t *task_index_find_id(const task_index_t *index, task_id_t task_id);
+
+/**
+ * @brief 在名称索引中查找任务。
+ *
+ * @param index 键类型为 TASK_INDEX_BY_NAME 的索引。
+ * @param task_name 任务名称。
+ * @param name_hash 由 task_name_hash 计算的名称哈希值。
+ * @return 对应的任务节点，不存在时返回 NULL。
+ */
+task_node_t *task_index_find_name(const task_index_t *index, const char *task_name, uint32_t name_hash);
+
+/**
+ * @brief 匿名任务的名称标记，定义在 thread.c 中。
+ *
+ * 作为任务名称传给内部提交函数时按地址识别，任务以匿名方式登记：不生成名称、不检查重名、
+ * 不登记到名称索引。日志和运行中任务名称中匿名任务显示为此字符串。
+ */
+extern const char task_anonymous_name[];
+
+/**
+ * @brief 取得节点用于显示的任务名称，匿名任务返回 task_anonymous_name。
+ */
+static inline const char *task_node_name(const task_node_t *node)
+{
+    return node->anonymous ? task_anonymous_name : node->task_name;
+}
+
+/**
+ * @struct task_future_waiter_t
+ * @brief `task_future_wait_any` 的等待者，可同时登记到多个完成句柄上。
  */
 typedef struct {
-    thread_pool_t pool; /**< 指向线程池实例的指针 (来自公共 API 的不透明类型)。 */
-    int thread_id;      /**< 工作线程的唯一标识符 (索引)。 */
-} thread_args_t;
+    pthread_mutex_t lock; /**< 保护 fired。 */
+    pthread_cond_t cond;  /**< 任一登记的句柄结束时发出信号。 */
+    int fired;            /**< 是否已有句柄结束。 */
+} task_future_waiter_t;
+
+/**
+ * @struct task_future_link_t
+ * @brief 句柄上的等待者链表节点，由等待者分配。
+ */
+typedef struct task_future_link_s {
+    task_future_waiter_t *waiter;    /**< 所属等待者。 */
+    struct task_future_link_s *next; /**< 同一句柄上的下一个等待者。 */
+} task_future_link_t;
+
+/**
+ * @struct task_future_s
+ * @brief 任务完成句柄的内部表示。
+ *
+ * 状态、结果和等待者链表受句柄自身的锁保护。
+ * 锁顺序：池锁 -> 句柄锁 -> 等待者锁，句柄函数从不获取池锁。
+ */
+struct task_future_s {
+    pthread_mutex_t lock;        /**< 保护以下字段。 */
+    pthread_cond_t cond;         /**< 任务结束时广播，使用 CLOCK_MONOTONIC。 */
+    task_future_state_t state;   /**< 当前状态。 */
+    void *result;                /**< 任务完成时的结果指针。 */
+    task_id_t task_id;           /**< 对应的任务ID。 */
+    atomic_int refs;             /**< 引用计数 (调用者引用 + 未结束任务持有的引用)。 */
+    task_future_link_t *waiters; /**< wait_any 登记的等待者。 */
+};
+
+// --- 任务完成句柄 (thread_future.c) ---
+
+/**
+ * @brief 初始化使用 CLOCK_MONOTONIC 计时的条件变量。
+ *
+ * @param cond 要初始化的条件变量。
+ * @return 成功返回 0，失败返回 -1。
+ */
+int monotonic_cond_init(pthread_cond_t *cond);
+
+/**
+ * @brief 根据超时时间计算 CLOCK_MONOTONIC 绝对截止时间。
+ *
+ * @param deadline 输出的截止时间。
+ * @param timeout_ms 超时时间 (毫秒)，负数表示无限等待。
+ * @return 有截止时间时返回 deadline，无限等待时返回 NULL。
+ */
+const struct timespec *monotonic_deadline(struct timespec *deadline, int timeout_ms);
+
+/**
+ * @brief 创建一个处于 TASK_FUTURE_PENDING 状态、引用计数为 1 的完成句柄。
+ *
+ * @param task_id 对应的任务ID。
+ * @return 新句柄，内存分配或同步原语初始化失败时返回 NULL。
+ */
+task_future_t task_future_create(task_id_t task_id);
+
+/**
+ * @brief 增加句柄的引用计数。
+ */
+void task_future_retain(task_future_t future);
+
+/**
+ * @brief 将句柄置为结束状态并唤醒所有等待者。每个句柄只应调用一次。
+ *
+ * @param future 完成句柄。
+ * @param state TASK_FUTURE_COMPLETED 或 TASK_FUTURE_CANCELLED。
+ * @param result 任务结果，取消时为 NULL。
+ */
+void task_future_finish(task_future_t future, task_future_state_t state, void *result);
+
+// --- 任务依赖图 (thread_graph.c) ---
+
+/**
+ * @enum task_graph_node_state_t
+ * @brief 依赖图节点在一次运行中的状态 (task_graph_node_s::state 的取值)。
+ */
+typedef enum {
+    TASK_GRAPH_NODE_DONE = 0,      /**< 已执行完成，或依赖图未在运行。 */
+    TASK_GRAPH_NODE_PENDING = 1,   /**< 等待前驱任务完成。 */
+    TASK_GRAPH_NODE_SUBMITTED = 2, /**< 已提交到线程池，在队列中等待或正在执行。 */
+    TASK_GRAPH_NODE_CANCELLED = 3  /**< 本次运行中被取消 (自身被取消或某个前驱被取消)。 */
+} task_graph_node_state_t;
+
+/**
+ * @struct task_graph_node_s
+ * @brief 依赖图中的一个任务。
+ *
+ * 结构字段只在依赖图未运行时修改；pending 和 state 在运行期间由工作线程无锁更新。
+ */
+typedef struct task_graph_node_s {
+    struct task_graph_s *graph;       /**< 所属的依赖图。 */
+    void (*function)(void *);         /**< 用户任务函数。 */
+    void *arg;                        /**< 用户任务参数。 */
+    char task_name[MAX_TASK_NAME_LEN]; /**< 用户指定的名称，空字符串表示自动生成。 */
+    task_priority_t priority;         /**< 提交到线程池时的优先级。 */
+    task_id_t task_id;                /**< 创建时分配的任务ID，每次运行都使用同一ID。 */
+    int dep_count;                    /**< 前驱任务数量。 */
+    struct task_graph_node_s **successors; /**< 后继任务节点。 */
+    int successor_count;              /**< 后继任务数量。 */
+    int successor_capacity;           /**< successors 数组的容量。 */
+    atomic_int pending;               /**< 本次运行中尚未完成的前驱数量，减到 0 时提交该任务。 */
+    atomic_int state;                 /**< task_graph_node_state_t。 */
+    struct task_graph_node_s *cancel_next; /**< 取消工作栈中的下一个节点，只由把 state 改为 CANCELLED 的线程使用。 */
+} task_graph_node_t;
+
+/**
+ * @struct task_graph_s
+ * @brief 任务依赖图的内部表示。
+ *
+ * 节点按任务ID递增顺序保存，供二分查找；并发添加时后分配ID的线程可能先获得图锁，
+ * 因此按ID插入到有序位置而不是总是追加。前驱总是先于后继添加，因此图中不会出现环。
+ * running 受 lock 保护；remaining 归零的线程在 lock 下清除 running 并广播 cond。
+ * 锁顺序：池锁 -> 图锁。
+ */
+struct task_graph_s {
+    thread_pool_t pool;        /**< 执行任务的线程池。 */
+    task_graph_node_t **nodes; /**< 节点指针数组，节点地址在图的生命周期内不变。 */
+    int node_count;            /**< 节点数量。 */
+    int node_capacity;         /**< nodes 数组的容量。 */
+    pthread_mutex_t lock;      /**< 保护 running 以及运行之外对结构的修改。 */
+    pthread_cond_t cond;       /**< 一次运行结束时广播，使用 CLOCK_MONOTONIC。 */
+    int running;               /**< 是否有一次运行尚未结束。 */
+    atomic_int remaining;      /**< 本次运行中尚未完成或取消的节点数量。 */
+    atomic_int cancelled;      /**< 本次运行中被取消的节点数量。 */
+};
+
+/**
+ * @brief 依赖图节点在线程池中执行时使用的任务函数。
+ *
+ * 执行用户函数，然后无锁地递减各后继的前驱计数，把计数归零的后继一次性提交到线程池。
+ * thread_pool_cancel_task 通过比较该函数地址识别依赖图中的任务。
+ *
+ * @param arg 指向 task_graph_node_t 的指针。
+ */
+void task_graph_node_run(void *arg);
+
+/**
+ * @brief 依赖图中的任务执行完成并被移出任务索引后调用，将该节点计入本次运行的结束数量。
+ *
+ * 由 task_node_complete_locked 在持有池锁时调用。
+ *
+ * @param arg 指向 task_graph_node_t 的指针。
+ */
+void task_graph_node_retired(void *arg);
+
+/**
+ * @brief 依赖图中已提交的任务被 thread_pool_cancel_task 取消后调用。
+ *
+ * 以用户参数调用取消回调，并取消所有尚未执行的后继任务 (每个任务调用一次回调)。
+ * 调用者不得持有池锁。
+ *
+ * @param arg 指向 task_graph_node_t 的指针。
+ * @param cancel_callback 取消回调，可以为 NULL。
+ */
+void task_graph_node_cancelled(void *arg, task_cancel_callback_t cancel_callback);
+
+/**
+ * @brief 为依赖图任务预先分配连续的任务ID。
+ *
+ * @param pool 线程池。
+ * @param count 需要的ID数量。
+ * @return 第一个ID，线程池正在关闭时返回 0。
+ */
+task_id_t pool_reserve_task_ids(thread_pool_t pool, int count);
+
+/**
+ * @brief 以预先分配的任务ID在一次加锁内提交一批任务，不检查队列容量。
+ *
+ * 依赖图在运行期间提交后继任务，拒绝提交会使整个图无法结束，因此不受 queue_capacity 限制。
+ * 提交完成后唤醒与成功提交数量相同的休眠线程。
+ *
+ * @param pool 线程池。
+ * @param tasks 任务描述数组，function 不能为 NULL；task_name 为 task_anonymous_name 的任务以匿名方式登记。
+ * @param task_ids 每个任务使用的ID。
+ * @param count 任务数量。
+ * @param results 输出每个任务的结果：成功为 0，线程池正在关闭、名称重复或内存分配失败为 -1。
+ * @return 成功提交的任务数量。
+ */
+int pool_submit_with_ids(thread_pool_t pool, const thread_pool_task_spec_t *tasks, const task_id_t *task_ids,
+                         int count, int *results);
+
+// --- 工作窃取双端队列 (thread_ws.c) ---
+
+/**
+ * @brief 创建一个工作窃取双端队列。
+ *
+ * @param capacity 队列容量，会被向上取整为 2 的幂。
+ * @return 新队列，内存分配失败返回 NULL。
+ */
+ws_deque_t *ws_deque_create(size_t capacity);
+
+/**
+ * @brief 释放双端队列 (不释放其中的节点)。
+ *
+ * @param deque 要释放的队列，可以为 NULL。
+ */
+void ws_deque_destroy(ws_deque_t *deque);
+
+/**
+ * @brief 所有者在 bottom 端压入节点。
+ *
+ * @param deque 双端队列。
+ * @param node 要压入的节点。
+ * @return 成功返回 0，队列已满返回 -1。
+ */
+int ws_deque_push(ws_deque_t *deque, task_node_t *node);
+
+/**
+ * @brief 所有者从 bottom 端弹出最近压入的节点。
+ *
+ * @param deque 双端队列。
+ * @return 弹出的节点，队列为空或最后一个节点被窃取者抢走时返回 NULL。
+ */
+task_node_t *ws_deque_pop(ws_deque_t *deque);
+
+/**
+ * @brief 窃取者从 top 端窃取最早压入的节点。可被任意线程并发调用。
+ *
+ * @param deque 双端队列。
+ * @return 窃取到的节点，队列为空或与其他线程竞争失败时返回 NULL。
+ */
+task_node_t *ws_deque_steal(ws_deque_t *deque);
+
+/**
+ * @brief 估计队列中的节点数量。并发修改时结果仅供参考。
+ *
+ * @param deque 双端队列。
+ * @return 节点数量的估计值。
+ */
+size_t ws_deque_size(ws_deque_t *deque);
+
+// --- 任务延迟统计 (thread_latency.c) ---
+
+/**
+ * @brief 读取 CLOCK_MONOTONIC 时间 (纳秒)。
+ */
+static inline uint64_t latency_now_ns(void)
+{
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (uint64_t)now.tv_sec * UINT64_C(1000000000) + (uint64_t)now.tv_nsec;
+}
+
+/**
+ * @brief 为所有优先级级别分配并初始化延迟直方图。
+ *
+ * @return 包含 TASK_PRIORITY_LEVELS 项的数组，内存分配失败返回 NULL。
+ */
+latency_level_t *latency_levels_create(void);
+
+/**
+ * @brief 释放延迟直方图数组。
+ *
+ * @param levels 要释放的数组，可以为 NULL。
+ */
+void latency_levels_destroy(latency_level_t *levels);
+
+/**
+ * @brief 向直方图记录一个样本。无锁，可被任意线程并发调用。
+ *
+ * @param hist 延迟直方图。
+ * @param elapsed_ns 延迟 (纳秒)。
+ */
+void latency_hist_record(latency_hist_t *hist, uint64_t elapsed_ns);
+
+/**
+ * @brief 读取直方图并计算样本数、p50、p99 和最大值。
+ *
+ * 各桶分别原子读取，并发记录时结果是近似的。
+ *
+ * @param hist 延迟直方图。
+ * @param out 输出结构。
+ */
+void latency_hist_read(latency_hist_t *hist, thread_pool_latency_histogram_t *out);
+
+// --- 分级时间轮 (thread_timer.c) ---
+
+/**
+ * @brief 读取当前的时间轮刻度 (CLOCK_MONOTONIC 毫秒)。
+ */
+static inline uint64_t timer_now_tick(void)
+{
+    return latency_now_ns() / UINT64_C(1000000);
+}
+
+/**
+ * @brief 初始化空的时间轮。
+ *
+ * @param wheel 要初始化的时间轮。
+ * @param now 当前刻度。
+ */
+void timer_wheel_init(timer_wheel_t *wheel, uint64_t now);
+
+/**
+ * @brief 按 node->timer_expire 把节点加入时间轮。已过期的节点在下一次推进时立即到期。
+ *
+ * @param wheel 时间轮。
+ * @param node 不在时间轮中的节点。
+ * @param now 当前刻度。
+ */
+void timer_wheel_insert(timer_wheel_t *wheel, task_node_t *node, uint64_t now);
+
+/**
+ * @brief 把节点从时间轮中移除。
+ *
+ * @param wheel 时间轮。
+ * @param node 位于该时间轮中的节点。
+ */
+void timer_wheel_remove(timer_wheel_t *wheel, task_node_t *node);
+
+/**
+ * @brief 推进时间轮到 now (含)，取出所有到期的节点。
+ *
+ * @param wheel 时间轮。
+ * @param now 当前刻度。
+ * @return 到期节点组成的单向链表 (通过 next 链接)，没有到期节点时返回 NULL。
+ */
+task_node_t *timer_wheel_advance(timer_wheel_t *wheel, uint64_t now);
+
+/**
+ * @brief 返回下一次需要推进时间轮的刻度：最近的非空第 0 级槽位，或第 0 级转完一圈需要级联的刻度。
+ *
+ * @param wheel 时间轮。
+ * @return 刻度，时间轮为空时返回 UINT64_MAX。
+ */
+uint64_t timer_wheel_next_tick(const timer_wheel_t *wheel);
+
+// --- 截止时间堆 (thread_deadline.c) ---
+
+/**
+ * @brief 初始化空的截止时间堆。
+ *
+ * @param heap 要初始化的堆。
+ */
+void deadline_heap_init(deadline_heap_t *heap);
+
+/**
+ * @brief 释放截止时间堆的数组。堆中剩余的节点不受影响。
+ *
+ * @param heap 截止时间堆。
+ */
+void deadline_heap_destroy(deadline_heap_t *heap);
+
+/**
+ * @brief 确保堆能再容纳一个条目，必要时扩容。
+ *
+ * 在入堆之前调用，使入堆本身不会失败。
+ *
+ * @param heap 截止时间堆。
+ * @return 成功返回 0，扩容时内存分配失败返回 -1。
+ */
+int deadline_heap_reserve(deadline_heap_t *heap);
+
+/**
+ * @brief 按级别和 node->deadline_ns 把节点加入堆。调用者必须已通过 deadline_heap_reserve 预留空间。
+ *
+ * @param heap 截止时间堆。
+ * @param node 不在堆中的节点。
+ * @param level 节点优先级对应的运行队列级别。
+ */
+void deadline_heap_push(deadline_heap_t *heap, task_node_t *node, int level);
+
+/**
+ * @brief 取出最高级别中截止时间最早的节点。
+ *
+ * @param heap 截止时间堆。
+ * @return 堆顶节点，堆为空时返回 NULL。
+ */
+task_node_t *deadline_heap_pop(deadline_heap_t *heap);
+
+/**
+ * @brief 把节点从堆中移除。
+ *
+ * @param heap 截止时间堆。
+ * @param node 位于该堆中的节点。
+ */
+void deadline_heap_remove(deadline_heap_t *heap, task_node_t *node);
+
+// --- 事件跟踪 (thread_trace.c) ---
+
+/**
+ * @enum trace_event_type_t
+ * @brief 跟踪事件类型。
+ */
+typedef enum {
+    TRACE_EVENT_ENQUEUE, /**< 任务进入运行队列或本地队列。 */
+    TRACE_EVENT_DEQUEUE, /**< 工作线程取得任务。 */
+    TRACE_EVENT_START,   /**< 任务函数开始执行。 */
+    TRACE_EVENT_FINISH,  /**< 任务函数执行完成。 */
+    TRACE_EVENT_SLEEP,   /**< 工作线程进入休眠。 */
+    TRACE_EVENT_WAKE,    /**< 工作线程被唤醒。 */
+    TRACE_EVENT_RESIZE   /**< 线程池调整了线程数量。 */
+} trace_event_type_t;
+
+/**
+ * @brief 是否正在记录跟踪事件。只能通过原子操作访问。
+ */
+extern atomic_int g_trace_enabled;
+
+/**
+ * @brief 向当前线程的环形缓冲区写入一条事件。不获取锁，可被任意线程并发调用。
+ *
+ * @param type 事件类型。
+ * @param pool 产生事件的线程池。
+ * @param arg 任务ID，调整大小事件为新的线程数。
+ * @param aux 任务优先级，调整大小事件为原线程数。
+ */
+void trace_record(trace_event_type_t type, const void *pool, uint64_t arg, int aux);
+
+/**
+ * @brief 记录一条跟踪事件。未开始跟踪时只有一次原子读取。
+ */
+static inline void trace_event(trace_event_type_t type, const void *pool, uint64_t arg, int aux)
+{
+    if (atomic_load_explicit(&g_trace_enabled, memory_order_relaxed)) {
+        trace_record(type, pool, arg, aux);
+    }
+}
+
+// --- 工作线程绑定 (thread_affinity.c) ---
+
+/**
+ * @brief 校验创建选项中的绑定和线程属性，并解析可用 CPU 和 NUMA 拓扑。
+ *
+ * @param placement 要初始化的结构。失败时已被清理，无需调用 worker_placement_destroy。
+ * @param config 线程池创建选项。
+ * @return 成功返回 0，选项无效、平台不支持或内存分配失败返回 -1。
+ */
+int worker_placement_init(worker_placement_t *placement, const thread_pool_config_t *config);
+
+/**
+ * @brief 释放 worker_placement_init 分配的内存。可重复调用。
+ *
+ * @param placement 要清理的结构。
+ */
+void worker_placement_destroy(worker_placement_t *placement);
+
+/**
+ * @brief 返回指定线程ID归属的 NUMA 节点。
+ *
+ * @param placement 绑定信息。
+ * @param thread_id 线程ID。
+ * @return 节点编号，未设置绑定策略时返回 -1。
+ */
+int worker_placement_node(const worker_placement_t *placement, int thread_id);
+
+/**
+ * @brief 按绑定信息为指定线程ID设置线程属性并创建线程。
+ *
+ * @param placement 绑定信息。
+ * @param thread_id 线程ID，决定绑定的 CPU 或节点。
+ * @param thread 输出新线程的句柄。
+ * @param start_routine 线程入口函数。
+ * @param arg 线程入口参数。
+ * @return 成功返回 0，失败返回 pthread 错误码。
+ */
+int worker_placement_create_thread(const worker_placement_t *placement, int thread_id, pthread_t *thread,
+                                   void *(*start_routine)(void *), void *arg);
 
 #endif /* THREAD_INTERNAL_H */
@@ -0,0 +1,104 @@
+/**
+ * @file thread_latency.c
+ * @brief 线程池任务延迟直方图的实现。
+ *
+ * 样本按微秒取以 2 为底的对数分桶，记录只需一次原子加法 (以及偶尔的最大值比较交换)，
+ * 不需要持有池锁。百分位在读取时由桶计数估算，取所在桶的上界。
+ */
+#include "thread_internal.h"
+#include <stdlib.h>
+
+latency_level_t *latency_levels_create(void)
+{
+    latency_level_t *levels = (latency_level_t *)malloc(TASK_PRIORITY_LEVELS * sizeof(latency_level_t));
+    if (levels == NULL) {
+        TPOOL_ERROR("latency_levels_create: 未能为 %d 个优先级级别的延迟直方图分配内存",
+                    TASK_PRIORITY_LEVELS);
+        return NULL;
+    }
+    for (int level = 0; level < TASK_PRIORITY_LEVELS; level++) {
+        latency_hist_t *hists[2] = {&levels[level].queue_wait, &levels[level].run_time};
+        for (int h = 0; h < 2; h++) {
+            for (int i = 0; i < THREAD_POOL_LATENCY_BUCKETS; i++) {
+                atomic_init(&hists[h]->buckets[i], 0);
+            }
+            atomic_init(&hists[h]->max_us, 0);
+        }
+    }
+    return levels;
+}
+
+void latency_levels_destroy(latency_level_t *levels)
+{
+    free(levels);
+}
+
+/**
+ * @brief 计算延迟所在的桶 (内部函数)。
+ */
+static inline int latency_bucket(unsigned int elapsed_us)
+{
+    if (elapsed_us < 2) {
+        return 0;
+    }
+    int bucket = 31 - __builtin_clz(elapsed_us);
+    return bucket < THREAD_POOL_LATENCY_BUCKETS ? bucket : THREAD_POOL_LATENCY_BUCKETS - 1;
+}
+
+/**
+ * @brief 返回桶所覆盖区间的上界 (微秒，内部函数)。
+ */
+static inline unsigned long latency_bucket_upper(int bucket)
+{
+    // 桶编号不超过 31，上界不超过 UINT32_MAX
+    return bucket == 0 ? 1UL : (unsigned long)((UINT64_C(2) << bucket) - 1);
+}
+
+void latency_hist_record(latency_hist_t *hist, uint64_t elapsed_ns)
+{
+    uint64_t elapsed_us64 = elapsed_ns / 1000;
+    unsigned int elapsed_us = elapsed_us64 > UINT32_MAX ? UINT32_MAX : (unsigned int)elapsed_us64;
+
+    atomic_fetch_add_explicit(&hist->buckets[latency_bucket(elapsed_us)], 1, memory_order_relaxed);
+
+    unsigned int max_us = atomic_load_explicit(&hist->max_us, memory_order_relaxed);
+    while (elapsed_us > max_us &&
+           !atomic_compare_exchange_weak_explicit(&hist->max_us, &max_us, elapsed_us, memory_order_relaxed,
+                                                  memory_order_relaxed)) {
+        // max_us 已被更新为最新值，继续比较
+    }
+}
+
+/**
+ * @brief 返回累计样本数达到 rank 的桶的上界 (内部函数)。
+ */
+static unsigned long latency_percentile(const thread_pool_latency_histogram_t *hist, unsigned long rank)
+{
+    unsigned long seen = 0;
+    for (int i = 0; i < THREAD_POOL_LATENCY_BUCKETS; i++) {
+        seen += hist->buckets[i];
+        if (seen >= rank) {
+            unsigned long upper = latency_bucket_upper(i);
+            return upper < hist->max_us ? upper : hist->max_us;
+        }
+    }
+    return hist->max_us;
+}
+
+void latency_hist_read(latency_hist_t *hist, thread_pool_latency_histogram_t *out)
+{
+    out->count = 0;
+    for (int i = 0; i < THREAD_POOL_LATENCY_BUCKETS; i++) {
+        out->buckets[i] = atomic_load_explicit(&hist->buckets[i], memory_order_relaxed);
+        out->count += out->buckets[i];
+    }
+    out->max_us = atomic_load_explicit(&hist->max_us, memory_order_relaxed);
+    if (out->count == 0) {
+        out->p50_us = 0;
+        out->p99_us = 0;
+        return;
+    }
+    // 名次向上取整，保证单个样本时 p50 和 p99 都落在该样本所在的桶
+    out->p50_us = latency_percentile(out, (unsigned long)(((uint64_t)out->count * 50 + 99) / 100));
+    out->p99_us = latency_percentile(out, (unsigned long)(((uint64_t)out->count * 99 + 99) / 100));
+}
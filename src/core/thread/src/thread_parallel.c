@@ -0,0 +1,252 @@
+/**
+ * @file thread_parallel.c
+ * @brief parallel_for / parallel_reduce 的实现。
+ *
+ * 区间按线程数切成若干块，调用线程和不超过线程数的辅助任务以 CAS 领取下一块，
+ * 先空闲的参与者领取更多块，从而适应各块耗时不均的情况。
+ * 作业描述放在调用线程的栈上；区间领完后调用线程撤回尚未开始的辅助任务，
+ * 只等待已经开始的辅助任务，然后才返回，因此辅助任务不会在返回后访问作业。
+ */
+#include "thread_internal.h"
+#include <stdlib.h>
+#include <string.h>
+
+/** 单次调用最多提交的辅助任务数量，辅助任务的描述都放在调用线程的栈上。 */
+#define PARALLEL_MAX_HELPERS 63
+
+/** 每个参与线程平均分到的块数，多于 1 块以便先完成的线程分担较慢的块。 */
+#define PARALLEL_CHUNKS_PER_THREAD 4
+
+typedef struct parallel_job_s parallel_job_t;
+
+/**
+ * @struct parallel_helper_t
+ * @brief 辅助任务的参数：所属作业和参与者编号 (调用线程为 0)。
+ */
+typedef struct {
+    parallel_job_t *job;
+    int slot;
+} parallel_helper_t;
+
+/**
+ * @struct parallel_job_s
+ * @brief 一次并行循环或归约的作业描述。
+ */
+struct parallel_job_s {
+    _Atomic size_t next;               /**< 下一块的起点。 */
+    size_t end;                        /**< 区间终点 (不含)。 */
+    size_t chunk;                      /**< 块大小。 */
+    thread_pool_range_fn_t for_fn;     /**< parallel_for 的区间处理函数，归约时为 NULL。 */
+    thread_pool_reduce_fn_t reduce_fn; /**< parallel_reduce 的区间归约函数。 */
+    unsigned char *accumulators;       /**< 各参与者的累加值，按参与者编号排列。 */
+    size_t value_size;                 /**< 累加值的大小。 */
+    void *ctx;                         /**< 用户参数。 */
+    pthread_mutex_t lock;              /**< 保护 outstanding。 */
+    pthread_cond_t done;               /**< outstanding 归零时通知调用线程。 */
+    int outstanding;                   /**< 已提交且尚未结束或撤回的辅助任务数量。 */
+};
+
+/**
+ * @brief 领取下一块 (内部函数)。
+ *
+ * @return 领取到返回 1，区间已领完返回 0。
+ */
+static int parallel_claim(parallel_job_t *job, size_t *begin, size_t *end)
+{
+    size_t start = atomic_load_explicit(&job->next, memory_order_relaxed);
+    size_t stop;
+    do {
+        if (start >= job->end) {
+            return 0;
+        }
+        stop = job->end - start > job->chunk ? start + job->chunk : job->end;
+    } while (!atomic_compare_exchange_weak_explicit(&job->next, &start, stop, memory_order_relaxed,
+                                                    memory_order_relaxed));
+    *begin = start;
+    *end = stop;
+    return 1;
+}
+
+/**
+ * @brief 以指定参与者编号处理块，直到区间领完 (内部函数)。
+ */
+static void parallel_run_slot(parallel_job_t *job, int slot)
+{
+    size_t begin;
+    size_t end;
+    while (parallel_claim(job, &begin, &end)) {
+        if (job->for_fn != NULL) {
+            job->for_fn(begin, end, job->ctx);
+        } else {
+            job->reduce_fn(begin, end, job->accumulators + (size_t)slot * job->value_size, job->ctx);
+        }
+    }
+}
+
+/**
+ * @brief 辅助任务的任务函数 (内部函数)。通知调用线程之后不再访问作业。
+ */
+static void parallel_helper_task(void *arg)
+{
+    parallel_helper_t *helper = (parallel_helper_t *)arg;
+    parallel_job_t *job = helper->job;
+    parallel_run_slot(job, helper->slot);
+
+    pthread_mutex_lock(&job->lock);
+    if (--job->outstanding == 0) {
+        pthread_cond_signal(&job->done);
+    }
+    pthread_mutex_unlock(&job->lock);
+}
+
+/**
+ * @brief 根据线程数选择块大小和辅助任务数量 (内部函数)。
+ *
+ * @param chunk 输出块大小。
+ * @return 辅助任务数量。
+ */
+static int parallel_plan(thread_pool_t pool, size_t range, size_t grain, size_t *chunk)
+{
+    int threads = atomic_load_explicit(&pool->stat_thread_count, memory_order_relaxed);
+    if (threads > PARALLEL_MAX_HELPERS) {
+        threads = PARALLEL_MAX_HELPERS;
+    }
+    if (threads < 0) {
+        threads = 0;
+    }
+    size_t target_chunks = (size_t)(threads + 1) * PARALLEL_CHUNKS_PER_THREAD;
+    size_t size = range / target_chunks + (range % target_chunks != 0);
+    if (size < grain) {
+        size = grain;
+    }
+    *chunk = size;
+
+    size_t chunks = range / size + (range % size != 0);
+    return chunks - 1 < (size_t)threads ? (int)(chunks - 1) : threads;
+}
+
+/**
+ * @brief 提交辅助任务并与它们一起处理整个区间，返回时所有块都已处理完 (内部函数)。
+ *
+ * @param helpers 计划的辅助任务数量，不超过 PARALLEL_MAX_HELPERS。
+ */
+static void parallel_execute(thread_pool_t pool, parallel_job_t *job, int helpers)
+{
+    parallel_helper_t helper_args[PARALLEL_MAX_HELPERS];
+    thread_pool_task_spec_t specs[PARALLEL_MAX_HELPERS];
+    task_id_t task_ids[PARALLEL_MAX_HELPERS];
+    int results[PARALLEL_MAX_HELPERS];
+
+    pthread_mutex_init(&job->lock, NULL);
+    pthread_cond_init(&job->done, NULL);
+    job->outstanding = 0;
+
+    task_id_t first_task_id = helpers > 0 ? pool_reserve_task_ids(pool, helpers) : 0;
+    if (first_task_id == 0) {
+        helpers = 0; // 线程池正在关闭，由调用线程独自处理
+    }
+    for (int i = 0; i < helpers; i++) {
+        helper_args[i].job = job;
+        helper_args[i].slot = i + 1;
+        specs[i].function = parallel_helper_task;
+        specs[i].arg = &helper_args[i];
+        specs[i].task_name = task_anonymous_name;
+        specs[i].priority = TASK_PRIORITY_NORMAL;
+        task_ids[i] = first_task_id + (task_id_t)i;
+    }
+    if (helpers > 0) {
+        // 先计入全部辅助任务，再扣除提交失败的部分，避免提前完成的辅助任务把计数减成负数
+        job->outstanding = helpers;
+        int submitted = pool_submit_with_ids(pool, specs, task_ids, helpers, results);
+        if (submitted < helpers) {
+            pthread_mutex_lock(&job->lock);
+            job->outstanding -= helpers - submitted;
+            pthread_mutex_unlock(&job->lock);
+        }
+    }
+
+    parallel_run_slot(job, 0);
+
+    // 区间已领完，撤回仍在队列中的辅助任务，只等待已经开始的
+    int withdrawn = 0;
+    for (int i = 0; i < helpers; i++) {
+        if (results[i] == 0 && thread_pool_cancel_task(pool, task_ids[i], NULL) == 0) {
+            withdrawn++;
+        }
+    }
+    pthread_mutex_lock(&job->lock);
+    job->outstanding -= withdrawn;
+    while (job->outstanding > 0) {
+        pthread_cond_wait(&job->done, &job->lock);
+    }
+    pthread_mutex_unlock(&job->lock);
+
+    pthread_cond_destroy(&job->done);
+    pthread_mutex_destroy(&job->lock);
+    TPOOL_DEBUG("线程池 %p: 并行处理 %d 个辅助任务 (撤回 %d 个)，块大小 %zu", (void *)pool, helpers, withdrawn,
+              job->chunk);
+}
+
+int thread_pool_parallel_for(thread_pool_t pool, size_t begin, size_t end, size_t grain, thread_pool_range_fn_t fn,
+                             void *ctx)
+{
+    if (pool == NULL || fn == NULL) {
+        TPOOL_ERROR("thread_pool_parallel_for: 无效参数 (pool: %p, fn: %s)", (void *)pool,
+                    fn == NULL ? "NULL" : "非空");
+        return -2;
+    }
+    if (end <= begin) {
+        return 0;
+    }
+
+    parallel_job_t job;
+    int helpers = parallel_plan(pool, end - begin, grain > 0 ? grain : 1, &job.chunk);
+    atomic_init(&job.next, begin);
+    job.end = end;
+    job.for_fn = fn;
+    job.reduce_fn = NULL;
+    job.accumulators = NULL;
+    job.value_size = 0;
+    job.ctx = ctx;
+    parallel_execute(pool, &job, helpers);
+    return 0;
+}
+
+int thread_pool_parallel_reduce(thread_pool_t pool, size_t begin, size_t end, size_t grain,
+                                thread_pool_reduce_fn_t fn, thread_pool_combine_fn_t combine, const void *identity,
+                                size_t value_size, void *result, void *ctx)
+{
+    if (pool == NULL || fn == NULL || combine == NULL || identity == NULL || value_size == 0 || result == NULL) {
+        TPOOL_ERROR("thread_pool_parallel_reduce: 无效参数 (pool: %p, fn: %s, combine: %s, value_size: %zu)",
+                    (void *)pool, fn == NULL ? "NULL" : "非空", combine == NULL ? "NULL" : "非空", value_size);
+        return -2;
+    }
+    memcpy(result, identity, value_size);
+    if (end <= begin) {
+        return 0;
+    }
+
+    parallel_job_t job;
+    int helpers = parallel_plan(pool, end - begin, grain > 0 ? grain : 1, &job.chunk);
+    job.accumulators = (unsigned char *)malloc((size_t)(helpers + 1) * value_size);
+    if (job.accumulators == NULL) {
+        TPOOL_ERROR("thread_pool_parallel_reduce: 未能为 %d 个累加值分配内存", helpers + 1);
+        return -1;
+    }
+    for (int i = 0; i <= helpers; i++) {
+        memcpy(job.accumulators + (size_t)i * value_size, identity, value_size);
+    }
+    atomic_init(&job.next, begin);
+    job.end = end;
+    job.for_fn = NULL;
+    job.reduce_fn = fn;
+    job.value_size = value_size;
+    job.ctx = ctx;
+    parallel_execute(pool, &job, helpers);
+
+    for (int i = 0; i <= helpers; i++) {
+        combine(result, job.accumulators + (size_t)i * value_size, ctx);
+    }
+    free(job.accumulators);
+    return 0;
+}
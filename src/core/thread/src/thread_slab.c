@@ -0,0 +1,127 @@
+/**
+ * @file thread_slab.c
+ * @brief 线程池任务节点 slab 的实现。
+ *
+ * 任务节点按块预分配，通过空闲链表循环复用，
+ * 工作线程另外持有一个小型本地缓存以减少对共享空闲链表的访问。
+ */
+#include "thread_internal.h"
+#include <stdlib.h>
+
+/**
+ * @brief 分配一个包含指定数量节点的内存块并将其节点挂入空闲链表 (内部函数)。
+ *
+ * @param slab 任务节点 slab。
+ * @param node_count 新内存块的节点数量。
+ * @return 成功返回 0，内存分配失败返回 -1。
+ */
+static int task_slab_grow(task_slab_t *slab, int node_count)
+{
+    task_slab_chunk_t *chunk =
+        (task_slab_chunk_t *)malloc(sizeof(task_slab_chunk_t) + (size_t)node_count * sizeof(task_node_t));
+    if (chunk == NULL) {
+        TPOOL_ERROR("task_slab_grow: 未能为 %d 个任务节点分配内存块", node_count);
+        return -1;
+    }
+    chunk->node_count = node_count;
+    chunk->next = slab->chunks;
+    slab->chunks = chunk;
+
+    // 逆序挂入，使低地址节点先被取出，便于顺序访问
+    for (int i = node_count - 1; i >= 0; i--) {
+        chunk->nodes[i].next = slab->free_list;
+        slab->free_list = &chunk->nodes[i];
+    }
+    slab->free_count += node_count;
+    slab->total_nodes += node_count;
+    TPOOL_DEBUG("任务节点 slab %p 扩展 %d 个节点，总节点数: %d", (void *)slab, node_count,
+              slab->total_nodes);
+    return 0;
+}
+
+int task_slab_init(task_slab_t *slab, int initial_nodes, int chunk_nodes)
+{
+    if (slab == NULL || initial_nodes < 0 || chunk_nodes <= 0) {
+        return -1;
+    }
+    slab->chunks = NULL;
+    slab->free_list = NULL;
+    slab->free_count = 0;
+    slab->total_nodes = 0;
+    slab->chunk_nodes = chunk_nodes;
+
+    if (initial_nodes > 0 && task_slab_grow(slab, initial_nodes) != 0) {
+        return -1;
+    }
+    return 0;
+}
+
+void task_slab_destroy(task_slab_t *slab)
+{
+    if (slab == NULL) {
+        return;
+    }
+    task_slab_chunk_t *chunk = slab->chunks;
+    while (chunk != NULL) {
+        task_slab_chunk_t *next = chunk->next;
+        free(chunk);
+        chunk = next;
+    }
+    slab->chunks = NULL;
+    slab->free_list = NULL;
+    slab->free_count = 0;
+    slab->total_nodes = 0;
+}
+
+task_node_t *task_slab_alloc(task_slab_t *slab)
+{
+    if (slab->free_list == NULL && task_slab_grow(slab, slab->chunk_nodes) != 0) {
+        return NULL;
+    }
+    task_node_t *node = slab->free_list;
+    slab->free_list = node->next;
+    slab->free_count--;
+    node->next = NULL;
+    return node;
+}
+
+void task_slab_free(task_slab_t *slab, task_node_t *node)
+{
+    node->next = slab->free_list;
+    slab->free_list = node;
+    slab->free_count++;
+}
+
+task_node_t *task_node_cache_pop(task_node_cache_t *cache)
+{
+    task_node_t *node = cache->head;
+    if (node != NULL) {
+        cache->head = node->next;
+        cache->count--;
+        node->next = NULL;
+    }
+    return node;
+}
+
+int task_node_cache_push(task_node_cache_t *cache, task_node_t *node)
+{
+    if (cache->count >= TASK_NODE_CACHE_MAX) {
+        return -1;
+    }
+    node->next = cache->head;
+    cache->head = node;
+    cache->count++;
+    return 0;
+}
+
+void task_node_cache_flush(task_node_cache_t *cache, task_slab_t *slab)
+{
+    task_node_t *node = cache->head;
+    while (node != NULL) {
+        task_node_t *next = node->next;
+        task_slab_free(slab, node);
+        node = next;
+    }
+    cache->head = NULL;
+    cache->count = 0;
+}
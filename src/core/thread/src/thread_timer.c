@@ -0,0 +1,175 @@
+/**
+ * @file thread_timer.c
+ * @brief 延迟和周期任务使用的分级时间轮实现。
+ *
+ * 结构与经典的 Linux 级联时间轮相同：以 1 毫秒为一个刻度，第 0 级直接按刻度分槽，
+ * 更高级别在下级转完一圈时把当前槽位的节点重新分配到下级。插入和删除都是 O(1)，
+ * 推进时每个刻度只处理一个第 0 级槽位，级联的代价均摊到各节点上。
+ */
+#include "thread_internal.h"
+
+/** 距当前刻度的最大偏移，超过时节点放在顶级的最远槽位，级联时再重新分配。 */
+#define TIMER_WHEEL_MAX_OFFSET ((UINT64_C(1) << (TIMER_WHEEL_BITS * TIMER_WHEEL_LEVELS)) - 1)
+
+void timer_wheel_init(timer_wheel_t *wheel, uint64_t now)
+{
+    for (int level = 0; level < TIMER_WHEEL_LEVELS; level++) {
+        for (int slot = 0; slot < TIMER_WHEEL_SLOTS; slot++) {
+            wheel->slots[level][slot] = NULL;
+        }
+        wheel->bitmap[level] = 0;
+    }
+    wheel->current = now;
+    wheel->count = 0;
+}
+
+/**
+ * @brief 按到期时间把节点放入对应级别的槽位 (内部函数)。
+ */
+static void timer_wheel_place(timer_wheel_t *wheel, task_node_t *node)
+{
+    uint64_t expire = node->timer_expire;
+    uint64_t offset;
+    if (expire < wheel->current) {
+        offset = 0;
+        expire = wheel->current;
+    } else {
+        offset = expire - wheel->current;
+        if (offset > TIMER_WHEEL_MAX_OFFSET) {
+            offset = TIMER_WHEEL_MAX_OFFSET;
+            expire = wheel->current + offset;
+        }
+    }
+
+    int level = 0;
+    while (level < TIMER_WHEEL_LEVELS - 1 && offset >= (UINT64_C(1) << (TIMER_WHEEL_BITS * (level + 1)))) {
+        level++;
+    }
+    int slot = (int)((expire >> (TIMER_WHEEL_BITS * level)) & (TIMER_WHEEL_SLOTS - 1));
+
+    node->prev = NULL;
+    node->next = wheel->slots[level][slot];
+    if (node->next != NULL) {
+        node->next->prev = node;
+    }
+    wheel->slots[level][slot] = node;
+    wheel->bitmap[level] |= UINT64_C(1) << slot;
+    node->timer_slot = level * TIMER_WHEEL_SLOTS + slot;
+    wheel->count++;
+}
+
+void timer_wheel_insert(timer_wheel_t *wheel, task_node_t *node, uint64_t now)
+{
+    if (wheel->count == 0 && now > wheel->current) {
+        // 空闲的时间轮不会被推进，current 可能停在很久以前，直接跳到当前刻度以免推进时逐刻度追赶
+        wheel->current = now;
+    }
+    timer_wheel_place(wheel, node);
+}
+
+void timer_wheel_remove(timer_wheel_t *wheel, task_node_t *node)
+{
+    int level = node->timer_slot / TIMER_WHEEL_SLOTS;
+    int slot = node->timer_slot % TIMER_WHEEL_SLOTS;
+
+    if (node->prev != NULL) {
+        node->prev->next = node->next;
+    } else {
+        wheel->slots[level][slot] = node->next;
+        if (node->next == NULL) {
+            wheel->bitmap[level] &= ~(UINT64_C(1) << slot);
+        }
+    }
+    if (node->next != NULL) {
+        node->next->prev = node->prev;
+    }
+    node->next = NULL;
+    node->prev = NULL;
+    node->timer_slot = -1;
+    wheel->count--;
+}
+
+/**
+ * @brief 取下一个槽位的整条链表并清空该槽位 (内部函数)。
+ */
+static task_node_t *timer_wheel_take_slot(timer_wheel_t *wheel, int level, int slot)
+{
+    task_node_t *list = wheel->slots[level][slot];
+    if (list == NULL) {
+        return NULL;
+    }
+    wheel->slots[level][slot] = NULL;
+    wheel->bitmap[level] &= ~(UINT64_C(1) << slot);
+    for (task_node_t *node = list; node != NULL; node = node->next) {
+        node->timer_slot = -1;
+        wheel->count--;
+    }
+    return list;
+}
+
+/**
+ * @brief 把上级槽位的节点按剩余时间重新分配到下级 (内部函数)。
+ *
+ * @return 该级的槽位编号，为 0 时说明该级也转完一圈，需要继续级联上一级。
+ */
+static int timer_wheel_cascade(timer_wheel_t *wheel, int level)
+{
+    int slot = (int)((wheel->current >> (TIMER_WHEEL_BITS * level)) & (TIMER_WHEEL_SLOTS - 1));
+    task_node_t *node = timer_wheel_take_slot(wheel, level, slot);
+    while (node != NULL) {
+        task_node_t *next = node->next;
+        timer_wheel_place(wheel, node);
+        node = next;
+    }
+    return slot;
+}
+
+task_node_t *timer_wheel_advance(timer_wheel_t *wheel, uint64_t now)
+{
+    task_node_t *expired = NULL;
+    task_node_t *tail = NULL;
+
+    while (wheel->current <= now) {
+        if (wheel->count == 0) {
+            // 没有剩余节点，直接跳到 now 之后
+            wheel->current = now + 1;
+            break;
+        }
+
+        int slot = (int)(wheel->current & (TIMER_WHEEL_SLOTS - 1));
+        if (slot == 0) {
+            for (int level = 1; level < TIMER_WHEEL_LEVELS && timer_wheel_cascade(wheel, level) == 0; level++) {
+                // 本级也转完一圈，继续级联上一级
+            }
+        }
+
+        task_node_t *list = timer_wheel_take_slot(wheel, 0, slot);
+        if (list != NULL) {
+            if (tail == NULL) {
+                expired = list;
+            } else {
+                tail->next = list;
+            }
+            tail = list;
+            while (tail->next != NULL) {
+                tail = tail->next;
+            }
+        }
+        wheel->current++;
+    }
+    return expired;
+}
+
+uint64_t timer_wheel_next_tick(const timer_wheel_t *wheel)
+{
+    if (wheel->count == 0) {
+        return UINT64_MAX;
+    }
+    int slot = (int)(wheel->current & (TIMER_WHEEL_SLOTS - 1));
+    uint64_t pending = wheel->bitmap[0] >> slot;
+    if (pending != 0) {
+        return wheel->current + (uint64_t)__builtin_ctzll(pending);
+    }
+    // 第 0 级本圈没有节点，在转完一圈时醒来级联
+    return wheel->current + (uint64_t)(TIMER_WHEEL_SLOTS - slot);
+}
@@ -0,0 +1,272 @@
+/**
+ * @file thread_trace.c
+ * @brief 线程池事件跟踪：每个线程私有的二进制环形缓冲区和 Chrome trace JSON 导出。
+ *
+ * 记录一个事件只是向当前线程的缓冲区写入一条定长记录，不格式化字符串，也不获取任何锁。
+ * 缓冲区在线程第一次记录事件时从全局登记表中领取，线程退出后保留到下一次 thread_pool_trace_start，
+ * 以便导出已退出线程 (例如被缩容的工作线程) 的事件；之后由新线程复用，从不释放。
+ *
+ * 控制函数与记录者之间用 busy 标志同步：记录者先置位自己的 busy 再检查全局开关，
+ * 控制函数先关闭开关再等待所有 busy 清零，此后可以安全地读取或重置所有缓冲区。
+ */
+#include "thread_internal.h"
+#include <sched.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+
+/**
+ * @struct trace_event_t
+ * @brief 一条定长的跟踪事件记录。
+ */
+typedef struct {
+    uint64_t ts_ns;   /**< 事件时间 (CLOCK_MONOTONIC 纳秒)。 */
+    const void *pool; /**< 产生事件的线程池。 */
+    uint64_t arg;     /**< 任务ID，调整大小事件为新的线程数。 */
+    uint32_t type;    /**< 事件类型 (trace_event_type_t)。 */
+    int32_t aux;      /**< 任务优先级，调整大小事件为原线程数。 */
+} trace_event_t;
+
+/**
+ * @struct trace_buffer_t
+ * @brief 一个线程的事件环形缓冲区。结构本身从不释放，events 只在跟踪暂停时重新分配。
+ */
+typedef struct trace_buffer_s {
+    atomic_int busy;             /**< 所属线程正在写入时为 1。 */
+    int owned;                   /**< 是否已被某个线程领取 (受 g_trace_lock 保护)。 */
+    int retired;                 /**< 所属线程已退出，本轮跟踪结束前不再复用 (受 g_trace_lock 保护)。 */
+    int tid;                     /**< 导出时使用的线程编号。 */
+    trace_event_t *events;       /**< 事件数组，容量为 mask + 1。 */
+    size_t mask;                 /**< 容量减一 (容量为 2 的幂)。 */
+    uint64_t head;               /**< 已写入的事件总数，只由所属线程在 busy 期间修改。 */
+    struct trace_buffer_s *next; /**< 登记表中的下一个缓冲区。 */
+} trace_buffer_t;
+
+atomic_int g_trace_enabled;
+
+static pthread_mutex_t g_trace_lock = PTHREAD_MUTEX_INITIALIZER;
+static trace_buffer_t *g_trace_buffers; // 所有缓冲区的登记表，受 g_trace_lock 保护
+static size_t g_trace_capacity;         // 本轮跟踪每个缓冲区的容量，受 g_trace_lock 保护
+static int g_trace_next_tid;            // 下一个线程编号，受 g_trace_lock 保护
+static pthread_once_t g_trace_key_once = PTHREAD_ONCE_INIT;
+static pthread_key_t g_trace_key; // 线程退出时归还缓冲区
+
+static _Thread_local trace_buffer_t *tls_trace_buffer;
+
+/**
+ * @brief 线程退出时把缓冲区标记为已退役 (内部函数)。
+ */
+static void trace_buffer_release(void *arg)
+{
+    trace_buffer_t *buffer = (trace_buffer_t *)arg;
+    pthread_mutex_lock(&g_trace_lock);
+    buffer->retired = 1;
+    pthread_mutex_unlock(&g_trace_lock);
+}
+
+static void trace_key_create(void)
+{
+    pthread_key_create(&g_trace_key, trace_buffer_release);
+}
+
+/**
+ * @brief 关闭记录并等待所有正在写入的线程完成 (内部函数)。
+ *
+ * 调用者必须持有 g_trace_lock。返回后在重新打开开关之前可以安全地访问所有缓冲区。
+ *
+ * @return 调用前是否处于记录状态。
+ */
+static int trace_pause_locked(void)
+{
+    int was_enabled = atomic_exchange(&g_trace_enabled, 0);
+    for (trace_buffer_t *buffer = g_trace_buffers; buffer != NULL; buffer = buffer->next) {
+        while (atomic_load(&buffer->busy)) {
+            sched_yield();
+        }
+    }
+    return was_enabled;
+}
+
+/**
+ * @brief 为当前线程领取一个缓冲区 (内部函数)。
+ *
+ * 优先复用未被领取的缓冲区，没有时分配新的缓冲区并加入登记表。
+ *
+ * @return 缓冲区，内存分配失败或跟踪已停止时返回 NULL。
+ */
+static trace_buffer_t *trace_buffer_acquire(void)
+{
+    pthread_once(&g_trace_key_once, trace_key_create);
+    pthread_mutex_lock(&g_trace_lock);
+    if (!atomic_load(&g_trace_enabled)) {
+        pthread_mutex_unlock(&g_trace_lock);
+        return NULL;
+    }
+    trace_buffer_t *buffer = g_trace_buffers;
+    while (buffer != NULL && buffer->owned) {
+        buffer = buffer->next;
+    }
+    if (buffer == NULL) {
+        buffer = (trace_buffer_t *)calloc(1, sizeof(trace_buffer_t));
+        trace_event_t *events = (trace_event_t *)malloc(g_trace_capacity * sizeof(trace_event_t));
+        if (buffer == NULL || events == NULL) {
+            pthread_mutex_unlock(&g_trace_lock);
+            free(buffer);
+            free(events);
+            return NULL;
+        }
+        atomic_init(&buffer->busy, 0);
+        buffer->events = events;
+        buffer->mask = g_trace_capacity - 1;
+        buffer->next = g_trace_buffers;
+        g_trace_buffers = buffer;
+    }
+    // 空闲的缓冲区已在 thread_pool_trace_start 中清空，容量与本轮一致
+    buffer->owned = 1;
+    buffer->tid = ++g_trace_next_tid;
+    pthread_mutex_unlock(&g_trace_lock);
+
+    pthread_setspecific(g_trace_key, buffer);
+    tls_trace_buffer = buffer;
+    return buffer;
+}
+
+void trace_record(trace_event_type_t type, const void *pool, uint64_t arg, int aux)
+{
+    trace_buffer_t *buffer = tls_trace_buffer;
+    if (buffer == NULL && (buffer = trace_buffer_acquire()) == NULL) {
+        return;
+    }
+    atomic_store(&buffer->busy, 1);
+    if (atomic_load(&g_trace_enabled)) {
+        trace_event_t *event = &buffer->events[buffer->head & buffer->mask];
+        event->ts_ns = latency_now_ns();
+        event->pool = pool;
+        event->arg = arg;
+        event->type = (uint32_t)type;
+        event->aux = aux;
+        buffer->head++;
+    }
+    atomic_store_explicit(&buffer->busy, 0, memory_order_release);
+}
+
+int thread_pool_trace_start(size_t events_per_thread)
+{
+    if (events_per_thread == 0 || events_per_thread > ((size_t)1 << 30)) {
+        TPOOL_ERROR("thread_pool_trace_start: 每线程事件数 %zu 超出范围 (1 到 2^30)", events_per_thread);
+        return -1;
+    }
+    size_t capacity = 1;
+    while (capacity < events_per_thread) {
+        capacity <<= 1;
+    }
+
+    pthread_mutex_lock(&g_trace_lock);
+    trace_pause_locked();
+    for (trace_buffer_t *buffer = g_trace_buffers; buffer != NULL; buffer = buffer->next) {
+        if (buffer->mask + 1 != capacity) {
+            trace_event_t *events = (trace_event_t *)malloc(capacity * sizeof(trace_event_t));
+            if (events == NULL) {
+                pthread_mutex_unlock(&g_trace_lock);
+                TPOOL_ERROR("thread_pool_trace_start: 未能为 %zu 个跟踪事件分配内存", capacity);
+                return -1;
+            }
+            free(buffer->events);
+            buffer->events = events;
+            buffer->mask = capacity - 1;
+        }
+        buffer->head = 0;
+        if (buffer->retired) { // 上一轮中已退出的线程的缓冲区，现在可以复用
+            buffer->owned = 0;
+            buffer->retired = 0;
+        }
+    }
+    g_trace_capacity = capacity;
+    atomic_store(&g_trace_enabled, 1);
+    pthread_mutex_unlock(&g_trace_lock);
+    return 0;
+}
+
+void thread_pool_trace_stop(void)
+{
+    pthread_mutex_lock(&g_trace_lock);
+    trace_pause_locked();
+    pthread_mutex_unlock(&g_trace_lock);
+}
+
+/**
+ * @brief 写出一条事件的 JSON 对象 (内部函数)。
+ */
+static void trace_write_event(FILE *file, int pid, int tid, const trace_event_t *event)
+{
+    static const char *const names[] = {"enqueue", "dequeue", "task", "task", "idle", "idle", "threads"};
+    static const char phases[] = {'i', 'i', 'B', 'E', 'B', 'E', 'C'};
+    if (event->type >= sizeof(phases)) {
+        return;
+    }
+    fprintf(file, ",\n{\"name\":\"%s\",\"cat\":\"thread_pool\",\"ph\":\"%c\",\"ts\":%.3f,\"pid\":%d,\"tid\":%d",
+            names[event->type], phases[event->type], (double)event->ts_ns / 1000.0, pid, tid);
+    switch ((trace_event_type_t)event->type) {
+    case TRACE_EVENT_ENQUEUE:
+    case TRACE_EVENT_DEQUEUE:
+        fprintf(file, ",\"s\":\"t\",\"args\":{\"pool\":\"%p\",\"task\":%llu,\"priority\":%d}}", event->pool,
+                (unsigned long long)event->arg, (int)event->aux);
+        break;
+    case TRACE_EVENT_START:
+        fprintf(file, ",\"args\":{\"pool\":\"%p\",\"task\":%llu,\"priority\":%d}}", event->pool,
+                (unsigned long long)event->arg, (int)event->aux);
+        break;
+    case TRACE_EVENT_SLEEP:
+        fprintf(file, ",\"args\":{\"pool\":\"%p\",\"worker\":%llu}}", event->pool, (unsigned long long)event->arg);
+        break;
+    case TRACE_EVENT_RESIZE:
+        // 计数器按 id 区分不同的线程池
+        fprintf(file, ",\"id\":\"%p\",\"args\":{\"threads\":%llu}}", event->pool, (unsigned long long)event->arg);
+        break;
+    default:
+        fputc('}', file);
+        break;
+    }
+}
+
+int thread_pool_trace_export_chrome(const char *path)
+{
+    if (path == NULL) {
+        TPOOL_ERROR("thread_pool_trace_export_chrome: 文件路径为 NULL");
+        return -1;
+    }
+    FILE *file = fopen(path, "w");
+    if (file == NULL) {
+        TPOOL_ERROR("thread_pool_trace_export_chrome: 无法打开文件 %s", path);
+        return -1;
+    }
+
+    pthread_mutex_lock(&g_trace_lock);
+    int was_enabled = trace_pause_locked();
+    int pid = (int)getpid();
+    // 第一条是进程名元数据，之后的事件都以逗号开头
+    fprintf(file, "{\"displayTimeUnit\":\"ns\",\"traceEvents\":[\n"
+                  "{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":%d,\"args\":{\"name\":\"thread_pool\"}}",
+            pid);
+    for (trace_buffer_t *buffer = g_trace_buffers; buffer != NULL; buffer = buffer->next) {
+        if (buffer->head == 0) {
+            continue;
+        }
+        // 缓冲区已回绕时只保留最近的 mask + 1 个事件
+        uint64_t first = buffer->head > buffer->mask + 1 ? buffer->head - (buffer->mask + 1) : 0;
+        for (uint64_t i = first; i < buffer->head; i++) {
+            trace_write_event(file, pid, buffer->tid, &buffer->events[i & buffer->mask]);
+        }
+    }
+    if (was_enabled) {
+        atomic_store(&g_trace_enabled, 1);
+    }
+    pthread_mutex_unlock(&g_trace_lock);
+
+    fputs("\n]}\n", file);
+    if (fclose(file) != 0) {
+        TPOOL_ERROR("thread_pool_trace_export_chrome: 写入文件 %s 失败", path);
+        return -1;
+    }
+    return 0;
+}
@@ -0,0 +1,106 @@
+/**
+ * @file thread_ws.c
+ * @brief 工作窃取模式使用的 Chase-Lev 双端队列实现。
+ *
+ * 内存序参照 Lê 等人针对弱内存模型给出的 C11 版本 Chase-Lev 算法。
+ * 为了避免扩容时旧缓冲区的回收问题，这里使用固定容量的环形缓冲区，
+ * 队列满时由调用者回退到共享运行队列。
+ */
+#include "thread_internal.h"
+#include <stdlib.h>
+
+ws_deque_t *ws_deque_create(size_t capacity)
+{
+    size_t rounded = 2;
+    while (rounded < capacity) {
+        rounded <<= 1;
+    }
+
+    ws_deque_t *deque = (ws_deque_t *)malloc(sizeof(ws_deque_t));
+    if (deque == NULL) {
+        TPOOL_ERROR("ws_deque_create: 未能为工作窃取队列分配内存");
+        return NULL;
+    }
+    deque->slots = (_Atomic(task_node_t *) *)calloc(rounded, sizeof(*deque->slots));
+    if (deque->slots == NULL) {
+        TPOOL_ERROR("ws_deque_create: 未能为 %zu 个工作窃取队列槽位分配内存", rounded);
+        free(deque);
+        return NULL;
+    }
+    atomic_init(&deque->top, 0);
+    atomic_init(&deque->bottom, 0);
+    deque->mask = rounded - 1;
+    return deque;
+}
+
+void ws_deque_destroy(ws_deque_t *deque)
+{
+    if (deque == NULL) {
+        return;
+    }
+    free((void *)deque->slots);
+    free(deque);
+}
+
+int ws_deque_push(ws_deque_t *deque, task_node_t *node)
+{
+    size_t b = atomic_load_explicit(&deque->bottom, memory_order_relaxed);
+    size_t t = atomic_load_explicit(&deque->top, memory_order_acquire);
+    if (b - t > deque->mask) {
+        return -1; // 队列已满
+    }
+    atomic_store_explicit(&deque->slots[b & deque->mask], node, memory_order_relaxed);
+    atomic_thread_fence(memory_order_release);
+    atomic_store_explicit(&deque->bottom, b + 1, memory_order_relaxed);
+    return 0;
+}
+
+task_node_t *ws_deque_pop(ws_deque_t *deque)
+{
+    size_t b = atomic_load_explicit(&deque->bottom, memory_order_relaxed) - 1;
+    atomic_store_explicit(&deque->bottom, b, memory_order_relaxed);
+    atomic_thread_fence(memory_order_seq_cst);
+    size_t t = atomic_load_explicit(&deque->top, memory_order_relaxed);
+
+    // 索引使用无符号回绕运算，差值按有符号解释
+    if ((ptrdiff_t)(b - t) < 0) {
+        // 队列为空，恢复 bottom
+        atomic_store_explicit(&deque->bottom, b + 1, memory_order_relaxed);
+        return NULL;
+    }
+
+    task_node_t *node = atomic_load_explicit(&deque->slots[b & deque->mask], memory_order_relaxed);
+    if (b == t) {
+        // 只剩最后一个节点，与窃取者竞争
+        if (!atomic_compare_exchange_strong_explicit(&deque->top, &t, t + 1, memory_order_seq_cst,
+                                                     memory_order_relaxed)) {
+            node = NULL; // 被窃取者抢走
+        }
+        atomic_store_explicit(&deque->bottom, b + 1, memory_order_relaxed);
+    }
+    return node;
+}
+
+task_node_t *ws_deque_steal(ws_deque_t *deque)
+{
+    size_t t = atomic_load_explicit(&deque->top, memory_order_acquire);
+    atomic_thread_fence(memory_order_seq_cst);
+    size_t b = atomic_load_explicit(&deque->bottom, memory_order_acquire);
+
+    if ((ptrdiff_t)(b - t) <= 0) {
+        return NULL; // 队列为空
+    }
+    task_node_t *node = atomic_load_explicit(&deque->slots[t & deque->mask], memory_order_relaxed);
+    if (!atomic_compare_exchange_strong_explicit(&deque->top, &t, t + 1, memory_order_seq_cst,
+                                                 memory_order_relaxed)) {
+        return NULL; // 与所有者或其他窃取者竞争失败
+    }
+    return node;
+}
+
+size_t ws_deque_size(ws_deque_t *deque)
+{
+    size_t b = atomic_load_explicit(&deque->bottom, memory_order_relaxed);
+    size_t t = atomic_load_explicit(&deque->top, memory_order_relaxed);
+    return (ptrdiff_t)(b - t) > 0 ? b - t : 0;
+}
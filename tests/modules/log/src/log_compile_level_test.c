@@ -0,0 +1,93 @@
+/**
+ * @file log_compile_level_test.c
+ * @brief 编译期日志级别测试
+ *
+ * 本文件以 CROLINKIT_LOG_COMPILE_LEVEL 为 3 (INFO) 编译，DEBUG 和 TRACE 级别的日志宏在编译期被移除。
+ * 运行期把级别设为 TRACE 后，被移除的宏仍然不能求值参数、不能调用 log_write。
+ */
+
+// 无论项目是否全局设置了编译期级别，本测试都固定使用 INFO
+#undef CROLINKIT_LOG_COMPILE_LEVEL
+#define CROLINKIT_LOG_COMPILE_LEVEL 3
+
+#include "log.h"
+#include <assert.h>
+#include <stdio.h>
+#include <string.h>
+#include <unistd.h>
+
+// 测试日志文件路径
+#define TEST_LOG_FILE "log_compile_level_test.log"
+
+// 记录日志参数被求值的次数
+static int arg_evaluations = 0;
+
+// 按级别统计回调次数
+static int callback_count[LOG_LEVEL_TRACE + 1];
+
+static int count_evaluation(void)
+{
+    return ++arg_evaluations;
+}
+
+static void counting_callback(log_level_t level, log_module_t module, const char *file, int line,
+                              const char *func, const char *message, void *user_data)
+{
+    (void)module;
+    (void)file;
+    (void)line;
+    (void)func;
+    (void)message;
+    (void)user_data;
+    callback_count[level]++;
+}
+
+// 测试编译期移除的日志宏不求值参数
+static void test_elided_macros(void)
+{
+    printf("测试编译期移除的日志宏...\n");
+
+    unlink(TEST_LOG_FILE);
+    assert(log_init(TEST_LOG_FILE, LOG_LEVEL_TRACE) == 0);
+    for (int i = 0; i < LOG_MODULE_MAX; i++) {
+        log_set_module_output((log_module_t)i, false, false);
+    }
+    log_set_module_level(LOG_MODULE_CORE, LOG_LEVEL_TRACE);
+    assert(log_level_enabled_fast(LOG_MODULE_CORE, LOG_LEVEL_TRACE));
+    memset(callback_count, 0, sizeof(callback_count));
+    assert(log_register_callback(counting_callback, NULL) == 0);
+
+    // 运行期级别已允许，但宏在编译期被移除
+    arg_evaluations = 0;
+    LOG_DEBUG(LOG_MODULE_CORE, "debug %d", count_evaluation());
+    LOG_TRACE(LOG_MODULE_CORE, "trace %d", count_evaluation());
+    LOG_BIN_DEBUG(LOG_MODULE_CORE, "bin debug %d", count_evaluation());
+    LOG_BIN_TRACE(LOG_MODULE_CORE, "bin trace %d", count_evaluation());
+    LOG_EVERY_N(LOG_LEVEL_DEBUG, LOG_MODULE_CORE, 1, "every debug %d", count_evaluation());
+    LOG_FIRST_N(LOG_LEVEL_TRACE, LOG_MODULE_CORE, 10, "first trace %d", count_evaluation());
+    assert(arg_evaluations == 0);
+    assert(callback_count[LOG_LEVEL_DEBUG] == 0 && callback_count[LOG_LEVEL_TRACE] == 0);
+
+    // 不比编译期级别更详细的宏照常输出
+    LOG_INFO(LOG_MODULE_CORE, "info %d", count_evaluation());
+    LOG_EVERY_N(LOG_LEVEL_WARN, LOG_MODULE_CORE, 1, "every warn %d", count_evaluation());
+    assert(arg_evaluations == 2);
+    assert(callback_count[LOG_LEVEL_INFO] == 1 && callback_count[LOG_LEVEL_WARN] == 1);
+
+    assert(log_unregister_callback(counting_callback) == 0);
+    log_deinit();
+    unlink(TEST_LOG_FILE);
+
+    printf("测试通过!\n");
+}
+
+// 主函数
+int main(void)
+{
+    printf("开始编译期日志级别测试...\n\n");
+
+    test_elided_macros();
+
+    printf("\n所有测试通过!\n");
+    return 0;
+}
@@ -5,10 +5,13 @@
 
 #include "log.h"
 #include <assert.h>
+#include <pthread.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
 #include <sys/stat.h>
+#include <sys/syscall.h>
+#include <time.h>
 #include <unistd.h>
 
 // 测试日志文件路径
@@ -49,6 +52,12 @@ void test_log_init_deinit(void)
     // 删除可能存在的旧日志文件
     unlink(TEST_LOG_FILE);
 
+    // 初始化之前任何模块、任何级别都不记录，包括 FATAL
+    for (int i = 0; i < LOG_MODULE_MAX; i++) {
+        assert(!log_is_level_enabled((log_module_t)i, LOG_LEVEL_FATAL));
+        assert(!log_level_enabled_fast((log_module_t)i, LOG_LEVEL_FATAL));
+    }
+
     // 测试初始化
     int ret = log_init(TEST_LOG_FILE, LOG_LEVEL_INFO);
     assert(ret == 0);
@@ -183,6 +192,990 @@ void test_log_rotation(void)
     printf("测试通过!\n");
 }
 
+// 统计文件中包含指定字符串的行数
+static int count_lines_containing(const char *filename, const char *needle)
+{
+    FILE *fp = fopen(filename, "r");
+    if (!fp) {
+        return -1;
+    }
+    char line[4096];
+    int count = 0;
+    while (fgets(line, sizeof(line), fp)) {
+        if (strstr(line, needle)) {
+            count++;
+        }
+    }
+    fclose(fp);
+    return count;
+}
+
+// 测试按写入字节数轮转和 .1 … .N 备份链
+void test_log_rotation_chain(void)
+{
+    printf("测试日志轮转备份链...\n");
+
+    char path[64];
+    for (int i = 0; i <= 4; i++) {
+        snprintf(path, sizeof(path), i == 0 ? TEST_LOG_FILE : TEST_LOG_FILE ".%d", i);
+        unlink(path);
+    }
+
+    log_init(TEST_LOG_FILE, LOG_LEVEL_INFO);
+    for (int i = 0; i < LOG_MODULE_MAX; i++) {
+        log_set_module_output((log_module_t)i, false, true);
+    }
+    log_rotation_config_t config = {.max_file_size = 1024,
+                                    .max_file_count = 3,
+                                    .rotate_on_size = true,
+                                    .rotate_on_time = false,
+                                    .rotate_interval_hours = 24};
+    log_set_rotation_config(&config);
+
+    // 写满多个文件，只保留当前文件和两个备份
+    for (int i = 0; i < 200; i++) {
+        LOG_INFO(LOG_MODULE_CORE, "rotation-chain line %d", i);
+    }
+
+    // log_rotate_now 返回时上一个文件已成为 .1
+    LOG_INFO(LOG_MODULE_CORE, "rotation-marker");
+    assert(log_rotate_now() == 0);
+    assert(count_lines_containing(TEST_LOG_FILE ".1", "rotation-marker") == 1);
+    assert(count_lines_containing(TEST_LOG_FILE, "rotation-marker") == 0);
+    log_deinit();
+
+    assert(file_exists(TEST_LOG_FILE ".1"));
+    assert(file_exists(TEST_LOG_FILE ".2"));
+    assert(!file_exists(TEST_LOG_FILE ".3"));
+    assert(!file_exists(TEST_LOG_FILE ".rotating.1"));
+
+    // 每个备份文件的大小不超过上限加一行
+    struct stat st;
+    assert(stat(TEST_LOG_FILE ".2", &st) == 0);
+    assert(st.st_size > 0 && st.st_size < 1024 + 512);
+
+    // 恢复默认配置，后续测试不受影响
+    config.max_file_size = 10 * 1024 * 1024;
+    config.max_file_count = 5;
+    log_init(TEST_LOG_FILE, LOG_LEVEL_INFO);
+    log_set_rotation_config(&config);
+    log_deinit();
+
+    printf("测试通过!\n");
+}
+
+// 异步测试回调：按级别计数，可选地拖慢后台写线程
+static int async_callback_count[LOG_LEVEL_TRACE + 1];
+static int async_callback_delay_us = 0;
+static pthread_t async_callback_thread;
+
+static void async_test_callback(log_level_t level, log_module_t module, const char *file, int line,
+                                const char *func, const char *message, void *user_data)
+{
+    (void)module;
+    (void)file;
+    (void)line;
+    (void)func;
+    (void)user_data;
+    if (strstr(message, "async-") == NULL) {
+        return;
+    }
+    async_callback_count[level]++;
+    async_callback_thread = pthread_self();
+    if (async_callback_delay_us > 0) {
+        struct timespec ts = {0, async_callback_delay_us * 1000L};
+        nanosleep(&ts, NULL);
+    }
+}
+
+// 多个线程并发写入异步日志
+static void *async_writer_thread(void *arg)
+{
+    int id = *(int *)arg;
+    for (int i = 0; i < 500; i++) {
+        LOG_INFO(LOG_MODULE_CORE, "async-msg thread=%d seq=%d", id, i);
+    }
+    return NULL;
+}
+
+// 为异步测试初始化日志系统：关闭控制台输出，注册计数回调
+static void async_test_init(void)
+{
+    unlink(TEST_LOG_FILE);
+    log_init(TEST_LOG_FILE, LOG_LEVEL_INFO);
+    // 轮转配置在 log_deinit 之后仍然保留，关闭按大小轮转以便统计行数
+    log_rotation_config_t rotation;
+    log_get_rotation_config(&rotation);
+    rotation.rotate_on_size = false;
+    log_set_rotation_config(&rotation);
+    for (int i = 0; i < LOG_MODULE_MAX; i++) {
+        log_set_module_output((log_module_t)i, false, true);
+    }
+    memset(async_callback_count, 0, sizeof(async_callback_count));
+    async_callback_delay_us = 0;
+    assert(log_register_callback(async_test_callback, NULL) == 0);
+}
+
+// 测试异步日志
+void test_log_async(void)
+{
+    printf("测试异步日志...\n");
+
+    // 未初始化时不能启用
+    assert(log_enable_async(NULL) == -1);
+
+    // 阻塞策略：多个生产者写满小缓冲区，不丢失任何日志
+    async_test_init();
+    log_async_config_t config;
+    log_async_config_init(&config);
+    assert(config.overflow_policy == LOG_OVERFLOW_BLOCK);
+    config.queue_capacity = 0;
+    assert(log_enable_async(&config) == -1);
+    config.queue_capacity = 16;
+    config.batch_size = 8;
+    assert(log_enable_async(&config) == 0);
+    assert(log_enable_async(&config) == -2);
+
+    pthread_t threads[4];
+    int ids[4];
+    for (int i = 0; i < 4; i++) {
+        ids[i] = i;
+        pthread_create(&threads[i], NULL, async_writer_thread, &ids[i]);
+    }
+    for (int i = 0; i < 4; i++) {
+        pthread_join(threads[i], NULL);
+    }
+    assert(log_disable_async() == 0);
+    assert(log_disable_async() == -1);
+
+    log_async_stats_t stats;
+    log_get_async_stats(&stats);
+    assert(stats.enqueued == 2000);
+    assert(stats.written == 2000);
+    assert(stats.dropped == 0);
+    assert(async_callback_count[LOG_LEVEL_INFO] == 2000);
+    // 回调在后台写线程中调用
+    assert(!pthread_equal(async_callback_thread, pthread_self()));
+
+    // 停用后恢复同步输出
+    LOG_INFO(LOG_MODULE_CORE, "async-sync-after-disable");
+    assert(async_callback_count[LOG_LEVEL_INFO] == 2001);
+    assert(pthread_equal(async_callback_thread, pthread_self()));
+    log_deinit();
+    assert(count_lines_containing(TEST_LOG_FILE, "async-msg") == 2000);
+
+    // 丢弃最新策略：写线程被回调拖慢，缓冲区满时丢弃，计数守恒；ERROR 和 FATAL 日志从不丢弃
+    async_test_init();
+    log_async_config_init(&config);
+    config.queue_capacity = 4;
+    config.overflow_policy = LOG_OVERFLOW_DROP_NEWEST;
+    assert(log_enable_async(&config) == 0);
+    async_callback_delay_us = 1000;
+    for (int i = 0; i < 200; i++) {
+        LOG_INFO(LOG_MODULE_CORE, "async-drop %d", i);
+        if (i % 10 == 9) {
+            LOG_ERROR(LOG_MODULE_CORE, "async-drop-error %d", i);
+        }
+    }
+    LOG_FATAL(LOG_MODULE_CORE, "async-drop-fatal");
+    assert(count_lines_containing(TEST_LOG_FILE, "async-drop-fatal") == 1);
+    assert(log_disable_async() == 0);
+    log_get_async_stats(&stats);
+    assert(stats.dropped > 0);
+    assert(stats.enqueued + stats.dropped == 221);
+    assert(stats.written == stats.enqueued);
+    assert(async_callback_count[LOG_LEVEL_ERROR] == 20);
+    assert(async_callback_count[LOG_LEVEL_FATAL] == 1);
+    assert(async_callback_count[LOG_LEVEL_INFO] == (int)stats.written - 21);
+    log_deinit();
+    assert(count_lines_containing(TEST_LOG_FILE, "async-drop-error") == 20);
+
+    // 按级别丢弃策略：TRACE 被丢弃，WARN 全部保留
+    async_test_init();
+    log_set_module_level(LOG_MODULE_CORE, LOG_LEVEL_TRACE);
+    log_async_config_init(&config);
+    config.queue_capacity = 8;
+    config.overflow_policy = LOG_OVERFLOW_DROP_LOWEST_LEVEL;
+    assert(log_enable_async(&config) == 0);
+    async_callback_delay_us = 500;
+    for (int i = 0; i < 100; i++) {
+        LOG_TRACE(LOG_MODULE_CORE, "async-trace %d", i);
+        LOG_TRACE(LOG_MODULE_CORE, "async-trace %d", i);
+        LOG_WARN(LOG_MODULE_CORE, "async-warn %d", i);
+    }
+    assert(log_disable_async() == 0);
+    log_get_async_stats(&stats);
+    assert(async_callback_count[LOG_LEVEL_WARN] == 100);
+    assert(async_callback_count[LOG_LEVEL_TRACE] < 200);
+    assert(stats.dropped == (unsigned long)(200 - async_callback_count[LOG_LEVEL_TRACE]));
+    log_deinit();
+
+    // FATAL 日志返回时已写入文件；log_deinit 输出剩余的日志
+    async_test_init();
+    assert(log_enable_async(NULL) == 0);
+    for (int i = 0; i < 100; i++) {
+        LOG_INFO(LOG_MODULE_CORE, "async-before-fatal %d", i);
+    }
+    LOG_FATAL(LOG_MODULE_CORE, "async-fatal-line");
+    assert(count_lines_containing(TEST_LOG_FILE, "async-fatal-line") == 1);
+    assert(count_lines_containing(TEST_LOG_FILE, "async-before-fatal") == 100);
+    for (int i = 0; i < 100; i++) {
+        LOG_INFO(LOG_MODULE_CORE, "async-before-deinit %d", i);
+    }
+    log_deinit();
+    assert(count_lines_containing(TEST_LOG_FILE, "async-before-deinit") == 100);
+
+    printf("测试通过!\n");
+}
+
+// 记录日志参数被求值的次数
+static int level_arg_evaluations = 0;
+
+static int count_evaluation(void)
+{
+    return ++level_arg_evaluations;
+}
+
+// 在测试线程修改级别的同时无锁读取
+static void *level_toggle_thread(void *arg)
+{
+    (void)arg;
+    for (int i = 0; i < 1000; i++) {
+        log_set_module_level(LOG_MODULE_THREAD, (i & 1) ? LOG_LEVEL_TRACE : LOG_LEVEL_WARN);
+    }
+    return NULL;
+}
+
+// 测试无锁级别检查和日志宏的内联过滤
+void test_log_level_fast(void)
+{
+    printf("测试无锁级别检查...\n");
+
+    log_init(TEST_LOG_FILE, LOG_LEVEL_INFO);
+    for (int i = 0; i < LOG_MODULE_MAX; i++) {
+        log_set_module_output((log_module_t)i, false, false);
+    }
+
+    // 级别未启用时 LOG_DEBUG/LOG_TRACE 不求值参数
+    level_arg_evaluations = 0;
+    LOG_DEBUG(LOG_MODULE_CORE, "debug %d", count_evaluation());
+    LOG_TRACE(LOG_MODULE_CORE, "trace %d", count_evaluation());
+    assert(level_arg_evaluations == 0);
+
+    log_set_module_level(LOG_MODULE_CORE, LOG_LEVEL_DEBUG);
+    assert(log_level_enabled_fast(LOG_MODULE_CORE, LOG_LEVEL_DEBUG));
+    LOG_DEBUG(LOG_MODULE_CORE, "debug %d", count_evaluation());
+    LOG_TRACE(LOG_MODULE_CORE, "trace %d", count_evaluation());
+    assert(level_arg_evaluations == 1);
+
+    // 禁用模块后所有级别都被过滤
+    log_set_module_enable(LOG_MODULE_CORE, false);
+    assert(!log_is_level_enabled(LOG_MODULE_CORE, LOG_LEVEL_FATAL));
+    LOG_DEBUG(LOG_MODULE_CORE, "debug %d", count_evaluation());
+    assert(level_arg_evaluations == 1);
+    log_set_module_enable(LOG_MODULE_CORE, true);
+    assert(log_is_level_enabled(LOG_MODULE_CORE, LOG_LEVEL_DEBUG));
+
+    // 无效模块
+    assert(!log_is_level_enabled(LOG_MODULE_MAX, LOG_LEVEL_FATAL));
+
+    // 并发修改级别时读取
+    pthread_t thread;
+    pthread_create(&thread, NULL, level_toggle_thread, NULL);
+    int enabled = 0;
+    for (int i = 0; i < 1000; i++) {
+        enabled += log_is_level_enabled(LOG_MODULE_THREAD, LOG_LEVEL_DEBUG);
+    }
+    pthread_join(thread, NULL);
+    (void)enabled;
+    assert(log_get_module_level(LOG_MODULE_THREAD) == LOG_LEVEL_TRACE);
+
+    // 关闭后不再有任何级别被记录
+    log_deinit();
+    assert(!log_is_level_enabled(LOG_MODULE_CORE, LOG_LEVEL_FATAL));
+
+    printf("测试通过!\n");
+}
+
+// 测试缓冲输出和刷新策略
+void test_log_flush_policy(void)
+{
+    printf("测试刷新策略...\n");
+
+    log_flush_policy_t policy;
+    log_flush_policy_init(&policy);
+    assert(policy.buffer_size == 0 && policy.flush_bytes == 0 && policy.flush_interval_ms == 0);
+    assert(policy.flush_level == LOG_LEVEL_ERROR);
+    assert(log_flush() == -1);
+
+    unlink(TEST_LOG_FILE);
+    log_init(TEST_LOG_FILE, LOG_LEVEL_INFO);
+    for (int i = 0; i < LOG_MODULE_MAX; i++) {
+        log_set_module_output((log_module_t)i, false, true);
+    }
+
+    // 无效参数
+    policy.flush_interval_ms = -1;
+    assert(log_set_flush_policy(&policy) == -1);
+    assert(log_set_flush_policy(NULL) == -1);
+
+    // 大缓冲区，只有 ERROR 及更严重的日志立即刷新
+    policy.buffer_size = 64 * 1024;
+    policy.flush_bytes = 32 * 1024;
+    policy.flush_interval_ms = 0;
+    policy.flush_level = LOG_LEVEL_ERROR;
+    assert(log_set_flush_policy(&policy) == 0);
+    log_flush_policy_t current;
+    log_get_flush_policy(&current);
+    assert(current.buffer_size == 64 * 1024 && current.flush_bytes == 32 * 1024);
+
+    LOG_INFO(LOG_MODULE_CORE, "flush-buffered");
+    assert(count_lines_containing(TEST_LOG_FILE, "flush-buffered") == 0);
+    assert(log_flush() == 0);
+    assert(count_lines_containing(TEST_LOG_FILE, "flush-buffered") == 1);
+
+    LOG_WARN(LOG_MODULE_CORE, "flush-warn");
+    LOG_ERROR(LOG_MODULE_CORE, "flush-error");
+    assert(count_lines_containing(TEST_LOG_FILE, "flush-warn") == 1);
+    assert(count_lines_containing(TEST_LOG_FILE, "flush-error") == 1);
+
+    // 未刷新的数据达到 flush_bytes 时刷新
+    // 每行约 100 字节，4KB 在第 40 行之前只刷新一次
+    policy.flush_bytes = 4096;
+    assert(log_set_flush_policy(&policy) == 0);
+    for (int i = 0; i < 40; i++) {
+        LOG_INFO(LOG_MODULE_CORE, "flush-bytes %d", i);
+    }
+    int flushed = count_lines_containing(TEST_LOG_FILE, "flush-bytes");
+    assert(flushed > 0 && flushed < 40);
+
+    // 异步模式下 log_flush 先等待后台写线程
+    policy.flush_bytes = 32 * 1024;
+    policy.flush_interval_ms = 50;
+    assert(log_set_flush_policy(&policy) == 0);
+    assert(log_enable_async(NULL) == 0);
+    for (int i = 0; i < 100; i++) {
+        LOG_INFO(LOG_MODULE_CORE, "flush-async %d", i);
+    }
+    assert(log_flush() == 0);
+    assert(count_lines_containing(TEST_LOG_FILE, "flush-async") == 100);
+
+    // 写线程空闲时按时间刷新
+    LOG_INFO(LOG_MODULE_CORE, "flush-interval");
+    int waited_ms = 0;
+    while (count_lines_containing(TEST_LOG_FILE, "flush-interval") == 0 && waited_ms < 2000) {
+        usleep(10000);
+        waited_ms += 10;
+    }
+    assert(count_lines_containing(TEST_LOG_FILE, "flush-interval") == 1);
+    assert(log_disable_async() == 0);
+
+    // log_deinit 写出剩余数据，恢复默认策略
+    LOG_INFO(LOG_MODULE_CORE, "flush-deinit");
+    log_deinit();
+    assert(count_lines_containing(TEST_LOG_FILE, "flush-deinit") == 1);
+    log_flush_policy_init(&policy);
+    log_init(TEST_LOG_FILE, LOG_LEVEL_INFO);
+    assert(log_set_flush_policy(&policy) == 0);
+    log_deinit();
+
+    printf("测试通过!\n");
+}
+
+// 读取文件中第一行包含指定字符串的内容
+static int read_line_containing(const char *filename, const char *needle, char *line, size_t size)
+{
+    FILE *fp = fopen(filename, "r");
+    if (!fp) {
+        return -1;
+    }
+    int found = -1;
+    while (fgets(line, (int)size, fp)) {
+        if (strstr(line, needle)) {
+            found = 0;
+            break;
+        }
+    }
+    fclose(fp);
+    return found;
+}
+
+// 测试缓存的时间戳前缀：更换格式后立即生效，毫秒数每行单独填写
+void test_log_time_format(void)
+{
+    printf("测试时间戳格式...\n");
+
+    unlink(TEST_LOG_FILE);
+    log_init(TEST_LOG_FILE, LOG_LEVEL_INFO);
+    for (int i = 0; i < LOG_MODULE_MAX; i++) {
+        log_set_module_output((log_module_t)i, false, true);
+    }
+
+    log_format_options_t options;
+    log_get_format_options(&options);
+    options.show_time = true;
+    strcpy(options.time_format, "%H:%M:%S");
+    log_set_format_options(&options);
+    LOG_INFO(LOG_MODULE_CORE, "time-short");
+
+    // 同一秒内更换格式，缓存的前缀必须失效
+    strcpy(options.time_format, "%Y/%m/%d %H:%M:%S");
+    log_set_format_options(&options);
+    LOG_INFO(LOG_MODULE_CORE, "time-long");
+    log_deinit();
+
+    char line[512];
+    assert(read_line_containing(TEST_LOG_FILE, "time-short", line, sizeof(line)) == 0);
+    // [HH:MM:SS.mmm]
+    assert(line[0] == '[' && line[3] == ':' && line[6] == ':' && line[9] == '.' && line[13] == ']');
+    for (int i = 10; i < 13; i++) {
+        assert(line[i] >= '0' && line[i] <= '9');
+    }
+
+    assert(read_line_containing(TEST_LOG_FILE, "time-long", line, sizeof(line)) == 0);
+    // [YYYY/mm/dd HH:MM:SS.mmm]，年份与 localtime_r 一致
+    time_t now = time(NULL);
+    struct tm tm_now;
+    localtime_r(&now, &tm_now);
+    char year[16];
+    snprintf(year, sizeof(year), "[%04d/", tm_now.tm_year + 1900);
+    assert(strncmp(line, year, 6) == 0);
+    assert(line[8] == '/' && line[20] == '.' && line[24] == ']');
+
+    printf("测试通过!\n");
+}
+
+// 测试二进制日志文件路径
+#define TEST_BIN_FILE "log_unit_test.bin"
+
+// 把二进制日志解码到临时文件，返回解码的记录条数
+static int decode_binary(const char *path, const log_format_options_t *options, FILE **decoded)
+{
+    *decoded = tmpfile();
+    assert(*decoded);
+    int count = log_binary_decode(path, *decoded, options);
+    rewind(*decoded);
+    return count;
+}
+
+// 测试二进制日志：编码、解码后的版式、文本回退和轮转
+void test_log_binary(void)
+{
+    printf("测试二进制日志...\n");
+
+    unlink(TEST_LOG_FILE);
+    unlink(TEST_BIN_FILE);
+    for (int i = 1; i <= 3; i++) {
+        char path[64];
+        snprintf(path, sizeof(path), TEST_BIN_FILE ".%d", i);
+        unlink(path);
+    }
+    log_init(TEST_LOG_FILE, LOG_LEVEL_INFO);
+    for (int i = 0; i < LOG_MODULE_MAX; i++) {
+        log_set_module_output((log_module_t)i, false, true);
+    }
+    assert(log_binary_open(TEST_BIN_FILE) == 0);
+    assert(log_binary_open(TEST_BIN_FILE) == -2);
+    log_set_module_binary(LOG_MODULE_CORE, true);
+
+    // 覆盖各种参数类型、修饰符和 '*'
+    const char *name = "payload";
+    long long big = -1234567890123LL;
+    size_t size = 4096;
+    unsigned char small = 200;
+    int bin_line = __LINE__ + 1;
+    LOG_BIN_INFO(LOG_MODULE_CORE, "bin-msg %d %5s|%-4c|%.3f %llu %zx %hhu %*d %.*s %e %% %p %lld", -42, name, 'z',
+                 3.14159, 18446744073709551615ULL, size, small, 6, 99, 3, "abcdef", 1.5e-7, (void *)&big, big);
+    char expected[512];
+    snprintf(expected, sizeof(expected), "bin-msg %d %5s|%-4c|%.3f %llu %zx %hhu %*d %.*s %e %% %p %lld", -42, name,
+             'z', 3.14159, 18446744073709551615ULL, size, small, 6, 99, 3, "abcdef", 1.5e-7, (void *)&big, big);
+
+    // 带精度的 %s 只读取精度指定的字节数，缓冲区可以不以 '\0' 结尾
+    char *unterminated = (char *)malloc(4);
+    assert(unterminated != NULL);
+    memcpy(unterminated, "wxyz", 4);
+    int prec_line = __LINE__ + 1;
+    LOG_BIN_INFO(LOG_MODULE_CORE, "bin-prec %.*s|%.2s|%-6.3s|", 4, unterminated, unterminated, unterminated);
+    free(unterminated);
+
+    // 未启用二进制输出的模块和不支持的格式字符串按文本输出
+    LOG_BIN_INFO(LOG_MODULE_THREAD, "bin-text-module %d", 7);
+    LOG_BIN_INFO(LOG_MODULE_CORE, "bin-text-unsupported %ls", L"wide");
+    assert(log_binary_close() == 0);
+    assert(log_binary_close() == -1);
+
+    // 文件关闭后 LOG_BIN_* 也按文本输出
+    LOG_BIN_INFO(LOG_MODULE_CORE, "bin-text-closed %s", "after");
+    log_deinit();
+
+    assert(count_lines_containing(TEST_LOG_FILE, "bin-msg") == 0);
+    assert(count_lines_containing(TEST_LOG_FILE, "bin-text-module 7") == 1);
+    assert(count_lines_containing(TEST_LOG_FILE, "bin-text-unsupported wide") == 1);
+    assert(count_lines_containing(TEST_LOG_FILE, "bin-text-closed after") == 1);
+
+    // 不显示时间时，解码结果与 log_write 写入文件的行逐字节相同
+    log_format_options_t options = {.show_time = false,
+                                    .show_tid = true,
+                                    .show_module = true,
+                                    .show_file_line = true,
+                                    .show_function = true,
+                                    .time_format = "%Y-%m-%d %H:%M:%S"};
+    FILE *decoded;
+    assert(decode_binary(TEST_BIN_FILE, &options, &decoded) == 2);
+    char line[1024];
+    char want[1024];
+    assert(fgets(line, sizeof(line), decoded));
+    snprintf(want, sizeof(want), "[INFO] [TID:%ld] [CORE] [log_unit_test.c:%d] [test_log_binary] %s\n",
+             (long)syscall(SYS_gettid), bin_line, expected);
+    assert(strcmp(line, want) == 0);
+    assert(fgets(line, sizeof(line), decoded));
+    snprintf(want, sizeof(want), "[INFO] [TID:%ld] [CORE] [log_unit_test.c:%d] [test_log_binary] %s\n",
+             (long)syscall(SYS_gettid), prec_line, "bin-prec wxyz|wx|wxy   |");
+    assert(strcmp(line, want) == 0);
+    fclose(decoded);
+
+    // 默认选项带时间戳
+    assert(decode_binary(TEST_BIN_FILE, NULL, &decoded) == 2);
+    assert(fgets(line, sizeof(line), decoded));
+    assert(line[0] == '[' && line[5] == '-' && line[24] == ']' && strstr(line, expected));
+    fclose(decoded);
+
+    // 按文本日志的轮转配置轮转，每个备份都有文件头和描述，可以单独解码
+    log_init(TEST_LOG_FILE, LOG_LEVEL_INFO);
+    for (int i = 0; i < LOG_MODULE_MAX; i++) {
+        log_set_module_output((log_module_t)i, false, false);
+    }
+    log_rotation_config_t rotation = {.max_file_size = 4096,
+                                      .max_file_count = 3,
+                                      .rotate_on_size = true,
+                                      .rotate_on_time = false,
+                                      .rotate_interval_hours = 24};
+    log_set_rotation_config(&rotation);
+    assert(log_binary_open(TEST_BIN_FILE) == 0);
+    log_set_module_binary(LOG_MODULE_CORE, true);
+    for (int i = 0; i < 1000; i++) {
+        LOG_BIN_INFO(LOG_MODULE_CORE, "bin-rotate %d %s", i, "0123456789abcdef");
+    }
+    log_deinit();
+
+    assert(file_exists(TEST_BIN_FILE ".1"));
+    assert(file_exists(TEST_BIN_FILE ".2"));
+    assert(!file_exists(TEST_BIN_FILE ".3"));
+    int total = 0;
+    const char *paths[] = {TEST_BIN_FILE ".2", TEST_BIN_FILE ".1", TEST_BIN_FILE};
+    for (int i = 0; i < 3; i++) {
+        int count = decode_binary(paths[i], &options, &decoded);
+        assert(count > 0);
+        total += count;
+        fclose(decoded);
+    }
+    assert(total < 1000);
+    assert(decode_binary(TEST_BIN_FILE ".1", &options, &decoded) > 0);
+    assert(fgets(line, sizeof(line), decoded) && strstr(line, "bin-rotate ") && strstr(line, " 0123456789abcdef\n"));
+    fclose(decoded);
+
+    log_rotation_config_t defaults = {.max_file_size = 10 * 1024 * 1024,
+                                      .max_file_count = 5,
+                                      .rotate_on_size = true,
+                                      .rotate_on_time = false,
+                                      .rotate_interval_hours = 24};
+    log_set_rotation_config(&defaults);
+    assert(log_binary_decode("log_unit_test.missing", stdout, NULL) == -1);
+
+    printf("测试通过!\n");
+}
+
+#define TEST_SINK_FILE "log_unit_test_thread.log"
+
+// 向不同模块并发写日志
+static void *module_sink_writer(void *arg)
+{
+    log_module_t module = *(log_module_t *)arg;
+    for (int i = 0; i < 500; i++) {
+        LOG_INFO(module, "sink-msg module=%d seq=%d", (int)module, i);
+    }
+    return NULL;
+}
+
+// 测试模块专用日志文件
+void test_log_module_sink(void)
+{
+    printf("测试模块专用日志文件...\n");
+
+    char path[64];
+    for (int i = 0; i <= 2; i++) {
+        snprintf(path, sizeof(path), i == 0 ? TEST_SINK_FILE : TEST_SINK_FILE ".%d", i);
+        unlink(path);
+    }
+    unlink(TEST_LOG_FILE);
+
+    // 未初始化时不能挂接
+    assert(log_attach_module_sink(LOG_MODULE_THREAD, TEST_SINK_FILE) == -1);
+
+    log_init(TEST_LOG_FILE, LOG_LEVEL_INFO);
+    for (int i = 0; i < LOG_MODULE_MAX; i++) {
+        log_set_module_output((log_module_t)i, false, true);
+    }
+    assert(log_attach_module_sink(LOG_MODULE_MAX, TEST_SINK_FILE) == -1);
+    assert(log_attach_module_sink(LOG_MODULE_THREAD, NULL) == -1);
+    assert(log_attach_module_sink(LOG_MODULE_THREAD, "/nonexistent-dir/sink.log") == -3);
+    assert(log_detach_module_sink(LOG_MODULE_THREAD) == -2);
+    assert(log_attach_module_sink(LOG_MODULE_THREAD, TEST_SINK_FILE) == 0);
+    assert(log_attach_module_sink(LOG_MODULE_THREAD, TEST_SINK_FILE) == -2);
+
+    // 同步模式：不同模块并发写入各自的文件
+    log_module_t modules[2] = {LOG_MODULE_CORE, LOG_MODULE_THREAD};
+    pthread_t threads[2];
+    for (int i = 0; i < 2; i++) {
+        pthread_create(&threads[i], NULL, module_sink_writer, &modules[i]);
+    }
+    for (int i = 0; i < 2; i++) {
+        pthread_join(threads[i], NULL);
+    }
+    assert(log_flush() == 0);
+    assert(count_lines_containing(TEST_LOG_FILE, "sink-msg module=0 ") == 500);
+    assert(count_lines_containing(TEST_LOG_FILE, "[THREAD]") == 0);
+    assert(count_lines_containing(TEST_SINK_FILE, "sink-msg module=1 ") == 500);
+    assert(count_lines_containing(TEST_SINK_FILE, "[CORE]") == 0);
+
+    // 异步模式：写线程按记录所属的模块切换文件
+    assert(log_enable_async(NULL) == 0);
+    for (int i = 0; i < 100; i++) {
+        LOG_INFO(LOG_MODULE_CORE, "sink-async core %d", i);
+        LOG_INFO(LOG_MODULE_THREAD, "sink-async thread %d", i);
+    }
+    assert(log_flush() == 0);
+    assert(count_lines_containing(TEST_LOG_FILE, "sink-async core ") == 100);
+    assert(count_lines_containing(TEST_SINK_FILE, "sink-async thread ") == 100);
+    assert(log_disable_async() == 0);
+
+    // 专用文件有自己的备份链，按全局轮转配置轮转
+    log_rotation_config_t config = {.max_file_size = 1024,
+                                    .max_file_count = 2,
+                                    .rotate_on_size = true,
+                                    .rotate_on_time = false,
+                                    .rotate_interval_hours = 24};
+    log_set_rotation_config(&config);
+    for (int i = 0; i < 50; i++) {
+        LOG_INFO(LOG_MODULE_THREAD, "sink-rotate line %d", i);
+    }
+
+    // 撤销后该模块的日志回到默认文件
+    assert(log_detach_module_sink(LOG_MODULE_THREAD) == 0);
+    assert(file_exists(TEST_SINK_FILE ".1"));
+    assert(!file_exists(TEST_SINK_FILE ".2"));
+    LOG_INFO(LOG_MODULE_THREAD, "sink-detached");
+    assert(log_flush() == 0);
+    assert(count_lines_containing(TEST_LOG_FILE, "sink-detached") == 1);
+
+    // log_deinit 自动撤销专用文件
+    config.max_file_size = 10 * 1024 * 1024;
+    config.max_file_count = 5;
+    log_set_rotation_config(&config);
+    assert(log_attach_module_sink(LOG_MODULE_THREAD, TEST_SINK_FILE) == 0);
+    LOG_INFO(LOG_MODULE_THREAD, "sink-deinit");
+    log_deinit();
+    assert(count_lines_containing(TEST_SINK_FILE, "sink-deinit") == 1);
+
+    printf("测试通过!\n");
+}
+
+// 没有设置上下文的线程写一条日志
+static void *context_free_thread(void *arg)
+{
+    (void)arg;
+    log_context_t context = log_get_thread_context();
+    assert(context.context_id == NULL && context.session_id == NULL);
+    LOG_INFO(LOG_MODULE_CORE, "ctx-other-thread");
+    return NULL;
+}
+
+// 测试线程本地上下文和显式上下文
+void test_log_context(void)
+{
+    printf("测试日志上下文...\n");
+
+    unlink(TEST_LOG_FILE);
+    log_init(TEST_LOG_FILE, LOG_LEVEL_INFO);
+    for (int i = 0; i < LOG_MODULE_MAX; i++) {
+        log_set_module_output((log_module_t)i, false, true);
+    }
+
+    // 字段被复制到线程本地缓冲区，原字符串可以立即修改
+    char session[16];
+    strcpy(session, "S1");
+    log_context_t context = {.context_id = "C1", .session_id = session, .user_id = NULL, .transaction_id = "T1"};
+    log_set_context(&context);
+    strcpy(session, "changed");
+    LOG_INFO(LOG_MODULE_CORE, "ctx-tls");
+
+    log_context_t current = log_get_thread_context();
+    assert(strcmp(current.context_id, "C1") == 0);
+    assert(strcmp(current.session_id, "S1") == 0);
+    assert(current.user_id == NULL);
+    assert(strcmp(current.transaction_id, "T1") == 0);
+
+    // 再次设置替换全部字段
+    log_context_t replaced = {.context_id = NULL, .session_id = NULL, .user_id = "U2", .transaction_id = NULL};
+    log_set_context(&replaced);
+    LOG_INFO(LOG_MODULE_CORE, "ctx-replaced");
+
+    // 显式上下文只用于这一条日志，不修改线程本地的上下文
+    log_context_t request = {.context_id = "REQ", .session_id = NULL, .user_id = NULL, .transaction_id = "TX9"};
+    log_write_with_context(LOG_LEVEL_INFO, LOG_MODULE_CORE, &request, __FILE__, __LINE__, __func__,
+                           "ctx-explicit %d", 42);
+    current = log_get_thread_context();
+    assert(current.context_id == NULL && strcmp(current.user_id, "U2") == 0);
+    log_write_with_context(LOG_LEVEL_INFO, LOG_MODULE_CORE, NULL, __FILE__, __LINE__, __func__, "ctx-null");
+    log_write_with_context(LOG_LEVEL_DEBUG, LOG_MODULE_CORE, &request, __FILE__, __LINE__, __func__,
+                           "ctx-filtered");
+
+    // 过长的字段被截断
+    char long_id[LOG_CONTEXT_FIELD_MAX * 2];
+    memset(long_id, 'x', sizeof(long_id) - 1);
+    long_id[sizeof(long_id) - 1] = '\0';
+    log_context_t long_context = {.context_id = long_id, .session_id = NULL, .user_id = NULL,
+                                  .transaction_id = NULL};
+    log_set_context(&long_context);
+    assert(strlen(log_get_thread_context().context_id) == LOG_CONTEXT_FIELD_MAX - 1);
+    LOG_INFO(LOG_MODULE_CORE, "ctx-long");
+
+    // 其他线程的上下文互不影响
+    pthread_t thread;
+    pthread_create(&thread, NULL, context_free_thread, NULL);
+    pthread_join(thread, NULL);
+
+    // 异步模式下显式上下文在调用线程中渲染
+    assert(log_enable_async(NULL) == 0);
+    log_write_with_context(LOG_LEVEL_INFO, LOG_MODULE_CORE, &request, __FILE__, __LINE__, __func__, "ctx-async");
+    assert(log_disable_async() == 0);
+
+    log_clear_context();
+    current = log_get_thread_context();
+    assert(current.context_id == NULL && current.user_id == NULL);
+    LOG_INFO(LOG_MODULE_CORE, "ctx-cleared");
+    log_deinit();
+
+    char line[1024];
+    assert(read_line_containing(TEST_LOG_FILE, "ctx-tls", line, sizeof(line)) == 0);
+    assert(strstr(line, "[CTX:C1] [SID:S1] [TXN:T1] ctx-tls"));
+    assert(read_line_containing(TEST_LOG_FILE, "ctx-replaced", line, sizeof(line)) == 0);
+    assert(strstr(line, "] [UID:U2] ctx-replaced") && !strstr(line, "CTX:"));
+    assert(read_line_containing(TEST_LOG_FILE, "ctx-explicit", line, sizeof(line)) == 0);
+    assert(strstr(line, "[CTX:REQ] [TXN:TX9] ctx-explicit 42") && !strstr(line, "UID:"));
+    assert(read_line_containing(TEST_LOG_FILE, "ctx-null", line, sizeof(line)) == 0);
+    assert(strstr(line, "[UID:U2] ctx-null"));
+    assert(count_lines_containing(TEST_LOG_FILE, "ctx-filtered") == 0);
+    assert(read_line_containing(TEST_LOG_FILE, "ctx-long", line, sizeof(line)) == 0);
+    long_id[LOG_CONTEXT_FIELD_MAX - 1] = '\0';
+    assert(strstr(line, long_id) && strstr(line, "x] ctx-long"));
+    assert(read_line_containing(TEST_LOG_FILE, "ctx-other-thread", line, sizeof(line)) == 0);
+    assert(!strstr(line, "[CTX:"));
+    assert(read_line_containing(TEST_LOG_FILE, "ctx-async", line, sizeof(line)) == 0);
+    assert(strstr(line, "[CTX:REQ] [TXN:TX9] ctx-async"));
+    assert(read_line_containing(TEST_LOG_FILE, "ctx-cleared", line, sizeof(line)) == 0);
+    assert(!strstr(line, "[CTX:") && !strstr(line, "[UID:"));
+
+    printf("测试通过!\n");
+}
+
+// 多个线程同时经过同一个 LOG_FIRST_N 调用点
+static void *first_n_thread(void *arg)
+{
+    (void)arg;
+    for (int i = 0; i < 1000; i++) {
+        LOG_FIRST_N(LOG_LEVEL_INFO, LOG_MODULE_CORE, 10, "rl-first-mt %d", i);
+    }
+    return NULL;
+}
+
+// 同一个 LOG_RATELIMITED 调用点连续调用 100 次：每秒 10 个令牌，最多积累 5 个
+static void ratelimited_burst(const char *tag)
+{
+    for (int i = 0; i < 100; i++) {
+        LOG_RATELIMITED(LOG_LEVEL_WARN, LOG_MODULE_CORE, 10, 5, "rl-bucket %s %d", tag, i);
+    }
+}
+
+// 测试采样、限流和重复日志折叠
+void test_log_ratelimit(void)
+{
+    printf("测试采样、限流和重复日志折叠...\n");
+
+    unlink(TEST_LOG_FILE);
+    log_init(TEST_LOG_FILE, LOG_LEVEL_INFO);
+    for (int i = 0; i < LOG_MODULE_MAX; i++) {
+        log_set_module_output((log_module_t)i, false, true);
+    }
+    log_suppress_stats_t stats;
+    log_get_suppress_stats(&stats);
+    assert(stats.sampled == 0 && stats.rate_limited == 0 && stats.deduplicated == 0);
+
+    // 跳过的调用不求值参数，级别未启用时不更新调用点状态
+    int evaluated = 0;
+    for (int i = 0; i < 100; i++) {
+        LOG_EVERY_N(LOG_LEVEL_INFO, LOG_MODULE_CORE, 10, "rl-every-n %d", (evaluated++, i));
+        LOG_FIRST_N(LOG_LEVEL_INFO, LOG_MODULE_CORE, 3, "rl-first-n %d", i);
+        LOG_EVERY_N(LOG_LEVEL_DEBUG, LOG_MODULE_CORE, 10, "rl-debug %d", i);
+    }
+    assert(evaluated == 10);
+    log_get_suppress_stats(&stats);
+    assert(stats.sampled == 90 + 97);
+
+    pthread_t threads[4];
+    for (int i = 0; i < 4; i++) {
+        pthread_create(&threads[i], NULL, first_n_thread, NULL);
+    }
+    for (int i = 0; i < 4; i++) {
+        pthread_join(threads[i], NULL);
+    }
+
+    // 同一个调用点在 50ms 内只写出一次
+    for (int i = 0; i < 3; i++) {
+        for (int j = 0; j < 20; j++) {
+            LOG_EVERY_MS(LOG_LEVEL_INFO, LOG_MODULE_CORE, 50, "rl-every-ms %d", i);
+        }
+        usleep(60 * 1000);
+    }
+
+    // 令牌桶：先写出 burst 条，之后按速率补充
+    ratelimited_burst("first");
+    usleep(250 * 1000);
+    ratelimited_burst("refill");
+    log_get_suppress_stats(&stats);
+    assert(stats.rate_limited >= 200 - 5 - 3 && stats.rate_limited <= 200 - 5 - 2);
+
+    // 重复日志折叠
+    assert(log_set_dedup(true, -1) == -1);
+    assert(log_set_dedup(true, 0) == 0);
+    for (int i = 0; i < 50; i++) {
+        LOG_ERROR(LOG_MODULE_CORE, "rl-dup sensor timeout");
+    }
+    LOG_ERROR(LOG_MODULE_CORE, "rl-dup different");
+    for (int i = 0; i < 3; i++) {
+        LOG_ERROR(LOG_MODULE_CORE, "rl-dup tail");
+    }
+    assert(log_flush() == 0);
+    log_get_suppress_stats(&stats);
+    assert(stats.deduplicated == 49 + 2);
+    assert(stats.repeat_reports == 2);
+
+    // 超出折叠窗口的重复日志重新输出
+    assert(log_set_dedup(true, 30) == 0);
+    for (int i = 0; i < 3; i++) {
+        if (i == 2) {
+            usleep(40 * 1000);
+        }
+        LOG_WARN(LOG_MODULE_CORE, "rl-window");
+    }
+    assert(log_set_dedup(false, 0) == 0);
+    LOG_WARN(LOG_MODULE_CORE, "rl-window");
+    log_deinit();
+
+    assert(count_lines_containing(TEST_LOG_FILE, "rl-every-n ") == 10);
+    assert(count_lines_containing(TEST_LOG_FILE, "rl-every-n 90") == 1);
+    assert(count_lines_containing(TEST_LOG_FILE, "rl-first-n ") == 3);
+    assert(count_lines_containing(TEST_LOG_FILE, "rl-debug") == 0);
+    assert(count_lines_containing(TEST_LOG_FILE, "rl-first-mt ") == 10);
+    assert(count_lines_containing(TEST_LOG_FILE, "rl-every-ms ") == 3);
+    assert(count_lines_containing(TEST_LOG_FILE, "rl-bucket first ") == 5);
+    int refilled = count_lines_containing(TEST_LOG_FILE, "rl-bucket refill ");
+    assert(refilled >= 2 && refilled <= 3);
+
+    char line[1024];
+    assert(count_lines_containing(TEST_LOG_FILE, "rl-dup sensor timeout") == 1);
+    assert(read_line_containing(TEST_LOG_FILE, "last message repeated 49 times", line, sizeof(line)) == 0);
+    assert(strstr(line, "[ERROR]") && strstr(line, "[CORE]"));
+    assert(count_lines_containing(TEST_LOG_FILE, "rl-dup different") == 1);
+    assert(count_lines_containing(TEST_LOG_FILE, "rl-dup tail") == 1);
+    assert(count_lines_containing(TEST_LOG_FILE, "last message repeated 2 times") == 1);
+    assert(count_lines_containing(TEST_LOG_FILE, "rl-window") == 3);
+    assert(count_lines_containing(TEST_LOG_FILE, "last message repeated 1 times") == 1);
+
+    printf("测试通过!\n");
+}
+
+// 慢回调测试：收到 "cb-block" 时阻塞到 slow_callback_release 被置位
+static int slow_callback_entered = 0;
+static int slow_callback_release = 0;
+static int slow_callback_calls = 0;
+static int slow_unregister_done = 0;
+
+static void slow_test_callback(log_level_t level, log_module_t module, const char *file, int line,
+                               const char *func, const char *message, void *user_data)
+{
+    (void)level;
+    (void)module;
+    (void)file;
+    (void)line;
+    (void)func;
+    (void)user_data;
+    __atomic_add_fetch(&slow_callback_calls, 1, __ATOMIC_SEQ_CST);
+    if (strstr(message, "cb-block")) {
+        __atomic_store_n(&slow_callback_entered, 1, __ATOMIC_SEQ_CST);
+        while (!__atomic_load_n(&slow_callback_release, __ATOMIC_SEQ_CST)) {
+            usleep(1000);
+        }
+    }
+}
+
+static void *slow_callback_writer(void *arg)
+{
+    (void)arg;
+    LOG_INFO(LOG_MODULE_CORE, "cb-block");
+    return NULL;
+}
+
+static void *slow_callback_unregister(void *arg)
+{
+    (void)arg;
+    assert(log_unregister_callback(slow_test_callback) == 0);
+    __atomic_store_n(&slow_unregister_done, 1, __ATOMIC_SEQ_CST);
+    return NULL;
+}
+
+// 测试回调函数在锁之外调用
+void test_log_callback_offlock(void)
+{
+    printf("测试回调函数在锁之外调用...\n");
+
+    unlink(TEST_LOG_FILE);
+    log_init(TEST_LOG_FILE, LOG_LEVEL_INFO);
+    for (int i = 0; i < LOG_MODULE_MAX; i++) {
+        log_set_module_output((log_module_t)i, false, true);
+    }
+    assert(log_register_callback(slow_test_callback, NULL) == 0);
+
+    // 一个线程阻塞在回调中时，其他线程仍然可以写日志和刷新
+    pthread_t writer, unregister;
+    pthread_create(&writer, NULL, slow_callback_writer, NULL);
+    while (!__atomic_load_n(&slow_callback_entered, __ATOMIC_SEQ_CST)) {
+        usleep(1000);
+    }
+    LOG_INFO(LOG_MODULE_CORE, "cb-main");
+    assert(log_flush() == 0);
+    assert(count_lines_containing(TEST_LOG_FILE, "cb-main") == 1);
+    assert(__atomic_load_n(&slow_callback_calls, __ATOMIC_SEQ_CST) == 2);
+
+    // 注销等待正在执行的回调返回
+    pthread_create(&unregister, NULL, slow_callback_unregister, NULL);
+    usleep(50 * 1000);
+    assert(!__atomic_load_n(&slow_unregister_done, __ATOMIC_SEQ_CST));
+    LOG_INFO(LOG_MODULE_CORE, "cb-during-unregister");
+    __atomic_store_n(&slow_callback_release, 1, __ATOMIC_SEQ_CST);
+    pthread_join(writer, NULL);
+    pthread_join(unregister, NULL);
+    assert(__atomic_load_n(&slow_unregister_done, __ATOMIC_SEQ_CST));
+
+    int calls = __atomic_load_n(&slow_callback_calls, __ATOMIC_SEQ_CST);
+    LOG_INFO(LOG_MODULE_CORE, "cb-after-unregister");
+    assert(__atomic_load_n(&slow_callback_calls, __ATOMIC_SEQ_CST) == calls);
+    assert(log_unregister_callback(slow_test_callback) == -2);
+    log_deinit();
+
+    printf("测试通过!\n");
+}
+
 // 主函数
 int main(void)
 {
@@ -194,6 +1187,16 @@ int main(void)
     test_log_callback_func();
     test_log_format_options();
     test_log_rotation();
+    test_log_async();
+    test_log_level_fast();
+    test_log_rotation_chain();
+    test_log_flush_policy();
+    test_log_time_format();
+    test_log_binary();
+    test_log_module_sink();
+    test_log_context();
+    test_log_ratelimit();
+    test_log_callback_offlock();
 
     printf("\n所有测试通过!\n");
     return 0;
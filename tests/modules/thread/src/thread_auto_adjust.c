@@ -32,6 +32,15 @@ static test_state_t g_test_state;
 // 使用volatile sig_atomic_t类型来确保在信号处理函数中的原子操作
 static volatile sig_atomic_t g_timeout_exit_flag = 0;
 
+// 销毁测试线程池，并清除全局状态中的引用，避免后续清理逻辑重复销毁已释放的线程池
+static void destroy_test_pool(thread_pool_t pool)
+{
+    if (g_test_state.pool == pool) {
+        g_test_state.pool = NULL;
+    }
+    thread_pool_destroy(pool);
+}
+
 // 随机数生成函数 - 使用getrandom获取更好的随机性
 static int get_random_int(int min, int max) {
     unsigned int rand_value = 0; // 初始化为0
@@ -223,7 +232,8 @@ static void submit_tasks(thread_pool_t pool, int count, void (*task_func)(void *
             continue;
         }
         *arg = i;
-        if (thread_pool_add_task_default(pool, task_func, arg, "test_task") != 0) {
+        // 任务名称在线程池内必须唯一，使用 NULL 让线程池自动生成名称
+        if (thread_pool_add_task_default(pool, task_func, arg, NULL) == 0) {
             printf("添加任务失败\n");
             free(arg);
         }
@@ -254,7 +264,7 @@ static int test_increase_threads(void)
     // 初始状态验证
     if (!check_thread_pool_in_range(pool, 2, 8)) {
         printf("初始状态验证失败\n");
-        thread_pool_destroy(pool);
+        destroy_test_pool(pool);
         return 0;
     }
 
@@ -277,7 +287,7 @@ static int test_increase_threads(void)
         if (g_timeout_exit_flag || g_test_state.timeout_occurred) {
             printf("超时标志被设置，立即退出等待循环\n");
             thread_pool_disable_auto_adjust(pool);
-            thread_pool_destroy(pool);
+            destroy_test_pool(pool);
             return 0;
         }
         
@@ -300,7 +310,7 @@ static int test_increase_threads(void)
     int result = thread_increased;
     if (!result) {
         printf("测试失败: 线程数未如预期增加\n");
-        thread_pool_destroy(pool);
+        destroy_test_pool(pool);
         return 0;
     }
 
@@ -335,7 +345,7 @@ static int test_increase_threads(void)
 
     printf("测试1结束，正在清理资源...\n");
     thread_pool_disable_auto_adjust(pool);
-    thread_pool_destroy(pool);
+    destroy_test_pool(pool);
     return result;
 }
 
@@ -382,7 +392,7 @@ static int test_decrease_threads(void)
     printf("\033[1;34m验证初始线程池状态...\033[0m\n");
     if (!check_thread_pool_in_range(pool, 8, 8)) {
         printf("\033[1;31m初始状态验证失败\033[0m\n");
-        thread_pool_destroy(pool);
+        destroy_test_pool(pool);
         return 0;
     }
     printf("\033[1;32m初始状态验证成功\033[0m\n");
@@ -424,7 +434,7 @@ static int test_decrease_threads(void)
     // 验证线程数已减少
     int result = check_thread_pool_in_range(pool, min_threads, 8);
 
-    thread_pool_destroy(pool);
+    destroy_test_pool(pool);
     return result;
 }
 
@@ -444,7 +454,7 @@ static int test_disable_auto_adjust(void)
     thread_pool_stats_t init_stats;
     if (thread_pool_get_stats(pool, &init_stats) != 0) {
         printf("获取初始线程池状态失败\n");
-        thread_pool_destroy(pool);
+        destroy_test_pool(pool);
         return 0;
     }
     printf("初始线程池状态: 线程数=%d, 空闲=%d\n", 
@@ -545,7 +555,7 @@ static int test_disable_auto_adjust(void)
     }
 
     printf("测试3结束，开始清理资源...\n");
-    thread_pool_destroy(pool);
+    destroy_test_pool(pool);
     return result;
 }
 
@@ -565,7 +575,7 @@ static int test_thread_limits(void)
     thread_pool_stats_t init_stats;
     if (thread_pool_get_stats(pool, &init_stats) != 0) {
         printf("获取初始线程池状态失败\n");
-        thread_pool_destroy(pool);
+        destroy_test_pool(pool);
         return 0;
     }
     printf("初始线程池状态: 线程数=%d, 空闲=%d\n", 
@@ -609,7 +619,7 @@ static int test_thread_limits(void)
         if (g_timeout_exit_flag || g_test_state.timeout_occurred) {
             printf("超时标志被设置，立即退出等待循环\n");
             thread_pool_disable_auto_adjust(pool);
-            thread_pool_destroy(pool);
+            destroy_test_pool(pool);
             return 0;
         }
         
@@ -750,9 +760,91 @@ static int test_thread_limits(void)
     }
 
     printf("销毁线程池...\n");
-    thread_pool_destroy(pool);
+    destroy_test_pool(pool);
     return result;
 }
+// 速率策略测试使用的固定耗时任务
+static void burst_task(void *arg)
+{
+    (void)arg;
+    if (!g_timeout_exit_flag) {
+        usleep(5000);
+    }
+}
+
+// 测试5：验证速率策略在突发负载下一次扩容到位，负载消失后经过冷却再缩减
+static int test_rate_policy(void)
+{
+    printf("\n=== 测试5：验证速率自动调整策略 ===\n");
+
+    thread_pool_t pool = thread_pool_create(2);
+    if (pool == NULL) {
+        printf("创建线程池失败\n");
+        return 0;
+    }
+    g_test_state.pool = pool;
+    thread_pool_set_limits(pool, 2, 32);
+
+    thread_pool_adjust_config_t config;
+    thread_pool_adjust_config_init(&config);
+    config.policy = THREAD_POOL_ADJUST_RATE;
+    config.ewma_weight_percent = 0;
+    if (thread_pool_enable_auto_adjust_with_config(pool, &config) != -1) {
+        printf("无效的平滑权重未被拒绝\n");
+        destroy_test_pool(pool);
+        return 0;
+    }
+
+    config.ewma_weight_percent = 50;
+    config.adjust_interval = 200;
+    config.target_queue_wait_us = 20000;
+    config.cooldown_ms = 1000;
+    if (thread_pool_enable_auto_adjust_with_config(pool, &config) != 0) {
+        printf("启用速率策略失败\n");
+        destroy_test_pool(pool);
+        return 0;
+    }
+
+    // 400 个 5ms 的任务：2 个线程需要约 1 秒，按 20ms 的期望等待时间需要远多于 2 个线程
+    printf("提交 400 个 5ms 的突发任务...\n");
+    for (int i = 0; i < 400; i++) {
+        thread_pool_add_task_default(pool, burst_task, NULL, NULL);
+    }
+
+    // 逐个线程增加的策略在 1 秒 (5 个检查间隔) 内最多只能到 7 个线程
+    thread_pool_stats_t stats;
+    int peak_threads = 0;
+    for (int i = 0; i < 50 && !g_timeout_exit_flag; i++) {
+        usleep(20000);
+        if (thread_pool_get_stats(pool, &stats) == 0 && stats.thread_count > peak_threads) {
+            peak_threads = stats.thread_count;
+        }
+    }
+    printf("1 秒内的最大线程数: %d\n", peak_threads);
+    if (peak_threads < 8) {
+        printf("速率策略未能一次扩容到位\n");
+        destroy_test_pool(pool);
+        return 0;
+    }
+
+    // 任务完成后不再有到达，冷却期过后应直接缩减到最小线程数
+    int shrunk = 0;
+    for (int i = 0; i < 40 && !g_timeout_exit_flag; i++) {
+        usleep(100000);
+        if (thread_pool_get_stats(pool, &stats) == 0 && stats.task_queue_size == 0 && stats.thread_count == 2) {
+            shrunk = 1;
+            break;
+        }
+    }
+    printf("负载消失后的线程数: %d\n", stats.thread_count);
+
+    thread_pool_disable_auto_adjust(pool);
+    destroy_test_pool(pool);
+    if (!shrunk) {
+        printf("速率策略未能在负载消失后缩减线程\n");
+    }
+    return shrunk;
+}
 
 int main(void)
 {
@@ -777,7 +869,7 @@ int main(void)
     printf("\n开始测试线程池自动动态调整功能...\n");
 
     int passed = 0;
-    int total = 4;
+    int total = 5;
 
     // 运行测试 - 每个测试之间检查超时状态，如果超时则立即退出
     printf("\n运行测试1: 高负载时线程数增加...\n");
@@ -847,6 +939,18 @@ int main(void)
     } else {
         printf("测试4失败：线程数调整范围限制\n");
     }
+
+    g_test_state.timeout_occurred = 0;
+    g_timeout_exit_flag = 0;
+    set_test_timeout(15);
+
+    printf("\n运行测试5: 速率自动调整策略...\n");
+    if (test_rate_policy()) {
+        printf("测试5通过：速率自动调整策略\n");
+        passed++;
+    } else {
+        printf("测试5失败：速率自动调整策略\n");
+    }
     
     // 检查是否发生超时
     if (g_test_state.timeout_occurred) {
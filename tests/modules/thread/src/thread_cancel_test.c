@@ -112,7 +112,7 @@ void test_cancel_queued_tasks(void) {
     task_id_t task_ids[10];
     for (int i = 0; i < 10; i++) {
         task_nums[i] = i + 1;
-        task_ids[i] = thread_pool_add_task(pool, short_task, &task_nums[i], "测试任务", 0);
+        task_ids[i] = thread_pool_add_task(pool, short_task, &task_nums[i], NULL, 0);
         assert(task_ids[i] != 0);
         
         // 更新任务创建计数
@@ -185,7 +185,7 @@ void test_cancel_running_tasks(void) {
     task_id_t task_ids[2];
     for (int i = 0; i < 2; i++) {
         task_nums[i] = i + 1;
-        task_ids[i] = thread_pool_add_task(pool, long_task, &task_nums[i], "长时间任务", 0);
+        task_ids[i] = thread_pool_add_task(pool, long_task, &task_nums[i], NULL, 0);
         assert(task_ids[i] != 0);
         
         // 更新任务创建计数
@@ -270,7 +270,7 @@ void test_task_existence(void) {
     // 添加两个短任务（会在队列中等待）
     for (int i = 1; i < 3; i++) {
         task_nums[i] = i + 1;
-        task_ids[i] = thread_pool_add_task(pool, short_task, &task_nums[i], "短时间任务", 0);
+        task_ids[i] = thread_pool_add_task(pool, short_task, &task_nums[i], NULL, 0);
         assert(task_ids[i] != 0);
         g_stats.tasks_created++;
     }
@@ -400,6 +400,107 @@ void test_invalid_parameters(void) {
     printf("测试4通过！\n");
 }
 
+// 测试5使用的闸门：阻塞唯一的工作线程，使后续任务全部在队列中积压
+static volatile int g_gate_open = 0;
+
+void gate_task(void *arg) {
+    (void)arg;
+    while (!__sync_fetch_and_add(&g_gate_open, 0)) {
+        usleep(1000);
+    }
+}
+
+void bulk_task(void *arg) {
+    (void)arg;
+    pthread_mutex_lock(&g_stats.lock);
+    g_stats.tasks_completed++;
+    pthread_mutex_unlock(&g_stats.lock);
+}
+
+// 测试5：大量积压任务下按名称/ID 的查找、取消与名称复用
+void test_large_backlog_index(void) {
+    printf("\n=== 测试5：大量积压任务的索引查找与取消 ===\n");
+
+    init_test_stats();
+    g_gate_open = 0;
+
+    thread_pool_t pool = thread_pool_create(1);
+    assert(pool != NULL);
+
+    task_id_t gate_id = thread_pool_add_task(pool, gate_task, NULL, "gate", TASK_PRIORITY_HIGH);
+    assert(gate_id != 0);
+    usleep(50000); // 等待闸门任务开始执行
+
+    const int backlog = 5000;
+    task_id_t *ids = malloc(backlog * sizeof(task_id_t));
+    assert(ids != NULL);
+    char name[MAX_TASK_NAME_LEN];
+    for (int i = 0; i < backlog; i++) {
+        snprintf(name, sizeof(name), "bulk_%d", i);
+        ids[i] = thread_pool_add_task(pool, bulk_task, NULL, name, TASK_PRIORITY_NORMAL);
+        assert(ids[i] != 0);
+    }
+
+    // 排队中和运行中的任务名称都不能重复
+    task_id_t dup_id = thread_pool_add_task(pool, bulk_task, NULL, "bulk_10", TASK_PRIORITY_NORMAL);
+    assert(dup_id == 0);
+    dup_id = thread_pool_add_task(pool, bulk_task, NULL, "gate", TASK_PRIORITY_NORMAL);
+    assert(dup_id == 0);
+
+    int is_running = -1;
+    task_id_t found = thread_pool_find_task_by_name(pool, "bulk_4999", &is_running);
+    assert(found == ids[backlog - 1] && is_running == 0);
+    found = thread_pool_find_task_by_name(pool, "gate", &is_running);
+    assert(found == gate_id && is_running == 1);
+
+    // 按名称取消所有偶数任务
+    for (int i = 0; i < backlog; i += 2) {
+        snprintf(name, sizeof(name), "bulk_%d", i);
+        int result = thread_pool_cancel_task_by_name(pool, name, NULL);
+        assert(result == 0);
+    }
+    for (int i = 0; i < backlog; i++) {
+        int exists = thread_pool_task_exists(pool, ids[i], &is_running);
+        assert(exists == (i % 2));
+        (void)exists;
+    }
+    int result = thread_pool_cancel_task(pool, gate_id, NULL);
+    assert(result == -1); // 正在运行的任务无法取消
+
+    // 已取消任务的名称可以立即复用
+    task_id_t reused_id = thread_pool_add_task(pool, bulk_task, NULL, "bulk_0", TASK_PRIORITY_NORMAL);
+    assert(reused_id != 0);
+
+    __sync_fetch_and_add(&g_gate_open, 1);
+    int expected = backlog / 2 + 1;
+    for (int wait = 0; wait < 500; wait++) {
+        pthread_mutex_lock(&g_stats.lock);
+        int completed = g_stats.tasks_completed;
+        pthread_mutex_unlock(&g_stats.lock);
+        if (completed == expected) {
+            break;
+        }
+        usleep(10000);
+    }
+    printf("积压任务完成数: %d/%d\n", g_stats.tasks_completed, expected);
+    assert(g_stats.tasks_completed == expected);
+
+    // 已完成任务从索引中移除，名称可以再次使用
+    usleep(50000);
+    found = thread_pool_find_task_by_name(pool, "bulk_1", NULL);
+    assert(found == 0);
+    reused_id = thread_pool_add_task(pool, bulk_task, NULL, "bulk_1", TASK_PRIORITY_NORMAL);
+    assert(reused_id != 0);
+    (void)dup_id;
+    (void)result;
+
+    thread_pool_destroy(pool);
+    free(ids);
+    cleanup_test_stats();
+
+    printf("测试5通过！\n");
+}
+
 int main(void) {
     printf("=== 线程池任务取消功能测试 ===\n");
     
@@ -408,6 +509,7 @@ int main(void) {
     test_cancel_running_tasks();
     test_task_existence();
     test_invalid_parameters();
+    test_large_backlog_index();
     
     printf("\n所有测试通过！\n");
     return 0;
@@ -180,7 +180,7 @@ static void submit_tasks(thread_pool_t pool, int count, void (*task_func)(void *
         char task_name[32];
         snprintf(task_name, sizeof(task_name), "Task-%d", i + 1);
 
-        if (thread_pool_add_task_default(pool, task_func, task_id, task_name) != 0) {
+        if (thread_pool_add_task_default(pool, task_func, task_id, task_name) == 0) {
             printf("提交任务失败: %d/%d\n", i + 1, count);
             free(task_id);
             return;
@@ -252,7 +252,7 @@ static int test_pool_destroy(void)
     // 等待所有任务完成
     int wait_count = 0;
     const int max_wait = 50; // 最多等待5秒
-    while (g_test_state.tasks_completed < 5 && wait_count < max_wait) {
+    while (g_test_state.tasks_completed < task_count && wait_count < max_wait) {
         usleep(100000); // 100ms
         wait_count++;
 
@@ -260,17 +260,17 @@ static int test_pool_destroy(void)
         if (wait_count % 10 == 0) {
             thread_pool_stats_t stats;
             if (thread_pool_get_stats(pool, &stats) == 0) {
-                printf("等待任务完成: 已完成 %d/5, 线程数=%d, 空闲=%d, 队列大小=%d\n",
-                       g_test_state.tasks_completed, stats.thread_count, stats.idle_threads,
+                printf("等待任务完成: 已完成 %d/%d, 线程数=%d, 空闲=%d, 队列大小=%d\n",
+                       g_test_state.tasks_completed, task_count, stats.thread_count, stats.idle_threads,
                        stats.task_queue_size);
             }
         }
     }
 
     // 强制等待所有任务完成
-    while (g_test_state.tasks_completed < 5) {
+    while (g_test_state.tasks_completed < task_count) {
         usleep(100000); // 100ms
-        printf("等待所有任务完成: 已完成 %d/5\n", g_test_state.tasks_completed);
+        printf("等待所有任务完成: 已完成 %d/%d\n", g_test_state.tasks_completed, task_count);
     }
 
     printf("所有任务已完成\n");
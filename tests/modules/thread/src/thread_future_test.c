@@ -0,0 +1,188 @@
+/**
+ * @file thread_future_test.c
+ * @brief 线程池任务完成句柄 (future) 的单元测试
+ *
+ * 此测试程序验证任务完成句柄的等待、结果传递和取消语义。
+ * 测试包括：
+ * 1. 提交时返回句柄，阻塞等待并读取任务结果
+ * 2. 等待超时
+ * 3. wait_any / wait_all
+ * 4. 为已提交的任务登记句柄，取消后句柄进入取消状态
+ * 5. 参数错误处理
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <assert.h>
+#include <pthread.h>
+#include <thread.h>
+
+// 休眠指定毫秒数，并把参数本身作为结果
+void sleeping_task(void *arg) {
+    int sleep_ms = *((int *)arg);
+    usleep((useconds_t)sleep_ms * 1000);
+    int result = thread_pool_set_task_result(arg);
+    assert(result == 0);
+    (void)result;
+}
+
+// 阻塞单线程池的闸门任务
+static int g_gate_open = 0;
+
+void gate_task(void *arg) {
+    (void)arg;
+    while (!__sync_fetch_and_add(&g_gate_open, 0)) {
+        usleep(1000);
+    }
+}
+
+// 测试提交时返回句柄、等待并读取结果
+void test_wait_and_result(void) {
+    printf("\n--- 测试等待与结果 ---\n");
+    thread_pool_t pool = thread_pool_create(2);
+    assert(pool != NULL);
+
+    int sleep_ms = 50;
+    task_future_t future = thread_pool_add_task_with_future(pool, sleeping_task, &sleep_ms, "future_result",
+                                                            TASK_PRIORITY_NORMAL);
+    assert(future != NULL);
+    task_id_t task_id = task_future_get_task_id(future);
+    assert(task_id != 0);
+
+    int result = task_future_wait(future, -1);
+    assert(result == 0);
+    assert(task_future_get_state(future) == TASK_FUTURE_COMPLETED);
+    assert(task_future_get_result(future) == &sleep_ms);
+    // 句柄结束时任务已从线程池中移除
+    assert(thread_pool_task_exists(pool, task_id, NULL) == 0);
+    printf("任务结果已通过句柄返回\n");
+
+    // 结束后再次等待立即返回
+    result = task_future_wait(future, 0);
+    assert(result == 0);
+    task_future_release(future);
+
+    // 任务外部无法设置结果
+    result = thread_pool_set_task_result(NULL);
+    assert(result == -1);
+    (void)result;
+
+    thread_pool_destroy(pool);
+    printf("等待与结果测试通过\n");
+}
+
+// 测试超时、wait_any 和 wait_all
+void test_wait_any_all(void) {
+    printf("\n--- 测试 wait_any / wait_all ---\n");
+    thread_pool_t pool = thread_pool_create(3);
+    assert(pool != NULL);
+
+    int slow_ms = 400;
+    int fast_ms = 20;
+    int medium_ms = 100;
+    task_future_t futures[3];
+    futures[0] = thread_pool_add_task_with_future(pool, sleeping_task, &slow_ms, "future_slow", TASK_PRIORITY_NORMAL);
+    futures[1] = thread_pool_add_task_with_future(pool, sleeping_task, &fast_ms, "future_fast", TASK_PRIORITY_NORMAL);
+    futures[2] =
+        thread_pool_add_task_with_future(pool, sleeping_task, &medium_ms, "future_medium", TASK_PRIORITY_NORMAL);
+    assert(futures[0] != NULL && futures[1] != NULL && futures[2] != NULL);
+
+    int result = task_future_wait(futures[0], 10);
+    assert(result == -1);
+    assert(task_future_get_state(futures[0]) == TASK_FUTURE_PENDING);
+    printf("等待慢任务超时\n");
+
+    int index = task_future_wait_any(futures, 3, -1);
+    assert(index == 1);
+    printf("wait_any 返回最先完成的任务: %d\n", index);
+
+    result = task_future_wait_all(futures, 3, 10);
+    assert(result == -1);
+    result = task_future_wait_all(futures, 3, 5000);
+    assert(result == 0);
+    for (int i = 0; i < 3; i++) {
+        assert(task_future_get_state(futures[i]) == TASK_FUTURE_COMPLETED);
+        task_future_release(futures[i]);
+    }
+    (void)index;
+    (void)result;
+
+    thread_pool_destroy(pool);
+    printf("wait_any / wait_all 测试通过\n");
+}
+
+// 测试为已提交的任务登记句柄，以及取消和销毁时句柄的状态
+void test_registered_future_cancel(void) {
+    printf("\n--- 测试登记句柄与取消 ---\n");
+    thread_pool_t pool = thread_pool_create(1);
+    assert(pool != NULL);
+
+    __sync_lock_test_and_set(&g_gate_open, 0);
+    task_id_t gate_id = thread_pool_add_task(pool, gate_task, NULL, "future_gate", TASK_PRIORITY_HIGH);
+    assert(gate_id != 0);
+    int sleep_ms = 1;
+    task_id_t queued_id = thread_pool_add_task(pool, sleeping_task, &sleep_ms, "future_queued", TASK_PRIORITY_LOW);
+    task_id_t dropped_id = thread_pool_add_task(pool, sleeping_task, &sleep_ms, "future_kept", TASK_PRIORITY_LOW);
+    assert(queued_id != 0 && dropped_id != 0);
+
+    task_future_t future = thread_pool_get_task_future(pool, queued_id);
+    task_future_t same = thread_pool_get_task_future(pool, queued_id);
+    assert(future != NULL && future == same);
+    task_future_release(same);
+    assert(thread_pool_get_task_future(pool, 9999) == NULL);
+
+    int result = thread_pool_cancel_task(pool, queued_id, NULL);
+    assert(result == 0);
+    result = task_future_wait(future, 1000);
+    assert(result == 0);
+    assert(task_future_get_state(future) == TASK_FUTURE_CANCELLED);
+    assert(task_future_get_result(future) == NULL);
+    task_future_release(future);
+    printf("取消的任务句柄进入取消状态\n");
+
+    // 登记后正常执行的任务
+    task_future_t kept = thread_pool_get_task_future(pool, dropped_id);
+    assert(kept != NULL);
+    __sync_lock_test_and_set(&g_gate_open, 1);
+    result = task_future_wait(kept, 5000);
+    assert(result == 0);
+    assert(task_future_get_state(kept) == TASK_FUTURE_COMPLETED);
+    assert(task_future_get_result(kept) == &sleep_ms);
+    task_future_release(kept);
+    (void)result;
+
+    thread_pool_destroy(pool);
+    printf("登记句柄与取消测试通过\n");
+}
+
+// 测试无效参数
+void test_invalid_parameters(void) {
+    printf("\n--- 测试无效参数 ---\n");
+    assert(task_future_wait(NULL, 0) == -2);
+    assert(task_future_wait_all(NULL, 1, 0) == -2);
+    assert(task_future_wait_any(NULL, 1, 0) == -2);
+    task_future_t futures[1] = {NULL};
+    assert(task_future_wait_any(futures, 1, 0) == -2);
+    assert(task_future_get_state(NULL) == TASK_FUTURE_CANCELLED);
+    assert(task_future_get_result(NULL) == NULL);
+    assert(task_future_get_task_id(NULL) == 0);
+    assert(thread_pool_add_task_with_future(NULL, sleeping_task, NULL, NULL, TASK_PRIORITY_NORMAL) == NULL);
+    assert(thread_pool_get_task_future(NULL, 1) == NULL);
+    task_future_release(NULL);
+    (void)futures;
+    printf("无效参数测试通过\n");
+}
+
+int main(void) {
+    printf("=== 线程池任务完成句柄测试 ===\n");
+
+    test_wait_and_result();
+    test_wait_any_all();
+    test_registered_future_cancel();
+    test_invalid_parameters();
+
+    printf("\n所有测试通过！\n");
+    return 0;
+}
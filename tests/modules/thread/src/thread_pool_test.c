@@ -120,6 +120,12 @@ static int test_basic_functionality(void)
         fprintf(stderr, "创建线程池失败\n");
         return 1;
     }
+    // 默认上限为初始线程数的两倍，放宽到足以容纳后面最多增加 3 个线程的调整
+    if (thread_pool_set_limits(pool, 1, initial_threads + 3) != 0) {
+        fprintf(stderr, "设置线程池限制失败\n");
+        thread_pool_destroy(pool);
+        return 1;
+    }
     printf("线程池创建成功，初始启动 %d 个工作线程\n", initial_threads);
     fflush(stdout);
 
@@ -145,8 +151,8 @@ static int test_basic_functionality(void)
         // 使用随机概率决定任务类型，大约20%的概率是长任务
         void (*task_func)(void *) = (get_random_int(1, 100) <= 20) ? long_task : test_task;
         
-        int result = thread_pool_add_task_default(pool, task_func, arg, task_name);
-        if (result != 0) {
+        task_id_t new_task_id = thread_pool_add_task_default(pool, task_func, arg, task_name);
+        if (new_task_id == 0) {
             fprintf(stderr, "无法添加任务 %d\n", task_idx);
             free(arg);
             thread_pool_destroy(pool);
@@ -286,12 +292,12 @@ static int test_error_handling(void)
     fflush(stdout);
     
     // 测试无效的线程池指针
-    int result = thread_pool_add_task_default(NULL, test_task, NULL, "invalid-pool");
-    printf("测试向NULL线程池添加任务: %s\n", (result != 0) ? "测试通过" : "测试失败");
+    task_id_t invalid_task_id = thread_pool_add_task_default(NULL, test_task, NULL, "invalid-pool");
+    printf("测试向NULL线程池添加任务: %s\n", (invalid_task_id == 0) ? "测试通过" : "测试失败");
     fflush(stdout);
 
     // 测试销毁NULL线程池
-    result = thread_pool_destroy(NULL);
+    int result = thread_pool_destroy(NULL);
     printf("测试销毁NULL线程池: %s\n", (result != 0) ? "测试通过" : "测试失败");
     fflush(stdout);
 
@@ -49,6 +49,7 @@ static void signal_handler(int sig);
 static int test_basic_priority_ordering(void);
 static int test_mixed_priority_ordering(void);
 static int test_priority_preemption(void);
+static int test_same_level_fifo_ordering(void);
 
 // 生成随机数，使用安全的 getrandom() 函数
 static int get_random_int(int min, int max)
@@ -396,7 +397,7 @@ static int test_mixed_priority_ordering(void)
         char task_name[64];
         snprintf(task_name, sizeof(task_name), "低优先级任务#%d", task_args[i].id);
         
-        if (thread_pool_add_task(pool, priority_task, &task_args[i], task_name, task_args[i].priority) != 0) {
+        if (thread_pool_add_task(pool, priority_task, &task_args[i], task_name, task_args[i].priority) == 0) {
             fprintf(stderr, "添加任务#%d失败\n", task_args[i].id);
             thread_pool_destroy(pool);
             return 1;
@@ -415,7 +416,7 @@ static int test_mixed_priority_ordering(void)
         char task_name[64];
         snprintf(task_name, sizeof(task_name), "高优先级任务#%d", task_args[i].id);
         
-        if (thread_pool_add_task(pool, priority_task, &task_args[i], task_name, task_args[i].priority) != 0) {
+        if (thread_pool_add_task(pool, priority_task, &task_args[i], task_name, task_args[i].priority) == 0) {
             fprintf(stderr, "添加任务#%d失败\n", task_args[i].id);
             thread_pool_destroy(pool);
             return 1;
@@ -455,7 +456,7 @@ static int test_mixed_priority_ordering(void)
         char task_name[64];
         snprintf(task_name, sizeof(task_name), "%s优先级任务#%d", priority_str, task_args[i].id);
         
-        if (thread_pool_add_task(pool, priority_task, &task_args[i], task_name, task_args[i].priority) != 0) {
+        if (thread_pool_add_task(pool, priority_task, &task_args[i], task_name, task_args[i].priority) == 0) {
             fprintf(stderr, "添加任务#%d失败\n", task_args[i].id);
             thread_pool_destroy(pool);
             return 1;
@@ -572,6 +573,18 @@ int main(void)
         return result;
     }
 
+    // 运行同级别FIFO及自定义优先级测试
+    if (g_shutdown_requested) {
+        printf("收到退出请求，终止测试\n");
+        return 0;
+    }
+
+    result = test_same_level_fifo_ordering();
+    if (result != 0) {
+        fprintf(stderr, "同级别FIFO及自定义优先级测试失败\n");
+        return result;
+    }
+
     printf("\n====================================\n");
     printf("=== 所有任务优先级测试已全部通过 ===\n");
     printf("====================================\n");
@@ -625,7 +638,7 @@ static int test_basic_priority_ordering(void)
         char task_name[64];
         snprintf(task_name, sizeof(task_name), "后台任务#%d", task_args[i].id);
         
-        if (thread_pool_add_task(pool, priority_task, &task_args[i], task_name, task_args[i].priority) != 0) {
+        if (thread_pool_add_task(pool, priority_task, &task_args[i], task_name, task_args[i].priority) == 0) {
             fprintf(stderr, "添加任务#%d失败\n", task_args[i].id);
             thread_pool_destroy(pool);
             return 1;
@@ -640,7 +653,7 @@ static int test_basic_priority_ordering(void)
         char task_name[64];
         snprintf(task_name, sizeof(task_name), "低优先级任务#%d", task_args[i].id);
         
-        if (thread_pool_add_task(pool, priority_task, &task_args[i], task_name, task_args[i].priority) != 0) {
+        if (thread_pool_add_task(pool, priority_task, &task_args[i], task_name, task_args[i].priority) == 0) {
             fprintf(stderr, "添加任务#%d失败\n", task_args[i].id);
             thread_pool_destroy(pool);
             return 1;
@@ -655,7 +668,7 @@ static int test_basic_priority_ordering(void)
         char task_name[64];
         snprintf(task_name, sizeof(task_name), "普通优先级任务#%d", task_args[i].id);
         
-        if (thread_pool_add_task(pool, priority_task, &task_args[i], task_name, task_args[i].priority) != 0) {
+        if (thread_pool_add_task(pool, priority_task, &task_args[i], task_name, task_args[i].priority) == 0) {
             fprintf(stderr, "添加任务#%d失败\n", task_args[i].id);
             thread_pool_destroy(pool);
             return 1;
@@ -670,7 +683,7 @@ static int test_basic_priority_ordering(void)
         char task_name[64];
         snprintf(task_name, sizeof(task_name), "高优先级任务#%d", task_args[i].id);
         
-        if (thread_pool_add_task(pool, priority_task, &task_args[i], task_name, task_args[i].priority) != 0) {
+        if (thread_pool_add_task(pool, priority_task, &task_args[i], task_name, task_args[i].priority) == 0) {
             fprintf(stderr, "添加任务#%d失败\n", task_args[i].id);
             thread_pool_destroy(pool);
             return 1;
@@ -811,3 +824,98 @@ static int test_basic_priority_ordering(void)
     thread_pool_destroy(pool);
     return 0;
 }
+
+// 阻塞唯一的工作线程，直到主线程完成全部任务的提交
+static void gate_task(void *arg)
+{
+    volatile int *released = (volatile int *)arg;
+    while (!*released) {
+        usleep(1000);
+    }
+}
+
+// 只记录执行顺序、不休眠的任务函数
+static void order_task(void *arg)
+{
+    record_task_execution((task_arg_t *)arg);
+}
+
+/**
+ * @brief 测试同优先级任务的FIFO顺序及自定义优先级值
+ *
+ * 使用单个工作线程并在其忙碌时一次性提交全部任务，验证：
+ * 1. 相同优先级的任务按提交顺序执行
+ * 2. 枚举之外的自定义优先级值按数值大小参与排序
+ * 3. 超出范围的优先级值不会导致任务丢失
+ *
+ * @return 成功时返回0，失败时返回非零值
+ */
+static int test_same_level_fifo_ordering(void)
+{
+    printf("\n=== 测试同级别FIFO及自定义优先级 ===\n");
+    fflush(stdout);
+
+    thread_pool_t pool = thread_pool_create(1);
+    if (pool == NULL) {
+        fprintf(stderr, "创建线程池失败\n");
+        return 1;
+    }
+
+    g_execution_index = 0;
+
+    volatile int released = 0;
+    if (thread_pool_add_task(pool, gate_task, (void *)&released, "FIFO门控任务",
+                             TASK_PRIORITY_HIGH) == 0) {
+        fprintf(stderr, "添加门控任务失败\n");
+        thread_pool_destroy(pool);
+        return 1;
+    }
+    usleep(50000); // 等待门控任务占用工作线程
+
+    // 提交顺序与期望的执行顺序（按任务id）
+    static const int priorities[] = {TASK_PRIORITY_LOW, 7, TASK_PRIORITY_NORMAL, 7,
+                                     TASK_PRIORITY_NORMAL, 1000, TASK_PRIORITY_LOW, 3,
+                                     TASK_PRIORITY_NORMAL};
+    static const int expected_order[] = {8, 3, 5, 9, 2, 4, 1, 7, 6};
+    const int task_count = (int)(sizeof(priorities) / sizeof(priorities[0]));
+    task_arg_t task_args[sizeof(priorities) / sizeof(priorities[0])];
+    memset(task_args, 0, sizeof(task_args));
+
+    for (int i = 0; i < task_count; i++) {
+        task_args[i].id = i + 1;
+        task_args[i].priority = (task_priority_t)priorities[i];
+        if (thread_pool_add_task(pool, order_task, &task_args[i], NULL, task_args[i].priority) ==
+            0) {
+            fprintf(stderr, "添加任务#%d失败\n", task_args[i].id);
+            released = 1;
+            thread_pool_destroy(pool);
+            return 1;
+        }
+    }
+
+    released = 1;
+
+    // 等待所有任务完成
+    for (int wait = 0; wait < 200 && g_execution_index < task_count; wait++) {
+        usleep(10000);
+    }
+
+    int ok = (g_execution_index == task_count);
+    printf("任务执行顺序:\n");
+    for (int i = 0; i < g_execution_index; i++) {
+        printf("  %2d: 任务 #%d (优先级 %d)\n", i + 1, g_task_execution_order[i].id,
+               (int)g_task_execution_order[i].priority);
+        if (i < task_count && g_task_execution_order[i].id != expected_order[i]) {
+            ok = 0;
+        }
+    }
+
+    thread_pool_destroy(pool);
+
+    if (!ok) {
+        printf("同级别FIFO及自定义优先级测试失败\n");
+        return 1;
+    }
+    printf("同级别FIFO及自定义优先级测试成功\n");
+    return 0;
+}
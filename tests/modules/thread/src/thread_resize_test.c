@@ -154,8 +154,7 @@ static void test_thread_pool_resize(void)
         char task_name[32];
         snprintf(task_name, sizeof(task_name), "Task-%d", task_idx);
         
-        ret = thread_pool_add_task_default(pool, test_task, arg, task_name);
-        if (ret != 0) {
+        if (thread_pool_add_task_default(pool, test_task, arg, task_name) == 0) {
             fprintf(stderr, "添加任务失败\n");
             free(arg);
             thread_pool_destroy(pool);
@@ -286,6 +285,59 @@ static void test_thread_pool_resize(void)
     printf("======================================\n");
 }
 
+// 缩小后再增加线程时不等待仍在执行任务的线程
+static int regrow_started = 0;
+static int regrow_release = 0;
+static int regrow_finished = 0;
+
+static void regrow_long_task(void *arg)
+{
+    (void)arg;
+    __sync_fetch_and_add(&regrow_started, 1);
+    while (!__sync_fetch_and_add(&regrow_release, 0)) {
+        usleep(1000);
+    }
+    __sync_fetch_and_add(&regrow_finished, 1);
+}
+
+static long long regrow_now_ms(void)
+{
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (long long)now.tv_sec * 1000 + now.tv_nsec / 1000000;
+}
+
+static void test_resize_regrow_busy(void)
+{
+    printf("\n=== 测试缩小后立即增加线程 ===\n");
+    thread_pool_t pool = thread_pool_create(2);
+    assert(pool != NULL);
+    assert(thread_pool_add_task(pool, regrow_long_task, NULL, "regrow_long_0", TASK_PRIORITY_NORMAL) != 0);
+    assert(thread_pool_add_task(pool, regrow_long_task, NULL, "regrow_long_1", TASK_PRIORITY_NORMAL) != 0);
+    while (__sync_fetch_and_add(&regrow_started, 0) < 2) {
+        usleep(1000);
+    }
+
+    // 线程 #1 被要求退出但仍在执行长任务，再次增加线程时应直接留用它
+    assert(thread_pool_resize(pool, 1) == 0);
+    long long start = regrow_now_ms();
+    assert(thread_pool_resize(pool, 2) == 0);
+    long long elapsed = regrow_now_ms() - start;
+    printf("增加线程耗时 %lld ms\n", elapsed);
+    assert(elapsed < 500);
+    assert(__sync_fetch_and_add(&regrow_finished, 0) == 0);
+
+    __sync_fetch_and_add(&regrow_release, 1);
+    while (__sync_fetch_and_add(&regrow_finished, 0) < 2) {
+        usleep(1000);
+    }
+    thread_pool_stats_t stats;
+    assert(thread_pool_get_stats(pool, &stats) == 0);
+    assert(stats.thread_count == 2);
+    assert(thread_pool_destroy(pool) == 0);
+    printf("测试成功: 增加线程没有等待正在执行的任务\n");
+}
+
 int main(void)
 {
     printf("======================================\n");
@@ -299,6 +351,9 @@ int main(void)
     alarm(timeout);
 
     test_thread_pool_resize();
+    if (!g_alarm_received) {
+        test_resize_regrow_busy();
+    }
 
     // 根据超时状态显示不同的完成提示
     if (g_alarm_received) {
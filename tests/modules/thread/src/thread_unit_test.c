@@ -1,5 +1,8 @@
+#define _GNU_SOURCE // sched_getaffinity
 #include "thread.h"
 #include <assert.h>
+#include <pthread.h>
+#include <sched.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <sys/random.h>
@@ -7,6 +10,7 @@
 #include <time.h>
 #include <unistd.h>
 #include <signal.h>
+#include <sys/resource.h>
 
 // 全局变量
 static int completed_tasks = 0;
@@ -50,6 +54,27 @@ static void alarm_handler(int sig) {
     g_alarm_received = 1;
 }
 
+// 各测试共用的单调时钟 (微秒)
+static long long test_now_us(void)
+{
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (long long)now.tv_sec * 1000000LL + now.tv_nsec / 1000;
+}
+
+// 各测试共用的等待：每毫秒轮询一次，直到计数器不小于 expected，返回此时的计数。
+// 5 秒内未达到或收到超时信号时断言失败，不会悄悄地继续执行
+static int test_wait_counter(int *counter, int expected)
+{
+    long long deadline = test_now_us() + 5000000LL;
+    int value;
+    while ((value = __sync_fetch_and_add(counter, 0)) < expected) {
+        assert(!g_alarm_received && test_now_us() < deadline);
+        usleep(1000);
+    }
+    return value;
+}
+
 // 测试任务函数 - 随机执行时间
 static void test_task(void *arg)
 {
@@ -100,8 +125,8 @@ static void test_basic_functionality(void)
         char task_name[64];
         snprintf(task_name, sizeof(task_name), "Task-%d", i);
 
-        int result = thread_pool_add_task_default(pool, test_task, task_id, task_name);
-        assert(result == 0);
+        task_id_t new_task_id = thread_pool_add_task_default(pool, test_task, task_id, task_name);
+        assert(new_task_id != 0);
         printf("已添加任务 #%d\n", i);
     }
 
@@ -185,13 +210,13 @@ static void test_error_handling(void)
     assert(pool != NULL);
 
     // 测试无效的任务函数
-    int result = thread_pool_add_task_default(pool, NULL, NULL, "invalid-task");
-    assert(result != 0);
+    task_id_t invalid_task_id = thread_pool_add_task_default(pool, NULL, NULL, "invalid-task");
+    assert(invalid_task_id == 0);
     printf("测试通过: 无法添加函数指针为NULL的任务\n");
 
     // 测试无效的线程池指针
-    result = thread_pool_add_task_default(NULL, test_task, NULL, "invalid-pool");
-    assert(result != 0);
+    invalid_task_id = thread_pool_add_task_default(NULL, test_task, NULL, "invalid-pool");
+    assert(invalid_task_id == 0);
     printf("测试通过: 无法向NULL线程池添加任务\n");
 
     // 测试获取运行任务名称的错误处理
@@ -200,7 +225,7 @@ static void test_error_handling(void)
     printf("测试通过: 从NULL线程池获取任务名称返回NULL\n");
 
     // 测试销毁NULL线程池
-    result = thread_pool_destroy(NULL);
+    int result = thread_pool_destroy(NULL);
     assert(result != 0);
     printf("测试通过: 销毁NULL线程池返回错误\n");
 
@@ -209,6 +234,1902 @@ static void test_error_handling(void)
     printf("错误处理测试全部通过\n");
 }
 
+// slab 测试用计数器与线程池
+static int slab_completed_tasks = 0;
+static thread_pool_t slab_pool = NULL;
+
+// 空任务：仅计数
+static void slab_counting_task(void *arg)
+{
+    (void)arg;
+    __sync_fetch_and_add(&slab_completed_tasks, 1);
+}
+
+// 在工作线程内提交子任务，覆盖工作线程本地节点缓存路径
+static void slab_spawning_task(void *arg)
+{
+    int children = *(int *)arg;
+    for (int i = 0; i < children; i++) {
+        task_id_t id = thread_pool_add_task_default(slab_pool, slab_counting_task, NULL, NULL);
+        assert(id != 0);
+        (void)id;
+    }
+    __sync_fetch_and_add(&slab_completed_tasks, 1);
+}
+
+// 测试任务节点 slab：预分配很小、需要多次扩展并在工作线程间复用节点
+static void test_task_slab_reuse(void)
+{
+    printf("\n=== 测试任务节点 slab ===\n");
+
+    thread_pool_config_t config;
+    thread_pool_config_init(&config, 3);
+    config.task_slab_chunk_size = 0;
+    thread_pool_t invalid_pool = thread_pool_create_with_config(&config);
+    assert(invalid_pool == NULL);
+    invalid_pool = thread_pool_create_with_config(NULL);
+    assert(invalid_pool == NULL);
+    printf("测试通过: 无效的 slab 选项被拒绝\n");
+
+    thread_pool_config_init(&config, 3);
+    config.task_slab_size = 2;
+    config.task_slab_chunk_size = 4;
+    slab_pool = thread_pool_create_with_config(&config);
+    assert(slab_pool != NULL);
+
+    const int rounds = 5;
+    const int tasks_per_round = 100;
+    int children = 20;
+    slab_completed_tasks = 0;
+    for (int round = 0; round < rounds; round++) {
+        task_id_t id = thread_pool_add_task_default(slab_pool, slab_spawning_task, &children, NULL);
+        assert(id != 0);
+        for (int i = 0; i < tasks_per_round; i++) {
+            id = thread_pool_add_task_default(slab_pool, slab_counting_task, NULL, NULL);
+            assert(id != 0);
+        }
+    }
+
+    // 取消一个排队中的任务，节点应归还给 slab 而不会被执行
+    int expected = rounds * (1 + children + tasks_per_round);
+    task_id_t victim = thread_pool_add_task(slab_pool, slab_counting_task, NULL, NULL, TASK_PRIORITY_LOW);
+    assert(victim != 0);
+    if (thread_pool_cancel_task(slab_pool, victim, NULL) != 0) {
+        expected++; // 任务已开始执行，无法取消
+    }
+
+    test_wait_counter(&slab_completed_tasks, expected);
+    printf("slab 测试完成任务数: %d/%d\n", slab_completed_tasks, expected);
+    assert(slab_completed_tasks == expected);
+
+    int result = thread_pool_destroy(slab_pool);
+    assert(result == 0);
+    slab_pool = NULL;
+    printf("任务节点 slab 测试通过\n");
+}
+
+// 批量提交测试用计数器
+static int batch_completed_tasks = 0;
+
+static void batch_counting_task(void *arg)
+{
+    (void)arg;
+    __sync_fetch_and_add(&batch_completed_tasks, 1);
+}
+
+// 测试批量提交：连续任务ID、逐条目失败报告且不回滚成功条目
+static void test_batch_submission(void)
+{
+    printf("\n=== 测试批量提交 ===\n");
+
+    thread_pool_t pool = thread_pool_create(4);
+    assert(pool != NULL);
+
+    int result = thread_pool_add_tasks(NULL, NULL, 0, NULL);
+    assert(result == -1);
+    result = thread_pool_add_tasks(pool, NULL, 1, NULL);
+    assert(result == -1);
+    result = thread_pool_add_tasks(pool, NULL, 0, NULL);
+    assert(result == 0);
+    printf("测试通过: 无效的批量提交参数被拒绝\n");
+
+    enum { BATCH_SIZE = 200 };
+    static thread_pool_task_spec_t specs[BATCH_SIZE];
+    static char names[BATCH_SIZE][MAX_TASK_NAME_LEN];
+    task_id_t ids[BATCH_SIZE];
+    for (int i = 0; i < BATCH_SIZE; i++) {
+        snprintf(names[i], sizeof(names[i]), "batch_task_%d", i);
+        specs[i].function = batch_counting_task;
+        specs[i].arg = NULL;
+        specs[i].task_name = names[i];
+        specs[i].priority = (task_priority_t)(i % 4);
+    }
+    specs[10].function = NULL;       // 无效条目
+    specs[20].task_name = names[19]; // 与同批次条目重名
+    specs[30].task_name = NULL;      // 自动生成名称
+
+    batch_completed_tasks = 0;
+    result = thread_pool_add_tasks(pool, specs, BATCH_SIZE, ids);
+    printf("批量提交成功条目数: %d/%d\n", result, BATCH_SIZE);
+    assert(result == BATCH_SIZE - 2);
+    assert(ids[10] == 0 && ids[20] == 0);
+    for (int i = 1; i < BATCH_SIZE; i++) {
+        if (i != 10 && i != 20) {
+            assert(ids[i] == ids[0] + (task_id_t)i);
+        }
+    }
+
+    test_wait_counter(&batch_completed_tasks, result);
+    assert(batch_completed_tasks == result);
+
+    // 批次之后的单任务ID紧随其后
+    task_id_t next_id = thread_pool_add_task_default(pool, batch_counting_task, NULL, NULL);
+    assert(next_id == ids[0] + BATCH_SIZE);
+    (void)next_id;
+
+    result = thread_pool_destroy(pool);
+    assert(result == 0);
+    (void)result;
+    printf("批量提交测试通过\n");
+}
+
+// 工作窃取测试用计数器与线程池
+static int ws_completed_tasks = 0;
+static int ws_cancelled_tasks = 0;
+static thread_pool_t ws_pool = NULL;
+#define WS_TEST_MAX_THREADS 16
+static pthread_t ws_seen_threads[WS_TEST_MAX_THREADS];
+static int ws_seen_count = 0;
+static pthread_mutex_t ws_seen_lock = PTHREAD_MUTEX_INITIALIZER;
+
+// 记录执行任务的线程，用于确认任务被其他线程窃取
+static void ws_record_thread(void)
+{
+    pthread_t self = pthread_self();
+    pthread_mutex_lock(&ws_seen_lock);
+    int known = 0;
+    for (int i = 0; i < ws_seen_count; i++) {
+        if (pthread_equal(ws_seen_threads[i], self)) {
+            known = 1;
+            break;
+        }
+    }
+    if (!known && ws_seen_count < WS_TEST_MAX_THREADS) {
+        ws_seen_threads[ws_seen_count++] = self;
+    }
+    pthread_mutex_unlock(&ws_seen_lock);
+}
+
+// 子任务：短暂休眠让空闲线程有机会窃取
+static void ws_child_task(void *arg)
+{
+    (void)arg;
+    ws_record_thread();
+    usleep(1000);
+    __sync_fetch_and_add(&ws_completed_tasks, 1);
+}
+
+// 在工作线程内提交子任务，任务进入该线程的本地队列
+static void ws_spawning_task(void *arg)
+{
+    int children = *(int *)arg;
+    for (int i = 0; i < children; i++) {
+        task_id_t id = thread_pool_add_task_default(ws_pool, ws_child_task, NULL, NULL);
+        assert(id != 0);
+        (void)id;
+    }
+    __sync_fetch_and_add(&ws_completed_tasks, 1);
+}
+
+static void ws_cancel_callback(void *arg, task_id_t task_id)
+{
+    (void)arg;
+    (void)task_id;
+    __sync_fetch_and_add(&ws_cancelled_tasks, 1);
+}
+
+// 单线程池中没有窃取者：提交后立即取消本地队列中的子任务
+static void ws_cancel_local_task(void *arg)
+{
+    (void)arg;
+    task_id_t victim = thread_pool_add_task_default(ws_pool, ws_child_task, NULL, "ws_local_victim");
+    task_id_t keeper = thread_pool_add_task_default(ws_pool, ws_child_task, NULL, "ws_local_keeper");
+    assert(victim != 0 && keeper != 0);
+
+    int is_running = -1;
+    int exists = thread_pool_task_exists(ws_pool, victim, &is_running);
+    assert(exists == 1 && is_running == 0);
+    int result = thread_pool_cancel_task_by_name(ws_pool, "ws_local_victim", ws_cancel_callback);
+    assert(result == 0);
+    exists = thread_pool_task_exists(ws_pool, victim, NULL);
+    assert(exists == 0);
+    (void)exists;
+    (void)result;
+    (void)keeper;
+    __sync_fetch_and_add(&ws_completed_tasks, 1);
+}
+
+// 测试工作窃取调度模式：本地提交、窃取、本地队列满时回退以及取消本地任务
+static void test_work_stealing(void)
+{
+    printf("\n=== 测试工作窃取调度模式 ===\n");
+
+    thread_pool_config_t config;
+    thread_pool_config_init(&config, 4);
+    config.scheduler = THREAD_POOL_SCHED_WORK_STEALING;
+    config.ws_deque_capacity = 0;
+    thread_pool_t invalid_pool = thread_pool_create_with_config(&config);
+    assert(invalid_pool == NULL);
+    printf("测试通过: 无效的工作窃取选项被拒绝\n");
+
+    // 本地队列容量很小，超出部分回退到共享队列
+    config.ws_deque_capacity = 8;
+    ws_pool = thread_pool_create_with_config(&config);
+    assert(ws_pool != NULL);
+
+    const int spawners = 3;
+    int children = 60;
+    ws_completed_tasks = 0;
+    ws_seen_count = 0;
+    for (int i = 0; i < spawners; i++) {
+        task_id_t id = thread_pool_add_task_default(ws_pool, ws_spawning_task, &children, NULL);
+        assert(id != 0);
+        (void)id;
+    }
+    int expected = spawners * (1 + children);
+    test_wait_counter(&ws_completed_tasks, expected);
+    printf("工作窃取测试完成任务数: %d/%d，参与线程数: %d\n", ws_completed_tasks, expected, ws_seen_count);
+    assert(ws_completed_tasks == expected);
+    assert(ws_seen_count >= 2);
+
+    thread_pool_stats_t stats;
+    int result = thread_pool_get_stats(ws_pool, &stats);
+    assert(result == 0 && stats.task_queue_size == 0);
+    result = thread_pool_destroy(ws_pool);
+    assert(result == 0);
+
+    // 单线程池：本地队列中的任务可以被取消，其余任务仍被执行
+    thread_pool_config_init(&config, 1);
+    config.scheduler = THREAD_POOL_SCHED_WORK_STEALING;
+    ws_pool = thread_pool_create_with_config(&config);
+    assert(ws_pool != NULL);
+    ws_completed_tasks = 0;
+    ws_cancelled_tasks = 0;
+    task_id_t id = thread_pool_add_task_default(ws_pool, ws_cancel_local_task, NULL, NULL);
+    assert(id != 0);
+    (void)id;
+    test_wait_counter(&ws_completed_tasks, 2);
+    assert(ws_completed_tasks == 2);
+    assert(ws_cancelled_tasks == 1);
+
+    result = thread_pool_destroy(ws_pool);
+    assert(result == 0);
+    (void)result;
+    ws_pool = NULL;
+    printf("工作窃取调度模式测试通过\n");
+}
+
+// 空闲休眠测试用计数器
+static int park_completed_tasks = 0;
+
+static void park_counting_task(void *arg)
+{
+    (void)arg;
+    __sync_fetch_and_add(&park_completed_tasks, 1);
+}
+
+static long long park_cpu_us(void)
+{
+    struct rusage usage;
+    getrusage(RUSAGE_SELF, &usage);
+    return (long long)(usage.ru_utime.tv_sec + usage.ru_stime.tv_sec) * 1000000LL + usage.ru_utime.tv_usec +
+           usage.ru_stime.tv_usec;
+}
+
+// 基准：不经过线程池，直接用条件变量唤醒一个休眠的线程
+static pthread_mutex_t park_baseline_lock = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t park_baseline_cond = PTHREAD_COND_INITIALIZER;
+static int park_baseline_go = 0;
+
+static void *park_baseline_thread(void *arg)
+{
+    (void)arg;
+    pthread_mutex_lock(&park_baseline_lock);
+    while (!park_baseline_go) {
+        pthread_cond_wait(&park_baseline_cond, &park_baseline_lock);
+    }
+    pthread_mutex_unlock(&park_baseline_lock);
+    __sync_fetch_and_add(&park_completed_tasks, 1);
+    return NULL;
+}
+
+// 用与线程池相同的等待方式测量唤醒一个休眠线程的延迟，作为本机调度延迟的基准
+static long long park_baseline_wake_us(void)
+{
+    pthread_t thread;
+    park_completed_tasks = 0;
+    park_baseline_go = 0;
+    assert(pthread_create(&thread, NULL, park_baseline_thread, NULL) == 0);
+    usleep(50000);
+    long long start = test_now_us();
+    pthread_mutex_lock(&park_baseline_lock);
+    park_baseline_go = 1;
+    pthread_cond_signal(&park_baseline_cond);
+    pthread_mutex_unlock(&park_baseline_lock);
+    test_wait_counter(&park_completed_tasks, 1);
+    long long latency = test_now_us() - start;
+    pthread_join(thread, NULL);
+    assert(park_completed_tasks == 1);
+    return latency;
+}
+
+// 测试空闲线程休眠：不轮询、提交后被定向唤醒、缩容时只唤醒退出的线程
+static void test_idle_parking(void)
+{
+    printf("\n=== 测试空闲线程休眠与定向唤醒 ===\n");
+
+    thread_pool_config_t config;
+    thread_pool_config_init(&config, 4);
+    config.idle_spin_us = -1;
+    thread_pool_t pool = thread_pool_create_with_config(&config);
+    assert(pool == NULL);
+    printf("测试通过: 无效的空闲自旋时间被拒绝\n");
+
+    // 没有线程池时同样时长内进程消耗的 CPU 时间和唤醒延迟作为基准
+    long long baseline_cpu_start = park_cpu_us();
+    usleep(300000);
+    long long baseline_cpu = park_cpu_us() - baseline_cpu_start;
+    long long baseline_wake = park_baseline_wake_us();
+    if (baseline_wake < 1000) {
+        baseline_wake = 1000; // 等待循环的轮询间隔是 1 毫秒
+    }
+
+    config.idle_spin_us = 200;
+    pool = thread_pool_create_with_config(&config);
+    assert(pool != NULL);
+    int result = thread_pool_set_limits(pool, 1, 4);
+    assert(result == 0);
+
+    // 空闲期间工作线程应全部休眠：4 个轮询的线程会消耗数倍于时长的 CPU 时间，
+    // 休眠时与基准相比增加的 CPU 时间应远少于一个核心
+    usleep(50000);
+    long long cpu_before = park_cpu_us();
+    long long idle_start = test_now_us();
+    usleep(300000);
+    long long idle_cpu = park_cpu_us() - cpu_before;
+    long long idle_wall = test_now_us() - idle_start;
+    printf("空闲 %lld 微秒期间进程 CPU 时间: %lld 微秒 (基准 %lld 微秒)\n", idle_wall, idle_cpu, baseline_cpu);
+    assert(idle_cpu <= baseline_cpu + idle_wall / 4);
+
+    // 空闲之后提交的任务应被立即唤醒的线程执行
+    park_completed_tasks = 0;
+    long long start = test_now_us();
+    task_id_t id = thread_pool_add_task_default(pool, park_counting_task, NULL, NULL);
+    assert(id != 0);
+    (void)id;
+    test_wait_counter(&park_completed_tasks, 1);
+    long long latency = test_now_us() - start;
+    printf("休眠后任务唤醒延迟: %lld 微秒 (直接唤醒线程的基准 %lld 微秒)\n", latency, baseline_wake);
+    assert(park_completed_tasks == 1);
+    assert(latency <= 50 * baseline_wake);
+
+    // 缩容时需要退出的休眠线程被唤醒，剩余线程继续处理任务
+    result = thread_pool_resize(pool, 2);
+    assert(result == 0);
+    thread_pool_stats_t stats;
+    result = thread_pool_get_stats(pool, &stats);
+    assert(result == 0 && stats.thread_count == 2);
+    for (int i = 0; i < 20; i++) {
+        id = thread_pool_add_task_default(pool, park_counting_task, NULL, NULL);
+        assert(id != 0);
+    }
+    test_wait_counter(&park_completed_tasks, 21);
+    assert(park_completed_tasks == 21);
+
+    // 扩容后新线程同样可以休眠和被唤醒
+    result = thread_pool_resize(pool, 4);
+    assert(result == 0);
+    usleep(20000);
+    for (int i = 0; i < 20; i++) {
+        id = thread_pool_add_task_default(pool, park_counting_task, NULL, NULL);
+        assert(id != 0);
+    }
+    test_wait_counter(&park_completed_tasks, 41);
+    assert(park_completed_tasks == 41);
+
+    result = thread_pool_destroy(pool);
+    assert(result == 0);
+    (void)result;
+    printf("空闲线程休眠测试通过\n");
+}
+
+// 工作线程槽位测试用计数器
+static int slot_completed_tasks = 0;
+
+static void slot_short_task(void *arg)
+{
+    (void)arg;
+    usleep(1000);
+    __sync_fetch_and_add(&slot_completed_tasks, 1);
+}
+
+// 测试工作线程槽位复用：反复缩小和扩大时任务不丢失，空闲计数保持一致
+static void test_worker_slot_reuse(void)
+{
+    printf("\n=== 测试工作线程槽位复用 ===\n");
+
+    thread_pool_t pool = thread_pool_create(2);
+    assert(pool != NULL);
+    int result = thread_pool_set_limits(pool, 1, 6);
+    assert(result == 0);
+
+    slot_completed_tasks = 0;
+    int submitted = 0;
+    for (int round = 0; round < 10 && !g_alarm_received; round++) {
+        result = thread_pool_resize(pool, 6);
+        assert(result == 0);
+        for (int i = 0; i < 12; i++) {
+            task_id_t id = thread_pool_add_task_default(pool, slot_short_task, NULL, NULL);
+            assert(id != 0);
+            (void)id;
+            submitted++;
+        }
+        // 缩小时仍有线程在执行任务，随后立即扩大会复用这些线程的槽位
+        result = thread_pool_resize(pool, 1);
+        assert(result == 0);
+    }
+    result = thread_pool_resize(pool, 4);
+    assert(result == 0);
+
+    test_wait_counter(&slot_completed_tasks, submitted);
+    printf("槽位复用测试完成任务数: %d/%d\n", slot_completed_tasks, submitted);
+    assert(slot_completed_tasks == submitted);
+
+    thread_pool_stats_t stats;
+    result = thread_pool_get_stats(pool, &stats);
+    assert(result == 0);
+    printf("线程数: %d，空闲线程数: %d\n", stats.thread_count, stats.idle_threads);
+    assert(stats.thread_count == 4);
+    assert(stats.idle_threads >= 0 && stats.idle_threads <= stats.thread_count);
+
+    char **names = thread_pool_get_running_task_names(pool);
+    assert(names != NULL);
+    for (int i = 0; i < stats.thread_count; i++) {
+        assert(names[i] != NULL && strcmp(names[i], "[idle]") == 0);
+    }
+    assert(names[stats.thread_count] == NULL);
+    free_running_task_names(names, stats.thread_count);
+
+    // 提高上限后可以扩大到新的上限
+    result = thread_pool_set_limits(pool, 1, 10);
+    assert(result == 0);
+    result = thread_pool_resize(pool, 10);
+    assert(result == 0);
+
+    result = thread_pool_destroy(pool);
+    assert(result == 0);
+    (void)result;
+    printf("工作线程槽位复用测试通过\n");
+}
+
+// 快照测试用的线程池、任务信息和控制标志
+enum { SNAP_TASKS = 64 };
+static thread_pool_t snap_pool = NULL;
+static task_id_t snap_ids[SNAP_TASKS];
+static char snap_names[SNAP_TASKS][MAX_TASK_NAME_LEN];
+static int snap_ids_ready = 0;
+static int snap_reader_stop = 0;
+static int snap_gate_open = 0;
+static int snap_inconsistent = 0;
+static int snap_reads = 0;
+
+static void snap_gate_task(void *arg)
+{
+    (void)arg;
+    while (!__sync_fetch_and_add(&snap_gate_open, 0)) {
+        usleep(1000);
+    }
+}
+
+static void snap_short_task(void *arg)
+{
+    (void)arg;
+    usleep(200);
+}
+
+// 不断读取快照，检查每个忙碌条目的任务名称与任务ID是否匹配
+static void *snap_reader_thread(void *arg)
+{
+    (void)arg;
+    thread_pool_worker_info_t infos[8];
+    thread_pool_snapshot_t snapshot;
+    while (!__sync_fetch_and_add(&snap_reader_stop, 0)) {
+        int n = thread_pool_get_snapshot(snap_pool, &snapshot, infos, 8);
+        if (n < 0) {
+            __sync_fetch_and_add(&snap_inconsistent, 1);
+            continue;
+        }
+        __sync_fetch_and_add(&snap_reads, 1);
+        if (!__sync_fetch_and_add(&snap_ids_ready, 0)) {
+            continue;
+        }
+        for (int i = 0; i < n; i++) {
+            if (infos[i].status != THREAD_POOL_WORKER_BUSY) {
+                continue;
+            }
+            task_id_t offset = infos[i].task_id - snap_ids[0];
+            if (offset >= SNAP_TASKS || strcmp(infos[i].task_name, snap_names[offset]) != 0) {
+                __sync_fetch_and_add(&snap_inconsistent, 1);
+            }
+        }
+    }
+    return NULL;
+}
+
+// 测试无锁快照接口：计数器、正在运行的任务信息以及并发读取时的一致性
+static void test_snapshot(void)
+{
+    printf("\n=== 测试无锁快照接口 ===\n");
+
+    thread_pool_snapshot_t snapshot;
+    thread_pool_worker_info_t infos[4];
+    assert(thread_pool_get_snapshot(NULL, &snapshot, infos, 4) == -1);
+
+    snap_pool = thread_pool_create(3);
+    assert(snap_pool != NULL);
+    assert(thread_pool_get_snapshot(snap_pool, NULL, infos, 4) == -1);
+    assert(thread_pool_get_snapshot(snap_pool, &snapshot, NULL, 4) == -1);
+    assert(thread_pool_get_snapshot(snap_pool, &snapshot, NULL, 0) == 0);
+    assert(snapshot.thread_count == 3);
+    printf("测试通过: 无效的快照参数被拒绝\n");
+
+    // 三个阻塞任务占满线程，第四个任务排队后被取消
+    __sync_lock_test_and_set(&snap_gate_open, 0);
+    task_id_t gate_ids[3];
+    for (int i = 0; i < 3; i++) {
+        char name[MAX_TASK_NAME_LEN];
+        snprintf(name, sizeof(name), "snap_gate_%d", i);
+        gate_ids[i] = thread_pool_add_task(snap_pool, snap_gate_task, NULL, name, TASK_PRIORITY_NORMAL);
+        assert(gate_ids[i] != 0);
+    }
+    task_id_t queued = thread_pool_add_task(snap_pool, snap_short_task, NULL, "snap_queued", TASK_PRIORITY_LOW);
+    assert(queued != 0);
+
+    int busy = 0;
+    for (int wait_loops = 0; busy < 3 && wait_loops < 500 && !g_alarm_received; wait_loops++) {
+        usleep(2000);
+        int n = thread_pool_get_snapshot(snap_pool, &snapshot, infos, 4);
+        assert(n == 3);
+        busy = 0;
+        for (int i = 0; i < n; i++) {
+            if (infos[i].status == THREAD_POOL_WORKER_BUSY) {
+                busy++;
+                int matched = 0;
+                for (int j = 0; j < 3; j++) {
+                    char name[MAX_TASK_NAME_LEN];
+                    snprintf(name, sizeof(name), "snap_gate_%d", j);
+                    matched |= infos[i].task_id == gate_ids[j] && strcmp(infos[i].task_name, name) == 0;
+                }
+                assert(matched);
+            }
+        }
+    }
+    assert(busy == 3);
+    assert(snapshot.task_queue_size == 1);
+    assert(snapshot.idle_threads == 0);
+    assert(snapshot.tasks_submitted == 4);
+
+    int result = thread_pool_cancel_task(snap_pool, queued, NULL);
+    assert(result == 0);
+    thread_pool_get_snapshot(snap_pool, &snapshot, NULL, 0);
+    assert(snapshot.tasks_cancelled == 1);
+    assert(snapshot.task_queue_size == 0);
+    printf("快照中忙碌线程数: %d，已提交: %lu，已取消: %lu\n", busy, snapshot.tasks_submitted,
+           snapshot.tasks_cancelled);
+
+    __sync_lock_test_and_set(&snap_gate_open, 1);
+    for (int wait_loops = 0; wait_loops < 500 && !g_alarm_received; wait_loops++) {
+        thread_pool_get_snapshot(snap_pool, &snapshot, NULL, 0);
+        if (snapshot.tasks_completed == 3) {
+            break;
+        }
+        usleep(2000);
+    }
+    assert(snapshot.tasks_completed == 3);
+
+    // 读取者并发轮询时，忙碌条目的名称与任务ID必须一致
+    pthread_t reader;
+    __sync_lock_test_and_set(&snap_reader_stop, 0);
+    __sync_lock_test_and_set(&snap_ids_ready, 0);
+    result = pthread_create(&reader, NULL, snap_reader_thread, NULL);
+    assert(result == 0);
+    thread_pool_task_spec_t specs[SNAP_TASKS];
+    for (int i = 0; i < SNAP_TASKS; i++) {
+        snprintf(snap_names[i], sizeof(snap_names[i]), "snap_task_%d_%s", i, i % 2 ? "odd" : "even");
+        specs[i].function = snap_short_task;
+        specs[i].arg = NULL;
+        specs[i].task_name = snap_names[i];
+        specs[i].priority = TASK_PRIORITY_NORMAL;
+    }
+    // 先阻塞所有线程，待任务ID就绪后再放行，保证读取者能校验每个条目
+    __sync_lock_test_and_set(&snap_gate_open, 0);
+    for (int i = 0; i < 3; i++) {
+        thread_pool_add_task_default(snap_pool, snap_gate_task, NULL, NULL);
+    }
+    result = thread_pool_add_tasks(snap_pool, specs, SNAP_TASKS, snap_ids);
+    assert(result == SNAP_TASKS);
+    __sync_lock_test_and_set(&snap_ids_ready, 1);
+    __sync_lock_test_and_set(&snap_gate_open, 1);
+
+    unsigned long expected = 3 + 3 + SNAP_TASKS;
+    for (int wait_loops = 0; wait_loops < 1000 && !g_alarm_received; wait_loops++) {
+        thread_pool_get_snapshot(snap_pool, &snapshot, NULL, 0);
+        if (snapshot.tasks_completed == expected) {
+            break;
+        }
+        usleep(2000);
+    }
+    __sync_lock_test_and_set(&snap_reader_stop, 1);
+    pthread_join(reader, NULL);
+    printf("并发读取次数: %d，不一致条目数: %d，已完成: %lu/%lu\n", snap_reads, snap_inconsistent,
+           snapshot.tasks_completed, expected);
+    assert(snapshot.tasks_completed == expected);
+    assert(snap_inconsistent == 0);
+    assert(snap_reads > 0);
+
+    result = thread_pool_destroy(snap_pool);
+    assert(result == 0);
+    (void)result;
+    snap_pool = NULL;
+    printf("无锁快照接口测试通过\n");
+}
+
+static void latency_sleep_task(void *arg)
+{
+    usleep((useconds_t)(uintptr_t)arg);
+}
+
+// 检查直方图的汇总值与桶计数是否自洽
+static void check_latency_histogram(const thread_pool_latency_histogram_t *hist, unsigned long expected_count)
+{
+    unsigned long total = 0;
+    for (int i = 0; i < THREAD_POOL_LATENCY_BUCKETS; i++) {
+        total += hist->buckets[i];
+    }
+    assert(hist->count == expected_count);
+    assert(total == hist->count);
+    assert(hist->p50_us <= hist->p99_us);
+    assert(hist->p99_us <= hist->max_us);
+    (void)total;
+}
+
+// 测试按优先级统计的任务排队等待和执行时间直方图
+static void test_latency_stats(void)
+{
+    printf("\n=== 测试任务延迟统计 ===\n");
+
+    thread_pool_latency_stats_t stats;
+    thread_pool_t plain_pool = thread_pool_create(1);
+    assert(plain_pool != NULL);
+    assert(thread_pool_get_latency_stats(plain_pool, TASK_PRIORITY_NORMAL, &stats) == -1);
+    assert(thread_pool_get_latency_stats(NULL, TASK_PRIORITY_NORMAL, &stats) == -1);
+    assert(thread_pool_destroy(plain_pool) == 0);
+    printf("测试通过: 未启用延迟统计的线程池拒绝查询\n");
+
+    thread_pool_config_t config;
+    thread_pool_config_init(&config, 1);
+    assert(config.latency_stats == 0);
+    config.latency_stats = 1;
+    thread_pool_t pool = thread_pool_create_with_config(&config);
+    assert(pool != NULL);
+    assert(thread_pool_get_latency_stats(pool, TASK_PRIORITY_NORMAL, NULL) == -1);
+
+    // 单个线程：一个 20ms 的高优先级任务先执行，随后 8 个 2ms 的低优先级任务依次排队
+    enum { LOW_TASKS = 8 };
+    task_future_t futures[LOW_TASKS + 1];
+    futures[0] = thread_pool_add_task_with_future(pool, latency_sleep_task, (void *)(uintptr_t)20000,
+                                                  "latency_high", TASK_PRIORITY_HIGH);
+    assert(futures[0] != NULL);
+    for (int i = 0; i < LOW_TASKS; i++) {
+        char name[MAX_TASK_NAME_LEN];
+        snprintf(name, sizeof(name), "latency_low_%d", i);
+        futures[i + 1] = thread_pool_add_task_with_future(pool, latency_sleep_task, (void *)(uintptr_t)2000,
+                                                          name, TASK_PRIORITY_LOW);
+        assert(futures[i + 1] != NULL);
+    }
+    assert(task_future_wait_all(futures, LOW_TASKS + 1, 5000) == 0);
+    for (int i = 0; i < LOW_TASKS + 1; i++) {
+        task_future_release(futures[i]);
+    }
+
+    assert(thread_pool_get_latency_stats(pool, TASK_PRIORITY_HIGH, &stats) == 0);
+    check_latency_histogram(&stats.queue_wait, 1);
+    check_latency_histogram(&stats.run_time, 1);
+    assert(stats.run_time.max_us >= 20000);
+    assert(stats.run_time.p50_us >= 16384);
+    printf("高优先级: 执行时间 p50 %lu us，最大 %lu us\n", stats.run_time.p50_us, stats.run_time.max_us);
+
+    assert(thread_pool_get_latency_stats(pool, TASK_PRIORITY_LOW, &stats) == 0);
+    check_latency_histogram(&stats.queue_wait, LOW_TASKS);
+    check_latency_histogram(&stats.run_time, LOW_TASKS);
+    assert(stats.run_time.p50_us >= 1024);
+    // 最后一个低优先级任务至少要等待高优先级任务和其余 7 个低优先级任务
+    assert(stats.queue_wait.max_us >= 20000 + (LOW_TASKS - 1) * 2000);
+    printf("低优先级: 排队等待 p50 %lu us，p99 %lu us，最大 %lu us；执行时间 p50 %lu us\n",
+           stats.queue_wait.p50_us, stats.queue_wait.p99_us, stats.queue_wait.max_us, stats.run_time.p50_us);
+
+    assert(thread_pool_get_latency_stats(pool, TASK_PRIORITY_NORMAL, &stats) == 0);
+    check_latency_histogram(&stats.queue_wait, 0);
+    check_latency_histogram(&stats.run_time, 0);
+
+    assert(thread_pool_destroy(pool) == 0);
+    printf("任务延迟统计测试通过\n");
+}
+
+#define TRACE_TEST_FILE "thread_trace_test.json"
+
+// 统计导出文件中子串出现的次数
+static int trace_count(const char *json, const char *needle)
+{
+    int count = 0;
+    for (const char *p = strstr(json, needle); p != NULL; p = strstr(p + 1, needle)) {
+        count++;
+    }
+    return count;
+}
+
+// 导出跟踪文件并读入内存，调用者负责释放
+static char *trace_export_and_read(void)
+{
+    assert(thread_pool_trace_export_chrome(TRACE_TEST_FILE) == 0);
+    FILE *file = fopen(TRACE_TEST_FILE, "r");
+    assert(file != NULL);
+    fseek(file, 0, SEEK_END);
+    long size = ftell(file);
+    fseek(file, 0, SEEK_SET);
+    char *json = (char *)malloc((size_t)size + 1);
+    assert(json != NULL);
+    size_t read = fread(json, 1, (size_t)size, file);
+    json[read] = '\0';
+    fclose(file);
+    remove(TRACE_TEST_FILE);
+    return json;
+}
+
+// 提交 count 个短任务并等待全部完成
+static void trace_run_tasks(thread_pool_t pool, int count)
+{
+    task_future_t futures[16];
+    assert(count <= 16);
+    static int serial = 0;
+    for (int i = 0; i < count; i++) {
+        char name[MAX_TASK_NAME_LEN];
+        snprintf(name, sizeof(name), "traced_%d", serial++);
+        futures[i] = thread_pool_add_task_with_future(pool, latency_sleep_task, (void *)(uintptr_t)100, name,
+                                                      TASK_PRIORITY_NORMAL);
+        assert(futures[i] != NULL);
+    }
+    assert(task_future_wait_all(futures, count, 5000) == 0);
+    for (int i = 0; i < count; i++) {
+        task_future_release(futures[i]);
+    }
+}
+
+// 测试线程池事件跟踪和 Chrome trace 导出
+static void test_trace_events(void)
+{
+    printf("\n=== 测试线程池事件跟踪 ===\n");
+
+    assert(thread_pool_trace_start(0) == -1);
+    assert(thread_pool_trace_export_chrome(NULL) == -1);
+
+    thread_pool_t pool = thread_pool_create(2);
+    assert(pool != NULL);
+    trace_run_tasks(pool, 2); // 跟踪开始前的事件不会被记录
+
+    enum { TRACED_TASKS = 10 };
+    assert(thread_pool_trace_start(256) == 0);
+    trace_run_tasks(pool, TRACED_TASKS);
+    assert(thread_pool_resize(pool, 3) == 0);
+    thread_pool_trace_stop();
+    trace_run_tasks(pool, 2); // 停止后的事件不会被记录
+
+    char *json = trace_export_and_read();
+    assert(strncmp(json, "{\"displayTimeUnit\"", 18) == 0);
+    assert(strstr(json, "\n]}\n") != NULL);
+    assert(trace_count(json, "\"name\":\"enqueue\"") == TRACED_TASKS);
+    assert(trace_count(json, "\"name\":\"dequeue\"") == TRACED_TASKS);
+    assert(trace_count(json, "\"name\":\"task\",\"cat\":\"thread_pool\",\"ph\":\"B\"") == TRACED_TASKS);
+    assert(trace_count(json, "\"name\":\"task\",\"cat\":\"thread_pool\",\"ph\":\"E\"") == TRACED_TASKS);
+    assert(trace_count(json, "\"args\":{\"threads\":3}") == 1);
+    printf("测试通过: 记录了 %d 个任务的入队、出队、开始和完成事件以及一次调整大小\n", TRACED_TASKS);
+    free(json);
+
+    // 缓冲区写满后只保留最近的事件：提交线程的缓冲区只有 4 条入队事件
+    assert(thread_pool_trace_start(3) == 0);
+    trace_run_tasks(pool, TRACED_TASKS);
+    thread_pool_trace_stop();
+    json = trace_export_and_read();
+    assert(trace_count(json, "\"name\":\"enqueue\"") == 4);
+    free(json);
+    printf("测试通过: 环形缓冲区回绕后保留最近的事件\n");
+
+    assert(thread_pool_destroy(pool) == 0);
+    printf("线程池事件跟踪测试通过\n");
+}
+
+// CPU 绑定测试用计数器
+static int placement_completed_tasks = 0;
+static int placement_bad_affinity = 0;
+
+// 检查当前线程只允许运行在 CPU 0 上
+static void placement_affinity_task(void *arg)
+{
+    (void)arg;
+    cpu_set_t cpus;
+    CPU_ZERO(&cpus);
+    if (sched_getaffinity(0, sizeof(cpus), &cpus) != 0 || CPU_COUNT(&cpus) != 1 || !CPU_ISSET(0, &cpus)) {
+        __sync_fetch_and_add(&placement_bad_affinity, 1);
+    }
+    __sync_fetch_and_add(&placement_completed_tasks, 1);
+}
+
+// 测试 CPU 绑定、线程属性和按节点提交任务
+static void test_worker_placement(void)
+{
+    printf("\n=== 测试工作线程 CPU 绑定与 NUMA 节点提交 ===\n");
+
+    thread_pool_config_t config;
+    thread_pool_config_init(&config, 2);
+    assert(config.cpus == NULL && config.cpu_count == 0 && config.pin_policy == THREAD_POOL_PIN_NONE);
+    assert(config.stack_size == 0 && config.sched_policy == -1);
+
+    // 无效选项被拒绝
+    static const int bad_cpus[] = {-1};
+    config.cpu_count = 1;
+    assert(thread_pool_create_with_config(&config) == NULL); // cpus 为 NULL
+    config.cpus = bad_cpus;
+    assert(thread_pool_create_with_config(&config) == NULL);
+    config.cpus = NULL;
+    config.cpu_count = 0;
+    config.stack_size = 1;
+    assert(thread_pool_create_with_config(&config) == NULL);
+    config.stack_size = 0;
+    config.pin_policy = (thread_pool_pin_policy_t)42;
+    assert(thread_pool_create_with_config(&config) == NULL);
+    printf("测试通过: 无效的 CPU 集合、栈大小和绑定策略被拒绝\n");
+
+    // 紧凑绑定到 CPU 0，所有工作线程 (包括扩容新建的线程) 都只能运行在 CPU 0 上
+    static const int cpu0[] = {0};
+    config.cpus = cpu0;
+    config.cpu_count = 1;
+    config.pin_policy = THREAD_POOL_PIN_COMPACT;
+    config.stack_size = 256 * 1024;
+    thread_pool_t pool = thread_pool_create_with_config(&config);
+    assert(pool != NULL);
+    assert(thread_pool_set_limits(pool, 1, 4) == 0);
+
+    placement_completed_tasks = 0;
+    placement_bad_affinity = 0;
+    for (int i = 0; i < 8; i++) {
+        assert(thread_pool_add_task(pool, placement_affinity_task, NULL, NULL, TASK_PRIORITY_NORMAL) != 0);
+    }
+    assert(test_wait_counter(&placement_completed_tasks, 8) == 8);
+
+    // CPU 0 属于节点 0：按节点提交的任务进入节点队列，无效节点退回共享队列
+    assert(thread_pool_add_task_on_node(pool, placement_affinity_task, NULL, NULL, TASK_PRIORITY_NORMAL, 0) != 0);
+    assert(thread_pool_add_task_on_node(pool, placement_affinity_task, NULL, NULL, TASK_PRIORITY_HIGH, 0) != 0);
+    assert(thread_pool_add_task_on_node(pool, placement_affinity_task, NULL, NULL, TASK_PRIORITY_NORMAL, 4096) !=
+           0);
+    assert(thread_pool_add_task_on_node(pool, placement_affinity_task, NULL, NULL, TASK_PRIORITY_NORMAL, -1) != 0);
+    assert(thread_pool_add_task_on_node(pool, NULL, NULL, NULL, TASK_PRIORITY_NORMAL, 0) == 0);
+    assert(test_wait_counter(&placement_completed_tasks, 12) == 12);
+
+    assert(thread_pool_resize(pool, 4) == 0);
+    for (int i = 0; i < 8; i++) {
+        assert(thread_pool_add_task_on_node(pool, placement_affinity_task, NULL, NULL, TASK_PRIORITY_NORMAL,
+                                            i % 2) != 0);
+    }
+    assert(test_wait_counter(&placement_completed_tasks, 20) == 20);
+    assert(thread_pool_resize(pool, 1) == 0);
+    assert(thread_pool_add_task_on_node(pool, placement_affinity_task, NULL, NULL, TASK_PRIORITY_NORMAL, 0) != 0);
+    assert(test_wait_counter(&placement_completed_tasks, 21) == 21);
+    assert(placement_bad_affinity == 0);
+    assert(thread_pool_destroy(pool) == 0);
+    printf("测试通过: 紧凑绑定在扩缩容后保持，按节点提交的任务全部执行\n");
+
+    // 工作窃取模式下按节点提交退化为普通提交
+    thread_pool_config_init(&config, 2);
+    config.scheduler = THREAD_POOL_SCHED_WORK_STEALING;
+    config.pin_policy = THREAD_POOL_PIN_NUMA_NODE;
+    pool = thread_pool_create_with_config(&config);
+    assert(pool != NULL);
+    placement_completed_tasks = 0;
+    placement_bad_affinity = 0;
+    for (int i = 0; i < 4; i++) {
+        assert(thread_pool_add_task_on_node(pool, placement_affinity_task, NULL, NULL, TASK_PRIORITY_NORMAL, 0) !=
+               0);
+    }
+    assert(test_wait_counter(&placement_completed_tasks, 4) == 4);
+    assert(thread_pool_destroy(pool) == 0);
+    printf("工作线程 CPU 绑定测试通过\n");
+}
+
+// 有界队列测试用状态
+static thread_pool_t bounded_pool = NULL;
+static int bounded_gate_open = 0;
+static int bounded_completed = 0;
+static int bounded_producer_done = 0;
+
+static void bounded_gate_task(void *arg)
+{
+    (void)arg;
+    while (!__sync_fetch_and_add(&bounded_gate_open, 0)) {
+        usleep(1000);
+    }
+    __sync_fetch_and_add(&bounded_completed, 1);
+}
+
+static void bounded_counting_task(void *arg)
+{
+    (void)arg;
+    __sync_fetch_and_add(&bounded_completed, 1);
+}
+
+// 在队列已满时阻塞提交，返回后记录结果；arg 非 NULL 时随后打开闸门
+static void *bounded_producer_thread(void *arg)
+{
+    task_id_t id = thread_pool_add_task(bounded_pool, bounded_counting_task, NULL, NULL, TASK_PRIORITY_BACKGROUND);
+    __sync_fetch_and_add(&bounded_producer_done, id != 0 ? 1 : -1);
+    if (arg != NULL) {
+        __sync_fetch_and_add(&bounded_gate_open, 1);
+    }
+    return NULL;
+}
+
+// 测试有界队列：快速失败、超时、高优先级保留槽位、阻塞提交者被唤醒以及销毁时释放阻塞的提交者
+static void test_bounded_queue(void)
+{
+    printf("\n=== 测试有界队列与背压 ===\n");
+
+    thread_pool_config_t config;
+    thread_pool_config_init(&config, 1);
+    assert(config.queue_capacity == 0 && config.queue_reserved == 0);
+    config.queue_capacity = -1;
+    assert(thread_pool_create_with_config(&config) == NULL);
+    config.queue_capacity = 4;
+    config.queue_reserved = 4;
+    assert(thread_pool_create_with_config(&config) == NULL);
+    printf("测试通过: 无效的队列容量和保留槽位被拒绝\n");
+
+    // 容量 4，其中 1 个槽位保留给高优先级任务；闸门任务占住唯一的工作线程
+    config.queue_reserved = 1;
+    bounded_pool = thread_pool_create_with_config(&config);
+    assert(bounded_pool != NULL);
+    bounded_gate_open = 0;
+    bounded_completed = 0;
+    bounded_producer_done = 0;
+    assert(thread_pool_add_task(bounded_pool, bounded_gate_task, NULL, "bounded_gate", TASK_PRIORITY_NORMAL) != 0);
+    thread_pool_snapshot_t snapshot;
+    for (int wait_loops = 0; wait_loops < 1000; wait_loops++) {
+        assert(thread_pool_get_snapshot(bounded_pool, &snapshot, NULL, 0) == 0);
+        if (snapshot.task_queue_size == 0) {
+            break;
+        }
+        usleep(1000);
+    }
+    assert(snapshot.task_queue_size == 0);
+
+    for (int i = 0; i < 3; i++) {
+        assert(thread_pool_try_add_task(bounded_pool, bounded_counting_task, NULL, NULL, TASK_PRIORITY_BACKGROUND) !=
+               0);
+    }
+    assert(thread_pool_try_add_task(bounded_pool, bounded_counting_task, NULL, NULL, TASK_PRIORITY_BACKGROUND) == 0);
+    assert(thread_pool_add_tasks(bounded_pool,
+                                 &(thread_pool_task_spec_t){bounded_counting_task, NULL, NULL, TASK_PRIORITY_LOW}, 1,
+                                 NULL) == 0);
+    assert(thread_pool_try_add_task(bounded_pool, bounded_counting_task, NULL, NULL, TASK_PRIORITY_HIGH) != 0);
+    assert(thread_pool_try_add_task(bounded_pool, bounded_counting_task, NULL, NULL, TASK_PRIORITY_HIGH) == 0);
+    printf("测试通过: 队列满时快速失败，保留槽位只供高优先级任务使用\n");
+
+    long long start_ms = test_now_us() / 1000;
+    assert(thread_pool_add_task_timeout(bounded_pool, bounded_counting_task, NULL, NULL, TASK_PRIORITY_NORMAL, 50) ==
+           0);
+    assert(test_now_us() / 1000 - start_ms >= 40);
+    assert(thread_pool_get_snapshot(bounded_pool, &snapshot, NULL, 0) == 0);
+    assert(snapshot.tasks_rejected == 4);
+    assert(snapshot.task_queue_size == 4);
+    printf("测试通过: 超时提交在等待后失败，拒绝次数为 %lu\n", snapshot.tasks_rejected);
+
+    // 阻塞的提交者在工作线程腾出空位后被唤醒
+    pthread_t producer;
+    assert(pthread_create(&producer, NULL, bounded_producer_thread, NULL) == 0);
+    usleep(50000);
+    assert(__sync_fetch_and_add(&bounded_producer_done, 0) == 0);
+    __sync_fetch_and_add(&bounded_gate_open, 1);
+    pthread_join(producer, NULL);
+    assert(bounded_producer_done == 1);
+    test_wait_counter(&bounded_completed, 6);
+    assert(bounded_completed == 6);
+    assert(thread_pool_destroy(bounded_pool) == 0);
+    printf("测试通过: 阻塞的提交者在队列腾出空位后继续\n");
+
+    // 销毁线程池时，阻塞的提交者返回失败
+    config.queue_capacity = 1;
+    config.queue_reserved = 0;
+    bounded_pool = thread_pool_create_with_config(&config);
+    assert(bounded_pool != NULL);
+    bounded_gate_open = 0;
+    bounded_producer_done = 0;
+    assert(thread_pool_add_task(bounded_pool, bounded_gate_task, NULL, "bounded_gate", TASK_PRIORITY_NORMAL) != 0);
+    for (int wait_loops = 0; wait_loops < 1000; wait_loops++) {
+        assert(thread_pool_get_snapshot(bounded_pool, &snapshot, NULL, 0) == 0);
+        if (snapshot.task_queue_size == 0) {
+            break;
+        }
+        usleep(1000);
+    }
+    assert(thread_pool_add_task(bounded_pool, bounded_counting_task, NULL, NULL, TASK_PRIORITY_NORMAL) != 0);
+    assert(pthread_create(&producer, NULL, bounded_producer_thread, (void *)&bounded_gate_open) == 0);
+    usleep(50000); // 等待提交者进入阻塞
+    assert(thread_pool_destroy(bounded_pool) == 0);
+    pthread_join(producer, NULL);
+    assert(bounded_producer_done == -1);
+    bounded_pool = NULL;
+    printf("有界队列测试通过\n");
+}
+
+// 定时任务测试用状态
+static long long timer_run_ms[4];
+static int timer_order[3];
+static int timer_order_claimed = 0;
+static int timer_order_count = 0;
+static int timer_periodic_runs = 0;
+static int timer_cancel_count = 0;
+
+static void timer_record_task(void *arg)
+{
+    int slot = (int)(uintptr_t)arg;
+    timer_run_ms[slot] = test_now_us() / 1000;
+    timer_order[__sync_fetch_and_add(&timer_order_claimed, 1) % 3] = slot;
+    __sync_fetch_and_add(&timer_order_count, 1); // 最后发布，主线程看到计数时记录已写完
+}
+
+static void timer_periodic_task(void *arg)
+{
+    (void)arg;
+    __sync_fetch_and_add(&timer_periodic_runs, 1);
+}
+
+static void timer_cancel_callback(void *arg, task_id_t task_id)
+{
+    (void)arg;
+    assert(task_id != 0);
+    __sync_fetch_and_add(&timer_cancel_count, 1);
+}
+
+// 参数由取消回调释放的周期任务：执行期间被取消时，回调必须在本次执行返回后才调用
+static int timer_owned_started = 0;
+static int timer_owned_running = 0;
+static int timer_owned_gate = 0;
+
+static void timer_owned_task(void *arg)
+{
+    int *owned = (int *)arg;
+    __sync_lock_test_and_set(&timer_owned_running, 1);
+    __sync_fetch_and_add(&timer_owned_started, 1);
+    while (__sync_fetch_and_add(&timer_owned_gate, 0) == 0) {
+        usleep(1000);
+    }
+    (*owned)++; // 返回前仍在使用参数
+    __sync_lock_test_and_set(&timer_owned_running, 0);
+}
+
+static void timer_owned_cancel_callback(void *arg, task_id_t task_id)
+{
+    assert(task_id != 0);
+    assert(__sync_fetch_and_add(&timer_owned_running, 0) == 0);
+    free(arg);
+    __sync_fetch_and_add(&timer_cancel_count, 1);
+}
+
+// 提交一个参数由取消回调释放的周期任务，等待它开始执行并阻塞在闸门上
+static task_id_t timer_owned_start(thread_pool_t pool)
+{
+    int *owned = (int *)calloc(1, sizeof(int));
+    assert(owned != NULL);
+    timer_owned_started = 0;
+    timer_owned_gate = 0;
+    timer_cancel_count = 0;
+    task_id_t id = thread_pool_add_periodic_task(pool, timer_owned_task, owned, NULL, TASK_PRIORITY_NORMAL, 0, 10);
+    assert(id != 0);
+    test_wait_counter(&timer_owned_started, 1);
+    assert(timer_owned_started == 1);
+    return id;
+}
+
+// 打开闸门让本次执行返回，取消回调恰好调用一次且之后任务不再执行
+static void timer_owned_finish(void)
+{
+    usleep(20000);
+    assert(__sync_fetch_and_add(&timer_cancel_count, 0) == 0); // 任务仍在执行，参数不能被释放
+    __sync_lock_test_and_set(&timer_owned_gate, 1);
+    test_wait_counter(&timer_cancel_count, 1);
+    assert(timer_cancel_count == 1);
+}
+
+// 测试延迟和周期任务：最短延迟、跨时间轮级别的到期顺序、取消、周期执行以及大量定时器的登记与取消
+static void test_timer_tasks(void)
+{
+    printf("\n=== 测试延迟与周期任务 ===\n");
+
+    thread_pool_t pool = thread_pool_create(1);
+    assert(pool != NULL);
+    assert(thread_pool_add_delayed_task(pool, NULL, NULL, NULL, TASK_PRIORITY_NORMAL, 10) == 0);
+    assert(thread_pool_add_periodic_task(pool, timer_periodic_task, NULL, NULL, TASK_PRIORITY_NORMAL, 0, 0) == 0);
+
+    // 150 毫秒的定时器位于第 1 级，需要级联后才到期
+    long long start_ms = test_now_us() / 1000;
+    timer_order_claimed = 0;
+    timer_order_count = 0;
+    assert(thread_pool_add_delayed_task(pool, timer_record_task, (void *)(uintptr_t)0, "timer_150",
+                                        TASK_PRIORITY_NORMAL, 150) != 0);
+    assert(thread_pool_add_delayed_task(pool, timer_record_task, (void *)(uintptr_t)1, "timer_30",
+                                        TASK_PRIORITY_NORMAL, 30) != 0);
+    assert(thread_pool_add_delayed_task(pool, timer_record_task, (void *)(uintptr_t)2, "timer_90",
+                                        TASK_PRIORITY_NORMAL, 90) != 0);
+    task_id_t cancelled_id = thread_pool_add_delayed_task(pool, timer_record_task, (void *)(uintptr_t)3,
+                                                          "timer_cancelled", TASK_PRIORITY_NORMAL, 60);
+    assert(cancelled_id != 0);
+    int is_running = 1;
+    assert(thread_pool_task_exists(pool, cancelled_id, &is_running) == 1 && is_running == 0);
+    assert(thread_pool_cancel_task(pool, cancelled_id, NULL) == 0);
+    assert(thread_pool_task_exists(pool, cancelled_id, NULL) == 0);
+
+    test_wait_counter(&timer_order_count, 3);
+    assert(timer_order_count == 3);
+    assert(timer_order[0] == 1 && timer_order[1] == 2 && timer_order[2] == 0);
+    assert(timer_run_ms[1] - start_ms >= 30);
+    assert(timer_run_ms[2] - start_ms >= 90);
+    assert(timer_run_ms[0] - start_ms >= 150);
+    usleep(20000);
+    assert(timer_order_count == 3);
+    printf("测试通过: 延迟任务按到期时间依次执行 (%lld/%lld/%lld 毫秒)，已取消的定时器不执行\n",
+           timer_run_ms[1] - start_ms, timer_run_ms[2] - start_ms, timer_run_ms[0] - start_ms);
+
+    // 周期任务反复执行，取消后不再执行
+    timer_periodic_runs = 0;
+    task_id_t periodic_id = thread_pool_add_periodic_task(pool, timer_periodic_task, NULL, "timer_periodic",
+                                                          TASK_PRIORITY_NORMAL, 0, 10);
+    assert(periodic_id != 0);
+    test_wait_counter(&timer_periodic_runs, 5);
+    assert(timer_periodic_runs >= 5);
+    assert(thread_pool_cancel_task(pool, periodic_id, NULL) == 0);
+    usleep(20000);
+    int runs_after_cancel = __sync_fetch_and_add(&timer_periodic_runs, 0);
+    usleep(50000);
+    assert(timer_periodic_runs == runs_after_cancel);
+    assert(thread_pool_task_exists(pool, periodic_id, NULL) == 0);
+    printf("测试通过: 周期任务执行 %d 次后被取消\n", runs_after_cancel);
+
+    // 执行期间被取消的周期任务：取消回调在本次执行返回后调用一次，可以在回调中释放参数
+    task_id_t owned_id = timer_owned_start(pool);
+    assert(thread_pool_cancel_task(pool, owned_id, timer_owned_cancel_callback) == 0);
+    timer_owned_finish();
+    owned_id = timer_owned_start(pool);
+    assert(thread_pool_request_cancel(pool, owned_id, timer_owned_cancel_callback) == 1);
+    timer_owned_finish();
+    usleep(30000);
+    assert(timer_cancel_count == 1 && timer_owned_started == 1);
+    assert(thread_pool_task_exists(pool, owned_id, NULL) == 0);
+    thread_pool_t owned_pool = thread_pool_create(1);
+    assert(owned_pool != NULL);
+    timer_owned_start(owned_pool);
+    __sync_lock_test_and_set(&timer_owned_gate, 1);
+    assert(thread_pool_destroy_with_mode(owned_pool, THREAD_POOL_DESTROY_DRAIN, timer_owned_cancel_callback) == 0);
+    assert(timer_cancel_count == 1);
+    printf("测试通过: 执行期间被取消的周期任务在本次执行返回后调用一次取消回调\n");
+
+    // 大量定时器的登记与取消都是 O(1)
+    enum { TIMER_COUNT = 100000 };
+    task_id_t *ids = (task_id_t *)malloc(TIMER_COUNT * sizeof(task_id_t));
+    assert(ids != NULL);
+    start_ms = test_now_us() / 1000;
+    for (int i = 0; i < TIMER_COUNT; i++) {
+        ids[i] = thread_pool_add_delayed_task(pool, timer_periodic_task, NULL, NULL, TASK_PRIORITY_LOW,
+                                              60000 + (unsigned int)(i % 5000));
+        assert(ids[i] != 0);
+    }
+    long long arm_ms = test_now_us() / 1000 - start_ms;
+    start_ms = test_now_us() / 1000;
+    for (int i = 0; i < TIMER_COUNT; i++) {
+        assert(thread_pool_cancel_task(pool, ids[i], NULL) == 0);
+    }
+    long long cancel_ms = test_now_us() / 1000 - start_ms;
+    free(ids);
+    printf("测试通过: 登记 %d 个定时器耗时 %lld 毫秒，取消耗时 %lld 毫秒\n", TIMER_COUNT, arm_ms, cancel_ms);
+
+    // DRAIN 模式销毁时取消尚未到期的定时器：完成句柄以取消状态结束，每个任务调用一次取消回调
+    assert(thread_pool_add_periodic_task(pool, timer_periodic_task, NULL, "timer_pending", TASK_PRIORITY_NORMAL,
+                                         60000, 1000) != 0);
+    task_id_t pending_id = thread_pool_add_delayed_task(pool, timer_periodic_task, NULL, "timer_pending_future",
+                                                        TASK_PRIORITY_NORMAL, 60000);
+    assert(pending_id != 0);
+    task_future_t pending_future = thread_pool_get_task_future(pool, pending_id);
+    assert(pending_future != NULL);
+    assert(task_future_wait(pending_future, 0) == -1);
+    timer_cancel_count = 0;
+    assert(thread_pool_destroy_with_mode(pool, THREAD_POOL_DESTROY_DRAIN, timer_cancel_callback) == 0);
+    assert(timer_cancel_count == 2);
+    assert(task_future_wait(pending_future, 1000) == 0);
+    assert(task_future_get_state(pending_future) == TASK_FUTURE_CANCELLED);
+    task_future_release(pending_future);
+    printf("测试通过: 销毁时尚未到期的 %d 个定时器被取消\n", timer_cancel_count);
+    printf("延迟与周期任务测试通过\n");
+}
+
+// 依赖图测试用状态
+static int graph_sequence = 0;
+static int graph_gate_open = 0;
+static int graph_cancel_sum = 0;
+static int graph_cancel_count = 0;
+
+typedef struct {
+    int order; // 最近一次执行时的全局序号
+    int runs;  // 累计执行次数
+} graph_stage_t;
+
+static void graph_stage_task(void *arg)
+{
+    graph_stage_t *stage = (graph_stage_t *)arg;
+    stage->order = __sync_add_and_fetch(&graph_sequence, 1);
+    stage->runs++;
+}
+
+static void graph_gate_task(void *arg)
+{
+    while (!__sync_fetch_and_add(&graph_gate_open, 0)) {
+        usleep(1000);
+    }
+    graph_stage_task(arg);
+}
+
+// 只会被取消、不应执行的任务
+static void graph_unreachable_task(void *arg)
+{
+    (void)arg;
+    assert(0);
+}
+
+static void graph_cancel_callback(void *arg, task_id_t task_id)
+{
+    assert(task_id != 0);
+    __sync_fetch_and_add(&graph_cancel_sum, (int)(uintptr_t)arg);
+    __sync_fetch_and_add(&graph_cancel_count, 1);
+}
+
+// 多个线程并发向同一张依赖图添加任务
+enum { GRAPH_ADDERS = 8, GRAPH_ADDS_PER_THREAD = 2000 };
+static task_graph_t graph_shared = NULL;
+static task_id_t graph_added_ids[GRAPH_ADDERS][GRAPH_ADDS_PER_THREAD];
+static graph_stage_t graph_added_stages[GRAPH_ADDERS][GRAPH_ADDS_PER_THREAD];
+
+static void *graph_adder_thread(void *arg)
+{
+    int thread_index = (int)(intptr_t)arg;
+    for (int i = 0; i < GRAPH_ADDS_PER_THREAD; i++) {
+        graph_added_ids[thread_index][i] = task_graph_add_task(graph_shared, graph_stage_task,
+                                                               &graph_added_stages[thread_index][i], NULL,
+                                                               TASK_PRIORITY_NORMAL, NULL, 0);
+        assert(graph_added_ids[thread_index][i] != 0);
+    }
+    return NULL;
+}
+
+// 测试任务依赖图：菱形依赖的执行顺序、跨帧复用、取消传递到后继以及运行期间的限制
+static void test_task_graph(void)
+{
+    printf("\n=== 测试任务依赖图 ===\n");
+
+    thread_pool_t pool = thread_pool_create(4);
+    assert(pool != NULL);
+    assert(task_graph_create(NULL) == NULL);
+
+    // decode -> {filter_a, filter_b} -> merge，复用三帧
+    graph_stage_t stages[4] = {{0, 0}, {0, 0}, {0, 0}, {0, 0}};
+    task_graph_t graph = task_graph_create(pool);
+    assert(graph != NULL);
+    task_id_t decode = task_graph_add_task(graph, graph_stage_task, &stages[0], "graph_decode", TASK_PRIORITY_NORMAL,
+                                           NULL, 0);
+    assert(decode != 0);
+    task_id_t filter_a = task_graph_add_task(graph, graph_stage_task, &stages[1], NULL, TASK_PRIORITY_NORMAL,
+                                             &decode, 1);
+    task_id_t filter_b = task_graph_add_task(graph, graph_stage_task, &stages[2], NULL, TASK_PRIORITY_HIGH,
+                                             &decode, 1);
+    assert(filter_a != 0 && filter_b != 0);
+    task_id_t filters[2] = {filter_a, filter_b};
+    task_id_t merge = task_graph_add_task(graph, graph_stage_task, &stages[3], "graph_merge", TASK_PRIORITY_NORMAL,
+                                          filters, 2);
+    assert(merge != 0);
+    task_id_t unknown = merge + 1000;
+    assert(task_graph_add_task(graph, graph_stage_task, NULL, NULL, TASK_PRIORITY_NORMAL, &unknown, 1) == 0);
+
+    for (int frame = 0; frame < 3; frame++) {
+        assert(task_graph_run(graph) == 0);
+        assert(task_graph_wait(graph, 5000) == 0);
+        assert(stages[0].order < stages[1].order && stages[0].order < stages[2].order);
+        assert(stages[1].order < stages[3].order && stages[2].order < stages[3].order);
+    }
+    for (int i = 0; i < 4; i++) {
+        assert(stages[i].runs == 3);
+    }
+    assert(thread_pool_task_exists(pool, merge, NULL) == 0);
+    assert(task_graph_cancel_task(graph, decode, NULL) == -1);
+    assert(task_graph_destroy(graph) == 0);
+    printf("测试通过: 菱形依赖图按依赖顺序执行并复用 3 帧\n");
+
+    // 并发添加时任务ID的分配顺序与登记顺序可能不同，所有任务仍能作为前驱被找到
+    graph_shared = task_graph_create(pool);
+    assert(graph_shared != NULL);
+    memset(graph_added_stages, 0, sizeof(graph_added_stages));
+    pthread_t adders[GRAPH_ADDERS];
+    for (int i = 0; i < GRAPH_ADDERS; i++) {
+        assert(pthread_create(&adders[i], NULL, graph_adder_thread, (void *)(intptr_t)i) == 0);
+    }
+    for (int i = 0; i < GRAPH_ADDERS; i++) {
+        pthread_join(adders[i], NULL);
+    }
+    graph_stage_t join_stage = {0, 0};
+    assert(task_graph_add_task(graph_shared, graph_stage_task, &join_stage, NULL, TASK_PRIORITY_NORMAL,
+                               &graph_added_ids[0][0], GRAPH_ADDERS * GRAPH_ADDS_PER_THREAD) != 0);
+    assert(task_graph_run(graph_shared) == 0);
+    assert(task_graph_wait(graph_shared, 5000) == 0);
+    for (int i = 0; i < GRAPH_ADDERS; i++) {
+        for (int j = 0; j < GRAPH_ADDS_PER_THREAD; j++) {
+            assert(graph_added_stages[i][j].runs == 1 && graph_added_stages[i][j].order < join_stage.order);
+        }
+    }
+    assert(task_graph_destroy(graph_shared) == 0);
+    graph_shared = NULL;
+    printf("测试通过: %d 个线程并发添加的任务都能作为前驱找到\n", GRAPH_ADDERS);
+
+    // 取消尚未提交的任务时一并取消其后继：gate -> child -> grandchild，sibling 独立
+    graph_stage_t gate_stage = {0, 0};
+    graph_stage_t sibling_stage = {0, 0};
+    graph_gate_open = 0;
+    graph_cancel_sum = 0;
+    graph_cancel_count = 0;
+    graph = task_graph_create(pool);
+    assert(graph != NULL);
+    task_id_t gate = task_graph_add_task(graph, graph_gate_task, &gate_stage, NULL, TASK_PRIORITY_NORMAL, NULL, 0);
+    task_id_t child = task_graph_add_task(graph, graph_unreachable_task, (void *)(uintptr_t)10, NULL,
+                                          TASK_PRIORITY_NORMAL, &gate, 1);
+    task_id_t grandchild = task_graph_add_task(graph, graph_unreachable_task, (void *)(uintptr_t)100, NULL,
+                                               TASK_PRIORITY_NORMAL, &child, 1);
+    assert(gate != 0 && child != 0 && grandchild != 0);
+    assert(task_graph_add_task(graph, graph_stage_task, &sibling_stage, NULL, TASK_PRIORITY_NORMAL, NULL, 0) != 0);
+    assert(task_graph_run(graph) == 0);
+    assert(task_graph_run(graph) == -1);
+    assert(task_graph_add_task(graph, graph_stage_task, NULL, NULL, TASK_PRIORITY_NORMAL, NULL, 0) == 0);
+    assert(task_graph_destroy(graph) == -1);
+    assert(task_graph_wait(graph, 20) == -1);
+    assert(task_graph_cancel_task(graph, child, graph_cancel_callback) == 0);
+    assert(graph_cancel_count == 2 && graph_cancel_sum == 110);
+    assert(task_graph_cancel_task(graph, grandchild, graph_cancel_callback) == -1);
+    __sync_fetch_and_add(&graph_gate_open, 1);
+    assert(task_graph_wait(graph, 5000) == 1);
+    assert(gate_stage.runs == 1 && sibling_stage.runs == 1);
+    assert(graph_cancel_count == 2);
+    assert(task_graph_destroy(graph) == 0);
+    printf("测试通过: 取消任务时其后继通过取消回调一并取消\n");
+
+    // 很长的依赖链整体取消，不受调用线程栈深度限制
+    enum { GRAPH_CHAIN_LENGTH = 200000 };
+    graph_stage_t chain_gate_stage = {0, 0};
+    graph_gate_open = 0;
+    graph_cancel_sum = 0;
+    graph_cancel_count = 0;
+    graph = task_graph_create(pool);
+    assert(graph != NULL);
+    task_id_t link = task_graph_add_task(graph, graph_gate_task, &chain_gate_stage, NULL, TASK_PRIORITY_NORMAL,
+                                         NULL, 0);
+    assert(link != 0);
+    task_id_t chain_head = 0;
+    for (int i = 0; i < GRAPH_CHAIN_LENGTH; i++) {
+        link = task_graph_add_task(graph, graph_unreachable_task, (void *)(uintptr_t)1, NULL, TASK_PRIORITY_NORMAL,
+                                   &link, 1);
+        assert(link != 0);
+        if (chain_head == 0) {
+            chain_head = link;
+        }
+    }
+    assert(task_graph_run(graph) == 0);
+    assert(task_graph_cancel_task(graph, chain_head, graph_cancel_callback) == 0);
+    assert(graph_cancel_count == GRAPH_CHAIN_LENGTH && graph_cancel_sum == GRAPH_CHAIN_LENGTH);
+    __sync_fetch_and_add(&graph_gate_open, 1);
+    assert(task_graph_wait(graph, 5000) == 1);
+    assert(chain_gate_stage.runs == 1);
+    assert(task_graph_destroy(graph) == 0);
+    printf("测试通过: 取消长度为 %d 的依赖链\n", GRAPH_CHAIN_LENGTH);
+    assert(thread_pool_destroy(pool) == 0);
+
+    // 对已在队列中的依赖图任务调用 thread_pool_cancel_task 同样取消其后继
+    pool = thread_pool_create(1);
+    assert(pool != NULL);
+    graph_stage_t blocker_stage = {0, 0};
+    graph_gate_open = 0;
+    graph_cancel_sum = 0;
+    graph_cancel_count = 0;
+    assert(thread_pool_add_task(pool, graph_gate_task, &blocker_stage, "graph_blocker", TASK_PRIORITY_NORMAL) != 0);
+    graph = task_graph_create(pool);
+    assert(graph != NULL);
+    task_id_t head = task_graph_add_task(graph, graph_unreachable_task, (void *)(uintptr_t)1, NULL,
+                                         TASK_PRIORITY_NORMAL, NULL, 0);
+    task_id_t tail = task_graph_add_task(graph, graph_unreachable_task, (void *)(uintptr_t)1000, NULL,
+                                         TASK_PRIORITY_NORMAL, &head, 1);
+    assert(head != 0 && tail != 0);
+    assert(task_graph_run(graph) == 0);
+    int is_running = 1;
+    assert(thread_pool_task_exists(pool, head, &is_running) == 1 && is_running == 0);
+    assert(thread_pool_cancel_task(pool, head, graph_cancel_callback) == 0);
+    assert(task_graph_wait(graph, 1000) == 1);
+    assert(graph_cancel_count == 2 && graph_cancel_sum == 1001);
+    __sync_fetch_and_add(&graph_gate_open, 1);
+    assert(task_graph_destroy(graph) == 0);
+    assert(thread_pool_destroy(pool) == 0);
+    assert(blocker_stage.runs == 1);
+    printf("测试通过: thread_pool_cancel_task 取消依赖图任务时其后继一并取消\n");
+
+    // 根任务未能提交 (名称与正在执行的任务重复) 时 task_graph_run 返回 -1，其余根任务照常执行
+    pool = thread_pool_create(2);
+    assert(pool != NULL);
+    blocker_stage.runs = 0;
+    graph_gate_open = 0;
+    assert(thread_pool_add_task(pool, graph_gate_task, &blocker_stage, "graph_blocker", TASK_PRIORITY_NORMAL) != 0);
+    graph = task_graph_create(pool);
+    assert(graph != NULL);
+    graph_stage_t root_stage = {0, 0};
+    head = task_graph_add_task(graph, graph_unreachable_task, NULL, "graph_blocker", TASK_PRIORITY_NORMAL, NULL, 0);
+    tail = task_graph_add_task(graph, graph_unreachable_task, NULL, NULL, TASK_PRIORITY_NORMAL, &head, 1);
+    assert(head != 0 && tail != 0);
+    assert(task_graph_add_task(graph, graph_stage_task, &root_stage, NULL, TASK_PRIORITY_NORMAL, NULL, 0) != 0);
+    assert(task_graph_run(graph) == -1);
+    assert(task_graph_wait(graph, 5000) == 1);
+    assert(root_stage.runs == 1);
+    __sync_fetch_and_add(&graph_gate_open, 1);
+    assert(task_graph_destroy(graph) == 0);
+    assert(thread_pool_destroy(pool) == 0);
+    assert(blocker_stage.runs == 1);
+    printf("测试通过: 根任务未能提交时 task_graph_run 返回 -1\n");
+    printf("任务依赖图测试通过\n");
+}
+
+// 并行循环测试用状态
+static int parallel_chunk_calls = 0;
+
+static void parallel_square_range(size_t begin, size_t end, void *ctx)
+{
+    unsigned int *values = (unsigned int *)ctx;
+    for (size_t i = begin; i < end; i++) {
+        values[i] = (unsigned int)(i * i);
+    }
+    __sync_fetch_and_add(&parallel_chunk_calls, 1);
+}
+
+static void parallel_sum_range(size_t begin, size_t end, void *accumulator, void *ctx)
+{
+    const unsigned int *values = (const unsigned int *)ctx;
+    unsigned long long *sum = (unsigned long long *)accumulator;
+    for (size_t i = begin; i < end; i++) {
+        *sum += values[i];
+    }
+}
+
+static void parallel_sum_combine(void *accumulator, const void *partial, void *ctx)
+{
+    (void)ctx;
+    *(unsigned long long *)accumulator += *(const unsigned long long *)partial;
+}
+
+typedef struct {
+    thread_pool_t pool;
+    unsigned int *values;
+    int outer_done;
+} parallel_nested_t;
+
+static void parallel_nested_task(void *arg)
+{
+    parallel_nested_t *nested = (parallel_nested_t *)arg;
+    // 在唯一的工作线程中嵌套调用：调用线程自己处理全部块，不会因等待辅助任务而死锁
+    assert(thread_pool_parallel_for(nested->pool, 0, 1000, 16, parallel_square_range, nested->values) == 0);
+    __sync_fetch_and_add(&nested->outer_done, 1);
+}
+
+// 测试 parallel_for / parallel_reduce：结果正确、块大小不小于 grain、空区间、嵌套调用
+static void test_parallel_for(void)
+{
+    printf("\n=== 测试并行循环与归约 ===\n");
+
+    enum { PARALLEL_COUNT = 100000 };
+    unsigned int *values = (unsigned int *)calloc(PARALLEL_COUNT, sizeof(unsigned int));
+    assert(values != NULL);
+    thread_pool_t pool = thread_pool_create(4);
+    assert(pool != NULL);
+    assert(thread_pool_parallel_for(NULL, 0, 10, 1, parallel_square_range, values) == -2);
+    assert(thread_pool_parallel_for(pool, 0, 10, 1, NULL, values) == -2);
+
+    parallel_chunk_calls = 0;
+    assert(thread_pool_parallel_for(pool, 0, PARALLEL_COUNT, 64, parallel_square_range, values) == 0);
+    for (size_t i = 0; i < PARALLEL_COUNT; i++) {
+        assert(values[i] == (unsigned int)(i * i));
+    }
+    // 4 个线程加调用线程，每个参与者约 4 块
+    assert(parallel_chunk_calls >= 5 && parallel_chunk_calls <= 20);
+    printf("测试通过: parallel_for 处理 %d 个下标，共 %d 块\n", PARALLEL_COUNT, parallel_chunk_calls);
+
+    parallel_chunk_calls = 0;
+    assert(thread_pool_parallel_for(pool, 0, 1000, 1000, parallel_square_range, values) == 0);
+    assert(parallel_chunk_calls == 1);
+    assert(thread_pool_parallel_for(pool, 5, 5, 1, parallel_square_range, values) == 0);
+    assert(parallel_chunk_calls == 1);
+    printf("测试通过: 块大小不小于 grain，空区间不调用处理函数\n");
+
+    unsigned long long expected = 0;
+    for (size_t i = 0; i < PARALLEL_COUNT; i++) {
+        expected += values[i];
+    }
+    unsigned long long identity = 0;
+    unsigned long long sum = 1;
+    assert(thread_pool_parallel_reduce(pool, 0, PARALLEL_COUNT, 1, parallel_sum_range, parallel_sum_combine,
+                                       &identity, sizeof(identity), &sum, values) == 0);
+    assert(sum == expected);
+    assert(thread_pool_parallel_reduce(pool, 3, 3, 1, parallel_sum_range, parallel_sum_combine, &identity,
+                                       sizeof(identity), &sum, values) == 0);
+    assert(sum == 0);
+    assert(thread_pool_parallel_reduce(pool, 0, 10, 1, parallel_sum_range, parallel_sum_combine, &identity, 0, &sum,
+                                       values) == -2);
+    printf("测试通过: parallel_reduce 结果为 %llu\n", expected);
+    assert(thread_pool_destroy(pool) == 0);
+
+    pool = thread_pool_create(1);
+    assert(pool != NULL);
+    parallel_nested_t nested = {pool, values, 0};
+    assert(thread_pool_add_task(pool, parallel_nested_task, &nested, "parallel_outer", TASK_PRIORITY_NORMAL) != 0);
+    test_wait_counter(&nested.outer_done, 1);
+    assert(nested.outer_done == 1);
+    assert(thread_pool_destroy(pool) == 0);
+    free(values);
+    printf("并行循环与归约测试通过\n");
+}
+
+// 匿名任务测试用状态
+static int anonymous_gate_open = 0;
+static int anonymous_runs = 0;
+
+static void anonymous_gate_task(void *arg)
+{
+    int *started = (int *)arg;
+    __sync_fetch_and_add(started, 1);
+    while (__sync_fetch_and_add(&anonymous_gate_open, 0) == 0) {
+        usleep(1000);
+    }
+}
+
+static void anonymous_count_task(void *arg)
+{
+    (void)arg;
+    __sync_fetch_and_add(&anonymous_runs, 1);
+}
+
+// 测试匿名任务：按ID查询和取消，不参与名称查找，运行时显示为 "[anonymous]"
+static void test_anonymous_tasks(void)
+{
+    printf("\n=== 测试匿名任务 ===\n");
+
+    enum { ANONYMOUS_COUNT = 64 };
+    assert(thread_pool_add_anonymous_task(NULL, anonymous_count_task, NULL, TASK_PRIORITY_NORMAL) == 0);
+    thread_pool_t pool = thread_pool_create(1);
+    assert(pool != NULL);
+    assert(thread_pool_add_anonymous_task(pool, NULL, NULL, TASK_PRIORITY_NORMAL) == 0);
+
+    int started = 0;
+    anonymous_gate_open = 0;
+    anonymous_runs = 0;
+    assert(thread_pool_add_task(pool, anonymous_gate_task, &started, "anonymous_gate", TASK_PRIORITY_NORMAL) != 0);
+    test_wait_counter(&started, 1);
+    assert(started == 1);
+
+    task_id_t ids[ANONYMOUS_COUNT];
+    for (int i = 0; i < ANONYMOUS_COUNT; i++) {
+        ids[i] = thread_pool_add_anonymous_task(pool, anonymous_count_task, NULL, TASK_PRIORITY_NORMAL);
+        assert(ids[i] != 0);
+        assert(i == 0 || ids[i] > ids[i - 1]);
+    }
+    int is_running = 1;
+    assert(thread_pool_task_exists(pool, ids[0], &is_running) == 1 && is_running == 0);
+
+    // 匿名任务不登记名称，既不能按显示名称也不能按自动生成的名称找到
+    char generated[MAX_TASK_NAME_LEN];
+    snprintf(generated, sizeof(generated), "unnamed_task_%lu", (unsigned long)ids[0]);
+    assert(thread_pool_find_task_by_name(pool, "[anonymous]", NULL) == 0);
+    assert(thread_pool_find_task_by_name(pool, generated, NULL) == 0);
+    assert(thread_pool_find_task_by_name(pool, "anonymous_gate", NULL) != 0);
+
+    assert(thread_pool_cancel_task(pool, ids[ANONYMOUS_COUNT / 2], NULL) == 0);
+    assert(thread_pool_cancel_task(pool, ids[ANONYMOUS_COUNT / 2], NULL) == -1);
+    assert(thread_pool_task_exists(pool, ids[ANONYMOUS_COUNT / 2], NULL) == 0);
+    printf("测试通过: 匿名任务可以按ID查询和取消，不参与名称查找\n");
+
+    __sync_fetch_and_add(&anonymous_gate_open, 1);
+    test_wait_counter(&anonymous_runs, ANONYMOUS_COUNT - 1);
+    assert(anonymous_runs == ANONYMOUS_COUNT - 1);
+    assert(thread_pool_task_exists(pool, ids[ANONYMOUS_COUNT - 1], NULL) == 0);
+
+    // 运行中的匿名任务显示为 "[anonymous]"
+    started = 0;
+    anonymous_gate_open = 0;
+    task_id_t running = thread_pool_add_anonymous_task(pool, anonymous_gate_task, &started, TASK_PRIORITY_HIGH);
+    assert(running != 0);
+    test_wait_counter(&started, 1);
+    char **names = thread_pool_get_running_task_names(pool);
+    assert(names != NULL);
+    assert(strcmp(names[0], "[anonymous]") == 0);
+    free_running_task_names(names, 1);
+    assert(thread_pool_task_exists(pool, running, &is_running) == 1 && is_running == 1);
+    assert(thread_pool_cancel_task(pool, running, NULL) == -1);
+    __sync_fetch_and_add(&anonymous_gate_open, 1);
+    assert(thread_pool_destroy(pool) == 0);
+    printf("测试通过: 运行中的匿名任务显示为 [anonymous]\n");
+    printf("匿名任务测试通过\n");
+}
+
+// 截止时间调度测试用状态
+static int deadline_gate_open = 0;
+static int deadline_order[16];
+static int deadline_order_count = 0;
+
+static void deadline_gate_task(void *arg)
+{
+    int *started = (int *)arg;
+    __sync_fetch_and_add(started, 1);
+    while (__sync_fetch_and_add(&deadline_gate_open, 0) == 0) {
+        usleep(1000);
+    }
+}
+
+static void deadline_record_task(void *arg)
+{
+    // 单线程线程池中任务依次执行，计数本身不会并发修改
+    int slot = __sync_fetch_and_add(&deadline_order_count, 1);
+    deadline_order[slot] = (int)(intptr_t)arg;
+}
+
+// 启动单线程线程池并用一个阻塞任务占住工作线程，使后续提交的任务全部排队
+static thread_pool_t deadline_blocked_pool(int aging_ms)
+{
+    thread_pool_config_t config;
+    thread_pool_config_init(&config, 1);
+    config.aging_ms = aging_ms;
+    thread_pool_t pool = thread_pool_create_with_config(&config);
+    assert(pool != NULL);
+    int started = 0;
+    deadline_gate_open = 0;
+    deadline_order_count = 0;
+    assert(thread_pool_add_task(pool, deadline_gate_task, &started, "deadline_gate", TASK_PRIORITY_HIGH) != 0);
+    test_wait_counter(&started, 1);
+    assert(started == 1);
+    return pool;
+}
+
+static void deadline_release_and_wait(thread_pool_t pool, int expected)
+{
+    __sync_fetch_and_add(&deadline_gate_open, 1);
+    test_wait_counter(&deadline_order_count, expected);
+    assert(thread_pool_destroy(pool) == 0);
+    assert(deadline_order_count == expected);
+}
+
+// 测试截止时间调度和优先级老化
+static void test_deadline_scheduling(void)
+{
+    printf("\n=== 测试截止时间调度与优先级老化 ===\n");
+
+    assert(thread_pool_add_task_with_deadline(NULL, deadline_record_task, NULL, NULL, TASK_PRIORITY_NORMAL, 10) ==
+           0);
+    thread_pool_config_t config;
+    thread_pool_config_init(&config, 1);
+    config.aging_ms = -1;
+    assert(thread_pool_create_with_config(&config) == NULL);
+
+    // 同一级别内带截止时间的任务按截止时间先后、先于该级别的其他任务执行，截止时间相同时先提交者优先；
+    // 更高级别的普通任务先于低级别带截止时间的任务执行
+    thread_pool_t pool = deadline_blocked_pool(0);
+    assert(thread_pool_add_task(pool, deadline_record_task, (void *)(intptr_t)4, NULL, TASK_PRIORITY_NORMAL) != 0);
+    assert(thread_pool_add_task_with_deadline(pool, deadline_record_task, (void *)(intptr_t)6, NULL,
+                                              TASK_PRIORITY_LOW, 300) != 0);
+    assert(thread_pool_add_task_with_deadline(pool, deadline_record_task, (void *)(intptr_t)5, NULL,
+                                              TASK_PRIORITY_LOW, 100) != 0);
+    task_id_t cancelled = thread_pool_add_task_with_deadline(pool, deadline_record_task, (void *)(intptr_t)99,
+                                                             NULL, TASK_PRIORITY_NORMAL, 50);
+    assert(cancelled != 0);
+    assert(thread_pool_add_task_with_deadline(pool, deadline_record_task, (void *)(intptr_t)2, "deadline_tie",
+                                              TASK_PRIORITY_NORMAL, 100) != 0);
+    assert(thread_pool_add_task_with_deadline(pool, deadline_record_task, (void *)(intptr_t)3, NULL,
+                                              TASK_PRIORITY_NORMAL, 100) != 0);
+    assert(thread_pool_add_task(pool, deadline_record_task, (void *)(intptr_t)1, NULL, TASK_PRIORITY_HIGH) != 0);
+    assert(thread_pool_find_task_by_name(pool, "deadline_tie", NULL) != 0);
+    assert(thread_pool_cancel_task(pool, cancelled, NULL) == 0);
+    deadline_release_and_wait(pool, 6);
+    for (int i = 0; i < 6; i++) {
+        assert(deadline_order[i] == i + 1);
+    }
+    printf("测试通过: 同一级别内带截止时间的任务按最早截止时间优先执行，高优先级任务不被低级别截止时间任务抢先\n");
+
+    // 未启用老化时后台任务排在所有普通任务之后
+    pool = deadline_blocked_pool(0);
+    assert(thread_pool_add_task(pool, deadline_record_task, (void *)(intptr_t)1, NULL, TASK_PRIORITY_BACKGROUND) != 0);
+    usleep(100000);
+    assert(thread_pool_add_task(pool, deadline_record_task, (void *)(intptr_t)2, NULL, TASK_PRIORITY_NORMAL) != 0);
+    assert(thread_pool_add_task(pool, deadline_record_task, (void *)(intptr_t)3, NULL, TASK_PRIORITY_NORMAL) != 0);
+    deadline_release_and_wait(pool, 3);
+    assert(deadline_order[0] == 2 && deadline_order[1] == 3 && deadline_order[2] == 1);
+
+    // 启用老化后等待足够久的后台任务被提升到普通任务之前
+    pool = deadline_blocked_pool(5);
+    assert(thread_pool_add_task(pool, deadline_record_task, (void *)(intptr_t)1, NULL, TASK_PRIORITY_BACKGROUND) != 0);
+    usleep(100000);
+    assert(thread_pool_add_task(pool, deadline_record_task, (void *)(intptr_t)2, NULL, TASK_PRIORITY_NORMAL) != 0);
+    assert(thread_pool_add_task(pool, deadline_record_task, (void *)(intptr_t)3, NULL, TASK_PRIORITY_NORMAL) != 0);
+    deadline_release_and_wait(pool, 3);
+    assert(deadline_order[0] == 1 && deadline_order[1] == 2 && deadline_order[2] == 3);
+    printf("测试通过: 老化使长时间等待的后台任务先于新提交的普通任务执行\n");
+
+    // 带截止时间的任务同样老化，不会被持续提交的更高级别任务饿死
+    pool = deadline_blocked_pool(5);
+    assert(thread_pool_add_task_with_deadline(pool, deadline_record_task, (void *)(intptr_t)1, NULL,
+                                              TASK_PRIORITY_BACKGROUND, 1000) != 0);
+    usleep(100000);
+    for (int i = 2; i <= 5; i++) {
+        assert(thread_pool_add_task(pool, deadline_record_task, (void *)(intptr_t)i, NULL, TASK_PRIORITY_NORMAL) != 0);
+    }
+    deadline_release_and_wait(pool, 5);
+    for (int i = 0; i < 5; i++) {
+        assert(deadline_order[i] == i + 1);
+    }
+    printf("测试通过: 老化使长时间等待的截止时间任务先于新提交的普通任务执行\n");
+    printf("截止时间调度与优先级老化测试通过\n");
+}
+
+// 协作取消测试用状态
+typedef struct {
+    thread_pool_t pool;
+    int children;       // 大于 0 时先在本线程池中提交这么多子任务
+    int started;
+    int saw_cancel;
+    int finished;
+    int until_discard;  // 非 0 时在第一次调用取消回调后结束，而不是等待取消请求
+} cooperative_task_t;
+
+static int cooperative_runs = 0;
+static int cooperative_cancel_count = 0;
+
+static void cooperative_count_task(void *arg)
+{
+    (void)arg;
+    __sync_fetch_and_add(&cooperative_runs, 1);
+}
+
+static void cooperative_cancel_callback(void *arg, task_id_t task_id)
+{
+    (void)arg;
+    (void)task_id;
+    __sync_fetch_and_add(&cooperative_cancel_count, 1);
+}
+
+// 反复检查取消标志，最多运行 5 秒
+static void cooperative_long_task(void *arg)
+{
+    cooperative_task_t *task = (cooperative_task_t *)arg;
+    for (int i = 0; i < task->children; i++) {
+        assert(thread_pool_add_task(task->pool, cooperative_count_task, NULL, NULL, TASK_PRIORITY_NORMAL) != 0);
+    }
+    __sync_fetch_and_add(&task->started, 1);
+    for (int loops = 0; loops < 5000; loops++) {
+        if (thread_pool_cancel_requested()) {
+            __sync_fetch_and_add(&task->saw_cancel, 1);
+            break;
+        }
+        if (task->until_discard && __sync_fetch_and_add(&cooperative_cancel_count, 0) > 0) {
+            break;
+        }
+        usleep(1000);
+    }
+    __sync_fetch_and_add(&task->finished, 1);
+}
+
+// 测试协作取消正在执行的任务和各销毁模式
+static void test_cooperative_cancel(void)
+{
+    printf("\n=== 测试协作取消与销毁模式 ===\n");
+
+    assert(thread_pool_cancel_requested() == 0);
+    assert(thread_pool_request_cancel(NULL, 1, NULL) == -2);
+
+    // 正在执行的任务收到取消请求后自行返回，排队中的任务直接移除
+    thread_pool_t pool = thread_pool_create(1);
+    assert(pool != NULL);
+    cooperative_task_t running = {pool, 0, 0, 0, 0, 0};
+    task_id_t running_id = thread_pool_add_task(pool, cooperative_long_task, &running, "cooperative_running",
+                                                TASK_PRIORITY_NORMAL);
+    assert(running_id != 0);
+    assert(test_wait_counter(&running.started, 1) == 1);
+    cooperative_cancel_count = 0;
+    cooperative_runs = 0;
+    task_id_t queued_id = thread_pool_add_task(pool, cooperative_count_task, NULL, NULL, TASK_PRIORITY_NORMAL);
+    assert(queued_id != 0);
+    assert(thread_pool_cancel_task(pool, running_id, NULL) == -1);
+    assert(thread_pool_request_cancel(pool, queued_id, cooperative_cancel_callback) == 0);
+    assert(cooperative_cancel_count == 1);
+    assert(thread_pool_request_cancel(pool, running_id, cooperative_cancel_callback) == 1);
+    assert(test_wait_counter(&running.finished, 1) == 1);
+    assert(running.saw_cancel == 1 && cooperative_cancel_count == 1);
+    assert(thread_pool_request_cancel(pool, queued_id, NULL) == -1);
+    assert(thread_pool_destroy_with_mode(pool, (thread_pool_destroy_mode_t)7, NULL) == -1);
+    assert(thread_pool_destroy(pool) == 0);
+    assert(cooperative_runs == 0);
+    printf("测试通过: 正在执行的任务响应取消请求，排队中的任务被直接取消\n");
+
+    // DISCARD_PENDING：排队任务不执行，逐个调用取消回调，正在执行的任务照常完成
+    enum { COOPERATIVE_BACKLOG = 2000 };
+    pool = thread_pool_create(1);
+    assert(pool != NULL);
+    // 阻塞任务在销毁丢弃排队任务之后才结束，避免工作线程提前执行积压的任务
+    cooperative_task_t blocker = {pool, 0, 0, 0, 0, 1};
+    cooperative_cancel_count = 0;
+    cooperative_runs = 0;
+    assert(thread_pool_add_task(pool, cooperative_long_task, &blocker, "cooperative_blocker", TASK_PRIORITY_NORMAL) != 0);
+    assert(test_wait_counter(&blocker.started, 1) == 1);
+    for (int i = 0; i < COOPERATIVE_BACKLOG; i++) {
+        assert(thread_pool_add_task(pool, cooperative_count_task, NULL, NULL, TASK_PRIORITY_NORMAL) != 0);
+    }
+    task_future_t future = thread_pool_add_task_with_future(pool, cooperative_count_task, NULL, NULL,
+                                                            TASK_PRIORITY_LOW);
+    assert(future != NULL);
+    assert(thread_pool_add_delayed_task(pool, cooperative_count_task, NULL, NULL, TASK_PRIORITY_NORMAL, 10000) != 0);
+    assert(thread_pool_destroy_with_mode(pool, THREAD_POOL_DESTROY_DISCARD_PENDING, cooperative_cancel_callback) ==
+           0);
+    assert(blocker.finished == 1);
+    assert(cooperative_runs == 0);
+    assert(cooperative_cancel_count == COOPERATIVE_BACKLOG + 2);
+    assert(task_future_get_state(future) == TASK_FUTURE_CANCELLED);
+    task_future_release(future);
+    printf("测试通过: DISCARD_PENDING 取消 %d 个排队任务而不执行\n", COOPERATIVE_BACKLOG + 2);
+
+    // CANCEL_RUNNING：正在执行的任务 (包括工作窃取本地队列中的子任务) 一并取消，关闭耗时与积压无关
+    thread_pool_config_t config;
+    thread_pool_config_init(&config, 1);
+    config.scheduler = THREAD_POOL_SCHED_WORK_STEALING;
+    pool = thread_pool_create_with_config(&config);
+    assert(pool != NULL);
+    cooperative_task_t parent = {pool, 16, 0, 0, 0, 0};
+    assert(thread_pool_add_task(pool, cooperative_long_task, &parent, "cooperative_parent", TASK_PRIORITY_NORMAL) != 0);
+    assert(test_wait_counter(&parent.started, 1) == 1);
+    cooperative_cancel_count = 0;
+    cooperative_runs = 0;
+    for (int i = 0; i < COOPERATIVE_BACKLOG; i++) {
+        assert(thread_pool_add_task(pool, cooperative_count_task, NULL, NULL, TASK_PRIORITY_NORMAL) != 0);
+    }
+    long long start_us = test_now_us();
+    assert(thread_pool_destroy_with_mode(pool, THREAD_POOL_DESTROY_CANCEL_RUNNING, cooperative_cancel_callback) == 0);
+    double elapsed_ms = (double)(test_now_us() - start_us) / 1000.0;
+    assert(parent.saw_cancel == 1 && parent.finished == 1);
+    assert(cooperative_runs == 0);
+    assert(cooperative_cancel_count == COOPERATIVE_BACKLOG + 16);
+    assert(elapsed_ms < 1000.0);
+    printf("测试通过: CANCEL_RUNNING 在 %.1f 毫秒内关闭线程池\n", elapsed_ms);
+    printf("协作取消与销毁模式测试通过\n");
+}
+
 int main(void)
 {
     printf("======================================\n");
@@ -231,6 +2152,56 @@ int main(void)
         test_error_handling();
     }
 
+    if (!g_alarm_received) {
+        test_task_slab_reuse();
+    }
+
+    if (!g_alarm_received) {
+        test_batch_submission();
+    }
+    if (!g_alarm_received) {
+        test_work_stealing();
+    }
+    if (!g_alarm_received) {
+        test_idle_parking();
+    }
+    if (!g_alarm_received) {
+        test_worker_slot_reuse();
+    }
+    if (!g_alarm_received) {
+        test_snapshot();
+    }
+    if (!g_alarm_received) {
+        test_latency_stats();
+    }
+    if (!g_alarm_received) {
+        test_trace_events();
+    }
+    if (!g_alarm_received) {
+        test_worker_placement();
+    }
+    if (!g_alarm_received) {
+        test_bounded_queue();
+    }
+    if (!g_alarm_received) {
+        test_timer_tasks();
+    }
+    if (!g_alarm_received) {
+        test_task_graph();
+    }
+    if (!g_alarm_received) {
+        test_parallel_for();
+    }
+    if (!g_alarm_received) {
+        test_anonymous_tasks();
+    }
+    if (!g_alarm_received) {
+        test_deadline_scheduling();
+    }
+    if (!g_alarm_received) {
+        test_cooperative_cancel();
+    }
+
     printf("\n======================================\n");
     printf("=== 线程池单元测试已完成并退出 ===\n");
     printf("======================================\n");
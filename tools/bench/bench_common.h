@@ -0,0 +1,233 @@
+/**
+ * @file bench_common.h
+ * @brief 基准测试程序共用的计时、参数解析和结果输出。
+ *
+ * 每条结果输出为一行 CSV 或 JSON 数组中的一个对象，字段为
+ * suite, benchmark, params, metric, value, unit, arch, cpus。
+ * params 以 `key=value;key=value` 的形式记录本次测量的参数，
+ * arch 和 cpus 用于合并比较不同平台 (例如 MIPS 与 x86) 的结果。
+ * 进度信息输出到 stderr，不影响结果文件。
+ */
+#ifndef CROLINKIT_BENCH_COMMON_H
+#define CROLINKIT_BENCH_COMMON_H
+
+#include <stdarg.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/utsname.h>
+#include <time.h>
+#include <unistd.h>
+
+/**
+ * @enum bench_format_t
+ * @brief 结果输出格式。
+ */
+typedef enum {
+    BENCH_FORMAT_CSV = 0, /**< 每条结果一行，首行为表头。 */
+    BENCH_FORMAT_JSON = 1 /**< 一个包含运行环境和结果数组的 JSON 对象。 */
+} bench_format_t;
+
+/**
+ * @struct bench_context_t
+ * @brief 一次基准测试运行的输出状态和通用选项。
+ */
+typedef struct {
+    const char *suite;     /**< 套件名称 ("thread" 或 "log")。 */
+    bench_format_t format; /**< 输出格式。 */
+    FILE *out;             /**< 结果输出流。 */
+    int quick;             /**< 非 0 时缩小各项规模，用于快速冒烟运行。 */
+    int max_threads;       /**< 扩展性测试的最大线程数，默认为在线 CPU 数量。 */
+    int results;           /**< 已输出的结果数量。 */
+    char arch[80];         /**< uname 报告的机器类型。 */
+    int cpus;              /**< 在线 CPU 数量。 */
+} bench_context_t;
+
+/**
+ * @brief 单调时钟的当前时间 (纳秒)。
+ */
+static inline uint64_t bench_now_ns(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ULL + (uint64_t)ts.tv_nsec;
+}
+
+/**
+ * @brief 休眠指定的微秒数。
+ */
+static inline void bench_sleep_us(long us)
+{
+    struct timespec ts = {us / 1000000, (us % 1000000) * 1000};
+    nanosleep(&ts, NULL);
+}
+
+/**
+ * @brief 扩展性测试的下一个线程数：按 2 的幂递增，最后一项为上限本身。
+ */
+static inline int bench_next_scale(int n, int max)
+{
+    return n < max && n * 2 > max ? max : n * 2;
+}
+
+/**
+ * @brief 打印用法说明。
+ */
+static inline void bench_usage(const char *prog)
+{
+    fprintf(stderr,
+            "用法: %s [--format csv|json] [--output FILE] [--threads N] [--quick]\n"
+            "  --format   结果格式，默认为 csv\n"
+            "  --output   结果写入文件，默认为标准输出\n"
+            "  --threads  扩展性测试的最大线程数，默认为在线 CPU 数量\n"
+            "  --quick    缩小测试规模，用于快速检查\n",
+            prog);
+}
+
+/**
+ * @brief 解析命令行并打开输出。
+ *
+ * @return 成功返回 0，参数无效或无法打开输出文件返回 -1。
+ */
+static inline int bench_init(bench_context_t *ctx, const char *suite, int argc, char **argv)
+{
+    memset(ctx, 0, sizeof(*ctx));
+    ctx->suite = suite;
+    ctx->out = stdout;
+    long cpus = sysconf(_SC_NPROCESSORS_ONLN);
+    ctx->cpus = cpus > 0 ? (int)cpus : 1;
+    ctx->max_threads = ctx->cpus;
+
+    const char *output = NULL;
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--format") == 0 && i + 1 < argc) {
+            const char *format = argv[++i];
+            if (strcmp(format, "csv") == 0) {
+                ctx->format = BENCH_FORMAT_CSV;
+            } else if (strcmp(format, "json") == 0) {
+                ctx->format = BENCH_FORMAT_JSON;
+            } else {
+                bench_usage(argv[0]);
+                return -1;
+            }
+        } else if (strcmp(argv[i], "--output") == 0 && i + 1 < argc) {
+            output = argv[++i];
+        } else if (strcmp(argv[i], "--threads") == 0 && i + 1 < argc) {
+            ctx->max_threads = atoi(argv[++i]);
+            if (ctx->max_threads <= 0) {
+                bench_usage(argv[0]);
+                return -1;
+            }
+        } else if (strcmp(argv[i], "--quick") == 0) {
+            ctx->quick = 1;
+        } else {
+            bench_usage(argv[0]);
+            return -1;
+        }
+    }
+
+    struct utsname uts;
+    snprintf(ctx->arch, sizeof(ctx->arch), "%s", uname(&uts) == 0 ? uts.machine : "unknown");
+
+    if (output != NULL) {
+        ctx->out = fopen(output, "w");
+        if (ctx->out == NULL) {
+            fprintf(stderr, "无法打开输出文件: %s\n", output);
+            return -1;
+        }
+    }
+
+    if (ctx->format == BENCH_FORMAT_CSV) {
+        fprintf(ctx->out, "suite,benchmark,params,metric,value,unit,arch,cpus\n");
+    } else {
+        fprintf(ctx->out, "{\n  \"suite\": \"%s\",\n  \"arch\": \"%s\",\n  \"cpus\": %d,\n", suite, ctx->arch,
+                ctx->cpus);
+#ifdef __VERSION__
+        fprintf(ctx->out, "  \"compiler\": \"%s\",\n", __VERSION__);
+#endif
+        fprintf(ctx->out, "  \"results\": [");
+    }
+    return 0;
+}
+
+/**
+ * @brief 输出一条结果。
+ *
+ * @param benchmark 测试项名称。
+ * @param params 本次测量的参数，形如 `workers=4;producers=2`，可以为空字符串。
+ * @param metric 指标名称。
+ * @param value 指标数值。
+ * @param unit 指标单位。
+ */
+static inline void bench_report(bench_context_t *ctx, const char *benchmark, const char *params, const char *metric,
+                                double value, const char *unit)
+{
+    if (ctx->format == BENCH_FORMAT_CSV) {
+        fprintf(ctx->out, "%s,%s,%s,%s,%.3f,%s,%s,%d\n", ctx->suite, benchmark, params, metric, value, unit,
+                ctx->arch, ctx->cpus);
+    } else {
+        fprintf(ctx->out,
+                "%s\n    {\"benchmark\": \"%s\", \"params\": \"%s\", \"metric\": \"%s\", \"value\": %.3f, "
+                "\"unit\": \"%s\"}",
+                ctx->results > 0 ? "," : "", benchmark, params, metric, value, unit);
+    }
+    fflush(ctx->out);
+    ctx->results++;
+}
+
+/**
+ * @brief 结束输出并关闭输出文件。
+ */
+static inline void bench_finish(bench_context_t *ctx)
+{
+    if (ctx->format == BENCH_FORMAT_JSON) {
+        fprintf(ctx->out, "\n  ]\n}\n");
+    }
+    if (ctx->out != stdout) {
+        fclose(ctx->out);
+    }
+    ctx->out = NULL;
+}
+
+/**
+ * @brief 输出进度信息到 stderr。
+ */
+static inline void bench_progress(const char *fmt, ...)
+{
+    va_list args;
+    va_start(args, fmt);
+    vfprintf(stderr, fmt, args);
+    va_end(args);
+    fputc('\n', stderr);
+}
+
+/**
+ * @brief qsort 使用的 uint64_t 比较函数。
+ */
+static inline int bench_compare_u64(const void *a, const void *b)
+{
+    uint64_t x = *(const uint64_t *)a;
+    uint64_t y = *(const uint64_t *)b;
+    return x < y ? -1 : (x > y);
+}
+
+/**
+ * @brief 已排序样本的百分位数 (最近秩法)。
+ */
+static inline uint64_t bench_percentile(const uint64_t *sorted, size_t count, double percent)
+{
+    if (count == 0) {
+        return 0;
+    }
+    size_t rank = (size_t)(percent / 100.0 * (double)count + 0.5);
+    if (rank == 0) {
+        rank = 1;
+    }
+    if (rank > count) {
+        rank = count;
+    }
+    return sorted[rank - 1];
+}
+
+#endif /* CROLINKIT_BENCH_COMMON_H */
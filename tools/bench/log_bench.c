@@ -0,0 +1,323 @@
+/**
+ * @file log_bench.c
+ * @brief 日志模块基准测试。
+ *
+ * 测试项：
+ * - filtered: 级别未启用时 log_write 的调用开销
+ * - write: 关闭控制台输出时 log_write 的吞吐量，分别测量不输出到文件 (只格式化)、输出到文件
+ *   和使用 64KB 缓冲区只在 ERROR 时立即刷新 (buffered=1)
+ * - threads: 1..N 个线程同时写文件时的总吞吐量
+ * - module_sinks: CORE 和 THREAD 模块各一个线程同时写日志，共用一个文件 (sinks=1) 与 THREAD 挂接专用文件
+ *   (sinks=2) 时的总吞吐量
+ * - rotate: 按大小轮转开启时写文件的吞吐量，包含轮转本身的开销
+ * - async_write / async_threads: 异步模式下生产者一侧的吞吐量，停用时输出剩余日志的耗时计入 async_drain
+ * - context_write: log_write_with_context 显式提供上下文时写入 64KB 缓冲文件的吞吐量，与 buffered=1 的文本写入对比
+ * - suppressed: LOG_RATELIMITED 令牌耗尽后被丢弃的调用开销，以及开启重复日志折叠时同一条日志被折叠的开销
+ * - binary_write: 二进制日志 (LOG_BIN_INFO) 写入 64KB 缓冲文件的吞吐量，与 buffered=1 的文本写入对比
+ *
+ * 日志文件写入当前目录下的 log_bench.log、log_bench_thread.log 和 log_bench.bin，测试结束后连同轮转产生的备份一起删除。
+ */
+#define _POSIX_C_SOURCE 200809L
+#include "bench_common.h"
+#include "log.h"
+#include <pthread.h>
+
+/** 日志文件路径。 */
+#define LOG_BENCH_FILE "log_bench.log"
+
+/** module_sinks 测试中 THREAD 模块专用日志文件的路径。 */
+#define LOG_BENCH_SINK_FILE "log_bench_thread.log"
+
+/** 二进制日志文件路径。 */
+#define LOG_BENCH_BINARY_FILE "log_bench.bin"
+
+/** rotate 测试的单个文件大小上限和保留的文件数量。 */
+#define LOG_BENCH_ROTATE_SIZE (64 * 1024)
+#define LOG_BENCH_ROTATE_COUNT 3
+
+/**
+ * @brief 写入指定数量的典型日志行。
+ */
+static void write_messages(long count, log_level_t level, log_module_t module)
+{
+    for (long i = 0; i < count; i++) {
+        log_write(level, module, __FILE__, __LINE__, __func__, "bench message %ld value=%d name=%s", i,
+                  (int)(i & 0xffff), "payload");
+    }
+}
+
+/**
+ * @brief 通过 LOG_BIN_INFO 写入指定数量的日志，参数与 write_messages 相同。
+ */
+static void write_binary_messages(long count)
+{
+    for (long i = 0; i < count; i++) {
+        LOG_BIN_INFO(LOG_MODULE_CORE, "bench message %ld value=%d name=%s", i, (int)(i & 0xffff), "payload");
+    }
+}
+
+/**
+ * @brief 通过 log_write_with_context 写入指定数量的日志，参数与 write_messages 相同。
+ */
+static void write_context_messages(long count)
+{
+    log_context_t context = {.context_id = "req-1234", .session_id = "sess-42", .user_id = NULL,
+                             .transaction_id = "txn-7"};
+    for (long i = 0; i < count; i++) {
+        log_write_with_context(LOG_LEVEL_INFO, LOG_MODULE_CORE, &context, __FILE__, __LINE__, __func__,
+                               "bench message %ld value=%d name=%s", i, (int)(i & 0xffff), "payload");
+    }
+}
+
+/**
+ * @brief 通过 LOG_RATELIMITED 写入指定数量的日志，令牌耗尽后的调用全部被丢弃。
+ */
+static void write_ratelimited_messages(long count)
+{
+    for (long i = 0; i < count; i++) {
+        LOG_RATELIMITED(LOG_LEVEL_INFO, LOG_MODULE_CORE, 10, 10, "bench message %ld value=%d name=%s", i,
+                        (int)(i & 0xffff), "payload");
+    }
+}
+
+/**
+ * @brief 写入指定数量的同一条日志，开启折叠时除第一条外都被折叠。
+ */
+static void write_duplicate_messages(long count)
+{
+    for (long i = 0; i < count; i++) {
+        LOG_ERROR(LOG_MODULE_CORE, "bench device timeout name=%s", "payload");
+    }
+}
+
+/**
+ * @brief 测量单线程写入指定数量日志行的速率并输出结果。
+ */
+static void measure_single(bench_context_t *ctx, const char *benchmark, const char *params, long count,
+                           log_level_t level)
+{
+    uint64_t start = bench_now_ns();
+    write_messages(count, level, LOG_MODULE_CORE);
+    uint64_t elapsed = bench_now_ns() - start;
+    bench_report(ctx, benchmark, params, "rate", (double)count * 1e9 / (double)elapsed, "msgs/s");
+    bench_report(ctx, benchmark, params, "cost", (double)elapsed / (double)count, "ns/msg");
+}
+
+typedef struct {
+    long count;
+    log_module_t module;
+    pthread_barrier_t *barrier;
+} writer_arg_t;
+
+static void *writer_main(void *arg)
+{
+    writer_arg_t *writer = (writer_arg_t *)arg;
+    pthread_barrier_wait(writer->barrier);
+    write_messages(writer->count, LOG_LEVEL_INFO, writer->module);
+    return NULL;
+}
+
+static void bench_threads(bench_context_t *ctx, const char *benchmark, long total)
+{
+    char params[64];
+    for (int threads = 1; threads <= ctx->max_threads; threads = bench_next_scale(threads, ctx->max_threads)) {
+        pthread_t *tids = (pthread_t *)malloc((size_t)threads * sizeof(pthread_t));
+        writer_arg_t *args = (writer_arg_t *)malloc((size_t)threads * sizeof(writer_arg_t));
+        if (tids == NULL || args == NULL) {
+            free(tids);
+            free(args);
+            return;
+        }
+        pthread_barrier_t barrier;
+        pthread_barrier_init(&barrier, NULL, (unsigned)threads + 1);
+        long per_thread = total / threads;
+        for (int t = 0; t < threads; t++) {
+            args[t].count = per_thread;
+            args[t].module = LOG_MODULE_CORE;
+            args[t].barrier = &barrier;
+            pthread_create(&tids[t], NULL, writer_main, &args[t]);
+        }
+        pthread_barrier_wait(&barrier);
+        uint64_t start = bench_now_ns();
+        for (int t = 0; t < threads; t++) {
+            pthread_join(tids[t], NULL);
+        }
+        uint64_t elapsed = bench_now_ns() - start;
+        pthread_barrier_destroy(&barrier);
+        free(tids);
+        free(args);
+
+        snprintf(params, sizeof(params), "threads=%d;console=0;file=1;msgs=%ld", threads, per_thread * threads);
+        bench_report(ctx, benchmark, params, "rate", (double)(per_thread * threads) * 1e9 / (double)elapsed,
+                     "msgs/s");
+    }
+}
+
+/**
+ * @brief CORE 和 THREAD 模块各一个线程同时写日志，测量总吞吐量。
+ */
+static void bench_module_sinks(bench_context_t *ctx, long total, int sinks)
+{
+    char params[64];
+    pthread_t tids[2];
+    writer_arg_t args[2];
+    pthread_barrier_t barrier;
+    pthread_barrier_init(&barrier, NULL, 3);
+    for (int t = 0; t < 2; t++) {
+        args[t].count = total / 2;
+        args[t].module = t == 0 ? LOG_MODULE_CORE : LOG_MODULE_THREAD;
+        args[t].barrier = &barrier;
+        pthread_create(&tids[t], NULL, writer_main, &args[t]);
+    }
+    pthread_barrier_wait(&barrier);
+    uint64_t start = bench_now_ns();
+    for (int t = 0; t < 2; t++) {
+        pthread_join(tids[t], NULL);
+    }
+    uint64_t elapsed = bench_now_ns() - start;
+    pthread_barrier_destroy(&barrier);
+
+    snprintf(params, sizeof(params), "threads=2;sinks=%d;msgs=%ld", sinks, total / 2 * 2);
+    bench_report(ctx, "module_sinks", params, "rate", (double)(total / 2 * 2) * 1e9 / (double)elapsed, "msgs/s");
+}
+
+int main(int argc, char **argv)
+{
+    bench_context_t ctx;
+    if (bench_init(&ctx, "log", argc, argv) != 0) {
+        return 1;
+    }
+    const long count = ctx.quick ? 20000 : 200000;
+    char params[64];
+
+    unlink(LOG_BENCH_FILE);
+    // 以 WARN 级别初始化，初始化日志不会混入标准输出中的结果
+    if (log_init(LOG_BENCH_FILE, LOG_LEVEL_WARN) != 0) {
+        bench_progress("log_init 失败");
+        bench_finish(&ctx);
+        return 1;
+    }
+    // 按大小轮转会产生额外的文件，测量期间关闭
+    log_rotation_config_t rotation;
+    log_get_rotation_config(&rotation);
+    rotation.rotate_on_size = false;
+    rotation.rotate_on_time = false;
+    log_set_rotation_config(&rotation);
+    for (int module = 0; module < LOG_MODULE_MAX; module++) {
+        log_set_module_output((log_module_t)module, false, true);
+    }
+    log_set_module_level(LOG_MODULE_CORE, LOG_LEVEL_INFO);
+    log_set_module_level(LOG_MODULE_THREAD, LOG_LEVEL_INFO);
+
+    bench_progress("filtered...");
+    snprintf(params, sizeof(params), "level=DEBUG;enabled=INFO;msgs=%ld", count * 10);
+    measure_single(&ctx, "filtered", params, count * 10, LOG_LEVEL_DEBUG);
+
+    bench_progress("write...");
+    log_set_module_output(LOG_MODULE_CORE, false, false);
+    snprintf(params, sizeof(params), "console=0;file=0;msgs=%ld", count);
+    measure_single(&ctx, "write", params, count, LOG_LEVEL_INFO);
+
+    log_set_module_output(LOG_MODULE_CORE, false, true);
+    snprintf(params, sizeof(params), "console=0;file=1;msgs=%ld", count);
+    measure_single(&ctx, "write", params, count, LOG_LEVEL_INFO);
+
+    log_flush_policy_t policy;
+    log_flush_policy_init(&policy);
+    policy.buffer_size = 64 * 1024;
+    policy.flush_bytes = 64 * 1024;
+    log_set_flush_policy(&policy);
+    snprintf(params, sizeof(params), "console=0;file=1;buffered=1;msgs=%ld", count);
+    measure_single(&ctx, "write", params, count, LOG_LEVEL_INFO);
+
+    bench_progress("context...");
+    {
+        uint64_t start = bench_now_ns();
+        write_context_messages(count);
+        uint64_t elapsed = bench_now_ns() - start;
+        snprintf(params, sizeof(params), "console=0;file=1;buffered=1;msgs=%ld", count);
+        bench_report(&ctx, "context_write", params, "rate", (double)count * 1e9 / (double)elapsed, "msgs/s");
+        bench_report(&ctx, "context_write", params, "cost", (double)elapsed / (double)count, "ns/msg");
+    }
+
+    bench_progress("suppressed...");
+    {
+        uint64_t start = bench_now_ns();
+        write_ratelimited_messages(count);
+        uint64_t elapsed = bench_now_ns() - start;
+        snprintf(params, sizeof(params), "kind=ratelimited;msgs=%ld", count);
+        bench_report(&ctx, "suppressed", params, "cost", (double)elapsed / (double)count, "ns/msg");
+
+        log_set_dedup(true, 0);
+        start = bench_now_ns();
+        write_duplicate_messages(count);
+        elapsed = bench_now_ns() - start;
+        log_set_dedup(false, 0);
+        snprintf(params, sizeof(params), "kind=dedup;msgs=%ld", count);
+        bench_report(&ctx, "suppressed", params, "cost", (double)elapsed / (double)count, "ns/msg");
+    }
+
+    bench_progress("binary...");
+    unlink(LOG_BENCH_BINARY_FILE);
+    if (log_binary_open(LOG_BENCH_BINARY_FILE) == 0) {
+        log_set_module_binary(LOG_MODULE_CORE, true);
+        uint64_t start = bench_now_ns();
+        write_binary_messages(count);
+        uint64_t elapsed = bench_now_ns() - start;
+        snprintf(params, sizeof(params), "file=1;buffered=1;msgs=%ld", count);
+        bench_report(&ctx, "binary_write", params, "rate", (double)count * 1e9 / (double)elapsed, "msgs/s");
+        bench_report(&ctx, "binary_write", params, "cost", (double)elapsed / (double)count, "ns/msg");
+        log_set_module_binary(LOG_MODULE_CORE, false);
+        log_binary_close();
+    }
+    unlink(LOG_BENCH_BINARY_FILE);
+    log_flush_policy_init(&policy);
+    log_set_flush_policy(&policy);
+
+    bench_progress("threads...");
+    bench_threads(&ctx, "threads", count);
+
+    bench_progress("module sinks...");
+    bench_module_sinks(&ctx, count, 1);
+    unlink(LOG_BENCH_SINK_FILE);
+    if (log_attach_module_sink(LOG_MODULE_THREAD, LOG_BENCH_SINK_FILE) == 0) {
+        bench_module_sinks(&ctx, count, 2);
+        log_detach_module_sink(LOG_MODULE_THREAD);
+    }
+    unlink(LOG_BENCH_SINK_FILE);
+
+    bench_progress("rotate...");
+    rotation.rotate_on_size = true;
+    rotation.max_file_size = LOG_BENCH_ROTATE_SIZE;
+    rotation.max_file_count = LOG_BENCH_ROTATE_COUNT;
+    log_set_rotation_config(&rotation);
+    snprintf(params, sizeof(params), "console=0;file=1;msgs=%ld;max_size=%d", count, LOG_BENCH_ROTATE_SIZE);
+    measure_single(&ctx, "rotate", params, count, LOG_LEVEL_INFO);
+    rotation.rotate_on_size = false;
+    log_set_rotation_config(&rotation);
+
+    bench_progress("async...");
+    log_async_config_t async_config;
+    log_async_config_init(&async_config);
+    async_config.queue_capacity = 4096;
+    if (log_enable_async(&async_config) == 0) {
+        snprintf(params, sizeof(params), "console=0;file=1;msgs=%ld;capacity=%zu", count,
+                 async_config.queue_capacity);
+        measure_single(&ctx, "async_write", params, count, LOG_LEVEL_INFO);
+        bench_threads(&ctx, "async_threads", count);
+        uint64_t start = bench_now_ns();
+        log_disable_async();
+        snprintf(params, sizeof(params), "capacity=%zu", async_config.queue_capacity);
+        bench_report(&ctx, "async_drain", params, "disable", (double)(bench_now_ns() - start) / 1e3, "us");
+    }
+
+    log_deinit();
+    unlink(LOG_BENCH_FILE);
+    for (int i = 1; i < LOG_BENCH_ROTATE_COUNT; i++) {
+        char backup[64];
+        snprintf(backup, sizeof(backup), "%s.%d", LOG_BENCH_FILE, i);
+        unlink(backup);
+    }
+    bench_finish(&ctx);
+    return 0;
+}
@@ -0,0 +1,421 @@
+/**
+ * @file thread_bench.c
+ * @brief 线程池基准测试。
+ *
+ * 测试项：
+ * - submit_throughput: 单个提交者提交空任务的吞吐量 (匿名任务与命名任务)
+ * - submit_to_start: 空闲线程池中从提交到任务开始执行的延迟分布
+ * - scaling: 1..N 个提交者与 1..N 个工作线程组合下的端到端吞吐量
+ * - queue_depth: 不同排队深度下 thread_pool_task_exists 和 thread_pool_cancel_task 的单次耗时
+ * - burst: thread_pool_resize 的耗时，以及自动调整对突发负载的反应时间
+ */
+#define _POSIX_C_SOURCE 200809L
+#include "bench_common.h"
+#include "log.h"
+#include "thread.h"
+#include <pthread.h>
+#include <sched.h>
+#include <stdatomic.h>
+
+/** 所有已提交的空任务共用的完成计数。 */
+static atomic_long g_completed;
+
+/**
+ * @brief 空任务，只增加完成计数。
+ */
+static void empty_task(void *arg)
+{
+    (void)arg;
+    atomic_fetch_add_explicit(&g_completed, 1, memory_order_relaxed);
+}
+
+/**
+ * @brief 等待完成计数达到目标值。
+ */
+static void wait_completed(long target)
+{
+    while (atomic_load_explicit(&g_completed, memory_order_acquire) < target) {
+        sched_yield();
+    }
+}
+
+/**
+ * @brief 创建使用默认选项和指定空闲自旋时间的线程池。
+ */
+static thread_pool_t create_pool(int threads, int idle_spin_us)
+{
+    thread_pool_config_t config;
+    thread_pool_config_init(&config, threads);
+    config.idle_spin_us = idle_spin_us;
+    return thread_pool_create_with_config(&config);
+}
+
+/* ---- submit_throughput ---- */
+
+static void bench_submit_throughput(bench_context_t *ctx)
+{
+    const long count = ctx->quick ? 20000 : 200000;
+    const int workers = ctx->max_threads;
+    char params[64];
+
+    for (int named = 0; named <= 1; named++) {
+        thread_pool_t pool = create_pool(workers, 0);
+        if (pool == NULL) {
+            bench_progress("submit_throughput: 创建线程池失败");
+            return;
+        }
+        atomic_store(&g_completed, 0);
+
+        uint64_t start = bench_now_ns();
+        for (long i = 0; i < count; i++) {
+            if (named) {
+                thread_pool_add_task(pool, empty_task, NULL, NULL, TASK_PRIORITY_NORMAL);
+            } else {
+                thread_pool_add_anonymous_task(pool, empty_task, NULL, TASK_PRIORITY_NORMAL);
+            }
+        }
+        uint64_t submitted = bench_now_ns();
+        wait_completed(count);
+        uint64_t finished = bench_now_ns();
+        thread_pool_destroy(pool);
+
+        snprintf(params, sizeof(params), "workers=%d;tasks=%ld;named=%d", workers, count, named);
+        bench_report(ctx, "submit_throughput", params, "submit_rate", (double)count * 1e9 / (double)(submitted - start),
+                     "ops/s");
+        bench_report(ctx, "submit_throughput", params, "submit_cost", (double)(submitted - start) / (double)count,
+                     "ns/op");
+        bench_report(ctx, "submit_throughput", params, "complete_rate",
+                     (double)count * 1e9 / (double)(finished - start), "ops/s");
+    }
+}
+
+/* ---- submit_to_start ---- */
+
+/** 任务开始执行的时间，由被测任务写入。 */
+static _Atomic uint64_t g_started_ns;
+
+static void stamp_task(void *arg)
+{
+    (void)arg;
+    atomic_store_explicit(&g_started_ns, bench_now_ns(), memory_order_release);
+}
+
+static void bench_submit_to_start(bench_context_t *ctx)
+{
+    const int samples = ctx->quick ? 200 : 2000;
+    const int spins[] = {0, 100};
+    uint64_t *latency = (uint64_t *)malloc((size_t)samples * sizeof(uint64_t));
+    if (latency == NULL) {
+        return;
+    }
+    char params[64];
+
+    for (size_t s = 0; s < sizeof(spins) / sizeof(spins[0]); s++) {
+        thread_pool_t pool = create_pool(1, spins[s]);
+        if (pool == NULL) {
+            break;
+        }
+        for (int i = 0; i < samples; i++) {
+            // 等工作线程回到空闲状态，测量的是唤醒空闲线程的延迟
+            bench_sleep_us(spins[s] > 0 ? 20 : 200);
+            atomic_store_explicit(&g_started_ns, 0, memory_order_relaxed);
+            uint64_t submit = bench_now_ns();
+            thread_pool_add_anonymous_task(pool, stamp_task, NULL, TASK_PRIORITY_NORMAL);
+            uint64_t started;
+            while ((started = atomic_load_explicit(&g_started_ns, memory_order_acquire)) == 0) {
+                sched_yield();
+            }
+            latency[i] = started - submit;
+        }
+        thread_pool_destroy(pool);
+
+        qsort(latency, (size_t)samples, sizeof(uint64_t), bench_compare_u64);
+        snprintf(params, sizeof(params), "workers=1;idle_spin_us=%d;samples=%d", spins[s], samples);
+        bench_report(ctx, "submit_to_start", params, "p50", (double)bench_percentile(latency, samples, 50), "ns");
+        bench_report(ctx, "submit_to_start", params, "p99", (double)bench_percentile(latency, samples, 99), "ns");
+        bench_report(ctx, "submit_to_start", params, "max", (double)latency[samples - 1], "ns");
+    }
+    free(latency);
+}
+
+/* ---- scaling ---- */
+
+typedef struct {
+    thread_pool_t pool;
+    long count;
+    pthread_barrier_t *barrier;
+} producer_arg_t;
+
+static void *producer_main(void *arg)
+{
+    producer_arg_t *producer = (producer_arg_t *)arg;
+    pthread_barrier_wait(producer->barrier);
+    for (long i = 0; i < producer->count; i++) {
+        thread_pool_add_anonymous_task(producer->pool, empty_task, NULL, TASK_PRIORITY_NORMAL);
+    }
+    return NULL;
+}
+
+static void bench_scaling(bench_context_t *ctx)
+{
+    const long total = ctx->quick ? 20000 : 200000;
+    char params[96];
+
+    for (int workers = 1; workers <= ctx->max_threads; workers = bench_next_scale(workers, ctx->max_threads)) {
+        for (int producers = 1; producers <= ctx->max_threads;
+             producers = bench_next_scale(producers, ctx->max_threads)) {
+            thread_pool_t pool = create_pool(workers, 0);
+            if (pool == NULL) {
+                return;
+            }
+            pthread_t *threads = (pthread_t *)malloc((size_t)producers * sizeof(pthread_t));
+            producer_arg_t *args = (producer_arg_t *)malloc((size_t)producers * sizeof(producer_arg_t));
+            if (threads == NULL || args == NULL) {
+                free(threads);
+                free(args);
+                thread_pool_destroy(pool);
+                return;
+            }
+            pthread_barrier_t barrier;
+            pthread_barrier_init(&barrier, NULL, (unsigned)producers + 1);
+            atomic_store(&g_completed, 0);
+
+            long per_producer = total / producers;
+            for (int p = 0; p < producers; p++) {
+                args[p].pool = pool;
+                args[p].count = per_producer;
+                args[p].barrier = &barrier;
+                pthread_create(&threads[p], NULL, producer_main, &args[p]);
+            }
+            pthread_barrier_wait(&barrier);
+            uint64_t start = bench_now_ns();
+            for (int p = 0; p < producers; p++) {
+                pthread_join(threads[p], NULL);
+            }
+            wait_completed(per_producer * producers);
+            uint64_t elapsed = bench_now_ns() - start;
+            pthread_barrier_destroy(&barrier);
+            thread_pool_destroy(pool);
+            free(threads);
+            free(args);
+
+            snprintf(params, sizeof(params), "workers=%d;producers=%d;tasks=%ld", workers, producers,
+                     per_producer * producers);
+            bench_report(ctx, "scaling", params, "throughput", (double)(per_producer * producers) * 1e9 / (double)elapsed,
+                         "ops/s");
+        }
+    }
+}
+
+/* ---- queue_depth ---- */
+
+typedef struct {
+    pthread_mutex_t lock;
+    pthread_cond_t cond;
+    int open;
+} gate_t;
+
+/**
+ * @brief 占住唯一的工作线程，直到闸门打开。
+ */
+static void gate_task(void *arg)
+{
+    gate_t *gate = (gate_t *)arg;
+    pthread_mutex_lock(&gate->lock);
+    while (!gate->open) {
+        pthread_cond_wait(&gate->cond, &gate->lock);
+    }
+    pthread_mutex_unlock(&gate->lock);
+}
+
+static void bench_queue_depth(bench_context_t *ctx)
+{
+    const int depths[] = {100, 1000, 10000, 100000};
+    const int depth_count = ctx->quick ? 3 : 4;
+    const int lookups = 10000;
+    char params[64];
+
+    for (int d = 0; d < depth_count; d++) {
+        int depth = depths[d];
+        task_id_t *ids = (task_id_t *)malloc((size_t)depth * sizeof(task_id_t));
+        if (ids == NULL) {
+            return;
+        }
+        thread_pool_t pool = create_pool(1, 0);
+        if (pool == NULL) {
+            free(ids);
+            return;
+        }
+        gate_t gate = {PTHREAD_MUTEX_INITIALIZER, PTHREAD_COND_INITIALIZER, 0};
+        thread_pool_add_anonymous_task(pool, gate_task, &gate, TASK_PRIORITY_HIGH);
+        for (int i = 0; i < depth; i++) {
+            ids[i] = thread_pool_add_task(pool, empty_task, NULL, NULL, TASK_PRIORITY_NORMAL);
+        }
+
+        // 线性同余序列，避免按提交顺序访问带来的缓存偏差
+        unsigned int seed = 12345;
+        uint64_t start = bench_now_ns();
+        for (int i = 0; i < lookups; i++) {
+            seed = seed * 1103515245u + 12345u;
+            thread_pool_task_exists(pool, ids[seed % (unsigned)depth], NULL);
+        }
+        uint64_t exists_ns = bench_now_ns() - start;
+
+        // 从尾部开始取消一半，队列深度在测量期间从 depth 降到 depth/2
+        int cancels = depth / 2 < lookups ? depth / 2 : lookups;
+        start = bench_now_ns();
+        for (int i = 0; i < cancels; i++) {
+            thread_pool_cancel_task(pool, ids[depth - 1 - i], NULL);
+        }
+        uint64_t cancel_ns = bench_now_ns() - start;
+
+        pthread_mutex_lock(&gate.lock);
+        gate.open = 1;
+        pthread_cond_broadcast(&gate.cond);
+        pthread_mutex_unlock(&gate.lock);
+        thread_pool_destroy_with_mode(pool, THREAD_POOL_DESTROY_DISCARD_PENDING, NULL);
+        free(ids);
+
+        snprintf(params, sizeof(params), "depth=%d", depth);
+        bench_report(ctx, "queue_depth", params, "exists_cost", (double)exists_ns / lookups, "ns/op");
+        bench_report(ctx, "queue_depth", params, "cancel_cost", (double)cancel_ns / cancels, "ns/op");
+    }
+}
+
+/* ---- burst ---- */
+
+/**
+ * @brief 模拟 1 毫秒阻塞工作的任务。
+ */
+static void sleep_task(void *arg)
+{
+    (void)arg;
+    bench_sleep_us(1000);
+    atomic_fetch_add_explicit(&g_completed, 1, memory_order_relaxed);
+}
+
+static int pool_thread_count(thread_pool_t pool)
+{
+    thread_pool_stats_t stats;
+    return thread_pool_get_stats(pool, &stats) == 0 ? stats.thread_count : -1;
+}
+
+static void bench_resize(bench_context_t *ctx)
+{
+    const int rounds = ctx->quick ? 5 : 20;
+    const int target = ctx->max_threads > 1 ? ctx->max_threads : 2;
+    char params[64];
+
+    thread_pool_t pool = create_pool(1, 0);
+    if (pool == NULL) {
+        return;
+    }
+    thread_pool_set_limits(pool, 1, target);
+    uint64_t grow_ns = 0;
+    uint64_t shrink_ns = 0;
+    for (int i = 0; i < rounds; i++) {
+        uint64_t start = bench_now_ns();
+        thread_pool_resize(pool, target);
+        grow_ns += bench_now_ns() - start;
+        start = bench_now_ns();
+        thread_pool_resize(pool, 1);
+        shrink_ns += bench_now_ns() - start;
+    }
+    thread_pool_destroy(pool);
+
+    snprintf(params, sizeof(params), "from=1;to=%d", target);
+    bench_report(ctx, "resize", params, "grow_cost", (double)grow_ns / rounds / 1e3, "us");
+    bench_report(ctx, "resize", params, "shrink_cost", (double)shrink_ns / rounds / 1e3, "us");
+}
+
+static void bench_auto_adjust_burst(bench_context_t *ctx)
+{
+    const long burst = ctx->quick ? 500 : 2000;
+    const int max_threads = ctx->max_threads * 2;
+    const int policies[] = {THREAD_POOL_ADJUST_WATERMARK, THREAD_POOL_ADJUST_RATE};
+    const char *policy_names[] = {"watermark", "rate"};
+    char params[96];
+
+    for (int p = 0; p < 2; p++) {
+        thread_pool_t pool = create_pool(1, 0);
+        if (pool == NULL) {
+            return;
+        }
+        thread_pool_set_limits(pool, 1, max_threads);
+        thread_pool_adjust_config_t config;
+        thread_pool_adjust_config_init(&config);
+        config.policy = (thread_pool_adjust_policy_t)policies[p];
+        config.high_watermark = 4;
+        config.low_watermark = 1;
+        config.adjust_interval = 20;
+        config.target_queue_wait_us = 5000;
+        config.cooldown_ms = 100;
+        thread_pool_enable_auto_adjust_with_config(pool, &config);
+        atomic_store(&g_completed, 0);
+
+        uint64_t start = bench_now_ns();
+        for (long i = 0; i < burst; i++) {
+            thread_pool_add_anonymous_task(pool, sleep_task, NULL, TASK_PRIORITY_NORMAL);
+        }
+        uint64_t first_grow = 0;
+        int peak = 1;
+        while (atomic_load_explicit(&g_completed, memory_order_acquire) < burst) {
+            int threads = pool_thread_count(pool);
+            if (threads > 1 && first_grow == 0) {
+                first_grow = bench_now_ns();
+            }
+            if (threads > peak) {
+                peak = threads;
+            }
+            bench_sleep_us(1000);
+        }
+        uint64_t drained = bench_now_ns();
+
+        // 负载结束后等待线程数回到下限，最多等待 10 秒
+        uint64_t shrunk = 0;
+        while (bench_now_ns() - drained < 10000000000ULL) {
+            if (pool_thread_count(pool) <= 1) {
+                shrunk = bench_now_ns();
+                break;
+            }
+            bench_sleep_us(5000);
+        }
+        thread_pool_destroy(pool);
+
+        snprintf(params, sizeof(params), "policy=%s;burst=%ld;task_us=1000;max_threads=%d", policy_names[p], burst,
+                 max_threads);
+        bench_report(ctx, "auto_adjust_burst", params, "first_grow",
+                     first_grow != 0 ? (double)(first_grow - start) / 1e6 : -1.0, "ms");
+        bench_report(ctx, "auto_adjust_burst", params, "peak_threads", peak, "threads");
+        bench_report(ctx, "auto_adjust_burst", params, "drain", (double)(drained - start) / 1e6, "ms");
+        bench_report(ctx, "auto_adjust_burst", params, "shrink_after_drain",
+                     shrunk != 0 ? (double)(shrunk - drained) / 1e6 : -1.0, "ms");
+    }
+}
+
+int main(int argc, char **argv)
+{
+    bench_context_t ctx;
+    if (bench_init(&ctx, "thread", argc, argv) != 0) {
+        return 1;
+    }
+    // 先于线程池初始化日志系统，只保留错误信息且不写日志文件，避免日志输出影响测量
+    log_init(NULL, LOG_LEVEL_ERROR);
+
+    bench_progress("submit_throughput...");
+    bench_submit_throughput(&ctx);
+    bench_progress("submit_to_start...");
+    bench_submit_to_start(&ctx);
+    bench_progress("scaling...");
+    bench_scaling(&ctx);
+    bench_progress("queue_depth...");
+    bench_queue_depth(&ctx);
+    bench_progress("resize...");
+    bench_resize(&ctx);
+    bench_progress("auto_adjust_burst...");
+    bench_auto_adjust_burst(&ctx);
+
+    bench_finish(&ctx);
+    log_deinit();
+    return 0;
+}
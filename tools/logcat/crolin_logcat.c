@@ -0,0 +1,96 @@
+/**
+ * @file crolin_logcat.c
+ * @brief 二进制日志解码工具。
+ *
+ * 把 log_binary_open 写入的二进制日志文件解码为文本，每条记录一行，
+ * 版式与 log_write 写入文本日志文件的相同。多个文件按命令行顺序依次解码，
+ * 轮转产生的备份应按从旧到新的顺序给出 (例如 app.bin.2 app.bin.1 app.bin)。
+ */
+#include "log.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+static void logcat_usage(const char *prog)
+{
+    fprintf(stderr,
+            "用法: %s [--output FILE] [--time-format FORMAT] [--no-time] [--no-tid] [--no-module]\n"
+            "          [--no-file-line] [--no-function] FILE...\n"
+            "  --output       文本写入文件，默认为标准输出\n"
+            "  --time-format  strftime 格式的时间格式，默认为 %%Y-%%m-%%d %%H:%%M:%%S\n"
+            "  --no-*         不显示对应的字段\n",
+            prog);
+}
+
+int main(int argc, char **argv)
+{
+    log_format_options_t options = {.show_time = true,
+                                    .show_tid = true,
+                                    .show_module = true,
+                                    .show_file_line = true,
+                                    .show_function = true,
+                                    .use_colors = false,
+                                    .use_iso_time = true,
+                                    .time_format = "%Y-%m-%d %H:%M:%S"};
+    const char *output = NULL;
+    int first_file = argc;
+
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--output") == 0 && i + 1 < argc) {
+            output = argv[++i];
+        } else if (strcmp(argv[i], "--time-format") == 0 && i + 1 < argc) {
+            const char *format = argv[++i];
+            if (strlen(format) >= sizeof(options.time_format)) {
+                fprintf(stderr, "时间格式过长: %s\n", format);
+                return 1;
+            }
+            strcpy(options.time_format, format);
+        } else if (strcmp(argv[i], "--no-time") == 0) {
+            options.show_time = false;
+        } else if (strcmp(argv[i], "--no-tid") == 0) {
+            options.show_tid = false;
+        } else if (strcmp(argv[i], "--no-module") == 0) {
+            options.show_module = false;
+        } else if (strcmp(argv[i], "--no-file-line") == 0) {
+            options.show_file_line = false;
+        } else if (strcmp(argv[i], "--no-function") == 0) {
+            options.show_function = false;
+        } else if (argv[i][0] == '-' && argv[i][1] != '\0') {
+            logcat_usage(argv[0]);
+            return 1;
+        } else {
+            first_file = i;
+            break;
+        }
+    }
+    if (first_file == argc) {
+        logcat_usage(argv[0]);
+        return 1;
+    }
+
+    FILE *out = stdout;
+    if (output != NULL) {
+        out = fopen(output, "w");
+        if (out == NULL) {
+            fprintf(stderr, "无法打开输出文件: %s\n", output);
+            return 1;
+        }
+    }
+
+    int status = 0;
+    for (int i = first_file; i < argc; i++) {
+        int count = log_binary_decode(argv[i], out, &options);
+        if (count == -1) {
+            fprintf(stderr, "无法打开二进制日志文件: %s\n", argv[i]);
+            status = 1;
+        } else if (count == -2) {
+            fprintf(stderr, "二进制日志文件格式错误或被截断: %s\n", argv[i]);
+            status = 1;
+        }
+    }
+
+    if (out != stdout) {
+        fclose(out);
+    }
+    return status;
+}